@@ -1,3 +1,5 @@
+#include <limits>
+
 #include "QtCore/QString"
 
 #include "boost/bind.hpp"
@@ -81,32 +83,41 @@ ABTracker::processInput(const Messages::Extractions::Ref& msg)
     Logger::ProcLog log("processInput", getLog());
     LOGINFO << std::endl;
 
-    // For each Extraction report in the message call updateTracks.
+    // Gate all of the reports by range in one pass, then call updateTracks for each Extraction report in the
+    // message.
     //
+    plots_.assign(*msg);
+    inRange_.clear();
+    plots_.selectRange(minRange_->getValue(), std::numeric_limits<double>::infinity(), inRange_);
+
     bool ok = true;
-    for (size_t index = 0; index < msg->size(); ++index) {
-        if (!updateTracks(msg[index])) ok = false;
+    Messages::ExtractionColumns::IndexVector::const_iterator next = inRange_.begin();
+    for (size_t index = 0; index < plots_.size(); ++index) {
+        bool inRange = next != inRange_.end() && *next == index;
+        if (inRange) ++next;
+        if (!updateTracks(index, inRange)) ok = false;
     }
 
     return ok;
 }
 
 bool
-ABTracker::updateTracks(const Messages::Extraction& plot)
+ABTracker::updateTracks(size_t index, bool inRange)
 {
     Logger::ProcLog log("updateTracks", getLog());
-    double when = plot.getWhen().asDouble();
+    double when = plots_.getTime(index);
 
-    LOGINFO << "when: " << when << " range: " << plot.getRange() << " az: " << plot.getAzimuth() << std::endl;
+    LOGINFO << "when: " << when << " range: " << plots_.getRange(index) << " az: " << plots_.getAzimuth(index)
+            << std::endl;
 
     Track* found = 0;
-    if (plot.getRange() >= minRange_->getValue()) {
+    if (inRange) {
         // We only associate with something if it has a proximity value smaller
         // than associationRadius. We use the squared variants to save us from
         // the costly square root.
         //
         double best = associationRadius2_;
-        Geometry::Vector v(plot.getX(), plot.getY(), plot.getElevation());
+        Geometry::Vector v(plots_.getX(index), plots_.getY(index), plots_.getElevation(index));
 
         // Visit all of the existing Track objects to find the one that best
         // associates with the given Extraction plot.
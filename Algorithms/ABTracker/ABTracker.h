@@ -5,6 +5,7 @@
 
 #include "Algorithms/Algorithm.h"
 #include "Messages/Extraction.h"
+#include "Messages/ExtractionColumns.h"
 #include "Parameter/Parameter.h"
 
 namespace SideCar {
@@ -100,7 +101,7 @@ public:
     double getScaledMaxCoastDuration() const { return scaledMaxCoastDuration_; }
 
 private:
-    bool updateTracks(const Messages::Extraction& plot);
+    bool updateTracks(size_t index, bool inRange);
 
     size_t getNumInfoSlots() const { return kNumSlots; }
 
@@ -139,6 +140,8 @@ private:
     Parameter::NotificationValue::Ref reset_;
 
     double associationRadius2_;
+    Messages::ExtractionColumns plots_;
+    Messages::ExtractionColumns::IndexVector inRange_;
     uint32_t trackIdGenerator_;
     using TrackList = std::list<ABTrackerUtils::Track*>;
     TrackList tracks_;
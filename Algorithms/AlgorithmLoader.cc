@@ -0,0 +1,186 @@
+#include "ace/ACE.h" // for ACE_DLL_PREFIX
+#include "ace/DLL.h"
+
+#ifdef darwin
+#include <dlfcn.h>
+#endif
+
+#include "Logger/Log.h"
+#include "Utils/StartupTrace.h"
+
+#include "AlgorithmLoader.h"
+
+using namespace SideCar::Algorithms;
+
+/** Thread that opens the DLLs given to AlgorithmLoader::preload().
+ */
+class AlgorithmLoader::Preloader : public Threading::Thread {
+public:
+    Preloader(AlgorithmLoader& loader) : Thread(), loader_(loader) {}
+
+private:
+    void run() override { loader_.runPreload(); }
+
+    AlgorithmLoader& loader_;
+};
+
+Logger::Log&
+AlgorithmLoader::Log()
+{
+    static Logger::Log& log_ = Logger::Log::Find("SideCar.Algorithms.AlgorithmLoader");
+    return log_;
+}
+
+AlgorithmLoader&
+AlgorithmLoader::Instance()
+{
+    // Never destroyed, since loaded DLLs must outlive every algorithm, and the preload thread may still be running
+    // when static objects go away at exit.
+    //
+    static AlgorithmLoader* loader_ = new AlgorithmLoader;
+    return *loader_;
+}
+
+AlgorithmLoader::AlgorithmLoader() :
+    condition_(Threading::Condition::Make()), entries_(), pending_(), preloading_(false), preloader_()
+{
+    ;
+}
+
+AlgorithmLoader::Maker
+AlgorithmLoader::getMaker(const std::string& algorithmName)
+{
+    Threading::Locker lock(condition_);
+    while (true) {
+        auto pos = entries_.find(algorithmName);
+        if (pos == entries_.end()) break;
+        if (pos->second.state == Entry::kLoaded) return pos->second.maker;
+        condition_->waitForSignal();
+    }
+
+    // Claim the load so that other threads asking for the same DLL wait for us, then do it without the lock.
+    //
+    Entry entry = {Entry::kLoading, 0};
+    entries_[algorithmName] = entry;
+    condition_->mutex()->unlock();
+    Maker maker = Load(algorithmName);
+    condition_->mutex()->lock();
+    finish(algorithmName, maker);
+    return maker;
+}
+
+void
+AlgorithmLoader::preload(const std::vector<std::string>& algorithmNames)
+{
+    Logger::ProcLog log("preload", Log());
+    Threading::Locker lock(condition_);
+    for (const auto& name : algorithmNames) {
+        if (entries_.find(name) != entries_.end()) continue;
+        LOGINFO << name << std::endl;
+        Entry entry = {Entry::kLoading, 0};
+        entries_[name] = entry;
+        pending_.push_back(name);
+    }
+
+    if (pending_.empty() || preloading_) return;
+
+    // The last preload thread has finished its work, so joining it does not wait for long.
+    //
+    if (preloader_) preloader_->join();
+    preloading_ = true;
+    preloader_.reset(new Preloader(*this));
+    preloader_->start();
+}
+
+void
+AlgorithmLoader::waitForPreload()
+{
+    Threading::Locker lock(condition_);
+    while (preloading_) condition_->waitForSignal();
+}
+
+bool
+AlgorithmLoader::isLoaded(const std::string& algorithmName) const
+{
+    Threading::Locker lock(condition_);
+    auto pos = entries_.find(algorithmName);
+    return pos != entries_.end() && pos->second.state == Entry::kLoaded;
+}
+
+AlgorithmLoader::Maker
+AlgorithmLoader::Load(const std::string& algorithmName)
+{
+    Logger::ProcLog log("Load", Log());
+    LOGINFO << algorithmName << std::endl;
+
+    Utils::StartupTrace::Scope trace("dll", algorithmName);
+
+    // Construct the name of the DLL we wish to load
+    //
+    std::string path(ACE_DLL_PREFIX);
+    path += algorithmName;
+    LOGDEBUG << "path: " << path << std::endl;
+
+    // Attempt to load/open the DLL. The ACE_DLL object is never deleted, which keeps the DLL loaded.
+    //
+    ACE_DLL* dll = new ACE_DLL;
+    int rc = dll->open(path.c_str());
+    if (rc != 0) {
+        LOGERROR << "failed to locate DLL '" << path << "' - " << rc << ' ' << errno << std::endl;
+#ifdef darwin
+        LOGERROR << dlerror() << std::endl;
+#endif
+        delete dll;
+        return 0;
+    }
+
+    // Create the algorithm factory method that will create an Algorthm object for us.
+    //
+    std::string makerName(algorithmName);
+    makerName += "Make";
+    LOGDEBUG << "makerName: " << makerName << std::endl;
+
+    // Attempt to resolve the factory method
+    //
+    union {
+        void* v;
+        Maker p;
+    } symbol;
+    symbol.v = dll->symbol(makerName.c_str());
+    if (!symbol.v) {
+        LOGERROR << "failed to obtain factory method '" << makerName << "' from DLL" << std::endl;
+        return 0;
+    }
+
+    return symbol.p;
+}
+
+void
+AlgorithmLoader::finish(const std::string& algorithmName, Maker maker)
+{
+    if (maker) {
+        Entry entry = {Entry::kLoaded, maker};
+        entries_[algorithmName] = entry;
+    } else {
+        entries_.erase(algorithmName);
+    }
+
+    condition_->broadcast();
+}
+
+void
+AlgorithmLoader::runPreload()
+{
+    Threading::Locker lock(condition_);
+    while (!pending_.empty()) {
+        std::string name(pending_.front());
+        pending_.erase(pending_.begin());
+        condition_->mutex()->unlock();
+        Maker maker = Load(name);
+        condition_->mutex()->lock();
+        finish(name, maker);
+    }
+
+    preloading_ = false;
+    condition_->broadcast();
+}
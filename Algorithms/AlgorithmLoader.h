@@ -0,0 +1,119 @@
+#ifndef SIDECAR_ALGORITHMS_ALGORITHMLOADER_H // -*- C++ -*-
+#define SIDECAR_ALGORITHMS_ALGORITHMLOADER_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "boost/scoped_ptr.hpp"
+
+#include "Threading/Threading.h"
+
+namespace Logger {
+class Log;
+}
+
+namespace SideCar {
+namespace Algorithms {
+
+class Algorithm;
+class Controller;
+
+/** Process-wide cache of the algorithm DLLs loaded by Controller objects. Each DLL is opened, and its factory
+    method resolved, once per process no matter how many controllers use it. Loaded DLLs stay loaded until the
+    process exits.
+
+    The preload() method opens a list of DLLs in a background thread, so that the work overlaps with the rest of
+    application startup. A controller that asks for a DLL still being opened by the background thread, or by
+    another controller, waits for that load to finish instead of starting its own. The dynamic loader serializes
+    DLL opens within a process, so one background thread is as fast as several.
+*/
+class AlgorithmLoader {
+public:
+    /** Prototype for the algorithm factory method that must exist in the DLL.
+     */
+    using Maker = Algorithm* (*)(Controller&, Logger::Log&);
+
+    static Logger::Log& Log();
+
+    /** Obtain the loader for the process.
+
+        \return loader reference
+    */
+    static AlgorithmLoader& Instance();
+
+    /** Obtain the factory method for an algorithm, opening its DLL if not done already. The DLL name is the
+        platform's DLL prefix followed by the algorithm name, and the factory method is the algorithm name
+        followed by "Make".
+
+        \param algorithmName name of the algorithm to load
+
+        \return factory method, or NULL if the DLL or the method could not be found
+    */
+    Maker getMaker(const std::string& algorithmName);
+
+    /** Open DLLs in a background thread. Names already loaded or being loaded are skipped. Returns right away.
+
+        \param algorithmNames names of the algorithms to load
+    */
+    void preload(const std::vector<std::string>& algorithmNames);
+
+    /** Wait until the background thread has opened all DLLs given to preload().
+     */
+    void waitForPreload();
+
+    /** Determine if an algorithm DLL has been loaded.
+
+        \param algorithmName name of the algorithm to check
+
+        \return true if loaded
+    */
+    bool isLoaded(const std::string& algorithmName) const;
+
+private:
+    struct Entry {
+        enum State { kLoading, kLoaded };
+        State state;
+        Maker maker;
+    };
+
+    class Preloader;
+
+    AlgorithmLoader();
+
+    AlgorithmLoader(const AlgorithmLoader&);
+    AlgorithmLoader& operator=(const AlgorithmLoader&);
+
+    /** Open a DLL and resolve its factory method. Invoked without holding the mutex.
+
+        \param algorithmName name of the algorithm to load
+
+        \return factory method, or NULL
+    */
+    static Maker Load(const std::string& algorithmName);
+
+    /** Record the outcome of a load started by the calling thread, and wake up any threads waiting for it. A
+        failed load leaves no entry behind, so the next request tries again. Invoked while holding the mutex.
+
+        \param algorithmName name of the algorithm loaded
+
+        \param maker factory method, or NULL if the load failed
+    */
+    void finish(const std::string& algorithmName, Maker maker);
+
+    void runPreload();
+
+    Threading::Condition::Ref condition_;
+    std::map<std::string, Entry> entries_;
+    std::vector<std::string> pending_;
+    bool preloading_;
+    boost::scoped_ptr<Preloader> preloader_;
+};
+
+} // end namespace Algorithms
+} // end namespace SideCar
+
+/** \file
+ */
+
+#endif
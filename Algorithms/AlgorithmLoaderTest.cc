@@ -0,0 +1,62 @@
+#include "Threading/Threading.h"
+#include "UnitTest/UnitTest.h"
+
+#include "AlgorithmLoader.h"
+
+using namespace SideCar::Algorithms;
+
+struct Test : public UnitTest::TestObj {
+    Test() : UnitTest::TestObj("AlgorithmLoader") {}
+    void test();
+};
+
+struct Requester : public Threading::Thread {
+    Requester(const std::string& name) : Thread(), name_(name), maker_(0) {}
+
+    void run() { maker_ = AlgorithmLoader::Instance().getMaker(name_); }
+
+    std::string name_;
+    AlgorithmLoader::Maker maker_;
+};
+
+void
+Test::test()
+{
+    AlgorithmLoader& loader(AlgorithmLoader::Instance());
+    assertFalse(loader.isLoaded("NoSuchAlgorithm"));
+
+    // A failed preload leaves nothing behind, so that a later request tries again and reports the failure.
+    //
+    std::vector<std::string> names;
+    names.push_back("NoSuchAlgorithm");
+    names.push_back("NoSuchAlgorithm");
+    names.push_back("AnotherMissingAlgorithm");
+    loader.preload(names);
+    loader.waitForPreload();
+    assertFalse(loader.isLoaded("NoSuchAlgorithm"));
+    assertFalse(loader.isLoaded("AnotherMissingAlgorithm"));
+    assertTrue(loader.getMaker("NoSuchAlgorithm") == 0);
+
+    // Requests racing a preload of the same DLL wait for it and see its outcome.
+    //
+    loader.preload(names);
+    Requester one("NoSuchAlgorithm"), two("AnotherMissingAlgorithm");
+    one.start();
+    two.start();
+    one.join();
+    two.join();
+    loader.waitForPreload();
+    assertTrue(one.maker_ == 0);
+    assertTrue(two.maker_ == 0);
+
+    // Preloading nothing new does not start a thread, and so does not block.
+    //
+    loader.preload(std::vector<std::string>());
+    loader.waitForPreload();
+}
+
+int
+main(int argc, const char* argv[])
+{
+    return Test().mainRun();
+}
@@ -23,7 +23,7 @@ ChannelBuffer::MakeGenericLongName(int index)
 
 ChannelBuffer::ChannelBuffer(ManyInAlgorithm& processor, size_t channelIndex, size_t maxBufferSize) :
     processor_(processor), enabledParam_(), channelIndex_(channelIndex), maxBufferSize_(maxBufferSize),
-    nextSequenceCounter_(0), container_(), enabled_(true)
+    ring_(maxBufferSize + 1), head_(0), size_(0), last_(), droppedCount_(0), filledCount_(0), enabled_(true)
 {
     ;
 }
@@ -53,26 +53,51 @@ ChannelBuffer::enabledChanged(const Parameter::BoolValue& parameter)
     if (enabled_ != parameter.getValue()) { setEnabled(parameter.getValue()); }
 }
 
+const std::string&
+ChannelBuffer::getProcessorName() const
+{
+    return processor_.getName();
+}
+
 bool
 ChannelBuffer::pruneToSequenceCounter(uint32_t sequenceCounter)
 {
-    static const uint32_t kWrapped = 1 << 16;
-
     // Skip entries until we have a message with a sequenceCounter that is not older than the given one.
     //
-    while (!isEmpty() &&
-           ((sequenceCounter > nextSequenceCounter_) ||
-            (sequenceCounter < nextSequenceCounter_ && nextSequenceCounter_ - sequenceCounter > kWrapped))) {
-        popFrontInternal();
-    }
-    return !isEmpty() && nextSequenceCounter_ == sequenceCounter;
+    while (!isEmpty() && IsOlder(getNextSequenceCounter(), sequenceCounter)) dropFront();
+    return !isEmpty() && getNextSequenceCounter() == sequenceCounter;
+}
+
+void
+ChannelBuffer::dropFront()
+{
+    popFrontInternal();
+    ++droppedCount_;
+}
+
+bool
+ChannelBuffer::fillFront(const Messages::PRIMessage::Ref& basis)
+{
+    if (!last_ || size_ == ring_.size()) return false;
+    head_ = (head_ + ring_.size() - 1) % ring_.size();
+    ring_[head_].msg = makeFill(basis, last_);
+    ring_[head_].arrival = Time::TimeStamp::Now();
+    ++size_;
+    ++filledCount_;
+    return true;
 }
 
 void
 ChannelBuffer::setMaxBufferSize(size_t maxBufferSize)
 {
+    // Keep the newest messages that fit, in order, at the start of a new ring.
+    //
     maxBufferSize_ = maxBufferSize;
     pruneToMaxBufferSize();
+    std::vector<Entry> ring(maxBufferSize_ + 1);
+    for (size_t index = 0; index < size_; ++index) ring[index] = ring_[(head_ + index) % ring_.size()];
+    ring_.swap(ring);
+    head_ = 0;
 }
 
 void
@@ -86,8 +111,11 @@ ChannelBuffer::setEnabled(bool value)
 void
 ChannelBuffer::reset()
 {
-    nextSequenceCounter_ = 0;
-    container_.clear();
+    while (!isEmpty()) popFrontInternal();
+    head_ = 0;
+    last_.reset();
+    droppedCount_ = 0;
+    filledCount_ = 0;
 }
 
 bool
@@ -95,9 +123,14 @@ ChannelBuffer::addData(const Messages::PRIMessage::Ref& msg)
 {
     if (!isEnabled()) return true;
 
-    if (container_.empty()) nextSequenceCounter_ = msg->getSequenceCounter();
-    container_.push_back(msg);
-    pruneToMaxBufferSize();
+    // Make room for the new message by dropping the oldest one if necessary.
+    //
+    while (size_ >= maxBufferSize_ && size_) dropFront();
+    Entry& entry(ring_[(head_ + size_) % ring_.size()]);
+    entry.msg = msg;
+    entry.arrival = Time::TimeStamp::Now();
+    ++size_;
+    last_ = msg;
 
     return processor_.processMessageReceived();
 }
@@ -106,13 +139,14 @@ void
 ChannelBuffer::popFrontInternal()
 {
     if (!isEmpty()) {
-        container_.pop_front();
-        nextSequenceCounter_ = container_.empty() ? 0 : container_.front()->getSequenceCounter();
+        ring_[head_].msg.reset();
+        head_ = (head_ + 1) % ring_.size();
+        --size_;
     }
 }
 
 void
 ChannelBuffer::pruneToMaxBufferSize()
 {
-    while (size() > maxBufferSize_) popFrontInternal();
+    while (size_ > maxBufferSize_) dropFront();
 }
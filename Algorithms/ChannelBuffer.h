@@ -1,13 +1,15 @@
 #ifndef SIDECAR_ALGORITHMS_CHANNELBUFFER_H // -*- C++ -*-
 #define SIDECAR_ALGORITHMS_CHANNELBUFFER_H
 
-#include <deque>
+#include <complex>
+#include <vector>
 #include <vsip/matrix.hpp>
 #include <vsip/vector.hpp>
 
 #include "Algorithms/Processor.h"
 #include "Messages/PRIMessage.h"
 #include "Parameter/Parameter.h"
+#include "Time/TimeStamp.h"
 
 namespace SideCar {
 namespace Algorithms {
@@ -22,14 +24,31 @@ class ManyInAlgorithm;
     Held messages are of type PRIMessage; a derived template class, TChannelBuffer, works with concrete SideCar
     messages types.
 
+    Messages live in a ring allocated when the maximum size is set, so adding and removing them does not touch
+    the heap. The ring has one slot more than the maximum size so that ManyInAlgorithm may place a zero-filled
+    message in front of the others when a channel is missing a sequence counter (see fillFront()). The buffer
+    counts the messages it discards and the ones it fills in for ManyInAlgorithm to report.
+
     Note that this class works with a ManyInAlgorithm instance, requiring one in its constructor. After a
     ChannelBuffer places a new message in its queue, it calls the ManyInAlgorithm::processMessageReceived()
     method to notify the ManyInAlgorithm object of new data.
 */
 class ChannelBuffer {
 public:
-    using Container = std::deque<Messages::PRIMessage::Ref>;
-    using const_iterator = Container::const_iterator;
+    /** Determine if one sequence counter comes before another. Sequence counters increase monotonically
+        except when wrapping around, so a value more than 65536 greater than another is taken to be older.
+
+        \param sequenceCounter the value to test
+
+        \param other the value to test against
+
+        \return true if \p sequenceCounter is older than \p other
+    */
+    static bool IsOlder(uint32_t sequenceCounter, uint32_t other)
+    {
+        static const uint32_t kWrapped = 1 << 16;
+        return other > sequenceCounter || (other < sequenceCounter && sequenceCounter - other > kWrapped);
+    }
 
     /** Create generic short name for the input channel. Given an index value of N, this will return a string
         with the format "input#Enabled", with # replaced by the value N+1.
@@ -79,13 +98,13 @@ public:
 
         \return buffer size
     */
-    size_t size() const { return container_.size(); }
+    size_t size() const { return size_; }
 
     /** Determine if the buffer is empty
 
         \return true if so
     */
-    bool isEmpty() const { return container_.empty(); }
+    bool isEmpty() const { return size_ == 0; }
 
     /** Determine if the buffer is enabled. A disabled buffer ignores all addData() calls.
 
@@ -98,7 +117,26 @@ public:
 
         \return sequence counter
     */
-    uint32_t getNextSequenceCounter() const { return nextSequenceCounter_; }
+    uint32_t getNextSequenceCounter() const { return size_ ? ring_[head_].msg->getSequenceCounter() : 0; }
+
+    /** Obtain the time when the first message in the queue arrived. NOTE: only call if the queue is not empty.
+
+        \return arrival time
+    */
+    const Time::TimeStamp& getFrontArrival() const { return ring_[head_].arrival; }
+
+    /** Obtain the number of messages discarded since the last reset(), either because the buffer was full or
+        because no other channel had a message with the same sequence counter.
+
+        \return discard count
+    */
+    size_t getDroppedCount() const { return droppedCount_; }
+
+    /** Obtain the number of zero-filled messages added by fillFront() since the last reset().
+
+        \return fill count
+    */
+    size_t getFilledCount() const { return filledCount_; }
 
     /** Remove messages from the front of the queue whose sequence counter values are less than the given value
 
@@ -108,6 +146,20 @@ public:
     */
     bool pruneToSequenceCounter(uint32_t sequenceCounter);
 
+    /** Discard the oldest message in the queue, counting it as dropped. NOTE: only call if the queue is not
+        empty.
+    */
+    void dropFront();
+
+    /** Place a zero-filled message at the front of the queue to stand in for one that never arrived. The new
+        message takes its header from \p basis and its size from the last message added to this buffer.
+
+        \param basis message from another channel with the missing sequence counter
+
+        \return true if successful, false if this buffer has never held a message
+    */
+    bool fillFront(const Messages::PRIMessage::Ref& basis);
+
     /** Change the maximum number of messages to hold.
 
         \param maxBufferSize new value
@@ -124,20 +176,6 @@ public:
      */
     virtual void reset();
 
-    /** Obtain a slide of the data, copying it into a VSIPL vector. NOTE: only valid if isEmpty() is false.
-        Always works on the first message in the FIFO queue.
-
-        \param offset index of the first sample value to use
-
-        \param span count of sample values to gather
-
-        \param slice container to hold the resulting complex values
-
-        \param doPop if true, remove the first message from the queue after
-        working with it
-    */
-    virtual void getSlice(int offset, int span, VsipComplexVector& slice, bool doPop) = 0;
-
     /** Add a message to the queue.
 
         \param msg the message to process
@@ -163,23 +201,19 @@ public:
     */
     virtual bool makeEnabledParameter(const std::string& shortName, const std::string& longName);
 
-    /** Obtain read-only iterator to the first sample value in the message.
-
-        \return read-only iterator
-    */
-    const_iterator begin() const { return container_.begin(); }
+    /** Obtain a message in the queue.
 
-    /** Obtain read-only iterator to the last + 1 sample value in the message.
+        \param index position of the message, where 0 is the oldest. Must be less than size().
 
-        \return read-only iterator
+        \return Messages::PRIMessage reference
     */
-    const_iterator end() const { return container_.end(); }
+    Messages::PRIMessage::Ref getMessage(size_t index) const { return ring_[(head_ + index) % ring_.size()].msg; }
 
     /** Obtain the oldest message in the queue. NOTE: only call if the queue is not empty.
 
         \return Messages::PRIMessage reference
     */
-    Messages::PRIMessage::Ref getFront() const { return container_.front(); }
+    Messages::PRIMessage::Ref getFront() const { return ring_[head_].msg; }
 
     /** Remove the oldest message in the queue. NOTE: only call if the queue is not empty.
      */
@@ -192,11 +226,27 @@ public:
     }
 
 protected:
-    /** Remove the oldest message from the queue. Updates the nextSequenceCounter_ value. NOTE: only call if the
-        queue is not empty.
-    */
+    /** Remove the oldest message from the queue. NOTE: only call if the queue is not empty.
+     */
     void popFrontInternal();
 
+    /** Create a message of the type held by this buffer for fillFront().
+
+        \param basis message to take the header from
+
+        \param last the last message added to this buffer
+
+        \return new message filled with zeros
+    */
+    virtual Messages::PRIMessage::Ref makeFill(const Messages::PRIMessage::Ref& basis,
+                                               const Messages::PRIMessage::Ref& last) const = 0;
+
+    /** Obtain the name of the algorithm that owns this buffer.
+
+        \return algorithm name
+    */
+    const std::string& getProcessorName() const;
+
     /** Remove messages until the size of the buffer is less than or equal to maxBufferSize_.
      */
     void pruneToMaxBufferSize();
@@ -208,12 +258,21 @@ protected:
     virtual void enabledChanged(const Parameter::BoolValue& parameter);
 
 private:
+    struct Entry {
+        Messages::PRIMessage::Ref msg;
+        Time::TimeStamp arrival;
+    };
+
     ManyInAlgorithm& processor_;
     Parameter::BoolValue::Ref enabledParam_;
     size_t channelIndex_;
     size_t maxBufferSize_;
-    uint32_t nextSequenceCounter_;
-    Container container_;
+    std::vector<Entry> ring_;
+    size_t head_;
+    size_t size_;
+    Messages::PRIMessage::Ref last_;
+    size_t droppedCount_;
+    size_t filledCount_;
     bool enabled_;
 };
 
@@ -224,6 +283,8 @@ private:
 template <typename T>
 class TChannelBuffer : public ChannelBuffer, public TProcessor<TChannelBuffer<T>, T> {
 public:
+    using DatumType = typename T::DatumType;
+
     /** Constructor. Registers ourselves with the owner as the processor for the channel.
 
         \param master the algorithm doing the processing
@@ -256,49 +317,24 @@ public:
         return msg;
     }
 
-    /** Obtain a slide of the data, copying it into a VSIPL vector. NOTE: only valid if isEmpty() is false.
-        Always works on the first message in the FIFO queue. Implementation of ChannelBuffer API.
-
-        Treats the message data as interleved I/Q data. Creates complex values
-        from subsequent values and adds them to the given VSIPL vector
-        container. If the message is too short to accomodate the span
-        parameter, pads the VSIPL vector with 0,0 complex values.
-
-        \param offset index of the first sample value to use
+protected:
+    /** Implementation of ChannelBuffer API. Creates a T message with the header of \p basis and the size of
+        \p last, filled with zeros.
 
-        \param span count of sample values to gather
+        \param basis message to take the header from
 
-        \param slice container to hold the resulting complex values
+        \param last the last message added to this buffer
 
-        \param doPop if true, remove the first message from the queue after
-        working with it
+        \return new message
     */
-    void getSlice(int offset, int span, VsipComplexVector& slice, bool doPop)
+    Messages::PRIMessage::Ref makeFill(const Messages::PRIMessage::Ref& basis,
+                                       const Messages::PRIMessage::Ref& last) const override
     {
-        if (isEmpty()) return;
-
-        // NOTE: important to hold reference to message in case we pop it from the deque.
-        //
-        typename T::Ref msg(getFront());
-        typename T::Container& container(msg->getData());
-        if (doPop) popFront();
-
-        // Make sure that offset + span is no greater than the size of the message.
-        //
-        int limit = span;
-        if ((offset + span) * 2 > int(container.size())) {
-            limit = container.size() / 2 - offset;
-            if (limit < 0) limit = 0;
-        }
-
-        // Now copy over the data as complex values.
-        //
-        typename T::DatumType* ptr = &container[offset * 2];
-        for (int index = 0; index < limit; ++index, ptr += 2) { slice.put(index, ComplexType(*ptr, *(ptr + 1))); }
-
-        // Make sure that the slices we return are of the requested size, even if our message is too short.
-        //
-        while (limit < span) { slice.put(limit++, ComplexType()); }
+        typename T::Ref ref(boost::dynamic_pointer_cast<T>(last));
+        typename T::Ref fill(T::Make(getProcessorName(), ref));
+        fill->getRIUInfo() = basis->getRIUInfo();
+        fill->getData().assign(ref->size(), DatumType());
+        return fill;
     }
 };
 
@@ -25,16 +25,26 @@ ClutterMap::ClutterMap(Controller& controller, Logger::Log& log) :
         Parameter::PositiveIntValue::Make("learningScanCount", "Learning Scan Count", kDefaultLearningScanCount)),
     radialPartitionCount_(Parameter::PositiveIntValue::Make("radialPartitionCount", "Radial Partition Count",
                                                             kDefaultRadialPartitionCount)),
+    mapFilePath_(Parameter::WritePathValue::Make("mapFilePath", "Map File", kDefaultMapFilePath)),
+    coarseStartGate_(
+        Parameter::NonNegativeIntValue::Make("coarseStartGate", "Coarse Cell Start Gate", kDefaultCoarseStartGate)),
+    coarseRangeFactor_(Parameter::PositiveIntValue::Make("coarseRangeFactor", "Coarse Cell Gate Count",
+                                                         kDefaultCoarseRangeFactor)),
+    coarseAzimuthFactor_(Parameter::PositiveIntValue::Make("coarseAzimuthFactor", "Coarse Cell Radial Count",
+                                                           kDefaultCoarseAzimuthFactor)),
     alpha_(Parameter::DoubleValue::Make("alpha", "Learn Rate", kDefaultAlpha)),
     loadFilePath_(Parameter::ReadPathValue::Make("loadFilePath", "Load File", kDefaultLoadFilePath)),
     loadMap_(Parameter::NotificationValue::Make("loadMap", "Load Map", 0)),
     saveFilePath_(Parameter::WritePathValue::Make("saveFilePath", "Save File", kDefaultSaveFilePath)),
     saveMap_(Parameter::NotificationValue::Make("saveMap", "Save Map", 0)),
     resetBuffer_(Parameter::NotificationValue::Make("resetBuffer", "Reset Map Buffer", 0)), lastShaftEncoding_(0),
-    scanCounter_(-1), mapBuffer_()
+    scanCounter_(-1), generation_(0), mapBuffer_()
 {
     alpha_->connectChangedSignalTo(boost::bind(&ClutterMap::alphaChanged, this, _1));
     radialPartitionCount_->connectChangedSignalTo(boost::bind(&ClutterMap::radialPartitionCountChanged, this, _1));
+    coarseStartGate_->connectChangedSignalTo(boost::bind(&ClutterMap::layoutChanged, this, _1));
+    coarseRangeFactor_->connectChangedSignalTo(boost::bind(&ClutterMap::factorChanged, this, _1));
+    coarseAzimuthFactor_->connectChangedSignalTo(boost::bind(&ClutterMap::factorChanged, this, _1));
     resetBuffer_->connectChangedSignalTo(boost::bind(&ClutterMap::resetBufferNotification, this, _1));
     loadMap_->connectChangedSignalTo(boost::bind(&ClutterMap::loadMapNotification, this, _1));
     saveMap_->connectChangedSignalTo(boost::bind(&ClutterMap::saveMapNotification, this, _1));
@@ -49,6 +59,8 @@ ClutterMap::startup()
     registerProcessor<ClutterMap, Messages::Video>(&ClutterMap::process);
     return registerParameter(enabled_) && registerParameter(beginInLearningMode_) &&
            registerParameter(learningScanCount_) && registerParameter(radialPartitionCount_) &&
+           registerParameter(mapFilePath_) && registerParameter(coarseStartGate_) &&
+           registerParameter(coarseRangeFactor_) && registerParameter(coarseAzimuthFactor_) &&
            registerParameter(alpha_) && registerParameter(loadFilePath_) && registerParameter(loadMap_) &&
            registerParameter(saveFilePath_) && registerParameter(saveMap_) && registerParameter(resetBuffer_) &&
            Algorithm::startup();
@@ -64,9 +76,44 @@ ClutterMap::reset()
         if (loadMap(loadFilePath_->getValue())) { beginInLearningMode_->setValue(true); }
     }
 
+    // Otherwise, pick up the map held in the map file, if there is one. A frozen map is ready for use now; one that
+    // was still learning continues to do so.
+    //
+    if (!mapBuffer_ && mapFilePath_->getValue().size() > 0) makeBuffer(true);
+
     return true;
 }
 
+bool
+ClutterMap::makeBuffer(bool reuse)
+{
+    Logger::ProcLog log("makeBuffer", getLog());
+
+    MapFile::Layout layout;
+    layout.radialCount = radialPartitionCount_->getValue();
+    layout.gateCount = RadarConfig::GetGateCountMax() + 1;
+    layout.coarseGate = coarseStartGate_->getValue();
+    layout.coarseRangeFactor = coarseRangeFactor_->getValue();
+    layout.coarseAzimuthFactor = coarseAzimuthFactor_->getValue();
+
+    mapBuffer_.reset(new MapBuffer(getName(), layout, alpha_->getValue()));
+    if (mapBuffer_->open(mapFilePath_->getValue(), reuse)) {
+        generation_ = mapBuffer_->getGeneration();
+        return true;
+    }
+
+    // Keep going without persistence rather than stop filtering.
+    //
+    LOGERROR << "failed to use map file '" << mapFilePath_->getValue() << "' - keeping map in memory" << std::endl;
+    if (mapBuffer_->open("", false)) {
+        generation_ = mapBuffer_->getGeneration();
+        return true;
+    }
+
+    mapBuffer_.reset();
+    return false;
+}
+
 void
 ClutterMap::resetBuffer()
 {
@@ -103,12 +150,23 @@ ClutterMap::process(const Messages::Video::Ref& msg)
         LOGINFO << "north mark crossing - scanCounter: " << scanCounter_ << " limit: " << learningScanCount_->getValue()
                 << std::endl;
 
+        if (mapBuffer_) {
+            // Count learning scans from the start of the current map generation, which another runner sharing the
+            // map file may have begun with a reset, or which recover() begins when a runner died while freezing.
+            //
+            mapBuffer_->recover();
+            if (mapBuffer_->getGeneration() != generation_) {
+                LOGWARNING << "map restarted - learning again" << std::endl;
+                generation_ = mapBuffer_->getGeneration();
+                scanCounter_ = 0;
+            }
+        }
+
         if (!mapBuffer_) {
-            mapBuffer_.reset(new MapBuffer(getName(), radialPartitionCount_->getValue(), alpha_->getValue()));
+            makeBuffer(false);
         } else if (!mapBuffer_->isFrozen()) {
-            if (++scanCounter_ == learningScanCount_->getValue()) {
-                LOGWARNING << "freezing clutter map" << std::endl;
-                mapBuffer_->freeze();
+            if (++scanCounter_ >= learningScanCount_->getValue() && mapBuffer_->freeze()) {
+                LOGWARNING << "froze clutter map" << std::endl;
                 std::string path = saveFilePath_->getValue();
                 if (path.size()) {
                     if (!saveMap(path)) { LOGERROR << "failed to save frozen map" << std::endl; }
@@ -143,6 +201,22 @@ ClutterMap::radialPartitionCountChanged(const Parameter::PositiveIntValue& value
     resetBuffer();
 }
 
+void
+ClutterMap::layoutChanged(const Parameter::NonNegativeIntValue& value)
+{
+    Logger::ProcLog log("layoutChanged", getLog());
+    LOGERROR << std::endl;
+    resetBuffer();
+}
+
+void
+ClutterMap::factorChanged(const Parameter::PositiveIntValue& value)
+{
+    Logger::ProcLog log("factorChanged", getLog());
+    LOGERROR << std::endl;
+    resetBuffer();
+}
+
 void
 ClutterMap::resetBufferNotification(const Parameter::NotificationValue& value)
 {
@@ -194,8 +268,7 @@ ClutterMap::loadMap(const std::string& path)
         return false;
     }
 
-    mapBuffer_.reset(new MapBuffer(getName(), radialPartitionCount_->getValue(), alpha_->getValue()));
-    if (!mapBuffer_->load(is)) {
+    if (!makeBuffer(false) || !mapBuffer_->load(is)) {
         LOGERROR << "failed to load map '" << path << "'" << std::endl;
         return false;
     }
@@ -41,6 +41,19 @@ namespace Algorithms {
     some radials fail to receive an update during one scan due to rotation speed and accuracy of the shaft
     encoder.
 
+    - \c mapFilePath path of the binary file that holds the clutter map while the algorithm runs. The file is
+    memory-mapped, so the map survives a restart: if the file holds a map with the same layout when the algorithm
+    starts, it picks up where it left off, and a frozen map is used right away. Redundant runners may share one
+    file, in which case the first to finish learning freezes the map for all of them. A reset starts a new
+    generation of the map, which every runner sharing the file learns again from scratch. A runner never resizes a
+    file that another runner is using: one with a different map layout keeps its map in memory. If empty, the map
+    is only held in memory, which is the default: every runner that should share a map must be configured with the
+    same path, and streams that should not share one must use different paths.
+
+    - \c coarseStartGate, \c coarseRangeFactor, \c coarseAzimuthFactor allow coarser map cells at long range.
+    Beyond \c coarseStartGate one cell covers \c coarseRangeFactor gates and \c coarseAzimuthFactor radials. With
+    both factors at 1 every gate of every radial has its own cell.
+
     - \c loadFilePath path of file containg the values of a previously-saved clutter map. A loaded map is
     automatically frozen.
 
@@ -147,6 +160,10 @@ private:
 
     void saveFilePathChanged(const Parameter::WritePathValue& value);
 
+    void layoutChanged(const Parameter::NonNegativeIntValue& value);
+
+    void factorChanged(const Parameter::PositiveIntValue& value);
+
     void resetBufferNotification(const Parameter::NotificationValue& param);
 
     void loadMapNotification(const Parameter::NotificationValue& param);
@@ -155,11 +172,23 @@ private:
 
     void resetBuffer();
 
+    /** Create a new map buffer.
+
+        \param reuse true if the contents of an existing map file may be used
+
+        \return true if successful
+    */
+    bool makeBuffer(bool reuse);
+
     Parameter::BoolValue::Ref enabled_;
     Parameter::BoolValue::Ref beginInLearningMode_;
     Parameter::DoubleValue::Ref alpha_;
     Parameter::PositiveIntValue::Ref learningScanCount_;
     Parameter::PositiveIntValue::Ref radialPartitionCount_;
+    Parameter::WritePathValue::Ref mapFilePath_;
+    Parameter::NonNegativeIntValue::Ref coarseStartGate_;
+    Parameter::PositiveIntValue::Ref coarseRangeFactor_;
+    Parameter::PositiveIntValue::Ref coarseAzimuthFactor_;
     Parameter::ReadPathValue::Ref loadFilePath_;
     Parameter::NotificationValue::Ref loadMap_;
     Parameter::WritePathValue::Ref saveFilePath_;
@@ -168,6 +197,7 @@ private:
 
     size_t lastShaftEncoding_;
     int scanCounter_;
+    uint32_t generation_;
     boost::scoped_ptr<MapBuffer> mapBuffer_;
 };
 
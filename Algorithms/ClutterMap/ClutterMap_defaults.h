@@ -3,6 +3,10 @@ static const int kDefaultLearningScanCount = 10;
 static const int kDefaultRadialPartitionCount = 360;
 static const char* const kDefaultLoadFilePath = "/opt/sidecar/data/cluttermap.txt";
 static const char* const kDefaultSaveFilePath = "/opt/sidecar/data/cluttermap.txt";
+static const char* const kDefaultMapFilePath = "";
+static const int kDefaultCoarseStartGate = 0;
+static const int kDefaultCoarseRangeFactor = 1;
+static const int kDefaultCoarseAzimuthFactor = 1;
 static const bool kDefaultRecordingEnabled = 0;
 static const bool kDefaultBeginInLearningMode = 1;
 static const bool kDefaultEnabled = 1;
@@ -1,10 +1,7 @@
-#include <algorithm>
-#include <fstream>
-#include <iterator>
+#include <cmath>
 
 #include "Logger/Log.h"
 #include "Messages/RadarConfig.h"
-#include "Utils/VsipVector.h"
 
 #include "MapBuffer.h"
 
@@ -18,15 +15,14 @@ MapBuffer::Log()
     return log_;
 }
 
-MapBuffer::MapBuffer(const std::string& name, size_t radialPartitionCount, float alpha) :
-    name_(name), maxRangeBin_(RadarConfig::GetGateCountMax() + 1), alpha_(0.05),
-    partitionScaling_(float(radialPartitionCount) / float(RadarConfig::GetShaftEncodingMax() + 1)),
-    buffer_(radialPartitionCount * maxRangeBin_, 0.0), radialCounts_(radialPartitionCount, 0), isLearning_(true)
+MapBuffer::MapBuffer(const std::string& name, const MapFile::Layout& layout, float alpha) :
+    name_(name), alpha_(alpha),
+    partitionScaling_(float(layout.radialCount) / float(RadarConfig::GetShaftEncodingMax() + 1)), map_(layout)
 {
     static Logger::ProcLog log("MapBuffer", Log());
-    LOGINFO << "radialPartitionCount: " << radialPartitionCount
+    LOGINFO << "radialPartitionCount: " << layout.radialCount
             << " shaftMax: " << (RadarConfig::GetShaftEncodingMax() + 1) << " partionScaling: " << partitionScaling_
-            << " buffer size: " << buffer_.size() << std::endl;
+            << " cells: " << map_.getCellCount() << std::endl;
 }
 
 MapBuffer::~MapBuffer()
@@ -41,79 +37,25 @@ MapBuffer::add(const Video::Ref& msg)
 
     size_t radialIndex = size_t(::floor(msg->getShaftEncoding() * partitionScaling_));
     LOGINFO << "encoding: " << msg->getShaftEncoding() << " index: " << radialIndex << std::endl;
-    if (radialIndex >= radialCounts_.size()) { LOGERROR << "radialIndex is too big!" << std::endl; }
-
-    std::vector<float>::iterator p = buffer_.begin();
-    p += radialIndex * maxRangeBin_;
-    Video::const_iterator v = msg->begin();
+    if (radialIndex >= map_.getLayout().radialCount) {
+        LOGERROR << "radialIndex is too big!" << std::endl;
+        return msg;
+    }
 
-    size_t limit = maxRangeBin_;
+    size_t limit = map_.getLayout().gateCount;
     if (msg->size() < limit) limit = msg->size();
 
-    if (isLearning_) {
-        for (size_t index = 0; index < limit; ++index) *p++ += *v++;
-        radialCounts_[radialIndex] += 1;
-        return msg;
+    // While another runner converts the learned sums, leave the map alone.
+    //
+    switch (map_.getState()) {
+    case MapFile::kLearning: map_.learn(radialIndex, msg->getData().data(), limit); return msg;
+    case MapFile::kFreezing: return msg;
+    case MapFile::kFrozen: break;
     }
 
     Video::Ref out(Messages::Video::Make(name_, msg));
-
-    float oneMinusAlpha_ = 1.0 - alpha_;
-    size_t radialCount = radialCounts_[radialIndex];
-
-    if (radialCount > 0) {
-        radialCounts_[radialIndex] = 0;
-        for (size_t index = 0; index < limit; ++index) {
-            float tmp = *p / radialCount;
-            out->push_back(*v - tmp);
-            *p++ = tmp * oneMinusAlpha_ + *v++ * alpha_;
-        }
-    } else {
-        for (size_t index = 0; index < limit; ++index) {
-            float tmp = *p;
-            out->push_back(*v - tmp);
-            *p++ = tmp * oneMinusAlpha_ + *v++ * alpha_;
-        }
-    }
+    out->resize(limit);
+    map_.filter(radialIndex, alpha_, msg->getData().data(), out->getData().data(), limit);
 
     return out;
 }
-
-void
-MapBuffer::freeze()
-{
-    Logger::ProcLog log("freeze", Log());
-    LOGWARNING << std::endl;
-    isLearning_ = false;
-}
-
-bool
-MapBuffer::load(std::istream& is)
-{
-    Logger::ProcLog log("load", Log());
-    LOGINFO << buffer_.size() << std::endl;
-
-    std::vector<float>::iterator p = buffer_.begin();
-    for (size_t index = 0; index < buffer_.size(); ++index) {
-        if (!(is >> *p++)) return false;
-    }
-
-    std::vector<int>::iterator c = radialCounts_.begin();
-    for (size_t index = 0; index < radialCounts_.size(); ++index) {
-        if (!(is >> *c++)) return false;
-    }
-
-    isLearning_ = false;
-
-    return true;
-}
-
-bool
-MapBuffer::save(std::ostream& os)
-{
-    Logger::ProcLog log("load", Log());
-    LOGINFO << buffer_.size() << std::endl;
-    std::copy(buffer_.begin(), buffer_.end(), std::ostream_iterator<float>(os, "\n"));
-    std::copy(radialCounts_.begin(), radialCounts_.end(), std::ostream_iterator<float>(os, "\n"));
-    return os.good();
-}
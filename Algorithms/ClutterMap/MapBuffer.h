@@ -2,12 +2,12 @@
 #define SIDECAR_ALGORITHMS_MAPBUFFER_H
 
 #include <iosfwd>
-
-#include <vector>
-#include <vsip/vector.hpp>
+#include <string>
 
 #include "Messages/Video.h"
 
+#include "MapFile.h"
+
 namespace Logger {
 class Log;
 }
@@ -17,39 +17,65 @@ namespace Algorithms {
 
 class MapBuffer {
 public:
-    using VsipFloatVector = vsip::Vector<float>;
-    using VsipFloatVectorBuffer = std::vector<VsipFloatVector*>;
-
     static Logger::Log& Log();
 
-    MapBuffer(const std::string& name, size_t radialPartitionCount, float alpha);
+    /** Constructor.
+
+        \param name producer name for output messages
+
+        \param layout cell layout of the map
+
+        \param alpha weight of new PRIs in a frozen map
+    */
+    MapBuffer(const std::string& name, const MapFile::Layout& layout, float alpha);
 
     ~MapBuffer();
 
+    /** Allocate the map cells. See MapFile::open().
+
+        \param path location of the file holding the map, or empty for memory only
+
+        \param reuse true if the contents of an existing file with the same layout should be kept
+
+        \return true if successful
+    */
+    bool open(const std::string& path, bool reuse) { return map_.open(path, reuse); }
+
     void setAlpha(float alpha) { alpha_ = alpha; }
 
     Messages::Video::Ref add(const Messages::Video::Ref& msg);
 
-    void freeze();
+    /** Stop learning. The map may already be frozen by another runner sharing the same map file.
 
-    bool isFrozen() const { return !isLearning_; }
+        \return true if this call froze the map
+    */
+    bool freeze() { return map_.freeze(); }
 
-    bool load(std::istream& is);
+    bool isFrozen() const { return map_.isFrozen(); }
 
-    bool save(std::ostream& os);
+    /** Obtain the generation of the map. See MapFile::getGeneration().
 
-private:
-    void makeBuffer(size_t radialPartitionCount);
+        \return map generation
+    */
+    uint32_t getGeneration() const { return map_.getGeneration(); }
+
+    /** Restart a map left freezing by a runner that died. See MapFile::recover().
+
+        \return true if the map was restarted
+    */
+    bool recover() { return map_.recover(); }
+
+    bool isMapped() const { return map_.isMapped(); }
+
+    bool load(std::istream& is) { return map_.load(is); }
 
+    bool save(std::ostream& os) const { return map_.save(os); }
+
+private:
     std::string name_;
-    size_t maxRangeBin_;
     float alpha_;
     float partitionScaling_;
-
-    std::vector<float> buffer_;
-    std::vector<int> radialCounts_;
-
-    bool isLearning_;
+    MapFile map_;
 };
 
 } // end namespace Algorithms
@@ -0,0 +1,710 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include "Logger/Log.h"
+
+#include "MapFile.h"
+
+using namespace SideCar::Algorithms;
+
+static const char kMagic[8] = {'S', 'C', 'C', 'M', 'A', 'P', '\0', '\0'};
+static const uint32_t kVersion = 3;
+
+/** Header at the start of a map file. Padded to 64 bytes so that the cells that follow are aligned for vector
+    loads. The state word holds a MapFile::State in its low two bits and, while freezing, the token of the freezer
+    above them.
+*/
+struct MapFile::Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t radialCount;
+    uint32_t gateCount;
+    uint32_t coarseGate;
+    uint32_t coarseRangeFactor;
+    uint32_t coarseAzimuthFactor;
+    std::atomic<uint32_t> generation;
+    std::atomic<uint64_t> state;
+    char padding[16];
+};
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "atomic counters must be plain words");
+static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t), "atomic locks must be plain words");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "atomics shared between processes must be lock-free");
+
+static const uint64_t kStateMask = 3;
+
+/** Time after which a waiter checks whether the holder of a row lock, or the runner freezing the map, is still
+    alive. Updating a row takes microseconds.
+*/
+static const std::chrono::milliseconds kLivenessCheckDelay(100);
+
+/** Longest time that load() waits for another runner to finish freezing the map.
+ */
+static const std::chrono::seconds kFreezeTimeout(5);
+
+static uint64_t
+MakeState(uint64_t token, MapFile::State state)
+{
+    return (token << 2) | state;
+}
+
+/** Create a token that identifies a MapFile object among all of the runners on the host: the process ID in the
+    upper bits and a per-process serial number in the lower 16. Never zero, which marks a free row lock.
+*/
+static uint64_t
+MakeToken()
+{
+    static std::atomic<uint32_t> serial_(0);
+    return (uint64_t(::getpid()) << 16) | (serial_.fetch_add(1) % 0xFFFF + 1);
+}
+
+/** Determine if the MapFile that owns a token may still be using the map. Objects in this process are always
+    alive, since they release what they hold before they go away.
+
+    \param token value from MakeToken()
+
+    \return true if the owning process exists
+*/
+static bool
+IsAlive(uint64_t token)
+{
+    pid_t pid = pid_t(token >> 16);
+    if (pid == ::getpid()) return true;
+    return ::kill(pid, 0) == 0 || errno != ESRCH;
+}
+
+/** Holds an exclusive lock on the companion lock file of a map file for as long as it exists. Runners take it to
+    set up, resize, or restart a map file, so that only one of them does so at a time, and so that the lock on the
+    map file itself may go from exclusive to shared without another runner slipping in between.
+*/
+class MapFile::InitLock {
+public:
+    InitLock(const std::string& path) : fd_(::open((path + ".lock").c_str(), O_RDWR | O_CREAT, 0644))
+    {
+        if (fd_ != -1 && ::flock(fd_, LOCK_EX) == -1) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+    ~InitLock()
+    {
+        if (fd_ != -1) ::close(fd_);
+    }
+
+    bool isLocked() const { return fd_ != -1; }
+
+private:
+    int fd_;
+};
+
+/** Holds the lock of one row of cells for as long as it exists. All runners sharing a map file take the lock of a
+    row while they change it. The lock word holds the token of its owner. A waiter takes the lock over only when
+    the owner's process is gone, and a lock is only released by its owner.
+*/
+class MapFile::RowLock {
+public:
+    RowLock(std::atomic<uint64_t>& lock, uint64_t token) : lock_(lock), token_(token)
+    {
+        uint64_t expected = 0;
+        if (lock_.compare_exchange_strong(expected, token_, std::memory_order_acquire)) return;
+        wait();
+    }
+
+    ~RowLock()
+    {
+        uint64_t expected = token_;
+        lock_.compare_exchange_strong(expected, 0, std::memory_order_release);
+    }
+
+private:
+    void wait()
+    {
+        auto check = std::chrono::steady_clock::now() + kLivenessCheckDelay;
+        while (true) {
+            std::this_thread::yield();
+            uint64_t expected = 0;
+            if (lock_.compare_exchange_weak(expected, token_, std::memory_order_acquire)) return;
+            if (expected && std::chrono::steady_clock::now() > check) {
+                if (!IsAlive(expected) && lock_.compare_exchange_strong(expected, token_, std::memory_order_acquire)) {
+                    static Logger::ProcLog log("RowLock", Log());
+                    LOGWARNING << "took over a row lock from process " << (expected >> 16) << ", which has exited"
+                               << std::endl;
+                    return;
+                }
+
+                check = std::chrono::steady_clock::now() + kLivenessCheckDelay;
+            }
+        }
+    }
+
+    std::atomic<uint64_t>& lock_;
+    uint64_t token_;
+};
+
+/** Convert a float sample difference to a sample value, truncating like the implicit conversion but saturating
+    instead of wrapping.
+*/
+static int16_t
+Saturate(float value)
+{
+    value = value < -32768.0f ? -32768.0f : value;
+    value = value > 32767.0f ? 32767.0f : value;
+    return int16_t(value);
+}
+
+Logger::Log&
+MapFile::Log()
+{
+    static Logger::Log& log_ = Logger::Log::Find("SideCar.Algorithms.ClutterMap.MapFile");
+    return log_;
+}
+
+MapFile::Layout::Layout() :
+    radialCount(1), gateCount(0), coarseGate(0), coarseRangeFactor(1), coarseAzimuthFactor(1)
+{
+    ;
+}
+
+MapFile::MapFile(const Layout& layout) :
+    layout_(layout), fineCount_(0), coarseRows_(0), coarseCells_(0), header_(0), cells_(0), counts_(0), locks_(0),
+    path_(), token_(MakeToken()), fd_(-1), mapped_(false)
+{
+    static_assert(sizeof(Header) == 64, "map file header must be 64 bytes");
+
+    // Without a coarse region every gate has its own cell.
+    //
+    if (layout_.radialCount == 0) layout_.radialCount = 1;
+    if (layout_.coarseRangeFactor == 0) layout_.coarseRangeFactor = 1;
+    if (layout_.coarseAzimuthFactor == 0) layout_.coarseAzimuthFactor = 1;
+    if (layout_.coarseRangeFactor == 1 && layout_.coarseAzimuthFactor == 1) layout_.coarseGate = layout_.gateCount;
+    if (layout_.coarseGate > layout_.gateCount) layout_.coarseGate = layout_.gateCount;
+
+    fineCount_ = layout_.radialCount * layout_.coarseGate;
+    if (layout_.coarseGate < layout_.gateCount) {
+        coarseRows_ = (layout_.radialCount + layout_.coarseAzimuthFactor - 1) / layout_.coarseAzimuthFactor;
+        coarseCells_ = (layout_.gateCount - layout_.coarseGate + layout_.coarseRangeFactor - 1) /
+                       layout_.coarseRangeFactor;
+    }
+}
+
+MapFile::~MapFile()
+{
+    close();
+}
+
+size_t
+MapFile::getLocksOffset() const
+{
+    // The 64-bit lock words follow the counts on an 8-byte boundary.
+    //
+    size_t offset = sizeof(Header) + getCellCount() * sizeof(float) + getRowCount() * sizeof(uint32_t);
+    return (offset + sizeof(uint64_t) - 1) & ~(sizeof(uint64_t) - 1);
+}
+
+size_t
+MapFile::getFileSize() const
+{
+    return getLocksOffset() + getRowCount() * sizeof(uint64_t);
+}
+
+size_t
+MapFile::getCoarseWidth(size_t cell) const
+{
+    size_t begin = layout_.coarseGate + cell * layout_.coarseRangeFactor;
+    return std::min(layout_.coarseRangeFactor, layout_.gateCount - begin);
+}
+
+bool
+MapFile::matches() const
+{
+    return ::memcmp(header_->magic, kMagic, sizeof(kMagic)) == 0 && header_->version == kVersion &&
+           header_->headerSize == sizeof(Header) && header_->radialCount == layout_.radialCount &&
+           header_->gateCount == layout_.gateCount && header_->coarseGate == layout_.coarseGate &&
+           header_->coarseRangeFactor == layout_.coarseRangeFactor &&
+           header_->coarseAzimuthFactor == layout_.coarseAzimuthFactor;
+}
+
+void
+MapFile::initialize()
+{
+    // The header and the counts hold atomics, so build them in place instead of clearing them with memset(). The
+    // value-initialized header has a zero magic value, and the real one goes in last so that a map interrupted
+    // during setup is not mistaken for a valid one.
+    //
+    new (header_) Header();
+    std::fill(cells_, cells_ + getCellCount(), 0.0f);
+    for (size_t index = 0; index < getRowCount(); ++index) {
+        new (counts_ + index) std::atomic<uint32_t>(0);
+        new (locks_ + index) std::atomic<uint64_t>(0);
+    }
+
+    header_->version = kVersion;
+    header_->headerSize = sizeof(Header);
+    header_->radialCount = layout_.radialCount;
+    header_->gateCount = layout_.gateCount;
+    header_->coarseGate = layout_.coarseGate;
+    header_->coarseRangeFactor = layout_.coarseRangeFactor;
+    header_->coarseAzimuthFactor = layout_.coarseAzimuthFactor;
+    header_->generation.store(1);
+    header_->state.store(kLearning);
+    ::memcpy(header_->magic, kMagic, sizeof(kMagic));
+}
+
+bool
+MapFile::open(const std::string& path, bool reuse)
+{
+    static Logger::ProcLog log("open", Log());
+    LOGINFO << "path: " << path << " reuse: " << reuse << " cells: " << getCellCount() << std::endl;
+
+    close();
+
+    size_t size = getFileSize();
+    void* base = MAP_FAILED;
+    if (path.empty()) {
+        base = ::mmap(0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (base == MAP_FAILED) {
+            LOGERROR << "failed mmap() of " << size << " bytes - " << errno << ' ' << strerror(errno) << std::endl;
+            return false;
+        }
+
+        setPointers(base);
+        initialize();
+        return true;
+    }
+
+    // Hold the companion lock file until the map is ready, so that no other runner resizes or sets up the file
+    // in the meantime.
+    //
+    InitLock init(path);
+    if (!init.isLocked()) {
+        LOGERROR << "failed to lock '" << path << ".lock' - " << errno << ' ' << strerror(errno) << std::endl;
+        return false;
+    }
+
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd_ == -1) {
+        LOGERROR << "failed to open map file '" << path << "' - " << errno << ' ' << strerror(errno) << std::endl;
+        return false;
+    }
+
+    // Every runner using the file holds a shared lock on it until close(). Only a runner that gets an exclusive
+    // lock, and so knows that no other runner has the file open, may resize the file or start a new map in it
+    // without regard for others.
+    //
+    bool alone = ::flock(fd_, LOCK_EX | LOCK_NB) == 0;
+    if (!alone && ::flock(fd_, LOCK_SH) == -1) {
+        LOGERROR << "failed to lock map file '" << path << "' - " << errno << ' ' << strerror(errno) << std::endl;
+        close();
+        return false;
+    }
+
+    struct stat fileStats;
+    if (::fstat(fd_, &fileStats) == -1) {
+        LOGERROR << "failed fstat() on map file '" << path << "' - " << errno << ' ' << strerror(errno)
+                 << std::endl;
+        close();
+        return false;
+    }
+
+    bool fits = size_t(fileStats.st_size) == size;
+    if (!fits && !alone) {
+        LOGERROR << "map file '" << path << "' is in use with a different layout" << std::endl;
+        close();
+        return false;
+    }
+
+    if (!fits && ::ftruncate(fd_, size) == -1) {
+        LOGERROR << "failed to size map file '" << path << "' - " << errno << ' ' << strerror(errno) << std::endl;
+        close();
+        return false;
+    }
+
+    base = ::mmap(0, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (base == MAP_FAILED) {
+        LOGERROR << "failed mmap() on map file '" << path << "' - " << errno << ' ' << strerror(errno)
+                 << std::endl;
+        close();
+        return false;
+    }
+
+    setPointers(base);
+    path_ = path;
+    mapped_ = true;
+
+    bool keep = fits && matches();
+    if (!alone) {
+        // Never resize or set up the file under other runners: join the map they are using, or start a new
+        // generation of it that they will see too.
+        //
+        if (!keep) {
+            LOGERROR << "map file '" << path << "' is in use with a different layout or version" << std::endl;
+            close();
+            return false;
+        }
+
+        if (!reuse) {
+            LOGWARNING << "map file '" << path << "' is in use - starting a new map for all of its users" << std::endl;
+            clear();
+        } else if ((header_->state.load() & kStateMask) == kFreezing && !IsAlive(header_->state.load() >> 2)) {
+            LOGWARNING << "map file '" << path << "' was left freezing by a runner that exited" << std::endl;
+            clear();
+        }
+    } else {
+        if (!keep) {
+            if (fits) LOGWARNING << "map file '" << path << "' has a different layout or version" << std::endl;
+        } else if (!reuse) {
+            keep = false;
+        } else if ((header_->state.load() & kStateMask) == kFreezing) {
+            // No other runner has the file open, so the runner freezing the map died part way through, leaving
+            // some rows with sums and others with means.
+            //
+            LOGWARNING << "map file '" << path << "' was left freezing by a runner that exited" << std::endl;
+            keep = false;
+        } else {
+            // Row locks left behind by a runner that died are meaningless now.
+            //
+            for (size_t index = 0; index < getRowCount(); ++index) locks_[index].store(0);
+        }
+
+        if (!keep) initialize();
+        sync();
+
+        // Other runners may open the file once they get the InitLock, which we still hold.
+        //
+        ::flock(fd_, LOCK_SH);
+    }
+
+    LOGWARNING << (keep ? "using" : "created") << " map file '" << path << "' state: " << getState()
+               << " generation: " << getGeneration() << std::endl;
+    return true;
+}
+
+void
+MapFile::setPointers(void* base)
+{
+    header_ = static_cast<Header*>(base);
+    cells_ = reinterpret_cast<float*>(header_ + 1);
+    counts_ = reinterpret_cast<std::atomic<uint32_t>*>(cells_ + getCellCount());
+    locks_ = reinterpret_cast<std::atomic<uint64_t>*>(static_cast<char*>(base) + getLocksOffset());
+}
+
+void
+MapFile::close()
+{
+    if (header_) {
+        if (mapped_) sync();
+        ::munmap(header_, getFileSize());
+        header_ = 0;
+        cells_ = 0;
+        counts_ = 0;
+        locks_ = 0;
+        mapped_ = false;
+    }
+
+    path_.clear();
+
+    // Closing the file releases our lock on it.
+    //
+    if (fd_ != -1) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+MapFile::State
+MapFile::getState() const
+{
+    return State(header_->state.load(std::memory_order_acquire) & kStateMask);
+}
+
+uint32_t
+MapFile::getGeneration() const
+{
+    return header_->generation.load(std::memory_order_acquire);
+}
+
+void
+MapFile::sync()
+{
+    if (mapped_) ::msync(header_, getFileSize(), MS_SYNC);
+}
+
+bool
+MapFile::restart()
+{
+    static Logger::ProcLog log("restart", Log());
+    if (!mapped_) {
+        clear();
+        return true;
+    }
+
+    // Runners sharing the file may not set up or restart the map at the same time.
+    //
+    InitLock init(path_);
+    if (!init.isLocked()) {
+        LOGERROR << "failed to lock '" << path_ << ".lock' - " << errno << ' ' << strerror(errno) << std::endl;
+        return false;
+    }
+
+    clear();
+    return true;
+}
+
+bool
+MapFile::recover()
+{
+    static Logger::ProcLog log("recover", Log());
+    uint64_t state = header_->state.load(std::memory_order_acquire);
+    if ((state & kStateMask) != kFreezing || IsAlive(state >> 2)) return false;
+
+    // Another runner may get here too; only the first to take the InitLock finds the state unchanged.
+    //
+    InitLock init(path_);
+    if (!init.isLocked() || header_->state.load() != state) return false;
+
+    LOGWARNING << "map file '" << path_ << "' was left freezing by process " << (state >> 18)
+               << ", which has exited - starting a new map" << std::endl;
+    clear();
+    return true;
+}
+
+void
+MapFile::clear()
+{
+    // Hold the freezing state while the rows are cleared, so that other runners neither learn nor filter. A runner
+    // that freezes the map at the same time finds its state gone when it is done, and leaves this one in place.
+    //
+    header_->state.store(MakeState(token_, kFreezing), std::memory_order_release);
+    for (size_t radial = 0; radial < layout_.radialCount; ++radial) {
+        RowLock lock(locks_[radial], token_);
+        std::fill(fineRow(radial), fineRow(radial) + layout_.coarseGate, 0.0f);
+        counts_[radial].store(0);
+    }
+
+    for (size_t row = 0; row < coarseRows_; ++row) {
+        RowLock lock(locks_[layout_.radialCount + row], token_);
+        float* cells = cells_ + fineCount_ + row * coarseCells_;
+        std::fill(cells, cells + coarseCells_, 0.0f);
+        counts_[layout_.radialCount + row].store(0);
+    }
+
+    header_->generation.fetch_add(1);
+    header_->state.store(kLearning, std::memory_order_release);
+    sync();
+}
+
+bool
+MapFile::freeze()
+{
+    // Only one runner sharing the file gets to convert the sums into means.
+    //
+    uint64_t expected = kLearning;
+    if (!header_->state.compare_exchange_strong(expected, MakeState(token_, kFreezing))) return false;
+    convert();
+    return true;
+}
+
+void
+MapFile::convert()
+{
+    static Logger::ProcLog log("convert", Log());
+
+    // Runners that saw the learning state before it changed may still be adding to a row, so take each row's lock.
+    // Rows with a count of 0 or 1 already hold their final values.
+    //
+    for (size_t radial = 0; radial < layout_.radialCount; ++radial) {
+        RowLock lock(locks_[radial], token_);
+        uint32_t count = counts_[radial].exchange(0);
+        if (count < 2) continue;
+        float scale = 1.0f / count;
+        float* cells = fineRow(radial);
+        for (size_t gate = 0; gate < layout_.coarseGate; ++gate) cells[gate] *= scale;
+    }
+
+    for (size_t row = 0; row < coarseRows_; ++row) {
+        RowLock lock(locks_[layout_.radialCount + row], token_);
+        uint32_t count = counts_[layout_.radialCount + row].exchange(0);
+        if (!count) continue;
+        float* cells = cells_ + fineCount_ + row * coarseCells_;
+        for (size_t cell = 0; cell < coarseCells_; ++cell) cells[cell] /= float(count * getCoarseWidth(cell));
+    }
+
+    // A restart() by another runner while we worked takes precedence.
+    //
+    uint64_t expected = MakeState(token_, kFreezing);
+    if (!header_->state.compare_exchange_strong(expected, kFrozen, std::memory_order_release)) {
+        LOGWARNING << "map was restarted while it was freezing" << std::endl;
+        return;
+    }
+
+    sync();
+    LOGWARNING << "froze map of " << getCellCount() << " cells" << std::endl;
+}
+
+void
+MapFile::learn(size_t radial, const int16_t* input, size_t count)
+{
+    if (count > layout_.gateCount) count = layout_.gateCount;
+
+    // Another runner may have started to freeze the map since the caller looked at the state. Once it has, sums
+    // must no longer change.
+    //
+    size_t fine = std::min(count, layout_.coarseGate);
+    {
+        RowLock lock(locks_[radial], token_);
+        if (getState() != kLearning) return;
+        float* cells = fineRow(radial);
+        for (size_t gate = 0; gate < fine; ++gate) cells[gate] += input[gate];
+        counts_[radial].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (count <= layout_.coarseGate) return;
+
+    RowLock lock(locks_[coarseIndex(radial)], token_);
+    if (getState() != kLearning) return;
+    float* cells = coarseRow(radial);
+    for (size_t gate = layout_.coarseGate; gate < count; ++gate) {
+        cells[(gate - layout_.coarseGate) / layout_.coarseRangeFactor] += input[gate];
+    }
+
+    counts_[coarseIndex(radial)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void
+MapFile::filter(size_t radial, float alpha, const int16_t* input, int16_t* output, size_t count)
+{
+    if (count > layout_.gateCount) count = layout_.gateCount;
+
+    const float oneMinusAlpha = 1.0f - alpha;
+    size_t fine = std::min(count, layout_.coarseGate);
+    {
+        // Another runner may have restarted the map since the caller looked at the state. Pass the samples through
+        // rather than mix them into a map that is learning again.
+        //
+        RowLock lock(locks_[radial], token_);
+        if (getState() != kFrozen) {
+            std::copy(input, input + count, output);
+            return;
+        }
+
+        float* cells = fineRow(radial);
+        for (size_t gate = 0; gate < fine; ++gate) {
+            float value = input[gate];
+            float mean = cells[gate];
+            output[gate] = Saturate(value - mean);
+            cells[gate] = mean * oneMinusAlpha + value * alpha;
+        }
+    }
+
+    if (count <= layout_.coarseGate) return;
+
+    // A coarse cell moves towards the average of the gates it covers.
+    //
+    RowLock lock(locks_[coarseIndex(radial)], token_);
+    if (getState() != kFrozen) {
+        std::copy(input + layout_.coarseGate, input + count, output + layout_.coarseGate);
+        return;
+    }
+
+    float* cells = coarseRow(radial);
+    for (size_t gate = layout_.coarseGate, cell = 0; gate < count; ++cell) {
+        size_t end = std::min(gate + layout_.coarseRangeFactor, count);
+        float mean = cells[cell];
+        float sum = 0.0f;
+        size_t width = end - gate;
+        for (; gate < end; ++gate) {
+            float value = input[gate];
+            output[gate] = Saturate(value - mean);
+            sum += value;
+        }
+
+        cells[cell] = mean * oneMinusAlpha + (sum / width) * alpha;
+    }
+}
+
+bool
+MapFile::load(std::istream& is)
+{
+    Logger::ProcLog log("load", Log());
+    LOGINFO << getCellCount() << std::endl;
+
+    // Read everything before touching the map, which other runners may be using.
+    //
+    std::vector<float> cells(getCellCount());
+    for (auto& cell : cells) {
+        if (!(is >> cell)) return false;
+    }
+
+    std::vector<uint32_t> counts(getRowCount());
+    for (auto& count : counts) {
+        if (!(is >> count)) return false;
+    }
+
+    // Hold the map in the freezing state so that other runners leave it alone. Wait a while for a runner that is
+    // freezing it right now, but not for one that died while doing so.
+    //
+    uint64_t freezing = MakeState(token_, kFreezing);
+    auto deadline = std::chrono::steady_clock::now() + kFreezeTimeout;
+    uint64_t state = header_->state.load();
+    while (true) {
+        if ((state & kStateMask) != kFreezing || !IsAlive(state >> 2)) {
+            if (header_->state.compare_exchange_weak(state, freezing)) break;
+            continue;
+        }
+
+        if (std::chrono::steady_clock::now() > deadline) {
+            LOGERROR << "map is still being frozen by process " << (state >> 18) << std::endl;
+            return false;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        state = header_->state.load();
+    }
+
+    for (size_t radial = 0; radial < layout_.radialCount; ++radial) {
+        RowLock lock(locks_[radial], token_);
+        std::copy(cells.begin() + radial * layout_.coarseGate, cells.begin() + (radial + 1) * layout_.coarseGate,
+                  fineRow(radial));
+        counts_[radial].store(counts[radial]);
+    }
+
+    for (size_t row = 0; row < coarseRows_; ++row) {
+        RowLock lock(locks_[layout_.radialCount + row], token_);
+        size_t offset = fineCount_ + row * coarseCells_;
+        std::copy(cells.begin() + offset, cells.begin() + offset + coarseCells_, cells_ + offset);
+        counts_[layout_.radialCount + row].store(counts[layout_.radialCount + row]);
+    }
+
+    // Files written before the map froze eagerly may still hold sums for some radials; converting them takes care
+    // of them.
+    //
+    convert();
+    return true;
+}
+
+bool
+MapFile::save(std::ostream& os) const
+{
+    Logger::ProcLog log("save", Log());
+    LOGINFO << getCellCount() << std::endl;
+    std::copy(cells_, cells_ + getCellCount(), std::ostream_iterator<float>(os, "\n"));
+    for (size_t index = 0; index < getRowCount(); ++index) os << counts_[index].load() << '\n';
+    return os.good();
+}
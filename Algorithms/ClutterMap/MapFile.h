@@ -0,0 +1,225 @@
+#ifndef SIDECAR_ALGORITHMS_MAPFILE_H // -*- C++ -*-
+#define SIDECAR_ALGORITHMS_MAPFILE_H
+
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+namespace Logger {
+class Log;
+}
+
+namespace SideCar {
+namespace Algorithms {
+
+/** Clutter map cell store held in a memory-mapped file. The file starts with a versioned header that records the
+    cell layout, the map generation, and the learn/freeze state, followed by the cell values, the per-row learning
+    counts, and per-row locks. A runner that starts up with a matching file continues from where the last one left
+    off, and the kernel keeps the pages on disk current even if the process dies. Redundant runners that map the
+    same file share the learn/freeze state: the first to freeze the map does so for all of them, and a restart()
+    by any of them starts a new generation that all of them learn.
+
+    Each update of a row of cells holds the row's lock, and the runner that freezes the map records itself in the
+    state. Both hold the process ID of their owner, so that a lock or a freeze left behind by a runner that died can
+    be told apart from one that is merely slow. Setting up, resizing, or restarting a file happens under an
+    exclusive lock on a companion file, the map file path with ".lock" appended.
+
+    Cells may be coarser at long range. Gates below Layout::coarseGate have one cell per gate and radial; beyond
+    that, one cell covers Layout::coarseRangeFactor gates and Layout::coarseAzimuthFactor radials.
+
+    Without a file path the cells live in anonymous memory and are lost when the object is destroyed.
+*/
+class MapFile {
+public:
+    /** Cell layout of a map.
+     */
+    struct Layout {
+        Layout();
+
+        size_t radialCount;         ///< Number of radials in the map
+        size_t gateCount;           ///< Number of gates in each radial
+        size_t coarseGate;          ///< First gate of the coarse region
+        size_t coarseRangeFactor;   ///< Gates per coarse cell
+        size_t coarseAzimuthFactor; ///< Radials per coarse cell
+    };
+
+    enum State { kLearning = 0, kFreezing, kFrozen };
+
+    static Logger::Log& Log();
+
+    /** Constructor. Does not allocate any cells; see open().
+
+        \param layout cell layout to use
+    */
+    explicit MapFile(const Layout& layout);
+
+    ~MapFile();
+
+    /** Allocate the cells. If \p path is empty, use anonymous memory. Otherwise, map the file at \p path. If
+        \p reuse is true and the file holds a map with the same layout, keep its contents and state; otherwise
+        start a new map in the learning state. A file that another MapFile has open is never resized: if it holds
+        a map with a different layout, the call fails. Otherwise the map is joined if \p reuse is true, and
+        restarted for every user of the file if not.
+
+        \param path location of the file to map
+
+        \param reuse true if an existing map may be used
+
+        \return true if successful
+    */
+    bool open(const std::string& path, bool reuse);
+
+    /** Release the cells, flushing them to disk if mapped from a file.
+     */
+    void close();
+
+    bool isOpen() const { return header_ != 0; }
+
+    bool isMapped() const { return mapped_; }
+
+    /** Obtain the learn/freeze state, which may have been changed by another runner using the same file.
+
+        \return current state
+    */
+    State getState() const;
+
+    bool isFrozen() const { return getState() == kFrozen; }
+
+    /** Obtain the generation of the map, which restart() advances. A change tells a runner sharing the file that
+        the map is learning from scratch.
+
+        \return map generation
+    */
+    uint32_t getGeneration() const;
+
+    /** Clear the map and return it to the learning state, for every runner using the same file.
+
+        \return true if successful
+    */
+    bool restart();
+
+    /** Restart the map if it has been left in the freezing state by a runner that died while converting it. Only
+        the state is checked unless it is freezing, so this is cheap enough to call once a scan.
+
+        \return true if the map was restarted
+    */
+    bool recover();
+
+    /** Convert the learned sums into mean values and stop learning. Does nothing if the map is not learning.
+
+        \return true if this call froze the map
+    */
+    bool freeze();
+
+    /** Add the samples of a PRI to the sums of a radial while learning.
+
+        \param radial radial index
+
+        \param input sample values
+
+        \param count number of samples
+    */
+    void learn(size_t radial, const int16_t* input, size_t count);
+
+    /** Subtract the map values of a radial from the samples of a PRI, and move the map values towards the samples
+        with a single-pole low-pass filter.
+
+        \param radial radial index
+
+        \param alpha weight of the new samples
+
+        \param input sample values
+
+        \param output buffer for the filtered values
+
+        \param count number of samples
+    */
+    void filter(size_t radial, float alpha, const int16_t* input, int16_t* output, size_t count);
+
+    /** Flush the cells to disk.
+     */
+    void sync();
+
+    /** Read cell values and counts written by save(). The map is frozen afterwards. If the map is shared, the
+        new values replace those of every runner using it.
+
+        \param is stream to read from
+
+        \return true if successful
+    */
+    bool load(std::istream& is);
+
+    /** Write cell values and counts as text.
+
+        \param os stream to write to
+
+        \return true if successful
+    */
+    bool save(std::ostream& os) const;
+
+    const Layout& getLayout() const { return layout_; }
+
+    size_t getCellCount() const { return fineCount_ + coarseRows_ * coarseCells_; }
+
+    size_t getRowCount() const { return layout_.radialCount + coarseRows_; }
+
+private:
+    struct Header;
+
+    class InitLock;
+
+    class RowLock;
+
+    size_t getFileSize() const;
+
+    size_t getLocksOffset() const;
+
+    bool matches() const;
+
+    void setPointers(void* base);
+
+    void initialize();
+
+    /** Clear the cells and counts under the row locks, advance the generation, and set the learning state. The
+        caller must hold the InitLock of a mapped file.
+    */
+    void clear();
+
+    /** Turn the learned sums into means, and mark the map as frozen. The caller must have set the freezing state
+        with this object's token.
+    */
+    void convert();
+
+    float* fineRow(size_t radial) const { return cells_ + radial * layout_.coarseGate; }
+
+    float* coarseRow(size_t radial) const
+    {
+        return cells_ + fineCount_ + (radial / layout_.coarseAzimuthFactor) * coarseCells_;
+    }
+
+    size_t coarseIndex(size_t radial) const { return layout_.radialCount + radial / layout_.coarseAzimuthFactor; }
+
+    size_t getCoarseWidth(size_t cell) const;
+
+    Layout layout_;
+    size_t fineCount_;
+    size_t coarseRows_;
+    size_t coarseCells_;
+    Header* header_;
+    float* cells_;
+    std::atomic<uint32_t>* counts_;
+    std::atomic<uint64_t>* locks_;
+    std::string path_;
+    uint64_t token_;
+    int fd_;
+    bool mapped_;
+};
+
+} // end namespace Algorithms
+} // end namespace SideCar
+
+/** \file
+ */
+
+#endif
@@ -0,0 +1,307 @@
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cmath>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "Logger/Log.h"
+#include "UnitTest/UnitTest.h"
+#include "Utils/FilePath.h"
+
+#include "MapFile.h"
+
+using namespace SideCar::Algorithms;
+
+struct Test : public UnitTest::TestObj {
+    Test() : TestObj("MapFile") {}
+
+    void test();
+};
+
+static std::vector<int16_t>
+Ramp(size_t count, int16_t start, int16_t step)
+{
+    std::vector<int16_t> values(count);
+    for (size_t index = 0; index < count; ++index) values[index] = start + step * index;
+    return values;
+}
+
+/** Obtain the ID of a process that has exited.
+ */
+static pid_t
+DeadProcess()
+{
+    pid_t pid = ::fork();
+    if (pid == 0) ::_exit(0);
+    ::waitpid(pid, 0, 0);
+    return pid;
+}
+
+/** Overwrite a word of a map file the way a runner that died would have left it.
+ */
+static bool
+Poke(const std::string& path, off_t offset, uint64_t value)
+{
+    int fd = ::open(path.c_str(), O_RDWR);
+    if (fd == -1) return false;
+    bool ok = ::pwrite(fd, &value, sizeof(value), offset) == sizeof(value);
+    ::close(fd);
+    return ok;
+}
+
+void
+Test::test()
+{
+    MapFile::Layout layout;
+    layout.radialCount = 4;
+    layout.gateCount = 10;
+
+    // Learning averages the PRIs seen by each radial. Filtering subtracts the map and moves it towards the input.
+    //
+    {
+        MapFile map(layout);
+        assertTrue(map.open("", false));
+        assertFalse(map.isMapped());
+        assertEqual(MapFile::kLearning, map.getState());
+        assertEqual(size_t(40), map.getCellCount());
+
+        map.learn(1, Ramp(10, 100, 10).data(), 10);
+        map.learn(1, Ramp(10, 300, 10).data(), 10);
+        assertTrue(map.freeze());
+        assertFalse(map.freeze());
+        assertTrue(map.isFrozen());
+
+        std::vector<int16_t> input(10, 500);
+        std::vector<int16_t> output(10);
+        map.filter(1, 0.5, input.data(), output.data(), 10);
+        assertEqual(300, output[0]);
+        assertEqual(210, output[9]);
+
+        map.filter(1, 0.5, input.data(), output.data(), 10);
+        assertEqual(150, output[0]);
+
+        // Differences that do not fit in a sample saturate.
+        //
+        input.assign(10, -32768);
+        map.learn(2, input.data(), 10);
+        map.filter(3, 0.0, input.data(), output.data(), 10);
+        assertEqual(-32768, output[0]);
+    }
+
+    // Beyond the coarse start gate, one cell covers several gates and radials.
+    //
+    {
+        MapFile::Layout coarse(layout);
+        coarse.coarseGate = 4;
+        coarse.coarseRangeFactor = 4;
+        coarse.coarseAzimuthFactor = 2;
+        MapFile map(coarse);
+        assertTrue(map.open("", false));
+        assertEqual(size_t(4 * 4 + 2 * 2), map.getCellCount());
+
+        map.learn(0, Ramp(10, 0, 1).data(), 10);
+        map.learn(1, Ramp(10, 100, 1).data(), 10);
+        map.freeze();
+
+        std::vector<int16_t> input(10, 0);
+        std::vector<int16_t> output(10);
+        map.filter(1, 0.0, input.data(), output.data(), 10);
+        assertEqual(-101, output[1]);
+
+        // Gates 4-7 averaged over radials 0 and 1: (4 + 5 + 6 + 7 + 104 + 105 + 106 + 107) / 8
+        //
+        assertEqual(-55, output[4]);
+        assertEqual(-55, output[7]);
+
+        // Gates 8-9: (8 + 9 + 108 + 109) / 4
+        //
+        assertEqual(-58, output[9]);
+    }
+
+    // A map file keeps its contents and state across opens, and is shared by all that map it.
+    //
+    {
+        Utils::TemporaryFilePath path;
+        Utils::TemporaryFilePath lockPath(path.filePath() + ".lock");
+        std::vector<int16_t> input(Ramp(10, 0, 100));
+        std::vector<int16_t> output(10);
+        {
+            MapFile map(layout);
+            assertTrue(map.open(path, true));
+            assertTrue(map.isMapped());
+            map.learn(3, input.data(), 10);
+
+            MapFile other(layout);
+            assertTrue(other.open(path, true));
+            assertEqual(MapFile::kLearning, other.getState());
+            assertTrue(other.freeze());
+            assertTrue(map.isFrozen());
+            assertFalse(map.freeze());
+        }
+
+        {
+            MapFile map(layout);
+            assertTrue(map.open(path, true));
+            assertTrue(map.isFrozen());
+            map.filter(3, 0.0, input.data(), output.data(), 10);
+            for (auto value : output) assertEqual(0, value);
+        }
+
+        // A file with a different layout, or one that may not be reused, starts over.
+        //
+        {
+            MapFile::Layout other(layout);
+            other.radialCount = 8;
+            MapFile map(other);
+            assertTrue(map.open(path, true));
+            assertEqual(MapFile::kLearning, map.getState());
+        }
+
+        {
+            MapFile map(layout);
+            assertTrue(map.open(path, false));
+            assertEqual(MapFile::kLearning, map.getState());
+        }
+
+        // A file in use is never resized under the runners using it. One that may not be reused starts a new
+        // generation of the map for all of them.
+        //
+        {
+            MapFile map(layout);
+            assertTrue(map.open(path, true));
+            map.learn(1, input.data(), 10);
+            assertTrue(map.freeze());
+            uint32_t generation = map.getGeneration();
+
+            MapFile other(layout);
+            assertTrue(other.open(path, true));
+            assertTrue(other.isFrozen());
+            other.filter(1, 0.0, input.data(), output.data(), 10);
+            for (auto value : output) assertEqual(0, value);
+
+            MapFile::Layout bigger(layout);
+            bigger.gateCount = 20;
+            MapFile third(bigger);
+            assertFalse(third.open(path, true));
+            assertTrue(map.isFrozen());
+
+            MapFile fourth(layout);
+            assertTrue(fourth.open(path, false));
+            assertEqual(MapFile::kLearning, map.getState());
+            assertEqual(generation + 1, map.getGeneration());
+
+            // A map that is learning passes samples through.
+            //
+            map.filter(1, 0.0, input.data(), output.data(), 10);
+            assertEqual(input[9], output[9]);
+
+            assertTrue(other.freeze());
+            assertTrue(other.restart());
+            assertEqual(MapFile::kLearning, map.getState());
+            assertEqual(generation + 2, map.getGeneration());
+        }
+    }
+
+    // A freeze or a row lock left behind by a runner that died does not hold up the others. The state word is at
+    // offset 40 of the header, and the row locks follow the 40 cells and 4 counts.
+    //
+    {
+        Utils::TemporaryFilePath path;
+        Utils::TemporaryFilePath lockPath(path.filePath() + ".lock");
+        std::vector<int16_t> input(10, 7);
+        std::vector<int16_t> output(10);
+        uint64_t token = (uint64_t(DeadProcess()) << 16) | 1;
+
+        MapFile map(layout);
+        assertTrue(map.open(path, true));
+        uint32_t generation = map.getGeneration();
+        assertTrue(Poke(path, 40, (token << 2) | MapFile::kFreezing));
+        assertEqual(MapFile::kFreezing, map.getState());
+        map.filter(0, 0.0, input.data(), output.data(), 10);
+        assertEqual(7, output[0]);
+
+        MapFile other(layout);
+        assertTrue(other.open(path, true));
+        assertEqual(MapFile::kLearning, map.getState());
+        assertEqual(generation + 1, map.getGeneration());
+
+        assertTrue(Poke(path, 40, (token << 2) | MapFile::kFreezing));
+        assertTrue(map.recover());
+        assertFalse(other.recover());
+        assertEqual(MapFile::kLearning, other.getState());
+
+        assertTrue(Poke(path, 64 + 40 * 4 + 4 * 4 + 8, token));
+        map.learn(1, input.data(), 10);
+        assertTrue(other.freeze());
+        map.filter(1, 0.0, input.data(), output.data(), 10);
+        assertEqual(0, output[0]);
+
+        // A load() does not wait for a freeze that will never finish.
+        //
+        std::ostringstream os;
+        assertTrue(map.save(os));
+        assertTrue(Poke(path, 40, (token << 2) | MapFile::kFreezing));
+        std::istringstream is(os.str());
+        assertTrue(map.load(is));
+        assertTrue(map.isFrozen());
+    }
+
+    // Runners learning the same radial at the same time lose none of each other's samples.
+    //
+    {
+        Utils::TemporaryFilePath path;
+        Utils::TemporaryFilePath lockPath(path.filePath() + ".lock");
+        std::vector<int16_t> input(10, 1);
+        const int kRounds = 20000;
+        auto learner = [&]() {
+            MapFile map(layout);
+            if (!map.open(path, true)) return;
+            for (int round = 0; round < kRounds; ++round) map.learn(2, input.data(), 10);
+        };
+
+        MapFile map(layout);
+        assertTrue(map.open(path, true));
+        std::thread first(learner);
+        std::thread second(learner);
+        first.join();
+        second.join();
+        assertTrue(map.freeze());
+
+        std::vector<int16_t> zeros(10, 0);
+        std::vector<int16_t> output(10);
+        map.filter(2, 0.0, zeros.data(), output.data(), 10);
+        for (auto value : output) assertEqual(-1, value);
+    }
+
+    // Text export and import.
+    //
+    {
+        MapFile map(layout);
+        assertTrue(map.open("", false));
+        map.learn(0, Ramp(10, 10, 10).data(), 10);
+        map.learn(0, Ramp(10, 30, 10).data(), 10);
+        std::ostringstream os;
+        assertTrue(map.save(os));
+
+        MapFile copy(layout);
+        assertTrue(copy.open("", false));
+        std::istringstream is(os.str());
+        assertTrue(copy.load(is));
+        assertTrue(copy.isFrozen());
+
+        std::vector<int16_t> input(10, 0);
+        std::vector<int16_t> output(10);
+        copy.filter(0, 0.0, input.data(), output.data(), 10);
+        assertEqual(-20, output[0]);
+        assertEqual(-110, output[9]);
+    }
+}
+
+int
+main(int, const char**)
+{
+    return Test().mainRun();
+}
@@ -1,23 +1,21 @@
-#include "ace/ACE.h" // for ACE_DLL_PREFIX
 #include "ace/Notification_Strategy.h"
 #include "ace/Reactor.h"
 
 #include "boost/date_time/posix_time/posix_time.hpp"
 
-#ifdef darwin
-#include <dlfcn.h>
-#endif
-
 #include "IO/ControlMessage.h"
 #include "IO/MessageManager.h"
 #include "IO/Module.h"
 #include "IO/ProcessingStateChangeRequest.h"
 #include "IO/RecordingStateChangeRequest.h"
 #include "Logger/Log.h"
+#include "Threading/Threading.h"
 #include "Utils/FilePath.h"
+#include "Utils/StartupTrace.h"
 #include "XMLRPC/XmlRpcValue.h"
 
 #include "Algorithm.h"
+#include "AlgorithmLoader.h"
 #include "Controller.h"
 #include "Recorder.h"
 
@@ -156,7 +154,13 @@ Controller::openAndInit(const std::string& algorithmName, const std::string& ser
 
     // Initialize it
     //
-    if (!algorithm_->startup()) {
+    bool ok;
+    {
+        Utils::StartupTrace::Scope trace("startup", getTaskName());
+        ok = algorithm_->startup();
+    }
+
+    if (!ok) {
         LOGERROR << "failed algorithm startup" << std::endl;
         setError("Failed to start algorithm");
         return false;
@@ -165,6 +169,7 @@ Controller::openAndInit(const std::string& algorithmName, const std::string& ser
     if (threaded_) {
         // Start a consumer thread for algorithmm processing
         //
+        Utils::StartupTrace::Scope trace("thread", getTaskName());
         if (activate(threadFlags, 1, 0, threadPriority) == -1) {
             LOGERROR << "failed to start service thread" << std::endl;
             setError("Failed to start service thread");
@@ -245,49 +250,18 @@ Controller::close(u_long flags)
     return 0;
 }
 
-/** Prototype for the algorithm factory method that must exist in the DLL.
- */
-using AlgorithmMaker = Algorithm* (*)(Controller&, Logger::Log&);
-
 bool
 Controller::loadAlgorithm()
 {
     Logger::ProcLog log("loadAlgorithm", Log());
     LOGINFO << algorithmName_ << std::endl;
 
-    // Construct the name of the DLL we wish to load
-    //
-    std::string path(ACE_DLL_PREFIX);
-    path += algorithmName_;
-    LOGDEBUG << "path: " << path << std::endl;
-
-    // Attempt to load/open the DLL.
-    //
-    ACE_DLL* dll = new ACE_DLL;
-    int rc = dll->open(path.c_str());
-    if (rc != 0) {
-        LOGERROR << "failed to locate DLL '" << path << "' - " << rc << ' ' << errno << std::endl;
-#ifdef darwin
-        LOGERROR << dlerror() << std::endl;
-#endif
-        return false;
-    }
-
-    // Create the algorithm factory method that will create an Algorthm object for us.
+    // Obtain the factory method that will create an Algorthm object for us. The DLL may already be loaded for
+    // another controller, or by a preload of the runner's algorithms.
     //
-    std::string makerName(algorithmName_);
-    makerName += "Make";
-    LOGDEBUG << "makerName: " << makerName << std::endl;
-
-    // Attempt to resolve the factory method
-    //
-    union {
-        void* v;
-        AlgorithmMaker p;
-    } symbol;
-    symbol.v = dll->symbol(makerName.c_str());
-    if (!symbol.v) {
-        LOGERROR << "failed to obtain factory method '" << makerName << "' from DLL" << std::endl;
+    AlgorithmLoader::Maker maker = AlgorithmLoader::Instance().getMaker(algorithmName_);
+    if (!maker) {
+        LOGERROR << "failed to load DLL for algorithm '" << algorithmName_ << "'" << std::endl;
         return false;
     }
 
@@ -296,13 +270,20 @@ Controller::loadAlgorithm()
     std::string logPath("SideCar.Algorithms.");
     logPath += algorithmName_;
 
-    // Attempt to create an Algorithm object to control.
+    // Attempt to create an Algorithm object to control. Each Algorithm holds a vsip::vsipl object, whose
+    // library reference counting is not thread-safe, so create one at a time in case streams are being built in
+    // parallel.
     //
     Logger::Log& logDevice = Logger::Log::Find(logPath);
     logDevice.setPriorityLimit(logLevel_->getValue());
-    algorithm_.reset(symbol.p(*this, logDevice));
+    {
+        static Threading::Mutex::Ref mutex_ = Threading::Mutex::Make();
+        Threading::Locker lock(mutex_);
+        algorithm_.reset(maker(*this, logDevice));
+    }
+
     if (!algorithm_) {
-        LOGERROR << "failed to create algorithm using factory method '" << makerName << "'" << std::endl;
+        LOGERROR << "failed to create algorithm using factory method '" << algorithmName_ << "Make'" << std::endl;
         return false;
     }
 
@@ -338,7 +319,10 @@ Controller::send(const Messages::Header::Ref& message, size_t channelIndex)
         }
     }
 
-    return Super::sendManaged(manager, channelIndex);
+    processingStat_.beginSend();
+    bool ok = Super::sendManaged(manager, channelIndex);
+    processingStat_.endSend();
+    return ok;
 }
 
 bool
@@ -420,6 +404,9 @@ Controller::processDataMessage(ACE_Message_Block* data)
     LOGINFO << "msg type: " << mgr.getNativeMessageType() << std::endl;
     Messages::Header::Ref msg(mgr.getNative());
 
+    // Record how long the message sat in our queue before we got to it.
+    //
+    processingStat_.addQueueWaitSample(Time::TimeStamp::Now() - mgr.getPostedTimeStamp());
     processingStat_.beginProcessing();
 
     if (!algorithm_->process(msg, data->msg_priority())) {
@@ -603,6 +590,12 @@ Controller::fillStatus(IO::StatusBase& status)
     status.setSlot(ControllerStatus::kAverageProcessingTime, processingStat_.getAverageProcessingTime());
     status.setSlot(ControllerStatus::kMinimumProcessingTime, processingStat_.getMinimumProcessingTime());
     status.setSlot(ControllerStatus::kMaximumProcessingTime, processingStat_.getMaximumProcessingTime());
+    status.setSlot(ControllerStatus::kQueueWaitLatency,
+                   ControllerStatus::MakeLatencySummary(processingStat_.getQueueWaitLatency()));
+    status.setSlot(ControllerStatus::kProcessingLatency,
+                   ControllerStatus::MakeLatencySummary(processingStat_.getProcessingLatency()));
+    status.setSlot(ControllerStatus::kSendLatency,
+                   ControllerStatus::MakeLatencySummary(processingStat_.getSendLatency()));
 
     // If the algorithm says that it has some status slots, give it a chance to add them to the XML status
     // object.
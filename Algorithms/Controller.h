@@ -224,8 +224,8 @@ private:
     */
     bool send(const Messages::Header::Ref& msg, size_t channelIndex) override;
 
-    /** Load the DLL library containing the algorithm class to instantiate, and attempt to create a new
-        algorithm object.
+    /** Obtain from AlgorithmLoader the factory method of the algorithm class to instantiate, which loads the
+        DLL library containing it if not done already, and attempt to create a new algorithm object.
     */
     bool loadAlgorithm();
 
@@ -1,3 +1,20 @@
+#include "Utils/LatencyHistogram.h"
+
 #include "ControllerStatus.h"
 
 using namespace SideCar::Algorithms;
+
+XmlRpc::XmlRpcValue
+ControllerStatus::MakeLatencySummary(const ::Utils::LatencyHistogram& histogram)
+{
+    XmlRpc::XmlRpcValue summary;
+    summary.setSize(kLatencyNumSlots);
+    summary[kLatencyCount] = int(histogram.getCount());
+    summary[kLatencyMean] = histogram.getMeanValue() * 1.0E-6;
+    summary[kLatencyP50] = histogram.getValueAtPercentile(50.0) * 1.0E-6;
+    summary[kLatencyP90] = histogram.getValueAtPercentile(90.0) * 1.0E-6;
+    summary[kLatencyP99] = histogram.getValueAtPercentile(99.0) * 1.0E-6;
+    summary[kLatencyP999] = histogram.getValueAtPercentile(99.9) * 1.0E-6;
+    summary[kLatencyMax] = histogram.getMaximumValue() * 1.0E-6;
+    return summary;
+}
@@ -3,11 +3,18 @@
 
 #include "IO/TaskStatus.h"
 
+namespace Utils {
+class LatencyHistogram;
+}
+
 namespace SideCar {
 namespace Algorithms {
 
 /** Status information reported by an algorithm controller. Contains recording status information, and custom
     info data and formatter specification obtained by the Algorithm::getInfoData() method.
+
+    The kQueueWaitLatency, kProcessingLatency, and kSendLatency slots each hold a latency summary array created
+    by MakeLatencySummary(), indexed by the LatencySummaryIndex values.
 */
 class ControllerStatus : public IO::TaskStatus {
 public:
@@ -21,11 +28,35 @@ public:
         kAverageProcessingTime,
         kMinimumProcessingTime,
         kMaximumProcessingTime,
+        kQueueWaitLatency,
+        kProcessingLatency,
+        kSendLatency,
         kNumSlots
     };
 
+    /** Indices of the values in a latency summary array. Durations are in seconds.
+     */
+    enum LatencySummaryIndex {
+        kLatencyCount = 0,
+        kLatencyMean,
+        kLatencyP50,
+        kLatencyP90,
+        kLatencyP99,
+        kLatencyP999,
+        kLatencyMax,
+        kLatencyNumSlots
+    };
+
     static const char* GetClassName() { return "ControllerStatus"; }
 
+    /** Create an XML-RPC latency summary array from the contents of a histogram.
+
+        \param histogram the source of the values
+
+        \return new XML-RPC array
+    */
+    static XmlRpc::XmlRpcValue MakeLatencySummary(const ::Utils::LatencyHistogram& histogram);
+
     ControllerStatus(const XmlRpc::XmlRpcValue& status) : IO::TaskStatus(status) {}
 
     bool isRecordingEnabled() const { return getSlot(kRecordingEnabled); }
@@ -39,6 +70,10 @@ public:
     double getAverageProcessingTime() const { return getSlot(kAverageProcessingTime); }
     double getMinimumProcessingTime() const { return getSlot(kMinimumProcessingTime); }
     double getMaximumProcessingTime() const { return getSlot(kMaximumProcessingTime); }
+
+    const XmlRpc::XmlRpcValue& getQueueWaitLatency() const { return getSlot(kQueueWaitLatency); }
+    const XmlRpc::XmlRpcValue& getProcessingLatency() const { return getSlot(kProcessingLatency); }
+    const XmlRpc::XmlRpcValue& getSendLatency() const { return getSlot(kSendLatency); }
 };
 
 } // end namespace Algorithms
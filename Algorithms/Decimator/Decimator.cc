@@ -1,5 +1,7 @@
-#include <algorithm>  // for std::transform
-#include <functional> // for std::bind* and std::mem_fun*
+#include <fstream>
+#include <vector>
+
+#include "boost/bind.hpp"
 
 #include "Algorithms/Controller.h"
 #include "Logger/Log.h"
@@ -18,9 +20,11 @@ using namespace SideCar::Algorithms;
 Decimator::Decimator(Controller& controller, Logger::Log& log) :
     Super(controller, log), enabled_(Parameter::BoolValue::Make("enabled", "Enabled", kDefaultEnabled)),
     isIQ_(Parameter::BoolValue::Make("isIQ", "Is the data composed of IQ values", kDefaultIsIQ)),
-    factor_(Parameter::PositiveIntValue::Make("factor", "Decimation factor", kDefaultFactor))
+    factor_(Parameter::PositiveIntValue::Make("factor", "Decimation factor", kDefaultFactor)),
+    kernelFile_(Parameter::StringValue::Make("kernelFile", "Anti-alias kernel file", kDefaultKernelFile)), filter_()
 {
-    ;
+    factor_->connectChangedSignalTo(boost::bind(&Decimator::filterChanged, this, _1));
+    kernelFile_->connectChangedSignalTo(boost::bind(&Decimator::filterChanged, this, _1));
 }
 
 // Startup routine. This is called right after the Controller loads our DLL and creates an instance of the Decimator
@@ -32,9 +36,43 @@ Decimator::startup()
 {
     registerProcessor<Decimator, Messages::Video>(&Decimator::processInput);
     bool ok = true;
-    ok = ok && registerParameter(isIQ_) && registerParameter(factor_) && registerParameter(enabled_);
+    ok = ok && registerParameter(isIQ_) && registerParameter(factor_) && registerParameter(enabled_) &&
+         registerParameter(kernelFile_);
+
+    return ok && buildFilter() && Super::startup();
+}
+
+void
+Decimator::filterChanged(const Parameter::ValueBase& parameter)
+{
+    Logger::ProcLog log("filterChanged", getLog());
+    LOGINFO << parameter.getName() << " changed" << std::endl;
+    buildFilter();
+}
+
+bool
+Decimator::buildFilter()
+{
+    Logger::ProcLog log("buildFilter", getLog());
+
+    std::string file = kernelFile_->getValue();
+    if (file.empty()) {
+        boost::atomic_store(&filter_, FIRFilter::Ref());
+        return true;
+    }
 
-    return ok && Super::startup();
+    std::ifstream input(file.c_str());
+    std::vector<float> taps;
+    if (!FIRFilter::ReadTaps(input, taps)) {
+        LOGERROR << "unable to load anti-alias kernel from " << file << std::endl;
+        return false;
+    }
+
+    // Build the new filter off to the side and swap it in so that processInput() never waits on a rebuild.
+    //
+    boost::atomic_store(&filter_, FIRFilter::Ref(new FIRFilter(taps, 1, factor_->getValue(), (taps.size() - 1) / 2)));
+    LOGINFO << "loaded " << taps.size() << " taps from " << file << std::endl;
+    return true;
 }
 
 bool
@@ -64,9 +102,21 @@ Decimator::processInput(const Messages::Video::Ref& msg)
     int step = factor_->getValue();
     bool isIQ = isIQ_->getValue();
 
-    // Perform the actual decimation.
+    // Filter and decimate in one pass when there is an anti-alias kernel. The filter may lag a change to the factor
+    // by a message, so use its factor for the range update.
     //
-    if (isIQ) {
+    FIRFilter::Ref filter(boost::atomic_load(&filter_));
+    if (filter) {
+        step = filter->getDecimation();
+        const Messages::Video::Container& input(msg->getData());
+        size_t count = isIQ ? input.size() / 2 : input.size();
+        out->resize(filter->getOutputSize(count) * (isIQ ? 2 : 1));
+        if (isIQ) {
+            filter->filterIQ(input.data(), count, out->getData().data());
+        } else {
+            filter->filter(input.data(), count, out->getData().data());
+        }
+    } else if (isIQ) {
         int inc = step * 2 - 1;
         while (pos < end) {
             out->push_back(*pos++);
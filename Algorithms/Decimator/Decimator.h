@@ -2,14 +2,23 @@
 #define SIDECAR_ALGORITHMS_DECIMATOR_H
 
 #include "Algorithms/Algorithm.h"
+#include "Algorithms/FIRFilter.h"
 #include "Messages/Video.h"
 #include "Parameter/Parameter.h"
 
 namespace SideCar {
 namespace Algorithms {
 
-/** Documentation for the algorithm Decimator. Please describe what the algorithm does, in layman's terms and,
-    if possible, mathematical terms.
+/** Reduce the number of range samples in a PRI by an integer factor D. Without a kernel, the algorithm keeps every
+    D-th sample (or I/Q pair). With an anti-alias kernel h[0..K-1] from the file named by the kernelFile parameter,
+    output m is instead
+
+    \code
+    y[m] = sum over k of h[k] * x[m * D + k - (K - 1) / 2]
+    \endcode
+
+    so that a symmetric kernel stays centered on the sample that picking would keep. Only the kept outputs are
+    computed (see FIRFilter).
 */
 class Decimator : public Algorithm {
     using Super = Algorithm;
@@ -44,6 +53,15 @@ public:
 private:
     size_t getNumInfoSlots() const { return kNumSlots; }
 
+    void filterChanged(const Parameter::ValueBase& parameter);
+
+    /** Rebuild the anti-alias filter from the kernel file and the decimation factor. An empty kernelFile value
+        removes the filter.
+
+        \return true if successful
+    */
+    bool buildFilter();
+
     void setInfoSlots(IO::StatusBase& status);
 
     /** Process messages from channel
@@ -59,6 +77,8 @@ private:
     Parameter::BoolValue::Ref enabled_;
     Parameter::BoolValue::Ref isIQ_;
     Parameter::PositiveIntValue::Ref factor_;
+    Parameter::StringValue::Ref kernelFile_;
+    FIRFilter::Ref filter_;
 };
 
 } // end namespace Algorithms
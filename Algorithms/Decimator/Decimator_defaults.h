@@ -1,3 +1,4 @@
 static const bool kDefaultEnabled = 1;
 static const bool kDefaultIsIQ = 1;
 static const int kDefaultFactor = 1;
+static const char* const kDefaultKernelFile = "";
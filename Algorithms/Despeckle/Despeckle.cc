@@ -1,4 +1,4 @@
-#include <algorithm> // for std::swap
+#include <cmath>
 
 #include "Logger/Log.h"
 
@@ -11,9 +11,12 @@ using namespace SideCar::Messages;
 Despeckle::Despeckle(Controller& controller, Logger::Log& log) :
     Algorithm(controller, log), varianceMultiplier_(Parameter::DoubleValue::Make(
                                     "varianceMultiplier", "Variance Multiplier", kDefaultVarianceMultiplier)),
-    past_(3)
+    tile_(3, 1), middle_(), newest_(), neighbours_(), median_(), variance_()
 {
-    ;
+    // The neighbourhood is the PRIs before and after the one being examined.
+    //
+    neighbours_.push_back(0);
+    neighbours_.push_back(2);
 }
 
 bool
@@ -26,7 +29,9 @@ Despeckle::startup()
 bool
 Despeckle::reset()
 {
-    past_.clear();
+    tile_.clear();
+    middle_.reset();
+    newest_.reset();
     return true;
 }
 
@@ -35,15 +40,17 @@ Despeckle::process(Messages::Video::Ref in0)
 {
     static Logger::ProcLog log("process", getLog());
 
-    LOGTIN << past_.size() << std::endl;
+    LOGTIN << tile_.size() << std::endl;
 
-    past_.add(in0);
-    if (!past_.full()) {
+    tile_.add(in0->getData().data(), in0->size());
+    middle_ = newest_;
+    newest_ = in0;
+    if (!tile_.full()) {
         LOGTOUT << std::endl;
         return true;
     }
 
-    size_t gateCount = past_.getMaxMsgSize();
+    size_t gateCount = tile_.getWidth();
     if (gateCount < 1) {
         LOGERROR << "invalid gate count" << std::endl;
         return true;
@@ -51,60 +58,33 @@ Despeckle::process(Messages::Video::Ref in0)
 
     LOGDEBUG << "gate count: " << gateCount << std::endl;
 
-    Messages::Video::Ref in1 = past_[1];
-    Messages::Video::Ref in2 = past_[2];
-    Messages::Video::Ref out(Messages::Video::Make(getName(), in1));
+    // Find the median of the neighbouring PRIs and the variance about it for every gate at once.
+    //
+    median_.resize(gateCount);
+    variance_.resize(gateCount);
+    tile_.median(neighbours_, 1, median_.data());
+    tile_.squaredDeviation(neighbours_, 1, median_.data(), variance_.data());
+
+    Messages::Video::Ref out(Messages::Video::Make(getName(), middle_));
     out->resize(gateCount, 0);
 
-    VideoT sort[6];
-    out[0] = in1[0];
-    out[gateCount - 1] = in1[gateCount - 1];
+    const float* in1 = tile_.getRow(1);
+    out[0] = VideoT(in1[0]);
+    out[gateCount - 1] = VideoT(in1[gateCount - 1]);
 
     float varianceMultiplier = varianceMultiplier_->getValue();
     int changedCounter = 0;
 
     for (size_t index = 1; index < gateCount - 1; ++index) {
-        // Find the median of the neighboring PRIs -- use a simple sorting network
+        float median = median_[index];
+        int value = int(in1[index]);
+
+        // Final threshold test
         //
-        sort[0] = in2[index - 1];
-        sort[1] = in2[index];
-        sort[2] = in2[index + 1];
-        sort[3] = in0[index - 1];
-        sort[4] = in0[index];
-        sort[5] = in0[index + 1];
-
-        Sort(sort[0], sort[1]);
-        Sort(sort[3], sort[4]);
-        Sort(sort[0], sort[2]);
-        Sort(sort[3], sort[5]);
-        Sort(sort[1], sort[2]);
-        Sort(sort[4], sort[5]);
-        Sort(sort[0], sort[3]);
-        Sort(sort[1], sort[4]);
-        Sort(sort[2], sort[5]);
-        Sort(sort[1], sort[3]);
-        Sort(sort[2], sort[4]);
-
-        float median = (sort[2] + sort[3]) * 0.5;
-
-        int value = in1[index];
-        if (value > median) {
-            // Calculate the variance about the median
-            //
-            float variance = 0;
-            for (int i = -1; i < 2; ++i) {
-                float a = in2[index + i] - median;
-                float b = in0[index + i] - median;
-                variance += a * a + b * b;
-            }
-
-            // Final threshold test
-            //
-            float dist = value - median;
-            if (dist * dist > varianceMultiplier * variance) {
-                value = VideoT(::rint(median));
-                ++changedCounter;
-            }
+        float dist = value - median;
+        if (value > median && dist * dist > varianceMultiplier * variance_[index]) {
+            value = VideoT(::rint(median));
+            ++changedCounter;
         }
 
         out[index] = value;
@@ -1,8 +1,10 @@
 #ifndef SIDECAR_ALGORITHMS_DESPECKLE_H // -*- C++ -*-
 #define SIDECAR_ALGORITHMS_DESPECKLE_H
 
+#include <vector>
+
 #include "Algorithms/Algorithm.h"
-#include "Algorithms/PastBuffer.h"
+#include "Algorithms/VideoTile.h"
 #include "Messages/Video.h"
 
 namespace SideCar {
@@ -11,11 +13,13 @@ namespace Algorithms {
 /** Attempts to suppress noise using a modified median filter. Delays the output by 2 PRIs.
 
     \par Pseudocode:
-    In the 3x3 block about each cell,
+    In the 3x3 block about each cell of the middle of the last three PRIs,
     - Find the median of the samples not in this PRI
     - Find the variance of those samples about their median
     - If the center > median + k*variance, set center=median
 
+    The three PRIs live in a VideoTile, which finds the medians and variances of all gates of a PRI at once.
+
     \par Input Messages:
     - Messages::Video containing the video data
 
@@ -47,14 +51,14 @@ private:
     //
     Parameter::DoubleValue::Ref varianceMultiplier_;
 
-    // Past buffer
+    // The last three PRIs. The tile holds their samples, and the messages supply the header of the output.
     //
-    PastBuffer<Messages::Video> past_;
-
-    static void Sort(VideoT& a, VideoT& b)
-    {
-        if (a > b) std::swap(a, b);
-    }
+    VideoTile tile_;
+    Messages::Video::Ref middle_;
+    Messages::Video::Ref newest_;
+    std::vector<size_t> neighbours_;
+    std::vector<float> median_;
+    std::vector<float> variance_;
 };
 
 } // namespace Algorithms
@@ -0,0 +1,252 @@
+#include <errno.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+
+#include <fftw3.h>
+
+#include "ace/Guard_T.h"
+#include "Logger/Log.h"
+#include "Time/TimeStamp.h"
+#include "Utils/FilePath.h"
+
+#include "FFTEngine.h"
+
+using namespace SideCar::Algorithms;
+
+const char* const FFTEngine::kDefaultWisdomPath = "$SIDECAR/data/fftwf.wisdom";
+
+static_assert(sizeof(FFTEngine::Complex) == sizeof(fftwf_complex), "std::complex<float> must match fftwf_complex");
+
+Logger::Log&
+FFTEngine::Log()
+{
+    static Logger::Log& log_ = Logger::Log::Find("SideCar.Algorithms.FFTEngine");
+    return log_;
+}
+
+FFTEngine::Buffer::Buffer(size_t size) : data_(0), size_(0)
+{
+    resize(size);
+}
+
+FFTEngine::Buffer::~Buffer()
+{
+    if (data_) ::fftwf_free(data_);
+}
+
+void
+FFTEngine::Buffer::resize(size_t size)
+{
+    if (size == size_) return;
+    if (data_) ::fftwf_free(data_);
+    data_ = size ? static_cast<Complex*>(::fftwf_malloc(size * sizeof(Complex))) : 0;
+    size_ = size;
+}
+
+FFTEngine::Plan::Plan(void* plan, size_t size, size_t count, Direction direction, Layout layout, bool inPlace,
+                      size_t threads) :
+    plan_(plan),
+    size_(size), count_(count), direction_(direction), layout_(layout), inPlace_(inPlace), threads_(threads)
+{
+    ;
+}
+
+FFTEngine::Plan::~Plan()
+{
+    // Plans are only destroyed by FFTEngine::purge() or at exit, both of which are safe from concurrent planning.
+    //
+    ::fftwf_destroy_plan(static_cast<fftwf_plan>(plan_));
+}
+
+void
+FFTEngine::Plan::execute(const Complex* input, Complex* output) const
+{
+    assert(::fftwf_alignment_of(reinterpret_cast<float*>(const_cast<Complex*>(input))) == 0);
+    assert(::fftwf_alignment_of(reinterpret_cast<float*>(output)) == 0);
+    assert(inPlace_ == (input == output));
+
+    // Complex transforms preserve their input when out-of-place, so the cast is safe.
+    //
+    ::fftwf_execute_dft(static_cast<fftwf_plan>(plan_),
+                        reinterpret_cast<fftwf_complex*>(const_cast<Complex*>(input)),
+                        reinterpret_cast<fftwf_complex*>(output));
+}
+
+bool
+FFTEngine::Key::operator<(const Key& rhs) const
+{
+    if (size != rhs.size) return size < rhs.size;
+    if (count != rhs.count) return count < rhs.count;
+    if (direction != rhs.direction) return direction < rhs.direction;
+    if (layout != rhs.layout) return layout < rhs.layout;
+    if (inPlace != rhs.inPlace) return inPlace < rhs.inPlace;
+    return threads < rhs.threads;
+}
+
+FFTEngine&
+FFTEngine::Instance()
+{
+    static FFTEngine engine_;
+    return engine_;
+}
+
+FFTEngine::FFTEngine() : mutex_(), plans_(), wisdomPath_(), threaded_(::fftwf_init_threads() != 0)
+{
+    Logger::ProcLog log("FFTEngine", Log());
+    if (!threaded_) LOGERROR << "failed fftwf_init_threads - plans will use one thread" << std::endl;
+
+    const char* path = ::getenv("SIDECAR_FFTW_WISDOM");
+    setWisdomPath(path ? path : kDefaultWisdomPath);
+}
+
+void
+FFTEngine::setWisdomPath(const std::string& path)
+{
+    wisdomPath_ = path.empty() ? path : Utils::FilePath(path).filePath();
+    if (!wisdomPath_.empty()) loadWisdom(wisdomPath_);
+}
+
+bool
+FFTEngine::loadWisdom(const std::string& path)
+{
+    Logger::ProcLog log("loadWisdom", Log());
+    ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
+    if (!::fftwf_import_wisdom_from_filename(path.c_str())) {
+        LOGWARNING << "no usable wisdom in '" << path << "'" << std::endl;
+        return false;
+    }
+
+    LOGINFO << "loaded wisdom from '" << path << "'" << std::endl;
+    return true;
+}
+
+bool
+FFTEngine::saveWisdom(const std::string& path) const
+{
+    Logger::ProcLog log("saveWisdom", Log());
+
+    // Write to a unique file in the same directory and then rename it over the old one, so that readers never
+    // see a partial file and other processes saving at the same time do not write to the same temporary file.
+    //
+    ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
+    std::string tmp(path + ".XXXXXX");
+    int fd = ::mkstemp(&tmp[0]);
+    if (fd == -1) {
+        LOGERROR << "failed to create '" << tmp << "' - " << errno << ' ' << strerror(errno) << std::endl;
+        return false;
+    }
+
+    ::fchmod(fd, 0644);
+    FILE* file = ::fdopen(fd, "w");
+    if (!file) {
+        LOGERROR << "failed to open '" << tmp << "' - " << errno << ' ' << strerror(errno) << std::endl;
+        ::close(fd);
+        ::unlink(tmp.c_str());
+        return false;
+    }
+
+    ::fftwf_export_wisdom_to_file(file);
+
+    bool failed = ::ferror(file);
+    if (::fclose(file) != 0) failed = true;
+    if (failed) {
+        LOGERROR << "failed to write wisdom to '" << tmp << "'" << std::endl;
+        ::unlink(tmp.c_str());
+        return false;
+    }
+
+    if (::rename(tmp.c_str(), path.c_str()) == -1) {
+        LOGERROR << "failed to rename '" << tmp << "' to '" << path << "' - " << errno << ' ' << strerror(errno)
+                 << std::endl;
+        ::unlink(tmp.c_str());
+        return false;
+    }
+
+    LOGINFO << "saved wisdom to '" << path << "'" << std::endl;
+    return true;
+}
+
+FFTEngine::Plan::Ref
+FFTEngine::getPlan(size_t size, size_t count, Direction direction, Layout layout, bool inPlace, size_t threads)
+{
+    if (!threaded_ || threads == 0) threads = 1;
+    Key key = {size, count, direction, layout, inPlace, threads};
+
+    Plan::Ref plan;
+    {
+        ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
+        PlanMap::const_iterator pos = plans_.find(key);
+        if (pos != plans_.end()) return pos->second;
+        plan = makePlan(key);
+        if (!plan) return plan;
+        plans_.insert(PlanMap::value_type(key, plan));
+    }
+
+    if (!wisdomPath_.empty()) saveWisdom(wisdomPath_);
+    return plan;
+}
+
+FFTEngine::Plan::Ref
+FFTEngine::makePlan(const Key& key)
+{
+    Logger::ProcLog log("makePlan", Log());
+    LOGINFO << "size: " << key.size << " count: " << key.count << " direction: " << key.direction
+            << " layout: " << key.layout << " inPlace: " << key.inPlace << " threads: " << key.threads << std::endl;
+
+    if (key.size == 0 || key.count == 0) return Plan::Ref();
+
+    // Plan with scratch buffers, since FFTW_MEASURE overwrites them. Buffers from fftwf_malloc() all share the
+    // same alignment, so the plan works on any of them.
+    //
+    int n = int(key.size);
+    int howMany = int(key.count);
+    int stride = key.layout == kRows ? 1 : howMany;
+    int distance = key.layout == kRows ? n : 1;
+    Buffer input(key.size * key.count);
+    Buffer output(key.inPlace ? 0 : key.size * key.count);
+    fftwf_complex* in = reinterpret_cast<fftwf_complex*>(input.data());
+    fftwf_complex* out = key.inPlace ? in : reinterpret_cast<fftwf_complex*>(output.data());
+
+    Time::TimeStamp start(Time::TimeStamp::Now());
+    if (threaded_) ::fftwf_plan_with_nthreads(int(key.threads));
+    fftwf_plan plan = ::fftwf_plan_many_dft(1, &n, howMany, in, 0, stride, distance, out, 0, stride, distance,
+                                            key.direction == kForward ? FFTW_FORWARD : FFTW_BACKWARD,
+                                            FFTW_MEASURE);
+    if (threaded_) ::fftwf_plan_with_nthreads(1);
+
+    if (!plan) {
+        LOGERROR << "FFTW failed to make a plan" << std::endl;
+        return Plan::Ref();
+    }
+
+    LOGINFO << "planned in " << (Time::TimeStamp::Now() - start).asDouble() << " seconds" << std::endl;
+    return Plan::Ref(new Plan(plan, key.size, key.count, key.direction, key.layout, key.inPlace, key.threads));
+}
+
+size_t
+FFTEngine::getPlanCount() const
+{
+    ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
+    return plans_.size();
+}
+
+void
+FFTEngine::purge()
+{
+    // A plan held only by the map cannot be handed out while the mutex is held, so it is safe to destroy it.
+    //
+    ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
+    PlanMap::iterator pos = plans_.begin();
+    while (pos != plans_.end()) {
+        if (pos->second.use_count() == 1) {
+            plans_.erase(pos++);
+        } else {
+            ++pos;
+        }
+    }
+}
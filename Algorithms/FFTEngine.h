@@ -0,0 +1,225 @@
+#ifndef SIDECAR_ALGORITHMS_FFTENGINE_H // -*- C++ -*-
+#define SIDECAR_ALGORITHMS_FFTENGINE_H
+
+#include <complex>
+#include <map>
+#include <string>
+
+#include "ace/Thread_Mutex.h"
+#include "boost/shared_ptr.hpp"
+
+namespace Logger {
+class Log;
+}
+
+namespace SideCar {
+namespace Algorithms {
+
+/** Process-wide source of single-precision complex FFTW plans. Algorithms that perform FFTs ask for a plan by
+    transform size, number of transforms, direction, and data layout, and receive a shared plan that stays valid
+    for as long as they hold it. Plans are built once per process and reused by every algorithm and thread that
+    asks for the same transform, so a parameter change that returns to a previous size costs nothing.
+
+    FFTW learns the fastest way to compute a transform by timing alternatives, which can take seconds for large
+    sizes. The results of that learning (FFTW's "wisdom") are loaded from a file when the engine is first used and
+    written back whenever a new plan is made, so a restarted runner plans in microseconds. The file is given by
+    the SIDECAR_FFTW_WISDOM environment variable, or kDefaultWisdomPath if it is not set; an empty value disables
+    persistence.
+
+    A plan may be executed by several threads at once, as long as each uses its own buffers. Buffers must have
+    the alignment of those from Buffer, which FFTW requires for its SIMD kernels.
+*/
+class FFTEngine {
+public:
+    using Complex = std::complex<float>;
+
+    enum Direction { kForward, kInverse };
+
+    /** Arrangement of a batch of transforms in memory. For kRows, transform N starts at element N * size and
+        takes successive elements. For kColumns, the data is a matrix of size rows by count columns in row-major
+        order, and each column is transformed; this is the layout of a CPI with one PRI per row, transformed
+        across PRIs.
+    */
+    enum Layout { kRows, kColumns };
+
+    static const char* const kDefaultWisdomPath;
+
+    /** Block of complex values allocated by FFTW with the alignment that its plans expect. Not copyable.
+     */
+    class Buffer {
+    public:
+        explicit Buffer(size_t size = 0);
+
+        ~Buffer();
+
+        /** Change the number of values held. Contents are not preserved.
+
+            \param size new size
+        */
+        void resize(size_t size);
+
+        size_t size() const { return size_; }
+
+        Complex* data() { return data_; }
+
+        const Complex* data() const { return data_; }
+
+        Complex& operator[](size_t index) { return data_[index]; }
+
+        const Complex& operator[](size_t index) const { return data_[index]; }
+
+    private:
+        Buffer(const Buffer&);
+        Buffer& operator=(const Buffer&);
+
+        Complex* data_;
+        size_t size_;
+    };
+
+    /** A batch of transforms prepared by FFTW. Obtained from FFTEngine::getPlan().
+     */
+    class Plan {
+    public:
+        using Ref = boost::shared_ptr<const Plan>;
+
+        ~Plan();
+
+        /** Perform the transforms. Inverse transforms are not normalized: transforming forward and back scales
+            the values by the transform size.
+
+            \param input values to transform; must hold getSize() * getCount() values
+
+            \param output location for the results; may equal \p input only if the plan is in-place
+        */
+        void execute(const Complex* input, Complex* output) const;
+
+        /** Perform the transforms in-place.
+
+            \param data values to transform and location for the results
+        */
+        void execute(Complex* data) const { execute(data, data); }
+
+        size_t getSize() const { return size_; }
+
+        size_t getCount() const { return count_; }
+
+        size_t getThreadCount() const { return threads_; }
+
+        Direction getDirection() const { return direction_; }
+
+        Layout getLayout() const { return layout_; }
+
+        bool isInPlace() const { return inPlace_; }
+
+    private:
+        Plan(void* plan, size_t size, size_t count, Direction direction, Layout layout, bool inPlace,
+             size_t threads);
+
+        void* plan_;
+        size_t size_;
+        size_t count_;
+        Direction direction_;
+        Layout layout_;
+        bool inPlace_;
+        size_t threads_;
+
+        friend class FFTEngine;
+    };
+
+    static Logger::Log& Log();
+
+    /** Obtain the engine for the process, creating it and loading any saved wisdom on first use.
+
+        \return engine reference
+    */
+    static FFTEngine& Instance();
+
+    /** Obtain a plan for a batch of transforms, building it if this is the first request for such a batch.
+
+        \param size number of points in each transform
+
+        \param count number of transforms in the batch
+
+        \param direction kForward or kInverse
+
+        \param layout arrangement of the transforms in memory
+
+        \param inPlace true if the results will overwrite the input
+
+        \param threads number of threads FFTW may use to run the batch. Only worthwhile for large batches, such as
+        a whole CPI.
+
+        \return new or shared plan; null if FFTW could not make one
+    */
+    Plan::Ref getPlan(size_t size, size_t count = 1, Direction direction = kForward, Layout layout = kRows,
+                      bool inPlace = false, size_t threads = 1);
+
+    /** Merge wisdom from a file into what FFTW knows.
+
+        \param path location of the file
+
+        \return true if successful
+    */
+    bool loadWisdom(const std::string& path);
+
+    /** Write all that FFTW knows to a file. The file is replaced atomically so that concurrent readers never see a
+        partial file.
+
+        \param path location of the file
+
+        \return true if successful
+    */
+    bool saveWisdom(const std::string& path) const;
+
+    /** Change the file used to persist wisdom, and load from it. An empty path disables persistence.
+
+        \param path location of the file
+    */
+    void setWisdomPath(const std::string& path);
+
+    const std::string& getWisdomPath() const { return wisdomPath_; }
+
+    /** Obtain the number of distinct plans made.
+
+        \return plan count
+    */
+    size_t getPlanCount() const;
+
+    /** Release the plans not held by any algorithm.
+     */
+    void purge();
+
+private:
+    struct Key {
+        size_t size;
+        size_t count;
+        Direction direction;
+        Layout layout;
+        bool inPlace;
+        size_t threads;
+
+        bool operator<(const Key& rhs) const;
+    };
+
+    using PlanMap = std::map<Key, Plan::Ref>;
+
+    FFTEngine();
+
+    FFTEngine(const FFTEngine&);
+    FFTEngine& operator=(const FFTEngine&);
+
+    Plan::Ref makePlan(const Key& key);
+
+    mutable ACE_Thread_Mutex mutex_;
+    PlanMap plans_;
+    std::string wisdomPath_;
+    bool threaded_;
+};
+
+} // end namespace Algorithms
+} // end namespace SideCar
+
+/** \file
+ */
+
+#endif
@@ -0,0 +1,161 @@
+#include <glob.h>
+
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+#include "Logger/Log.h"
+#include "UnitTest/UnitTest.h"
+#include "Utils/FilePath.h"
+
+#include "FFTEngine.h"
+
+using namespace SideCar::Algorithms;
+
+struct Test : public UnitTest::TestObj {
+    Test() : TestObj("FFTEngine") {}
+
+    void test();
+};
+
+using Complex = FFTEngine::Complex;
+
+/** Textbook DFT of one transform of a batch, with elements \p stride apart.
+ */
+static Complex
+DFT(const FFTEngine::Buffer& input, size_t first, size_t stride, size_t size, size_t bin, double sign)
+{
+    std::complex<double> sum;
+    for (size_t index = 0; index < size; ++index) {
+        double angle = sign * 2.0 * M_PI * double(bin * index % size) / size;
+        sum += std::complex<double>(input[first + index * stride]) * std::polar(1.0, angle);
+    }
+
+    return Complex(sum);
+}
+
+static void
+Fill(FFTEngine::Buffer& buffer)
+{
+    for (size_t index = 0; index < buffer.size(); ++index)
+        buffer[index] = Complex(::rand() % 200 - 100, ::rand() % 200 - 100);
+}
+
+void
+Test::test()
+{
+    Utils::TemporaryFilePath wisdom;
+    FFTEngine& engine(FFTEngine::Instance());
+    engine.setWisdomPath(wisdom);
+
+    // A batch of row transforms matches the DFT of each row.
+    //
+    {
+        const size_t size = 24, count = 5;
+        FFTEngine::Plan::Ref plan(engine.getPlan(size, count));
+        assertTrue(plan.get());
+        assertEqual(size, plan->getSize());
+        assertEqual(count, plan->getCount());
+
+        FFTEngine::Buffer input(size * count), output(size * count);
+        Fill(input);
+        plan->execute(input.data(), output.data());
+        for (size_t row = 0; row < count; ++row) {
+            for (size_t bin = 0; bin < size; ++bin) {
+                Complex expected(DFT(input, row * size, 1, size, bin, -1.0));
+                assertEqualEpsilon(expected.real(), output[row * size + bin].real(), 1.0E-2);
+                assertEqualEpsilon(expected.imag(), output[row * size + bin].imag(), 1.0E-2);
+            }
+        }
+
+        // The same request gets the same plan.
+        //
+        assertTrue(plan == engine.getPlan(size, count));
+        assertTrue(plan != engine.getPlan(size, count, FFTEngine::kInverse));
+    }
+
+    // Column transforms across the rows of a matrix, in-place, and inverted.
+    //
+    {
+        const size_t rows = 16, columns = 7;
+        FFTEngine::Plan::Ref forward(
+            engine.getPlan(rows, columns, FFTEngine::kForward, FFTEngine::kColumns, true, 2));
+        FFTEngine::Plan::Ref inverse(
+            engine.getPlan(rows, columns, FFTEngine::kInverse, FFTEngine::kColumns, true, 2));
+        assertTrue(forward.get() && inverse.get());
+        assertTrue(forward->isInPlace());
+
+        FFTEngine::Buffer original(rows * columns), data(rows * columns);
+        Fill(original);
+        std::copy(original.data(), original.data() + rows * columns, data.data());
+
+        forward->execute(data.data());
+        for (size_t column = 0; column < columns; ++column) {
+            for (size_t bin = 0; bin < rows; ++bin) {
+                Complex expected(DFT(original, column, columns, rows, bin, -1.0));
+                assertEqualEpsilon(expected.real(), data[bin * columns + column].real(), 1.0E-2);
+                assertEqualEpsilon(expected.imag(), data[bin * columns + column].imag(), 1.0E-2);
+            }
+        }
+
+        // Inverse transforms are not normalized.
+        //
+        inverse->execute(data.data());
+        for (size_t index = 0; index < rows * columns; ++index) {
+            assertEqualEpsilon(original[index].real() * rows, data[index].real(), 1.0E-2);
+            assertEqualEpsilon(original[index].imag() * rows, data[index].imag(), 1.0E-2);
+        }
+    }
+
+    // New plans are recorded in the wisdom file.
+    //
+    {
+        std::ifstream is(wisdom.filePath().c_str());
+        std::string header;
+        assertTrue(bool(is >> header));
+        assertEqual(std::string("(fftw-"), header.substr(0, 6));
+        assertTrue(engine.loadWisdom(wisdom));
+    }
+
+    // Saves running at the same time each use their own temporary file, and none are left behind.
+    //
+    {
+        std::atomic<int> failures(0);
+        std::vector<std::thread> threads;
+        for (int index = 0; index < 4; ++index) {
+            threads.emplace_back([&]() {
+                for (int count = 0; count < 20; ++count) {
+                    if (!engine.saveWisdom(wisdom)) ++failures;
+                }
+            });
+        }
+
+        for (auto& thread : threads) thread.join();
+        assertEqual(0, failures.load());
+        assertTrue(engine.loadWisdom(wisdom));
+
+        glob_t matches;
+        assertEqual(GLOB_NOMATCH, ::glob((wisdom.filePath() + ".*").c_str(), 0, 0, &matches));
+    }
+
+    // Plans not held elsewhere go away on purge.
+    //
+    {
+        FFTEngine::Plan::Ref held(engine.getPlan(24, 5));
+        assertTrue(engine.getPlanCount() > 1);
+        engine.purge();
+        assertEqual(size_t(1), engine.getPlanCount());
+        assertTrue(held == engine.getPlan(24, 5));
+    }
+
+    engine.setWisdomPath("");
+}
+
+int
+main(int, const char**)
+{
+    return Test().mainRun();
+}
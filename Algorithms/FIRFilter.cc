@@ -0,0 +1,281 @@
+#include <algorithm>
+#include <cmath>
+#include <istream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "FFTEngine.h"
+#include "FIRFilter.h"
+
+using namespace SideCar::Algorithms;
+
+/** Number of partial sums kept by Dot(). Branches are padded with zeros to a multiple of this.
+ */
+static const size_t kLanes = 8;
+
+/** Dot product of two float arrays whose length is a multiple of kLanes. The independent partial sums let the
+    compiler use vector instructions without reordering any one sum.
+*/
+static inline float
+Dot(const float* x, const float* h, size_t count)
+{
+    float sums[kLanes] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+    for (size_t index = 0; index < count; index += kLanes) {
+        for (size_t lane = 0; lane < kLanes; ++lane) sums[lane] += x[index + lane] * h[index + lane];
+    }
+
+    return ((sums[0] + sums[4]) + (sums[1] + sums[5])) + ((sums[2] + sums[6]) + (sums[3] + sums[7]));
+}
+
+static inline int16_t
+ToSample(float value)
+{
+    value = ::rintf(value);
+    value = value < -32768.0f ? -32768.0f : value;
+    value = value > 32767.0f ? 32767.0f : value;
+    return int16_t(value);
+}
+
+/** Per-thread work areas, so that one filter may be shared by several threads.
+ */
+static std::vector<float>&
+RealScratch(int which)
+{
+    static thread_local std::vector<float> scratch_[2];
+    return scratch_[which];
+}
+
+static std::vector<FIRFilter::Complex>&
+ComplexScratch(int which)
+{
+    static thread_local std::vector<FIRFilter::Complex> scratch_[2];
+    return scratch_[which];
+}
+
+static FFTEngine::Buffer&
+BlockScratch()
+{
+    static thread_local FFTEngine::Buffer scratch_;
+    return scratch_;
+}
+
+bool
+FIRFilter::ReadTaps(std::istream& is, std::vector<float>& taps)
+{
+    taps.clear();
+    std::string token;
+    while (is >> token) {
+        std::replace(token.begin(), token.end(), ',', ' ');
+        std::istringstream values(token);
+        float value;
+        while (values >> value) taps.push_back(value);
+        if (!values.eof()) return false;
+    }
+
+    return !taps.empty();
+}
+
+FIRFilter::FIRFilter(const std::vector<float>& taps, size_t interpolation, size_t decimation, size_t delay,
+                     size_t fftThreshold) :
+    taps_(taps),
+    interpolation_(std::max(interpolation, size_t(1))), decimation_(std::max(decimation, size_t(1))), delay_(delay),
+    branchSize_(0), branches_(), fftSize_(0), fftStep_(0), spectrum_()
+{
+    if (taps_.empty()) throw std::invalid_argument("FIRFilter: no taps");
+
+    // Branch p holds taps p, p + L, p + 2L, ... padded with zeros to a multiple of kLanes.
+    //
+    size_t longest = (taps_.size() + interpolation_ - 1) / interpolation_;
+    branchSize_ = (longest + kLanes - 1) / kLanes * kLanes;
+    branches_.assign(branchSize_ * interpolation_, 0.0f);
+    for (size_t tap = 0; tap < taps_.size(); ++tap) {
+        branches_[(tap % interpolation_) * branchSize_ + tap / interpolation_] = taps_[tap];
+    }
+
+    if (interpolation_ != 1 || taps_.size() <= fftThreshold) return;
+
+    // Overlap-save with blocks of at least four times the filter length keeps the wasted part of each block small.
+    //
+    fftSize_ = 64;
+    while (fftSize_ < 4 * taps_.size()) fftSize_ *= 2;
+    fftStep_ = fftSize_ - taps_.size() + 1;
+
+    // Store the conjugate of the tap spectrum for correlation, scaled to undo the gain of the inverse transform.
+    //
+    FFTEngine::Buffer buffer(fftSize_);
+    std::fill(buffer.data(), buffer.data() + fftSize_, Complex(0.0f, 0.0f));
+    std::copy(taps_.begin(), taps_.end(), buffer.data());
+    FFTEngine::Instance().getPlan(fftSize_, 1, FFTEngine::kForward, FFTEngine::kRows, true)->execute(buffer.data());
+
+    spectrum_.resize(fftSize_);
+    float scale = 1.0f / fftSize_;
+    for (size_t index = 0; index < fftSize_; ++index) spectrum_[index] = std::conj(buffer[index]) * scale;
+}
+
+size_t
+FIRFilter::getPaddedSize(size_t count) const
+{
+    return getLeadingZeros() + count + branchSize_ + 1;
+}
+
+void
+FIRFilter::runDirect(const float* input, size_t count, float* output, size_t stride) const
+{
+    // The input has getLeadingZeros() zeros before it and branchSize_ + 1 after it, so no dot product needs a
+    // bounds check. Output m starts at upsampled position m * D - d, tracked below as quotient and remainder of L
+    // relative to the first leading zero, so that the loop does no division.
+    //
+    size_t leading = getLeadingZeros();
+    size_t position = leading * interpolation_ - delay_;
+    size_t quotient = position / interpolation_;
+    size_t remainder = position % interpolation_;
+    size_t quotientStep = decimation_ / interpolation_;
+    size_t remainderStep = decimation_ % interpolation_;
+    const float* base = input - leading;
+
+    size_t outputs = getOutputSize(count);
+    for (size_t index = 0; index < outputs; ++index) {
+        // Branch p lines up with input samples when the upsampled position plus p is a multiple of L.
+        //
+        size_t phase = remainder ? interpolation_ - remainder : 0;
+        size_t start = quotient + (remainder ? 1 : 0);
+        output[index * stride] = Dot(base + start, &branches_[phase * branchSize_], branchSize_);
+
+        quotient += quotientStep;
+        remainder += remainderStep;
+        if (remainder >= interpolation_) {
+            remainder -= interpolation_;
+            ++quotient;
+        }
+    }
+}
+
+void
+FIRFilter::runFFT(const Complex* input, size_t count, Complex* output) const
+{
+    size_t outputs = getOutputSize(count);
+    if (!outputs) return;
+
+    // Full-rate output n needs inputs n - delay through n - delay + K - 1. Block b of the batch holds those for
+    // outputs b * S through b * S + S - 1, where S is fftStep_.
+    //
+    size_t last = (outputs - 1) * decimation_;
+    size_t blocks = last / fftStep_ + 1;
+    FFTEngine::Buffer& buffer(BlockScratch());
+    buffer.resize(std::max(buffer.size(), blocks * fftSize_));
+
+    for (size_t block = 0; block < blocks; ++block) {
+        Complex* data = buffer.data() + block * fftSize_;
+        long first = long(block * fftStep_) - long(delay_);
+        for (size_t index = 0; index < fftSize_; ++index) {
+            long position = first + long(index);
+            data[index] = (position >= 0 && position < long(count)) ? input[position] : Complex(0.0f, 0.0f);
+        }
+    }
+
+    FFTEngine& engine(FFTEngine::Instance());
+    engine.getPlan(fftSize_, blocks, FFTEngine::kForward, FFTEngine::kRows, true)->execute(buffer.data());
+
+    // Spelling out the complex product avoids the NaN handling of std::complex multiplication.
+    //
+    const Complex* spectrum = spectrum_.data();
+    for (size_t block = 0; block < blocks; ++block) {
+        float* data = reinterpret_cast<float*>(buffer.data() + block * fftSize_);
+        const float* weights = reinterpret_cast<const float*>(spectrum);
+        for (size_t index = 0; index < fftSize_ * 2; index += 2) {
+            float re = data[index] * weights[index] - data[index + 1] * weights[index + 1];
+            float im = data[index] * weights[index + 1] + data[index + 1] * weights[index];
+            data[index] = re;
+            data[index + 1] = im;
+        }
+    }
+
+    engine.getPlan(fftSize_, blocks, FFTEngine::kInverse, FFTEngine::kRows, true)->execute(buffer.data());
+
+    for (size_t index = 0; index < outputs; ++index) {
+        size_t position = index * decimation_;
+        output[index] = buffer[(position / fftStep_) * fftSize_ + position % fftStep_];
+    }
+}
+
+void
+FIRFilter::filter(const float* input, size_t count, float* output) const
+{
+    if (usesFFT()) {
+        std::vector<Complex>& in(ComplexScratch(0));
+        std::vector<Complex>& out(ComplexScratch(1));
+        in.assign(input, input + count);
+        out.resize(getOutputSize(count));
+        runFFT(in.data(), count, out.data());
+        for (size_t index = 0; index < out.size(); ++index) output[index] = out[index].real();
+        return;
+    }
+
+    std::vector<float>& padded(RealScratch(0));
+    padded.assign(getPaddedSize(count), 0.0f);
+    std::copy(input, input + count, padded.begin() + getLeadingZeros());
+    runDirect(padded.data() + getLeadingZeros(), count, output, 1);
+}
+
+void
+FIRFilter::filter(const int16_t* input, size_t count, int16_t* output) const
+{
+    std::vector<float>& values(RealScratch(1));
+    values.resize(getOutputSize(count));
+    if (usesFFT()) {
+        std::vector<Complex>& in(ComplexScratch(0));
+        std::vector<Complex>& out(ComplexScratch(1));
+        in.assign(input, input + count);
+        out.resize(values.size());
+        runFFT(in.data(), count, out.data());
+        for (size_t index = 0; index < out.size(); ++index) output[index] = ToSample(out[index].real());
+        return;
+    }
+
+    std::vector<float>& padded(RealScratch(0));
+    padded.assign(getPaddedSize(count), 0.0f);
+    std::copy(input, input + count, padded.begin() + getLeadingZeros());
+    runDirect(padded.data() + getLeadingZeros(), count, values.data(), 1);
+    for (size_t index = 0; index < values.size(); ++index) output[index] = ToSample(values[index]);
+}
+
+void
+FIRFilter::filter(const Complex* input, size_t count, Complex* output) const
+{
+    if (usesFFT()) {
+        runFFT(input, count, output);
+        return;
+    }
+
+    // With real taps the I and Q values are filtered separately.
+    //
+    std::vector<float>& real(RealScratch(0));
+    std::vector<float>& imag(RealScratch(1));
+    real.assign(getPaddedSize(count), 0.0f);
+    imag.assign(real.size(), 0.0f);
+    size_t lead = getLeadingZeros();
+    for (size_t index = 0; index < count; ++index) {
+        real[lead + index] = input[index].real();
+        imag[lead + index] = input[index].imag();
+    }
+
+    float* out = reinterpret_cast<float*>(output);
+    runDirect(real.data() + lead, count, out, 2);
+    runDirect(imag.data() + lead, count, out + 1, 2);
+}
+
+void
+FIRFilter::filterIQ(const int16_t* input, size_t count, int16_t* output) const
+{
+    std::vector<Complex>& in(ComplexScratch(0));
+    std::vector<Complex>& out(ComplexScratch(1));
+    in.resize(count);
+    for (size_t index = 0; index < count; ++index) in[index] = Complex(input[2 * index], input[2 * index + 1]);
+    out.resize(getOutputSize(count));
+    filter(in.data(), count, out.data());
+    for (size_t index = 0; index < out.size(); ++index) {
+        output[2 * index] = ToSample(out[index].real());
+        output[2 * index + 1] = ToSample(out[index].imag());
+    }
+}
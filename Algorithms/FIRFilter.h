@@ -0,0 +1,152 @@
+#ifndef SIDECAR_ALGORITHMS_FIRFILTER_H // -*- C++ -*-
+#define SIDECAR_ALGORITHMS_FIRFILTER_H
+
+#include <complex>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+#include "boost/shared_ptr.hpp"
+
+namespace SideCar {
+namespace Algorithms {
+
+/** Finite impulse response filter with rational resampling, applied to one PRI at a time. For taps h[0..K-1],
+    interpolation factor L, decimation factor D, and delay d, output m is
+
+    \code
+    y[m] = sum over k of h[k] * u[m * D + k - d]
+    \endcode
+
+    where u is the input with L - 1 zeros inserted after every sample, and samples outside the PRI are zero. With
+    L = D = 1 and d = 0 this is the correlation of the input with the taps; reversing the taps and setting d = K - 1
+    gives the usual causal convolution.
+
+    Only the outputs that are kept are computed, and the inserted zeros are never multiplied: the taps are split
+    into L polyphase branches, and each output is one dot product of a branch with consecutive input samples.
+    Above a tap count threshold, filters that do not interpolate use overlap-save FFT convolution instead, running
+    all the blocks of a PRI as one batch from FFTEngine.
+
+    Objects are immutable once built, so an algorithm may swap in a new filter when its taps change while another
+    thread is using the old one.
+*/
+class FIRFilter {
+public:
+    using Ref = boost::shared_ptr<const FIRFilter>;
+    using Complex = std::complex<float>;
+
+    /** Number of taps above which FFT convolution is faster than direct computation.
+     */
+    static const size_t kDefaultFFTThreshold = 64;
+
+    /** Read taps from a stream. Values may be separated by whitespace or commas.
+
+        \param is stream to read
+
+        \param taps container to hold the values
+
+        \return true if at least one value was read and all text was valid
+    */
+    static bool ReadTaps(std::istream& is, std::vector<float>& taps);
+
+    /** Constructor.
+
+        \param taps filter coefficients. Must not be empty.
+
+        \param interpolation number of outputs per input sample before decimation
+
+        \param decimation number of upsampled samples per output
+
+        \param delay offset of the taps relative to the output position, in upsampled samples
+
+        \param fftThreshold tap count above which to use FFT convolution
+    */
+    FIRFilter(const std::vector<float>& taps, size_t interpolation = 1, size_t decimation = 1, size_t delay = 0,
+              size_t fftThreshold = kDefaultFFTThreshold);
+
+    /** Obtain the number of outputs for a given number of inputs.
+
+        \param count number of input samples
+
+        \return number of output samples
+    */
+    size_t getOutputSize(size_t count) const { return (count * interpolation_ + decimation_ - 1) / decimation_; }
+
+    const std::vector<float>& getTaps() const { return taps_; }
+
+    size_t getInterpolation() const { return interpolation_; }
+
+    size_t getDecimation() const { return decimation_; }
+
+    size_t getDelay() const { return delay_; }
+
+    bool usesFFT() const { return fftSize_ != 0; }
+
+    /** Filter real samples.
+
+        \param input samples to filter
+
+        \param count number of input samples
+
+        \param output buffer for getOutputSize(count) results
+    */
+    void filter(const float* input, size_t count, float* output) const;
+
+    /** Filter real samples, rounding the results and saturating them to the sample range.
+
+        \param input samples to filter
+
+        \param count number of input samples
+
+        \param output buffer for getOutputSize(count) results
+    */
+    void filter(const int16_t* input, size_t count, int16_t* output) const;
+
+    /** Filter complex samples.
+
+        \param input samples to filter
+
+        \param count number of input samples
+
+        \param output buffer for getOutputSize(count) results
+    */
+    void filter(const Complex* input, size_t count, Complex* output) const;
+
+    /** Filter complex samples held as interleaved I and Q values, rounding the results and saturating them to the
+        sample range.
+
+        \param input I and Q values to filter
+
+        \param count number of complex input samples
+
+        \param output buffer for getOutputSize(count) I and Q pairs
+    */
+    void filterIQ(const int16_t* input, size_t count, int16_t* output) const;
+
+private:
+    size_t getLeadingZeros() const { return delay_ / interpolation_ + 1; }
+
+    size_t getPaddedSize(size_t count) const;
+
+    void runDirect(const float* input, size_t count, float* output, size_t stride) const;
+
+    void runFFT(const Complex* input, size_t count, Complex* output) const;
+
+    std::vector<float> taps_;
+    size_t interpolation_;
+    size_t decimation_;
+    size_t delay_;
+    size_t branchSize_;
+    std::vector<float> branches_;
+    size_t fftSize_;
+    size_t fftStep_;
+    std::vector<Complex> spectrum_;
+};
+
+} // end namespace Algorithms
+} // end namespace SideCar
+
+/** \file
+ */
+
+#endif
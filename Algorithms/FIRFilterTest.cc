@@ -0,0 +1,143 @@
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+
+#include "Logger/Log.h"
+#include "UnitTest/UnitTest.h"
+
+#include "FIRFilter.h"
+
+using namespace SideCar::Algorithms;
+
+struct Test : public UnitTest::TestObj {
+    Test() : TestObj("FIRFilter") {}
+
+    void test();
+};
+
+using Complex = FIRFilter::Complex;
+
+/** Textbook form of the filter: upsample by zero insertion, filter at the full rate, and keep every D-th value.
+ */
+template <typename T>
+static std::vector<T>
+Reference(const std::vector<float>& taps, const std::vector<T>& input, size_t interpolation, size_t decimation,
+          size_t delay)
+{
+    std::vector<T> upsampled(input.size() * interpolation, T(0));
+    for (size_t index = 0; index < input.size(); ++index) upsampled[index * interpolation] = input[index];
+
+    std::vector<T> output;
+    for (size_t position = 0; position < upsampled.size(); position += decimation) {
+        T sum(0);
+        for (size_t tap = 0; tap < taps.size(); ++tap) {
+            long offset = long(position + tap) - long(delay);
+            if (offset >= 0 && offset < long(upsampled.size())) sum += taps[tap] * upsampled[offset];
+        }
+        output.push_back(sum);
+    }
+
+    return output;
+}
+
+static std::vector<float>
+RandomTaps(size_t count)
+{
+    std::vector<float> taps(count);
+    for (size_t index = 0; index < count; ++index) taps[index] = (::rand() % 2001 - 1000) / 1000.0f;
+    return taps;
+}
+
+void
+Test::test()
+{
+    ::srand(1234);
+
+    // Reading taps.
+    //
+    {
+        std::vector<float> taps;
+        std::istringstream is("0.25, 0.5,0.25\n-1\n");
+        assertTrue(FIRFilter::ReadTaps(is, taps));
+        assertEqual(size_t(4), taps.size());
+        assertEqual(0.5f, taps[1]);
+        assertEqual(-1.0f, taps[3]);
+
+        std::istringstream bad("0.25 x");
+        assertFalse(FIRFilter::ReadTaps(bad, taps));
+        std::istringstream empty("");
+        assertFalse(FIRFilter::ReadTaps(empty, taps));
+    }
+
+    // Direct and FFT paths match the reference for a range of tap counts, rates, and delays.
+    //
+    const size_t kTapCounts[] = {1, 7, 16, 33, 100};
+    for (size_t tapCount : kTapCounts) {
+        std::vector<float> taps(RandomTaps(tapCount));
+        for (size_t interpolation = 1; interpolation <= 3; ++interpolation) {
+            for (size_t decimation = 1; decimation <= 4; ++decimation) {
+                size_t delay = ::rand() % (tapCount + 2);
+                size_t count = 50 + ::rand() % 300;
+                FIRFilter filter(taps, interpolation, decimation, delay, 32);
+                assertEqual(interpolation == 1 && tapCount > 32, filter.usesFFT());
+
+                std::vector<float> real(count);
+                std::vector<Complex> complex(count);
+                for (size_t index = 0; index < count; ++index) {
+                    real[index] = ::rand() % 2000 - 1000;
+                    complex[index] = Complex(::rand() % 2000 - 1000, ::rand() % 2000 - 1000);
+                }
+
+                std::vector<float> expectedReal(Reference(taps, real, interpolation, decimation, delay));
+                std::vector<Complex> expectedComplex(Reference(taps, complex, interpolation, decimation, delay));
+                assertEqual(expectedReal.size(), filter.getOutputSize(count));
+
+                std::vector<float> gotReal(filter.getOutputSize(count));
+                std::vector<Complex> gotComplex(gotReal.size());
+                filter.filter(real.data(), count, gotReal.data());
+                filter.filter(complex.data(), count, gotComplex.data());
+                for (size_t index = 0; index < gotReal.size(); ++index) {
+                    assertEqualEpsilon(expectedReal[index], gotReal[index], 0.1);
+                    assertEqualEpsilon(expectedComplex[index].real(), gotComplex[index].real(), 0.1);
+                    assertEqualEpsilon(expectedComplex[index].imag(), gotComplex[index].imag(), 0.1);
+                }
+            }
+        }
+    }
+
+    // Integer samples are rounded and saturated.
+    //
+    {
+        std::vector<float> taps(3, 0.5f);
+        FIRFilter filter(taps, 1, 2, 1);
+        const int16_t input[] = {1, 2, 30000, 30000, -30000, -30000, 5};
+        int16_t output[4];
+        assertEqual(size_t(4), filter.getOutputSize(7));
+        filter.filter(input, 7, output);
+        assertEqual(int16_t(2), output[0]);
+        assertEqual(int16_t(30001), output[1]);
+        assertEqual(int16_t(-15000), output[2]);
+        assertEqual(int16_t(-14998), output[3]);
+
+        const int16_t loud[] = {30000, 30000, 30000, 30000};
+        filter.filter(loud, 4, output);
+        assertEqual(int16_t(30000), output[0]);
+        assertEqual(int16_t(32767), output[1]);
+
+        // Interleaved I and Q values.
+        //
+        const int16_t iq[] = {2, -2, 4, -4, 6, -6, 8, -8};
+        int16_t iqOut[4];
+        filter.filterIQ(iq, 4, iqOut);
+        assertEqual(int16_t(3), iqOut[0]);
+        assertEqual(int16_t(-3), iqOut[1]);
+        assertEqual(int16_t(9), iqOut[2]);
+        assertEqual(int16_t(-9), iqOut[3]);
+    }
+}
+
+int
+main(int, const char**)
+{
+    return Test().mainRun();
+}
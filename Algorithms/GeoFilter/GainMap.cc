@@ -0,0 +1,146 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "GainMap.h"
+
+using namespace SideCar::Algorithms;
+
+/** Adding and then subtracting 1.5 * 2^52 rounds a double of magnitude below 2^51 to an integer using the current
+    rounding mode, exactly like ::rint(), but in a form that the compiler can vectorize.
+*/
+static const double kRoundingBias = 6755399441055744.0;
+
+static const double kSampleMin = std::numeric_limits<int16_t>::min();
+static const double kSampleMax = std::numeric_limits<int16_t>::max();
+
+GainMap::Zone::Zone() :
+    rangeMin(0.0), rangeMax(0.0), azMin(0.0), azMax(0.0), attenuation(1.0), offset(0.0), clampMin(kSampleMin),
+    clampMax(kSampleMax)
+{
+    ;
+}
+
+GainMap::GainMap(const ZoneVector& zones) :
+    zones_(zones), breaks_(), buckets_(), rangeMin_(0.0), rangeFactor_(0.0), count_(0), compiled_(false)
+{
+    // A zone covers [azMin, azMax]. Record the first azimuth inside and the first azimuth past each zone; the
+    // sorted set of these points bounds the buckets. Zones with azMin > azMax never match.
+    //
+    for (const auto& zone : zones_) {
+        if (zone.azMin > zone.azMax) continue;
+        breaks_.push_back(zone.azMin);
+        breaks_.push_back(std::nextafter(zone.azMax, std::numeric_limits<double>::infinity()));
+    }
+
+    std::sort(breaks_.begin(), breaks_.end());
+    breaks_.erase(std::unique(breaks_.begin(), breaks_.end()), breaks_.end());
+
+    buckets_.resize(breaks_.size());
+    for (size_t index = 0; index < buckets_.size(); ++index) {
+        double azimuth = breaks_[index];
+        for (size_t zone = 0; zone < zones_.size(); ++zone) {
+            if (zones_[zone].azMin <= azimuth && azimuth <= zones_[zone].azMax) {
+                buckets_[index].zones.push_back(zone);
+            }
+        }
+    }
+}
+
+bool
+GainMap::IsIdentity(const Zone& zone)
+{
+    return zone.attenuation == 1.0 && zone.offset == 0.0 && zone.clampMin <= kSampleMin &&
+           zone.clampMax >= kSampleMax;
+}
+
+void
+GainMap::compile(double rangeMin, double rangeFactor, size_t count)
+{
+    rangeMin_ = rangeMin;
+    rangeFactor_ = rangeFactor;
+    count_ = count;
+    compiled_ = true;
+
+    std::vector<int> owners(count);
+    for (auto& bucket : buckets_) compile(bucket, owners);
+}
+
+void
+GainMap::compile(Bucket& bucket, std::vector<int>& owners)
+{
+    bucket.spans.clear();
+    if (bucket.zones.empty()) return;
+
+    // Paint each gate with the last zone that covers it. Gate limits are calculated as they were when zones were
+    // applied one after another.
+    //
+    std::fill(owners.begin(), owners.end(), -1);
+    for (auto index : bucket.zones) {
+        const Zone& zone(zones_[index]);
+        double offset = (zone.rangeMin - rangeMin_) / rangeFactor_;
+        if (offset < 0.0)
+            offset = 0.0;
+        else if (offset > count_)
+            offset = count_;
+        size_t begin = size_t(offset);
+
+        offset = (zone.rangeMax - rangeMin_) / rangeFactor_;
+        if (offset < 0.0)
+            offset = 0.0;
+        else if (offset > count_)
+            offset = count_;
+        size_t end = size_t(offset);
+
+        for (size_t gate = begin; gate < end; ++gate) owners[gate] = index;
+    }
+
+    // Convert runs of gates with the same owner into spans.
+    //
+    size_t gate = 0;
+    while (gate < count_) {
+        int owner = owners[gate];
+        size_t begin = gate;
+        while (gate < count_ && owners[gate] == owner) ++gate;
+        if (owner == -1 || IsIdentity(zones_[owner])) continue;
+
+        const Zone& zone(zones_[owner]);
+        Span span;
+        span.begin = begin;
+        span.end = gate;
+        span.gain = zone.attenuation;
+        span.offset = zone.offset;
+
+        // Clamping before or after rounding gives the same result, so the limits can be whole sample values.
+        //
+        span.clampMin = int16_t(::rint(std::min(std::max(zone.clampMin, kSampleMin), kSampleMax)));
+        span.clampMax = int16_t(::rint(std::min(std::max(zone.clampMax, kSampleMin), kSampleMax)));
+        bucket.spans.push_back(span);
+    }
+}
+
+void
+GainMap::apply(double azimuth, double rangeMin, double rangeFactor, int16_t* samples, size_t count)
+{
+    if (breaks_.empty() || azimuth < breaks_.front()) return;
+
+    if (!compiled_ || rangeMin != rangeMin_ || rangeFactor != rangeFactor_ || count != count_) {
+        compile(rangeMin, rangeFactor, count);
+    }
+
+    size_t index = std::upper_bound(breaks_.begin(), breaks_.end(), azimuth) - breaks_.begin() - 1;
+    for (const auto& span : buckets_[index].spans) {
+        const double gain = span.gain;
+        const double offset = span.offset;
+        const double low = span.clampMin;
+        const double high = span.clampMax;
+        int16_t* ptr = samples + span.begin;
+        size_t length = span.end - span.begin;
+        for (size_t gate = 0; gate < length; ++gate) {
+            double value = ptr[gate] * gain + offset;
+            value = value < low ? low : value;
+            value = value > high ? high : value;
+            ptr[gate] = int16_t((value + kRoundingBias) - kRoundingBias);
+        }
+    }
+}
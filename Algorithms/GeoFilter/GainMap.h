@@ -0,0 +1,117 @@
+#ifndef SIDECAR_ALGORITHMS_GEOFILTER_GAINMAP_H // -*- C++ -*-
+#define SIDECAR_ALGORITHMS_GEOFILTER_GAINMAP_H
+
+#include <cstdint>
+#include <vector>
+
+#include "boost/shared_ptr.hpp"
+
+namespace SideCar {
+namespace Algorithms {
+
+/** Compiled form of a set of GeoFilter zones. Each zone scales, offsets, and clamps the samples that fall within
+    an azimuth and range sector. Zone boundaries divide the azimuth circle into buckets with a fixed set of active
+    zones, so a PRI finds its zones with one binary search instead of testing every zone. Within a bucket the
+    zones are flattened into non-overlapping gate spans; where zones overlap the one defined last wins, as each
+    zone reads the original sample value. Spans that would leave samples unchanged are dropped.
+
+    Gate spans depend on the range geometry of the PRI messages, so they are built for the first message seen and
+    rebuilt only if the range start, range factor, or sample count changes.
+
+    A GainMap is built once and then only used by the processing thread, so a new configuration can be compiled
+    on another thread and swapped in with an atomic pointer store.
+*/
+class GainMap {
+public:
+    using Ref = boost::shared_ptr<GainMap>;
+
+    /** Definition of one zone.
+     */
+    struct Zone {
+        Zone();
+
+        double rangeMin;    ///< Start of zone in range (km)
+        double rangeMax;    ///< End of zone in range (km)
+        double azMin;       ///< Start of zone in azimuth (radians)
+        double azMax;       ///< End of zone in azimuth (radians)
+        double attenuation; ///< Sample multiplier
+        double offset;      ///< Value added after multiplying
+        double clampMin;    ///< Smallest output value
+        double clampMax;    ///< Largest output value
+    };
+
+    using ZoneVector = std::vector<Zone>;
+
+    /** Constructor.
+
+        \param zones zone definitions, in configuration order
+    */
+    explicit GainMap(const ZoneVector& zones);
+
+    /** Obtain the number of zones.
+
+        \return zone count
+    */
+    size_t getZoneCount() const { return zones_.size(); }
+
+    /** Obtain the number of azimuth buckets.
+
+        \return bucket count
+    */
+    size_t getBucketCount() const { return buckets_.size(); }
+
+    /** Apply the zones that cover an azimuth to the samples of a PRI, in place.
+
+        \param azimuth azimuth of the PRI (radians)
+
+        \param rangeMin range of the first sample (km)
+
+        \param rangeFactor range between samples (km)
+
+        \param samples sample values to update
+
+        \param count number of samples
+    */
+    void apply(double azimuth, double rangeMin, double rangeFactor, int16_t* samples, size_t count);
+
+private:
+    /** Run of gates that share one transform.
+     */
+    struct Span {
+        uint32_t begin;
+        uint32_t end;
+        double gain;
+        double offset;
+        int16_t clampMin;
+        int16_t clampMax;
+    };
+
+    /** Azimuth interval with a fixed set of active zones.
+     */
+    struct Bucket {
+        std::vector<uint16_t> zones;
+        std::vector<Span> spans;
+    };
+
+    void compile(double rangeMin, double rangeFactor, size_t count);
+
+    void compile(Bucket& bucket, std::vector<int>& owners);
+
+    static bool IsIdentity(const Zone& zone);
+
+    ZoneVector zones_;
+    std::vector<double> breaks_;
+    std::vector<Bucket> buckets_;
+    double rangeMin_;
+    double rangeFactor_;
+    size_t count_;
+    bool compiled_;
+};
+
+} // end namespace Algorithms
+} // end namespace SideCar
+
+/** \file
+ */
+
+#endif
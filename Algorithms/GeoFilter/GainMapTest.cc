@@ -0,0 +1,135 @@
+#include <cmath>
+#include <cstdlib>
+
+#include "Logger/Log.h"
+#include "UnitTest/UnitTest.h"
+
+#include "GainMap.h"
+
+using namespace SideCar::Algorithms;
+
+struct Test : public UnitTest::TestObj {
+    Test() : TestObj("GainMap") {}
+
+    void test();
+};
+
+/** Apply zones one after another, as GeoFilter did before it used a GainMap.
+ */
+static void
+Reference(const GainMap::ZoneVector& zones, double azimuth, double rangeMin, double rangeFactor,
+          const std::vector<int16_t>& input, std::vector<int16_t>& output)
+{
+    output = input;
+    for (const auto& zone : zones) {
+        if (zone.azMin > azimuth || azimuth > zone.azMax) continue;
+        double offset = (zone.rangeMin - rangeMin) / rangeFactor;
+        if (offset < 0.0) offset = 0.0;
+        size_t begin = size_t(offset);
+        offset = (zone.rangeMax - rangeMin) / rangeFactor;
+        if (offset < 0.0)
+            offset = 0.0;
+        else if (offset > input.size())
+            offset = input.size();
+        size_t end = size_t(offset);
+        for (size_t gate = begin; gate < end; ++gate) {
+            double v = input[gate] * zone.attenuation + zone.offset;
+            if (v < zone.clampMin) v = zone.clampMin;
+            if (v > zone.clampMax) v = zone.clampMax;
+            output[gate] = ::rint(v);
+        }
+    }
+}
+
+static double
+Random(double low, double high)
+{
+    return low + (high - low) * ::rand() / RAND_MAX;
+}
+
+void
+Test::test()
+{
+    // One zone covering part of the range in one sector.
+    //
+    GainMap::ZoneVector zones(1);
+    zones[0].azMin = 1.0;
+    zones[0].azMax = 2.0;
+    zones[0].rangeMin = 10.0;
+    zones[0].rangeMax = 20.0;
+    zones[0].attenuation = 0.5;
+    zones[0].offset = 1.0;
+    zones[0].clampMax = 100.0;
+
+    GainMap map(zones);
+    assertEqual(size_t(1), map.getZoneCount());
+    assertEqual(size_t(2), map.getBucketCount());
+
+    std::vector<int16_t> samples(40, 301);
+    map.apply(0.5, 0.0, 1.0, samples.data(), samples.size());
+    assertEqual(301, samples[15]);
+
+    map.apply(2.0, 0.0, 1.0, samples.data(), samples.size());
+    assertEqual(301, samples[9]);
+    assertEqual(100, samples[10]);
+    assertEqual(100, samples[19]);
+    assertEqual(301, samples[20]);
+
+    samples.assign(40, 5);
+    map.apply(1.5, 0.0, 1.0, samples.data(), samples.size());
+    assertEqual(4, samples[10]); // rint(3.5) rounds to even
+
+    // Where zones overlap, the later one wins and reads the original sample. An identity zone restores the input.
+    //
+    zones.resize(2);
+    zones[1].azMin = 1.5;
+    zones[1].azMax = 3.0;
+    zones[1].rangeMin = 15.0;
+    zones[1].rangeMax = 100.0;
+    GainMap overlap(zones);
+    samples.assign(40, 301);
+    overlap.apply(1.75, 0.0, 1.0, samples.data(), samples.size());
+    assertEqual(100, samples[14]);
+    assertEqual(301, samples[15]);
+    assertEqual(301, samples[39]);
+
+    // Compare against the zone-by-zone calculation for random zones and messages, including changes in range
+    // geometry that force the spans to be rebuilt.
+    //
+    ::srand(4321);
+    for (int trial = 0; trial < 50; ++trial) {
+        zones.clear();
+        int count = 1 + ::rand() % 40;
+        for (int index = 0; index < count; ++index) {
+            GainMap::Zone zone;
+            zone.azMin = Random(0.0, 6.3);
+            zone.azMax = Random(0.0, 6.3);
+            zone.rangeMin = Random(-10.0, 200.0);
+            zone.rangeMax = Random(-10.0, 200.0);
+            if (::rand() % 4) zone.attenuation = Random(0.0, 2.0);
+            if (::rand() % 4) zone.offset = Random(-500.0, 500.0);
+            if (::rand() % 2) zone.clampMin = Random(-32768.0, 1000.0);
+            if (::rand() % 2) zone.clampMax = Random(-1000.0, 32767.0);
+            zones.push_back(zone);
+        }
+
+        GainMap map(zones);
+        for (int pri = 0; pri < 100; ++pri) {
+            double rangeMin = (pri / 50) * 3.0;
+            double rangeFactor = 0.25 + (pri / 50) * 0.1;
+            double azimuth = Random(0.0, 6.3);
+            std::vector<int16_t> input(500 + (pri / 50) * 20);
+            for (auto& value : input) value = ::rand() % 65536 - 32768;
+            std::vector<int16_t> expected;
+            Reference(zones, azimuth, rangeMin, rangeFactor, input, expected);
+            map.apply(azimuth, rangeMin, rangeFactor, input.data(), input.size());
+            assertTrue(input == expected);
+        }
+    }
+}
+
+int
+main(int, const char**)
+{
+    return Test().mainRun();
+}
@@ -21,26 +21,10 @@ using namespace boost::placeholders;
 using namespace SideCar;
 using namespace SideCar::Algorithms;
 
-struct Filter {
-    Filter() :
-        name(), rangeMin(0.0), rangeMax(0.0), azMin(0.0), azMax(0.0), attenuation(1.0), offset(0.0),
-        clampMin(std::numeric_limits<short>::min()), clampMax(std::numeric_limits<short>::max())
-    {
-    }
-    QString name;
-    double rangeMin;
-    double rangeMax;
-    double azMin;
-    double azMax;
-    double attenuation;
-    double offset;
-    double clampMin;
-    double clampMax;
-};
-
 struct GeoFilter::Private {
-    Private() : filters_(), stateEmitter_() {}
-    std::vector<Filter> filters_;
+    Private() : map_(), zoneCount_(0), stateEmitter_() {}
+    GainMap::Ref map_;
+    int zoneCount_;
     IO::StateEmitter stateEmitter_;
 };
 
@@ -87,17 +71,27 @@ GeoFilter::reset()
     // The algorithm is transitioning from a stop state to a run state. Attempt to load our configuration if we have
     // not already done so.
     //
-    if (p_->filters_.empty()) return loadConfig();
+    GainMap::Ref map(boost::atomic_load(&p_->map_));
+    if (!map || !map->getZoneCount()) return loadConfig();
     return true;
 }
 
 bool
 GeoFilter::loadConfig()
 {
-    p_->filters_.clear();
+    // Compile the new configuration off to the side and then swap it in, so that processInput() never waits on a
+    // reload. A failed load installs an empty map.
+    //
+    GainMap::ZoneVector zones;
     std::string path = configPath_->getValue();
+    bool ok = path.empty() || loadConfigFile(path, zones);
+    if (!ok) zones.clear();
+
+    boost::atomic_store(&p_->map_, GainMap::Ref(new GainMap(zones)));
+    p_->zoneCount_ = zones.size();
+
     if (path.size()) {
-        if (!loadConfigFile(path)) {
+        if (!ok) {
             getController().setError("Failed to load configuration file");
             return false;
         }
@@ -108,7 +102,7 @@ GeoFilter::loadConfig()
 }
 
 bool
-GeoFilter::loadConfigFile(const std::string& path)
+GeoFilter::loadConfigFile(const std::string& path, GainMap::ZoneVector& zones)
 {
     Logger::ProcLog log("loadConfig", getLog());
 
@@ -141,11 +135,11 @@ GeoFilter::loadConfigFile(const std::string& path)
 
     QDomElement filterSpec = top.firstChildElement(kFilterEntity);
     while (!filterSpec.isNull()) {
-        Filter filter;
+        GainMap::Zone filter;
         bool enabled;
 
-        filter.name = filterSpec.attribute("name", "").trimmed();
-        if (filter.name.isEmpty()) {
+        QString name = filterSpec.attribute("name", "").trimmed();
+        if (name.isEmpty()) {
             LOGERROR << "missing name attribute" << std::endl;
             return false;
         }
@@ -244,11 +238,11 @@ GeoFilter::loadConfigFile(const std::string& path)
         }
 
         if (enabled) {
-            LOGWARNING << "adding filter - " << filter.name << " az: " << Utils::radiansToDegrees(filter.azMin) << '/'
+            LOGWARNING << "adding filter - " << name << " az: " << Utils::radiansToDegrees(filter.azMin) << '/'
                        << Utils::radiansToDegrees(filter.azMax) << " range: " << filter.rangeMin << '/'
                        << filter.rangeMax << " attenuation: " << filter.attenuation << " offset: " << filter.offset
                        << " clamp: " << filter.clampMin << '/' << filter.clampMax << std::endl;
-            p_->filters_.push_back(filter);
+            zones.push_back(filter);
         }
 
         filterSpec = filterSpec.nextSiblingElement("filter");
@@ -269,42 +263,10 @@ GeoFilter::processInput(const Messages::Video::Ref& inMsg)
     outMsg->getData() = inMsg->getData();
     if (!enabled_->getValue()) return send(outMsg);
 
-    double azimuth = inMsg->getAzimuthStart();
-
-    const std::vector<Filter>& filters(p_->filters_);
-    for (size_t index = 0; index < filters.size(); ++index) {
-        const Filter& filter(filters[index]);
-        if (filter.azMin <= azimuth && azimuth <= filter.azMax) {
-            LOGDEBUG << "applying filter " << filter.name << std::endl;
-
-            double rangeMin = inMsg->getRangeMin();
-            double rangeFactor = inMsg->getRangeFactor();
-
-            double offset = (filter.rangeMin - rangeMin) / rangeFactor;
-            if (offset < 0.0) offset = 0.0;
-
-            LOGDEBUG << "begin offset: " << offset << std::endl;
-
-            Messages::Video::const_iterator in = inMsg->begin() + size_t(offset);
-            Messages::Video::iterator out = outMsg->begin() + size_t(offset);
-
-            offset = (filter.rangeMax - rangeMin) / rangeFactor;
-            if (offset < 0.0)
-                offset = 0.0;
-            else if (offset > inMsg->size())
-                offset = inMsg->size();
-
-            LOGDEBUG << "end offset: " << offset << std::endl;
-
-            Messages::Video::const_iterator end = inMsg->begin() + size_t(offset);
-
-            while (in < end) {
-                double v = *in++ * filter.attenuation + filter.offset;
-                if (v < filter.clampMin) v = filter.clampMin;
-                if (v > filter.clampMax) v = filter.clampMax;
-                *out++ = ::rint(v);
-            }
-        }
+    GainMap::Ref map(boost::atomic_load(&p_->map_));
+    if (map && !outMsg->empty()) {
+        map->apply(inMsg->getAzimuthStart(), inMsg->getRangeMin(), inMsg->getRangeFactor(), &outMsg[0],
+                   outMsg->size());
     }
 
     bool rc = send(outMsg);
@@ -316,7 +278,7 @@ void
 GeoFilter::setInfoSlots(IO::StatusBase& status)
 {
     status.setSlot(kEnabled, enabled_->getValue());
-    status.setSlot(kActiveFilterCount, int(p_->filters_.size()));
+    status.setSlot(kActiveFilterCount, p_->zoneCount_);
     status.setSlot(kConfigPath, configPath_->getValue());
 }
 
@@ -7,6 +7,8 @@
 #include "Messages/Video.h"
 #include "Parameter/Parameter.h"
 
+#include "GainMap.h"
+
 namespace SideCar {
 namespace Algorithms {
 
@@ -48,7 +50,7 @@ private:
 
     bool loadConfig();
 
-    bool loadConfigFile(const std::string& path);
+    bool loadConfigFile(const std::string& path, GainMap::ZoneVector& zones);
 
     void loadNotification(const Parameter::NotificationValue& value);
 
@@ -1,11 +1,10 @@
 #include "boost/bind.hpp"
 
-#include <algorithm> // for std::transform
+#include <algorithm>
+#include <cmath>
 #include <fstream>
-#include <functional> // for std::bind* and std::mem_fun*
-#include <iostream>
-#include <sstream>
 #include <string>
+#include <vector>
 
 #include "Logger/Log.h"
 
@@ -22,11 +21,13 @@ using namespace SideCar::Algorithms;
 //
 LowPassFilter::LowPassFilter(Controller& controller, Logger::Log& log) :
     Super(controller, log), enabled_(Parameter::BoolValue::Make("enabled", "Enabled", kDefaultEnabled)),
-    fftSize_(Parameter::PositiveIntValue::Make("fftSize", "Size of FFT", kDefaultFftSize)),
+    fftThreshold_(
+        Parameter::PositiveIntValue::Make("fftThreshold", "Taps above which to use FFT", kDefaultFftThreshold)),
     kernelFile_(Parameter::StringValue::Make("kernelFile", "Path and name to kernel file", kDefaultKernelFile)),
-    alphas_(), msg_(), filtered_data_(), kernel_()
+    filter_()
 {
-    fftSize_->connectChangedSignalTo(boost::bind(&LowPassFilter::fftSizeChanged, this, _1));
+    kernelFile_->connectChangedSignalTo(boost::bind(&LowPassFilter::kernelFileChanged, this, _1));
+    fftThreshold_->connectChangedSignalTo(boost::bind(&LowPassFilter::fftThresholdChanged, this, _1));
 }
 
 // Startup routine. This is called right after the Controller loads our DLL and creates an instance of the
@@ -37,15 +38,8 @@ bool
 LowPassFilter::startup()
 {
     registerProcessor<LowPassFilter, Messages::Video>(&LowPassFilter::processInput);
-    bool ok = true;
-
-    kernel_.reset(new VsipComplexVector(8, ComplexType(0.0, 0.0)));
-    filtered_data_.reset(new VsipComplexVector(128, ComplexType(0.0, 0.0)));
-    msg_.reset(new VsipComplexVector(128, ComplexType(0.0, 0.0)));
-    ok = ok && registerParameter(enabled_) && registerParameter(kernelFile_) && registerParameter(fftSize_);
-
-    buildFFTs();
-
+    bool ok = registerParameter(enabled_) && registerParameter(kernelFile_) && registerParameter(fftThreshold_);
+    loadKernel();
     return ok && Super::startup();
 }
 
@@ -54,40 +48,34 @@ LowPassFilter::loadKernel()
 {
     static Logger::ProcLog log("loadKernel", getLog());
 
-    std::string file = kernelFile_->getValue().c_str();
-
-    if (file == "") LOGERROR << "No kernel file provided.  Using default!" << std::endl;
+    std::string file = kernelFile_->getValue();
+    if (file.empty()) {
+        LOGERROR << "No kernel file provided" << std::endl;
+        return false;
+    }
 
     std::ifstream input(file.c_str());
+    std::vector<float> taps;
+    if (!FIRFilter::ReadTaps(input, taps)) {
+        LOGERROR << "Unable to load kernel for filter from " << file << std::endl;
+        return false;
+    }
 
-    std::string line;
-    std::vector<float> alphas;
-    float val;
-
-    // Read in each kernel value for the low pass filter
+    // Scale the kernel so that its largest value has a magnitude of one.
     //
-    while (std::getline(input, line)) {
-        std::istringstream converter(line);
-        if (!(converter >> val)) {
-            LOGERROR << "Unable to load kernel for filter.  Bad value: " << line << std::endl;
-            return false;
-        } else {
-            alphas.push_back(val);
-        }
+    float scale = 0.0;
+    for (size_t index = 0; index < taps.size(); ++index) scale = std::max(scale, std::abs(taps[index]));
+    if (scale == 0.0) {
+        LOGERROR << "Kernel in " << file << " is all zeros" << std::endl;
+        return false;
     }
 
-    kernel_.reset(new VsipComplexVector(fftSize_->getValue(), ComplexType(0.0, 0.0)));
-
-    for (size_t i = 0; i < alphas.size(); i++) { kernel_->put(i, ComplexType(alphas[i], 0.0)); }
-
-    float scale;
-    vsip::Index<1> maxIndex;
-    scale = vsip::sqrt(vsip::maxmgsqval(*kernel_, maxIndex));
-
-    *kernel_ /= scale;
-    *kernel_ = (*fwdFFT_)(*kernel_);
-    *kernel_ = vsip::conj(*kernel_);
+    for (size_t index = 0; index < taps.size(); ++index) taps[index] /= scale;
 
+    // Build the new filter off to the side and swap it in so that processInput() never waits on a reload.
+    //
+    boost::atomic_store(&filter_, FIRFilter::Ref(new FIRFilter(taps, 1, 1, 0, fftThreshold_->getValue())));
+    LOGINFO << "loaded " << taps.size() << " taps from " << file << std::endl;
     return true;
 }
 
@@ -100,24 +88,18 @@ LowPassFilter::shutdown()
 }
 
 void
-LowPassFilter::fftSizeChanged(const Parameter::PositiveIntValue& parameter)
+LowPassFilter::kernelFileChanged(const Parameter::StringValue& parameter)
 {
-    Logger::ProcLog log("fftSizeChanged", getLog());
-    LOGINFO << "fftSize: " << parameter.getValue() << std::endl;
-    buildFFTs();
+    Logger::ProcLog log("kernelFileChanged", getLog());
+    LOGINFO << "kernelFile: " << parameter.getValue() << std::endl;
+    loadKernel();
 }
 
 void
-LowPassFilter::buildFFTs()
+LowPassFilter::fftThresholdChanged(const Parameter::PositiveIntValue& parameter)
 {
-    Logger::ProcLog log("buildFFTs", getLog());
-    int fftSize = fftSize_->getValue();
-    LOGINFO << "rebuilding FFTW with size " << fftSize << std::endl;
-
-    fwdFFT_.reset(new FwdFFT(vsip::Domain<1>(fftSize), 1.0));
-    invFFT_.reset(new InvFFT(vsip::Domain<1>(fftSize), 1.0 / fftSize));
-    filtered_data_.reset(new VsipComplexVector(fftSize, ComplexType(0.0, 0.0)));
-
+    Logger::ProcLog log("fftThresholdChanged", getLog());
+    LOGINFO << "fftThreshold: " << parameter.getValue() << std::endl;
     loadKernel();
 }
 
@@ -126,48 +108,22 @@ LowPassFilter::processInput(const Messages::Video::Ref& msg)
 {
     static Logger::ProcLog log("processInput", getLog());
 
-    int msg_size = msg->getSize() / 2;
+    // If not enabled or without a kernel, simply pass message.
+    //
+    FIRFilter::Ref filter(boost::atomic_load(&filter_));
+    if (!enabled_->getValue() || !filter) return send(msg);
 
     // Create a new message to hold the output of what we do. Note that although we pass in the input message,
     // the new message does not contain any data.
     //
     Messages::Video::Ref out(Messages::Video::Make("LowPassFilter::processInput", msg));
-    Messages::Video::Container& outputData(out->getData());
-
-    // Fetch the FFT parameters. The number of windows is the number of FFTs we must execute in order to process
-    // the filter span. Using ::ceil to sure that numWindows covers the entire message.
-    //
-    const int fftSize = fftSize_->getValue();
-    const int numWindows = static_cast<int>(::ceil(static_cast<float>(msg_size) / fftSize));
-    const int totalFFTSize = fftSize * numWindows;
-    const int padding = totalFFTSize - msg_size;
 
-    // Process the RX buffer as windows of fftSize.
+    // The message holds interleaved I and Q values. The filter does not decimate, so the output has as many
+    // samples as the input.
     //
-    for (int windowIndex = 0; windowIndex < numWindows; ++windowIndex) {
-        int offset = windowIndex * fftSize;
-
-        // Copy the appropriate portion of the input into the appropriate FFT buffer
-        //
-        for (int index = 0; index < fftSize; ++index) {
-            filtered_data_->put(index, ComplexType(msg[2 * (offset + index)], msg[2 * (offset + index) + 1]));
-        }
-
-        // Transform input data into frequency space, correlate, and translate result back into time space.
-        //
-        (*filtered_data_) = (*invFFT_)((*kernel_) * (*fwdFFT_)(*filtered_data_));
-
-        // Copy filtered data into output message.
-        //
-        int limit = fftSize;
-        if (windowIndex == numWindows - 1) limit -= padding;
-
-        for (int index = 0; index < limit; ++index) {
-            outputData.push_back(Messages::Video::DatumType((*filtered_data_)(index).real()));
-            outputData.push_back(Messages::Video::DatumType((*filtered_data_)(index).imag()));
-        }
-
-    } // end for each window
+    size_t count = msg->size() / 2;
+    out->resize(count * 2);
+    filter->filterIQ(msg->getData().data(), count, out->getData().data());
 
     // Send out on the default output device, and return the result to our Controller. NOTE: for multichannel
     // output, one must give a channel index to the send() method. Use getOutputChannelIndex() to obtain the
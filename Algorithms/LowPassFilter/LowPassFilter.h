@@ -2,30 +2,25 @@
 #define SIDECAR_ALGORITHMS_LOWPASSFILTER_H
 
 #include "Algorithms/Algorithm.h"
+#include "Algorithms/FIRFilter.h"
 #include "Messages/Video.h"
 #include "Parameter/Parameter.h"
 
-#include <complex>
-#include <vector>
-
-#include <vsip/matrix.hpp>
-#include <vsip/signal.hpp>
-#include <vsip/vector.hpp>
-
 namespace SideCar {
 namespace Algorithms {
 
-/** Documentation for the algorithm LowPassFilter. Please describe what the algorithm does, in layman's terms
-    and, if possible, mathematical terms.
+/** Low-pass filter for complex (I/Q) video. Each output sample is the correlation of the input with the kernel
+    read from the file named by the kernelFile parameter:
+
+    \code
+    y[n] = sum over k of h[k] * x[n + k]
+    \endcode
+
+    where the kernel values are scaled so that the largest has a magnitude of one, and samples past the end of the
+    PRI are zero. Kernels with more than fftThreshold taps are applied with overlap-save FFT convolution.
 */
 class LowPassFilter : public Algorithm {
     using Super = Algorithm;
-    using ComplexType = std::complex<float>;
-    using VsipFloatVector = vsip::Vector<float>;
-    using VsipComplexVector = vsip::Vector<ComplexType>;
-    using VsipFIR = vsip::Fir<ComplexType>;
-    using FwdFFT = vsip::Fft<vsip::Vector, ComplexType, ComplexType, vsip::fft_fwd>;
-    using InvFFT = vsip::Fft<vsip::Vector, ComplexType, ComplexType, vsip::fft_inv>;
 
 public:
     enum InfoSlots { kEnabled = ControllerStatus::kNumSlots, kNumSlots };
@@ -52,9 +47,9 @@ public:
     bool shutdown();
 
 private:
-    void fftSizeChanged(const Parameter::PositiveIntValue& parameter);
+    void kernelFileChanged(const Parameter::StringValue& parameter);
+    void fftThresholdChanged(const Parameter::PositiveIntValue& parameter);
     size_t getNumInfoSlots() const { return kNumSlots; }
-    void buildFFTs();
     void setInfoSlots(IO::StatusBase& status);
 
     /** Process messages from channel
@@ -65,22 +60,17 @@ private:
     */
     bool processInput(const Messages::Video::Ref& msg);
 
+    /** Read the kernel file and build a new filter from it. The filter in use is replaced only if the load
+        succeeds.
+
+        \return true if successful
+    */
     bool loadKernel();
-    // Add attributes here
-    //
+
     Parameter::BoolValue::Ref enabled_;
-    Parameter::PositiveIntValue::Ref fftSize_;
+    Parameter::PositiveIntValue::Ref fftThreshold_;
     Parameter::StringValue::Ref kernelFile_;
-
-    std::vector<Parameter::DoubleValue::Ref> alphas_;
-
-    boost::scoped_ptr<VsipComplexVector> msg_;
-    boost::scoped_ptr<VsipComplexVector> filtered_data_;
-    boost::scoped_ptr<VsipComplexVector> kernel_;
-
-    boost::scoped_ptr<FwdFFT> fwdFFT_;
-    boost::scoped_ptr<InvFFT> invFFT_;
-    boost::scoped_ptr<VsipComplexVector> txPulseVec_;
+    FIRFilter::Ref filter_;
 };
 
 } // end namespace Algorithms
@@ -1,3 +1,3 @@
 static const bool kDefaultEnabled = 1;
-static const int kDefaultFftSize = 1024;
+static const int kDefaultFftThreshold = 64;
 static const char* const kDefaultKernelFile = "";
@@ -1,4 +1,5 @@
 #include "Logger/Log.h"
+#include "Time/TimeStamp.h"
 #include "XMLRPC/XmlRpcValue.h"
 
 #include "ChannelBuffer.h"
@@ -7,6 +8,17 @@
 
 using namespace SideCar::Algorithms;
 
+static const char* kJoinPolicyNames[] = {
+    "Drop Incomplete",
+    "Fill Missing",
+};
+
+const char* const*
+ManyInAlgorithm::JoinPolicyEnumTraits::GetEnumNames()
+{
+    return kJoinPolicyNames;
+}
+
 QString
 ManyInAlgorithm::GetFormattedStats(const IO::StatusBase& status)
 {
@@ -20,12 +32,24 @@ ManyInAlgorithm::GetFormattedStats(const IO::StatusBase& status)
         if (size) output += QString("C%1[%2]  ").arg(id).arg(size);
     }
 
+    int dropped = status[kDropped];
+    if (dropped) output += QString("Drop %1  ").arg(dropped);
+
+    int filled = status[kFilled];
+    if (filled) output += QString("Fill %1  ").arg(filled);
+
+    const XmlRpc::XmlRpcValue& latency(status[kJoinLatency]);
+    if (int(latency[ControllerStatus::kLatencyCount])) {
+        output += QString("Join P99 %1ms  ").arg(double(latency[ControllerStatus::kLatencyP99]) * 1.0E3, 0, 'f', 1);
+    }
+
     return output;
 }
 
 ManyInAlgorithm::ManyInAlgorithm(Controller& controller, Logger::Log& log, bool enabled, size_t maxBufferSize) :
     Algorithm(controller, log), channels_(), enabled_(Parameter::BoolValue::Make("enabled", "Enabled", enabled)),
-    maxBufferSize_(Parameter::PositiveIntValue::Make("maxBufferSize", "Max channel buffer size", maxBufferSize))
+    maxBufferSize_(Parameter::PositiveIntValue::Make("maxBufferSize", "Max channel buffer size", maxBufferSize)),
+    joinPolicy_(JoinPolicyParameter::Make("joinPolicy", "Incomplete Sets", kDropIncomplete)), joinLatency_()
 {
     maxBufferSize_->connectChangedSignalTo([this](auto& v) { maxBufferSizeChanged(v); });
 }
@@ -49,13 +73,15 @@ ManyInAlgorithm::startup()
 
     // Register our runtime parameters and let our parent class startup.
     //
-    return Super::startup() && registerParameter(enabled_) && registerParameter(maxBufferSize_);
+    return Super::startup() && registerParameter(enabled_) && registerParameter(maxBufferSize_) &&
+           registerParameter(joinPolicy_);
 }
 
 bool
 ManyInAlgorithm::reset()
 {
     for (auto c : channels_) c->reset();
+    joinLatency_.reset();
     return Super::reset();
 }
 
@@ -79,13 +105,9 @@ struct ChannelMaxSequence {
 
     void operator()(ChannelBuffer* channel)
     {
-        static const uint32_t kWrapped = (1 << 16);
         if (channel->isEmpty() || !channel->isEnabled()) return;
         uint32_t seq = channel->getNextSequenceCounter();
-
-        // Check for and handle wrap-around of sequence numbers.
-        //
-        if ((seq < maxSeq_ && maxSeq_ - seq > kWrapped) || (seq > maxSeq_)) { maxSeq_ = seq; }
+        if (ChannelBuffer::IsOlder(maxSeq_, seq)) { maxSeq_ = seq; }
     }
 
     operator uint32_t() const { return maxSeq_; }
@@ -159,6 +181,19 @@ ManyInAlgorithm::setInfoSlots(IO::StatusBase& status)
     // Set the number of enabled channels we found above.
     //
     status.setSlot(kChannelStats, v);
+
+    // Same race condition as above for the counters and the histogram, but a stale value does no harm.
+    //
+    int dropped = 0;
+    int filled = 0;
+    for (auto channel : channels_) {
+        dropped += channel->getDroppedCount();
+        filled += channel->getFilledCount();
+    }
+
+    status.setSlot(kDropped, dropped);
+    status.setSlot(kFilled, filled);
+    status.setSlot(kJoinLatency, ControllerStatus::MakeLatencySummary(joinLatency_));
 }
 
 void
@@ -172,18 +207,79 @@ bool
 ManyInAlgorithm::processMessageReceived()
 {
     // NOTE: we should only get called from ChannelBuffer::addData(). Therefore, we can safely assume that there
-    // is at least one message in one of our channels.
+    // is at least one message in one of our channels. Keep going while there are sets to process or drop, since
+    // dropping or filling one set may complete the next.
     //
-    uint32_t maxSeq = getMaxSequenceCounter();
+    while (true) {
+        // Locate the oldest sequence counter at the front of the enabled channels.
+        //
+        ChannelBuffer* basis = nullptr;
+        uint32_t oldest = 0;
+        for (auto channel : channels_) {
+            if (!channel->isEnabled() || channel->isEmpty()) continue;
+            uint32_t seq = channel->getNextSequenceCounter();
+            if (!basis || ChannelBuffer::IsOlder(seq, oldest)) {
+                basis = channel;
+                oldest = seq;
+            }
+        }
 
-    // Determine if all of our channels have a message with the same sequence number.
-    //
-    if (!pruneToSequenceCounter(maxSeq)) return true;
+        if (!basis) return true;
 
-    // We have a message in every channel to process. Derived classes must have an implementation of
-    // processChannels().
-    //
-    return processChannels();
+        // Sort the enabled channels by whether they have the sequence counter, may yet receive it (empty), or
+        // never will (newer message at the front). Remember when the first message of the set arrived.
+        //
+        Time::TimeStamp arrival(basis->getFrontArrival());
+        size_t waiting = 0;
+        size_t missing = 0;
+        for (auto channel : channels_) {
+            if (!channel->isEnabled()) continue;
+            if (channel->isEmpty()) {
+                ++waiting;
+            } else if (channel->getNextSequenceCounter() != oldest) {
+                ++missing;
+            } else if (channel->getFrontArrival() < arrival) {
+                arrival = channel->getFrontArrival();
+            }
+        }
+
+        if (missing) {
+            if (getJoinPolicy() == kDropIncomplete) {
+                for (auto channel : channels_) {
+                    if (channel->isEnabled() && !channel->isEmpty() && channel->getNextSequenceCounter() == oldest) {
+                        channel->dropFront();
+                    }
+                }
+                continue;
+            }
+
+            if (waiting) return true;
+
+            // A channel with a newer message at its front has held a message, so it can always provide a fill.
+            //
+            Messages::PRIMessage::Ref msg(basis->getFront());
+            for (auto channel : channels_) {
+                if (channel->isEnabled() && channel->getNextSequenceCounter() != oldest) channel->fillFront(msg);
+            }
+        } else if (waiting) {
+            return true;
+        }
+
+        // We have a message in every channel to process. Derived classes must have an implementation of
+        // processChannels().
+        //
+        joinLatency_.addSeconds((Time::TimeStamp::Now() - arrival).asDouble());
+        if (!processChannels()) return false;
+
+        // Derived classes pop the messages they use, but make sure that they are gone so that the loop above
+        // always progresses.
+        //
+        for (auto channel : channels_) {
+            if (channel->isEnabled() && !channel->isEmpty() && channel->getNextSequenceCounter() == oldest) {
+                channel->popFront();
+            }
+        }
+    }
 }
 
 void
@@ -8,6 +8,7 @@
 
 #include "Algorithms/Algorithm.h"
 #include "Algorithms/ControllerStatus.h"
+#include "Utils/LatencyHistogram.h"
 
 namespace SideCar {
 namespace Algorithms {
@@ -23,12 +24,31 @@ class TChannelBuffer;
     remove from the channels any messages with a lesser sequence counter value, returning true if one or more of
     the resulting channel buffers is empty. When it returns false, then one may safely access the first message
     from each ChannelBuffer object using ChannelBuffer::getFront().
+
+    The default processMessageReceived() joins the channels this way: it looks at the oldest sequence counter
+    at the front of the enabled channels, and calls processChannels() once every enabled channel has a message
+    with it. Since channels are FIFOs, a channel whose first message is newer will never supply the missing
+    one. The joinPolicy parameter decides what happens then: kDropIncomplete discards the messages of the
+    incomplete set, while kFillMissing places zero-filled messages in the channels that lack one, and processes
+    the set once no channel is still waiting for it. The time from the arrival of the first message of a set to
+    its processing, and the counts of dropped and filled messages, appear in the status info.
 */
 class ManyInAlgorithm : public Algorithm {
     using Super = Algorithm;
 
 public:
-    enum InfoSlot { kEnabled = ControllerStatus::kNumSlots, kChannelStats, kNumSlots };
+    enum InfoSlot {
+        kEnabled = ControllerStatus::kNumSlots,
+        kChannelStats,
+        kJoinLatency,
+        kDropped,
+        kFilled,
+        kNumSlots
+    };
+
+    /** What to do with messages whose sequence counter is missing from one or more of the other channels.
+     */
+    enum JoinPolicy { kDropIncomplete, kFillMissing };
 
     static QString GetFormattedStats(const IO::StatusBase& status);
 
@@ -64,6 +84,12 @@ public:
     */
     bool isEnabled() const { return enabled_->getValue(); }
 
+    /** Obtain the policy for incomplete sets of messages.
+
+        \return join policy
+    */
+    JoinPolicy getJoinPolicy() const { return joinPolicy_->getValue(); }
+
     /** Obtain the current max buffer size.
 
         \return max buffer size
@@ -195,6 +221,15 @@ private:
     */
     void maxBufferSizeChanged(const Parameter::PositiveIntValue& parameter);
 
+    struct JoinPolicyEnumTraits : public Parameter::Defs::EnumTypeTraitsBase {
+        using ValueType = JoinPolicy;
+        static ValueType GetMinValue() { return kDropIncomplete; }
+        static ValueType GetMaxValue() { return kFillMissing; }
+        static const char* const* GetEnumNames();
+    };
+
+    using JoinPolicyParameter = Parameter::TValue<Parameter::Defs::Enum<JoinPolicyEnumTraits>>;
+
     /** Run-time parameter for enabled state. If false, just pass thru messages from the first input channel.
      */
     Parameter::BoolValue::Ref enabled_;
@@ -202,6 +237,14 @@ private:
     /** Run-time parameter for a channel's internal buffer size
      */
     Parameter::PositiveIntValue::Ref maxBufferSize_;
+
+    /** Run-time parameter for the handling of incomplete sets of messages
+     */
+    JoinPolicyParameter::Ref joinPolicy_;
+
+    /** Time from the arrival of the first message of a set to its processing
+     */
+    ::Utils::LatencyHistogram joinLatency_;
 };
 
 } // end namespace Algorithms
@@ -0,0 +1,193 @@
+#include <vector>
+
+#include "ace/OS_NS_unistd.h"
+
+#include "IO/ParametersChangeRequest.h"
+#include "IO/Stream.h"
+#include "Logger/Log.h"
+#include "Messages/VMEHeader.h"
+#include "Messages/Video.h"
+#include "UnitTest/UnitTest.h"
+#include "XMLRPC/XmlRpcValue.h"
+
+#include "ChannelBuffer.h"
+#include "Controller.h"
+#include "ManyInAlgorithm.h"
+
+using namespace SideCar;
+using namespace SideCar::Algorithms;
+using namespace SideCar::Messages;
+
+struct ManyInAlgorithmTest : public UnitTest::TestObj {
+    ManyInAlgorithmTest() : TestObj("ManyInAlgorithm") {}
+
+    void test();
+};
+
+/** Algorithm that joins two Video channels and remembers the sequence counter of each set it processes, along
+    with the first sample of the second channel so that tests can tell filled messages apart.
+*/
+class Joiner : public ManyInAlgorithm {
+public:
+    Joiner(Controller& controller, Logger::Log& log) : ManyInAlgorithm(controller, log), sequences_(), samples_() {}
+
+    bool processChannels() override
+    {
+        Video::Ref first(getChannelBuffer<Video>(0)->popFront());
+        Video::Ref second(getChannelBuffer<Video>(1)->popFront());
+        if (first->getSequenceCounter() != second->getSequenceCounter()) return false;
+        sequences_.push_back(first->getSequenceCounter());
+        samples_.push_back((*second)[0]);
+        return true;
+    }
+
+    ChannelBuffer* makeChannelBuffer(int channelIndex, const std::string& name, size_t maxBufferSize) override
+    {
+        return new TChannelBuffer<Video>(*this, channelIndex, maxBufferSize);
+    }
+
+    std::vector<uint32_t> sequences_;
+    std::vector<int> samples_;
+};
+
+/** Add a message with the given sequence counter to a channel of the Joiner.
+ */
+static bool
+Add(Joiner* joiner, size_t channel, uint32_t sequenceCounter)
+{
+    VMEDataMessage vme;
+    vme.header.pri = sequenceCounter;
+    Video::DatumType init[] = {Video::DatumType(sequenceCounter), 1, 2};
+    return joiner->getChannelBuffer<Video>(channel)->addData(Video::Make("test", vme, init, init + 3));
+}
+
+void
+ManyInAlgorithmTest::test()
+{
+    Logger::Log::Root().setPriorityLimit(Logger::Priority::kError);
+
+    IO::Stream::Ref stream(IO::Stream::Make("ManyInAlgorithmTest"));
+    ControllerModule* module = new ControllerModule(stream);
+    assertEqual(0, stream->push(module));
+    Controller::Ref controller = module->getTask();
+    controller->setTaskIndex(0);
+    controller->addInputChannel(IO::Channel("a", "Video"));
+    controller->addInputChannel(IO::Channel("b", "Video"));
+
+    Joiner* joiner = new Joiner(*controller, Logger::Log::Root());
+    assertTrue(controller->openAndInit("joiner", "", joiner));
+    assertEqual(size_t(2), joiner->getChannelCount());
+    assertEqual(ManyInAlgorithm::kDropIncomplete, joiner->getJoinPolicy());
+
+    ChannelBuffer* a = joiner->getGenericChannelBuffer(0);
+    ChannelBuffer* b = joiner->getGenericChannelBuffer(1);
+
+    // Nothing is processed while the other channel may still deliver the same sequence counters.
+    //
+    assertTrue(Add(joiner, 0, 1));
+    assertTrue(Add(joiner, 0, 2));
+    assertTrue(Add(joiner, 0, 3));
+    assertTrue(joiner->sequences_.empty());
+    assertEqual(size_t(3), a->size());
+
+    // Sets complete in order as the late channel catches up.
+    //
+    assertTrue(Add(joiner, 1, 1));
+    assertEqual(size_t(1), joiner->sequences_.size());
+    assertTrue(Add(joiner, 1, 2));
+    assertTrue(Add(joiner, 1, 3));
+    assertEqual(size_t(3), joiner->sequences_.size());
+    assertEqual(1U, joiner->sequences_[0]);
+    assertEqual(2U, joiner->sequences_[1]);
+    assertEqual(3U, joiner->sequences_[2]);
+    assertTrue(a->isEmpty());
+    assertTrue(b->isEmpty());
+
+    // Either channel may lead.
+    //
+    assertTrue(Add(joiner, 1, 4));
+    assertEqual(size_t(3), joiner->sequences_.size());
+    assertTrue(Add(joiner, 0, 4));
+    assertEqual(size_t(4), joiner->sequences_.size());
+    assertEqual(4U, joiner->sequences_.back());
+
+    // A newer message in channel b means that it will never have 5, so channel a's 5 is dropped, and 6 is
+    // processed once channel a has it.
+    //
+    assertTrue(Add(joiner, 0, 5));
+    assertTrue(Add(joiner, 1, 6));
+    assertEqual(size_t(4), joiner->sequences_.size());
+    assertEqual(size_t(1), a->getDroppedCount());
+    assertEqual(size_t(0), b->getDroppedCount());
+    assertTrue(a->isEmpty());
+    assertTrue(Add(joiner, 0, 6));
+    assertEqual(size_t(5), joiner->sequences_.size());
+    assertEqual(6U, joiner->sequences_.back());
+    assertEqual(size_t(0), a->getFilledCount() + b->getFilledCount());
+
+    // The same holds when several sequence counters go missing at once.
+    //
+    assertTrue(Add(joiner, 0, 7));
+    assertTrue(Add(joiner, 0, 8));
+    assertTrue(Add(joiner, 0, 9));
+    assertTrue(Add(joiner, 1, 9));
+    assertEqual(size_t(6), joiner->sequences_.size());
+    assertEqual(9U, joiner->sequences_.back());
+    assertEqual(size_t(3), a->getDroppedCount());
+
+    // Switch to filling in missing messages. The change happens in the controller's thread.
+    //
+    XmlRpc::XmlRpcValue change;
+    change.setSize(2);
+    change[0] = "joinPolicy";
+    change[1] = int(ManyInAlgorithm::kFillMissing);
+    assertTrue(controller->injectControlMessage(IO::ParametersChangeRequest(change, false)));
+    for (int count = 0; count < 500 && joiner->getJoinPolicy() != ManyInAlgorithm::kFillMissing; ++count) {
+        ACE_OS::sleep(ACE_Time_Value(0, 10000));
+    }
+
+    assertEqual(ManyInAlgorithm::kFillMissing, joiner->getJoinPolicy());
+
+    // Channel b skips 10, so a zero-filled message stands in for it. The fill has the size of the last message
+    // in channel b.
+    //
+    assertTrue(Add(joiner, 0, 10));
+    assertEqual(size_t(6), joiner->sequences_.size());
+    assertTrue(Add(joiner, 1, 11));
+    assertEqual(size_t(7), joiner->sequences_.size());
+    assertEqual(10U, joiner->sequences_.back());
+    assertEqual(0, joiner->samples_.back());
+    assertEqual(size_t(1), b->getFilledCount());
+    assertEqual(size_t(0), a->getFilledCount());
+    assertEqual(size_t(1), b->size());
+
+    assertTrue(Add(joiner, 0, 11));
+    assertEqual(size_t(8), joiner->sequences_.size());
+    assertEqual(11U, joiner->sequences_.back());
+    assertEqual(11, joiner->samples_.back());
+
+    // A fill waits while the other channel is empty, since it may yet deliver the sequence counter.
+    //
+    assertTrue(Add(joiner, 0, 12));
+    assertEqual(size_t(8), joiner->sequences_.size());
+    assertTrue(Add(joiner, 1, 13));
+    assertEqual(size_t(9), joiner->sequences_.size());
+    assertEqual(12U, joiner->sequences_.back());
+    assertEqual(0, joiner->samples_.back());
+    assertEqual(size_t(2), b->getFilledCount());
+    assertEqual(size_t(1), b->size());
+
+    // Dropped and filled counts start over after a reset.
+    //
+    assertTrue(joiner->reset());
+    assertEqual(size_t(0), a->getDroppedCount());
+    assertEqual(size_t(0), b->getFilledCount());
+    assertTrue(a->isEmpty());
+    assertTrue(b->isEmpty());
+}
+
+int
+main(int argc, char** argv)
+{
+    return ManyInAlgorithmTest().mainRun();
+}
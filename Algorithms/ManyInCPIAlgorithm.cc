@@ -44,34 +44,37 @@ struct ChannelCPIPrune {
 
         // Iterate through the buffer looking for the CPI boundary which is currently identified by checking
         // the prfEncoding field in the PRI Message header. Currently, we look for M_(i).code !=
-        // M2_(i+1).code. If i != cpiSpan-1, then we have an invalid CPI (ie, it's missing messages).
+        // M2_(i+1).code. If i != cpiSpan-1, then we have an invalid CPI (ie, it's missing messages). After
+        // pruning an incomplete CPI, start over from the new front of the buffer.
         //
-        ChannelBuffer::const_iterator itr = channel->begin();
         Messages::PRIMessage::Ref last = channel->getFront();
-        size_t pos = 0; // location of start of next CPI
-        bool cpiBoundary = false;
-        ++itr; // move to next PRI message
-        ++pos;
-        for (; itr != channel->end() && pos <= cpiSpan_; ++itr, ++pos) {
+        size_t pos = 1; // location of start of next CPI
+        while (pos < channel->size() && pos <= cpiSpan_) {
+            Messages::PRIMessage::Ref msg(channel->getMessage(pos));
+
             // Check for CPI boundary
             //
-            cpiBoundary = (last->getRIUInfo().prfEncoding != (*itr)->getRIUInfo().prfEncoding);
-
-            if (cpiBoundary) {
-                // Found the boundary, ensure it is located at the proper index which is equal to the
-                // cpiSpan. This will implicitly check that no messages were dropped between the first PRI
-                // message of a CPI and the last one.
-                //
-                if (pos != cpiSpan_) {
-                    // Need to prune off incomplete CPI by pruning to the sequence number of the start of
-                    // the next CPI
-                    //
-                    if (!channel->pruneToSequenceCounter((*itr)->getSequenceCounter())) ok_ = false;
-
-                } // end if (pos != cpiSpan_)
-            }     // end if (delta > thresh)
-        }         // end for loop
-    }             // end void operator()
+            bool cpiBoundary = (last->getRIUInfo().prfEncoding != msg->getRIUInfo().prfEncoding);
+
+            // Found the boundary, ensure it is located at the proper index which is equal to the cpiSpan. This
+            // will implicitly check that no messages were dropped between the first PRI message of a CPI and
+            // the last one. If not, prune off the incomplete CPI by pruning to the sequence number of the start
+            // of the next CPI.
+            //
+            if (cpiBoundary && pos != cpiSpan_) {
+                if (!channel->pruneToSequenceCounter(msg->getSequenceCounter())) {
+                    ok_ = false;
+                    return;
+                }
+
+                last = channel->getFront();
+                pos = 1;
+                continue;
+            }
+
+            ++pos;
+        }
+    }
 
     operator bool() const { return valid_ && ok_; }
 
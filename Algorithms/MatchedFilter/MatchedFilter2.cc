@@ -1,11 +1,10 @@
 #include "boost/bind.hpp"
 
-#include <fftw3.h>
-
 #include <algorithm>  // for std::transform
 #include <functional> // for std::bind* and std::mem_fun*
 
 #include "Algorithms/Controller.h"
+#include "Algorithms/ParameterStager.h"
 #include "Algorithms/Utils.h"
 #include "Logger/Log.h"
 
@@ -71,19 +70,22 @@ MatchedFilter::MatchedFilter(Controller& controller, Logger::Log& logger) :
                                                    kDefaultTxThresholdStartBin)),
     txThresholdSpan_(Parameter::IntValue::Make("txThresholdSpan", "Number of complex bins to search for Tx pulse",
                                                kDefaultTxThresholdSpan)),
-    fwdFFT_(), txPulseVec_(), workerThreads_(0), idleWorkRequests_(new WorkRequestQueue("idle")),
+    fftSetup_(), activeFFTSize_(0), activeFFTThreads_(0), processing_(false), txPulse_(), workerThreads_(0),
+    idleWorkRequests_(new WorkRequestQueue("idle")),
     pendingWorkRequests_(new WorkRequestQueue("pending")), finishedWorkRequests_(new WorkRequestQueue("finished")),
     noPulseDetected_(false), restartWorkerThreads_(true)
 {
-    Logger::ProcLog log("MatchedFilter", logger);
-
-    if (!fftw_init_threads()) LOGERROR << "failed fftw_init_threads" << std::endl;
-
     numWorkers_->connectChangedSignalTo(boost::bind(&MatchedFilter::numWorkersChanged, this, _1));
+    numFFTThreads_->connectChangedSignalTo(boost::bind(&MatchedFilter::numFFTThreadsChanged, this, _1));
     fftSize_->connectChangedSignalTo(boost::bind(&MatchedFilter::fftSizeChanged, this, _1));
     rxFilterSpan_->connectChangedSignalTo(boost::bind(&MatchedFilter::rxFilterSpanChanged, this, _1));
 }
 
+MatchedFilter::~MatchedFilter()
+{
+    ParameterStager::Instance().cancel(this);
+}
+
 // Startup routine. This is called right after the Controller loads our DLL and creates an instance of the
 // MatchedFilter class. Place registerProcessor and registerParameter calls here. Also, be sure to invoke
 // Algorithm::startup() as shown below.
@@ -91,6 +93,13 @@ MatchedFilter::MatchedFilter(Controller& controller, Logger::Log& logger) :
 bool
 MatchedFilter::startup()
 {
+    // Nothing is flowing yet, so build the initial plans right here.
+    //
+    fftSetup_.publish(FFTSetup::Make(fftSize_->getValue(), numFFTThreads_->getValue()));
+    fftSetup_.update();
+    activeFFTSize_ = fftSetup_.get()->fftSize;
+    activeFFTThreads_ = fftSetup_.get()->numFFTThreads;
+
     return registerParameter(txPulseStartBin_) && registerParameter(txPulseSpan_) &&
            registerParameter(rxFilterStartBin_) && registerParameter(rxFilterSpan_) && registerParameter(domain_) &&
            registerParameter(fftSize_) && registerParameter(scaleWithSumMag_) && registerParameter(numWorkers_) &&
@@ -103,7 +112,9 @@ MatchedFilter::shutdown()
 {
     // Note: at this point there is no algorithm thread running, so this is safe to do here.
     //
+    ParameterStager::Instance().cancel(this);
     stopThreads();
+    processing_ = false;
 
     // When stopThreads() returns, no worker threads will be running so we can safely delete all WorkRequest
     // objects.
@@ -137,7 +148,7 @@ MatchedFilter::getWorkRequest()
     //
     ACE_Message_Block* data = 0;
     if (idleWorkRequests_->message_count() && idleWorkRequests_->dequeue_head(data) != -1) return data;
-    return WorkRequest::Make(txPulseVec_.get(), numFFTThreads_->getValue(), fftSize_->getValue());
+    return WorkRequest::Make(&txPulse_, fftSetup_.getRef());
 }
 
 bool
@@ -178,8 +189,7 @@ MatchedFilter::startThreads()
         //
         ACE_Message_Block* data;
         idleWorkRequests_->dequeue_head(data);
-        WorkRequest::FromMessageBlock(data)->reconfigure(txPulseVec_.get(), numFFTThreads_->getValue(),
-                                                         fftSize_->getValue());
+        WorkRequest::FromMessageBlock(data)->reconfigure(&txPulse_, fftSetup_.getRef());
         idleWorkRequests_->enqueue_tail(data);
     }
 
@@ -235,12 +245,20 @@ MatchedFilter::numWorkersChanged(const Parameter::PositiveIntValue& parameter)
     setRestartWorkerThreads();
 }
 
+void
+MatchedFilter::numFFTThreadsChanged(const Parameter::PositiveIntValue& parameter)
+{
+    Logger::ProcLog log("numFFTThreadsChanged", getLog());
+    LOGINFO << "numFFTThreads: " << parameter.getValue() << std::endl;
+    stageFFTSetup();
+}
+
 void
 MatchedFilter::fftSizeChanged(const Parameter::PositiveIntValue& parameter)
 {
     Logger::ProcLog log("fftSizeChanged", getLog());
     LOGINFO << "fftSize: " << parameter.getValue() << std::endl;
-    setRestartWorkerThreads();
+    stageFFTSetup();
 }
 
 void
@@ -252,17 +270,29 @@ MatchedFilter::rxFilterSpanChanged(const Parameter::IntValue& parameter)
 }
 
 void
-MatchedFilter::buildFFTs()
+MatchedFilter::stageFFTSetup()
 {
-    Logger::ProcLog log("buildFFTs", getLog());
+    Logger::ProcLog log("stageFFTSetup", getLog());
     int fftSize = fftSize_->getValue();
-    LOGINFO << "rebuilding FFTW with size " << fftSize << std::endl;
+    int numFFTThreads = numFFTThreads_->getValue();
+    LOGINFO << "staging FFT plans with size " << fftSize << std::endl;
 
-    fftw_plan_with_nthreads(numFFTThreads_->getValue());
-    fwdFFT_.reset(new FwdFFT(vsip::Domain<1>(fftSize), 1.0));
-    fftw_plan_with_nthreads(1);
+    // Configuration changes usually land after startup() but before the first message. Build the plans for them
+    // now so that no message sees the defaults. Drop any job still waiting so that it cannot replace them with
+    // older values later.
+    //
+    if (!processing_) {
+        ParameterStager::Instance().cancel(this);
+        fftSetup_.publish(FFTSetup::Make(fftSize, numFFTThreads));
+        return;
+    }
 
-    txPulseVec_.reset(new VsipComplexVector(fftSize));
+    // Planning a size new to this process may take FFTW a long time, so do it away from the processing thread.
+    // Sizes seen before come straight from the engine's cache.
+    //
+    ParameterStager::Instance().submit(this, [this, fftSize, numFFTThreads]() {
+        fftSetup_.publish(FFTSetup::Make(fftSize, numFFTThreads));
+    });
 }
 
 ChannelBuffer*
@@ -292,6 +322,7 @@ MatchedFilter::processChannels()
 
     Messages::Video::Ref rxMsg(rx_->popFront());
     Messages::Video::Ref txMsg(tx_->popFront());
+    processing_ = true;
 
     if (!isEnabled()) {
         LOGDEBUG << "not enabled" << std::endl;
@@ -336,12 +367,21 @@ MatchedFilter::processChannels()
 
     noPulseDetected_ = false;
 
-    // Check if we need to (re)start our worker threads. Done here to remove any chance of a race condition with
-    // our message processing thread that runs this method.
+    // Adopt any FFT setup staged since the last message, and check if we need to (re)start our worker threads.
+    // Done here to remove any chance of a race condition with our message processing thread that runs this
+    // method.
     //
-    if (getRestartWorkerThreads()) {
+    bool restart = getRestartWorkerThreads();
+    if (fftSetup_.update()) {
+        activeFFTSize_ = fftSetup_.get()->fftSize;
+        activeFFTThreads_ = fftSetup_.get()->numFFTThreads;
+        restart = true;
+    }
+
+    const FFTSetup& setup(*fftSetup_.get());
+    if (restart) {
         if (workerThreads_) stopThreads();
-        buildFFTs();
+        txPulse_.resize(setup.fftSize);
         startThreads();
     }
 
@@ -405,7 +445,7 @@ MatchedFilter::processChannels()
         // Fetch the FFT parameters. The number of windows is the number of FFTs we must execute in order to
         // process the filter span. Using ::ceil to sure that numWindows covers the entire message.
         //
-        const int fftSize = fftSize_->getValue();
+        const int fftSize = setup.fftSize;
         int numWindows = static_cast<int>(::ceil(static_cast<float>(rxFilterSpan) / fftSize));
         const int totalFFTSize = fftSize * numWindows;
         const int padding = totalFFTSize - rxFilterSpan;
@@ -414,32 +454,37 @@ MatchedFilter::processChannels()
         //
         Messages::Video::const_iterator pos(txMsg->begin());
         pos += 2 * txPulseStart;
+        if (txPulseSpan > fftSize) txPulseSpan = fftSize;
         for (int index = 0; index < txPulseSpan; ++index) {
             float i = *pos++;
             float q = *pos++;
-            txPulseVec_->put(index, ComplexType(i, q));
+            txPulse_[index] = ComplexType(i, q);
         }
 
-        // Pad the txPulseVec with zeroes so that it represents a length equal to fftSize
+        // Pad the txPulse with zeroes so that it represents a length equal to fftSize
         //
-        for (int index = txPulseSpan; index < fftSize; ++index) txPulseVec_->put(index, ComplexType(0.0, 0.0));
+        std::fill(txPulse_.data() + txPulseSpan, txPulse_.data() + fftSize, ComplexType(0.0, 0.0));
 
         // Fetch the average magnitude found within the pulse. Since this value is always non-negative (sum of
         // squares), we don't need to use a complex type to represent it.
         //
-        float scale;
-        if (scaleWithSumMag_->getValue()) {
-            scale = vsip::sqrt(vsip::sumval(vsip::magsq(*txPulseVec_)));
-        } else {
-            vsip::Index<1> maxIndex;
-            scale = vsip::sqrt(vsip::maxmgsqval(*txPulseVec_, maxIndex));
+        float scale = 0.0;
+        for (int index = 0; index < txPulseSpan; ++index) {
+            float magsq = std::norm(txPulse_[index]);
+            if (scaleWithSumMag_->getValue()) {
+                scale += magsq;
+            } else if (magsq > scale) {
+                scale = magsq;
+            }
         }
 
+        scale = 1.0 / ::sqrt(scale);
+
         // Convert xmit pulse into frequence domain.
         //
-        *txPulseVec_ /= scale;
-        *txPulseVec_ = (*fwdFFT_)(*txPulseVec_);
-        *txPulseVec_ = vsip::conj(*txPulseVec_);
+        for (int index = 0; index < txPulseSpan; ++index) txPulse_[index] *= scale;
+        setup.fwdFFT->execute(txPulse_.data());
+        for (int index = 0; index < fftSize; ++index) txPulse_[index] = std::conj(txPulse_[index]);
 
         // Process the rx buffer as windows of fftSize, each window processed by a separate thread.
         //
@@ -541,9 +586,9 @@ void
 MatchedFilter::setInfoSlots(IO::StatusBase& status)
 {
     Super::setInfoSlots(status);
-    status.setSlot(kFFTSize, fftSize_->getValue());
+    status.setSlot(kFFTSize, activeFFTSize_.load());
     status.setSlot(kWorkerCount, numWorkers_->getValue());
-    status.setSlot(kFFTThreadCount, numFFTThreads_->getValue());
+    status.setSlot(kFFTThreadCount, activeFFTThreads_.load());
     status.setSlot(kDomain, domain_->getValue());
     status.setSlot(kNoPulseDetected, noPulseDetected_);
 }
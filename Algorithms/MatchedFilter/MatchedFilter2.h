@@ -1,6 +1,7 @@
 #ifndef SIDECAR_ALGORITHMS_MATCHEDFILTER_H // -*- C++ -*-
 #define SIDECAR_ALGORITHMS_MATCHEDFILTER_H
 
+#include <atomic>
 #include <complex>
 
 #include "ace/Message_Queue_T.h"
@@ -10,11 +11,14 @@
 #include <vsip/signal.hpp>
 #include <vsip/vector.hpp>
 
+#include "Algorithms/FFTEngine.h"
 #include "Algorithms/ManyInAlgorithm.h"
 #include "Messages/Video.h"
 #include "Parameter/Parameter.h"
+#include "Utils/Snapshot.h"
 
 #include "MatchedFilterTypes.h"
+#include "WorkRequest.h"
 
 namespace SideCar {
 namespace Algorithms {
@@ -40,6 +44,10 @@ public:
     */
     MatchedFilter(Controller& controller, Logger::Log& log);
 
+    /** Destructor. Discards or waits for any FFT setup still being staged for us.
+     */
+    ~MatchedFilter();
+
     /** Implementation of the Algorithm::startup interface. Register runtime parameters and data processors.
 
         \return true if successful, false otherwise
@@ -128,7 +136,11 @@ private:
     */
     void rxFilterSpanChanged(const Parameter::IntValue& parameter);
 
-    void buildFFTs();
+    /** Capture the current fftSize and numFFTThreads values, and have ParameterStager build the FFT plans for
+        them. The processing thread adopts the result at the start of a later message. Before processing starts,
+        the plans are built before returning instead.
+    */
+    void stageFFTSetup();
 
     /** Determine if we need to restart our worker threads due to a parameter change. We only do so from within
         the process() method in order to prevent any race conditions while doing so. NOTE: this is a one-shot
@@ -222,8 +234,25 @@ private:
      */
     DomainParameter::Ref domain_;
 
-    boost::scoped_ptr<MatchedFilterUtils::FwdFFT> fwdFFT_;
-    boost::scoped_ptr<VsipComplexVector> txPulseVec_;
+    /** FFT plans used by the processing thread and the work requests. The forward plan also converts the
+        transmit pulse into the frequency domain.
+    */
+    Utils::Snapshot<MatchedFilterUtils::FFTSetup> fftSetup_;
+
+    /** FFT size and thread count of the setup in use, for the status report. The parameters may hold values
+        that are still being staged.
+    */
+    std::atomic<int> activeFFTSize_;
+    std::atomic<int> activeFFTThreads_;
+
+    /** Set once processChannels() has seen a message. Until then, stageFFTSetup() builds the FFT plans right away
+        so that the first messages use the configured fftSize and numFFTThreads instead of the defaults.
+    */
+    std::atomic<bool> processing_;
+
+    /** Conjugate of the transmit pulse spectrum, shared with the work requests.
+     */
+    FFTEngine::Buffer txPulse_;
 
     /** Worker thread pool generator.
      */
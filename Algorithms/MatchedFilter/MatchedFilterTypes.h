@@ -18,8 +18,6 @@ class WorkRequestQueue;
 
 using ComplexType = std::complex<float>;
 using VsipComplexVector = vsip::Vector<ComplexType>;
-using FwdFFT = vsip::Fft<vsip::Vector, ComplexType, ComplexType, vsip::fft_fwd>;
-using InvFFT = vsip::Fft<vsip::Vector, ComplexType, ComplexType, vsip::fft_inv>;
 
 } // namespace MatchedFilterUtils
 } // namespace Algorithms
@@ -1,13 +1,9 @@
-#include <fftw3.h>
+#include <algorithm>
 
 #include "Logger/Log.h"
 
 #include "WorkRequest.h"
 
-#include <vsip/domain.hpp>
-#include <vsip/math.hpp>
-#include <vsip/solvers.hpp>
-
 using namespace SideCar;
 using namespace SideCar::Algorithms;
 using namespace SideCar::Algorithms::MatchedFilterUtils;
@@ -25,8 +21,22 @@ WorkRequest::FromMessageBlock(ACE_Message_Block* data)
     return reinterpret_cast<WorkRequest*>(data->base());
 }
 
+FFTSetup::Ref
+FFTSetup::Make(int fftSize, int numFFTThreads)
+{
+    // All work requests share the same two plans, which FFTW allows as long as each uses its own buffer.
+    //
+    FFTSetup* setup = new FFTSetup;
+    setup->fftSize = fftSize;
+    setup->numFFTThreads = numFFTThreads;
+    FFTEngine& engine(FFTEngine::Instance());
+    setup->fwdFFT = engine.getPlan(fftSize, 1, FFTEngine::kForward, FFTEngine::kRows, true, numFFTThreads);
+    setup->invFFT = engine.getPlan(fftSize, 1, FFTEngine::kInverse, FFTEngine::kRows, true, numFFTThreads);
+    return Ref(setup);
+}
+
 ACE_Message_Block*
-WorkRequest::Make(VsipComplexVector* txPulseVec, int numFFTThreads, int fftSize)
+WorkRequest::Make(const FFTEngine::Buffer* txPulse, const FFTSetup::Ref& setup)
 {
     Logger::ProcLog log("Make", Log());
 
@@ -41,7 +51,7 @@ WorkRequest::Make(VsipComplexVector* txPulseVec, int numFFTThreads, int fftSize)
     // doing this, we must manually call the WorkRequest destructor when we are done with the WorkRequest object
     // or else we will leak memory. See the Destroy() class method.
     //
-    WorkRequest* tmp = new (data->base()) WorkRequest(txPulseVec, numFFTThreads, fftSize);
+    WorkRequest* tmp = new (data->base()) WorkRequest(txPulse, setup);
 
     return data;
 }
@@ -60,12 +70,12 @@ WorkRequest::Destroy(ACE_Message_Block* data)
     data->release();
 }
 
-WorkRequest::WorkRequest(VsipComplexVector* txPulseVec, int numFFTThreads, int fftSize) :
-    input_(), output_(), offset_(0), rxVec_(), fwdFFT_(), invFFT_()
+WorkRequest::WorkRequest(const FFTEngine::Buffer* txPulse, const FFTSetup::Ref& setup) :
+    input_(), output_(), offset_(0), rx_(), fwdFFT_(), invFFT_()
 {
     Logger::ProcLog log("WorkRequest", Log());
     LOGDEBUG << this << std::endl;
-    reconfigure(txPulseVec, numFFTThreads, fftSize);
+    reconfigure(txPulse, setup);
 }
 
 WorkRequest::~WorkRequest()
@@ -75,19 +85,14 @@ WorkRequest::~WorkRequest()
 }
 
 void
-WorkRequest::reconfigure(VsipComplexVector* txPulseVec, int numFFTThreads, int fftSize)
+WorkRequest::reconfigure(const FFTEngine::Buffer* txPulse, const FFTSetup::Ref& setup)
 {
-    txPulseVec_ = txPulseVec;
-    fftSize_ = fftSize;
-
-    rxVec_.reset(new VsipComplexVector(fftSize));
-
-    fftw_plan_with_nthreads(numFFTThreads);
-
-    fwdFFT_.reset(new FwdFFT(vsip::Domain<1>(fftSize), 1.0));
-    invFFT_.reset(new InvFFT(vsip::Domain<1>(fftSize), 1.0 / fftSize));
+    txPulse_ = txPulse;
+    fftSize_ = setup->fftSize;
 
-    fftw_plan_with_nthreads(1);
+    rx_.resize(fftSize_);
+    fwdFFT_ = setup->fwdFFT;
+    invFFT_ = setup->invFFT;
 
     input_.reset();
     output_.reset();
@@ -120,16 +125,20 @@ WorkRequest::process()
     while (inputPos < inputEnd) {
         float i = *inputPos++;
         float q = *inputPos++;
-        rxVec_->put(index++, ComplexType(i, q));
+        rx_[index++] = ComplexType(i, q);
     }
 
     // If necessary, pad the end with zeros.
     //
-    while (index < fftSize_) { rxVec_->put(index++, ComplexType(0.0, 0.0)); }
+    std::fill(rx_.data() + index, rx_.data() + fftSize_, ComplexType(0.0, 0.0));
 
-    // Filter the data in-place.
+    // Filter the data in-place. The inverse transform is not normalized, so fold that into the multiply.
     //
-    (*rxVec_) = (*invFFT_)((*txPulseVec_) * (*fwdFFT_)((*rxVec_)));
+    fwdFFT_->execute(rx_.data());
+    const ComplexType* txPulse = txPulse_->data();
+    const float scale = 1.0 / fftSize_;
+    for (index = 0; index < fftSize_; ++index) rx_[index] *= txPulse[index] * scale;
+    invFFT_->execute(rx_.data());
 
     // Replace the appropriate output message samples with the complex component values from the above filtering
     // operation.
@@ -141,8 +150,8 @@ WorkRequest::process()
 
     index = 0;
     while (outputPos < outputEnd) {
-        *outputPos++ = Messages::Video::DatumType(rxVec_->get(index).real());
-        *outputPos++ = Messages::Video::DatumType(rxVec_->get(index).imag());
+        *outputPos++ = Messages::Video::DatumType(rx_[index].real());
+        *outputPos++ = Messages::Video::DatumType(rx_[index].imag());
         ++index;
     }
 }
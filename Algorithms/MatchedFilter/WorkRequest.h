@@ -6,10 +6,8 @@
 
 #include "ace/Message_Block.h"
 #include "ace/Message_Queue_T.h"
-#include "boost/scoped_ptr.hpp"
-#include <vsip/matrix.hpp>
-#include <vsip/vector.hpp>
 
+#include "Algorithms/FFTEngine.h"
 #include "Messages/Video.h"
 
 #include "MatchedFilterTypes.h"
@@ -18,6 +16,28 @@ namespace SideCar {
 namespace Algorithms {
 namespace MatchedFilterUtils {
 
+/** FFT size and plans shared by all work requests. Built by ParameterStager off the processing thread whenever
+    the fftSize or numFFTThreads parameter changes, and adopted by the algorithm at the start of a message.
+*/
+struct FFTSetup {
+    using Ref = boost::shared_ptr<const FFTSetup>;
+
+    /** Fetch the plans for a transform size, waiting for FFTW to make them if they are new.
+
+        \param fftSize number of points in each transform
+
+        \param numFFTThreads number of threads FFTW may use for one transform
+
+        \return new setup
+    */
+    static Ref Make(int fftSize, int numFFTThreads);
+
+    int fftSize;
+    int numFFTThreads;
+    FFTEngine::Plan::Ref fwdFFT;
+    FFTEngine::Plan::Ref invFFT;
+};
+
 /** Collection of data values that will be used for a windowed SLC processing. Encapsulates the values that must
     not change while in use by a thread.
 */
@@ -37,7 +57,7 @@ public:
 
         \return
     */
-    static ACE_Message_Block* Make(VsipComplexVector* txPulseVec, int numFFTThreads, int fftSize);
+    static ACE_Message_Block* Make(const FFTEngine::Buffer* txPulse, const FFTSetup::Ref& setup);
 
     /** Dispose of the WorkRequest object held within an ACE_Message_Block, and release the ACE_Message_Block
         memory.
@@ -54,9 +74,9 @@ public:
     */
     static WorkRequest* FromMessageBlock(ACE_Message_Block* data);
 
-    /** Reconfigure the work request with new values. Reallocates some VSIPL objects.
+    /** Reconfigure the work request with new values. Takes its FFT plans from the given setup.
      */
-    void reconfigure(VsipComplexVector* txPulseVec, int numFFTThreads, int fftSize);
+    void reconfigure(const FFTEngine::Buffer* txPulse, const FFTSetup::Ref& setup);
 
     /** Initialize a new work request
 
@@ -77,21 +97,21 @@ public:
 private:
     /** Consturctor. Use the Make() factory method to create new WorkRequest objects.
      */
-    WorkRequest(VsipComplexVector* txPulseVec, int numFFTThreads, int fftSize);
+    WorkRequest(const FFTEngine::Buffer* txPulse, const FFTSetup::Ref& setup);
 
     /** Destructor. Here to keep someone from manually deleting a WorkRequest object; use the Destroy() class
         method instead.
     */
     ~WorkRequest();
 
-    VsipComplexVector* txPulseVec_;
+    const FFTEngine::Buffer* txPulse_;
     int fftSize_;
     Messages::Video::Ref input_;
     Messages::Video::Ref output_;
     size_t offset_;
-    boost::scoped_ptr<VsipComplexVector> rxVec_;
-    boost::scoped_ptr<FwdFFT> fwdFFT_;
-    boost::scoped_ptr<InvFFT> invFFT_;
+    FFTEngine::Buffer rx_;
+    FFTEngine::Plan::Ref fwdFFT_;
+    FFTEngine::Plan::Ref invFFT_;
 };
 
 } // namespace MatchedFilterUtils
@@ -1,11 +1,11 @@
 #include "PRISegmentation.h"
-#include "Messages/Segments.h"
 
 using namespace SideCar::Algorithms;
 using namespace SideCar::Messages;
 
 PRISegmentation::PRISegmentation(Controller& controller, Logger::Log& log) :
-    Algorithm(controller, log), threshold_(Parameter::IntValue::Make("threshold", "Threshold", 5000))
+    Algorithm(controller, log), threshold_(Parameter::IntValue::Make("threshold", "Threshold", 5000)), bits_(),
+    busy_(false)
 {
     ;
 }
@@ -14,6 +14,7 @@ bool
 PRISegmentation::startup()
 {
     registerProcessor<PRISegmentation, Messages::Video>(&PRISegmentation::process);
+    registerProcessor<PRISegmentation, Messages::BinaryVideo>(&PRISegmentation::processBinary);
     return registerParameter(threshold_) && Algorithm::startup();
 }
 
@@ -55,7 +56,24 @@ PRISegmentation::process(const Video::Ref& pri)
         out.merge(s);
     }
 
-    if (out.data().size()) {
+    return emit(output);
+}
+
+bool
+PRISegmentation::processBinary(const BinaryVideo::Ref& pri)
+{
+    SegmentMessage::Ref output(new SegmentMessage("PRISegmentation", pri, pri->getRangeMin(), pri->getRangeFactor()));
+    pri->getBits(bits_);
+    output->data()->merge(pri->getShaftEncoding(), bits_);
+    return emit(output);
+}
+
+bool
+PRISegmentation::emit(const SegmentMessage::Ref& output)
+{
+    // Only send empty messages at the end of a run of non-empty ones, so that downstream connectors see the break.
+    //
+    if (!output->data()->empty()) {
         busy_ = true;
         return send(output);
     } else if (busy_) {
@@ -2,7 +2,10 @@
 #define SIDECAR_ALGORITHMS_PRI_SEGMENTATION_H
 
 #include "Algorithms/Algorithm.h"
+#include "Messages/BinaryVideo.h"
+#include "Messages/Segments.h"
 #include "Messages/Video.h"
+#include "Utils/BitVector.h"
 
 namespace SideCar {
 namespace Algorithms {
@@ -16,6 +19,7 @@ namespace Algorithms {
 
    \par Input Messages:
    - Messages::Video to be thresholded
+   - Messages::BinaryVideo already thresholded; runs are found a word of gates at a time
 
    \par Output Messages:
    - Messages::SegmentMessage run-length encoding of the thresholded video
@@ -36,7 +40,12 @@ public:
 private:
     bool process(const Messages::Video::Ref& pri);
 
+    bool processBinary(const Messages::BinaryVideo::Ref& pri);
+
+    bool emit(const Messages::SegmentMessage::Ref& output);
+
     Parameter::IntValue::Ref threshold_;
+    Utils::BitVector bits_;
     bool busy_;
 };
 
@@ -0,0 +1,125 @@
+#include <exception>
+
+#include "Logger/Log.h"
+
+#include "ParameterStager.h"
+
+using namespace SideCar::Algorithms;
+
+/** Thread that runs the jobs of the stager.
+ */
+class ParameterStager::Worker : public Threading::Thread {
+public:
+    Worker(ParameterStager& stager) : Thread(), stager_(stager) {}
+
+private:
+    void run() override { stager_.run(); }
+
+    ParameterStager& stager_;
+};
+
+Logger::Log&
+ParameterStager::Log()
+{
+    static Logger::Log& log_ = Logger::Log::Find("SideCar.Algorithms.ParameterStager");
+    return log_;
+}
+
+ParameterStager&
+ParameterStager::Instance()
+{
+    // Never destroyed, since the thread may still be waiting for work when static objects go away at exit.
+    //
+    static ParameterStager* stager_ = new ParameterStager;
+    return *stager_;
+}
+
+ParameterStager::ParameterStager() :
+    condition_(Threading::Condition::Make()), jobs_(), running_(0), runCount_(0), replacedCount_(0), worker_()
+{
+    worker_.reset(new Worker(*this));
+    worker_->start();
+}
+
+void
+ParameterStager::submit(const void* owner, const Job& job)
+{
+    Threading::Locker lock(condition_);
+    for (auto& entry : jobs_) {
+        if (entry.owner == owner) {
+            entry.job = job;
+            ++replacedCount_;
+            return;
+        }
+    }
+
+    Entry entry = {owner, job};
+    jobs_.push_back(entry);
+    condition_->broadcast();
+}
+
+void
+ParameterStager::cancel(const void* owner)
+{
+    Threading::Locker lock(condition_);
+    for (auto pos = jobs_.begin(); pos != jobs_.end();) {
+        if (pos->owner == owner) {
+            pos = jobs_.erase(pos);
+        } else {
+            ++pos;
+        }
+    }
+
+    while (running_ == owner) condition_->waitForSignal();
+}
+
+void
+ParameterStager::wait()
+{
+    Threading::Locker lock(condition_);
+    while (!jobs_.empty() || running_) condition_->waitForSignal();
+}
+
+size_t
+ParameterStager::getRunCount() const
+{
+    Threading::Locker lock(condition_);
+    return runCount_;
+}
+
+size_t
+ParameterStager::getReplacedCount() const
+{
+    Threading::Locker lock(condition_);
+    return replacedCount_;
+}
+
+void
+ParameterStager::run()
+{
+    Logger::ProcLog log("run", Log());
+    Threading::Locker lock(condition_);
+    while (true) {
+        while (jobs_.empty()) condition_->waitForSignal();
+
+        Entry entry(jobs_.front());
+        jobs_.pop_front();
+        running_ = entry.owner;
+
+        // Run the job without the lock so that submissions never wait on a rebuild.
+        //
+        condition_->mutex()->unlock();
+        try {
+            entry.job();
+        } catch (const std::exception& ex) {
+            LOGERROR << "job for " << entry.owner << " failed - " << ex.what() << std::endl;
+        } catch (...) {
+            LOGERROR << "job for " << entry.owner << " failed" << std::endl;
+        }
+
+        condition_->mutex()->lock();
+        running_ = 0;
+        ++runCount_;
+        condition_->broadcast();
+    }
+}
@@ -0,0 +1,100 @@
+#ifndef SIDECAR_ALGORITHMS_PARAMETERSTAGER_H // -*- C++ -*-
+#define SIDECAR_ALGORITHMS_PARAMETERSTAGER_H
+
+#include <deque>
+#include <functional>
+
+#include "boost/scoped_ptr.hpp"
+
+#include "Threading/Threading.h"
+
+namespace Logger {
+class Log;
+}
+
+namespace SideCar {
+namespace Algorithms {
+
+/** Process-wide background thread that prepares the state an algorithm derives from its runtime parameters.
+    Parameter changes arrive on an algorithm's processing thread between messages, so rebuilding expensive state
+    (FFT plans, filter banks, lookup tables) in a change handler stalls the whole stream. Instead, the handler
+    captures the new parameter values in a job and submits it here. The job builds the new state and publishes it
+    through a Utils::Snapshot, which the processing thread adopts at the start of a later message.
+
+    Jobs run one at a time in the order submitted, so the jobs of one owner never publish concurrently. A job
+    submitted while an earlier one of the same owner is still waiting replaces it, so sweeping a parameter through
+    many values costs at most two rebuilds.
+*/
+class ParameterStager {
+public:
+    using Job = std::function<void()>;
+
+    static Logger::Log& Log();
+
+    /** Obtain the stager for the process, starting its thread on first use.
+
+        \return stager reference
+    */
+    static ParameterStager& Instance();
+
+    /** Schedule a job, replacing any job of the same owner that has not started yet.
+
+        \param owner object the job works for, usually the algorithm
+
+        \param job work to do
+    */
+    void submit(const void* owner, const Job& job);
+
+    /** Discard any waiting jobs of an owner, and wait for its running job to finish. Call before destroying
+        anything the jobs refer to.
+
+        \param owner object given to submit()
+    */
+    void cancel(const void* owner);
+
+    /** Wait until all jobs submitted so far have finished.
+     */
+    void wait();
+
+    /** Obtain the number of jobs run so far.
+
+        \return job count
+    */
+    size_t getRunCount() const;
+
+    /** Obtain the number of jobs replaced by later ones before they ran.
+
+        \return job count
+    */
+    size_t getReplacedCount() const;
+
+private:
+    struct Entry {
+        const void* owner;
+        Job job;
+    };
+
+    class Worker;
+
+    ParameterStager();
+
+    ParameterStager(const ParameterStager&);
+    ParameterStager& operator=(const ParameterStager&);
+
+    void run();
+
+    Threading::Condition::Ref condition_;
+    std::deque<Entry> jobs_;
+    const void* running_;
+    size_t runCount_;
+    size_t replacedCount_;
+    boost::scoped_ptr<Worker> worker_;
+};
+
+} // end namespace Algorithms
+} // end namespace SideCar
+
+/** \file
+ */
+
+#endif
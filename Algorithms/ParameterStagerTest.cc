@@ -0,0 +1,68 @@
+#include <stdexcept>
+
+#include "UnitTest/UnitTest.h"
+
+#include "ParameterStager.h"
+
+using namespace SideCar::Algorithms;
+
+struct Test : public UnitTest::TestObj {
+    Test() : TestObj("ParameterStager") {}
+
+    void test();
+};
+
+void
+Test::test()
+{
+    ParameterStager& stager(ParameterStager::Instance());
+    Threading::Condition::Ref gate(Threading::Condition::Make());
+    bool open = false;
+    int blocked = 0, first = 0, second = 0, other = 0;
+
+    // Hold the thread in a job so that the following submissions queue up behind it.
+    //
+    stager.submit(&gate, [&]() {
+        Threading::Locker lock(gate);
+        while (!open) gate->waitForSignal();
+        ++blocked;
+    });
+
+    // A job waiting for the thread is replaced by a later one for the same owner, but not by one for another.
+    //
+    size_t replaced = stager.getReplacedCount();
+    stager.submit(&first, [&]() { first = 1; });
+    stager.submit(&other, [&]() { ++other; });
+    stager.submit(&first, [&]() { first = 2; });
+    stager.submit(&second, [&]() { ++second; });
+    assertEqual(replaced + 1, stager.getReplacedCount());
+
+    // Cancelled jobs never run.
+    //
+    stager.cancel(&second);
+
+    {
+        Threading::Locker lock(gate);
+        open = true;
+        gate->signal();
+    }
+
+    stager.wait();
+    assertEqual(1, blocked);
+    assertEqual(2, first);
+    assertEqual(1, other);
+    assertEqual(0, second);
+
+    // A failing job does not stop the thread.
+    //
+    stager.submit(&first, []() { throw std::runtime_error("oops"); });
+    stager.submit(&other, [&]() { ++other; });
+    stager.wait();
+    assertEqual(2, other);
+}
+
+int
+main(int, const char**)
+{
+    return Test().mainRun();
+}
@@ -7,7 +7,11 @@ void
 ProcessingStat::reset()
 {
     orderedStats_.clear();
+    queueWaitLatency_.reset();
+    processingLatency_.reset();
+    sendLatency_.reset();
     beginProcessing_ = Time::TimeStamp::Max();
+    beginSend_ = Time::TimeStamp::Max();
 }
 
 void
@@ -19,3 +23,14 @@ ProcessingStat::endProcessing()
         addSample(delta);
     }
 }
+
+void
+ProcessingStat::endSend()
+{
+    if (beginSend_ != Time::TimeStamp::Max()) {
+        Time::TimeStamp delta = Time::TimeStamp::Now();
+        delta -= beginSend_;
+        sendLatency_.addSeconds(delta.asDouble());
+        beginSend_ = Time::TimeStamp::Max();
+    }
+}
@@ -4,6 +4,7 @@
 #include <vector>
 
 #include "Time/TimeStamp.h"
+#include "Utils/LatencyHistogram.h"
 #include "Utils/RunningMedian.h"
 
 namespace SideCar {
@@ -12,6 +13,11 @@ namespace Algorithms {
 /** Processing statistic for an Algorithm. Records amount of time spent in algorithm-specific code, from the
     time just before entering its message displatch routines, to when it outputs a message. Maintains a vector
     of the last 1000 processing times, and returns their average.
+
+    In addition, keeps Utils::LatencyHistogram distributions for three phases of message handling: time spent
+    waiting in the controller's input queue, time spent in the algorithm, and time spent handing an output
+    message to downstream tasks. Unlike the running median, these histograms cover every sample since the last
+    reset() so they can report tail latencies.
 */
 class ProcessingStat {
 public:
@@ -31,7 +37,25 @@ public:
      */
     void endProcessing();
 
-    void addSample(const Time::TimeStamp& delta) { orderedStats_.addValue(delta.asDouble()); }
+    void addSample(const Time::TimeStamp& delta)
+    {
+        orderedStats_.addValue(delta.asDouble());
+        processingLatency_.addSeconds(delta.asDouble());
+    }
+
+    /** Record the amount of time a message waited in the input queue before processing began.
+
+        \param delta queue wait duration
+    */
+    void addQueueWaitSample(const Time::TimeStamp& delta) { queueWaitLatency_.addSeconds(delta.asDouble()); }
+
+    /** Remember the current time for calculating send times
+     */
+    void beginSend() { beginSend_ = Time::TimeStamp::Now(); }
+
+    /** Calculate amount of time spent sending a message downstream and add to the send histogram.
+     */
+    void endSend();
 
     /** Obtain the current average processing time.
 
@@ -45,9 +69,19 @@ public:
 
     double getMaximumProcessingTime() const { return orderedStats_.getMaximumValue(); }
 
+    const ::Utils::LatencyHistogram& getQueueWaitLatency() const { return queueWaitLatency_; }
+
+    const ::Utils::LatencyHistogram& getProcessingLatency() const { return processingLatency_; }
+
+    const ::Utils::LatencyHistogram& getSendLatency() const { return sendLatency_; }
+
 private:
     ::Utils::RunningMedian orderedStats_;
+    ::Utils::LatencyHistogram queueWaitLatency_;
+    ::Utils::LatencyHistogram processingLatency_;
+    ::Utils::LatencyHistogram sendLatency_;
     Time::TimeStamp beginProcessing_;
+    Time::TimeStamp beginSend_;
 };
 
 } // end namespace Algorithms
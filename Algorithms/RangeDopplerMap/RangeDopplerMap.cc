@@ -16,8 +16,10 @@ using namespace SideCar::Algorithms;
 // in the startup() method. NOTE: it is WRONG to call any virtual functions here...
 //
 RangeDopplerMap::RangeDopplerMap(Controller& controller, Logger::Log& log) :
-    Super(controller, log, kDefaultEnabled, kDefaultCpiSpan), CPI_(), fft_output_(), HammingWindow_(), hamming_(),
-    maxSpan_(1000)
+    Super(controller, log, kDefaultEnabled, kDefaultCpiSpan),
+    fftThreads_(
+        Parameter::PositiveIntValue::Make("fftThreads", "Number of FFT threads per CPI", kDefaultFftThreads)),
+    cpi_(), fft_(), hamming_(), maxSpan_(1000)
 {
     cpiSpan_->connectChangedSignalTo(boost::bind(&RangeDopplerMap::cpiSpanChanged, this, _1));
 }
@@ -29,28 +31,17 @@ RangeDopplerMap::RangeDopplerMap(Controller& controller, Logger::Log& log) :
 bool
 RangeDopplerMap::startup()
 {
-    bool ok = true;
-    std::stringstream converter;
-
-    int cpiSpan = cpiSpan_->getValue();
-
-    // Set the buffers to default sizes
-    //
-    CPI_.reset(new VsipComplexMatrix(cpiSpan, maxSpan_));
-    fft_output_.reset(new VsipComplexMatrix(cpiSpan, maxSpan_));
-    HammingWindow_.reset(new VsipComplexMatrix(cpiSpan, 1));
-
-    float hamming;
+    makeHammingWindow(cpiSpan_->getValue());
+    return registerParameter(fftThreads_) && Super::startup();
+}
 
-    // populate the Hamming window with the correct values
-    //
+void
+RangeDopplerMap::makeHammingWindow(int cpiSpan)
+{
+    hamming_.clear();
     for (int i = 0; i < cpiSpan; i++) {
-        hamming = 0.53836 - 0.46164 * cos(2.0 * 3.141592 * (double(i) / (cpiSpan - 1)));
-        (*HammingWindow_)(i, 0) = ComplexType(hamming, 0.0);
-        hamming_.push_back(hamming);
+        hamming_.push_back(0.53836 - 0.46164 * cos(2.0 * 3.141592 * (double(i) / (cpiSpan - 1))));
     }
-
-    return ok && Super::startup();
 }
 
 // This routine is responsible for taking a set of PRIs and performing the appropriate FFT on the set.
@@ -62,7 +53,6 @@ RangeDopplerMap::processCPI()
     LOGINFO << std::endl;
     LOGDEBUG << "Process CPI with " << buffer_.size() << " msgs" << std::endl;
 
-    int last_row = -1;
     int limit, row = 0;
 
     float hamming;
@@ -83,11 +73,28 @@ RangeDopplerMap::processCPI()
     //
     if (max_msg_size > maxSpan_) { resize(max_msg_size); }
 
-    VsipComplexVector fft_buffer_(cpiSpan);
+    // The plan is shared with any other algorithm transforming CPIs of the same shape, and is only built the
+    // first time the process sees that shape.
+    //
+    cpi_.resize(cpiSpan * maxSpan_);
+    size_t threads = fftThreads_->getValue();
+    if (!fft_ || fft_->getSize() != cpiSpan || fft_->getCount() != maxSpan_ || fft_->getThreadCount() != threads) {
+        fft_ = FFTEngine::Instance().getPlan(cpiSpan, maxSpan_, FFTEngine::kForward, FFTEngine::kColumns, true,
+                                             threads);
+        if (!fft_) {
+            LOGERROR << "failed to obtain FFT plan for " << cpiSpan << " x " << maxSpan_ << std::endl;
+            return true;
+        }
+    }
+
+    // Rows for PRIs that were dropped remain zero.
+    //
+    std::fill(cpi_.data(), cpi_.data() + cpi_.size(), ComplexType(0.0, 0.0));
 
     size_t cnt;
-    size_t invalid = 0;
+    size_t invalid = cpiSpan;
     size_t startingSequenceNumber_ = buffer_[0]->getRIUInfo().sequenceCounter;
+
     // Add the PRI values composing this CPI to the appropriate buffer for performing FFTs across the PRI range
     // bins (ie, the columns of a matrix.
     //
@@ -98,34 +105,22 @@ RangeDopplerMap::processCPI()
 
         row = seqNum - startingSequenceNumber_;
         LOGDEBUG << "Add msg: " << seqNum << " to row: " << row << " in cpi buffer"
-                 << " starting @ msg: " << startingSequenceNumber_ << " last_row = " << last_row << std::endl;
-        // pad any rows whose PRIs were dropped
-        //
-        for (int row_index = last_row + 1; row_index < row; row_index++) {
-            LOGDEBUG << "Padding CPI(" << row_index << ") with zeroes" << std::endl;
-            invalid++;
-            for (size_t index = 0; index < maxSpan_; index++) {
-                CPI_->row(row_index).put(index, ComplexType(0.0, 0.0));
-            }
-        }
+                 << " starting @ msg: " << startingSequenceNumber_ << std::endl;
+        if (row < 0 || size_t(row) >= cpiSpan) continue;
+        --invalid;
 
-        limit = ref->size() / 2;
+        limit = std::min(ref->size() / 2, maxSpan_);
         hamming = hamming_[row];
 
         // populate the row with the PRI's samples
+        ComplexType* samples = cpi_.data() + row * maxSpan_;
         for (int index = 0; index < limit; ++index)
-            CPI_->row(row).put(index, hamming * ComplexType(ref[2 * index], ref[2 * index + 1]));
-        // if need be, pad the row with zeros
-        for (size_t index = limit; index < maxSpan_; index++) CPI_->row(row).put(index, ComplexType(0.0, 0.0));
-
-        last_row = row++;
+            samples[index] = hamming * ComplexType(ref[2 * index], ref[2 * index + 1]);
     }
 
     // need to apply fft on data matrix, not on a per row basis
-    ForwardFFTM fftm_(vsip::Domain<2>(cpiSpan, maxSpan_), 1.0);
+    fft_->execute(cpi_.data());
     float scale = 1.0 / (cpiSpan - invalid);
-    fftm_(*CPI_, *fft_output_);
-    (*fft_output_) *= scale;
 
     bool rc = true;
     // For each received message of CPI, create an output message, and send the fft results for that particular
@@ -139,19 +134,18 @@ RangeDopplerMap::processCPI()
         // compute appropriate index into fft output buffer
         Messages::Video::Ref ref = boost::dynamic_pointer_cast<Messages::Video>(*itr);
         row = ref->getRIUInfo().sequenceCounter - startingSequenceNumber_;
+        if (row < 0 || size_t(row) >= cpiSpan) continue;
 
         Messages::Video::Ref out(Messages::Video::Make(getName(), ref));
         Messages::Video::Container& outputData(out->getData());
 
-        // Convert from IQ to magnitude values
-        //
-        (*fft_output_).row(row) = vsip::sqrt(vsip::magsq((*fft_output_).row(row)));
-
-        // Output messages have a number of samples equal to the maximum number of samples in a PRI from this
-        // CPI. Once a better CPI tracking mechanism is in place, this is irrelevant.
+        // Convert from IQ to magnitude values. Output messages have a number of samples equal to the maximum
+        // number of samples in a PRI from this CPI. Once a better CPI tracking mechanism is in place, this is
+        // irrelevant.
         //
+        const ComplexType* bins = cpi_.data() + row * maxSpan_;
         for (size_t i = 0; i < len; i++) {
-            outputData.push_back(Messages::Video::DatumType(::rint((*fft_output_)(row, i).real())));
+            outputData.push_back(Messages::Video::DatumType(::rint(std::abs(bins[i]) * scale)));
         }
 
         rc &= send(out);
@@ -167,8 +161,6 @@ RangeDopplerMap::resize(int max)
     LOGERROR << "Resizing from " << maxSpan_ << " to new size: " << max << std::endl;
 
     maxSpan_ = max;
-    CPI_.reset(new VsipComplexMatrix(cpiSpan_->getValue(), maxSpan_));
-    fft_output_.reset(new VsipComplexMatrix(cpiSpan_->getValue(), maxSpan_));
 
     return true;
 }
@@ -176,19 +168,7 @@ RangeDopplerMap::resize(int max)
 bool
 RangeDopplerMap::cpiSpanChanged(const Parameter::PositiveIntValue& parameter)
 {
-    int cpiSpan = parameter.getValue();
-    HammingWindow_.reset(new VsipComplexMatrix(cpiSpan, 1));
-    CPI_.reset(new VsipComplexMatrix(cpiSpan, maxSpan_));
-    fft_output_.reset(new VsipComplexMatrix(cpiSpan, maxSpan_));
-    // populate the Hamming window with the correct values
-    float hamming;
-
-    for (int i = 0; i < cpiSpan; i++) {
-        hamming = 0.53836 - 0.46164 * cos(2.0 * 3.141592 * (double(i) / (cpiSpan - 1)));
-        (*HammingWindow_)(i, 0) = ComplexType(hamming, 0.0);
-        hamming_.push_back(hamming);
-    }
-
+    makeHammingWindow(parameter.getValue());
     return true;
 }
 
@@ -4,15 +4,8 @@
 #include <deque>
 #include <vector>
 
-#include "boost/scoped_ptr.hpp"
-
-#include <vsip/math.hpp>
-#include <vsip/matrix.hpp>
-#include <vsip/signal.hpp>
-#include <vsip/support.hpp>
-#include <vsip/vector.hpp>
-
 #include "Algorithms/CPIAlgorithm.h"
+#include "Algorithms/FFTEngine.h"
 #include "Messages/Video.h"
 #include "Parameter/Parameter.h"
 
@@ -26,10 +19,7 @@ namespace Algorithms {
 class RangeDopplerMap : public CPIAlgorithm {
 public:
     using Super = CPIAlgorithm;
-    using ComplexType = std::complex<float>;
-    using VsipComplexVector = vsip::Vector<ComplexType>;
-    using VsipComplexMatrix = vsip::Matrix<ComplexType>;
-    using ForwardFFTM = vsip::Fftm<ComplexType, ComplexType, vsip::col, vsip::fft_fwd, vsip::by_reference>;
+    using ComplexType = FFTEngine::Complex;
 
     /** Constructor.
 
@@ -50,11 +40,23 @@ private:
     bool processCPI();
     bool resize(int);
 
-    // Add attributes here
-    //
-    boost::scoped_ptr<VsipComplexMatrix> CPI_;
-    boost::scoped_ptr<VsipComplexMatrix> fft_output_;
-    boost::scoped_ptr<VsipComplexMatrix> HammingWindow_;
+    /** Recalculate the Hamming weights applied to the PRIs of a CPI.
+
+        \param cpiSpan number of PRIs in a CPI
+    */
+    void makeHammingWindow(int cpiSpan);
+
+    /** Run-time parameter for the number of threads FFTW may use to transform a CPI.
+     */
+    Parameter::PositiveIntValue::Ref fftThreads_;
+
+    /** CPI samples, one row per PRI, transformed in-place down the columns.
+     */
+    FFTEngine::Buffer cpi_;
+
+    /** Shared plan for the column transforms of a CPI, from FFTEngine.
+     */
+    FFTEngine::Plan::Ref fft_;
 
     std::vector<float> hamming_;
 
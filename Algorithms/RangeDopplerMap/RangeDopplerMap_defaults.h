@@ -1,2 +1,3 @@
 static const int kDefaultCpiSpan = 10;
 static const bool kDefaultEnabled = 1;
+static const int kDefaultFftThreads = 1;
@@ -58,23 +58,23 @@ ScanCorrelator::process(const Messages::Extractions::Ref& msg)
 
     Messages::Extractions::Ref result = Messages::Extractions::Make("ScanCorrelator", msg);
 
-    Extractions::iterator index;
-    Extractions::const_iterator stop = msg->end();
+    columns_.assign(*msg);
     time_t time = msg->getCreatedTimeStamp().getSeconds();
 
-    for (index = msg->begin(); index != stop; index++) {
-        corr(*index, time);
+    ExtractionColumns::IndexVector selected;
+    for (size_t index = 0; index < columns_.size(); ++index) {
+        corr(index, time);
 
 #ifdef SCAN_CORR_DEBUG
-        cerr << "correlated? " << index->getCorrelated() << " at " << index->getX() << ", " << index->getY() << endl;
+        cerr << "correlated? " << columns_.getCorrelated(index) << " at " << columns_.getX(index) << ", "
+             << columns_.getY(index) << endl;
 #endif
 
-        if (index->getCorrelated() && (index->getNumCorrelations() >= num_scans)) result->push_back(*index);
-
-        //        if(index->getCorrelations()>0)
-        //            result->push_back(*index);
+        if (columns_.getCorrelated(index) && (columns_.getNumCorrelations(index) >= num_scans))
+            selected.push_back(index);
     }
 
+    columns_.fill(*result, selected);
     return send(result);
 }
 
@@ -96,95 +96,76 @@ ScanCorrelator::init()
 }
 
 void
-ScanCorrelator::corrCell(Data& d, Entry& candidates)
+ScanCorrelator::Cell::discardBefore(time_t limit)
 {
-    static Logger::ProcLog log("corrCell", getLog());
-    Extraction& ext = d.extraction;
-
-#ifdef SCAN_CORR_DEBUG
-    cerr << "Cell count: " << candidates.size() << endl;
-#endif
-
-    Entry::iterator ci;
-    Entry::const_iterator stop = candidates.end();
-
-    for (ci = candidates.begin(); ci != stop;) {
-        time_t deltat = d.time - ci->time;
-
-        // Ignore/discard old entries
-        if (deltat > t_old) {
-#ifdef SCAN_CORR_DEBUG
-            cerr << "too old." << endl;
-#endif
+    size_t kept = 0;
+    for (size_t index = 0; index < size(); ++index) {
+        if (time[index] < limit) continue;
+        time[kept] = time[index];
+        x[kept] = x[index];
+        y[kept] = y[index];
+        numCorrelations[kept] = numCorrelations[index];
+        ++kept;
+    }
 
-            if (deltat > t_veryold) {
-#ifdef SCAN_CORR_DEBUG
-                cerr << "very old, erase." << endl;
-#endif
+    time.resize(kept);
+    x.resize(kept);
+    y.resize(kept);
+    numCorrelations.resize(kept);
+}
 
-                ci = candidates.erase(ci);
-            } else {
-                ci++;
-            }
-            continue;
-        }
+void
+ScanCorrelator::corrCell(size_t index, time_t time, Cell& candidates)
+{
+    // Discard entries that are too old to ever correlate again.
+    //
+    candidates.discardBefore(time - t_veryold);
 
-        // Ignore new entries
-        if (deltat < t_new) {
 #ifdef SCAN_CORR_DEBUG
-            cerr << "too new." << endl;
+    cerr << "Cell count: " << candidates.size() << endl;
 #endif
 
-            ci++;
-            continue;
-        }
-
-        const Extraction& other = ci->extraction;
-        // Verify the exact cartesian distance
-        float dx = ext.getX() - other.getX();
-        float dy = ext.getY() - other.getY();
-
-        float dist2 = dx * dx + dy * dy;
-#ifdef SCAN_CORR_DEBUG
-        cerr << "too far? ";
-#endif
+    // Locate the first entry that is neither too old nor too new and that lies within the search radius. The loop
+    // runs backwards over every entry without an early exit so that the compiler can vectorize it.
+    //
+    double x = columns_.getX(index);
+    double y = columns_.getY(index);
+    const time_t* times = candidates.time.data();
+    const double* xs = candidates.x.data();
+    const double* ys = candidates.y.data();
+    size_t count = candidates.size();
+    size_t found = count;
+    for (size_t pos = count; pos-- > 0;) {
+        time_t deltat = time - times[pos];
+        float dx = x - xs[pos];
+        float dy = y - ys[pos];
+        bool match = deltat >= t_new && deltat <= t_old && dx * dx + dy * dy < searchRadius2;
+        found = match ? pos : found;
+    }
 
-        if (dist2 < searchRadius2) {
-#ifdef SCAN_CORR_DEBUG
-            cerr << "no.  correlating." << endl;
-#endif
+    if (found == count) return;
 
-            // ext.correlate(other, sqrt(dist2));
-            ext.setCorrelated(true);
-            int num_scans = other.getNumCorrelations();
-            num_scans++;
-            ext.setNumCorrelations(num_scans);
-            return;
-        } else {
 #ifdef SCAN_CORR_DEBUG
-            cerr << "yes." << endl;
+    cerr << "correlating with " << xs[found] << ", " << ys[found] << endl;
 #endif
-        }
 
-        ci++;
-    }
+    columns_.setCorrelated(index, true);
+    columns_.setNumCorrelations(index, candidates.numCorrelations[found] + 1);
 }
 
 void
-ScanCorrelator::corr(Extraction& ext, time_t time)
+ScanCorrelator::corr(size_t index, time_t time)
 {
     // Determine which bin this extraction belongs to
     // (add +1) to shift the logical data buffer within the larger buffer
-    int binX = int(floor(ext.getX() / searchRadius)) + indexOffset + 1;
-    int binY = int(floor(ext.getY() / searchRadius)) + indexOffset + 1;
-
-    ext.setCorrelated(false);
+    int binX = int(floor(columns_.getX(index) / searchRadius)) + indexOffset + 1;
+    int binY = int(floor(columns_.getY(index) / searchRadius)) + indexOffset + 1;
 
-    Data d = {time, ext};
+    columns_.setCorrelated(index, false);
 
 #ifdef SCAN_CORR_DEBUG
-    cerr << "Correlating extraction (" << ext.getX() << ", " << ext.getY() << ") into [" << binX << ", " << binY
-         << "] numBins=" << numBins << endl;
+    cerr << "Correlating extraction (" << columns_.getX(index) << ", " << columns_.getY(index) << ") into [" << binX
+         << ", " << binY << "] numBins=" << numBins << endl;
 #endif
 
     if (((binX - 1) < 0) || ((binX + 1) >= numBins) || ((binY - 1) < 0) || ((binY + 1) >= numBins)) {
@@ -198,23 +179,20 @@ ScanCorrelator::corr(Extraction& ext, time_t time)
     // Perform the correlations
     // binX and binY are never = 0 or numBins - 1, so this code holds
     // for all possible cases
-    corrCell(d, buffer[binX - 1][binY - 1]);
-    corrCell(d, buffer[binX - 1][binY]);
-    corrCell(d, buffer[binX - 1][binY + 1]);
-    corrCell(d, buffer[binX][binY - 1]);
-    corrCell(d, buffer[binX + 1][binY - 1]);
-    corrCell(d, buffer[binX][binY]);
-    corrCell(d, buffer[binX][binY + 1]);
-    corrCell(d, buffer[binX + 1][binY]);
-    corrCell(d, buffer[binX + 1][binY + 1]);
-
-    if (!d.extraction.getCorrelated()) d.extraction.setNumCorrelations(0);
+    corrCell(index, time, buffer[binX - 1][binY - 1]);
+    corrCell(index, time, buffer[binX - 1][binY]);
+    corrCell(index, time, buffer[binX - 1][binY + 1]);
+    corrCell(index, time, buffer[binX][binY - 1]);
+    corrCell(index, time, buffer[binX + 1][binY - 1]);
+    corrCell(index, time, buffer[binX][binY]);
+    corrCell(index, time, buffer[binX][binY + 1]);
+    corrCell(index, time, buffer[binX + 1][binY]);
+    corrCell(index, time, buffer[binX + 1][binY + 1]);
+
+    if (!columns_.getCorrelated(index)) columns_.setNumCorrelations(index, 0);
 
     // Add to buffer
-    buffer[binX][binY].push_back(d);
-
-    // set the result
-    ext = d.extraction;
+    buffer[binX][binY].append(time, columns_.getX(index), columns_.getY(index), columns_.getNumCorrelations(index));
 }
 
 void
@@ -3,11 +3,11 @@
 
 #include "Algorithms/Algorithm.h"
 #include "Messages/Extraction.h"
+#include "Messages/ExtractionColumns.h"
 #include "Messages/Video.h"
 #include "Parameter/Parameter.h"
 
 #include <cmath>
-#include <list>
 #include <vector>
 
 namespace SideCar {
@@ -48,19 +48,36 @@ private:
     bool process(const Messages::Extractions::Ref& msg);
 
     using time_t = long;
-    using Extraction = SideCar::Messages::Extraction;
 
-    struct Data {
-        time_t time;
-        SideCar::Messages::Extraction extraction;
+    /** Prior extractions that fell within one grid cell, stored as parallel columns so that gating runs over
+        contiguous arrays.
+    */
+    struct Cell {
+        std::vector<time_t> time;
+        std::vector<double> x;
+        std::vector<double> y;
+        std::vector<int> numCorrelations;
+
+        size_t size() const { return time.size(); }
+
+        void append(time_t when, double px, double py, int count)
+        {
+            time.push_back(when);
+            x.push_back(px);
+            y.push_back(py);
+            numCorrelations.push_back(count);
+        }
+
+        void discardBefore(time_t limit);
     };
 
-    using Entry = std::list<Data>;
-    std::vector<std::vector<Entry>> buffer; // [x][y]
+    std::vector<std::vector<Cell>> buffer; // [x][y]
     size_t indexOffset;
 
-    void corrCell(Data&, Entry& candidates);
-    void corr(Extraction& ext, time_t t);
+    Messages::ExtractionColumns columns_;
+
+    void corrCell(size_t index, time_t time, Cell& candidates);
+    void corr(size_t index, time_t time);
 
     double rMax;
     size_t numBins;
@@ -1,4 +1,4 @@
-#include <algorithm>  // for std::transform
+#include <algorithm>  // for std::fill
 #include <functional> // for std::bind* and std::mem_fun*
 
 #include "Algorithms/Controller.h"
@@ -60,7 +60,7 @@ SectorMask::NormalizeBins(int& startRngBin, int& endRngBin, size_t msg_size)
 
     if (endRngBin < 0) endRngBin += msg_size;
 
-    if (startRngBin < endRngBin || startRngBin >= msg_size) {
+    if (startRngBin < 0 || endRngBin < startRngBin || endRngBin >= int(msg_size)) {
         LOGERROR << "Invalid minRangeBin (" << startRngBin << ") or maxRangeBin " << endRngBin
                  << ") values with message size: " << msg_size << std::endl;
         return false;
@@ -95,7 +95,7 @@ SectorMask::processInput(const Messages::BinaryVideo::Ref& msg)
 
         // Mask out any values in the given sector
         //
-        for (size_t i = startRngBin; i <= endRngBin; i++) { out[i] = false; }
+        std::fill(out->begin() + startRngBin, out->begin() + endRngBin + 1, false);
     }
 
     // Send out on the default output device, and return the result to our Controller. NOTE: for multichannel
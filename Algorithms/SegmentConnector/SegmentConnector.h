@@ -2,13 +2,15 @@
 #define SIDECAR_ALGORITHMS_SEGMENT_CONNECTOR_H
 
 #include "Algorithms/Algorithm.h"
+#include "Messages/SegmentLabeller.h"
 #include "Messages/Segments.h"
-#include "SegmentTree.h"
 
 namespace SideCar {
 namespace Algorithms {
 
-/** Takes a stream of PRISegments and outputs a stream of segments, each representing an extraction blob.
+/** Takes a stream of PRISegments and outputs a stream of segments, each representing an extraction blob. The
+    connected-component work is done by a Messages::SegmentLabeller, which only holds the previous PRI and the
+    blobs still open.
  */
 class SegmentConnector : public Algorithm {
 public:
@@ -20,8 +22,9 @@ public:
 private:
     bool process(Messages::SegmentMessage::Ref newPRI);
 
-    Messages::SegmentMessage::Ref oldPRI;
-    std::list<SegmentTree*>* oldTrees;
+    Messages::SegmentLabeller labeller_;
+    Messages::SegmentLabeller::BlobVector done_;
+    bool primed_;
     double rangeMin_;
     double rangeFactor_;
 };
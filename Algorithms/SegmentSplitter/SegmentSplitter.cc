@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include "SegmentSplitter.h"
 #include "Messages/MetaTypeInfo.h"
 #include "Messages/RadarConfig.h"
@@ -45,14 +47,14 @@ bool
 SegmentSplitter::processSegment(SegmentMessage::Ref pri)
 {
     // Read in the message
-    const std::list<Segment>& in = pri->data()->data();
+    const SegmentList::Container& in = pri->data()->data();
 
     // identify the peaks in this extraction a peak is the highest value in its 9-cell region
     //
-    std::list<Segment>::const_iterator seg;
-    std::list<Segment>::const_iterator stop = in.end();
+    SegmentList::const_iterator seg;
+    SegmentList::const_iterator stop = in.end();
     Peak peak;
-    std::list<Peak> peaks;
+    std::vector<Peak> peaks;
     for (seg = in.begin(); seg != stop; seg++) {
         size_t azimuth = seg->azimuth;
 
@@ -97,13 +99,12 @@ SegmentSplitter::processSegment(SegmentMessage::Ref pri)
 
     // Sort through the peaks, picking the highest peak "per object"
     //
-    std::list<Peak> extractions;
+    std::vector<Peak> extractions;
     while (peaks.size()) {
         // Find the highest peak
-        std::list<Peak>::iterator peak = peaks.begin();
-        std::list<Peak>::iterator max = peak; // start assuming the first peak is highest
-        std::list<Peak>::const_iterator stop = peaks.end();
-        for (peak++; peak != stop; peak++) // then check the other peaks
+        std::vector<Peak>::iterator peak = peaks.begin();
+        std::vector<Peak>::iterator max = peak; // start assuming the first peak is highest
+        for (peak++; peak != peaks.end(); peak++) // then check the other peaks
         {
             if ((peak->value > max->value) || ((peak->value == max->value) && (peak->sum > max->sum))) { max = peak; }
         }
@@ -114,25 +115,22 @@ SegmentSplitter::processSegment(SegmentMessage::Ref pri)
 
         // remove any peaks shadowed by max
         peaks.erase(max);
-        for (peak = peaks.begin(); peak != stop; /* increment in the loop */) {
-            int dRange = wAz * (summit.range - peak->range); // cross-multiply instead of dividing
-            int dAz = summit.azimuth - peak->azimuth;
+        auto shadowed = [&](const Peak& other) {
+            int dRange = wAz * (summit.range - other.range); // cross-multiply instead of dividing
+            int dAz = summit.azimuth - other.azimuth;
             if (dAz < -scan_2) dAz += scan;
             if (dAz > scan_2) dAz -= scan;
             dAz *= wRange;
+            return dRange * dRange + dAz * dAz < close2;
+        };
 
-            if (dRange * dRange + dAz * dAz < close2) {
-                peak = peaks.erase(peak);
-            } else {
-                peak++;
-            }
-        }
+        peaks.erase(std::remove_if(peaks.begin(), peaks.end(), shadowed), peaks.end());
     }
 
     // Create a new SegmentMessage for each extraction
     //
-    std::list<Peak>::const_iterator ext;
-    std::list<Peak>::const_iterator stopExt = extractions.end();
+    std::vector<Peak>::const_iterator ext;
+    std::vector<Peak>::const_iterator stopExt = extractions.end();
     Segment s;
     for (ext = extractions.begin(); ext != stopExt; ext++) {
         // create a SegmentMessage
@@ -69,8 +69,9 @@ SegmentStats::processSegmentMessage(SegmentMessage::Ref pri)
     }
 
     // The master loop
-    std::list<Segment>::const_iterator seg;
-    std::list<Segment>::const_iterator stop = in.data().end();
+    out.reserve(in.size());
+    SegmentList::const_iterator seg;
+    SegmentList::const_iterator stop = in.data().end();
     for (seg = in.data().begin(); seg != stop; seg++) {
         out.merge(*seg); // Add this segment to the output
 
@@ -68,20 +68,22 @@ SpreadMofN::processCPI()
 
     size_t msg_size = msg_buffer_[0]->size();
     Messages::BinaryVideo::Ref out(Messages::BinaryVideo::Make(getName(), msg_buffer_[0]));
-    Messages::BinaryVideo::Container& outputData(out->getData());
-    outputData.resize(msg_buffer_[0]->size(), 0);
 
-    // Count only Doppler bins in interval [2, cpiSpan - 1]
+    // Count only Doppler bins in interval [2, cpiSpan - 1]. The counters are bit-sliced, so each add updates 64
+    // gates at a time.
     //
+    Utils::BitCounter counts(msg_size, cpiSpan);
+    Utils::BitVector bits;
     for (size_t i = 2; i < cpiSpan - 1; i++) {
-        for (size_t j = 0; j < msg_size; j++) {
-            if (msg_buffer_[i][j]) { ++outputData[j]; }
-        }
+        msg_buffer_[i]->getBits(bits);
+        bits.resize(msg_size);
+        counts.add(bits);
     }
 
     // Check if enough hits were detected
     //
-    for (size_t i = 0; i < msg_size; i++) { outputData[i] = (outputData[i] >= M); }
+    counts.atLeast(M, bits);
+    out->setBits(bits);
 
     msg_buffer_.clear();
     bool rc = send(out);
@@ -56,18 +56,16 @@ TrackInitiator::process(const Messages::Extractions::Ref& msg)
 
     int num_scans = param_numScans->getValue();
 
-    Extractions::const_iterator pos = msg->begin();
-    Extractions::const_iterator end = msg->end();
+    columns_.assign(*msg);
+    for (size_t index = 0; index < columns_.size(); ++index) {
+        corr(index);
 
-    while (pos != end) {
-        Data d(*pos++);
-        corr(d);
+        LOGDEBUG << "correlated? " << columns_.getCorrelated(index) << " at " << columns_.getX(index) << ", "
+                 << columns_.getY(index) << std::endl;
 
-        Extraction& ext(d.extraction_);
-        LOGDEBUG << "correlated? " << ext.getCorrelated() << " at " << ext.getX() << ", " << ext.getY() << std::endl;
-
-        if (ext.getCorrelated() && ext.getNumCorrelations() >= num_scans - 1) {
-            LOGDEBUG << "extraction is correlated for " << (ext.getNumCorrelations() + 1) << " scans " << std::endl;
+        if (columns_.getCorrelated(index) && columns_.getNumCorrelations(index) >= num_scans - 1) {
+            LOGDEBUG << "extraction is correlated for " << (columns_.getNumCorrelations(index) + 1) << " scans "
+                     << std::endl;
 
             // Make new Track Message
             Messages::Track::Ref trk(Track::Make("TrackInitiator"));
@@ -85,8 +83,8 @@ TrackInitiator::process(const Messages::Extractions::Ref& msg)
             const GEO_LOCATION* origin = Messages::TSPI::GetOrigin();
 
             Track::Coord rae;
-            rae[GEO_AZ] = ext.getAzimuth();       // radians
-            rae[GEO_RNG] = ext.getRange() * 1000; // meters
+            rae[GEO_AZ] = columns_.getAzimuth(index);       // radians
+            rae[GEO_RNG] = columns_.getRange(index) * 1000; // meters
             rae[GEO_EL] = Utils::el_from_range_and_alt(rae[GEO_RNG], param_assumedAltitude->getValue(),
                                                        Utils::degreesToRadians(origin->lat));
 
@@ -100,14 +98,14 @@ TrackInitiator::process(const Messages::Extractions::Ref& msg)
                        &measurement[GEO_HGT]);
 
             trk->setEstimate(measurement);
-            double when = ext.getWhen().asDouble();
+            double when = columns_.getTime(index);
             trk->setWhen(when);
             trk->setExtractionTime(when);
 
             // Velocity estimate should be a simple point-to-point velocity between last two measurements in the
             // hypothesis convert enu velocity to llh velocity
             //
-            Track::Coord xyz_vel(d.velocity_[0] * 1000, d.velocity_[1] * 1000);
+            Track::Coord xyz_vel(velocity_[0] * 1000, velocity_[1] * 1000);
             Track::Coord rae_vel;
             geoXyz2Rae(xyz_vel.tuple_, rae_vel.tuple_);
 
@@ -159,70 +157,72 @@ TrackInitiator::init()
 }
 
 void
-TrackInitiator::corrCell(Data& d, Entry& candidates)
+TrackInitiator::Cell::discardBefore(double limit)
 {
-    static Logger::ProcLog log("corrCell", getLog());
-
-    Extraction& ext = d.extraction_;
+    size_t kept = 0;
+    for (size_t index = 0; index < size(); ++index) {
+        if (when[index] < limit) continue;
+        when[kept] = when[index];
+        x[kept] = x[index];
+        y[kept] = y[index];
+        numCorrelations[kept] = numCorrelations[index];
+        ++kept;
+    }
 
-    LOGDEBUG << "cell count: " << candidates.size() << endl;
+    when.resize(kept);
+    x.resize(kept);
+    y.resize(kept);
+    numCorrelations.resize(kept);
+}
 
-    Entry::iterator ci = candidates.begin();
-    Entry::iterator end = candidates.end();
-    while (ci != end) {
-        double delta = d.when_ - ci->when_;
-        if (delta > t_old_) {
-            LOGDEBUG << "too old. delta=" << delta << " threshold=" << t_old_ << endl;
-
-            if (delta > t_veryold_) {
-                LOGDEBUG << "very old, erase." << endl;
-                ci = candidates.erase(ci);
-            } else {
-                ++ci;
-            }
-            continue;
-        }
+void
+TrackInitiator::corrCell(size_t index, Cell& candidates)
+{
+    static Logger::ProcLog log("corrCell", getLog());
 
-        // Ignore new entries
-        //
-        if (delta < t_new_) {
-            LOGDEBUG << "too new." << endl;
-            ++ci;
-            continue;
-        }
+    // Discard entries that are too old to ever correlate again.
+    //
+    double when = columns_.getTime(index);
+    candidates.discardBefore(when - t_veryold_);
 
-        const Extraction& other = ci->extraction_;
+    LOGDEBUG << "cell count: " << candidates.size() << endl;
 
-        // Verify the exact cartesian distance
-        //
-        float dx = ext.getX() - other.getX();
-        float dy = ext.getY() - other.getY();
-        float dist2 = dx * dx + dy * dy;
-        LOGDEBUG << "too far? ";
+    // Locate the first entry that is neither too old nor too new and that lies within the search radius. The loop
+    // runs backwards over every entry without an early exit so that the compiler can vectorize it.
+    //
+    double x = columns_.getX(index);
+    double y = columns_.getY(index);
+    const double* whens = candidates.when.data();
+    const double* xs = candidates.x.data();
+    const double* ys = candidates.y.data();
+    size_t count = candidates.size();
+    size_t found = count;
+    for (size_t pos = count; pos-- > 0;) {
+        double delta = when - whens[pos];
+        float dx = x - xs[pos];
+        float dy = y - ys[pos];
+        bool match = delta >= t_new_ && delta <= t_old_ && dx * dx + dy * dy < searchRadius2_;
+        found = match ? pos : found;
+    }
 
-        if (dist2 < searchRadius2_) {
-            LOGDEBUG << "no.  correlating." << endl;
+    if (found == count) return;
 
-            ext.setCorrelated(true);
-            int num_scans = other.getNumCorrelations() + 1;
-            ext.setNumCorrelations(num_scans);
+    LOGDEBUG << "correlating with " << xs[found] << ", " << ys[found] << endl;
 
-            //
-            // Compute simple point-to-point velocity in enu coordinates
-            //
-            delta = ext.getWhen().asDouble() - other.getWhen().asDouble();
-            d.velocity_[0] = dx / delta;
-            d.velocity_[1] = dy / delta;
-            return;
-        }
+    columns_.setCorrelated(index, true);
+    columns_.setNumCorrelations(index, candidates.numCorrelations[found] + 1);
 
-        LOGDEBUG << "yes." << endl;
-        ++ci;
-    }
+    // Compute simple point-to-point velocity in enu coordinates
+    //
+    float dx = x - xs[found];
+    float dy = y - ys[found];
+    double delta = when - whens[found];
+    velocity_[0] = dx / delta;
+    velocity_[1] = dy / delta;
 }
 
 void
-TrackInitiator::corr(Data& d)
+TrackInitiator::corr(size_t index)
 {
     static Logger::ProcLog log("corr", getLog());
     LOGINFO << std::endl;
@@ -230,13 +230,16 @@ TrackInitiator::corr(Data& d)
     // Determine which bin this extraction belongs to (add +1) to shift the logical data buffer within the
     // larger buffer
     //
-    int binX = int(floor(d.extraction_.getX() / searchRadius_)) + indexOffset_ + 1;
-    int binY = int(floor(d.extraction_.getY() / searchRadius_)) + indexOffset_ + 1;
+    double x = columns_.getX(index);
+    double y = columns_.getY(index);
+    int binX = int(floor(x / searchRadius_)) + indexOffset_ + 1;
+    int binY = int(floor(y / searchRadius_)) + indexOffset_ + 1;
 
-    d.extraction_.setCorrelated(false);
+    columns_.setCorrelated(index, false);
+    velocity_ = Messages::Track::Coord();
 
-    LOGDEBUG << "Correlating extraction (" << d.extraction_.getX() << ", " << d.extraction_.getY() << ") into [" << binX
-             << ", " << binY << "] numBins=" << numBins_ << std::endl;
+    LOGDEBUG << "Correlating extraction (" << x << ", " << y << ") into [" << binX << ", " << binY
+             << "] numBins=" << numBins_ << std::endl;
 
     if (binX < 1 || binX >= numBins_ - 1 || binY < 1 || binY >= numBins_ - 1) {
         LOGERROR << "Bad bin #, bailing" << endl;
@@ -246,19 +249,19 @@ TrackInitiator::corr(Data& d)
     // Perform the correlations binX and binY are never = 0 or numBins - 1, so this code holds for all possible
     // cases
     //
-    corrCell(d, buffer_[binX - 1][binY - 1]);
-    corrCell(d, buffer_[binX - 1][binY]);
-    corrCell(d, buffer_[binX - 1][binY + 1]);
-    corrCell(d, buffer_[binX][binY - 1]);
-    corrCell(d, buffer_[binX + 1][binY - 1]);
-    corrCell(d, buffer_[binX][binY]);
-    corrCell(d, buffer_[binX][binY + 1]);
-    corrCell(d, buffer_[binX + 1][binY]);
-    corrCell(d, buffer_[binX + 1][binY + 1]);
-
-    if (!d.extraction_.getCorrelated()) d.extraction_.setNumCorrelations(0);
-
-    buffer_[binX][binY].push_back(d);
+    corrCell(index, buffer_[binX - 1][binY - 1]);
+    corrCell(index, buffer_[binX - 1][binY]);
+    corrCell(index, buffer_[binX - 1][binY + 1]);
+    corrCell(index, buffer_[binX][binY - 1]);
+    corrCell(index, buffer_[binX + 1][binY - 1]);
+    corrCell(index, buffer_[binX][binY]);
+    corrCell(index, buffer_[binX][binY + 1]);
+    corrCell(index, buffer_[binX + 1][binY]);
+    corrCell(index, buffer_[binX + 1][binY + 1]);
+
+    if (!columns_.getCorrelated(index)) columns_.setNumCorrelations(index, 0);
+
+    buffer_[binX][binY].append(columns_.getTime(index), x, y, columns_.getNumCorrelations(index));
 }
 
 void
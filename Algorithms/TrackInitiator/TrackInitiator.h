@@ -2,12 +2,12 @@
 #define SIDECAR_ALGORITHMS_TRACK_INITIATOR_H
 
 #include <cmath>
-#include <list>
 #include <time.h> // for time_t and friends
 #include <vector>
 
 #include "Algorithms/Algorithm.h"
 #include "Messages/Extraction.h"
+#include "Messages/ExtractionColumns.h"
 #include "Messages/Track.h"
 #include "Parameter/Parameter.h"
 
@@ -46,24 +46,36 @@ private:
     */
     bool process(const Messages::Extractions::Ref& msg);
 
-    using Extraction = SideCar::Messages::Extraction;
+    /** Prior extractions that fell within one grid cell, stored as parallel columns so that gating runs over
+        contiguous arrays.
+    */
+    struct Cell {
+        std::vector<double> when;
+        std::vector<double> x;
+        std::vector<double> y;
+        std::vector<int> numCorrelations;
+
+        size_t size() const { return when.size(); }
 
-    struct Data {
-        Data(const Messages::Extraction& extraction) :
-            when_(extraction.getWhen().asDouble()), extraction_(extraction), velocity_()
+        void append(double time, double px, double py, int count)
         {
+            when.push_back(time);
+            x.push_back(px);
+            y.push_back(py);
+            numCorrelations.push_back(count);
         }
-        double when_;
-        Messages::Extraction extraction_;
-        Messages::Track::Coord velocity_;
+
+        void discardBefore(double limit);
     };
 
-    using Entry = std::list<Data>;
-    std::vector<std::vector<Entry>> buffer_; // [x][y]
+    std::vector<std::vector<Cell>> buffer_; // [x][y]
     size_t indexOffset_;
 
-    void corrCell(Data&, Entry& candidates);
-    void corr(Data&);
+    Messages::ExtractionColumns columns_;
+    Messages::Track::Coord velocity_; // point-to-point velocity of the extraction being correlated
+
+    void corrCell(size_t index, Cell& candidates);
+    void corr(size_t index);
 
     double rMax_;
     size_t numBins_;
@@ -3,7 +3,6 @@
 #include "Logger/Log.h"
 #include "Messages/RadarConfig.h"
 #include "Messages/Video.h"
-#include "Utils/VsipVector.h"
 
 #include "VideoInterpolation.h"
 #include "VideoInterpolation_defaults.h"
@@ -14,7 +13,7 @@ using namespace SideCar::Messages;
 VideoInterpolation::VideoInterpolation(Controller& controller, Logger::Log& log) :
     Algorithm(controller, log), interpolationCount_(Parameter::PositiveIntValue::Make(
                                     "interpolationCount", "Interpolation Count", kDefaultInterpolationCount)),
-    past_(2)
+    tile_(2, 0), last_(), weights_(2, 0.0), blend_()
 {
     ;
 }
@@ -29,7 +28,8 @@ VideoInterpolation::startup()
 bool
 VideoInterpolation::reset()
 {
-    past_.clear();
+    tile_.clear();
+    last_.reset();
     return true;
 }
 
@@ -41,13 +41,16 @@ VideoInterpolation::process(const Messages::Video::Ref& in)
     const float kEncoded2PI = RadarConfig::GetShaftEncodingMax() + 1.0;
     const float kEncodedPI = kEncoded2PI / 2.0;
 
-    past_.add(in);
-    if (!past_.full()) { return send(in); }
+    if (!last_) {
+        tile_.add(in->getData().data(), in->size());
+        last_ = in;
+        return send(in);
+    }
 
     // Convention: i indexes the input shaft encoding, j indexes the output shaft encoding
     //
-    float iNew = past_[0]->getShaftEncoding();
-    float iOld = past_[1]->getShaftEncoding();
+    float iNew = in->getShaftEncoding();
+    float iOld = last_->getShaftEncoding();
     LOGDEBUG << "iNew: " << iNew << " iOld: " << iOld << std::endl;
 
     if (iNew < iOld) {
@@ -62,22 +65,19 @@ VideoInterpolation::process(const Messages::Video::Ref& in)
     //
     if (delta > kEncodedPI) {
         LOGERROR << "detected backward movement" << std::endl;
-        past_.add(past_[1]);
         return true;
     }
 
+    tile_.add(in->getData().data(), in->size());
+    last_ = in;
+
     int emitCount = interpolationCount_->getValue() + 1;
     delta /= emitCount;
 
     LOGDEBUG << "interpolation delta: " << delta << std::endl;
 
-    // VSIP bindings for the inputs
-    VsipVector<Video> vNew(*past_[0]);
-    VsipVector<Video> vOld(*past_[1]);
-    vNew.admit(true);
-    vOld.admit(true);
-
-    vsip::Vector<float> tmp(in->size(), 0.0);
+    size_t gateCount = in->size();
+    blend_.resize(tile_.getWidth());
 
     for (int index = 1; index <= emitCount; ++index) {
         float shaftEncoding = iOld + delta * index;
@@ -89,26 +89,24 @@ VideoInterpolation::process(const Messages::Video::Ref& in)
         LOGDEBUG << "shaftEncoding: " << shaftEncoding << std::endl;
 
         Video::Ref out(Video::Make(getName(), in));
-        out->resize(in->size(), 0);
+        out->resize(gateCount, 0);
         out->getRIUInfo().shaftEncoding = size_t(::rint(shaftEncoding));
 
-        VsipVector<Video> vOut(*out);
-        vOut.admit(false);
-
         float weight = float(index) / float(emitCount);
         LOGDEBUG << "index: " << index << " weight: " << weight << std::endl;
 
-        tmp = mul(vOld.v, 1.0 - weight);
-        tmp = ma(vNew.v, weight, tmp);
-        vOut.v = vsip::impl::view_cast<Video::DatumType>(tmp);
-        vOut.release(true);
+        // Row 0 of the tile is the new PRI and row 1 the old one.
+        //
+        weights_[0] = weight;
+        weights_[1] = 1.0 - weight;
+        tile_.convolve(weights_, 0, blend_.data());
+
+        Video::DatumType* ptr = out->getData().data();
+        for (size_t gate = 0; gate < gateCount; ++gate) ptr[gate] = Video::DatumType(blend_[gate]);
 
         if (!send(out)) return false;
     }
 
-    vNew.release(false);
-    vOld.release(false);
-
     LOGDEBUG << "done" << std::endl;
 
     return true;
@@ -7,8 +7,10 @@
    use an FIR to estimate the mean values, use another to estimate the variance / standard deviation
 */
 
+#include <vector>
+
 #include "Algorithms/Algorithm.h"
-#include "Algorithms/PastBuffer.h"
+#include "Algorithms/VideoTile.h"
 #include "Messages/Video.h"
 #include "Parameter/Parameter.h"
 
@@ -21,7 +23,7 @@ namespace Algorithms {
 
    \par Pseudocode:
    - keep the two most recent input messages
-   - create any output messages which lie between them
+   - create any output messages which lie between them, each a weighted sum of the two
 
    \par Input Messages:
    - Messages::Video source data
@@ -58,7 +60,12 @@ private:
     //
     Parameter::PositiveIntValue::Ref interpolationCount_;
 
-    PastBuffer<Messages::Video> past_;
+    // The last two PRIs. The tile holds their samples, and the last message supplies the previous shaft encoding.
+    //
+    VideoTile tile_;
+    Messages::Video::Ref last_;
+    std::vector<float> weights_;
+    std::vector<float> blend_;
 };
 
 } // namespace Algorithms
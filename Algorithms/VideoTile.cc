@@ -0,0 +1,173 @@
+#include <algorithm>
+
+#include "VideoTile.h"
+
+using namespace SideCar::Algorithms;
+
+/** Rows are padded to a multiple of this many gates so that growth is infrequent.
+ */
+static const size_t kGateBlock = 16;
+
+/** Number of gates the median works on at a time, sized so that the candidates of a block stay in cache while the
+    sorting network runs over them.
+ */
+static const size_t kMedianBlock = 256;
+
+std::vector<std::pair<size_t, size_t>>
+VideoTile::SortingNetwork(size_t count)
+{
+    std::vector<std::pair<size_t, size_t>> network;
+    for (size_t p = 1; p < count; p *= 2) {
+        for (size_t k = p; k >= 1; k /= 2) {
+            for (size_t j = k % p; j + k < count; j += 2 * k) {
+                for (size_t i = 0; i < k && i + j + k < count; ++i) {
+                    if ((i + j) / (2 * p) == (i + j + k) / (2 * p)) network.push_back(std::make_pair(i + j, i + j + k));
+                }
+            }
+        }
+    }
+
+    return network;
+}
+
+VideoTile::VideoTile(size_t rowCount, size_t margin) :
+    rowCount_(0), margin_(0), size_(0), newest_(0), width_(0), stride_(0), rows_(), gateCounts_()
+{
+    reset(rowCount, margin);
+}
+
+void
+VideoTile::reset(size_t rowCount, size_t margin)
+{
+    rowCount_ = std::max(rowCount, size_t(1));
+    margin_ = margin;
+    stride_ = 2 * margin_;
+    rows_.assign(rowCount_ * stride_, 0.0f);
+    clear();
+}
+
+void
+VideoTile::clear()
+{
+    size_ = 0;
+    newest_ = rowCount_ - 1;
+    width_ = 0;
+    std::fill(rows_.begin(), rows_.end(), 0.0f);
+    gateCounts_.assign(rowCount_, 0);
+}
+
+void
+VideoTile::widen(size_t gates)
+{
+    // Only happens when a PRI is longer than any before it, so a copy of every row is acceptable. The leading
+    // margin stays where it was, so each old row copies over as-is.
+    //
+    size_t stride = (gates + kGateBlock - 1) / kGateBlock * kGateBlock + 2 * margin_;
+    std::vector<float> rows(rowCount_ * stride, 0.0f);
+    for (size_t row = 0; row < rowCount_; ++row) {
+        std::copy(rows_.begin() + row * stride_, rows_.begin() + (row + 1) * stride_, rows.begin() + row * stride);
+    }
+
+    rows_.swap(rows);
+    stride_ = stride;
+}
+
+void
+VideoTile::add(const int16_t* samples, size_t count)
+{
+    if (count + 2 * margin_ > stride_) widen(count);
+
+    newest_ = (newest_ + 1) % rowCount_;
+    float* row = rows_.data() + newest_ * stride_ + margin_;
+    for (size_t gate = 0; gate < count; ++gate) row[gate] = samples[gate];
+
+    // Clear any gates of the old row past the end of the new one.
+    //
+    for (size_t gate = count; gate < gateCounts_[newest_]; ++gate) row[gate] = 0.0f;
+
+    gateCounts_[newest_] = count;
+    size_ = std::min(size_ + 1, rowCount_);
+    width_ = *std::max_element(gateCounts_.begin(), gateCounts_.end());
+}
+
+void
+VideoTile::median(const std::vector<size_t>& ages, size_t radius, float* output) const
+{
+    size_t span = 2 * radius + 1;
+    size_t count = ages.size() * span;
+    if (!count) {
+        std::fill(output, output + width_, 0.0f);
+        return;
+    }
+
+    std::vector<std::pair<size_t, size_t>> network(SortingNetwork(count));
+    static thread_local std::vector<float> scratch_;
+    scratch_.resize(count * kMedianBlock);
+
+    for (size_t first = 0; first < width_; first += kMedianBlock) {
+        size_t gates = std::min(kMedianBlock, width_ - first);
+
+        // Candidate i of every gate in the block goes into lane i of the scratch area.
+        //
+        size_t lane = 0;
+        for (size_t age : ages) {
+            const float* row = getRow(age) + first - radius;
+            for (size_t offset = 0; offset < span; ++offset, ++lane) {
+                std::copy(row + offset, row + offset + gates, scratch_.data() + lane * kMedianBlock);
+            }
+        }
+
+        // Each compare-exchange of the network runs across all gates of the block at once.
+        //
+        for (const auto& step : network) {
+            float* lo = scratch_.data() + step.first * kMedianBlock;
+            float* hi = scratch_.data() + step.second * kMedianBlock;
+            for (size_t gate = 0; gate < gates; ++gate) {
+                float a = lo[gate];
+                float b = hi[gate];
+                lo[gate] = std::min(a, b);
+                hi[gate] = std::max(a, b);
+            }
+        }
+
+        const float* upper = scratch_.data() + (count / 2) * kMedianBlock;
+        if (count & 1) {
+            std::copy(upper, upper + gates, output + first);
+        } else {
+            const float* lower = upper - kMedianBlock;
+            for (size_t gate = 0; gate < gates; ++gate) output[first + gate] = (lower[gate] + upper[gate]) * 0.5f;
+        }
+    }
+}
+
+void
+VideoTile::squaredDeviation(const std::vector<size_t>& ages, size_t radius, const float* center,
+                            float* output) const
+{
+    std::fill(output, output + width_, 0.0f);
+    for (size_t offset = 0; offset <= 2 * radius; ++offset) {
+        for (size_t age : ages) {
+            const float* row = getRow(age) + offset - radius;
+            for (size_t gate = 0; gate < width_; ++gate) {
+                float delta = row[gate] - center[gate];
+                output[gate] += delta * delta;
+            }
+        }
+    }
+}
+
+void
+VideoTile::convolve(const std::vector<float>& weights, size_t radius, float* output) const
+{
+    size_t span = 2 * radius + 1;
+    size_t rows = std::min(weights.size() / span, size_);
+    std::fill(output, output + width_, 0.0f);
+    for (size_t age = 0; age < rows; ++age) {
+        for (size_t offset = 0; offset < span; ++offset) {
+            float weight = weights[age * span + offset];
+            if (weight == 0.0f) continue;
+            const float* row = getRow(age) + offset - radius;
+            for (size_t gate = 0; gate < width_; ++gate) output[gate] += weight * row[gate];
+        }
+    }
+}
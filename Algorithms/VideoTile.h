@@ -0,0 +1,157 @@
+#ifndef SIDECAR_ALGORITHMS_VIDEOTILE_H // -*- C++ -*-
+#define SIDECAR_ALGORITHMS_VIDEOTILE_H
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace SideCar {
+namespace Algorithms {
+
+/** Rolling two-dimensional window of video for algorithms that work on a neighbourhood spanning several PRIs.
+    The tile holds the last N PRIs as rows of float values in one preallocated ring. Rows are addressed by age:
+    row 0 is the PRI added last, and row N - 1 the oldest one kept. Each row has a margin of zeros on both sides,
+    so neighbourhoods that extend past the first or last gate need no bounds checks.
+
+    PRIs may differ in length. Gates past the end of a PRI read as zero, and the width of the tile is the length
+    of the longest PRI it holds.
+
+    The neighbourhood kernels below work on all gates at once. Each step of a kernel is a loop over gates, which the
+    compiler turns into vector instructions; the median in particular applies a sorting network to whole rows of
+    candidates with element-wise min and max rather than sorting a small array for each gate.
+*/
+class VideoTile {
+public:
+    /** Obtain the compare-exchange steps of a sorting network for a given number of values. The network is
+        Batcher's odd-even merge sort, which works for any count.
+
+        \param count number of values to sort
+
+        \return pairs of indices to compare and exchange, in order
+    */
+    static std::vector<std::pair<size_t, size_t>> SortingNetwork(size_t count);
+
+    /** Constructor.
+
+        \param rowCount number of PRIs to keep
+
+        \param margin number of zero gates before and after each row. Kernels may reach this far past the ends.
+    */
+    explicit VideoTile(size_t rowCount = 3, size_t margin = 1);
+
+    /** Drop all rows and change the shape of the tile.
+
+        \param rowCount number of PRIs to keep
+
+        \param margin number of zero gates before and after each row
+    */
+    void reset(size_t rowCount, size_t margin);
+
+    /** Drop all rows.
+     */
+    void clear();
+
+    size_t getRowCount() const { return rowCount_; }
+
+    size_t getMargin() const { return margin_; }
+
+    /** Obtain the number of rows that hold PRIs.
+
+        \return row count
+    */
+    size_t size() const { return size_; }
+
+    bool full() const { return size_ == rowCount_; }
+
+    /** Obtain the number of gates in the longest PRI in the tile. The kernels produce this many values.
+
+        \return gate count
+    */
+    size_t getWidth() const { return width_; }
+
+    /** Obtain the number of gates in one PRI.
+
+        \param age row to inspect, where 0 is the last PRI added
+
+        \return gate count
+    */
+    size_t getGateCount(size_t age) const { return gateCounts_[slot(age)]; }
+
+    /** Obtain the values of one PRI. The pointer may be indexed from -getMargin() up to
+        getWidth() + getMargin() - 1.
+
+        \param age row to fetch, where 0 is the last PRI added
+
+        \return pointer to the value of the first gate
+    */
+    const float* getRow(size_t age) const { return rows_.data() + slot(age) * stride_ + margin_; }
+
+    /** Add a PRI, replacing the oldest one if the tile is full.
+
+        \param samples sample values
+
+        \param count number of values in \p samples
+    */
+    void add(const int16_t* samples, size_t count);
+
+    /** Find the median of a neighbourhood about each gate. The neighbourhood holds gates g - radius through
+        g + radius of each of the given rows. For an even number of values the median is the mean of the middle
+        two.
+
+        \param ages rows in the neighbourhood
+
+        \param radius half-width of the neighbourhood in gates. Must not exceed getMargin().
+
+        \param output buffer for getWidth() values
+    */
+    void median(const std::vector<size_t>& ages, size_t radius, float* output) const;
+
+    /** Find the sum of squared differences between the values of a neighbourhood about each gate and a value for
+        that gate. The neighbourhood is the same as for median().
+
+        \param ages rows in the neighbourhood
+
+        \param radius half-width of the neighbourhood in gates. Must not exceed getMargin().
+
+        \param center getWidth() values to take differences from
+
+        \param output buffer for getWidth() values
+    */
+    void squaredDeviation(const std::vector<size_t>& ages, size_t radius, const float* center, float* output) const;
+
+    /** Find the weighted sum of a neighbourhood about each gate:
+
+        \code
+        output[g] = sum over a and j of weights[a * (2 * radius + 1) + j] * getRow(a)[g + j - radius]
+        \endcode
+
+        \param weights row-major weights for the rows of ages 0, 1, ... The number of rows must not exceed size().
+
+        \param radius half-width of the neighbourhood in gates. Must not exceed getMargin().
+
+        \param output buffer for getWidth() values
+    */
+    void convolve(const std::vector<float>& weights, size_t radius, float* output) const;
+
+private:
+    size_t slot(size_t age) const { return (newest_ + rowCount_ - age) % rowCount_; }
+
+    void widen(size_t gates);
+
+    size_t rowCount_;
+    size_t margin_;
+    size_t size_;
+    size_t newest_;
+    size_t width_;
+    size_t stride_;
+    std::vector<float> rows_;
+    std::vector<size_t> gateCounts_;
+};
+
+} // end namespace Algorithms
+} // end namespace SideCar
+
+/** \file
+ */
+
+#endif
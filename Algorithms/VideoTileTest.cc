@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <cstdlib>
+#include <deque>
+#include <vector>
+
+#include "UnitTest/UnitTest.h"
+
+#include "VideoTile.h"
+
+using namespace SideCar::Algorithms;
+
+struct Test : public UnitTest::TestObj {
+    Test() : TestObj("VideoTile") {}
+
+    void test();
+};
+
+using Samples = std::vector<int16_t>;
+
+/** Value of a gate of a PRI, or zero past either end.
+ */
+static float
+Value(const Samples& pri, long gate)
+{
+    return gate >= 0 && gate < long(pri.size()) ? pri[gate] : 0.0f;
+}
+
+void
+Test::test()
+{
+    ::srand(1234);
+
+    // By the zero-one principle, a network that sorts every sequence of zeros and ones sorts everything.
+    //
+    for (size_t count = 1; count <= 14; ++count) {
+        std::vector<std::pair<size_t, size_t>> network(VideoTile::SortingNetwork(count));
+        for (size_t bits = 0; bits < (size_t(1) << count); ++bits) {
+            std::vector<int> values(count);
+            for (size_t index = 0; index < count; ++index) values[index] = (bits >> index) & 1;
+            for (const auto& step : network) {
+                if (values[step.first] > values[step.second]) std::swap(values[step.first], values[step.second]);
+            }
+            assertTrue(std::is_sorted(values.begin(), values.end()));
+        }
+    }
+
+    // Rows come back by age, zero-padded past their ends and within the margin.
+    //
+    {
+        VideoTile tile(2, 2);
+        const int16_t a[] = {1, 2, 3}, b[] = {4, 5};
+        tile.add(a, 3);
+        assertFalse(tile.full());
+        tile.add(b, 2);
+        assertTrue(tile.full());
+        assertEqual(size_t(3), tile.getWidth());
+        assertEqual(size_t(2), tile.getGateCount(0));
+        assertEqual(4.0f, tile.getRow(0)[0]);
+        assertEqual(0.0f, tile.getRow(0)[2]);
+        assertEqual(3.0f, tile.getRow(1)[2]);
+        assertEqual(0.0f, tile.getRow(1)[-2]);
+        assertEqual(0.0f, tile.getRow(1)[4]);
+
+        // A shorter PRI replacing the longest narrows the tile and clears the old values.
+        //
+        tile.add(b, 2);
+        assertEqual(size_t(2), tile.getWidth());
+        assertEqual(0.0f, tile.getRow(1)[2]);
+    }
+
+    // Kernels match direct computation over PRIs of varying lengths.
+    //
+    for (size_t radius = 0; radius <= 2; ++radius) {
+        VideoTile tile(4, radius);
+        std::deque<Samples> pris;
+        for (int pass = 0; pass < 30; ++pass) {
+            Samples pri(::rand() % 600);
+            for (auto& value : pri) value = ::rand() % 2000 - 1000;
+            tile.add(pri.data(), pri.size());
+            pris.push_front(pri);
+            if (pris.size() > 4) pris.pop_back();
+
+            size_t width = 0;
+            for (const Samples& row : pris) width = std::max(width, row.size());
+            assertEqual(width, tile.getWidth());
+
+            std::vector<size_t> ages;
+            for (size_t age = 0; age < pris.size(); ++age) {
+                if (age != 1 || pris.size() == 1) ages.push_back(age);
+            }
+
+            std::vector<float> weights((2 * radius + 1) * pris.size());
+            for (auto& weight : weights) weight = (::rand() % 201 - 100) / 50.0f;
+
+            std::vector<float> median(width), deviation(width), sum(width);
+            tile.median(ages, radius, median.data());
+            tile.squaredDeviation(ages, radius, median.data(), deviation.data());
+            tile.convolve(weights, radius, sum.data());
+
+            for (size_t gate = 0; gate < width; ++gate) {
+                std::vector<float> values;
+                float expectedSum = 0.0f;
+                for (size_t age = 0; age < pris.size(); ++age) {
+                    for (size_t offset = 0; offset <= 2 * radius; ++offset) {
+                        float value = Value(pris[age], long(gate + offset) - long(radius));
+                        expectedSum += weights[age * (2 * radius + 1) + offset] * value;
+                        if (std::find(ages.begin(), ages.end(), age) != ages.end()) values.push_back(value);
+                    }
+                }
+
+                std::sort(values.begin(), values.end());
+                size_t middle = values.size() / 2;
+                float expected = values.size() & 1 ? values[middle] : (values[middle - 1] + values[middle]) * 0.5f;
+                assertEqual(expected, median[gate]);
+
+                float expectedDeviation = 0.0f;
+                for (float value : values) expectedDeviation += (value - expected) * (value - expected);
+                assertEqualEpsilon(expectedDeviation, deviation[gate], expectedDeviation * 1.0E-5);
+                assertEqualEpsilon(expectedSum, sum[gate], 0.05);
+            }
+        }
+    }
+}
+
+int
+main(int, const char**)
+{
+    return Test().mainRun();
+}
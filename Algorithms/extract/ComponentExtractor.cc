@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "Utils/Utils.h"
+
+#include "ComponentExtractor.h"
+
+using namespace SideCar::Algorithms;
+
+/** Obtain the angle swept going clockwise from one azimuth to another.
+ */
+static double
+Sweep(double from, double to)
+{
+    double delta = to - from;
+    return delta < 0.0 ? delta + 2.0 * M_PI : delta;
+}
+
+double
+ComponentExtractor::Target::getAzimuth() const
+{
+    return Utils::normalizeRadians(azimuthStart + Sweep(azimuthStart, azimuthEnd) / 2.0);
+}
+
+double
+ComponentExtractor::Target::getCentroidAzimuth() const
+{
+    return weight > 0.0 ? Utils::normalizeRadians(azimuthStart + azimuthMoment / weight) : getAzimuth();
+}
+
+void
+ComponentExtractor::Target::absorb(const Target& other)
+{
+    // Keep the azimuth moment relative to whichever component started first.
+    //
+    if (other.irigStart < irigStart) {
+        azimuthMoment += weight * Sweep(other.azimuthStart, azimuthStart);
+        azimuthStart = other.azimuthStart;
+        irigStart = other.irigStart;
+    }
+
+    azimuthMoment += other.azimuthMoment + other.weight * Sweep(azimuthStart, other.azimuthStart);
+
+    if (other.irigEnd > irigEnd) {
+        irigEnd = other.irigEnd;
+        azimuthEnd = other.azimuthEnd;
+    }
+
+    weight += other.weight;
+    gateMoment += other.gateMoment;
+    gateMin = std::min(gateMin, other.gateMin);
+    gateMax = std::max(gateMax, other.gateMax);
+    cellCount += other.cellCount;
+}
+
+ComponentExtractor::ComponentExtractor() : forest_(), targets_(), previous_(), current_()
+{
+    ;
+}
+
+void
+ComponentExtractor::reset()
+{
+    forest_.reset();
+    targets_.clear();
+    previous_.clear();
+}
+
+ComponentExtractor::Label
+ComponentExtractor::unite(Label a, Label b)
+{
+    if (a == b) return a;
+
+    targets_[a].absorb(targets_[b]);
+    forest_.unite(a, b);
+    return a;
+}
+
+ComponentExtractor::Label
+ComponentExtractor::allocate(double irig, double azimuth)
+{
+    Label label = forest_.allocate();
+    if (targets_.size() < forest_.getLabelCount()) targets_.resize(forest_.getLabelCount());
+
+    Target& target(targets_[label]);
+    target.irigStart = irig;
+    target.irigEnd = irig;
+    target.azimuthStart = azimuth;
+    target.azimuthEnd = azimuth;
+    target.weight = 0.0;
+    target.gateMoment = 0.0;
+    target.azimuthMoment = 0.0;
+    target.gateMin = std::numeric_limits<uint32_t>::max();
+    target.gateMax = 0;
+    target.cellCount = 0;
+
+    return label;
+}
+
+void
+ComponentExtractor::attach(Label label, const Run& run, double irig, double azimuth, const int16_t* weights)
+{
+    Target& target(targets_[label]);
+    if (forest_.touch(label)) {
+        target.irigEnd = irig;
+        target.azimuthEnd = azimuth;
+    }
+
+    uint32_t count = run.stop - run.start + 1;
+    target.gateMin = std::min(target.gateMin, run.start);
+    target.gateMax = std::max(target.gateMax, run.stop);
+    target.cellCount += count;
+
+    double weight = 0.0;
+    double gateMoment = 0.0;
+    if (weights) {
+        for (uint32_t gate = run.start; gate <= run.stop; ++gate) {
+            double value = std::max(int16_t(0), weights[gate]);
+            weight += value;
+            gateMoment += value * gate;
+        }
+    } else {
+        weight = count;
+        gateMoment = double(count) * (run.start + run.stop) / 2.0;
+    }
+
+    target.weight += weight;
+    target.gateMoment += gateMoment;
+    target.azimuthMoment += weight * Sweep(target.azimuthStart, azimuth);
+}
+
+void
+ComponentExtractor::add(double irig, double azimuth, const Utils::BitVector& bits, const int16_t* weights,
+                        TargetVector& done)
+{
+    forest_.beginPRI();
+
+    current_.clear();
+    bits.forEachRun([this](size_t start, size_t stop) {
+        Run run = {uint32_t(start), uint32_t(stop), 0};
+        current_.push_back(run);
+    });
+
+    // Sweep both PRIs in range order. A run joins every run of the previous PRI with which it shares a gate.
+    //
+    size_t first = 0;
+    for (auto& run : current_) {
+        while (first < previous_.size() && previous_[first].stop < run.start) ++first;
+
+        Label label = 0;
+        bool found = false;
+        for (size_t other = first; other < previous_.size() && previous_[other].start <= run.stop; ++other) {
+            Label root = forest_.find(previous_[other].label);
+            label = found ? unite(label, root) : root;
+            found = true;
+        }
+
+        if (!found) label = allocate(irig, azimuth);
+        attach(label, run, irig, azimuth, weights);
+        run.label = label;
+    }
+
+    // Components open before this PRI that it did not extend are complete.
+    //
+    forest_.close([&](Label label) { done.push_back(targets_[label]); }, [](Label) { return true; });
+
+    // Point the runs at their roots so that labels merged away during this PRI are no longer used.
+    //
+    for (auto& run : current_) run.label = forest_.find(run.label);
+    forest_.recycleMerged();
+
+    previous_.swap(current_);
+}
+
+void
+ComponentExtractor::flush(TargetVector& done)
+{
+    for (auto label : forest_.getOpen()) done.push_back(targets_[label]);
+    reset();
+}
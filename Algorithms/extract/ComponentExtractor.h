@@ -0,0 +1,144 @@
+#ifndef SIDECAR_ALGORITHMS_EXTRACT_COMPONENTEXTRACTOR_H // -*- C++ -*-
+#define SIDECAR_ALGORITHMS_EXTRACT_COMPONENTEXTRACTOR_H
+
+#include <cstdint>
+#include <vector>
+
+#include "Utils/BitVector.h"
+#include "Utils/LabelForest.h"
+
+namespace SideCar {
+namespace Algorithms {
+
+/** Single-pass connected component extractor for thresholded PRIs. Each call to add() finds the runs of set gates
+    in one PRI and joins them to the runs of the previous PRI that share a gate. Components are kept in a pool of
+    fixed-size records indexed by label, and joined with a Utils::LabelForest, so the cost of a PRI is linear in the number
+    of runs it holds. A component is complete when a PRI adds nothing to it, at which point a copy of its record is
+    returned and its label reused.
+
+    Records hold the extent of a component and running sums for a weighted centroid, so nothing about the
+    individual cells is kept.
+*/
+class ComponentExtractor {
+public:
+    /** Summary of one connected component.
+     */
+    struct Target {
+        /** Obtain the mid-point of the time span of the component.
+
+            \return IRIG time
+        */
+        double getIRIGTime() const { return (irigStart + irigEnd) / 2.0; }
+
+        /** Obtain the middle of the gate span of the component.
+
+            \return gate index
+        */
+        double getGate() const { return (gateMin + gateMax) / 2.0; }
+
+        /** Obtain the middle of the azimuth span of the component, allowing for a span that crosses north.
+
+            \return azimuth in radians
+        */
+        double getAzimuth() const;
+
+        /** Obtain the weighted mean gate of the component, or the middle of its span if the weights sum to zero.
+
+            \return gate index
+        */
+        double getCentroidGate() const { return weight > 0.0 ? gateMoment / weight : getGate(); }
+
+        /** Obtain the weighted mean azimuth of the component, or the middle of its span if the weights sum to zero.
+
+            \return azimuth in radians
+        */
+        double getCentroidAzimuth() const;
+
+        /** Fold another component into this one.
+
+            \param other component to absorb
+        */
+        void absorb(const Target& other);
+
+        double irigStart;     ///< Time of the first PRI
+        double irigEnd;       ///< Time of the last PRI
+        double azimuthStart;  ///< Azimuth of the first PRI
+        double azimuthEnd;    ///< Azimuth of the last PRI
+        double weight;        ///< Sum of cell weights
+        double gateMoment;    ///< Sum of weight * gate
+        double azimuthMoment; ///< Sum of weight * azimuth past azimuthStart
+        uint32_t gateMin;     ///< Lowest gate
+        uint32_t gateMax;     ///< Highest gate
+        uint32_t cellCount;   ///< Number of set cells
+    };
+
+    using TargetVector = std::vector<Target>;
+
+    ComponentExtractor();
+
+    /** Add the next PRI. Components that the PRI did not extend are appended to \p done.
+
+        \param irig time of the PRI
+
+        \param azimuth azimuth of the PRI in radians
+
+        \param bits thresholded gates of the PRI
+
+        \param weights sample values to weight the centroid with, one per gate. If null, every cell has a weight of
+        one. Negative values count as zero.
+
+        \param done container for completed components
+    */
+    void add(double irig, double azimuth, const Utils::BitVector& bits, const int16_t* weights, TargetVector& done);
+
+    /** Complete all open components.
+
+        \param done container for completed components
+    */
+    void flush(TargetVector& done);
+
+    /** Forget all state.
+     */
+    void reset();
+
+    /** Obtain the number of components extended by the last PRI.
+
+        \return open count
+    */
+    size_t getOpenCount() const { return forest_.getOpenCount(); }
+
+    /** Obtain the number of records allocated. Labels are reused, so this is the largest number of components that
+        were active at once.
+
+        \return pool size
+    */
+    size_t getPoolSize() const { return targets_.size(); }
+
+private:
+    using Label = Utils::LabelForest::Label;
+
+    struct Run {
+        uint32_t start;
+        uint32_t stop;
+        Label label;
+    };
+
+    Label unite(Label a, Label b);
+
+    Label allocate(double irig, double azimuth);
+
+    void attach(Label label, const Run& run, double irig, double azimuth, const int16_t* weights);
+
+    Utils::LabelForest forest_;
+    std::vector<Target> targets_;
+    std::vector<Run> previous_;
+    std::vector<Run> current_;
+};
+
+} // end namespace Algorithms
+} // end namespace SideCar
+
+/** \file
+ */
+
+#endif
@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#include "Logger/Log.h"
+#include "UnitTest/UnitTest.h"
+
+#include "ComponentExtractor.h"
+
+using namespace SideCar::Algorithms;
+
+struct Test : public UnitTest::TestObj {
+    Test() : TestObj("ComponentExtractor") {}
+
+    void test();
+};
+
+using Picture = std::vector<std::vector<char>>;
+
+static Utils::BitVector
+Bits(const std::vector<char>& row)
+{
+    Utils::BitVector bits;
+    bits.assign(row.data(), row.data() + row.size());
+    return bits;
+}
+
+/** Label a picture with a flood fill, returning the cell count, gate span, and PRI span of each component,
+    sorted.
+*/
+static std::vector<std::vector<size_t>>
+FloodFill(const Picture& picture)
+{
+    std::vector<std::vector<size_t>> found;
+    Picture seen(picture.size(), std::vector<char>(picture[0].size(), 0));
+    for (size_t pri = 0; pri < picture.size(); ++pri) {
+        for (size_t gate = 0; gate < picture[pri].size(); ++gate) {
+            if (!picture[pri][gate] || seen[pri][gate]) continue;
+            std::vector<std::pair<size_t, size_t>> stack(1, std::make_pair(pri, gate));
+            seen[pri][gate] = 1;
+            size_t cells = 0, gateMin = gate, gateMax = gate, priMin = pri, priMax = pri;
+            while (!stack.empty()) {
+                size_t p = stack.back().first, g = stack.back().second;
+                stack.pop_back();
+                ++cells;
+                gateMin = std::min(gateMin, g);
+                gateMax = std::max(gateMax, g);
+                priMin = std::min(priMin, p);
+                priMax = std::max(priMax, p);
+                const int offsets[4][2] = {{-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+                for (const auto& offset : offsets) {
+                    size_t np = p + offset[0], ng = g + offset[1];
+                    if (np >= picture.size() || ng >= picture[np].size()) continue;
+                    if (!picture[np][ng] || seen[np][ng]) continue;
+                    seen[np][ng] = 1;
+                    stack.push_back(std::make_pair(np, ng));
+                }
+            }
+
+            found.push_back({cells, gateMin, gateMax, priMin, priMax});
+        }
+    }
+
+    std::sort(found.begin(), found.end());
+    return found;
+}
+
+void
+Test::test()
+{
+    // A "U" shape is two components until its arms join. Cells that touch only at a corner are separate.
+    //
+    const char* rows[] = {
+        "##...##.....#...",
+        "##...##......#..",
+        ".#...#..........",
+        ".#####..........",
+        "................",
+    };
+
+    ComponentExtractor extractor;
+    ComponentExtractor::TargetVector done;
+    for (size_t row = 0; row < 5; ++row) {
+        std::vector<char> gates;
+        for (const char* c = rows[row]; *c; ++c) gates.push_back(*c == '#');
+        extractor.add(row, 0.1 * row, Bits(gates), 0, done);
+    }
+
+    assertEqual(size_t(3), done.size());
+    assertEqual(size_t(0), extractor.getOpenCount());
+    std::sort(done.begin(), done.end(), [](auto& a, auto& b) { return a.cellCount < b.cellCount; });
+    assertEqual(uint32_t(1), done[0].cellCount);
+    assertEqual(uint32_t(1), done[1].cellCount);
+    assertEqual(uint32_t(15), done[2].cellCount);
+    assertEqual(uint32_t(0), done[2].gateMin);
+    assertEqual(uint32_t(6), done[2].gateMax);
+    assertEqual(3.0, done[2].getGate());
+    assertEqual(1.5, done[2].getIRIGTime());
+    assertTrue(std::fabs(done[2].getAzimuth() - 0.15) < 1.0E-9);
+
+    // Weighted centroid of a single run.
+    //
+    {
+        ComponentExtractor extractor;
+        std::vector<char> gates(8, 0);
+        gates[2] = gates[3] = gates[4] = 1;
+        std::vector<int16_t> weights(8, 0);
+        weights[2] = 1;
+        weights[3] = -5;
+        weights[4] = 3;
+        extractor.add(0.0, 1.0, Bits(gates), weights.data(), done);
+        extractor.add(1.0, 1.2, Bits(gates), weights.data(), done);
+        done.clear();
+        extractor.flush(done);
+        assertEqual(size_t(1), done.size());
+        assertEqual(3.5, done[0].getCentroidGate());
+        assertTrue(std::fabs(done[0].getCentroidAzimuth() - 1.1) < 1.0E-9);
+    }
+
+    // Azimuth spans and centroids that cross north.
+    //
+    {
+        ComponentExtractor extractor;
+        std::vector<char> gates(4, 1);
+        extractor.add(0.0, 2.0 * M_PI - 0.1, Bits(gates), 0, done);
+        extractor.add(1.0, 0.1, Bits(gates), 0, done);
+        done.clear();
+        extractor.flush(done);
+        assertEqual(size_t(1), done.size());
+        assertTrue(std::fabs(done[0].getAzimuth()) < 1.0E-9 || std::fabs(done[0].getAzimuth() - 2.0 * M_PI) < 1.0E-9);
+        assertTrue(std::fabs(std::sin(done[0].getCentroidAzimuth())) < 1.0E-9);
+    }
+
+    // Compare with a flood fill on random pictures. Record the PRI of each row in its IRIG time so that PRI spans
+    // can be checked.
+    //
+    ::srand(2718);
+    for (int trial = 0; trial < 200; ++trial) {
+        size_t pris = 1 + ::rand() % 40;
+        size_t gates = 1 + ::rand() % 150;
+        int density = 20 + ::rand() % 60;
+        Picture picture(pris, std::vector<char>(gates, 0));
+        for (auto& row : picture) {
+            for (auto& gate : row) gate = (::rand() % 100) < density;
+        }
+
+        ComponentExtractor extractor;
+        done.clear();
+        for (size_t pri = 0; pri < pris; ++pri) extractor.add(pri, 0.0, Bits(picture[pri]), 0, done);
+        extractor.flush(done);
+
+        std::vector<std::vector<size_t>> found;
+        for (const auto& target : done) {
+            found.push_back({target.cellCount, target.gateMin, target.gateMax, size_t(target.irigStart),
+                             size_t(target.irigEnd)});
+        }
+
+        std::sort(found.begin(), found.end());
+        assertTrue(found == FloodFill(picture));
+    }
+
+    // Labels are reused, so the pool only grows to the largest number of components active at once.
+    //
+    extractor.reset();
+    std::vector<char> comb(64, 0);
+    for (size_t gate = 0; gate < comb.size(); gate += 2) comb[gate] = 1;
+    std::vector<char> blank(64, 0);
+    for (int pri = 0; pri < 1000; ++pri) {
+        done.clear();
+        extractor.add(pri, 0.0, Bits(pri % 2 ? comb : blank), 0, done);
+    }
+
+    assertEqual(size_t(32), extractor.getPoolSize());
+}
+
+int
+main(int, const char**)
+{
+    return Test().mainRun();
+}
@@ -1,30 +1,26 @@
 #ifndef SIDECAR_ALGORITHMS_EXTRACT_H // -*- C++ -*-
 #define SIDECAR_ALGORITHMS_EXTRACT_H
 
-#include <list>
-#include <vector>
-
-#include "boost/shared_ptr.hpp"
-
 #include "Algorithms/Algorithm.h"
 #include "Messages/BinaryVideo.h"
 #include "Parameter/Parameter.h"
+#include "Utils/BitVector.h"
+
+#include "ComponentExtractor.h"
 
 namespace SideCar {
 namespace Algorithms {
 
-/** This algorithm takes in thresholded pri's and outputs extraction messages. For now an extraction is declared
-    at the center (where the center is simply the average of the min and max az/range) of every contiguous group
-    of detections.
+/** This algorithm takes in thresholded pri's and outputs extraction messages. An extraction is declared for every
+    group of detections connected in range or azimuth, once a PRI arrives that does not extend the group. By default
+    the extraction lies at the center of the group, the average of its min and max az/range. If \c centroid is set,
+    it lies at the centroid of the group weighted by the Video samples that were the basis of the detections.
 
+    Groups are found by a ComponentExtractor, which works on one PRI at a time and keeps only a small summary of
+    each open group.
 */
 class Extract : public Algorithm {
 public:
-    class Target;
-    using TargetRef = boost::shared_ptr<Target>;
-    using TargetList = std::list<TargetRef>;
-    using TargetVector = std::vector<TargetRef>;
-
     /** Constructor.
 
         \param controller object that controls us
@@ -50,14 +46,11 @@ private:
     */
     bool process(const Messages::BinaryVideo::Ref& msg);
 
-    /** List of pending target extractions. An pending target is one whose end azimuth has not yet been
-        identified.
-    */
-    TargetList pending_;
+    Parameter::BoolValue::Ref centroid_;
 
-    /** List of targets assigned to range gates for the last PRI.
-     */
-    TargetVector gateTargets_;
+    ComponentExtractor extractor_;
+    ComponentExtractor::TargetVector done_;
+    Utils::BitVector bits_;
 };
 
 } // end namespace Algorithms
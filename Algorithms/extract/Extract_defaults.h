@@ -0,0 +1 @@
+static const bool kDefaultCentroid = false;
@@ -0,0 +1,210 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "boost/shared_ptr.hpp"
+
+#include "Time/TimeStamp.h"
+#include "Utils/BitVector.h"
+#include "Utils/CmdLineArgs.h"
+#include "Utils/Utils.h"
+
+#include "ComponentExtractor.h"
+
+using namespace SideCar;
+
+const std::string about = "Time target extraction from thresholded video with the ComponentExtractor and with the "
+                          "list-based bookkeeping that Extract used before it, on a synthetic scan.";
+
+const Utils::CmdLineArgs::OptionDef opts[] = {
+    {'b', "blobs", "number of blobs (default 4000)", "N"},
+    {'d', "density", "speckle density in percent (default 10)", "N"},
+    {'g', "gates", "gates per PRI (default 4096)", "N"},
+    {'n', "iterations", "number of passes over the scan (default 3)", "N"},
+    {'p', "pris", "PRIs in the scan (default 4096)", "N"},
+};
+
+using Scene = std::vector<std::vector<char>>;
+
+/** Build one scan of thresholded video: random speckle and elliptical blobs of various sizes.
+ */
+static void
+MakeScene(Scene& scene, int pris, int gates, int blobs, int density)
+{
+    ::srand(1234);
+    scene.assign(pris, std::vector<char>(gates, 0));
+    for (auto& pri : scene) {
+        for (auto& gate : pri) gate = (::rand() % 100) < density;
+    }
+
+    for (int index = 0; index < blobs; ++index) {
+        int az = ::rand() % pris;
+        int range = ::rand() % gates;
+        int azRadius = 1 + ::rand() % 12;
+        int rangeRadius = 1 + ::rand() % 20;
+        for (int dAz = -azRadius; dAz <= azRadius; ++dAz) {
+            std::vector<char>& pri(scene[(az + dAz + pris) % pris]);
+            double fraction = 1.0 - double(dAz * dAz) / (azRadius * azRadius);
+            int span = int(rangeRadius * fraction);
+            int last = std::min(gates - 1, range + span);
+            for (int gate = std::max(0, range - span); gate <= last; ++gate) pri[gate] = 1;
+        }
+    }
+}
+
+/** The target bookkeeping of Extract before it used ComponentExtractor: a list of shared target objects, a vector
+    of target pointers per gate, and a linear search of the list whenever two targets join.
+*/
+class Legacy {
+public:
+    size_t add(double irig, float azimuth, const std::vector<char>& data)
+    {
+        if (data.size() > gateTargets_.size()) gateTargets_.resize(data.size(), Target::Ref());
+
+        Target::Ref target;
+        for (size_t gate = 0; gate < data.size(); ++gate) {
+            if (data[gate]) {
+                if (!target) {
+                    if (gateTargets_[gate]) {
+                        target = gateTargets_[gate];
+                    } else {
+                        target.reset(new Target(irig, gate, azimuth));
+                        pending_.push_back(target);
+                    }
+                } else if (gateTargets_[gate] && gateTargets_[gate] != target) {
+                    auto pos = std::find(pending_.begin(), pending_.end(), target);
+                    if (pos != pending_.end()) pending_.erase(pos);
+                    gateTargets_[gate]->assimilate(*target);
+                    target = gateTargets_[gate];
+                }
+            } else if (target) {
+                target->update(irig, gate - 1, azimuth);
+                target.reset();
+            }
+        }
+
+        std::fill(gateTargets_.begin(), gateTargets_.end(), Target::Ref());
+
+        size_t done = 0;
+        auto it = pending_.begin();
+        while (it != pending_.end()) {
+            target = *it;
+            if (target->testValidAndReset()) {
+                ++it;
+                for (int gate = target->gateMin; gate <= target->gateMax; ++gate)
+                    if (data[gate]) gateTargets_[gate] = target;
+            } else {
+                ++done;
+                it = pending_.erase(it);
+            }
+        }
+
+        return done;
+    }
+
+private:
+    struct Target {
+        using Ref = boost::shared_ptr<Target>;
+
+        Target(double irig, int gate, float azimuth) :
+            irigStart(irig), irigEnd(irig), azimuthStart(azimuth), azimuthEnd(azimuth), gateMin(gate), gateMax(gate),
+            valid(true)
+        {
+        }
+
+        void update(double irig, int gate, float azimuth)
+        {
+            if (gate > gateMax) gateMax = gate;
+            irigEnd = irig;
+            azimuthEnd = azimuth;
+            valid = true;
+        }
+
+        void assimilate(const Target& other)
+        {
+            if (other.gateMin < gateMin) gateMin = other.gateMin;
+            if (other.gateMax > gateMax) gateMax = other.gateMax;
+            valid = true;
+        }
+
+        bool testValidAndReset()
+        {
+            bool tmp = false;
+            std::swap(tmp, valid);
+            return tmp;
+        }
+
+        double irigStart, irigEnd;
+        float azimuthStart, azimuthEnd;
+        int gateMin, gateMax;
+        bool valid;
+    };
+
+    std::list<Target::Ref> pending_;
+    std::vector<Target::Ref> gateTargets_;
+};
+
+static void
+Report(const char* label, double elapsed, size_t pris, int iterations, size_t targets)
+{
+    double perPRI = elapsed / (double(pris) * iterations);
+    std::cout << std::setw(10) << label << std::fixed << std::setprecision(3) << std::setw(10) << perPRI * 1.0E6
+              << " usecs/PRI " << std::setw(10) << std::setprecision(1) << 1.0 / (perPRI * pris)
+              << " scans/sec  targets: " << targets << '\n';
+}
+
+int
+main(int argc, char** argv)
+{
+    Utils::CmdLineArgs cla(argc, argv, about, opts, sizeof(opts), 0, 0);
+
+    int iterations = 3, pris = 4096, gates = 4096, blobs = 4000, density = 10;
+    if (cla.hasOpt("iterations")) cla.opt("iterations")[0] >> iterations;
+    if (cla.hasOpt("pris")) cla.opt("pris")[0] >> pris;
+    if (cla.hasOpt("gates")) cla.opt("gates")[0] >> gates;
+    if (cla.hasOpt("blobs")) cla.opt("blobs")[0] >> blobs;
+    if (cla.hasOpt("density")) cla.opt("density")[0] >> density;
+
+    Scene scene;
+    MakeScene(scene, pris, gates, blobs, density);
+    double azimuthStep = 2.0 * M_PI / scene.size();
+
+    size_t targets = 0;
+    Time::TimeStamp start(Time::TimeStamp::Now());
+    for (int pass = 0; pass < iterations; ++pass) {
+        Legacy legacy;
+        targets = 0;
+        for (size_t index = 0; index < scene.size(); ++index) {
+            targets += legacy.add(index, index * azimuthStep, scene[index]);
+        }
+    }
+    Report("legacy", (Time::TimeStamp::Now() - start).asDouble(), scene.size(), iterations, targets);
+
+    // Packing the gates is part of the cost, as Extract does it for every message.
+    //
+    Algorithms::ComponentExtractor extractor;
+    Algorithms::ComponentExtractor::TargetVector done;
+    Utils::BitVector bits;
+    start = Time::TimeStamp::Now();
+    for (int pass = 0; pass < iterations; ++pass) {
+        extractor.reset();
+        targets = 0;
+        for (size_t index = 0; index < scene.size(); ++index) {
+            const std::vector<char>& pri(scene[index]);
+            bits.assign(pri.data(), pri.data() + pri.size());
+            done.clear();
+            extractor.add(index, index * azimuthStep, bits, 0, done);
+            targets += done.size();
+        }
+    }
+    Report("streaming", (Time::TimeStamp::Now() - start).asDouble(), scene.size(), iterations, targets);
+
+    std::cout << "PRIs: " << scene.size() << " gates: " << gates << " largest pool: " << extractor.getPoolSize()
+              << '\n';
+
+    return 0;
+}
@@ -0,0 +1,110 @@
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include <fftw3.h>
+
+#include "Time/TimeStamp.h"
+#include "Utils/CmdLineArgs.h"
+#include "Utils/FilePath.h"
+#include "Utils/Utils.h"
+
+#include "FFTEngine.h"
+
+using namespace SideCar;
+using namespace SideCar::Algorithms;
+
+const std::string about = "Time FFTEngine plan creation with and without saved wisdom, and compare the cost of a CPI "
+                          "of transforms done one row at a time, as a batch, and as a threaded batch.";
+
+const Utils::CmdLineArgs::OptionDef opts[] = {
+    {'n', "iterations", "number of CPIs to transform (default 200)", "N"},
+    {'r', "rows", "transforms per CPI (default 256)", "N"},
+    {'s', "size", "points per transform (default 1024)", "N"},
+    {'t', "threads", "threads for the threaded batch (default 4)", "N"},
+};
+
+static void
+ReportPlan(const char* label, double elapsed)
+{
+    std::cout << std::setw(24) << label << std::fixed << std::setprecision(1) << std::setw(12) << elapsed * 1.0E6
+              << " usecs\n";
+}
+
+static void
+ReportRun(const char* label, double elapsed, int iterations, size_t points)
+{
+    double perCPI = elapsed / iterations;
+    std::cout << std::setw(24) << label << std::fixed << std::setprecision(1) << std::setw(12) << perCPI * 1.0E6
+              << " usecs/CPI " << std::setw(8) << std::setprecision(2) << perCPI * 1.0E9 / points
+              << " nsecs/point\n";
+}
+
+int
+main(int argc, char** argv)
+{
+    Utils::CmdLineArgs cla(argc, argv, about, opts, sizeof(opts), 0, 0);
+
+    int iterations = 200, rows = 256, size = 1024, threads = 4;
+    if (cla.hasOpt("iterations")) cla.opt("iterations")[0] >> iterations;
+    if (cla.hasOpt("rows")) cla.opt("rows")[0] >> rows;
+    if (cla.hasOpt("size")) cla.opt("size")[0] >> size;
+    if (cla.hasOpt("threads")) cla.opt("threads")[0] >> threads;
+
+    Utils::TemporaryFilePath wisdom;
+    FFTEngine& engine(FFTEngine::Instance());
+    engine.setWisdomPath("");
+    ::fftwf_forget_wisdom();
+
+    // Startup latency: the first request measures, a repeat comes from the cache, and a restarted process with
+    // saved wisdom skips the measuring.
+    //
+    Time::TimeStamp start(Time::TimeStamp::Now());
+    FFTEngine::Plan::Ref batch(engine.getPlan(size, rows));
+    ReportPlan("cold plan", (Time::TimeStamp::Now() - start).asDouble());
+
+    start = Time::TimeStamp::Now();
+    engine.getPlan(size, rows);
+    ReportPlan("cached plan", (Time::TimeStamp::Now() - start).asDouble());
+
+    engine.saveWisdom(wisdom);
+    batch.reset();
+    engine.purge();
+    ::fftwf_forget_wisdom();
+
+    start = Time::TimeStamp::Now();
+    engine.loadWisdom(wisdom);
+    batch = engine.getPlan(size, rows);
+    ReportPlan("plan from wisdom", (Time::TimeStamp::Now() - start).asDouble());
+
+    FFTEngine::Plan::Ref single(engine.getPlan(size));
+    FFTEngine::Plan::Ref threaded(engine.getPlan(size, rows, FFTEngine::kForward, FFTEngine::kRows, false, threads));
+
+    FFTEngine::Buffer input(size * rows), output(size * rows);
+    ::srand(1234);
+    for (size_t index = 0; index < input.size(); ++index)
+        input[index] = FFTEngine::Complex(::rand() % 2000 - 1000, ::rand() % 2000 - 1000);
+
+    // Per-transform cost. The single-row plan stands in for an algorithm that runs one FFT per PRI.
+    //
+    size_t points = size_t(size) * rows;
+    start = Time::TimeStamp::Now();
+    for (int pass = 0; pass < iterations; ++pass) {
+        for (int row = 0; row < rows; ++row) single->execute(input.data() + row * size, output.data() + row * size);
+    }
+    ReportRun("row at a time", (Time::TimeStamp::Now() - start).asDouble(), iterations, points);
+
+    start = Time::TimeStamp::Now();
+    for (int pass = 0; pass < iterations; ++pass) batch->execute(input.data(), output.data());
+    ReportRun("batch", (Time::TimeStamp::Now() - start).asDouble(), iterations, points);
+
+    start = Time::TimeStamp::Now();
+    for (int pass = 0; pass < iterations; ++pass) threaded->execute(input.data(), output.data());
+    ReportRun("threaded batch", (Time::TimeStamp::Now() - start).asDouble(), iterations, points);
+
+    std::cout << "size: " << size << " rows: " << rows << " threads: " << threaded->getThreadCount()
+              << " plans: " << engine.getPlanCount() << '\n';
+
+    return 0;
+}
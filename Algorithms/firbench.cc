@@ -0,0 +1,110 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Time/TimeStamp.h"
+#include "Utils/CmdLineArgs.h"
+#include "Utils/Utils.h"
+
+#include "FIRFilter.h"
+
+using namespace SideCar;
+using namespace SideCar::Algorithms;
+
+const std::string about = "Time FIRFilter on one PRI of complex samples against filtering at the full rate and "
+                          "discarding the unwanted outputs, with direct and FFT convolution.";
+
+const Utils::CmdLineArgs::OptionDef opts[] = {
+    {'d', "decimation", "decimation factor (default 4)", "N"},
+    {'k', "taps", "number of filter taps (default 128)", "N"},
+    {'n', "iterations", "number of PRIs to filter (default 2000)", "N"},
+    {'s', "samples", "complex samples per PRI (default 4096)", "N"},
+};
+
+using Complex = FIRFilter::Complex;
+
+/** Full-rate filtering with every output computed, followed by decimation.
+ */
+static void
+FullRate(const std::vector<float>& taps, const std::vector<Complex>& input, size_t decimation,
+         std::vector<Complex>& filtered, std::vector<Complex>& output)
+{
+    size_t count = input.size();
+    filtered.resize(count);
+    for (size_t index = 0; index < count; ++index) {
+        float re = 0.0, im = 0.0;
+        size_t limit = std::min(taps.size(), count - index);
+        for (size_t tap = 0; tap < limit; ++tap) {
+            re += taps[tap] * input[index + tap].real();
+            im += taps[tap] * input[index + tap].imag();
+        }
+        filtered[index] = Complex(re, im);
+    }
+
+    output.clear();
+    for (size_t index = 0; index < count; index += decimation) output.push_back(filtered[index]);
+}
+
+static void
+Report(const char* label, double elapsed, int iterations, size_t outputs)
+{
+    double perPRI = elapsed / iterations;
+    std::cout << std::setw(24) << label << std::fixed << std::setprecision(1) << std::setw(12) << perPRI * 1.0E6
+              << " usecs/PRI " << std::setw(8) << std::setprecision(2) << perPRI * 1.0E9 / outputs
+              << " nsecs/output\n";
+}
+
+int
+main(int argc, char** argv)
+{
+    Utils::CmdLineArgs cla(argc, argv, about, opts, sizeof(opts), 0, 0);
+
+    int decimation = 4, taps = 128, iterations = 2000, samples = 4096;
+    if (cla.hasOpt("decimation")) cla.opt("decimation")[0] >> decimation;
+    if (cla.hasOpt("taps")) cla.opt("taps")[0] >> taps;
+    if (cla.hasOpt("iterations")) cla.opt("iterations")[0] >> iterations;
+    if (cla.hasOpt("samples")) cla.opt("samples")[0] >> samples;
+
+    ::srand(1234);
+    std::vector<float> kernel(taps);
+    for (int index = 0; index < taps; ++index) kernel[index] = (::rand() % 2001 - 1000) / 1000.0f;
+
+    std::vector<Complex> input(samples);
+    for (int index = 0; index < samples; ++index)
+        input[index] = Complex(::rand() % 2000 - 1000, ::rand() % 2000 - 1000);
+
+    FIRFilter direct(kernel, 1, decimation, 0, taps);
+    FIRFilter fft(kernel, 1, decimation, 0, 0);
+    size_t outputs = direct.getOutputSize(samples);
+    std::vector<Complex> filtered, expected, output(outputs);
+
+    Time::TimeStamp start(Time::TimeStamp::Now());
+    for (int pass = 0; pass < iterations; ++pass) FullRate(kernel, input, decimation, filtered, expected);
+    Report("full rate and discard", (Time::TimeStamp::Now() - start).asDouble(), iterations, outputs);
+
+    start = Time::TimeStamp::Now();
+    for (int pass = 0; pass < iterations; ++pass) direct.filter(input.data(), samples, output.data());
+    Report("polyphase direct", (Time::TimeStamp::Now() - start).asDouble(), iterations, outputs);
+
+    double error = 0.0;
+    for (size_t index = 0; index < outputs; ++index)
+        error = std::max(error, double(std::abs(output[index] - expected[index])));
+
+    // Run once to make the plans before timing.
+    //
+    fft.filter(input.data(), samples, output.data());
+    start = Time::TimeStamp::Now();
+    for (int pass = 0; pass < iterations; ++pass) fft.filter(input.data(), samples, output.data());
+    Report("overlap-save FFT", (Time::TimeStamp::Now() - start).asDouble(), iterations, outputs);
+
+    for (size_t index = 0; index < outputs; ++index)
+        error = std::max(error, double(std::abs(output[index] - expected[index])));
+
+    std::cout << "samples: " << samples << " taps: " << taps << " decimation: " << decimation
+              << " max error: " << error << '\n';
+
+    return 0;
+}
@@ -1,5 +1,3 @@
-#include <algorithm>  // for std::transform
-#include <functional> // for std::plus
 #include <math.h>
 
 #include "boost/bind.hpp"
@@ -16,7 +14,8 @@ using namespace SideCar;
 using namespace SideCar::Algorithms;
 
 MofN::MofN(Controller& controller, Logger::Log& log) :
-    Algorithm(controller, log), enabled_(Parameter::BoolValue::Make("enabled", "Enabled", kDefaultEnabled)),
+    Algorithm(controller, log), runningCounts_(), gateCount_(0),
+    enabled_(Parameter::BoolValue::Make("enabled", "Enabled", kDefaultEnabled)),
     numPRIs_(Parameter::PositiveIntValue::Make("numPRIs", "Num PRIs", kDefaultNumPRIs)),
     numGates_(Parameter::PositiveIntValue::Make("numGates", "Num Gates", kDefaultNumGates)),
     threshold_(Threshold::Make("threshold", "Score Threshold", kDefaultThreshold))
@@ -43,29 +42,31 @@ MofN::reset()
     retainedCount_ = 0;
     oldestIndex_ = 0;
     newestIndex_ = 0;
-    runningCounts_.clear();
+    gateCount_ = 0;
+    runningCounts_.resize(0, numPRIs_->getValue() * numGates_->getValue());
     return true;
 }
 
-struct Updater {
-    uint16_t threshold_;
-    MofN::DetectionCountVector::const_iterator del_;
-    MofN::DetectionCountVector::const_iterator add_;
-    Messages::BinaryVideo::Container& out_;
-    Updater(uint16_t threshold, MofN::DetectionCountVector::const_iterator del,
-            MofN::DetectionCountVector::const_iterator add, Messages::BinaryVideo::Container& out) :
-        threshold_(threshold),
-        del_(del), add_(add), out_(out)
-    {
-    }
-
-    MofN::DetectionCountType operator()(MofN::DetectionCountType v)
-    {
-        v += (*add_++ - *del_++);
-        out_.push_back(v >= threshold_);
-        return v;
+void
+MofN::countWindow(Utils::BitCounter& counts)
+{
+    // The window for gate G spans [G - halfWindow, G - halfWindow + numGates). Add one shifted copy of the PRI's
+    // bits for each offset in the window, so that gate G receives the value of gate G + offset.
+    //
+    int numGates = numGates_->getValue();
+    int halfWindow = numGates / 2;
+    counts.resize(gateCount_, numGates);
+    counts.reset();
+    for (int offset = -halfWindow; offset < numGates - halfWindow; ++offset) {
+        shifted_ = bits_;
+        if (offset > 0) {
+            shifted_.shiftDown(offset);
+        } else if (offset < 0) {
+            shifted_.shiftUp(-offset);
+        }
+        counts.add(shifted_);
     }
-};
+}
 
 bool
 MofN::process(const Messages::BinaryVideo::Ref& video)
@@ -75,85 +76,47 @@ MofN::process(const Messages::BinaryVideo::Ref& video)
 
     if (!enabled_->getValue()) { return send(video); }
 
-    // Detect mismatch between current runningCounts_.size() and sample count in the message. Grow
-    // runningCounts_.size() if necessary, but leave the message alone if it is smaller.
+    // Detect mismatch between current gateCount_ and sample count in the message. Grow gateCount_ if necessary,
+    // but leave the message alone if it is smaller. Missing gates count as zeros.
     //
     size_t priLen = video->size();
-    if (runningCounts_.size() < priLen) {
-        runningCounts_.resize(priLen, 0);
-    } else if (runningCounts_.size() > priLen) {
-        LOGWARNING << "incoming message too small - expected: " << runningCounts_.size() << " got: " << priLen
-                   << std::endl;
+    if (gateCount_ < priLen) {
+        gateCount_ = priLen;
+        runningCounts_.resize(gateCount_, numPRIs_->getValue() * numGates_->getValue());
+    } else if (gateCount_ > priLen) {
+        LOGWARNING << "incoming message too small - expected: " << gateCount_ << " got: " << priLen << std::endl;
     }
 
+    video->getBits(bits_);
+    bits_.resize(gateCount_);
+
     // We save the result of counting in the range dimension so that we won't have to repeat the calculation for
-    // subsequent PRIs. We will ultimately keep around vectors for the previous numPRIs PRIs
+    // subsequent PRIs. We will ultimately keep around counts for the previous numPRIs PRIs. Use the oldest + 1 slot
+    // to hold our sample and detection counts. We need the oldest detection counts below to keep our running count
+    // up-to-date so we cannot use that slot yet.
     //
     size_t numPRIs = numPRIs_->getValue();
-    retained_[newestIndex_].video = video;
-
-    // Use the oldest + 1 slot to hold our sample and detection counts. We need the oldest detection counts below to
-    // keep our running count up-to-date so we cannot use that slot yet.
-    //
-    DetectionCountVector& detections(retained_[newestIndex_++].detectionCounts);
+    RetainedEntry& newest(retained_[newestIndex_++]);
     if (newestIndex_ == retained_.size()) { newestIndex_ = 0; }
 
-    detections.resize(runningCounts_.size(), 0);
-
-    // The first stage in the calculation is to count the number of detections within a "numGates" sized window window
-    // around each range cell.
-    //
-    Messages::BinaryVideo::const_iterator videoIter(video->begin());
-    size_t numGates = numGates_->getValue();
-    size_t halfWindow = numGates / 2;
-    size_t gateIndex = 0;
-
-    // Calculate partial windows at the start of the PRI. Update the running counter, but don't record anything get.
-    //
-    DetectionCountType count = 0;
-    while (gateIndex++ < halfWindow) { count += (*videoIter++ ? 1 : 0); }
-
-    // Keep updating the counter, but now we can store the counter results.
-    //
-    DetectionCountVector::iterator detectionsIter(detections.begin());
-    while (gateIndex++ < numGates) {
-        count += (*videoIter++ ? 1 : 0);
-        *detectionsIter++ = count;
-    }
-
-    // Even better -- we can store and remove the oldest sample.
-    //
-    Messages::BinaryVideo::const_iterator oldestIter(video->begin());
-    while (gateIndex++ < priLen) {
-        count += (*videoIter++ ? 1 : 0);
-        *detectionsIter++ = count;
-        count -= (*oldestIter++ ? 1 : 0);
-    }
-
-    // Reached the end of the PRI message. Go back and finish calculating windowed counts. Be careful not to move
-    // beyond the sample data which could happen if priLen < runningCounts_.size()
-    //
-    Messages::BinaryVideo::const_iterator videoEnd(video->end());
-    while (oldestIter < videoEnd) {
-        *detectionsIter++ = count;
-        count -= (*oldestIter++ ? 1 : 0);
-    }
-
-    // Finally, handle the case where priLen < runningCounts_.size(). Just set to zero.
-    //
-    DetectionCountVector::iterator detectionsEnd(detections.end());
-    while (detectionsIter < detectionsEnd) { *detectionsIter++ = 0; }
+    newest.video = video;
+    countWindow(newest.windowCounts);
+    runningCounts_.add(newest.windowCounts);
 
-    // Update the running counts vector with the detections we just calculated. If we don't have a desired number of
-    // PRI messages, then just add the calculated counts for each gate to the running count tally.
+    // If we don't have a desired number of PRI messages, then just keep the tally.
     //
     if (retainedCount_ < numPRIs) {
         ++retainedCount_;
-        std::transform(runningCounts_.begin(), runningCounts_.end(), detections.begin(), runningCounts_.begin(),
-                       std::plus<DetectionCountType>());
         return true;
     }
 
+    // Remove the contribution of the oldest PRI message, which leaves the counts for the last numPRIs messages.
+    //
+    runningCounts_.subtract(retained_[oldestIndex_].windowCounts);
+    retained_[oldestIndex_].video.reset();
+    ++oldestIndex_;
+    if (oldestIndex_ == retained_.size()) { oldestIndex_ = 0; }
+
     // Create a new BinaryVideo message with gate values that are true/false depending on whether the MofN window
     // surrounding the gate has enough ON values to pass a threshold value. Base our outgoing message on the middle
     // message in our MofN window.
@@ -161,19 +124,10 @@ MofN::process(const Messages::BinaryVideo::Ref& video)
     size_t index = (oldestIndex_ + numPRIs / 2);
     if (index >= retained_.size()) { index -= retained_.size(); }
 
-    Messages::BinaryVideo::Ref midPoint((retained_.begin() + index)->video);
+    Messages::BinaryVideo::Ref midPoint(retained_[index].video);
     Messages::BinaryVideo::Ref out(Messages::BinaryVideo::Make(getName(), midPoint));
-    out->reserve(runningCounts_.size());
-
-    // Add the new counts vector to and subtract the oldest counts vector from the running count. A side-effect of this
-    // is that the output message gets the boolean values based on whether the updated sample count values match or
-    // pass thresholdValue_.
-    //
-    std::transform(
-        runningCounts_.begin(), runningCounts_.end(), runningCounts_.begin(),
-        Updater(thresholdValue_, retained_[oldestIndex_].detectionCounts.begin(), detections.begin(), out->getData()));
-    ++oldestIndex_;
-    if (oldestIndex_ == retained_.size()) { oldestIndex_ = 0; }
+    runningCounts_.atLeast(thresholdValue_, bits_);
+    out->setBits(bits_);
 
     LOGDEBUG << *out.get() << std::endl;
     bool rc = send(out);
@@ -186,7 +140,7 @@ void
 MofN::calculateThresholdValue()
 {
     thresholdValue_ =
-        static_cast<uint16_t>(::round(threshold_->getValue() * numPRIs_->getValue() * numGates_->getValue()));
+        static_cast<uint32_t>(::round(threshold_->getValue() * numPRIs_->getValue() * numGates_->getValue()));
 }
 
 void
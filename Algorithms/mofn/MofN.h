@@ -4,6 +4,7 @@
 #include "Algorithms/Algorithm.h"
 #include "Messages/BinaryVideo.h"
 #include "Parameter/Parameter.h"
+#include "Utils/BitVector.h"
 
 namespace SideCar {
 namespace Algorithms {
@@ -18,15 +19,13 @@ namespace Algorithms {
 
 class MofN : public Algorithm {
 public:
-    using DetectionCountType = uint16_t;
-    using DetectionCountVector = std::vector<DetectionCountType>;
-
     /** Internal class that contains data retained between PRI message processing. Holds the binary video PRI
-        message and the detected counts from the PRI message.
+        message and the per-gate detection counts within the range window, stored bit-sliced so that 64 gates are
+        updated with each word operation.
     */
     struct RetainedEntry {
         Messages::BinaryVideo::Ref video;
-        DetectionCountVector detectionCounts;
+        Utils::BitCounter windowCounts;
     };
 
     using RetainedEntryVector = std::vector<RetainedEntry>;
@@ -103,9 +102,24 @@ private:
 
     void calculateThresholdValue();
 
+    /** Calculate the number of detections within the range window around each gate of a PRI.
+
+        \param counts container to hold the results
+    */
+    void countWindow(Utils::BitCounter& counts);
+
     /** Value of the detection counts found for numPRIs_ messages.
      */
-    DetectionCountVector runningCounts_;
+    Utils::BitCounter runningCounts_;
+
+    /** Number of gates held in runningCounts_. Grows to the size of the largest message seen.
+     */
+    size_t gateCount_;
+
+    /** Scratch space for the packed gate values of the latest message, and shifted copies of them.
+     */
+    Utils::BitVector bits_;
+    Utils::BitVector shifted_;
 
     /** Data retained between PRI messages.
      */
@@ -131,7 +145,7 @@ private:
     */
     Threshold::Ref threshold_;
 
-    uint16_t thresholdValue_;
+    uint32_t thresholdValue_;
 };
 
 } // end namespace Algorithms
@@ -1,25 +1,24 @@
 #ifndef SIDECAR_ALGORITHMS_NCINTEGRATE_H // -*- C++ -*-
 #define SIDECAR_ALGORITHMS_NCINTEGRATE_H
 
-#include <vector>
+#include <deque>
 
 #include "Algorithms/Algorithm.h"
-#include "Algorithms/PastBuffer.h"
 #include "Messages/Video.h"
 #include "Parameter/Parameter.h"
 
+#include "PulseRing.h"
+
 namespace SideCar {
 namespace Algorithms {
 
 /** This algorithm averages a block of pulses around the input pulse. It takes the run-time parameter numPulses.
     It waits until it receives 'numPulses' pri's, after which it returns the average of the last 'numPulses'
-    pri's at the output.
-
+    pri's at the output. The running sums live in a PulseRing, so the cost of a PRI does not depend on numPulses.
 */
 class NCIntegrate : public Algorithm {
 public:
     using DatumType = Messages::Video::DatumType;
-    using RunningAverageVector = std::vector<int32_t>;
 
     enum InfoSlot { kNumPRIs = ControllerStatus::kNumSlots, kIQValues, kNumSlots };
 
@@ -86,8 +85,8 @@ private:
     Parameter::BoolValue::Ref enabled_;
     Parameter::BoolValue::Ref iqValues_;
     Parameter::PositiveIntValue::Ref numPulses_;
-    PastBuffer<Messages::Video> in_;
-    RunningAverageVector runningAverage_;
+    std::deque<Messages::Video::Ref> in_;
+    PulseRing ring_;
 };
 
 } // end namespace Algorithms
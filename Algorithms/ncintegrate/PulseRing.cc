@@ -0,0 +1,124 @@
+#include <algorithm>
+#include <cmath>
+
+#include "PulseRing.h"
+
+using namespace SideCar::Algorithms;
+
+/** Rows are padded to a multiple of this many gates so that each one starts on a vector boundary.
+ */
+static const size_t kGateBlock = 16;
+
+PulseRing::PulseRing(size_t capacity, bool iq) :
+    capacity_(0), iq_(iq), size_(0), next_(0), width_(0), stride_(0), rows_(), gateCounts_(), sums_()
+{
+    reset(capacity, iq);
+}
+
+void
+PulseRing::reset(size_t capacity, bool iq)
+{
+    capacity_ = std::max(capacity, size_t(1));
+    iq_ = iq;
+    stride_ = 0;
+    rows_.clear();
+    sums_.clear();
+    clear();
+}
+
+void
+PulseRing::clear()
+{
+    size_ = 0;
+    next_ = 0;
+    width_ = 0;
+    std::fill(rows_.begin(), rows_.end(), 0);
+    std::fill(sums_.begin(), sums_.end(), 0);
+    gateCounts_.assign(capacity_, 0);
+}
+
+void
+PulseRing::widen(size_t gates)
+{
+    // Only happens when a PRI is longer than any before it, so a copy of every row is acceptable.
+    //
+    size_t stride = (gates + kGateBlock - 1) / kGateBlock * kGateBlock;
+    std::vector<uint32_t> rows(capacity_ * stride, 0);
+    for (size_t row = 0; row < capacity_; ++row) {
+        std::copy(rows_.begin() + row * stride_, rows_.begin() + (row + 1) * stride_, rows.begin() + row * stride);
+    }
+
+    rows_.swap(rows);
+    sums_.resize(stride, 0);
+    stride_ = stride;
+}
+
+void
+PulseRing::add(const int16_t* samples, size_t count)
+{
+    size_t gates = iq_ ? count / 2 : count;
+    if (gates > stride_) widen(gates);
+
+    uint32_t* row = rows_.data() + next_ * stride_;
+    uint32_t* sums = sums_.data();
+
+    // Replace the oldest row and update the sums in one pass. A row not yet used holds zeros, so filling the ring
+    // needs no special case.
+    //
+    if (iq_) {
+        for (size_t gate = 0; gate < gates; ++gate) {
+            int32_t i = samples[2 * gate];
+            int32_t q = samples[2 * gate + 1];
+            uint32_t value = uint32_t(i * i) + uint32_t(q * q);
+            sums[gate] += value - row[gate];
+            row[gate] = value;
+        }
+    } else {
+        for (size_t gate = 0; gate < gates; ++gate) {
+            uint32_t value = uint32_t(int32_t(samples[gate]));
+            sums[gate] += value - row[gate];
+            row[gate] = value;
+        }
+    }
+
+    // Remove any gates of the old row past the end of the new one.
+    //
+    for (size_t gate = gates; gate < gateCounts_[next_]; ++gate) {
+        sums[gate] -= row[gate];
+        row[gate] = 0;
+    }
+
+    gateCounts_[next_] = gates;
+    next_ = (next_ + 1) % capacity_;
+    size_ = std::min(size_ + 1, capacity_);
+    width_ = *std::max_element(gateCounts_.begin(), gateCounts_.end());
+}
+
+void
+PulseRing::average(int16_t* output) const
+{
+    // Multiply by the reciprocal in double precision and let the conversion to int32_t truncate. The error of the
+    // product is far less than 1 / N, so nudging it by half of that toward larger magnitudes gives the same result
+    // as integer division, even when the division is exact. Unlike integer division, this vectorizes.
+    //
+    const uint32_t* sums = sums_.data();
+    uint32_t half = uint32_t(size_ / 2);
+    double reciprocal = 1.0 / double(size_);
+    double nudge = 0.5 * reciprocal;
+    if (iq_) {
+        for (size_t gate = 0; gate < width_; ++gate) {
+            double sum = double(int32_t(sums[gate] + half));
+            double power = double(int32_t(sum * reciprocal + std::copysign(nudge, sum)));
+
+            // No square root of an integer lies halfway between two integers, so adding 0.5 and truncating rounds
+            // the same way as std::round().
+            //
+            output[gate] = power > 0.0 ? int16_t(int32_t(std::sqrt(power) + 0.5)) : 0;
+        }
+    } else {
+        for (size_t gate = 0; gate < width_; ++gate) {
+            double sum = double(int32_t(sums[gate] + half));
+            output[gate] = int16_t(int32_t(sum * reciprocal + std::copysign(nudge, sum)));
+        }
+    }
+}
@@ -0,0 +1,96 @@
+#ifndef SIDECAR_ALGORITHMS_NCINTEGRATE_PULSERING_H // -*- C++ -*-
+#define SIDECAR_ALGORITHMS_NCINTEGRATE_PULSERING_H
+
+#include <cstdint>
+#include <vector>
+
+namespace SideCar {
+namespace Algorithms {
+
+/** Running integration of the last N PRIs. Rows of per-gate values live in one preallocated ring, and a row of
+    32-bit sums holds their total. Adding a PRI overwrites the oldest row and updates the sums in the same pass, so
+    the cost of a PRI does not depend on N. For I/Q data the stored value of a gate is I * I + Q * Q, and the
+    average is the rounded square root of the mean power.
+
+    The sums wrap modulo 2^32 like the int32 arithmetic they replace, and the average of a gate is computed as
+    (sum + N / 2) / N with the quotient truncated toward zero.
+
+    PRIs may differ in length. Gates past the end of a PRI count as zero, and averages cover the longest PRI still
+    in the ring.
+*/
+class PulseRing {
+public:
+    /** Constructor.
+
+        \param capacity number of PRIs to integrate
+
+        \param iq true if PRIs hold interleaved I and Q values
+    */
+    explicit PulseRing(size_t capacity = 1, bool iq = false);
+
+    /** Drop all rows and set the integration parameters.
+
+        \param capacity number of PRIs to integrate
+
+        \param iq true if PRIs hold interleaved I and Q values
+    */
+    void reset(size_t capacity, bool iq);
+
+    /** Drop all rows.
+     */
+    void clear();
+
+    size_t getCapacity() const { return capacity_; }
+
+    bool isIQ() const { return iq_; }
+
+    /** Obtain the number of PRIs in the ring.
+
+        \return row count
+    */
+    size_t size() const { return size_; }
+
+    bool full() const { return size_ == capacity_; }
+
+    /** Obtain the number of gates in the longest PRI in the ring. This is the number of averages that average()
+        writes.
+
+        \return gate count
+    */
+    size_t getWidth() const { return width_; }
+
+    /** Add a PRI, replacing the oldest one if the ring is full.
+
+        \param samples sample values, or interleaved I and Q values
+
+        \param count number of values in \p samples
+    */
+    void add(const int16_t* samples, size_t count);
+
+    /** Write the average of each gate over the PRIs in the ring.
+
+        \param output buffer for getWidth() values
+    */
+    void average(int16_t* output) const;
+
+private:
+    void widen(size_t gates);
+
+    size_t capacity_;
+    bool iq_;
+    size_t size_;
+    size_t next_;
+    size_t width_;
+    size_t stride_;
+    std::vector<uint32_t> rows_;
+    std::vector<uint32_t> gateCounts_;
+    std::vector<uint32_t> sums_;
+};
+
+} // end namespace Algorithms
+} // end namespace SideCar
+
+/** \file
+ */
+
+#endif
@@ -0,0 +1,118 @@
+#include <cmath>
+#include <cstdlib>
+#include <deque>
+#include <vector>
+
+#include "UnitTest/UnitTest.h"
+
+#include "PulseRing.h"
+
+using namespace SideCar::Algorithms;
+
+struct Test : public UnitTest::TestObj {
+    Test() : TestObj("PulseRing") {}
+
+    void test();
+};
+
+using Samples = std::vector<int16_t>;
+
+/** The integration that NCIntegrate did before PulseRing: zero-pad every retained PRI to the longest one, then sum
+    in int32 and divide with rounding.
+*/
+static Samples
+Reference(const std::deque<Samples>& pris, bool iq)
+{
+    size_t width = 0;
+    for (const Samples& pri : pris) width = std::max(width, iq ? pri.size() / 2 : pri.size());
+
+    int32_t size = pris.size();
+    Samples output;
+    for (size_t gate = 0; gate < width; ++gate) {
+        uint32_t sum = 0;
+        for (const Samples& pri : pris) {
+            if (iq) {
+                if (2 * gate + 1 >= pri.size()) continue;
+                int32_t i = pri[2 * gate], q = pri[2 * gate + 1];
+                sum += uint32_t(i * i) + uint32_t(q * q);
+            } else if (gate < pri.size()) {
+                sum += uint32_t(int32_t(pri[gate]));
+            }
+        }
+
+        int32_t value = int32_t(sum + size / 2) / size;
+        if (iq) value = value > 0 ? int32_t(::round(::sqrt(value))) : 0;
+        output.push_back(int16_t(value));
+    }
+
+    return output;
+}
+
+void
+Test::test()
+{
+    ::srand(1234);
+
+    // Rounding of a simple average.
+    //
+    {
+        PulseRing ring(3);
+        const int16_t a[] = {1, -5, 100}, b[] = {2, -5, 100}, c[] = {4, -6, 101};
+        ring.add(a, 3);
+        ring.add(b, 3);
+        assertFalse(ring.full());
+        ring.add(c, 3);
+        assertTrue(ring.full());
+        int16_t output[3];
+        ring.average(output);
+        assertEqual(int16_t(2), output[0]);
+        assertEqual(int16_t(-5), output[1]);
+        assertEqual(int16_t(100), output[2]);
+    }
+
+    // Random PRIs of varying length, for both sample kinds and several ring sizes, match the reference.
+    //
+    for (int iq = 0; iq < 2; ++iq) {
+        for (size_t capacity : {2, 3, 7, 16}) {
+            PulseRing ring(capacity, iq);
+            std::deque<Samples> pris;
+            for (int pass = 0; pass < 100; ++pass) {
+                Samples pri((iq ? 2 : 1) * (::rand() % 40));
+                for (auto& value : pri) value = ::rand() % 65536 - 32768;
+                ring.add(pri.data(), pri.size());
+                pris.push_front(pri);
+                if (pris.size() > capacity) pris.pop_back();
+
+                assertEqual(pris.size(), ring.size());
+                Samples expected(Reference(pris, iq));
+                assertEqual(expected.size(), ring.getWidth());
+                Samples output(ring.getWidth());
+                ring.average(output.data());
+                for (size_t gate = 0; gate < output.size(); ++gate) assertEqual(expected[gate], output[gate]);
+            }
+        }
+    }
+
+    // Clearing drops all rows.
+    //
+    {
+        PulseRing ring(2, true);
+        const int16_t a[] = {3, 4, 6, 8};
+        ring.add(a, 4);
+        ring.clear();
+        assertEqual(size_t(0), ring.size());
+        assertEqual(size_t(0), ring.getWidth());
+        ring.add(a, 4);
+        ring.add(a, 4);
+        int16_t output[2];
+        ring.average(output);
+        assertEqual(int16_t(5), output[0]);
+        assertEqual(int16_t(10), output[1]);
+    }
+}
+
+int
+main(int, const char**)
+{
+    return Test().mainRun();
+}
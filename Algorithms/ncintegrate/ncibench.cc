@@ -0,0 +1,119 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Time/TimeStamp.h"
+#include "Utils/CmdLineArgs.h"
+#include "Utils/Utils.h"
+
+#include "PulseRing.h"
+
+using namespace SideCar;
+using namespace SideCar::Algorithms;
+
+const std::string about = "Time non-coherent integration of N PRIs with PulseRing and with the padded message queue "
+                          "and int32 running sum that NCIntegrate used before it, for N from 2 to 128.";
+
+const Utils::CmdLineArgs::OptionDef opts[] = {
+    {'g', "gates", "gates per PRI (default 4096)", "N"},
+    {'i', "iq", "PRIs hold I/Q values", 0},
+    {'n', "iterations", "number of PRIs to integrate (default 5000)", "N"},
+};
+
+using Samples = std::vector<int16_t>;
+
+/** The integration NCIntegrate did before PulseRing: a queue of the last N PRIs, a running int32 sum, and an
+    output built with push_back.
+*/
+struct Before {
+    Before(size_t capacity, bool iq) : capacity_(capacity), iq_(iq), queue_(), sums_() {}
+
+    static int32_t Power(const int16_t* iq) { return int32_t(iq[0]) * iq[0] + int32_t(iq[1]) * iq[1]; }
+
+    void add(const Samples& pri, Samples& out)
+    {
+        size_t gates = iq_ ? pri.size() / 2 : pri.size();
+        sums_.resize(std::max(sums_.size(), gates), 0);
+        queue_.push_front(pri);
+        if (queue_.size() <= capacity_) {
+            for (size_t gate = 0; gate < gates; ++gate) sums_[gate] += iq_ ? Power(&pri[2 * gate]) : pri[gate];
+            if (queue_.size() < capacity_) return;
+        } else {
+            const Samples& gone(queue_.back());
+            for (size_t gate = 0; gate < gates; ++gate) {
+                sums_[gate] += iq_ ? Power(&pri[2 * gate]) - Power(&gone[2 * gate]) : pri[gate] - gone[gate];
+            }
+            queue_.pop_back();
+        }
+
+        int32_t size = capacity_, half = size / 2;
+        out.clear();
+        for (size_t gate = 0; gate < sums_.size(); ++gate) {
+            int32_t value = (sums_[gate] + half) / size;
+            out.push_back(iq_ ? int32_t(::round(::sqrt(value))) : value);
+        }
+    }
+
+    size_t capacity_;
+    bool iq_;
+    std::deque<Samples> queue_;
+    std::vector<int32_t> sums_;
+};
+
+static void
+Report(size_t pulses, double before, double after, int iterations, size_t gates)
+{
+    double scale = 1.0E9 / (double(iterations) * gates);
+    std::cout << std::setw(8) << pulses << std::fixed << std::setprecision(2) << std::setw(14) << before * scale
+              << std::setw(14) << after * scale << std::setw(10) << before / after << "x\n";
+}
+
+int
+main(int argc, char** argv)
+{
+    Utils::CmdLineArgs cla(argc, argv, about, opts, sizeof(opts), 0, 0);
+
+    int gates = 4096, iterations = 5000;
+    bool iq = cla.hasOpt("iq");
+    if (cla.hasOpt("gates")) cla.opt("gates")[0] >> gates;
+    if (cla.hasOpt("iterations")) cla.opt("iterations")[0] >> iterations;
+
+    // A pool of PRIs to cycle through, each carrying its own copy as the algorithm would receive it.
+    //
+    ::srand(1234);
+    std::vector<Samples> pool(64, Samples((iq ? 2 : 1) * gates));
+    for (auto& pri : pool) {
+        for (auto& value : pri) value = ::rand() % 2000 - 1000;
+    }
+
+    std::cout << std::setw(8) << "pulses" << std::setw(14) << "before ns/gate" << std::setw(14) << "ring ns/gate"
+              << std::setw(11) << "speedup" << '\n';
+
+    Samples output;
+    for (size_t pulses = 2; pulses <= 128; pulses *= 2) {
+        Before before(pulses, iq);
+        Time::TimeStamp start(Time::TimeStamp::Now());
+        for (int pass = 0; pass < iterations; ++pass) before.add(pool[pass % pool.size()], output);
+        double beforeElapsed = (Time::TimeStamp::Now() - start).asDouble();
+
+        PulseRing ring(pulses, iq);
+        start = Time::TimeStamp::Now();
+        for (int pass = 0; pass < iterations; ++pass) {
+            const Samples& pri(pool[pass % pool.size()]);
+            ring.add(pri.data(), pri.size());
+            if (ring.full()) {
+                output.resize(ring.getWidth());
+                ring.average(output.data());
+            }
+        }
+
+        Report(pulses, beforeElapsed, (Time::TimeStamp::Now() - start).asDouble(), iterations, gates);
+    }
+
+    return 0;
+}
@@ -0,0 +1,156 @@
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "Threading/Threading.h"
+#include "Time/TimeStamp.h"
+#include "Utils/CmdLineArgs.h"
+#include "Utils/LatencyHistogram.h"
+#include "Utils/Snapshot.h"
+#include "Utils/Utils.h"
+
+#include "FFTEngine.h"
+#include "ParameterStager.h"
+
+using namespace SideCar;
+using namespace SideCar::Algorithms;
+
+const std::string about = "Time messages on a processing thread while another thread sweeps its FFT size, with the "
+                          "new plans built on the processing thread as before, or staged by ParameterStager and "
+                          "adopted through a Utils::Snapshot.";
+
+const Utils::CmdLineArgs::OptionDef opts[] = {
+    {'d', "duration", "seconds to run each mode (default 5)", "N"},
+    {'p', "period", "milliseconds between parameter changes (default 20)", "N"},
+    {'w', "windows", "FFT windows per message (default 4)", "N"},
+};
+
+/** FFT plans for one size, as an algorithm would derive them from its fftSize parameter.
+ */
+struct Setup {
+    Setup(int size) :
+        size(size), fwd(FFTEngine::Instance().getPlan(size, 1, FFTEngine::kForward, FFTEngine::kRows, true)),
+        inv(FFTEngine::Instance().getPlan(size, 1, FFTEngine::kInverse, FFTEngine::kRows, true))
+    {
+    }
+
+    int size;
+    FFTEngine::Plan::Ref fwd;
+    FFTEngine::Plan::Ref inv;
+};
+
+using SetupSnapshot = Utils::Snapshot<Setup>;
+
+/** Stand-in for the control path: changes the value of the parameter every so often.
+ */
+struct Sweeper : public Threading::Thread {
+    Sweeper(std::atomic<int>& value, int first, double period) :
+        Thread(), value_(value), first_(first), period_(period), stop_(false)
+    {
+    }
+
+    void run()
+    {
+        // Sizes with many small factors other than 2 take FFTW the longest to plan. Each one is new to the
+        // process, so every change forces real planning.
+        //
+        for (int step = 1; !stop_; ++step) {
+            Threading::Thread::Sleep(period_);
+            value_ = first_ + 12 * step;
+        }
+    }
+
+    std::atomic<int>& value_;
+    int first_;
+    double period_;
+    std::atomic<bool> stop_;
+};
+
+static void
+Report(const char* label, const Utils::LatencyHistogram& histogram)
+{
+    std::cout << std::setw(10) << label << std::fixed << std::setprecision(1) << " mean " << std::setw(8)
+              << histogram.getMeanValue() << " p50 " << std::setw(8) << histogram.getValueAtPercentile(50.0)
+              << " p99 " << std::setw(8) << histogram.getValueAtPercentile(99.0) << " p99.9 " << std::setw(8)
+              << histogram.getValueAtPercentile(99.9) << " max " << std::setw(8) << histogram.getMaximumValue()
+              << " usecs\n";
+}
+
+/** Process messages while a Sweeper changes the FFT size.
+
+    \param staged if true, build plans with ParameterStager; otherwise build them on the processing thread
+
+    \param first first size of the sweep, distinct between modes so that neither finds the other's plans cached
+*/
+static void
+Run(bool staged, int first, double duration, double period, int windows)
+{
+    std::atomic<int> parameter(first);
+    SetupSnapshot snapshot(SetupSnapshot::Ref(new Setup(first)));
+    int seen = first;
+    FFTEngine::Buffer buffer(first);
+    for (size_t index = 0; index < buffer.size(); ++index) buffer[index] = FFTEngine::Complex(index % 7, index % 5);
+
+    Sweeper sweeper(parameter, first, period);
+    sweeper.start();
+
+    Utils::LatencyHistogram histogram;
+    int changes = 0;
+    Time::TimeStamp end(Time::TimeStamp::Now());
+    end += Time::TimeStamp(duration);
+    for (Time::TimeStamp start(Time::TimeStamp::Now()); start < end; start = Time::TimeStamp::Now()) {
+        // A change of the parameter arrives between messages, as a control message would.
+        //
+        int value = parameter;
+        if (value != seen) {
+            seen = value;
+            ++changes;
+            if (staged) {
+                ParameterStager::Instance().submit(&snapshot, [&snapshot, value]() {
+                    snapshot.publish(SetupSnapshot::Ref(new Setup(value)));
+                });
+            } else {
+                snapshot.publish(SetupSnapshot::Ref(new Setup(value)));
+            }
+        }
+
+        if (snapshot.update()) buffer.resize(snapshot.get()->size);
+
+        const Setup& setup(*snapshot.get());
+        for (int window = 0; window < windows; ++window) {
+            setup.fwd->execute(buffer.data());
+            setup.inv->execute(buffer.data());
+        }
+
+        histogram.addSeconds((Time::TimeStamp::Now() - start).asDouble());
+    }
+
+    sweeper.stop_ = true;
+    sweeper.join();
+    ParameterStager::Instance().cancel(&snapshot);
+
+    Report(staged ? "staged" : "inline", histogram);
+    std::cout << std::setw(10) << "" << " messages " << histogram.getCount() << " changes " << changes << " adopted "
+              << snapshot.getVersion() - 1 << '\n';
+}
+
+int
+main(int argc, char** argv)
+{
+    Utils::CmdLineArgs cla(argc, argv, about, opts, sizeof(opts), 0, 0);
+
+    int duration = 5, period = 20, windows = 4;
+    if (cla.hasOpt("duration")) cla.opt("duration")[0] >> duration;
+    if (cla.hasOpt("period")) cla.opt("period")[0] >> period;
+    if (cla.hasOpt("windows")) cla.opt("windows")[0] >> windows;
+
+    // Keep the sweep from persisting wisdom, which would make later runs plan instantly.
+    //
+    FFTEngine::Instance().setWisdomPath("");
+
+    Run(false, 1200, duration, period / 1000.0, windows);
+    Run(true, 1206, duration, period / 1000.0, windows);
+    return 0;
+}
@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Time/TimeStamp.h"
+#include "Utils/CmdLineArgs.h"
+#include "Utils/Utils.h"
+
+#include "VideoTile.h"
+
+using namespace SideCar;
+using namespace SideCar::Algorithms;
+
+const std::string about = "Time the Despeckle median and variance of a PRI computed with VideoTile against "
+                          "gathering and sorting the neighbourhood of each gate in turn.";
+
+const Utils::CmdLineArgs::OptionDef opts[] = {
+    {'g', "gates", "gates per PRI (default 4096)", "N"},
+    {'n', "iterations", "number of PRIs to process (default 2000)", "N"},
+    {'r', "radius", "neighbourhood half-width in gates (default 1)", "N"},
+};
+
+using Samples = std::vector<int16_t>;
+
+/** Median and variance of each gate found the way Despeckle used to: copy the neighbourhood of a gate from the
+    PRIs before and after into a small array, sort it, and take the middle.
+*/
+static void
+PerGate(const Samples& in0, const Samples& in2, size_t radius, std::vector<float>& median,
+        std::vector<float>& variance)
+{
+    long gates = in0.size();
+    std::vector<int16_t> sort;
+    for (long gate = 0; gate < gates; ++gate) {
+        sort.clear();
+        for (long offset = -long(radius); offset <= long(radius); ++offset) {
+            long index = gate + offset;
+            bool inside = index >= 0 && index < gates;
+            sort.push_back(inside ? in2[index] : 0);
+            sort.push_back(inside ? in0[index] : 0);
+        }
+
+        std::sort(sort.begin(), sort.end());
+        size_t middle = sort.size() / 2;
+        float value = (sort[middle - 1] + sort[middle]) * 0.5f;
+        median[gate] = value;
+
+        float sum = 0.0;
+        for (int16_t sample : sort) sum += (sample - value) * (sample - value);
+        variance[gate] = sum;
+    }
+}
+
+static void
+Report(const char* label, double elapsed, int iterations, size_t gates)
+{
+    double perPRI = elapsed / iterations;
+    std::cout << std::setw(24) << label << std::fixed << std::setprecision(1) << std::setw(12) << perPRI * 1.0E6
+              << " usecs/PRI " << std::setw(8) << std::setprecision(2) << perPRI * 1.0E9 / gates
+              << " nsecs/gate\n";
+}
+
+int
+main(int argc, char** argv)
+{
+    Utils::CmdLineArgs cla(argc, argv, about, opts, sizeof(opts), 0, 0);
+
+    int gates = 4096, iterations = 2000, radius = 1;
+    if (cla.hasOpt("gates")) cla.opt("gates")[0] >> gates;
+    if (cla.hasOpt("iterations")) cla.opt("iterations")[0] >> iterations;
+    if (cla.hasOpt("radius")) cla.opt("radius")[0] >> radius;
+
+    ::srand(1234);
+    std::vector<Samples> pris(3, Samples(gates));
+    for (auto& pri : pris) {
+        for (auto& value : pri) value = ::rand() % 10 ? ::rand() % 200 : ::rand() % 3000;
+    }
+
+    VideoTile tile(3, radius);
+    for (const auto& pri : pris) tile.add(pri.data(), pri.size());
+
+    std::vector<size_t> ages;
+    ages.push_back(0);
+    ages.push_back(2);
+
+    std::vector<float> expectedMedian(gates), expectedVariance(gates), median(gates), variance(gates);
+
+    Time::TimeStamp start(Time::TimeStamp::Now());
+    for (int pass = 0; pass < iterations; ++pass) PerGate(pris[2], pris[0], radius, expectedMedian, expectedVariance);
+    Report("per-gate sort", (Time::TimeStamp::Now() - start).asDouble(), iterations, gates);
+
+    start = Time::TimeStamp::Now();
+    for (int pass = 0; pass < iterations; ++pass) {
+        tile.median(ages, radius, median.data());
+        tile.squaredDeviation(ages, radius, median.data(), variance.data());
+    }
+    Report("VideoTile", (Time::TimeStamp::Now() - start).asDouble(), iterations, gates);
+
+    // The medians must match exactly. The variances are sums taken in a different order, so compare them relatively.
+    //
+    int mismatches = 0;
+    double error = 0.0;
+    for (int gate = 0; gate < gates; ++gate) {
+        if (median[gate] != expectedMedian[gate]) ++mismatches;
+        double scale = std::max(1.0f, expectedVariance[gate]);
+        error = std::max(error, std::abs(variance[gate] - expectedVariance[gate]) / scale);
+    }
+
+    std::cout << "gates: " << gates << " radius: " << radius << " median mismatches: " << mismatches
+              << " max variance error: " << error << '\n';
+
+    return 0;
+}
@@ -23,6 +23,7 @@ struct ConfigurationTests : public UnitTest::ProcSuite<ConfigurationTests> {
         add("InvalidRadar", &ConfigurationTests::testInvalidRadar);
         add("MissingDP", &ConfigurationTests::testMissingDP);
         add("InvalidIncludes", &ConfigurationTests::testIncludes);
+        add("Snapshot", &ConfigurationTests::testSnapshot);
     }
 
     void testLoadConfig();
@@ -34,6 +35,7 @@ struct ConfigurationTests : public UnitTest::ProcSuite<ConfigurationTests> {
     void testInvalidRadar();
     void testMissingDP();
     void testIncludes();
+    void testSnapshot();
 };
 
 void
@@ -361,6 +363,104 @@ ConfigurationTests::testIncludes()
     assertEqual(1, runnerConfig->getStreamNodes().size());
 }
 
+void
+ConfigurationTests::testSnapshot()
+{
+    Utils::TemporaryFilePath mainFilePath;
+    Utils::TemporaryFilePath streamFilePath;
+    Utils::TemporaryFilePath snapshotFilePath;
+    {
+        std::ofstream os(mainFilePath.filePath().c_str());
+        os << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+           << "<sidecar>\n"
+           << " <radar>\n"
+           << "  <name>Radar</name>\n"
+           << "  <gateCountMax type=\"int\">2468</gateCountMax>\n"
+           << "  <shaftEncodingMax type=\"int\">65535</shaftEncodingMax>\n"
+           << "  <rotationRate units=\"rpm\" type=\"double\">6</rotationRate>\n"
+           << "  <rangeMin units=\"km\" type=\"double\">0.0</rangeMin>\n"
+           << "  <rangeMax units=\"km\" type=\"double\">300.0</rangeMax>\n"
+           << "  <beamWidth units=\"radians\" type=\"double\">0.01</beamWidth>\n"
+           << " </radar>\n"
+           << " <dp recordingsDirectory=\"/a/b\" logsDirectory=\"/c\">\n"
+           << "  <runner name=\"A\" host=\"alpha\" multicast=\"237.1.2.101\">\n"
+           << "   <stream file=\"" << streamFilePath << "\"/>\n"
+           << "   <stream name=\"Two\">\n"
+           << "    <subscriber name=\"Bye\"/>\n"
+           << "   </stream>\n"
+           << "  </runner>\n"
+           << "  <runner name=\"B\" host=\"beta\">\n"
+           << "   <stream name=\"Three\">\n"
+           << "    <subscriber name=\"Hi\"/>\n"
+           << "   </stream>\n"
+           << "  </runner>\n"
+           << " </dp>\n"
+           << "</sidecar>\n";
+    }
+
+    {
+        std::ofstream os(streamFilePath.filePath().c_str());
+        os << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+           << "<stream name=\"One\">\n"
+           << " <algorithm dll=\"Foo\">\n"
+           << "  <param name=\"x\" type=\"int\" value=\"3\"/>\n"
+           << " </algorithm>\n"
+           << "</stream>\n";
+    }
+
+    QString configurationPath(QString::fromStdString(mainFilePath));
+    QString snapshotPath(QString::fromStdString(snapshotFilePath));
+
+    Loader loader;
+    assertFalse(loader.saveSnapshot("A", snapshotPath));
+    assertTrue(loader.load(configurationPath));
+    assertFalse(loader.saveSnapshot("C", snapshotPath));
+    assertTrue(loader.saveSnapshot("A", snapshotPath));
+
+    // A snapshot restores just the one runner, with its include files already resolved.
+    //
+    RadarConfig::Load("", 10, 10, 6.0, 0.0, 10.0, 0.01);
+    Loader restored;
+    assertTrue(restored.loadSnapshot(configurationPath, "A", snapshotPath));
+    assertEqual(Loader::kOK, restored.getLastLoadResult());
+    assertEqual(2468, int(RadarConfig::GetGateCountMax()));
+    assertEqual(1, restored.getRunnerConfigs().size());
+    assertEqual("/a/b", restored.getRecordingsDirectory().toStdString());
+    assertEqual("/c", restored.getLogsDirectory().toStdString());
+    assertEqual(loader.getIncludePaths().size(), restored.getIncludePaths().size());
+
+    const RunnerConfig* runnerConfig = restored.getRunnerConfig("A");
+    assertTrue(runnerConfig != 0);
+    assertEqual(std::string("alpha"), runnerConfig->getHostName().toStdString());
+    assertEqual(std::string("237.1.2.101"), runnerConfig->getMulticastAddress().toStdString());
+    assertEqual(loader.getRunnerConfig("A")->getServiceName().toStdString(),
+                runnerConfig->getServiceName().toStdString());
+    assertEqual(2, runnerConfig->getStreamNodes().size());
+    QDomElement stream = runnerConfig->getStreamNodes()[0];
+    assertEqual(std::string("One"), stream.attribute("name").toStdString());
+    QDomElement param = stream.firstChildElement("algorithm").firstChildElement("param");
+    assertEqual(std::string("3"), param.attribute("value").toStdString());
+    assertEqual(std::string("Two"), runnerConfig->getStreamNodes()[1].attribute("name").toStdString());
+
+    // The snapshot only serves the runner and configuration it was made from.
+    //
+    assertFalse(restored.loadSnapshot(configurationPath, "B", snapshotPath));
+    assertEqual(Loader::kStaleSnapshot, restored.getLastLoadResult());
+    assertEqual(0, restored.getRunnerConfigs().size());
+    assertFalse(restored.loadSnapshot(QString::fromStdString(streamFilePath), "A", snapshotPath));
+    assertFalse(restored.loadSnapshot(configurationPath, "A", snapshotPath + ".missing"));
+
+    // Any change to an include file makes the snapshot stale.
+    //
+    {
+        std::ofstream os(streamFilePath.filePath().c_str(), std::ios::app);
+        os << "\n";
+    }
+
+    assertFalse(restored.loadSnapshot(configurationPath, "A", snapshotPath));
+    assertEqual(Loader::kStaleSnapshot, restored.getLastLoadResult());
+}
+
 int
 main(int argc, const char* argv[])
 {
@@ -1,8 +1,13 @@
+#include <cstdio>
+
+#include "QtCore/QDataStream"
+#include "QtCore/QDateTime"
 #include "QtCore/QDir"
 #include "QtCore/QFile"
 #include "QtCore/QFileInfo"
 #include "QtCore/QString"
 #include "QtCore/QStringList"
+#include "QtCore/QTextStream"
 #include "QtXml/QDomDocument"
 #include "QtXml/QDomElement"
 
@@ -40,6 +45,13 @@ static const char* const kAttributeCpuAffinity = "cpu";
 static const char* const kAttributeInitialProcessingState = "state";
 static const char* const kEntityStream = "stream";
 
+static const quint32 kSnapshotMagic = 0x53435253; // "SCRS"
+static const quint32 kSnapshotVersion = 2;
+
+/** Kinds of nodes held in a snapshot. Comments and processing instructions are left out.
+ */
+enum SnapshotNode { kSnapshotElement = 1, kSnapshotText };
+
 static QString
 expandEnvVars(const QString& val)
 {
@@ -50,13 +62,45 @@ expandEnvVars(const QString& val)
 /** Private implementation class the performs the work for the Loader class.
  */
 struct Loader::Private {
+    /** Identity of a file that went into the configuration, used to tell whether a snapshot is out of date.
+     */
+    struct Source {
+        Source() : path(), size(-1), modified(-1) {}
+        Source(const QString& p);
+        bool isCurrent() const { return Source(path) == *this; }
+        bool operator==(const Source& rhs) const
+        {
+            return path == rhs.path && size == rhs.size && modified == rhs.modified;
+        }
+        void write(QDataStream& os) const { os << path << size << modified; }
+        void read(QDataStream& is) { is >> path >> size >> modified; }
+
+        QString path;
+        qint64 size;
+        qint64 modified;
+    };
+
     static Logger::Log& Log();
 
+    static QString ToText(const QDomElement& element);
+
+    static void WriteElement(QDataStream& os, const QDomElement& element);
+
+    static QDomElement ReadElement(QDataStream& is);
+
+    static QDomElement ReadElement(QDataStream& is, QDomDocument& doc, int depth);
+
     Private(const Loader& parent);
 
     bool loadRadarConfig(const QString& configurationPath);
 
-    bool load(const QString& configurationPath);
+    bool load(const QString& configurationPath, bool applyRadarConfig);
+
+    bool loadSnapshot(const QString& configurationPath, const QString& runnerName, const QString& snapshotPath);
+
+    bool saveSnapshot(const QString& runnerName, const QString& snapshotPath) const;
+
+    bool rejectSnapshot(const QString& reason);
 
     void updateInit(RunnerConfig::Init& cfg, QDomElement xml);
 
@@ -85,8 +129,19 @@ struct Loader::Private {
     QString initialProcessingState_;
     QStringList includePaths_;
     QStringList hostNames_;
+    QDomElement radar_;
+    QList<Source> sources_;
 };
 
+Loader::Private::Source::Source(const QString& p) : path(QFileInfo(p).absoluteFilePath()), size(-1), modified(-1)
+{
+    QFileInfo info(path);
+    if (info.exists()) {
+        size = info.size();
+        modified = info.lastModified().toMSecsSinceEpoch();
+    }
+}
+
 Logger::Log&
 Loader::Private::Log()
 {
@@ -94,6 +149,95 @@ Loader::Private::Log()
     return log_;
 }
 
+QString
+Loader::Private::ToText(const QDomElement& element)
+{
+    QString text;
+    QTextStream os(&text, QIODevice::WriteOnly);
+    element.save(os, 0);
+    return text;
+}
+
+void
+Loader::Private::WriteElement(QDataStream& os, const QDomElement& element)
+{
+    // Write the element already parsed, so that loadSnapshot() rebuilds it without running the XML parser.
+    //
+    os << element.tagName();
+    QDomNamedNodeMap attributes(element.attributes());
+    os << quint32(attributes.count());
+    for (int index = 0; index < attributes.count(); ++index) {
+        QDomAttr attribute(attributes.item(index).toAttr());
+        os << attribute.name() << attribute.value();
+    }
+
+    QList<QDomNode> children;
+    for (QDomNode child = element.firstChild(); !child.isNull(); child = child.nextSibling()) {
+        if (child.isElement() || child.isCharacterData()) children.append(child);
+    }
+
+    os << quint32(children.size());
+    foreach (const QDomNode& child, children) {
+        if (child.isElement()) {
+            os << quint8(kSnapshotElement);
+            WriteElement(os, child.toElement());
+        } else {
+            os << quint8(kSnapshotText) << child.nodeValue();
+        }
+    }
+}
+
+QDomElement
+Loader::Private::ReadElement(QDataStream& is)
+{
+    QDomDocument doc;
+    QDomElement element = ReadElement(is, doc, 0);
+    if (!element.isNull()) doc.appendChild(element);
+    return element;
+}
+
+QDomElement
+Loader::Private::ReadElement(QDataStream& is, QDomDocument& doc, int depth)
+{
+    // Guard against a damaged file sending us down without end.
+    //
+    static const int kMaxDepth = 256;
+    if (depth > kMaxDepth) return QDomElement();
+
+    QString name;
+    is >> name;
+    if (is.status() != QDataStream::Ok || name.isEmpty()) return QDomElement();
+
+    QDomElement element = doc.createElement(name);
+    quint32 count = 0;
+    is >> count;
+    for (quint32 index = 0; index < count && is.status() == QDataStream::Ok; ++index) {
+        QString attribute;
+        QString value;
+        is >> attribute >> value;
+        element.setAttribute(attribute, value);
+    }
+
+    is >> count;
+    for (quint32 index = 0; index < count && is.status() == QDataStream::Ok; ++index) {
+        quint8 kind = 0;
+        is >> kind;
+        if (kind == kSnapshotElement) {
+            QDomElement child = ReadElement(is, doc, depth + 1);
+            if (child.isNull()) return QDomElement();
+            element.appendChild(child);
+        } else if (kind == kSnapshotText) {
+            QString text;
+            is >> text;
+            element.appendChild(doc.createTextNode(text));
+        } else {
+            return QDomElement();
+        }
+    }
+
+    return is.status() == QDataStream::Ok ? element : QDomElement();
+}
+
 Loader::Private::Private(const Loader& parent) :
     parent_(parent), configurationPath_(""), configurationName_(""), loadResult_(Loader::kNotLoaded), runnerConfigs_(),
     filePath_(), errorText_(""), errorLine_(-1), errorColumn_(-1), logsDirectory_(""), recordingsDirectory_(""),
@@ -120,6 +264,8 @@ Loader::Private::reset()
     initialProcessingState_ = kDefaultInitialProcessingState;
     includePaths_.clear();
     hostNames_.clear();
+    radar_.clear();
+    sources_.clear();
 }
 
 RunnerConfig*
@@ -179,7 +325,7 @@ Loader::Private::loadRadarConfig(const QString& configurationPath)
 }
 
 bool
-Loader::Private::load(const QString& configurationPath)
+Loader::Private::load(const QString& configurationPath, bool applyRadarConfig)
 {
     Logger::ProcLog log("load", Log());
 
@@ -197,6 +343,11 @@ Loader::Private::load(const QString& configurationPath)
     QFile file(configurationPath_);
     if (!file.open(QFile::ReadOnly | QFile::Text)) { return finishLoad(Loader::kFailedFileOpen); }
 
+    // Note the identity of the file before reading it, so that a snapshot never claims to match a file that
+    // changed after we read it.
+    //
+    sources_.append(Source(configurationPath_));
+
     // Load the XML data, creating a DOM object.
     //
     QDomDocument dom;
@@ -221,7 +372,9 @@ Loader::Private::load(const QString& configurationPath)
         radar = loadIncludeFile(dir.filePath(expandEnvVars(radar.attribute(kAttributeFile))), kEntityRadar, doc);
     }
 
-    if (!Messages::RadarConfig::Load(radar)) { return finishLoad(Loader::kInvalidRadarNode); }
+    if (radar.isNull()) { return finishLoad(Loader::kInvalidRadarNode); }
+    if (applyRadarConfig && !Messages::RadarConfig::Load(radar)) { return finishLoad(Loader::kInvalidRadarNode); }
+    radar_ = radar;
 
     // We MUST have a <dp> (data-processor) element
     //
@@ -352,6 +505,143 @@ Loader::Private::getStreams(const QDir& dir, const QDomElement& runner, QList<QD
     return true;
 }
 
+bool
+Loader::Private::loadSnapshot(const QString& configurationPath, const QString& runnerName, const QString& snapshotPath)
+{
+    Logger::ProcLog log("loadSnapshot", Log());
+    LOGINFO << "configurationPath: " << configurationPath << " runnerName: " << runnerName
+            << " snapshotPath: " << snapshotPath << std::endl;
+
+    reset();
+    configurationPath_ = configurationPath;
+    configurationName_ = QFileInfo(configurationPath).baseName();
+    filePath_ = snapshotPath;
+
+    QFile file(snapshotPath);
+    if (!file.open(QFile::ReadOnly)) { return rejectSnapshot("unable to open snapshot"); }
+
+    QDataStream is(&file);
+    is.setVersion(QDataStream::Qt_5_0);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    is >> magic >> version;
+    if (magic != kSnapshotMagic || version != kSnapshotVersion) { return rejectSnapshot("unknown snapshot format"); }
+
+    QString path;
+    QString name;
+    is >> path >> name;
+    if (path != QFileInfo(configurationPath).absoluteFilePath() || name != runnerName) {
+        return rejectSnapshot("snapshot is for another configuration or runner");
+    }
+
+    // Every file that went into the snapshot must be just as it was when the snapshot was made.
+    //
+    quint32 count = 0;
+    is >> count;
+    for (quint32 index = 0; index < count && is.status() == QDataStream::Ok; ++index) {
+        Source source;
+        source.read(is);
+        if (!source.isCurrent()) { return rejectSnapshot(QString("%1 has changed").arg(source.path)); }
+        sources_.append(source);
+    }
+
+    radar_ = ReadElement(is);
+    is >> logsDirectory_ >> recordingsDirectory_ >> loggerConfiguration_ >> initialProcessingState_ >>
+        includePaths_ >> hostNames_;
+
+    RunnerConfig::Init cfg;
+    is >> cfg.name >> cfg.opts >> cfg.host >> cfg.multicastAddress >> cfg.scheduler >> cfg.priority >>
+        cfg.cpuAffinity >> cfg.initialProcessingState;
+
+    is >> count;
+    for (quint32 index = 0; index < count && is.status() == QDataStream::Ok; ++index) {
+        QDomElement stream = ReadElement(is);
+        if (stream.isNull()) { return rejectSnapshot("invalid <stream> definition"); }
+        cfg.streams.append(stream);
+    }
+
+    if (is.status() != QDataStream::Ok) { return rejectSnapshot("snapshot is truncated"); }
+
+    if (radar_.isNull() || !Messages::RadarConfig::Load(radar_)) {
+        return rejectSnapshot("invalid <radar> definition");
+    }
+
+    runnerConfigs_.append(new RunnerConfig(parent_, cfg));
+    return finishLoad(Loader::kOK);
+}
+
+bool
+Loader::Private::rejectSnapshot(const QString& reason)
+{
+    Logger::ProcLog log("rejectSnapshot", Log());
+    LOGWARNING << filePath_ << " - " << reason << std::endl;
+    QString configurationPath(configurationPath_);
+    reset();
+    configurationPath_ = configurationPath;
+    return finishLoad(Loader::kStaleSnapshot);
+}
+
+bool
+Loader::Private::saveSnapshot(const QString& runnerName, const QString& snapshotPath) const
+{
+    Logger::ProcLog log("saveSnapshot", Log());
+    LOGINFO << "runnerName: " << runnerName << " snapshotPath: " << snapshotPath << std::endl;
+
+    const RunnerConfig* config = getRunnerConfig(runnerName);
+    if (loadResult_ != Loader::kOK || !config || radar_.isNull()) {
+        LOGERROR << "no loaded configuration for runner " << runnerName << std::endl;
+        return false;
+    }
+
+    // Write to a temporary file and then rename it, so that a runner starting up at the same time never sees a
+    // partial snapshot.
+    //
+    QString tmpPath(snapshotPath + ".tmp");
+    QFile file(tmpPath);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate)) {
+        LOGERROR << "failed to open file '" << tmpPath << "'" << std::endl;
+        return false;
+    }
+
+    QDataStream os(&file);
+    os.setVersion(QDataStream::Qt_5_0);
+    os << kSnapshotMagic << kSnapshotVersion << QFileInfo(configurationPath_).absoluteFilePath() << runnerName;
+
+    os << quint32(sources_.size());
+    foreach (const Source& source, sources_) {
+        source.write(os);
+    }
+
+    WriteElement(os, radar_);
+    os << logsDirectory_ << recordingsDirectory_ << loggerConfiguration_ << initialProcessingState_
+       << includePaths_ << hostNames_;
+
+    const RunnerConfig::Init& cfg(config->getInit());
+    os << cfg.name << cfg.opts << cfg.host << cfg.multicastAddress << cfg.scheduler << cfg.priority << cfg.cpuAffinity
+       << cfg.initialProcessingState;
+
+    os << quint32(cfg.streams.size());
+    foreach (const QDomElement& stream, cfg.streams) {
+        WriteElement(os, stream);
+    }
+
+    file.close();
+    if (os.status() != QDataStream::Ok || file.error() != QFile::NoError) {
+        LOGERROR << "failed to write file '" << tmpPath << "'" << std::endl;
+        file.remove();
+        return false;
+    }
+
+    if (std::rename(qPrintable(tmpPath), qPrintable(snapshotPath)) != 0) {
+        LOGERROR << "failed to rename '" << tmpPath << "' to '" << snapshotPath << "'" << std::endl;
+        file.remove();
+        return false;
+    }
+
+    return true;
+}
+
 QDomElement
 Loader::Private::loadIncludeFile(const QString& path, const QString& entity, QDomDocument& doc)
 {
@@ -367,6 +657,7 @@ Loader::Private::loadIncludeFile(const QString& path, const QString& entity, QDo
     }
 
     includePaths_.append(path);
+    sources_.append(Source(path));
 
     if (!doc.setContent(&file, false, &errorText_, &errorLine_, &errorColumn_)) {
         LOGERROR << "failed to parse XML file" << std::endl;
@@ -407,15 +698,27 @@ Loader::loadRadarConfig(const std::string& configurationPath)
 }
 
 bool
-Loader::load(const QString& configurationPath)
+Loader::load(const QString& configurationPath, bool applyRadarConfig)
+{
+    return p_->load(configurationPath, applyRadarConfig);
+}
+
+bool
+Loader::load(const std::string& configurationPath, bool applyRadarConfig)
+{
+    return p_->load(QString::fromStdString(configurationPath), applyRadarConfig);
+}
+
+bool
+Loader::loadSnapshot(const QString& configurationPath, const QString& runnerName, const QString& snapshotPath)
 {
-    return p_->load(configurationPath);
+    return p_->loadSnapshot(configurationPath, runnerName, snapshotPath);
 }
 
 bool
-Loader::load(const std::string& configurationPath)
+Loader::saveSnapshot(const QString& runnerName, const QString& snapshotPath) const
 {
-    return p_->load(QString::fromStdString(configurationPath));
+    return p_->saveSnapshot(runnerName, snapshotPath);
 }
 
 Loader::LoadResult
@@ -462,6 +765,12 @@ Loader::getParseErrorInfo(int& line, int& column) const
     return p_->errorText_;
 }
 
+QString
+Loader::getRadarDefinition() const
+{
+    return p_->radar_.isNull() ? QString() : Private::ToText(p_->radar_);
+}
+
 QString
 Loader::getConfigurationPath() const
 {
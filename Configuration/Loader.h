@@ -39,6 +39,7 @@ public:
         kMissingDPNode,      ///< Missing a <dp> entity node
         kMissingStreams,     ///< Missing a <stream> entity node
         kMissingRunners,     ///< Missing a <runner> entity node
+        kStaleSnapshot,      ///< The snapshot is missing, unreadable, or out of date
         kNotLoaded           ///< The load() method has not been called
     };
 
@@ -70,17 +71,53 @@ public:
 
         \param configurationPath location of the file
 
+        \param applyRadarConfig if true, install the <radar> settings in Messages::RadarConfig. A running process
+        that only wants to look at a configuration should pass false, and use getRadarDefinition() to detect a
+        change.
+
         \return true if successful
     */
-    bool load(const QString& configurationPath);
+    bool load(const QString& configurationPath, bool applyRadarConfig = true);
 
     /** Attempt to load a SideCar configuration file.
 
         \param configurationPath location of the file
 
+        \param applyRadarConfig if true, install the <radar> settings in Messages::RadarConfig
+
         \return true if successful
     */
-    bool load(const std::string& configurationPath);
+    bool load(const std::string& configurationPath, bool applyRadarConfig = true);
+
+    /** Attempt to restore the configuration of one runner from a snapshot written by saveSnapshot(), instead of
+        parsing the configuration file and all of its include files. The snapshot is only used if it was made
+        from the same configuration file for the same runner, and if none of the files it was made from has
+        changed size or modification time since. On success, the loader holds just the one RunnerConfig.
+
+        \param configurationPath location of the configuration file
+
+        \param runnerName name of the runner to restore
+
+        \param snapshotPath location of the snapshot
+
+        \return true if successful. If false, getLastLoadResult() returns kStaleSnapshot, and the caller should
+        use load() instead.
+    */
+    bool loadSnapshot(const QString& configurationPath, const QString& runnerName, const QString& snapshotPath);
+
+    /** Write a snapshot of the configuration of one runner for later use by loadSnapshot(). The snapshot holds
+        the <radar> definition, the <dp> settings, and the runner's settings and <stream> definitions with all
+        include files resolved. The definitions are stored as parsed element trees, so restoring them does not
+        run the XML parser. Only call after a successful load(), and preferably after the runner has put the
+        configuration to use, so that a snapshot only ever holds a configuration known to work.
+
+        \param runnerName name of the runner to save
+
+        \param snapshotPath location of the snapshot to write
+
+        \return true if successful
+    */
+    bool saveSnapshot(const QString& runnerName, const QString& snapshotPath) const;
 
     /** Determine if a configuration file has been successfully loaded
 
@@ -156,6 +193,12 @@ public:
     */
     QString getParseErrorInfo(int& line, int& column) const;
 
+    /** Obtain the <radar> definition of the loaded configuration, with any include file resolved.
+
+        \return XML text, empty if nothing is loaded
+    */
+    QString getRadarDefinition() const;
+
     /** Obtain the full path of the file given in the last call to load().
 
         \return the configuration file path
@@ -113,6 +113,12 @@ public:
 
     const QString& getInitialProcessingState() const { return cfg_.initialProcessingState; }
 
+    /** Obtain the settings the runner was created with.
+
+        \return runner settings
+    */
+    const Init& getInit() const { return cfg_; }
+
     /** Obtain the location of the log file for the runner process
 
         \return log file path
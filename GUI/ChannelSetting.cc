@@ -194,3 +194,9 @@ ChannelSetting::isConnected() const
 {
     return first_ && first_->currentIndex() > 0;
 }
+
+void
+ChannelSetting::setFilter(const MessageFilter& filter)
+{
+    subscriber_->setFilter(filter);
+}
@@ -14,6 +14,7 @@ class Log;
 namespace SideCar {
 namespace GUI {
 
+class MessageFilter;
 class MessageList;
 class Subscriber;
 
@@ -41,6 +42,13 @@ public:
 
     bool isConnected() const;
 
+    /** Install a filter that drops unwanted messages on the channel's reader thread. By default nothing is
+        dropped. See MessageFilter for what a display must keep.
+
+        \param filter filter settings to use
+    */
+    void setFilter(const MessageFilter& filter);
+
 signals:
 
     /** Notification sent out when the channel has data.
@@ -1,6 +1,5 @@
 #include "GUI/LogUtils.h"
 #include "GUI/ServiceEntry.h"
-#include "XMLRPC/XmlRpcClient.h"
 #include "XMLRPC/XmlRpcValue.h"
 
 #include "ConfigurationItem.h"
@@ -75,9 +74,10 @@ ConfigurationItem::executeRequest(const char* cmd, const XmlRpc::XmlRpcValue& ar
 
         LOGDEBUG << "cmd: " << cmd << ' ' << serviceEntry->getHost() << '/' << serviceEntry->getPort() << std::endl;
 
-        XmlRpc::XmlRpcClient client(serviceEntry->getHost().toStdString(), serviceEntry->getPort());
         XmlRpc::XmlRpcValue result;
-        if (!client.execute(cmd, args, result)) ok = false;
+        if (!getChild(index)->executeRequest(serviceEntry->getHost().toStdString(), serviceEntry->getPort(), cmd,
+                                             args, result))
+            ok = false;
     }
 
     return ok;
@@ -41,6 +41,11 @@ RunnerItem::RunnerItem(const RunnerStatus& status, ConfigurationItem* parent) :
     }
 }
 
+RunnerItem::~RunnerItem()
+{
+    if (client_) client_->close();
+}
+
 void
 RunnerItem::updateChildren()
 {
@@ -96,8 +101,25 @@ RunnerItem::executeRequest(const char* cmd, const XmlRpc::XmlRpcValue& args, Xml
 
     LOGINFO << "cmd: " << cmd << " host: " << getHostName() << " port: " << serviceEntry_->getPort() << std::endl;
 
-    XmlRpc::XmlRpcClient client(getHostName().toStdString(), serviceEntry_->getPort());
-    return client.execute(cmd, args, result);
+    return executeRequest(getHostName().toStdString(), serviceEntry_->getPort(), cmd, args, result);
+}
+
+bool
+RunnerItem::executeRequest(const std::string& host, int port, const char* cmd, const XmlRpc::XmlRpcValue& args,
+                           XmlRpc::XmlRpcValue& result) const
+{
+    static Logger::ProcLog log("executeRequest", Log());
+
+    // Reuse the existing connection unless the runner has moved. The XmlRpcClient reconnects by itself if the
+    // runner closed the connection since the last request.
+    //
+    if (!client_ || client_->getHost() != host || client_->getPort() != port) {
+        LOGINFO << "new connection to " << host << '/' << port << std::endl;
+        if (client_) client_->close();
+        client_.reset(new XmlRpc::XmlRpcClient(host, port));
+    }
+
+    return client_->execute(cmd, args, result);
 }
 
 bool
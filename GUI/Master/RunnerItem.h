@@ -1,6 +1,8 @@
 #ifndef SIDECAR_GUI_RUNNERITEM_H // -*- C++ -*-
 #define SIDECAR_GUI_RUNNERITEM_H
 
+#include <memory>
+#include <string>
 #include <vector>
 
 #include "Runner/RunnerStatus.h"
@@ -11,6 +13,7 @@ namespace Logger {
 class Log;
 }
 namespace XmlRpc {
+class XmlRpcClient;
 class XmlRpcValue;
 }
 
@@ -50,6 +53,10 @@ public:
     */
     RunnerItem(const Runner::RunnerStatus& status, ConfigurationItem* parent);
 
+    /** Destructor. Closes any open XML-RPC connection to the runner process.
+     */
+    ~RunnerItem();
+
     /** Obtain the data value for the Host column, which displays host names where runner programs are
         executing.
 
@@ -147,6 +154,24 @@ public:
     */
     bool executeRequest(const char* cmd, const XmlRpc::XmlRpcValue& args, XmlRpc::XmlRpcValue& result) const;
 
+    /** Issue an XML-RPC request to the runner application at a specific address. The connection stays open
+        between requests, and is only replaced when the address changes.
+
+        \param host name of the host running the XML-RPC server
+
+        \param port port of the XML-RPC server
+
+        \param cmd remote command to execute
+
+        \param args command arguments
+
+        \param result command result
+
+        \return true if successfully executed
+    */
+    bool executeRequest(const std::string& host, int port, const char* cmd, const XmlRpc::XmlRpcValue& args,
+                        XmlRpc::XmlRpcValue& result) const;
+
     /** Override of TreeViewItem method. Allow filter matching on the host name where the Runner is executing.
 
         \param filter the text used as a filter
@@ -176,6 +201,7 @@ private:
     void updateChildren();
 
     ServiceEntry* serviceEntry_; ///< XML-RPC server connection info
+    mutable std::unique_ptr<XmlRpc::XmlRpcClient> client_; ///< Persistent XML-RPC connection
     QString displayName_;
     RunnerLog* log_;
     std::vector<int> streamIndexMapping_;
@@ -62,8 +62,8 @@ ServicesModel::ServicesModel(QObject* parent) :
     connect(browser_, SIGNAL(foundServices(const ServiceEntryList&)),
             SLOT(foundServices(const ServiceEntryList&)));
     connect(browser_, SIGNAL(lostServices(const ServiceEntryList&)), SLOT(lostServices(const ServiceEntryList&)));
-    connect(statusCollector_, SIGNAL(statusUpdates(const QList<QByteArray>&)),
-            SLOT(updateStatus(const QList<QByteArray>&)));
+    connect(statusCollector_, SIGNAL(statusUpdates(const QList<XmlRpc::XmlRpcValue>&)),
+            SLOT(updateStatus(const QList<XmlRpc::XmlRpcValue>&)));
 }
 
 ServicesModel::~ServicesModel()
@@ -320,19 +320,16 @@ ServicesModel::flags(const QModelIndex& index) const
 }
 
 void
-ServicesModel::updateStatus(const QList<QByteArray>& statusReports)
+ServicesModel::updateStatus(const QList<XmlRpc::XmlRpcValue>& statusReports)
 {
     static Logger::ProcLog log("updateStatus", Log());
 
-    foreach (QByteArray statusReport, statusReports) {
+    foreach (const XmlRpc::XmlRpcValue& xmlValue, statusReports) {
         // Verify that we have a valid XML-RPC value. For some reason I've seen corrupted XML-RPC messages.
         // Still don't know why...
         //
-        int offset = 0;
-        XmlRpc::XmlRpcValue xmlValue(statusReport.data(), &offset);
         if (!xmlValue.valid() || xmlValue.getType() != XmlRpc::XmlRpcValue::TypeArray) {
-            LOGERROR << "invalid type from runner: " << xmlValue.getType() << " size: " << statusReport.size()
-                     << std::endl;
+            LOGERROR << "invalid type from runner: " << xmlValue.getType() << std::endl;
             continue;
         }
 
@@ -118,7 +118,7 @@ private slots:
 
     void resolvedService(ServiceEntry* serviceEntry);
 
-    void updateStatus(const QList<QByteArray>& statusReports);
+    void updateStatus(const QList<XmlRpc::XmlRpcValue>& statusReports);
 
 private:
     QModelIndex getModelIndex(const TreeViewItem* configItem, int col = 0) const;
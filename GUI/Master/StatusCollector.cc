@@ -20,7 +20,8 @@ StatusCollector::Log()
     return log_;
 }
 
-StatusCollector::StatusCollector() : publisher_(Zeroconf::Publisher::Make(new QtMonitor)), socket_(new QUdpSocket(this))
+StatusCollector::StatusCollector() :
+    publisher_(Zeroconf::Publisher::Make(new QtMonitor)), socket_(new QUdpSocket(this)), decoders_()
 {
     static Logger::ProcLog log("StatusCollector", Log());
     LOGINFO << std::endl;
@@ -47,6 +48,7 @@ StatusCollector::open()
 
     int port = socket_->localPort();
     publisher_->setPort(port);
+    publisher_->setTextData(IO::StatusCodec::GetEncodingKey(), IO::StatusCodec::GetBinaryEncodingName(), false);
 
     // Let Zeroconf deconflict our names. There is no harm in having multiple Master applications running, and
     // each one should receive status updates from running Runners.
@@ -75,7 +77,7 @@ StatusCollector::dataAvailable()
 {
     static Logger::ProcLog log("dataAvailable", Log());
 
-    QList<QByteArray> statusReports;
+    QList<XmlRpc::XmlRpcValue> statusReports;
 
     do {
         qint64 size = socket_->pendingDatagramSize();
@@ -83,10 +85,27 @@ StatusCollector::dataAvailable()
         if (size == -1) break;
 
         QByteArray buffer(size + 1, 0);
-        size = socket_->readDatagram(buffer.data(), size);
+        QHostAddress sender;
+        quint16 senderPort;
+        size = socket_->readDatagram(buffer.data(), size, &sender, &senderPort);
         if (size == -1) break;
 
-        statusReports.append(buffer);
+        // Binary frames may be deltas against an earlier keyframe from the same emitter, so each emitter
+        // address gets its own decoder.
+        //
+        XmlRpc::XmlRpcValue status;
+        if (IO::StatusCodec::IsBinary(buffer.data(), size)) {
+            QString key(QString("%1:%2").arg(sender.toString()).arg(senderPort));
+            if (!decoders_[key].decode(buffer.data(), size, status)) {
+                LOGWARNING << "unusable status frame from " << key << std::endl;
+                continue;
+            }
+        } else {
+            int offset = 0;
+            status.fromXml(buffer.data(), &offset);
+        }
+
+        statusReports.append(status);
 
     } while (socket_->hasPendingDatagrams());
 
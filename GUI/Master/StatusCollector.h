@@ -1,6 +1,8 @@
 #ifndef SIDECAR_GUI_MASTER_STATUSCOLLECTOR_H // -*- C++ -*-
 #define SIDECAR_GUI_MASTER_STATUSCOLLECTOR_H
 
+#include <map>
+
 #include "boost/shared_ptr.hpp"
 
 #include "QtCore/QByteArray"
@@ -8,7 +10,9 @@
 #include "QtCore/QObject"
 #include "QtNetwork/QUdpSocket"
 
+#include "IO/StatusCodec.h"
 #include "Runner/StatusEmitter.h"
+#include "XMLRPC/XmlRpcValue.h"
 
 class QUdpSocket;
 
@@ -23,9 +27,12 @@ class Publisher;
 namespace GUI {
 namespace Master {
 
-/** Status collector for Runner StatusEmitter objects. Accepts XML status information from a StatusEmitter that
-    details the status of the IO::Stream and IO::Task objects owned by the Runner. Hands off incoming status
-    data to a ServiceModel object via ServicesModel::updateStatus() method.
+/** Status collector for Runner StatusEmitter objects. Accepts XML or binary status information from a
+    StatusEmitter that details the status of the IO::Stream and IO::Task objects owned by the Runner. Hands off
+    decoded status data to a ServiceModel object via ServicesModel::updateStatus() method.
+
+    Advertises support for binary status frames in its Zeroconf TXT record. Binary frames are decoded by an
+    IO::StatusDecoder kept for each emitter address.
 */
 class StatusCollector : public QObject {
     Q_OBJECT
@@ -66,7 +73,7 @@ signals:
 
     /** Signal sent out whenever a new status message is received.
      */
-    void statusUpdates(const QList<QByteArray>& statusUpdates);
+    void statusUpdates(const QList<XmlRpc::XmlRpcValue>& statusUpdates);
 
 private slots:
 
@@ -81,8 +88,11 @@ private slots:
     void error(QAbstractSocket::SocketError err);
 
 private:
+    using DecoderMap = std::map<QString, IO::StatusDecoder>;
+
     ZCPublisherRef publisher_;
     QUdpSocket* socket_;
+    DecoderMap decoders_;
 };
 
 } // end namespace Master
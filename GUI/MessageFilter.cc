@@ -0,0 +1,88 @@
+#include "Messages/PRIMessage.h"
+#include "Utils/Utils.h"
+
+#include "LogUtils.h"
+#include "MessageFilter.h"
+
+using namespace SideCar;
+using namespace SideCar::GUI;
+
+Logger::Log&
+MessageFilter::Log()
+{
+    static Logger::Log& log_ = Logger::Log::Find("SideCar.GUI.MessageFilter");
+    return log_;
+}
+
+MessageFilter::MessageFilter() :
+    azimuthStart_(0.0), azimuthSpan_(Utils::kCircleRadians), rangeMin_(0.0), rangeMax_(0.0), decimation_(1),
+    counter_(0), hasAzimuth_(false), hasRange_(false), stats_()
+{
+    ;
+}
+
+void
+MessageFilter::setAzimuthWindow(double start, double span)
+{
+    azimuthStart_ = Utils::normalizeRadians(start);
+    azimuthSpan_ = span;
+    hasAzimuth_ = span > 0.0 && span < Utils::kCircleRadians;
+}
+
+void
+MessageFilter::setRangeWindow(double rangeMin, double rangeMax)
+{
+    rangeMin_ = rangeMin;
+    rangeMax_ = rangeMax;
+    hasRange_ = rangeMax > rangeMin;
+}
+
+void
+MessageFilter::setDecimation(int factor)
+{
+    decimation_ = factor > 1 ? factor : 1;
+    counter_ = 0;
+}
+
+void
+MessageFilter::clear()
+{
+    hasAzimuth_ = false;
+    hasRange_ = false;
+    setDecimation(1);
+}
+
+bool
+MessageFilter::accept(const Messages::Header::Ref& msg)
+{
+    static Logger::ProcLog log("accept", Log());
+
+    if (!isActive()) {
+        ++stats_.passed;
+        return true;
+    }
+
+    Messages::PRIMessage::Ref pri(boost::dynamic_pointer_cast<Messages::PRIMessage>(msg));
+    if (!pri) {
+        ++stats_.passed;
+        return true;
+    }
+
+    if (hasAzimuth_ && Utils::normalizeRadians(pri->getAzimuthStart() - azimuthStart_) >= azimuthSpan_) {
+        ++stats_.dropped;
+        return false;
+    }
+
+    if (hasRange_ && (pri->getRangeMin() > rangeMax_ || pri->getRangeMax() < rangeMin_)) {
+        ++stats_.dropped;
+        return false;
+    }
+
+    if (decimation_ > 1 && counter_++ % decimation_) {
+        ++stats_.dropped;
+        return false;
+    }
+
+    ++stats_.passed;
+    return true;
+}
@@ -0,0 +1,106 @@
+#ifndef SIDECAR_GUI_MESSAGEFILTER_H // -*- C++ -*-
+#define SIDECAR_GUI_MESSAGEFILTER_H
+
+#include <cstdint>
+
+#include "Messages/Header.h"
+
+namespace Logger {
+class Log;
+}
+
+namespace SideCar {
+namespace GUI {
+
+/** Reader-side filter that decides which PRI messages are worth handing to a display. A display that only shows
+    part of the scan, or that cannot keep up with a full-rate channel, installs a filter on its Subscriber so that
+    unwanted messages are dropped on the reader thread and never reach the main thread. Messages that are not
+    PRI messages (extractions, tracks, etc.) always pass.
+
+    A filter has three independent tests, all disabled by default:
+
+    - an azimuth window, given as a start angle and a clockwise span in radians
+    - a range window; a message passes if any part of its gates fall within it
+    - a decimation factor N, which keeps only one of every N messages that pass the other tests
+
+    Filtering is opt-in: a Subscriber passes everything until given a filter. A display that keeps a history of
+    the scan, or that detects scan wraps from the azimuths it sees, must not filter by azimuth, and should only
+    limit range or decimate if it never needs the dropped messages later, since they are gone for good.
+
+    Not thread-safe; ReaderThread keeps its own copy that only its thread uses.
+*/
+class MessageFilter {
+public:
+    struct Stats {
+        uint64_t passed;  ///< Messages accepted
+        uint64_t dropped; ///< Messages rejected
+    };
+
+    static Logger::Log& Log();
+
+    /** Constructor. Creates a filter that passes everything.
+     */
+    MessageFilter();
+
+    /** Limit messages to those with a starting azimuth in the window that starts at start and extends clockwise
+        for span radians. A span of 2 pi or more disables the test.
+
+        \param start start of the window in radians
+
+        \param span width of the window in radians
+    */
+    void setAzimuthWindow(double start, double span);
+
+    /** Limit messages to those whose gates cover at least part of the range window.
+
+        \param rangeMin lower bound of the window in kilometers
+
+        \param rangeMax upper bound of the window in kilometers; if not larger than rangeMin, the test is disabled
+    */
+    void setRangeWindow(double rangeMin, double rangeMax);
+
+    /** Keep only one of every factor messages that pass the window tests.
+
+        \param factor decimation factor; 1 or less keeps all
+    */
+    void setDecimation(int factor);
+
+    /** Remove all limits.
+     */
+    void clear();
+
+    /** Determine if the filter can reject anything.
+
+        \return true if any test is enabled
+    */
+    bool isActive() const { return hasAzimuth_ || hasRange_ || decimation_ > 1; }
+
+    /** Apply the filter to a message.
+
+        \param msg message to check
+
+        \return true if the message should be kept
+    */
+    bool accept(const Messages::Header::Ref& msg);
+
+    const Stats& getStats() const { return stats_; }
+
+private:
+    double azimuthStart_;
+    double azimuthSpan_;
+    double rangeMin_;
+    double rangeMax_;
+    int decimation_;
+    int counter_;
+    bool hasAzimuth_;
+    bool hasRange_;
+    Stats stats_;
+};
+
+} // end namespace GUI
+} // end namespace SideCar
+
+/** \file
+ */
+
+#endif
@@ -43,7 +43,8 @@ MessageReader::Make(const ServiceEntry* serviceEntry)
     return reader;
 }
 
-MessageReader::MessageReader(const Messages::MetaTypeInfo* metaTypeInfo) : Super(), metaTypeInfo_(metaTypeInfo)
+MessageReader::MessageReader(const Messages::MetaTypeInfo* metaTypeInfo) :
+    Super(), metaTypeInfo_(metaTypeInfo), pending_()
 {
     ;
 }
@@ -53,6 +54,15 @@ MessageReader::addRawData(ACE_Message_Block* raw)
 {
     static Logger::ProcLog log("addRawData", Log());
     IO::MessageManager mgr(raw, metaTypeInfo_);
-    Messages::Header::Ref msg(mgr.getNative());
-    emit received(msg);
+    pending_.push_back(mgr.getNative());
+}
+
+void
+MessageReader::flushMessages()
+{
+    static Logger::ProcLog log("flushMessages", Log());
+    if (pending_.empty()) return;
+    LOGDEBUG << "count: " << pending_.size() << std::endl;
+    emit received(pending_);
+    pending_.clear();
 }
@@ -4,6 +4,7 @@
 #include "QtCore/QObject"
 #include "QtCore/QString"
 
+#include "GUI/MessageList.h"
 #include "Messages/Header.h"
 #include "Messages/MetaTypeInfo.h"
 
@@ -19,8 +20,8 @@ class ServiceEntry;
 /** Base class for SideCar message readers used by the GUI applications. Contains no actual connection code; see
     derived classes TCPMessageReader and MulticastMessageReader.
 
-    Manages two MessageList objects, one that is active for incoming data, and one that was active but can safely be
-    used by another thread to obtain received data.
+    Decoded messages are collected in a MessageList, and announced with one received() signal per socket read
+    instead of one per message.
 */
 class MessageReader : public QObject {
     Q_OBJECT
@@ -61,9 +62,12 @@ signals:
      */
     void connected();
 
-    /** Notification that a new message is available from a publisher
-     */
-    void received(const Messages::Header::Ref& msg);
+    /** Notification that new messages are available from a publisher. The list is only valid for the duration
+        of the signal; it must not be retained.
+
+        \param msgs decoded messages from one socket read
+    */
+    void received(const MessageList& msgs);
 
     /** Notification that the reader has disconnected from a publisher.
      */
@@ -76,16 +80,20 @@ protected:
     */
     MessageReader(const Messages::MetaTypeInfo* metaTypeInfo);
 
-    /** Add raw incoming message data to the active message queue. First converts the raw data into a SideCar
-        message type. Thread safe. Emits the dataAvailable() signal if this is the first message added he active
-        message queue.
+    /** Add raw incoming message data to the pending message list. First converts the raw data into a SideCar
+        message type. Derived classes call flushMessages() when they have read all that is available.
 
         \param raw pointer to raw message data
     */
     void addRawData(ACE_Message_Block* raw);
 
+    /** Emit the received() signal with the pending messages, if there are any, and start a new list.
+     */
+    void flushMessages();
+
 private:
     const Messages::MetaTypeInfo* metaTypeInfo_;
+    MessageList pending_;
 };
 
 } // end namespace GUI
@@ -178,6 +178,7 @@ MulticastMessageReader::socketReadyRead()
     } while (proxy_->hasPendingDatagrams());
 
     if (raw) raw->release();
+    flushMessages();
 }
 
 static const char*
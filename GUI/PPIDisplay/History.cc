@@ -23,6 +23,15 @@ int History::Entry::rangeTruthsLifeTime_ = 30 * 1000;
 int History::Entry::rangeTruthsMaxTrailLength_ = 10;
 int History::Entry::bugPlotsLifeTime_ = 30 * 1000;
 
+/** Number of pixels on a side of the scan-converted video image of an Entry.
+ */
+static const int kVideoRasterSize = 1024;
+
+/** Widest wedge that a Video message may paint. Larger azimuth steps from one message to the next are gaps in
+    the data, so such messages only paint a beam width.
+*/
+static const double kMaxVideoWedge = M_PI / 16.0;
+
 static size_t
 calculateCapacity(size_t size)
 {
@@ -35,7 +44,7 @@ calculateCapacity(size_t size)
 }
 
 History::Entry::Entry(size_t lastVideoSize, size_t lastBinarySize) :
-    video_(), binary_(), extractions_(), rangeTruths_(), bugPlots_()
+    video_(), videoRaster_(kVideoRasterSize, 0.0), binary_(), extractions_(), rangeTruths_(), bugPlots_()
 {
     size_t capacity = lastVideoSize ? calculateCapacity(lastVideoSize) : 5000;
     video_.reserve(capacity);
@@ -154,6 +163,7 @@ History::Entry::clearVideo()
 {
     lastVideoSlot_ = 0;
     video_.clear();
+    videoRaster_.clear();
 }
 
 void
@@ -203,10 +213,12 @@ History::Entry::addVideo(const Messages::Video::Ref& msg)
     if (video_.empty()) {
         video_.push_back(msg);
         lastVideoSlot_ = 0;
+        rasterizeVideo(msg, Messages::PRIMessage::Ref());
         return filled;
     }
 
     Messages::PRIMessage::Ref last = video_[lastVideoSlot_];
+    rasterizeVideo(msg, last);
     if (msg->getShaftEncoding() == last->getShaftEncoding()) {
         video_[lastVideoSlot_] = msg;
     } else {
@@ -229,6 +241,33 @@ History::Entry::addVideo(const Messages::Video::Ref& msg)
     return filled;
 }
 
+void
+History::Entry::rasterizeVideo(const Messages::Video::Ref& msg, const Messages::PRIMessage::Ref& last)
+{
+    if (msg->empty()) return;
+
+    // Grow the raster if the message reaches further out than the raster covers. This only happens when the
+    // radar configuration changes, so losing what was already there does not matter.
+    //
+    if (msg->getRangeMax() > videoRaster_.getRangeMax()) videoRaster_.reset(msg->getRangeMax());
+
+    // Paint the wedge between the previous message and this one so that there are no gaps between messages.
+    //
+    double wedge = 0.0;
+    if (last) wedge = Utils::normalizeRadians(msg->getAzimuthStart() - last->getAzimuthStart());
+    if (wedge <= 0.0 || wedge > kMaxVideoWedge) wedge = RadarConfig::GetBeamWidth();
+
+    videoRaster_.add(msg->getAzimuthStart(), wedge, msg->getRangeMin(), msg->getRangeFactor(), &msg->getData()[0],
+                     msg->size());
+}
+
+const Utils::ScanRaster&
+History::Entry::getVideoRaster() const
+{
+    videoRaster_.updatePyramid();
+    return videoRaster_;
+}
+
 void
 History::Entry::pruneExtractions()
 {
@@ -13,6 +13,7 @@
 #include "Messages/Video.h"
 
 #include "GUI/TargetPlot.h"
+#include "Utils/ScanRaster.h"
 
 namespace Logger {
 class Log;
@@ -72,6 +73,13 @@ public:
         */
         const MessageVector& getVideo() const { return video_; }
 
+        /** Obtain the scan-converted image of the Video collection. Redrawing from the image takes the same time
+            no matter how many PRIs and gates make up the revolution.
+
+            \return ScanRaster reference with an up-to-date pyramid
+        */
+        const Utils::ScanRaster& getVideoRaster() const;
+
         /** Obtain a read-only reference to the BinaryVideo collection
 
             \return MessageVector reference
@@ -153,8 +161,17 @@ public:
 
         Messages::PRIMessage::Ref findByAzimuth(const MessageVector& data, double azimuth) const;
 
+        /** Scan-convert a Video message into the video raster.
+
+            \param msg the Video message to add
+
+            \param last the previous Video message, if any
+        */
+        void rasterizeVideo(const Messages::Video::Ref& msg, const Messages::PRIMessage::Ref& last);
+
         MessageVector video_;
         size_t lastVideoSlot_;
+        mutable Utils::ScanRaster videoRaster_;
         MessageVector binary_;
         size_t lastBinarySlot_;
         TargetPlotList extractions_;
@@ -74,7 +74,8 @@ PPIWidget::PPIWidget(QWidget* parent) :
     binaryVertexGenerator_(new BinaryVertexGenerator), displayLists_(0), decayTexture_(), desaturationTexture_(),
     backgroundTexture_(), updateTimer_(), phantomCursor_(PhantomCursorImaging::InvalidCursor()), info_(),
     settingsKey_(), magnifiers_(), cursorPosition_(), panning_(false), rubberBanding_(false),
-    showPhantomCursor_(true), showCursorPosition_(true), trimVideo_(true), trimBinary_(true)
+    showPhantomCursor_(true), showCursorPosition_(true), trimVideo_(true), trimBinary_(true),
+    repaintVideoRaster_(false)
 {
     Logger::ProcLog log("PPIWidget", Log());
     LOGINFO << std::endl;
@@ -697,6 +698,10 @@ PPIWidget::rangeMaxChanged(double value)
     }
 
     setViewTransform();
+
+    // Refill the video buffer at the new scale from the raster of the viewed revolution.
+    //
+    redisplayVideo();
 }
 
 void
@@ -742,13 +747,42 @@ PPIWidget::processVideo(const MessageList& data)
 }
 
 void
-PPIWidget::repaintVideo(const History::MessageVector& video)
+PPIWidget::repaintVideo(const History::Entry& entry)
 {
     Logger::ProcLog log("repaintVideo", Log());
-    LOGINFO << "video.size(): " << video.size() << std::endl;
-    if (!updateTimer_.isActive() || !videoBuffer_ || video.empty()) { return; }
+    LOGINFO << "video.size(): " << entry.getVideo().size() << std::endl;
+    if (!updateTimer_.isActive() || !videoBuffer_ || !entry.hasVideo()) { return; }
 
-    videoVertexGenerator_->add(video);
+    // Drop any messages still waiting to be drawn, since the redraw covers them. Draw in paintGL() so that the
+    // offscreen buffer has seen any view changes that led to this call.
+    //
+    videoVertexGenerator_->flushQueue();
+    repaintVideoRaster_ = true;
+}
+
+void
+PPIWidget::renderVideoRaster()
+{
+    static Logger::ProcLog log("renderVideoRaster", Log());
+
+    const History::Entry& entry(history_->getViewedEntry());
+    if (!entry.hasVideo()) return;
+
+    // If the raster pixels are coarser than the offscreen buffer pixels, the raster would show blocks, so draw the
+    // messages instead.
+    //
+    const Utils::ScanRaster& raster(entry.getVideoRaster());
+    double span = 2.0 * viewSettings_->getRangeMax() / std::min(width(), height());
+    if (!raster.hasData() || raster.getPixelSpan() > span * 1.5) {
+        LOGINFO << "raster too coarse - pixelSpan: " << raster.getPixelSpan() << " span: " << span << std::endl;
+        videoVertexGenerator_->add(entry.getVideo());
+        return;
+    }
+
+    VertexColorArray points;
+    videoVertexGenerator_->renderRaster(raster, span, points);
+    LOGINFO << "points: " << points.size() << std::endl;
+    videoBuffer_->renderPoints(points);
 }
 
 void
@@ -861,6 +895,11 @@ PPIWidget::paintGL()
 
     if (!binaryBuffer_) makeBinaryBuffer();
 
+    if (repaintVideoRaster_) {
+        repaintVideoRaster_ = false;
+        renderVideoRaster();
+    }
+
     videoVertexGenerator_->processQueue();
     videoVertexGenerator_->renderInto(videoBuffer_);
     videoVertexGenerator_->flushPoints();
@@ -1085,7 +1124,7 @@ PPIWidget::historyCurrentViewChanged(int age)
         lastShaftEncoding_ = info_->getShaftEncoding();
     }
 
-    repaintVideo(entry.getVideo());
+    repaintVideo(entry);
     repaintBinary(entry.getBinary());
 
     if (age) {
@@ -1106,8 +1145,7 @@ PPIWidget::historyCurrentViewAged(int age)
 void
 PPIWidget::redisplayVideo()
 {
-    const History::Entry& entry(history_->getViewedEntry());
-    repaintVideo(entry.getVideo());
+    repaintVideo(history_->getViewedEntry());
 }
 
 void
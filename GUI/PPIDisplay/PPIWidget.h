@@ -461,7 +461,16 @@ private:
 
     void leaveEvent(QEvent* event);
 
-    void repaintVideo(const History::MessageVector& video);
+    /** Redraw the Video data of a revolution. The drawing happens in the next paintGL() call.
+
+        \param entry the revolution to draw
+    */
+    void repaintVideo(const History::Entry& entry);
+
+    /** Draw the Video data of the viewed revolution from its scan-converted raster, or from its messages if the
+        raster is too coarse for the current view.
+    */
+    void renderVideoRaster();
 
     void repaintBinary(const History::MessageVector& binary);
 
@@ -534,6 +543,7 @@ private:
     bool showCursorPosition_;
     bool trimVideo_;
     bool trimBinary_;
+    bool repaintVideoRaster_;
 };
 
 } // end namespace PPIDisplay
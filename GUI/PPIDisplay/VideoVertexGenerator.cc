@@ -1,4 +1,7 @@
+#include <algorithm>
+
 #include "GUI/VideoSampleCountTransform.h"
+#include "Utils/ScanRaster.h"
 #include "Utils/SineCosineLUT.h"
 
 #include "App.h"
@@ -51,3 +54,28 @@ VideoVertexGenerator::renderMessage(const Messages::PRIMessage::Ref& msg, Vertex
         }
     }
 }
+
+void
+VideoVertexGenerator::renderRaster(const Utils::ScanRaster& raster, double span, VertexColorArray& points)
+{
+    int level = raster.chooseLevel(span);
+    double pixelSpan = raster.getPixelSpan(level);
+    int size = raster.getSize(level);
+
+    // The view is centered on the radar, so only visit the square of pixels that it covers.
+    //
+    int first = std::max(0, int((raster.getRangeMax() - viewSettings_->getRangeMax()) / pixelSpan));
+    int last = size - first;
+    if (first >= last) return;
+
+    points.checkCapacity((last - first) * (last - first));
+    for (int row = first; row < last; ++row) {
+        double y = raster.getY(level, row);
+        for (int column = first; column < last; ++column) {
+            Utils::ScanRaster::Value value = raster.getValue(level, column, row);
+            if (value == Utils::ScanRaster::kEmpty) continue;
+            double intensity = transform_->transform(value);
+            points.push_back(Vertex(raster.getX(level, column), y), imaging_->getColor(intensity));
+        }
+    }
+}
@@ -4,6 +4,7 @@
 #include "GUI/VertexGenerator.h"
 
 namespace Utils {
+class ScanRaster;
 class SineCosineLUT;
 }
 
@@ -27,6 +28,17 @@ class VideoVertexGenerator : public VertexGenerator {
 public:
     VideoVertexGenerator();
 
+    /** Generate one point for each non-empty pixel of a scan-converted revolution that lies within the current
+        view. Uses the coarsest raster level that still has pixels no wider than those of the display.
+
+        \param raster the revolution to draw
+
+        \param span width of a display pixel in kilometers
+
+        \param points container to append to
+    */
+    void renderRaster(const Utils::ScanRaster& raster, double span, VertexColorArray& points);
+
 private:
     void renderMessage(const Messages::PRIMessage::Ref& msg, VertexColorArray& points);
 
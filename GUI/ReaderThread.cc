@@ -6,7 +6,10 @@
 #include "ServiceEntry.h"
 
 using namespace SideCar::GUI;
-;
+
+/** Most batches that may wait for the consumer. When full, new batches are dropped.
+ */
+static const int kMaxBatches = 256;
 
 Logger::Log&
 ReaderThread::Log()
@@ -15,7 +18,9 @@ ReaderThread::Log()
     return log_;
 }
 
-ReaderThread::ReaderThread() : QThread(), serviceEntry_(0), messages_(), active_(0), mutex_()
+ReaderThread::ReaderThread() :
+    QThread(), serviceEntry_(0), metaTypeInfo_(0), batches_(kMaxBatches), free_(kMaxBatches), spare_(0), messages_(),
+    notified_(false), filter_(), pendingFilter_(), filterChanged_(false), overflows_(0), mutex_()
 {
     Logger::ProcLog log("ReaderThread", Log());
     LOGINFO << std::endl;
@@ -24,12 +29,6 @@ ReaderThread::ReaderThread() : QThread(), serviceEntry_(0), messages_(), active_
     // be as queued connections (except for the MessageReader object created in the run() method below)
     //
     moveToThread(this);
-
-    // Initialize our incoming message buffers. We use two so that we can collect messages in oen while another
-    // thread processes the messages in another.
-    //
-    messages_[0].clear();
-    messages_[1].clear();
 }
 
 ReaderThread::~ReaderThread()
@@ -37,6 +36,7 @@ ReaderThread::~ReaderThread()
     Logger::ProcLog log("~ReaderThread", Log());
     LOGINFO << this << std::endl;
     if (isRunning()) stop();
+    delete spare_;
 }
 
 void
@@ -71,40 +71,66 @@ ReaderThread::stop()
 const MessageList&
 ReaderThread::getMessages()
 {
-    // Clear the inactive buffer before we swap it in. No need to protect this since we are the only ones using
-    // it right now.
+    // Allow a new notification before draining, so that a batch added after the last popOff() below always
+    // results in another dataAvailable() signal.
     //
-    size_t retired = active_;
-    size_t newActive = retired ^ 1;
-    messages_[newActive].clear();
+    notified_ = false;
+    messages_.clear();
+
+    MessageList* batch;
+    while ((batch = batches_.popOff())) {
+        for (const auto& msg : *batch) messages_.push_back(msg);
+        batch->clear();
+        if (!free_.pushOn(batch)) delete batch;
+    }
 
-    // !!! Need to protect against other thread reading active_ value. Fetch the active buffer and begin using
-    // the inactive one. *** Is there a better, non-locking way?
-    //
-    mutex_.lock();
-    active_ = newActive;
-    mutex_.unlock();
+    return messages_;
+}
 
-    return messages_[retired];
+void
+ReaderThread::setFilter(const MessageFilter& filter)
+{
+    QMutexLocker lock(&mutex_);
+    pendingFilter_ = filter;
+    filterChanged_ = true;
 }
 
 void
-ReaderThread::received(const Messages::Header::Ref& msg)
+ReaderThread::received(const MessageList& msgs)
 {
     Logger::ProcLog log("received", Log());
-    LOGINFO << std::endl;
+    LOGINFO << msgs.size() << std::endl;
 
-    // !!! Need to protect against changes to active_ while adding message to list.
-    //
-    mutex_.lock();
-    bool doSend = messages_[active_].empty();
-    messages_[active_].push_back(msg);
-    mutex_.unlock();
+    if (filterChanged_.exchange(false)) {
+        QMutexLocker lock(&mutex_);
+        filter_ = pendingFilter_;
+    }
+
+    MessageList* batch = spare_;
+    spare_ = 0;
+    if (!batch) batch = free_.popOff();
+    if (!batch) batch = new MessageList;
+
+    for (const auto& msg : msgs) {
+        if (filter_.accept(msg)) batch->push_back(msg);
+    }
+
+    if (batch->empty()) {
+        spare_ = batch;
+        return;
+    }
+
+    if (!batches_.pushOn(batch)) {
+        if (overflows_++ % 100 == 0) LOGWARNING << "consumer is behind - dropped " << overflows_ << std::endl;
+        batch->clear();
+        spare_ = batch;
+        return;
+    }
 
-    // Notify others that we have data, but only do so the FIRST time we have data. Otherwise, we run the risk
-    // of flooding another thread's event queue.
+    // Notify others that we have data, but only if they have not yet been told. Otherwise, we run the risk of
+    // flooding another thread's event queue.
     //
-    if (doSend) {
+    if (!notified_.exchange(true)) {
         LOGDEBUG << "data available" << std::endl;
         emit dataAvailable();
     }
@@ -125,7 +151,7 @@ ReaderThread::run()
     // it before we and our thread exits.
     //
     connect(reader.get(), SIGNAL(connected()), SIGNAL(connected()));
-    connect(reader.get(), SIGNAL(received(const Messages::Header::Ref&)), SLOT(received(const Messages::Header::Ref&)));
+    connect(reader.get(), SIGNAL(received(const MessageList&)), SLOT(received(const MessageList&)));
     connect(reader.get(), SIGNAL(disconnected()), SIGNAL(disconnected()));
 
     // Run this thread's event loop so we can respond to signals from our MessageReader.
@@ -138,5 +164,6 @@ ReaderThread::run()
     reader->disconnect(this);
     reader.reset();
 
-    LOGINFO << this << " reader thread exiting" << std::endl;
+    LOGINFO << this << " reader thread exiting - passed: " << filter_.getStats().passed
+            << " dropped: " << filter_.getStats().dropped << " overflows: " << overflows_ << std::endl;
 }
@@ -1,13 +1,17 @@
 #ifndef SIDECAR_GUI_READERTHREAD_H // -*- C++ -*-
 #define SIDECAR_GUI_READERTHREAD_H
 
+#include <atomic>
+
 #include "boost/scoped_ptr.hpp"
 
 #include "QtCore/QMutex"
 #include "QtCore/QString"
 #include "QtCore/QThread"
 
+#include "GUI/MessageFilter.h"
 #include "GUI/MessageList.h"
+#include "Utils/RingBuffer.h"
 
 namespace Logger {
 class Log;
@@ -26,6 +30,11 @@ class ServiceEntry;
     ServiceEntry object (called with a NULL object will stop any running thread). The thread runs the run()
     method, which creates a new MessageReader object, hooks up its signals to the reader* slots below, and then
     starts up a new Qt event loop.
+
+    Each batch of messages from the MessageReader is run through a MessageFilter and placed in a single-producer,
+    single-consumer ring buffer, so neither thread takes a lock per message. The dataAvailable() signal goes out
+    only when the consumer has taken everything offered so far; getMessages() collects all waiting batches. Empty
+    lists travel back to the reader thread in a second ring for reuse.
 */
 class ReaderThread : public QThread {
     Q_OBJECT
@@ -57,10 +66,17 @@ public:
     */
     const Messages::MetaTypeInfo* getMetaTypeInfo() const { return metaTypeInfo_; }
 
-    /** Obtain the list of data messages received from the internal MessageReader object.
+    /** Obtain the list of data messages received from the internal MessageReader object. Only the thread that
+        receives the dataAvailable() signal may call this.
      */
     const MessageList& getMessages();
 
+    /** Install a new filter for incoming messages. Takes effect with the next batch read. Thread safe.
+
+        \param filter filter settings to copy
+    */
+    void setFilter(const MessageFilter& filter);
+
 public slots:
 
     /** If a thread is running, stop it and wait for it to exit.
@@ -69,7 +85,7 @@ public slots:
 
 private slots:
 
-    void received(const Messages::Header::Ref& msg);
+    void received(const MessageList& msgs);
 
 signals:
 
@@ -94,8 +110,15 @@ protected:
 private:
     boost::scoped_ptr<ServiceEntry> serviceEntry_;
     const Messages::MetaTypeInfo* metaTypeInfo_;
-    MessageList messages_[2];
-    volatile size_t active_;
+    Utils::PtrRingBuffer<MessageList> batches_; ///< Filtered batches waiting for the consumer
+    Utils::PtrRingBuffer<MessageList> free_;    ///< Emptied batches returned by the consumer
+    MessageList* spare_;                        ///< Unused batch kept by the reader thread
+    MessageList messages_;                      ///< Result of the last getMessages()
+    std::atomic<bool> notified_;                ///< True if dataAvailable() sent and not yet answered
+    MessageFilter filter_;                      ///< Filter used by the reader thread
+    MessageFilter pendingFilter_;               ///< Filter given in setFilter(), guarded by mutex_
+    std::atomic<bool> filterChanged_;
+    size_t overflows_; ///< Batches dropped because the consumer fell behind
     QMutex mutex_;
 };
 
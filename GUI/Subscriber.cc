@@ -122,3 +122,9 @@ Subscriber::getMessages() const
 {
     return reader_->getMessages();
 }
+
+void
+Subscriber::setFilter(const MessageFilter& filter)
+{
+    reader_->setFilter(filter);
+}
@@ -10,6 +10,7 @@ class Log;
 namespace SideCar {
 namespace GUI {
 
+class MessageFilter;
 class MessageList;
 class ReaderThread;
 class ServiceEntry;
@@ -56,6 +57,13 @@ public:
     */
     const MessageList& getMessages() const;
 
+    /** Install a filter that drops unwanted messages before they reach getMessages(). The filter stays in
+        effect across publisher changes.
+
+        \param filter filter settings to use
+    */
+    void setFilter(const MessageFilter& filter);
+
 signals:
 
     /** Notification that a connection has been established to a publisher.
@@ -53,4 +53,6 @@ TCPMessageReader::socketReadyRead()
         }
 
     } while (socket_->bytesAvailable() > 0);
+
+    flushMessages();
 }
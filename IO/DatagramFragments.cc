@@ -0,0 +1,227 @@
+#include <algorithm>
+#include <cstring>
+#include <random>
+
+#include "Logger/Log.h"
+
+#include "DatagramFragments.h"
+
+using namespace SideCar::IO;
+
+namespace {
+
+void
+Put(char* data, uint32_t value, size_t size)
+{
+    for (size_t index = size; index > 0; --index) {
+        data[index - 1] = char(value & 0xFF);
+        value >>= 8;
+    }
+}
+
+uint32_t
+Get(const char* data, size_t size)
+{
+    uint32_t value = 0;
+    for (size_t index = 0; index < size; ++index) value = (value << 8) | uint8_t(data[index]);
+    return value;
+}
+
+} // namespace
+
+Logger::Log&
+DatagramFragmenter::Log()
+{
+    static Logger::Log& log_ = Logger::Log::Find("SideCar.IO.DatagramFragmenter");
+    return log_;
+}
+
+DatagramFragmenter::DatagramFragmenter(size_t maxDatagramSize) :
+    maxDatagramSize_(0), sliceSize_(0), streamId_(std::random_device()()), messageId_(0), stats_()
+{
+    setMaxDatagramSize(maxDatagramSize);
+}
+
+void
+DatagramFragmenter::setMaxDatagramSize(size_t maxDatagramSize)
+{
+    maxDatagramSize_ = std::max(maxDatagramSize, size_t(kMinDatagramSize));
+    sliceSize_ = (maxDatagramSize_ - kHeaderSize) & ~size_t(7);
+}
+
+bool
+DatagramFragmenter::split(const iovec* iov, int count, size_t size, std::vector<Fragment>& fragments)
+{
+    static Logger::ProcLog log("split", Log());
+
+    size_t fragmentCount = (size + sliceSize_ - 1) / sliceSize_;
+    if (fragmentCount > 0xFFFF) {
+        LOGERROR << "message of " << size << " bytes needs " << fragmentCount << " fragments" << std::endl;
+        return false;
+    }
+
+    ++messageId_;
+    ++stats_.messages;
+    stats_.fragments += fragmentCount;
+    fragments.resize(fragmentCount);
+
+    // Walk the iovec entries once, handing out slices of them to each fragment in turn.
+    //
+    const iovec* end = iov + count;
+    size_t used = 0; ///< Bytes of *iov already given to a fragment
+    for (size_t index = 0; index < fragmentCount; ++index) {
+        Fragment& fragment(fragments[index]);
+        size_t offset = index * sliceSize_;
+        Put(fragment.header, kMagic, 4);
+        Put(fragment.header + 4, streamId_, 4);
+        Put(fragment.header + 8, messageId_, 4);
+        Put(fragment.header + 12, size, 4);
+        Put(fragment.header + 16, offset, 4);
+        Put(fragment.header + 20, index, 2);
+        Put(fragment.header + 22, fragmentCount, 2);
+
+        fragment.iovs.clear();
+        size_t needed = std::min(sliceSize_, size - offset);
+        while (needed && iov != end) {
+            size_t available = iov->iov_len - used;
+            size_t take = std::min(needed, available);
+            if (take) {
+                iovec slice;
+                slice.iov_base = static_cast<char*>(iov->iov_base) + used;
+                slice.iov_len = take;
+                fragment.iovs.push_back(slice);
+            }
+
+            needed -= take;
+            used += take;
+            if (used == iov->iov_len) {
+                ++iov;
+                used = 0;
+            }
+        }
+    }
+
+    return true;
+}
+
+Logger::Log&
+DatagramReassembler::Log()
+{
+    static Logger::Log& log_ = Logger::Log::Find("SideCar.IO.DatagramReassembler");
+    return log_;
+}
+
+bool
+DatagramReassembler::IsFragment(const char* data, size_t size)
+{
+    return size >= DatagramFragmenter::kHeaderSize && Get(data, 4) == DatagramFragmenter::kMagic;
+}
+
+DatagramReassembler::DatagramReassembler(Pool& pool, double timeout, size_t maxPending, size_t maxMessageSize) :
+    pool_(pool), timeout_(timeout), maxPending_(std::max(maxPending, size_t(1))), maxMessageSize_(maxMessageSize),
+    pending_(), stats_()
+{
+    ;
+}
+
+DatagramReassembler::~DatagramReassembler()
+{
+    while (!pending_.empty()) discard(pending_.begin());
+}
+
+DatagramReassembler::Result
+DatagramReassembler::add(const char* data, size_t size, double now, void*& handle, size_t& length)
+{
+    static Logger::ProcLog log("add", Log());
+
+    if (!IsFragment(data, size)) return kNotFragment;
+
+    Key key(Get(data + 4, 4), Get(data + 8, 4));
+    size_t total = Get(data + 12, 4);
+    size_t offset = Get(data + 16, 4);
+    size_t index = Get(data + 20, 2);
+    size_t count = Get(data + 22, 2);
+    size_t sliceSize = size - DatagramFragmenter::kHeaderSize;
+
+    if (index >= count || offset + sliceSize > total || total > maxMessageSize_ || !sliceSize) {
+        LOGWARNING << "invalid fragment " << index << '/' << count << " offset: " << offset << " size: " << sliceSize
+                   << " total: " << total << std::endl;
+        ++stats_.invalid;
+        return kInvalid;
+    }
+
+    EntryMap::iterator pos = pending_.find(key);
+    if (pos == pending_.end()) {
+        // Make room by dropping the oldest message in progress.
+        //
+        if (pending_.size() >= maxPending_) {
+            EntryMap::iterator oldest = pending_.begin();
+            for (EntryMap::iterator scan = pending_.begin(); scan != pending_.end(); ++scan) {
+                if (scan->second.started < oldest->second.started) oldest = scan;
+            }
+
+            LOGWARNING << "evicting incomplete message " << oldest->first.second << std::endl;
+            discard(oldest);
+            ++stats_.evicted;
+        }
+
+        Entry entry;
+        entry.buffer = pool_.acquire(total, entry.handle);
+        entry.size = total;
+        entry.remaining = count;
+        entry.started = now;
+        entry.received.resize(count, false);
+        pos = pending_.insert(EntryMap::value_type(key, entry)).first;
+    }
+
+    Entry& entry(pos->second);
+    if (entry.size != total || entry.received.size() != count) {
+        LOGWARNING << "fragment " << index << " does not match message " << key.second << std::endl;
+        ++stats_.invalid;
+        return kInvalid;
+    }
+
+    if (entry.received[index]) {
+        ++stats_.duplicates;
+        return kPending;
+    }
+
+    ::memcpy(entry.buffer + offset, data + DatagramFragmenter::kHeaderSize, sliceSize);
+    entry.received[index] = true;
+    ++stats_.fragments;
+    if (--entry.remaining) return kPending;
+
+    handle = entry.handle;
+    length = entry.size;
+    pending_.erase(pos);
+    ++stats_.reassembled;
+    return kComplete;
+}
+
+size_t
+DatagramReassembler::expire(double now)
+{
+    static Logger::ProcLog log("expire", Log());
+
+    size_t count = 0;
+    EntryMap::iterator pos = pending_.begin();
+    while (pos != pending_.end()) {
+        EntryMap::iterator tmp = pos++;
+        if (now - tmp->second.started >= timeout_) {
+            LOGWARNING << "incomplete message " << tmp->first.second << " missing " << tmp->second.remaining
+                       << " fragments" << std::endl;
+            discard(tmp);
+            ++count;
+        }
+    }
+
+    stats_.timeouts += count;
+    return count;
+}
+
+void
+DatagramReassembler::discard(EntryMap::iterator pos)
+{
+    pool_.release(pos->second.handle);
+    pending_.erase(pos);
+}
@@ -0,0 +1,232 @@
+#ifndef SIDECAR_IO_DATAGRAMFRAGMENTS_H // -*- C++ -*-
+#define SIDECAR_IO_DATAGRAMFRAGMENTS_H
+
+#include <cstdint>
+#include <map>
+#include <sys/uio.h> // for struct iovec
+#include <vector>
+
+namespace Logger {
+class Log;
+}
+
+namespace SideCar {
+namespace IO {
+
+/** Splits messages too large for one UDP datagram into fragments. Each fragment is a datagram that starts with a
+    fixed header in network byte order, followed by a slice of the message:
+
+    - magic tag (4 bytes)
+    - sender stream ID (4 bytes), chosen at random for each fragmenter
+    - message ID (4 bytes), counting up for each fragmented message
+    - total message size (4 bytes)
+    - offset of the slice in the message (4 bytes)
+    - fragment index (2 bytes)
+    - fragment count (2 bytes)
+
+    Messages that fit in one datagram go out as they are, so readers that know nothing about fragments still
+    work with them. Fragments do not copy message data: they refer to slices of the caller's iovec entries.
+*/
+class DatagramFragmenter {
+public:
+    enum {
+        kMagic = 0x53434652,
+        kHeaderSize = 24,
+        kDefaultMaxDatagramSize = 65000, ///< Largest datagram sent as is, just under the UDP limit
+        kMinDatagramSize = 512
+    };
+
+    /** A fragment waiting to be sent. The datagram holds the header bytes followed by the data of the iovec
+        entries.
+    */
+    struct Fragment {
+        char header[kHeaderSize];
+        std::vector<iovec> iovs;
+    };
+
+    struct Stats {
+        uint64_t messages;  ///< Messages split into fragments
+        uint64_t fragments; ///< Fragments made
+    };
+
+    static Logger::Log& Log();
+
+    /** Constructor.
+
+        \param maxDatagramSize largest datagram to send, including the fragment header
+    */
+    DatagramFragmenter(size_t maxDatagramSize = kDefaultMaxDatagramSize);
+
+    /** Change the largest datagram to send. Values below kMinDatagramSize are raised to it.
+
+        \param maxDatagramSize new size in bytes
+    */
+    void setMaxDatagramSize(size_t maxDatagramSize);
+
+    size_t getMaxDatagramSize() const { return maxDatagramSize_; }
+
+    /** Determine if a message needs splitting.
+
+        \param size number of bytes in the message
+
+        \return true if the message does not fit in one datagram
+    */
+    bool needsFragments(size_t size) const { return size > maxDatagramSize_; }
+
+    /** Split a message into fragments.
+
+        \param iov first iovec entry of the message
+
+        \param count number of iovec entries
+
+        \param size number of bytes in the message
+
+        \param fragments storage for the fragments, in order
+
+        \return false if the message needs more fragments than the header can count
+    */
+    bool split(const iovec* iov, int count, size_t size, std::vector<Fragment>& fragments);
+
+    const Stats& getStats() const { return stats_; }
+
+private:
+    size_t maxDatagramSize_;
+    size_t sliceSize_; ///< Message bytes per fragment, a multiple of 8 to keep CDR alignment
+    uint32_t streamId_;
+    uint32_t messageId_;
+    Stats stats_;
+};
+
+/** Rebuilds messages from the fragments made by DatagramFragmenter. Fragments may arrive in any order, and
+    duplicates are ignored. Each message under construction lives in a buffer obtained from a Pool as soon as
+    its first fragment shows up, and fragments are copied straight into place. Messages still incomplete after a
+    timeout are discarded by expire(), as is the oldest one when too many are in progress.
+*/
+class DatagramReassembler {
+public:
+    /** Source of buffers for messages under construction.
+     */
+    struct Pool {
+        virtual ~Pool() {}
+
+        /** Obtain a buffer.
+
+            \param size number of bytes needed
+
+            \param handle storage for a value identifying the buffer to the pool
+
+            \return start of the buffer
+        */
+        virtual char* acquire(size_t size, void*& handle) = 0;
+
+        /** Return a buffer holding an incomplete message.
+
+            \param handle value given by acquire()
+        */
+        virtual void release(void* handle) = 0;
+    };
+
+    enum Result {
+        kNotFragment, ///< Datagram is an ordinary message
+        kInvalid,     ///< Datagram is a damaged or inconsistent fragment
+        kPending,     ///< Fragment taken, message still incomplete
+        kComplete     ///< Fragment completed a message
+    };
+
+    struct Stats {
+        uint64_t fragments;   ///< Fragments accepted
+        uint64_t duplicates;  ///< Fragments already seen
+        uint64_t invalid;     ///< Fragments rejected
+        uint64_t reassembled; ///< Messages completed
+        uint64_t timeouts;    ///< Incomplete messages discarded by expire()
+        uint64_t evicted;     ///< Incomplete messages discarded to make room for new ones
+    };
+
+    static Logger::Log& Log();
+
+    /** Determine if a datagram holds a fragment.
+
+        \param data start of the datagram
+
+        \param size number of bytes in the datagram
+
+        \return true if so
+    */
+    static bool IsFragment(const char* data, size_t size);
+
+    /** Constructor.
+
+        \param pool source of message buffers
+
+        \param timeout seconds to wait for the rest of a message after its first fragment
+
+        \param maxPending most messages under construction at once
+
+        \param maxMessageSize largest message accepted
+    */
+    DatagramReassembler(Pool& pool, double timeout = 0.5, size_t maxPending = 64,
+                        size_t maxMessageSize = 64 * 1024 * 1024);
+
+    /** Destructor. Returns the buffers of any incomplete messages to the pool.
+     */
+    ~DatagramReassembler();
+
+    /** Accept a datagram.
+
+        \param data start of the datagram
+
+        \param size number of bytes in the datagram
+
+        \param now current time in seconds
+
+        \param handle if the result is kComplete, storage for the pool handle of the finished message, which now
+        belongs to the caller
+
+        \param length if the result is kComplete, storage for the number of bytes in the finished message
+
+        \return disposition of the datagram
+    */
+    Result add(const char* data, size_t size, double now, void*& handle, size_t& length);
+
+    /** Discard incomplete messages older than the timeout.
+
+        \param now current time in seconds
+
+        \return number of messages discarded
+    */
+    size_t expire(double now);
+
+    size_t getPendingCount() const { return pending_.size(); }
+
+    const Stats& getStats() const { return stats_; }
+
+private:
+    struct Entry {
+        void* handle;
+        char* buffer;
+        size_t size;
+        size_t remaining; ///< Fragments still missing
+        double started;
+        std::vector<bool> received;
+    };
+
+    using Key = std::pair<uint32_t, uint32_t>; ///< Stream ID and message ID
+    using EntryMap = std::map<Key, Entry>;
+
+    void discard(EntryMap::iterator pos);
+
+    Pool& pool_;
+    double timeout_;
+    size_t maxPending_;
+    size_t maxMessageSize_;
+    EntryMap pending_;
+    Stats stats_;
+};
+
+} // end namespace IO
+} // end namespace SideCar
+
+/** \file
+ */
+
+#endif
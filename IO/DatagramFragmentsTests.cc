@@ -0,0 +1,268 @@
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <netinet/in.h>
+#include <poll.h>
+#include <random>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+#include "UnitTest/UnitTest.h"
+
+#include "DatagramFragments.h"
+
+using namespace SideCar::IO;
+
+struct Test : public UnitTest::TestObj {
+    Test() : UnitTest::TestObj("DatagramFragments") {}
+    void test();
+};
+
+/** Pool that keeps track of the buffers it hands out.
+ */
+struct VectorPool : public DatagramReassembler::Pool {
+    char* acquire(size_t size, void*& handle)
+    {
+        std::vector<char>* buffer = new std::vector<char>(size);
+        handle = buffer;
+        ++outstanding;
+        return &(*buffer)[0];
+    }
+
+    void release(void* handle)
+    {
+        delete static_cast<std::vector<char>*>(handle);
+        --outstanding;
+    }
+
+    /** Take ownership of a finished message.
+     */
+    std::vector<char> take(void* handle)
+    {
+        std::vector<char> result;
+        result.swap(*static_cast<std::vector<char>*>(handle));
+        release(handle);
+        return result;
+    }
+
+    int outstanding = 0;
+};
+
+/** Build a test message whose contents depend on its index.
+ */
+static std::vector<char>
+Message(int index, size_t size)
+{
+    std::vector<char> message(size);
+    for (size_t pos = 0; pos < size; ++pos) message[pos] = char(index * 31 + pos * 7);
+    return message;
+}
+
+/** Split a message held in two iovec entries, and flatten each fragment into a datagram.
+ */
+static std::vector<std::vector<char>>
+Split(DatagramFragmenter& fragmenter, const std::vector<char>& message)
+{
+    size_t half = message.size() / 3;
+    iovec iovs[2];
+    iovs[0].iov_base = const_cast<char*>(&message[0]);
+    iovs[0].iov_len = half;
+    iovs[1].iov_base = const_cast<char*>(&message[half]);
+    iovs[1].iov_len = message.size() - half;
+
+    std::vector<DatagramFragmenter::Fragment> fragments;
+    std::vector<std::vector<char>> datagrams;
+    if (!fragmenter.split(iovs, 2, message.size(), fragments)) return datagrams;
+    for (const auto& fragment : fragments) {
+        std::vector<char> datagram(fragment.header, fragment.header + DatagramFragmenter::kHeaderSize);
+        for (const auto& iov : fragment.iovs) {
+            const char* data = static_cast<const char*>(iov.iov_base);
+            datagram.insert(datagram.end(), data, data + iov.iov_len);
+        }
+
+        datagrams.push_back(datagram);
+    }
+
+    return datagrams;
+}
+
+void
+Test::test()
+{
+    // Splitting: slices are multiples of 8 bytes, fit in the datagram limit, and cross iovec boundaries.
+    //
+    {
+        DatagramFragmenter fragmenter(1000);
+        assertFalse(fragmenter.needsFragments(1000));
+        assertTrue(fragmenter.needsFragments(1001));
+
+        std::vector<char> message(Message(1, 5000));
+        std::vector<std::vector<char>> datagrams(Split(fragmenter, message));
+        assertEqual(size_t(6), datagrams.size());
+        for (const auto& datagram : datagrams) assertTrue(datagram.size() <= 1000);
+        assertEqual(size_t(DatagramFragmenter::kHeaderSize + 976), datagrams[0].size());
+        assertEqual(uint64_t(1), fragmenter.getStats().messages);
+        assertEqual(uint64_t(6), fragmenter.getStats().fragments);
+
+        fragmenter.setMaxDatagramSize(10);
+        assertEqual(size_t(DatagramFragmenter::kMinDatagramSize), fragmenter.getMaxDatagramSize());
+    }
+
+    // Reassembly in order, out of order, and with duplicates. Ordinary datagrams pass through.
+    //
+    {
+        VectorPool pool;
+        DatagramFragmenter fragmenter(1000);
+        DatagramReassembler reassembler(pool);
+        void* handle = 0;
+        size_t length = 0;
+
+        const char plain[] = "\xAA\xAA\x00\x00 not a fragment";
+        assertEqual(DatagramReassembler::kNotFragment, reassembler.add(plain, sizeof(plain), 1.0, handle, length));
+
+        std::vector<char> message(Message(2, 4321));
+        std::vector<std::vector<char>> datagrams(Split(fragmenter, message));
+        std::reverse(datagrams.begin(), datagrams.end());
+        for (size_t index = 0; index < datagrams.size() - 1; ++index) {
+            assertEqual(DatagramReassembler::kPending,
+                        reassembler.add(&datagrams[index][0], datagrams[index].size(), 1.0, handle, length));
+            assertEqual(DatagramReassembler::kPending,
+                        reassembler.add(&datagrams[index][0], datagrams[index].size(), 1.0, handle, length));
+        }
+
+        assertEqual(DatagramReassembler::kComplete,
+                    reassembler.add(&datagrams.back()[0], datagrams.back().size(), 1.0, handle, length));
+        assertEqual(message.size(), length);
+        assertTrue(pool.take(handle) == message);
+        assertEqual(uint64_t(1), reassembler.getStats().reassembled);
+        assertEqual(uint64_t(datagrams.size() - 1), reassembler.getStats().duplicates);
+        assertEqual(0, pool.outstanding);
+
+        // Fragments with an index past their count are rejected.
+        //
+        std::vector<char> bad(datagrams[0]);
+        bad[20] = char(0xFF);
+        bad[21] = char(0xFF);
+        assertEqual(DatagramReassembler::kInvalid, reassembler.add(&bad[0], bad.size(), 1.0, handle, length));
+        assertEqual(uint64_t(1), reassembler.getStats().invalid);
+    }
+
+    // Incomplete messages time out, the oldest is evicted when too many are in progress, and all buffers go back
+    // to the pool.
+    //
+    {
+        VectorPool pool;
+        DatagramFragmenter fragmenter(1000);
+        {
+            DatagramReassembler reassembler(pool, 0.5, 2);
+            void* handle = 0;
+            size_t length = 0;
+            for (int index = 0; index < 3; ++index) {
+                std::vector<std::vector<char>> datagrams(Split(fragmenter, Message(index, 3000)));
+                reassembler.add(&datagrams[0][0], datagrams[0].size(), 1.0 + index * 0.1, handle, length);
+            }
+
+            assertEqual(uint64_t(1), reassembler.getStats().evicted);
+            assertEqual(size_t(2), reassembler.getPendingCount());
+            assertEqual(size_t(0), reassembler.expire(1.55));
+            assertEqual(size_t(1), reassembler.expire(1.65));
+            assertEqual(uint64_t(1), reassembler.getStats().timeouts);
+
+            std::vector<std::vector<char>> datagrams(Split(fragmenter, Message(9, 3000)));
+            reassembler.add(&datagrams[0][0], datagrams[0].size(), 2.0, handle, length);
+            assertEqual(2, pool.outstanding);
+        }
+
+        assertEqual(0, pool.outstanding);
+    }
+
+    // Loopback stress: send fragments over a UDP socket in shuffled order, dropping some, and check that every
+    // message either arrives intact or times out.
+    //
+    {
+        int socket = ::socket(AF_INET, SOCK_DGRAM, 0);
+        assertTrue(socket != -1);
+        int bufferSize = 4 * 1024 * 1024;
+        ::setsockopt(socket, SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof(bufferSize));
+        sockaddr_in address;
+        ::memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t addressSize = sizeof(address);
+        assertTrue(::bind(socket, reinterpret_cast<sockaddr*>(&address), addressSize) == 0);
+        assertTrue(::getsockname(socket, reinterpret_cast<sockaddr*>(&address), &addressSize) == 0);
+
+        ::srand(4321);
+        std::mt19937 generator(4321);
+        VectorPool pool;
+        DatagramFragmenter fragmenter(8192);
+        DatagramReassembler reassembler(pool, 0.5, 8);
+        std::vector<char> buffer(65536);
+        std::map<int, std::vector<char>> expected;
+        int intact = 0;
+        int lost = 0;
+        double now = 0.0;
+
+        for (int index = 0; index < 500; ++index) {
+            std::vector<char> message(Message(index, 20000 + ::rand() % 100000));
+            std::vector<std::vector<char>> datagrams(Split(fragmenter, message));
+            std::shuffle(datagrams.begin(), datagrams.end(), generator);
+
+            bool dropped = false;
+            size_t sent = 0;
+            for (const auto& datagram : datagrams) {
+                if (::rand() % 100 < 2) {
+                    dropped = true;
+                    continue;
+                }
+
+                ::sendto(socket, &datagram[0], datagram.size(), 0, reinterpret_cast<sockaddr*>(&address),
+                         sizeof(address));
+                ++sent;
+            }
+
+            if (dropped) {
+                ++lost;
+            } else {
+                expected[index] = message;
+            }
+
+            // Drain the socket.
+            //
+            pollfd fds = {socket, POLLIN, 0};
+            for (; sent && ::poll(&fds, 1, 1000) == 1; --sent) {
+                ssize_t size = ::recv(socket, &buffer[0], buffer.size(), 0);
+                if (size <= 0) break;
+                void* handle = 0;
+                size_t length = 0;
+                if (reassembler.add(&buffer[0], size, now, handle, length) == DatagramReassembler::kComplete) {
+                    std::vector<char> received(pool.take(handle));
+                    if (expected.count(index) && received == expected[index]) ++intact;
+                }
+            }
+
+            now += 0.1;
+            reassembler.expire(now);
+        }
+
+        ::close(socket);
+        reassembler.expire(now + 1.0);
+
+        const DatagramReassembler::Stats& stats(reassembler.getStats());
+        assertTrue(lost > 0);
+        assertEqual(int(expected.size()), intact);
+        assertEqual(uint64_t(intact), stats.reassembled);
+        assertEqual(uint64_t(lost), stats.timeouts + stats.evicted);
+        assertEqual(uint64_t(0), stats.invalid);
+        assertEqual(0, pool.outstanding);
+    }
+}
+
+int
+main(int argc, const char* argv[])
+{
+    return Test().mainRun();
+}
@@ -0,0 +1,483 @@
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
+
+#include "ace/Guard_T.h"
+
+#include "Logger/Log.h"
+#include "Time/TimeStamp.h"
+
+#include "FanOutWriter.h"
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+using namespace SideCar::IO;
+
+namespace {
+
+/** Most messages taken from a client's queue for one gather-write.
+ */
+const size_t kMaxBatch = 64;
+
+/** Most readiness reports fetched from the kernel at once.
+ */
+const int kMaxEvents = 64;
+
+double
+Now()
+{
+    return SideCar::Time::TimeStamp::Now().asDouble();
+}
+
+} // namespace
+
+Logger::Log&
+FanOutWriter::Log()
+{
+    static Logger::Log& log_ = Logger::Log::Find("SideCar.IO.FanOutWriter");
+    return log_;
+}
+
+FanOutWriter::FanOutWriter() :
+    ACE_Task_Base(), mutex_(), changed_(mutex_), clients_(), watched_(), writable_(), poller_(-1),
+    wakeupPending_(false), stopping_(false)
+{
+    wakeup_[0] = wakeup_[1] = -1;
+}
+
+FanOutWriter::~FanOutWriter()
+{
+    stop();
+}
+
+bool
+FanOutWriter::start(long threadFlags, long threadPriority)
+{
+    static Logger::ProcLog log("start", Log());
+
+    if (::pipe(wakeup_) == -1) {
+        LOGERROR << "failed to create wakeup pipe - " << ::strerror(errno) << std::endl;
+        return false;
+    }
+
+    ::fcntl(wakeup_[0], F_SETFL, O_NONBLOCK);
+    ::fcntl(wakeup_[1], F_SETFL, O_NONBLOCK);
+
+#ifdef __linux__
+    poller_ = ::epoll_create1(EPOLL_CLOEXEC);
+    if (poller_ == -1) {
+        LOGWARNING << "epoll_create1 failed, using poll - " << ::strerror(errno) << std::endl;
+    } else {
+        epoll_event event;
+        ::memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN;
+        event.data.fd = wakeup_[0];
+        ::epoll_ctl(poller_, EPOLL_CTL_ADD, wakeup_[0], &event);
+    }
+#endif
+
+    stopping_ = false;
+    if (activate(threadFlags, 1, 0, threadPriority) == -1) {
+        LOGERROR << "failed to start writer thread" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+void
+FanOutWriter::stop()
+{
+    static Logger::ProcLog log("stop", Log());
+
+    if (thr_count()) {
+        {
+            ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
+            stopping_ = true;
+            changed_.broadcast();
+        }
+
+        wake();
+        wait();
+    }
+
+    // With the writer thread gone, nothing else uses the clients.
+    //
+    std::vector<ACE_Message_Block*> dropped;
+    for (auto& value : clients_) {
+        Client* client = value.second;
+        client->queue.clear(dropped);
+        for (const auto& item : client->outgoing) dropped.push_back(item.data);
+        delete client;
+    }
+
+    clients_.clear();
+    release(dropped);
+
+    if (poller_ != -1) ::close(poller_);
+    if (wakeup_[0] != -1) ::close(wakeup_[0]);
+    if (wakeup_[1] != -1) ::close(wakeup_[1]);
+    poller_ = wakeup_[0] = wakeup_[1] = -1;
+}
+
+bool
+FanOutWriter::addClient(ACE_HANDLE handle, const std::string& address, Queue::Policy policy, size_t depth)
+{
+    static Logger::ProcLog log("addClient", Log());
+    LOGINFO << handle << ' ' << address << " policy: " << policy << " depth: " << depth << std::endl;
+
+    int flags = ::fcntl(handle, F_GETFL);
+    if (flags == -1 || ::fcntl(handle, F_SETFL, flags | O_NONBLOCK) == -1) {
+        LOGERROR << "failed to make socket non-blocking - " << ::strerror(errno) << std::endl;
+        return false;
+    }
+
+    ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
+    if (clients_.count(handle)) {
+        LOGERROR << "socket " << handle << " is already a client" << std::endl;
+        return false;
+    }
+
+    clients_[handle] = new Client(handle, address, policy, depth);
+    return true;
+}
+
+void
+FanOutWriter::removeClient(ACE_HANDLE handle)
+{
+    static Logger::ProcLog log("removeClient", Log());
+    LOGINFO << handle << std::endl;
+
+    ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
+    ClientMap::iterator pos = clients_.find(handle);
+    if (pos == clients_.end()) return;
+
+    // The writer thread does the removal, since it may be in the middle of writing to the socket.
+    //
+    pos->second->removed = true;
+    changed_.broadcast();
+    if (!wakeupPending_) {
+        wakeupPending_ = true;
+        wake();
+    }
+
+    while (thr_count() && !stopping_ && clients_.count(handle)) changed_.wait();
+}
+
+void
+FanOutWriter::send(ACE_Message_Block* encoded)
+{
+    static Logger::ProcLog log("send", Log());
+
+    double now = Now();
+    std::vector<ACE_Message_Block*> dropped;
+    {
+        ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
+
+        // Visit by handle, since waiting for room in a blocking queue lets the map change.
+        //
+        std::vector<ACE_HANDLE> handles;
+        for (const auto& value : clients_) handles.push_back(value.first);
+
+        for (auto handle : handles) {
+            ACE_Message_Block* data = encoded->duplicate();
+            while (true) {
+                ClientMap::iterator pos = clients_.find(handle);
+                if (pos == clients_.end() || pos->second->removed || pos->second->failed || stopping_) {
+                    dropped.push_back(data);
+                    break;
+                }
+
+                if (pos->second->queue.push(data, now, dropped)) break;
+
+                LOGDEBUG << "waiting for room in queue of " << pos->second->address << std::endl;
+                changed_.wait();
+            }
+        }
+
+        if (!wakeupPending_ && !clients_.empty()) {
+            wakeupPending_ = true;
+            wake();
+        }
+    }
+
+    encoded->release();
+    release(dropped);
+}
+
+void
+FanOutWriter::getClients(std::vector<ClientInfo>& clients) const
+{
+    double now = Now();
+    clients.clear();
+    ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
+    for (const auto& value : clients_) {
+        const Client& client(*value.second);
+        if (client.removed) continue;
+        ClientInfo info;
+        info.address = client.address;
+        info.waiting = client.sending + client.queue.size();
+        info.failed = client.failed;
+        info.stats = client.queue.getStats();
+        double oldest = now;
+        if (client.sending) {
+            oldest = client.sendingSince;
+        } else {
+            client.queue.getOldest(oldest);
+        }
+
+        info.lag = now - oldest;
+        clients.push_back(info);
+    }
+}
+
+int
+FanOutWriter::svc()
+{
+    static Logger::ProcLog log("svc", Log());
+    LOGINFO << "started" << std::endl;
+
+    std::vector<Client*> work;
+    std::vector<ACE_Message_Block*> dropped;
+    while (true) {
+        waitForEvents();
+
+        // Take new messages for clients that are not waiting on their sockets, and finish off removed clients.
+        //
+        work.clear();
+        {
+            ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
+            if (stopping_) break;
+            wakeupPending_ = false;
+            double now = Now();
+            bool took = false;
+            ClientMap::iterator pos = clients_.begin();
+            while (pos != clients_.end()) {
+                Client* client = pos->second;
+                if (client->removed) {
+                    if (client->watching) watch(*client, false);
+                    client->queue.clear(dropped);
+                    for (const auto& item : client->outgoing) dropped.push_back(item.data);
+                    delete client;
+                    clients_.erase(pos++);
+                    changed_.broadcast();
+                    continue;
+                }
+
+                ++pos;
+                if (client->failed) continue;
+                if (client->watching &&
+                    std::find(writable_.begin(), writable_.end(), client->handle) == writable_.end()) {
+                    continue;
+                }
+
+                if (client->outgoing.empty()) {
+                    Client::Outgoing item;
+                    while (client->outgoing.size() < kMaxBatch && client->queue.pop(item.data, now, &item.queuedAt)) {
+                        client->outgoing.push_back(item);
+                        took = true;
+                    }
+                }
+
+                if (!client->outgoing.empty()) work.push_back(client);
+            }
+
+            if (took) changed_.broadcast();
+        }
+
+        release(dropped);
+
+        // Write without holding the lock. Only this thread deletes clients, so the pointers stay good.
+        //
+        for (auto client : work) flush(*client);
+
+        ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
+        for (auto client : work) {
+            client->sending = client->outgoing.size();
+            if (client->sending) client->sendingSince = client->outgoing.front().queuedAt;
+
+            // More may have arrived while writing. Come straight back for it if the socket has room.
+            //
+            if (!client->watching && !client->queue.empty()) wakeupPending_ = true;
+        }
+
+        if (wakeupPending_) wake();
+    }
+
+    LOGINFO << "stopped" << std::endl;
+    return 0;
+}
+
+void
+FanOutWriter::flush(Client& client)
+{
+    static Logger::ProcLog log("flush", Log());
+
+    std::vector<iovec> iovs;
+    while (!client.outgoing.empty()) {
+        iovs.clear();
+        for (const auto& item : client.outgoing) {
+            for (const ACE_Message_Block* block = item.data; block; block = block->cont()) {
+                if (!block->length()) continue;
+                iovec iov;
+                iov.iov_base = block->rd_ptr();
+                iov.iov_len = block->length();
+                iovs.push_back(iov);
+            }
+        }
+
+        // Skip what went out last time.
+        //
+        size_t skip = client.offset;
+        size_t first = 0;
+        while (skip && skip >= iovs[first].iov_len) skip -= iovs[first++].iov_len;
+        iovs[first].iov_base = static_cast<char*>(iovs[first].iov_base) + skip;
+        iovs[first].iov_len -= skip;
+
+        msghdr header;
+        ::memset(&header, 0, sizeof(header));
+        header.msg_iov = &iovs[first];
+        header.msg_iovlen = std::min(iovs.size() - first, size_t(IOV_MAX));
+
+        ssize_t rc = ::sendmsg(client.handle, &header, MSG_NOSIGNAL);
+        if (rc == -1) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                if (!client.watching) watch(client, true);
+                return;
+            }
+
+            LOGERROR << "failed to write to " << client.address << " - " << ::strerror(errno) << std::endl;
+            std::vector<ACE_Message_Block*> dropped;
+            for (const auto& item : client.outgoing) dropped.push_back(item.data);
+            client.outgoing.clear();
+            client.offset = 0;
+            if (client.watching) watch(client, false);
+            release(dropped);
+
+            ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
+            client.failed = true;
+            client.sending = 0;
+            client.queue.clear(dropped);
+
+            // Wake any producer blocked in send() waiting for room in this client's queue.
+            //
+            changed_.broadcast();
+            guard.release();
+            release(dropped);
+            return;
+        }
+
+        // Release the messages that are now completely written.
+        //
+        size_t written = client.offset + rc;
+        while (!client.outgoing.empty()) {
+            size_t size = client.outgoing.front().data->total_length();
+            if (written < size) break;
+            written -= size;
+            client.outgoing.front().data->release();
+            client.outgoing.pop_front();
+        }
+
+        client.offset = written;
+    }
+
+    client.offset = 0;
+    if (client.watching) watch(client, false);
+}
+
+void
+FanOutWriter::watch(Client& client, bool enable)
+{
+    client.watching = enable;
+    if (enable) {
+        watched_.push_back(client.handle);
+    } else {
+        watched_.erase(std::remove(watched_.begin(), watched_.end(), client.handle), watched_.end());
+    }
+
+#ifdef __linux__
+    if (poller_ != -1) {
+        epoll_event event;
+        ::memset(&event, 0, sizeof(event));
+        event.events = EPOLLOUT;
+        event.data.fd = client.handle;
+        ::epoll_ctl(poller_, enable ? EPOLL_CTL_ADD : EPOLL_CTL_DEL, client.handle, &event);
+    }
+#endif
+}
+
+void
+FanOutWriter::waitForEvents()
+{
+    static Logger::ProcLog log("waitForEvents", Log());
+
+    writable_.clear();
+    bool woken = false;
+
+#ifdef __linux__
+    if (poller_ != -1) {
+        epoll_event events[kMaxEvents];
+        int count = ::epoll_wait(poller_, events, kMaxEvents, 1000);
+        for (int index = 0; index < count; ++index) {
+            if (events[index].data.fd == wakeup_[0]) {
+                woken = true;
+            } else {
+                writable_.push_back(events[index].data.fd);
+            }
+        }
+    }
+#endif
+
+    if (poller_ == -1) {
+        std::vector<pollfd> fds(1);
+        fds[0].fd = wakeup_[0];
+        fds[0].events = POLLIN;
+        for (auto handle : watched_) {
+            pollfd fd = {handle, POLLOUT, 0};
+            fds.push_back(fd);
+        }
+
+        if (::poll(&fds[0], fds.size(), 1000) > 0) {
+            woken = fds[0].revents != 0;
+            for (size_t index = 1; index < fds.size(); ++index) {
+                if (fds[index].revents) writable_.push_back(fds[index].fd);
+            }
+        }
+    }
+
+    if (woken) {
+        char buffer[64];
+        while (::read(wakeup_[0], buffer, sizeof(buffer)) > 0)
+            ;
+    }
+}
+
+void
+FanOutWriter::wake()
+{
+    char byte = 0;
+    if (::write(wakeup_[1], &byte, 1) == -1 && errno != EAGAIN) {
+        static Logger::ProcLog log("wake", Log());
+        LOGERROR << "failed to write to wakeup pipe - " << ::strerror(errno) << std::endl;
+    }
+}
+
+void
+FanOutWriter::release(std::vector<ACE_Message_Block*>& blocks)
+{
+    for (auto block : blocks) block->release();
+    blocks.clear();
+}
@@ -0,0 +1,171 @@
+#ifndef SIDECAR_IO_FANOUTWRITER_H // -*- C++ -*-
+#define SIDECAR_IO_FANOUTWRITER_H
+
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "ace/Condition_T.h"
+#include "ace/Message_Block.h"
+#include "ace/Task.h"
+#include "ace/Thread_Mutex.h"
+
+#include "IO/SendQueue.h"
+
+namespace Logger {
+class Log;
+}
+
+namespace SideCar {
+namespace IO {
+
+/** Sends already-encoded messages to many connected sockets from one thread. Each client has its own bounded
+    SendQueue of references to the shared encoded data, so a message is encoded once no matter how many clients
+    there are, and a slow client only ever backs up its own queue. The writer thread sleeps in epoll (poll() on
+    platforms without it) on a wakeup pipe plus the sockets of clients whose kernel buffers are full, and writes
+    to the sockets without blocking.
+
+    Only the kBlock policy can hold up the producer calling send(); use it only for clients that must see every
+    message.
+*/
+class FanOutWriter : public ACE_Task_Base {
+public:
+    using Queue = SendQueue<ACE_Message_Block*>;
+
+    /** Snapshot of the state of one client.
+     */
+    struct ClientInfo {
+        std::string address;
+        size_t waiting; ///< Messages queued or partly sent
+        double lag;     ///< Age of the oldest message not yet fully sent, in seconds
+        bool failed;    ///< True if a write to the client failed
+        Queue::Stats stats;
+    };
+
+    static Logger::Log& Log();
+
+    FanOutWriter();
+
+    ~FanOutWriter();
+
+    /** Start the writer thread.
+
+        \param threadFlags ACE thread flags
+
+        \param threadPriority thread priority
+
+        \return true if successful
+    */
+    bool start(long threadFlags, long threadPriority);
+
+    /** Stop the writer thread, and drop all clients.
+     */
+    void stop();
+
+    /** Add a client. The socket is made non-blocking.
+
+        \param handle connected socket
+
+        \param address description of the client for reports
+
+        \param policy what to do when the client's queue is full
+
+        \param depth most messages to queue for the client
+
+        \return true if successful
+    */
+    bool addClient(ACE_HANDLE handle, const std::string& address, Queue::Policy policy, size_t depth);
+
+    /** Remove a client. Once this returns, the writer thread no longer touches the socket, and the caller may
+        close it. Data not yet sent is dropped.
+
+        \param handle socket given to addClient()
+    */
+    void removeClient(ACE_HANDLE handle);
+
+    /** Queue an encoded message for every client.
+
+        \param encoded message data, which the writer takes over
+    */
+    void send(ACE_Message_Block* encoded);
+
+    /** Obtain the state of all clients.
+
+        \param clients storage for the results
+    */
+    void getClients(std::vector<ClientInfo>& clients) const;
+
+private:
+    struct Client {
+        Client(ACE_HANDLE h, const std::string& a, Queue::Policy policy, size_t depth) :
+            handle(h), address(a), queue(policy, depth), failed(false), removed(false), sending(0), sendingSince(0.0),
+            outgoing(), offset(0), watching(false)
+        {
+        }
+
+        /** Message taken from the queue for writing.
+         */
+        struct Outgoing {
+            ACE_Message_Block* data;
+            double queuedAt;
+        };
+
+        ACE_HANDLE handle;
+        std::string address;
+
+        // Guarded by mutex_
+        //
+        Queue queue;
+        bool failed;
+        bool removed;
+        size_t sending;      ///< Copy of outgoing.size() for reports
+        double sendingSince; ///< Time the first outgoing message was queued, for reports
+
+        // Only used by the writer thread
+        //
+        std::deque<Outgoing> outgoing;
+        size_t offset; ///< Bytes of the first outgoing message already written
+        bool watching; ///< True if waiting for the socket to become writable
+    };
+
+    using ClientMap = std::map<ACE_HANDLE, Client*>;
+
+    int svc();
+
+    /** Write as much as the socket will take without blocking.
+
+        \param client the client to write to
+    */
+    void flush(Client& client);
+
+    /** Ask for or cancel notification when a client's socket becomes writable.
+     */
+    void watch(Client& client, bool enable);
+
+    /** Block until there is something to do: a wakeup, or a watched socket that is writable.
+     */
+    void waitForEvents();
+
+    void wake();
+
+    void release(std::vector<ACE_Message_Block*>& blocks);
+
+    mutable ACE_Thread_Mutex mutex_;
+    ACE_Condition<ACE_Thread_Mutex> changed_; ///< Signalled when queues drain or clients go away
+    ClientMap clients_;
+    std::vector<ACE_HANDLE> watched_;  ///< Sockets waiting to become writable
+    std::vector<ACE_HANDLE> writable_; ///< Watched sockets reported writable by waitForEvents()
+    int poller_;                       ///< epoll instance, or -1 if not available
+    int wakeup_[2];
+    bool wakeupPending_;
+    volatile bool stopping_;
+};
+
+} // end namespace IO
+} // end namespace SideCar
+
+/** \file
+ */
+
+#endif
@@ -0,0 +1,155 @@
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "ace/Message_Block.h"
+#include "ace/OS_NS_unistd.h"
+#include "ace/Task.h"
+
+#include "UnitTest/UnitTest.h"
+
+#include "FanOutWriter.h"
+
+using namespace SideCar::IO;
+
+struct Test : public UnitTest::TestObj {
+    Test() : UnitTest::TestObj("FanOutWriter") {}
+    void test();
+};
+
+/** Thread that sends messages to a FanOutWriter until it has sent them all.
+ */
+struct Producer : public ACE_Task_Base {
+    Producer(FanOutWriter& writer, int count) : writer_(writer), count_(count), sent_(0) {}
+
+    int svc()
+    {
+        for (; sent_ < count_; ++sent_) {
+            ACE_Message_Block* data = new ACE_Message_Block(64 * 1024);
+            data->wr_ptr(data->size());
+            writer_.send(data);
+        }
+        return 0;
+    }
+
+    FanOutWriter& writer_;
+    int count_;
+    volatile int sent_;
+};
+
+/** Thread that reads from a socket until it has seen a given number of bytes or the socket closes.
+ */
+struct Reader : public ACE_Task_Base {
+    Reader(int fd, size_t expected) : fd_(fd), expected_(expected), received_(0) {}
+
+    int svc()
+    {
+        std::vector<char> buffer(64 * 1024);
+        while (received_ < expected_) {
+            ssize_t count = ::read(fd_, buffer.data(), buffer.size());
+            if (count <= 0) break;
+            received_ += count;
+        }
+        return 0;
+    }
+
+    int fd_;
+    size_t expected_;
+    volatile size_t received_;
+};
+
+/** Poll for a condition for up to two seconds.
+ */
+template <typename Pred>
+static bool
+WaitFor(Pred pred)
+{
+    for (int count = 0; count < 200; ++count) {
+        if (pred()) return true;
+        ACE_OS::sleep(ACE_Time_Value(0, 10000));
+    }
+    return pred();
+}
+
+void
+Test::test()
+{
+    // A client that never reads, with a blocking queue, soon holds up the producer.
+    //
+    int fds[2];
+    assertEqual(0, ::socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+    int size = 4096;
+    ::setsockopt(fds[0], SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+
+    FanOutWriter writer;
+    assertTrue(writer.start(THR_NEW_LWP | THR_JOINABLE, 0));
+    assertTrue(writer.addClient(fds[0], "pair", FanOutWriter::Queue::kBlock, 2));
+
+    Producer producer(writer, 32);
+    assertEqual(0, producer.activate(THR_NEW_LWP | THR_JOINABLE));
+
+    std::vector<FanOutWriter::ClientInfo> clients;
+    assertTrue(WaitFor([&]() {
+        writer.getClients(clients);
+        return clients.size() == 1 && clients[0].stats.queued > 2 && clients[0].waiting >= 2;
+    }));
+    ACE_OS::sleep(ACE_Time_Value(0, 100000));
+    assertTrue(producer.sent_ < 32);
+
+    // Once the client goes away, its writes fail and the producer must no longer wait on it.
+    //
+    ::close(fds[1]);
+    assertTrue(WaitFor([&]() { return producer.sent_ == 32; }));
+    producer.wait();
+
+    writer.getClients(clients);
+    assertEqual(size_t(1), clients.size());
+    assertTrue(clients[0].failed);
+    assertEqual(size_t(0), clients[0].waiting);
+
+    writer.removeClient(fds[0]);
+    ::close(fds[0]);
+
+    // A stalled client that may drop messages does not hold up the producer, nor delay a client that keeps up,
+    // even one that must see every message.
+    //
+    int stalled[2];
+    int healthy[2];
+    assertEqual(0, ::socketpair(AF_UNIX, SOCK_STREAM, 0, stalled));
+    assertEqual(0, ::socketpair(AF_UNIX, SOCK_STREAM, 0, healthy));
+    ::setsockopt(stalled[0], SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+    assertTrue(writer.addClient(stalled[0], "stalled", FanOutWriter::Queue::kDropOldest, 2));
+    assertTrue(writer.addClient(healthy[0], "healthy", FanOutWriter::Queue::kBlock, 2));
+
+    Reader reader(healthy[1], 64 * 64 * 1024);
+    assertEqual(0, reader.activate(THR_NEW_LWP | THR_JOINABLE));
+    Producer second(writer, 64);
+    assertEqual(0, second.activate(THR_NEW_LWP | THR_JOINABLE));
+
+    assertTrue(WaitFor([&]() { return second.sent_ == 64 && reader.received_ == reader.expected_; }));
+    second.wait();
+    reader.wait();
+
+    writer.getClients(clients);
+    assertEqual(size_t(2), clients.size());
+    for (const auto& client : clients) {
+        if (client.address == "stalled") {
+            assertTrue(client.stats.dropped > 0);
+        } else {
+            assertEqual(uint64_t(0), client.stats.dropped);
+            assertEqual(uint64_t(64), client.stats.sent);
+        }
+    }
+
+    writer.removeClient(stalled[0]);
+    writer.removeClient(healthy[0]);
+    for (int fd : {stalled[0], stalled[1], healthy[0], healthy[1]}) ::close(fd);
+    writer.stop();
+}
+
+int
+main(int argc, const char* argv[])
+{
+    return Test().mainRun();
+}
@@ -7,6 +7,7 @@
 #include "IO/ControlMessage.h"
 #include "IO/Decoder.h"
 #include "Messages/Header.h"
+#include "Time/TimeStamp.h"
 #include "Utils/Pool.h"
 #include "Utils/Utils.h"
 #include "XMLRPC/XmlRpcValue.h"
@@ -69,7 +70,7 @@ public:
     struct MetaData {
         /** Constructor.
          */
-        MetaData() : native() {}
+        MetaData() : native(), posted(Time::TimeStamp::Now()) {}
 
         /** Shared reference to a native message object, one that has either been decoded from the network or
             file, or one that was given to an MessageManager constructor.
@@ -81,6 +82,12 @@ public:
             is the value from the Messages::Header::getSize() virtual method.
         */
         size_t size;
+
+        /** When the MetaData was created, which is when a native message was handed to a MessageManager for
+            sending, or when an encoded message was decoded. Consumers use it to measure how long the message
+            waited in their input queue.
+        */
+        Time::TimeStamp posted;
     };
 
     /** Obtain the log device for MessageManager objects
@@ -301,6 +308,12 @@ public:
     */
     size_t getMessageSize() const { return metaData_ ? metaData_->size : 0; }
 
+    /** Obtain the time when the managed message was posted for delivery (see MetaData::posted).
+
+        \return time stamp, or Time::TimeStamp::Min() if there is no MetaData
+    */
+    Time::TimeStamp getPostedTimeStamp() const { return metaData_ ? metaData_->posted : Time::TimeStamp::Min(); }
+
     /** Obtain a shallow copy of the held ACE_Message_Block. Caller is responsible for releasing it. This is a
         very fast operation since new ACE_Message_Block objects are fetched from an allocation pool, and they
         only contain pointers and offset into an ACE_Data_Block, which is not replicated but shared among
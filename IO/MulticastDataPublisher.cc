@@ -1,5 +1,9 @@
+#include <cstdlib>
+#include <cstring>
 #include <sstream>
 
+#include "ace/Guard_T.h"
+#include "ace/OS_NS_unistd.h"
 #include "ace/Reactor.h"
 
 #include "Logger/Log.h"
@@ -27,7 +31,8 @@ MulticastDataPublisher::Make()
     return ref;
 }
 
-MulticastDataPublisher::MulticastDataPublisher() : Super(), writer_(), heartBeatReader_(), timer_(-1), heartBeats_()
+MulticastDataPublisher::MulticastDataPublisher() :
+    Super(), writer_(), heartBeatReader_(), timer_(-1), heartBeats_(), sender_(), senderMutex_(), simulatedLoss_(0.0)
 {
     ;
 }
@@ -37,6 +42,20 @@ MulticastDataPublisher::~MulticastDataPublisher()
     ;
 }
 
+void
+MulticastDataPublisher::setReliability(size_t windowSize, size_t groupSize, double rate, double simulatedLoss)
+{
+    static Logger::ProcLog log("setReliability", Log());
+    LOGINFO << "windowSize: " << windowSize << " groupSize: " << groupSize << " rate: " << rate
+            << " simulatedLoss: " << simulatedLoss << std::endl;
+    sender_.reset(new ReliableMulticastSender(windowSize, groupSize, rate));
+    simulatedLoss_ = simulatedLoss;
+
+    // Large messages become fragments before they are framed, so leave room for the framing header.
+    //
+    writer_.setMaxDatagramSize(DatagramFragmenter::kDefaultMaxDatagramSize - ReliableMulticastPacket::kHeaderSize);
+}
+
 void
 MulticastDataPublisher::setServiceName(const std::string& serviceName)
 {
@@ -139,6 +158,7 @@ MulticastDataPublisher::openAndInit(const std::string& key, const std::string& s
     std::ostringstream os;
     os << address.get_port_number();
     getConnectionPublisher()->setTextData("HeartBeatPort", os.str());
+    if (sender_) getConnectionPublisher()->setTextData("reliable", "1");
 
     // Now we are ready to publish our connection information.
     //
@@ -215,14 +235,20 @@ MulticastDataPublisher::handle_input(ACE_HANDLE handle)
     // Fetch the heart-beat message. Should be 'HI' or 'BYE'. Actually, this whole routine should be refactored
     // into another class.
     //
-    ACE_TCHAR buffer[16];
+    ACE_TCHAR buffer[1500];
     ACE_INET_Addr address;
-    ssize_t count = heartBeatReader_.recv(buffer, sizeof(buffer), address);
+    ssize_t count = heartBeatReader_.recv(buffer, sizeof(buffer) - 1, address);
     if (count < 1) {
         LOGERROR << "failed recv - " << errno << ' ' << strerror(errno) << std::endl;
         return 0;
     }
 
+    if (count > 4 && ::memcmp(buffer, "NACK", 4) == 0) {
+        handleNack(buffer + 4, count - 4);
+        return 0;
+    }
+
+    buffer[count] = 0;
     std::string msg(buffer);
     LOGDEBUG << "msg: " << msg << std::endl;
 
@@ -260,6 +286,15 @@ MulticastDataPublisher::handle_timeout(const ACE_Time_Value& duration, const voi
 
     if (arg != &timer_) return Super::handle_timeout(duration, arg);
 
+    if (sender_) {
+        ACE_Guard<ACE_Thread_Mutex> guard(senderMutex_);
+        const ReliableMulticastSender::Stats& stats(sender_->getStats());
+        std::ostringstream os;
+        os << "Sent: " << stats.sent << " Parity: " << stats.parity << " Resent: " << stats.retransmitted
+           << " Too Late: " << stats.tooLate << " Rate: " << int(stats.rate / 1024) << " KB/s";
+        setConnectionInfo(os.str());
+    }
+
     if (heartBeats_.empty()) return 0;
 
     // Calculate a time that is 60 seconds ago. If a timestamp is older than that, assume the connection is
@@ -308,12 +343,118 @@ MulticastDataPublisher::svc()
     ACE_Message_Block* data;
     while (getq(data) != -1) {
         MessageManager mgr(data);
-        if (!writer_.write(mgr)) { LOGERROR << "failed to send the message" << std::endl; }
+        if (!(sender_ ? writeReliable(mgr) : writer_.write(mgr))) {
+            LOGERROR << "failed to send the message" << std::endl;
+        }
     }
 
     return 0;
 }
 
+bool
+MulticastDataPublisher::writeReliable(const MessageManager& mgr)
+{
+    static Logger::ProcLog log("writeReliable", Log());
+
+    ACE_Message_Block* encoded = mgr.getEncoded();
+    if (!encoded) return false;
+
+    ReliableMulticastSender::Bytes bytes;
+    bytes.reserve(encoded->total_length());
+    for (ACE_Message_Block* block = encoded; block; block = block->cont()) {
+        bytes.insert(bytes.end(), block->rd_ptr(), block->wr_ptr());
+    }
+
+    encoded->release();
+
+    // Messages too large for one datagram go out as fragments, each framed and repaired on its own.
+    //
+    std::vector<ReliableMulticastSender::Bytes> pieces;
+    DatagramFragmenter* fragmenter = writer_.getFragmenter();
+    if (fragmenter->needsFragments(bytes.size())) {
+        IOV iov(&bytes[0], bytes.size());
+        std::vector<DatagramFragmenter::Fragment> fragments;
+        if (!fragmenter->split(&iov, 1, bytes.size(), fragments)) return false;
+        pieces.resize(fragments.size());
+        for (size_t index = 0; index < fragments.size(); ++index) {
+            const DatagramFragmenter::Fragment& fragment(fragments[index]);
+            ReliableMulticastSender::Bytes& piece(pieces[index]);
+            piece.assign(fragment.header, fragment.header + DatagramFragmenter::kHeaderSize);
+            const char* data = static_cast<const char*>(fragment.iovs[0].iov_base);
+            piece.insert(piece.end(), data, data + fragment.iovs[0].iov_len);
+        }
+    } else {
+        pieces.resize(1);
+        pieces[0].swap(bytes);
+    }
+
+    std::vector<ReliableMulticastSender::Bytes> packets;
+    {
+        ACE_Guard<ACE_Thread_Mutex> guard(senderMutex_);
+        for (const auto& piece : pieces) sender_->wrap(&piece[0], piece.size(), packets);
+    }
+
+    bool ok = true;
+    for (const auto& packet : packets) {
+        double delay;
+        {
+            ACE_Guard<ACE_Thread_Mutex> guard(senderMutex_);
+            delay = sender_->pace(packet.size(), Time::TimeStamp::Now().asDouble());
+        }
+
+        // NOTE: ACE_Time_Value(delay) would truncate the delay to whole seconds.
+        //
+        if (delay > 0.0) {
+            ACE_Time_Value tv;
+            tv.set(delay);
+            ACE_OS::sleep(tv);
+        }
+
+        if (simulatedLoss_ > 0.0 && ::drand48() < simulatedLoss_) {
+            LOGDEBUG << "dropping packet on purpose" << std::endl;
+            continue;
+        }
+
+        ok = sendPacket(packet) && ok;
+    }
+
+    return ok;
+}
+
+void
+MulticastDataPublisher::handleNack(const char* data, size_t size)
+{
+    static Logger::ProcLog log("handleNack", Log());
+    if (!sender_) return;
+
+    for (; size >= 8; data += 8, size -= 8) {
+        uint64_t sequence = 0;
+        for (int index = 0; index < 8; ++index) sequence = (sequence << 8) | uint8_t(data[index]);
+        LOGDEBUG << "NACK " << sequence << std::endl;
+
+        ReliableMulticastSender::Bytes packet;
+        bool found;
+        {
+            ACE_Guard<ACE_Thread_Mutex> guard(senderMutex_);
+            found = sender_->nack(sequence, packet);
+        }
+
+        if (found) sendPacket(packet);
+    }
+}
+
+bool
+MulticastDataPublisher::sendPacket(const ReliableMulticastSender::Bytes& packet)
+{
+    static Logger::ProcLog log("sendPacket", Log());
+    if (writer_.getDevice().send(&packet[0], packet.size(), writer_.getRemoteAddress()) != ssize_t(packet.size())) {
+        LOGERROR << "failed send - " << errno << ' ' << ::strerror(errno) << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
 bool
 MulticastDataPublisher::calculateUsingDataValue() const
 {
@@ -5,9 +5,12 @@
 #include <string>
 
 #include "ace/SOCK_Dgram.h"
+#include "ace/Thread_Mutex.h"
+#include "boost/scoped_ptr.hpp"
 
 #include "IO/DataPublisher.h"
 #include "IO/Module.h"
+#include "IO/ReliableMulticast.h"
 #include "IO/Writers.h"
 #include "IO/ZeroconfRegistry.h"
 #include "Time/TimeStamp.h"
@@ -36,6 +39,12 @@ namespace IO {
     subscriber closes the multicast connection, it sends a 'BYE' heart-beat so that the publisher will know
     immediately that it has one less subscriber. If for some reason, the 'BYE' does not make it through to the
     publisher, the periodic scan mentioned above will take care of it.
+
+    With setReliability(), messages go out through a ReliableMulticastSender: each datagram carries a sequence
+    number, parity packets follow each group of messages, and sending is paced to a byte rate. Subscribers send
+    'NACK' messages to the heart-beat port for sequence numbers they miss, and the publisher multicasts the
+    packets again from its retransmission window. The Zeroconf text record holds "reliable=1" so that subscribers
+    know to expect the framing.
 */
 class MulticastDataPublisher : public DataPublisher, public ZeroconfTypes::Publisher {
     using Super = DataPublisher;
@@ -71,6 +80,18 @@ public:
     bool openAndInit(const std::string& key, const std::string& serviceName, const std::string& ip,
                      long threadFlags = kDefaultThreadFlags, long threadPriority = ACE_DEFAULT_THREAD_PRIORITY);
 
+    /** Send through the reliability layer. Must be called before openAndInit().
+
+        \param windowSize number of recent messages held for retransmission
+
+        \param groupSize number of messages covered by each parity packet, or 0 for none
+
+        \param rate pacing rate in bytes per second, or 0 for no pacing
+
+        \param simulatedLoss fraction of first transmissions to drop on purpose, for testing
+    */
+    void setReliability(size_t windowSize, size_t groupSize, double rate, double simulatedLoss = 0.0);
+
     /** Override of DataPublisher method. The service is being shutdown.
 
         \param flags if 1 module is shutting down
@@ -135,6 +156,30 @@ private:
     */
     int svc();
 
+    /** Send a message through the reliability layer.
+
+        \param mgr message to send
+
+        \return true if successful
+    */
+    bool writeReliable(const MessageManager& mgr);
+
+    /** Handle a NACK from a subscriber: a list of 64-bit sequence numbers in network byte order.
+
+        \param data first sequence number
+
+        \param size number of bytes of sequence numbers
+    */
+    void handleNack(const char* data, size_t size);
+
+    /** Multicast a packet of the reliability layer.
+
+        \param packet bytes to send
+
+        \return true if successful
+    */
+    bool sendPacket(const ReliableMulticastSender::Bytes& packet);
+
     UDPSocketWriter writer_;
     long threadFlags_;
     long threadPriority_;
@@ -142,6 +187,9 @@ private:
     long timer_;
     using HeartBeatMap = std::map<std::string, Time::TimeStamp>;
     HeartBeatMap heartBeats_;
+    boost::scoped_ptr<ReliableMulticastSender> sender_;
+    ACE_Thread_Mutex senderMutex_; ///< Guards sender_ between the writer thread and NACK handling
+    double simulatedLoss_;
 };
 
 using MulticastDataPublisherModule = TModule<MulticastDataPublisher>;
@@ -1,19 +1,27 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
 #include <sstream>
+#include <vector>
 
+#include "ace/CDR_Base.h"
 #include "ace/Event_Handler.h"
 #include "ace/Guard_T.h"
 #include "ace/Reactor.h"
+#include "boost/scoped_ptr.hpp"
 
 #include "Logger/Log.h"
+#include "Time/TimeStamp.h"
 #include "Utils/Format.h"
 #include "Zeroconf/ACEMonitor.h"
 
 #include "MessageManager.h"
 #include "MulticastDataSubscriber.h"
 #include "Readers.h"
+#include "ReliableMulticast.h"
 
 static int kHeartBeatInterval = 2;         // seconds
 static int kAttemptConnectionInterval = 1; // seconds
@@ -34,7 +42,10 @@ public:
 
         \param owner
     */
-    ReaderThread(MulticastDataSubscriber* owner) : Super(), owner_(owner), reader_(), active_(false) {}
+    ReaderThread(MulticastDataSubscriber* owner) :
+        Super(), owner_(owner), reader_(), active_(false), receiver_(), statsMutex_(), stats_(), fragmentStats_()
+    {
+    }
 
     /** Initialize the ReaderThread. Attempt to join a multicast broadcast, and if successful, start a new
         thread to read data from the socket.
@@ -43,9 +54,12 @@ public:
 
         \param bufferSize value to give to SO_RCVBUF socket setting
 
+        \param reliable true if the publisher sends through the reliability layer
+
         \return true if successful, false otherwise
     */
-    bool openAndInit(const ACE_INET_Addr& remoteAddress, int bufferSize, long threadFlags, long threadPriority)
+    bool openAndInit(const ACE_INET_Addr& remoteAddress, int bufferSize, long threadFlags, long threadPriority,
+                     bool reliable)
     {
         static Logger::ProcLog log("open", Log());
         LOGINFO << "remoteAddress: " << remoteAddress.get_host_addr() << '/' << remoteAddress.get_port_number()
@@ -80,6 +94,8 @@ public:
             }
         }
 
+        if (reliable) receiver_.reset(new ReliableMulticastReceiver);
+
         // Activate the message queue before we create a new thread, since the thread uses the queue
         // deactivation state as a signal to quit.
         //
@@ -119,6 +135,30 @@ public:
         return Super::close(flags);
     }
 
+    /** Obtain the counters of the reliability layer.
+
+        \param stats storage for the counters
+
+        \return false if the publisher does not use the reliability layer
+    */
+    bool getStats(ReliableMulticastReceiver::Stats& stats)
+    {
+        if (!receiver_) return false;
+        ACE_Guard<ACE_Thread_Mutex> guard(statsMutex_);
+        stats = stats_;
+        return true;
+    }
+
+    /** Obtain the counters of fragment reassembly.
+
+        \param stats storage for the counters
+    */
+    void getFragmentStats(DatagramReassembler::Stats& stats)
+    {
+        ACE_Guard<ACE_Thread_Mutex> guard(statsMutex_);
+        stats = fragmentStats_;
+    }
+
 private:
     /** Method run in a separate thread due to ACE_Task::activate() being invoked. Read data from a multicast
         UDP socket, and if fetched a valid datagram, place onto internal message queue. The read attempt has a
@@ -131,7 +171,10 @@ private:
     {
         static Logger::ProcLog log("svc", Log());
         LOGINFO << owner_->getTaskName() << std::endl;
-        ACE_Time_Value timeout(1, 0);
+
+        // The reliability layer needs to check for holes every few milliseconds, even when nothing arrives.
+        //
+        ACE_Time_Value timeout(receiver_ ? ACE_Time_Value(0, 5000) : ACE_Time_Value(1, 0));
         reader_.setFetchTimeout(&timeout);
 
         while (active_) {
@@ -142,16 +185,67 @@ private:
 
             if (!active_) break;
 
-            if (reader_.isMessageAvailable()) { owner_->acquireExternalMessage(reader_.getMessage()); }
+            if (receiver_) {
+                processReliable();
+            } else {
+                if (reader_.isMessageAvailable()) owner_->acquireExternalMessage(reader_.getMessage());
+                ACE_Guard<ACE_Thread_Mutex> guard(statsMutex_);
+                fragmentStats_ = reader_.getFragmentStats();
+            }
         }
 
         LOGINFO << owner_->getTaskName() << " exiting" << std::endl;
         return 0;
     }
 
+    /** Give any new datagram to the reliability layer, send NACKs for holes, and pass on the messages that are
+        ready in sequence order.
+    */
+    void processReliable()
+    {
+        double now = Time::TimeStamp::Now().asDouble();
+        std::vector<ReliableMulticastReceiver::Bytes> messages;
+        if (reader_.isMessageAvailable()) {
+            ACE_Message_Block* data = reader_.getMessage();
+            receiver_->add(data->rd_ptr(), data->length(), now, messages);
+            data->release();
+        }
+
+        std::vector<uint64_t> nacks;
+        receiver_->poll(now, nacks, messages);
+        if (!nacks.empty()) owner_->sendNacks(nacks);
+
+        for (const auto& message : messages) {
+            // Keep the copy CDR-aligned, as the Decoder expects.
+            //
+            ACE_Message_Block* data = MessageManager::MakeMessageBlock(message.size() + ACE_CDR::MAX_ALIGNMENT);
+            ACE_CDR::mb_align(data);
+            ::memcpy(data->wr_ptr(), &message[0], message.size());
+            data->wr_ptr(message.size());
+
+            // Large messages arrive as fragments, each delivered reliably.
+            //
+            ACE_Message_Block* complete;
+            if (reader_.reassemble(data, complete)) {
+                data->release();
+                data = complete;
+            }
+
+            if (data) owner_->acquireExternalMessage(data);
+        }
+
+        ACE_Guard<ACE_Thread_Mutex> guard(statsMutex_);
+        stats_ = receiver_->getStats();
+        fragmentStats_ = reader_.getFragmentStats();
+    }
+
     MulticastDataSubscriber* owner_;
     MulticastSocketReader reader_;
     volatile bool active_;
+    boost::scoped_ptr<ReliableMulticastReceiver> receiver_;
+    ACE_Thread_Mutex statsMutex_;
+    ReliableMulticastReceiver::Stats stats_;
+    DatagramReassembler::Stats fragmentStats_;
 };
 
 } // namespace IO
@@ -183,7 +277,7 @@ MulticastDataSubscriber::Make()
 
 MulticastDataSubscriber::MulticastDataSubscriber() :
     Super(), address_(), reader_(0), bufferSize_(0), timer_(-1), heartBeatAddress_(),
-    heartBeatWriter_(ACE_INET_Addr(uint16_t(0))), closing_(false)
+    heartBeatWriter_(ACE_INET_Addr(uint16_t(0))), closing_(false), reliable_(false)
 {
     ;
 }
@@ -267,6 +361,7 @@ MulticastDataSubscriber::resolvedService(const Zeroconf::ServiceEntry::Ref& serv
     uint16_t port;
     is >> port;
     heartBeatAddress_.set(port, resolved.getNativeHost().c_str(), 1, AF_INET);
+    reliable_ = resolved.getTextEntry("reliable") == "1";
 
     // Attempt to enter the last processing state we were in before we had an error. NOTE: this may invoke our
     // setUsingData() method which may attempt to acquire our mutex. BE CAREFUL!
@@ -318,7 +413,7 @@ MulticastDataSubscriber::attemptConnection()
     //
     reader_ = new ReaderThread(this);
 
-    if (!reader_->openAndInit(address_, bufferSize_, threadFlags_, threadPriority_)) {
+    if (!reader_->openAndInit(address_, bufferSize_, threadFlags_, threadPriority_, reliable_)) {
         LOGERROR << getTaskName() << " failed to start reader thread" << std::endl;
 
         // Clean up anything left over from trying to open the reader.
@@ -382,6 +477,23 @@ MulticastDataSubscriber::handle_timeout(const ACE_Time_Value& duration, const vo
         attemptConnection();
     } else {
         sendHeartBeat("HI");
+        std::ostringstream os;
+        ReliableMulticastReceiver::Stats stats;
+        if (reader_->getStats(stats)) {
+            os << "Recovered: " << stats.recoveredByNack << " NACK " << stats.recoveredByFec
+               << " FEC Unrecovered: " << stats.unrecovered << " Repair: " << std::fixed << std::setprecision(1)
+               << (stats.recoveries ? stats.recoveryTotal / stats.recoveries * 1000.0 : 0.0) << '/'
+               << stats.recoveryMax * 1000.0 << " ms ";
+        }
+
+        DatagramReassembler::Stats fragmentStats;
+        reader_->getFragmentStats(fragmentStats);
+        if (fragmentStats.fragments) {
+            os << "Fragments: " << fragmentStats.fragments << " Reassembled: " << fragmentStats.reassembled
+               << " Timeouts: " << fragmentStats.timeouts + fragmentStats.evicted;
+        }
+
+        if (!os.str().empty()) setConnectionInfo(os.str());
     }
 
     return 0;
@@ -400,6 +512,30 @@ MulticastDataSubscriber::sendHeartBeat(const char* msg) const
     }
 }
 
+void
+MulticastDataSubscriber::sendNacks(const std::vector<uint64_t>& sequences) const
+{
+    static Logger::ProcLog log("sendNacks", Log());
+    LOGINFO << getTaskName() << ' ' << sequences.size() << std::endl;
+
+    // Stay within one Ethernet frame per NACK message.
+    //
+    const size_t kMaxPerMessage = 180;
+    for (size_t first = 0; first < sequences.size(); first += kMaxPerMessage) {
+        size_t count = std::min(sequences.size() - first, kMaxPerMessage);
+        std::vector<char> msg(4 + count * 8);
+        ::memcpy(&msg[0], "NACK", 4);
+        for (size_t index = 0; index < count; ++index) {
+            uint64_t sequence = sequences[first + index];
+            for (int byte = 7; byte >= 0; --byte, sequence >>= 8) msg[4 + index * 8 + byte] = char(sequence & 0xFF);
+        }
+
+        if (heartBeatWriter_.send(&msg[0], msg.size(), heartBeatAddress_) != ssize_t(msg.size())) {
+            LOGERROR << "failed to send NACK message - " << errno << ": " << ::strerror(errno) << std::endl;
+        }
+    }
+}
+
 void
 MulticastDataSubscriber::setUsingData(bool state)
 {
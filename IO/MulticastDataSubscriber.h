@@ -1,6 +1,9 @@
 #ifndef SIDECAR_IO_MULTICASTDATASUBSCRIBER_H // -*- C++ -*-
 #define SIDECAR_IO_MULTICASTDATASUBSCRIBER_H
 
+#include <cstdint>
+#include <vector>
+
 #include "ace/SOCK_Dgram.h"
 #include "ace/Thread_Mutex.h"
 
@@ -18,6 +21,10 @@ namespace IO {
 
 /** Subscriber of data using the UDP multicast transport. Relies on a MulticastSocketReader object to do the
     receiving. This class manages the connection state based on Zeroconf information.
+
+    If the publisher advertises "reliable=1", datagrams go through a ReliableMulticastReceiver, which puts them
+    back in order, repairs holes from parity packets, and asks the publisher for the rest with NACK messages
+    sent to its heart-beat port. The repair counters appear in the connection info of the task.
 */
 class MulticastDataSubscriber : public DataSubscriber, public ZeroconfTypes::Subscriber {
     using Super = DataSubscriber;
@@ -117,6 +124,12 @@ private:
 
     void sendHeartBeat(const char* msg) const;
 
+    /** Ask the publisher to send some packets again. Called by the reader thread.
+
+        \param sequences sequence numbers of the missing packets
+    */
+    void sendNacks(const std::vector<uint64_t>& sequences) const;
+
     void startTimer(int intervalSeconds);
 
     void stopTimer();
@@ -132,6 +145,7 @@ private:
     long threadFlags_;
     long threadPriority_;
     bool closing_;
+    bool reliable_;
 };
 
 using MulticastDataSubscriberModule = TModule<MulticastDataSubscriber>;
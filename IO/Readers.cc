@@ -3,6 +3,7 @@
 
 #include "Logger/Log.h"
 #include "Messages/RawVideoHeader.h"
+#include "Time/TimeStamp.h"
 #include "Utils/Format.h"
 
 #include "Decoder.h"
@@ -201,7 +202,7 @@ DatagramReader::Log()
     return log_;
 }
 
-DatagramReader::DatagramReader(size_t maxSize) : building_(0)
+DatagramReader::DatagramReader(size_t maxSize) : Reader(), building_(0), reassembler_(*this)
 {
     makeIncomingBuffer(maxSize);
 }
@@ -233,7 +234,9 @@ DatagramReader::fetchInput()
     LOGINFO << std::endl;
     if (isMessageAvailable()) { LOGERROR << "fetching while message is available" << std::endl; }
 
-    ssize_t fetched = fetchFromDevice(building_->wr_ptr(), building_->size());
+    if (reassembler_.getPendingCount()) reassembler_.expire(Time::TimeStamp::Now().asDouble());
+
+    ssize_t fetched = fetchFromDevice(building_->wr_ptr(), building_->space());
     LOGDEBUG << "fetched: " << fetched << std::endl;
     switch (fetched) {
     case -1: // device err
@@ -252,12 +255,60 @@ DatagramReader::fetchInput()
     }
 
     building_->wr_ptr(fetched);
-    setAvailable(building_);
-    makeIncomingBuffer(building_->size());
+
+    // Fragments get copied into their message, so the receive buffer can take the next datagram.
+    //
+    ACE_Message_Block* complete = 0;
+    if (!reassemble(building_, complete)) {
+        setAvailable(building_);
+        makeIncomingBuffer(building_->size());
+    } else {
+        building_->reset();
+        ACE_CDR::mb_align(building_);
+        if (complete) setAvailable(complete);
+    }
 
     return true;
 }
 
+bool
+DatagramReader::reassemble(const ACE_Message_Block* data, ACE_Message_Block*& complete)
+{
+    static Logger::ProcLog log("reassemble", Log());
+
+    complete = 0;
+    void* handle = 0;
+    size_t length = 0;
+    switch (reassembler_.add(data->rd_ptr(), data->length(), Time::TimeStamp::Now().asDouble(), handle, length)) {
+    case DatagramReassembler::kNotFragment: return false;
+
+    case DatagramReassembler::kComplete:
+        LOGDEBUG << "reassembled message of " << length << " bytes" << std::endl;
+        complete = static_cast<ACE_Message_Block*>(handle);
+        complete->wr_ptr(length);
+        break;
+
+    default: break;
+    }
+
+    return true;
+}
+
+char*
+DatagramReader::acquire(size_t size, void*& handle)
+{
+    ACE_Message_Block* data = MessageManager::MakeMessageBlock(size + ACE_CDR::MAX_ALIGNMENT);
+    ACE_CDR::mb_align(data);
+    handle = data;
+    return data->wr_ptr();
+}
+
+void
+DatagramReader::release(void* handle)
+{
+    static_cast<ACE_Message_Block*>(handle)->release();
+}
+
 Logger::Log&
 MulticastSocket::Log()
 {
@@ -10,6 +10,7 @@
 
 #include "boost/shared_ptr.hpp"
 
+#include "IO/DatagramFragments.h"
 #include "IO/Preamble.h"
 #include "IO/Stats.h"
 
@@ -323,12 +324,11 @@ private:
     bool needSynch_;
 };
 
-/** Abstract base class for readers. A reader accumulates data from a device until it has all of the data of a
-    complete message. All SideCar messages have a header (see SideCar::Messages::Header class) which contains a
-    size in bytes. A reader simply adds incoming bytes to an ACE_Message_Block until the
-    ACE_Message_Block::length() == Header::getSize().
+/** Abstract base class for datagram readers. Each datagram normally holds one complete message. Datagrams that
+    hold fragments of a larger message (see DatagramFragmenter) are collected until the message is whole, in a
+    buffer from the MessageManager allocator. Incomplete messages are dropped after a timeout.
 */
-class DatagramReader : public Reader {
+class DatagramReader : public Reader, private DatagramReassembler::Pool {
 public:
     using Ref = boost::shared_ptr<DatagramReader>;
 
@@ -359,6 +359,22 @@ public:
     */
     void reset() {}
 
+    /** Pass a datagram obtained by other means through fragment reassembly.
+
+        \param data the datagram, which remains the caller's
+
+        \param complete set to the message the datagram completed, which the caller must release, or NULL
+
+        \return false if the datagram is not a fragment
+    */
+    bool reassemble(const ACE_Message_Block* data, ACE_Message_Block*& complete);
+
+    /** Obtain the fragment reassembly counters. Only safe to call from the thread calling fetchInput().
+
+        \return counters
+    */
+    const DatagramReassembler::Stats& getFragmentStats() const { return reassembler_.getStats(); }
+
 protected:
     /** Prototype of method that fetches data from a device and places it into a specific location.
 
@@ -378,6 +394,13 @@ protected:
     void makeIncomingBuffer(size_t size);
 
     ACE_Message_Block* building_; ///< Message being built
+
+private:
+    char* acquire(size_t size, void*& handle);
+
+    void release(void* handle);
+
+    DatagramReassembler reassembler_;
 };
 
 /** Template class for device-specific readers. The template argument _D is a device to use to actually read in
@@ -0,0 +1,396 @@
+#include <algorithm>
+#include <cstring>
+
+#include "Logger/Log.h"
+
+#include "ReliableMulticast.h"
+
+using namespace SideCar::IO;
+
+namespace {
+
+/** Seconds between adjustments of the sender's pacing rate.
+ */
+const double kAdaptInterval = 0.1;
+
+void
+Put(char* data, uint64_t value, size_t size)
+{
+    for (size_t index = size; index > 0; --index) {
+        data[index - 1] = char(value & 0xFF);
+        value >>= 8;
+    }
+}
+
+uint64_t
+Get(const char* data, size_t size)
+{
+    uint64_t value = 0;
+    for (size_t index = 0; index < size; ++index) value = (value << 8) | uint8_t(data[index]);
+    return value;
+}
+
+/** Fold a message into a parity buffer: its length as four bytes, followed by its bytes.
+ */
+void
+Fold(std::vector<char>& parity, const char* data, size_t size)
+{
+    if (parity.size() < size + 4) parity.resize(size + 4, 0);
+    char length[4];
+    Put(length, size, 4);
+    for (size_t index = 0; index < 4; ++index) parity[index] ^= length[index];
+    char* pos = &parity[4];
+    for (size_t index = 0; index < size; ++index) pos[index] ^= data[index];
+}
+
+} // namespace
+
+void
+ReliableMulticastPacket::Build(Bytes& packet, Kind kind, int flags, size_t groupSize, uint64_t sequence,
+                               const char* data, size_t size)
+{
+    packet.resize(kHeaderSize + size);
+    char* pos = &packet[0];
+    Put(pos, kMagic, 4);
+    Put(pos + 4, kind, 1);
+    Put(pos + 5, flags, 1);
+    Put(pos + 6, groupSize, 2);
+    Put(pos + 8, size, 4);
+    Put(pos + 12, sequence, 8);
+    if (size) ::memcpy(pos + kHeaderSize, data, size);
+}
+
+bool
+ReliableMulticastPacket::parse(const char* data, size_t size)
+{
+    if (size < kHeaderSize || Get(data, 4) != kMagic) return false;
+    kind = Kind(Get(data + 4, 1));
+    flags = Get(data + 5, 1);
+    groupSize = Get(data + 6, 2);
+    length = Get(data + 8, 4);
+    sequence = Get(data + 12, 8);
+    payload = data + kHeaderSize;
+    return (kind == kData || kind == kParity) && sequence != 0 && length == size - kHeaderSize;
+}
+
+Logger::Log&
+ReliableMulticastSender::Log()
+{
+    static Logger::Log& log_ = Logger::Log::Find("SideCar.IO.ReliableMulticastSender");
+    return log_;
+}
+
+ReliableMulticastSender::ReliableMulticastSender(size_t windowSize, size_t groupSize, double rate) :
+    windowSize_(std::max(windowSize, size_t(1))), groupSize_(std::min(groupSize, size_t(0xFFFF))),
+    configuredRate_(rate), sequence_(0), window_(), parity_(), parityMembers_(0), tokens_(0.0), lastPace_(0.0),
+    intervalStart_(0.0), intervalNacks_(0), stats_()
+{
+    stats_.rate = rate;
+}
+
+void
+ReliableMulticastSender::wrap(const char* data, size_t size, std::vector<Bytes>& packets)
+{
+    ++sequence_;
+    ++stats_.sent;
+    packets.push_back(Bytes());
+    ReliableMulticastPacket::Build(packets.back(), ReliableMulticastPacket::kData, 0, groupSize_, sequence_, data,
+                                   size);
+
+    window_.push_back(packets.back());
+    if (window_.size() > windowSize_) window_.pop_front();
+
+    if (!groupSize_) return;
+
+    Fold(parity_, data, size);
+    if (++parityMembers_ == groupSize_) {
+        ++stats_.parity;
+        packets.push_back(Bytes());
+        ReliableMulticastPacket::Build(packets.back(), ReliableMulticastPacket::kParity, 0, groupSize_,
+                                       sequence_ - groupSize_ + 1, &parity_[0], parity_.size());
+        parity_.clear();
+        parityMembers_ = 0;
+    }
+}
+
+bool
+ReliableMulticastSender::nack(uint64_t sequence, Bytes& packet)
+{
+    static Logger::ProcLog log("nack", Log());
+
+    ++stats_.nacked;
+    ++intervalNacks_;
+
+    uint64_t first = sequence_ - window_.size() + 1;
+    if (window_.empty() || sequence < first || sequence > sequence_) {
+        LOGDEBUG << "sequence " << sequence << " not in window " << first << '-' << sequence_ << std::endl;
+        ++stats_.tooLate;
+        return false;
+    }
+
+    ++stats_.retransmitted;
+    packet = window_[sequence - first];
+    packet[5] = ReliableMulticastPacket::kRetransmit;
+    return true;
+}
+
+double
+ReliableMulticastSender::pace(size_t size, double now)
+{
+    if (configuredRate_ <= 0.0) return 0.0;
+
+    // Allow bursts of up to 10 milliseconds worth of data, and start with a full allowance.
+    //
+    double burst = std::max(stats_.rate * 0.01, 64.0 * 1024.0);
+    if (intervalStart_ == 0.0) {
+        intervalStart_ = now;
+        lastPace_ = now;
+        tokens_ = burst;
+    }
+
+    if (now - intervalStart_ >= kAdaptInterval) {
+        if (intervalNacks_) {
+            stats_.rate = std::max(stats_.rate * 0.8, configuredRate_ * 0.25);
+        } else {
+            stats_.rate = std::min(stats_.rate + configuredRate_ * 0.05, configuredRate_);
+        }
+
+        intervalNacks_ = 0;
+        intervalStart_ = now;
+    }
+
+    tokens_ = std::min(burst, tokens_ + (now - lastPace_) * stats_.rate);
+    lastPace_ = now;
+    tokens_ -= size;
+    return tokens_ < 0.0 ? -tokens_ / stats_.rate : 0.0;
+}
+
+Logger::Log&
+ReliableMulticastReceiver::Log()
+{
+    static Logger::Log& log_ = Logger::Log::Find("SideCar.IO.ReliableMulticastReceiver");
+    return log_;
+}
+
+ReliableMulticastReceiver::ReliableMulticastReceiver(double nackDelay, double nackInterval, double giveUpDelay,
+                                                     size_t maxPending) :
+    nackDelay_(nackDelay),
+    nackInterval_(nackInterval), giveUpDelay_(giveUpDelay), maxPending_(std::max(maxPending, size_t(1))),
+    groupSize_(0), expected_(0), highest_(0), pending_(), history_(), parities_(), holes_(), stats_()
+{
+    ;
+}
+
+void
+ReliableMulticastReceiver::reset(uint64_t sequence)
+{
+    expected_ = sequence;
+    highest_ = sequence - 1;
+    pending_.clear();
+    history_.clear();
+    parities_.clear();
+    holes_.clear();
+}
+
+uint64_t
+ReliableMulticastReceiver::getGroupFirst(uint64_t sequence) const
+{
+    return groupSize_ ? (sequence - 1) / groupSize_ * groupSize_ + 1 : sequence;
+}
+
+bool
+ReliableMulticastReceiver::add(const char* data, size_t size, double now, std::vector<Bytes>& messages)
+{
+    static Logger::ProcLog log("add", Log());
+
+    ReliableMulticastPacket packet;
+    if (!packet.parse(data, size)) {
+        LOGERROR << "invalid packet of " << size << " bytes" << std::endl;
+        return false;
+    }
+
+    if (packet.groupSize != groupSize_) {
+        LOGINFO << "parity group size " << packet.groupSize << std::endl;
+        groupSize_ = packet.groupSize;
+        history_.clear();
+        parities_.clear();
+    }
+
+    uint64_t sequence = packet.sequence;
+
+    if (packet.kind == ReliableMulticastPacket::kParity) {
+        if (!expected_ || !groupSize_ || sequence != getGroupFirst(sequence)) return true;
+        uint64_t last = sequence + groupSize_ - 1;
+        if (last < expected_ || sequence > expected_ + maxPending_) return true;
+
+        // A parity packet reveals holes at the end of its group that no later data packet has shown yet.
+        //
+        for (uint64_t missing = highest_ + 1; missing <= last; ++missing) holes_[missing] = Hole{now, 0.0};
+        highest_ = std::max(highest_, last);
+
+        parities_[sequence].assign(packet.payload, packet.payload + packet.length);
+        recover(sequence, now);
+        deliver(messages);
+        return true;
+    }
+
+    if (!expected_) {
+        reset(sequence);
+    } else if (sequence + maxPending_ < expected_) {
+        LOGWARNING << "sequence went from " << expected_ << " to " << sequence << " - starting over" << std::endl;
+        reset(sequence);
+    }
+
+    if (sequence < expected_ || pending_.count(sequence)) {
+        ++stats_.duplicates;
+        return true;
+    }
+
+    // Never hold back more than maxPending_ messages behind a hole.
+    //
+    if (sequence >= expected_ + maxPending_) skipTo(sequence - maxPending_, messages);
+
+    ++stats_.received;
+    for (uint64_t missing = std::max(highest_ + 1, expected_); missing < sequence; ++missing) {
+        holes_[missing] = Hole{now, 0.0};
+    }
+
+    highest_ = std::max(highest_, sequence);
+
+    Bytes payload(packet.payload, packet.payload + packet.length);
+    store(sequence, payload, now,
+          (packet.flags & ReliableMulticastPacket::kRetransmit) ? &stats_.recoveredByNack : 0);
+
+    if (groupSize_) recover(getGroupFirst(sequence), now);
+    deliver(messages);
+    return true;
+}
+
+void
+ReliableMulticastReceiver::poll(double now, std::vector<uint64_t>& nacks, std::vector<Bytes>& messages)
+{
+    // Holes appear in sequence order, so the expired ones are at the front.
+    //
+    uint64_t giveUpTo = 0;
+    for (auto pos = holes_.begin(); pos != holes_.end() && now - pos->second.detected >= giveUpDelay_; ++pos) {
+        giveUpTo = pos->first;
+    }
+
+    if (giveUpTo) skipTo(giveUpTo, messages);
+
+    for (auto& hole : holes_) {
+        if (now - hole.second.detected >= nackDelay_ && now - hole.second.lastNack >= nackInterval_) {
+            nacks.push_back(hole.first);
+            hole.second.lastNack = now;
+            ++stats_.nacksSent;
+        }
+    }
+}
+
+void
+ReliableMulticastReceiver::store(uint64_t sequence, Bytes& payload, double now, uint64_t* recovered)
+{
+    auto hole = holes_.find(sequence);
+    if (hole != holes_.end()) {
+        if (recovered) {
+            ++*recovered;
+            double latency = now - hole->second.detected;
+            ++stats_.recoveries;
+            stats_.recoveryTotal += latency;
+            stats_.recoveryMax = std::max(stats_.recoveryMax, latency);
+        }
+
+        holes_.erase(hole);
+    }
+
+    pending_[sequence].swap(payload);
+}
+
+void
+ReliableMulticastReceiver::recover(uint64_t groupFirst, double now)
+{
+    static Logger::ProcLog log("recover", Log());
+
+    auto parity = parities_.find(groupFirst);
+    if (parity == parities_.end()) return;
+
+    // Delivered members of the group are in history_, and the rest in pending_. A member below expected_ that is
+    // not in history_ was given up on, so there is nothing left to repair.
+    //
+    uint64_t missing = 0;
+    size_t missingCount = 0;
+    for (uint64_t sequence = groupFirst; sequence < groupFirst + groupSize_; ++sequence) {
+        if (sequence < expected_ ? history_.count(sequence) : pending_.count(sequence)) continue;
+        missing = sequence;
+        ++missingCount;
+    }
+
+    if (missingCount != 1 || missing < expected_) {
+        if (missingCount == 0 || missing < expected_) parities_.erase(parity);
+        return;
+    }
+
+    Bytes rebuilt(parity->second);
+    for (uint64_t sequence = groupFirst; sequence < groupFirst + groupSize_; ++sequence) {
+        if (sequence == missing) continue;
+        const Bytes& member(sequence < expected_ ? history_[sequence] : pending_[sequence]);
+        Fold(rebuilt, member.empty() ? 0 : &member[0], member.size());
+    }
+
+    parities_.erase(parity);
+
+    size_t length = Get(&rebuilt[0], 4);
+    if (length + 4 > rebuilt.size()) {
+        LOGERROR << "parity for group " << groupFirst << " gives invalid length " << length << std::endl;
+        return;
+    }
+
+    Bytes payload(rebuilt.begin() + 4, rebuilt.begin() + 4 + length);
+    store(missing, payload, now, &stats_.recoveredByFec);
+}
+
+void
+ReliableMulticastReceiver::deliver(std::vector<Bytes>& messages)
+{
+    auto pos = pending_.begin();
+    while (pos != pending_.end() && pos->first == expected_) {
+        if (groupSize_) history_[expected_] = pos->second;
+        messages.push_back(Bytes());
+        messages.back().swap(pos->second);
+        pending_.erase(pos++);
+        ++expected_;
+    }
+
+    uint64_t keep = getGroupFirst(expected_);
+    history_.erase(history_.begin(), history_.lower_bound(keep));
+    parities_.erase(parities_.begin(), parities_.lower_bound(keep));
+}
+
+void
+ReliableMulticastReceiver::skipTo(uint64_t sequence, std::vector<Bytes>& messages)
+{
+    static Logger::ProcLog log("skipTo", Log());
+
+    if (sequence < expected_) return;
+
+    uint64_t unrecovered = 0;
+    auto end = pending_.upper_bound(sequence);
+    for (auto pos = pending_.begin(); pos != end; pending_.erase(pos++)) {
+        unrecovered += pos->first - expected_;
+        expected_ = pos->first + 1;
+        if (groupSize_) history_[pos->first] = pos->second;
+        messages.push_back(Bytes());
+        messages.back().swap(pos->second);
+    }
+
+    if (sequence >= expected_) {
+        unrecovered += sequence + 1 - expected_;
+        expected_ = sequence + 1;
+    }
+
+    LOGWARNING << "gave up on " << unrecovered << " messages before " << expected_ << std::endl;
+    stats_.unrecovered += unrecovered;
+    holes_.erase(holes_.begin(), holes_.upper_bound(sequence));
+    highest_ = std::max(highest_, sequence);
+    deliver(messages);
+}
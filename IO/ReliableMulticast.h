@@ -0,0 +1,277 @@
+#ifndef SIDECAR_IO_RELIABLEMULTICAST_H // -*- C++ -*-
+#define SIDECAR_IO_RELIABLEMULTICAST_H
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <vector>
+
+namespace Logger {
+class Log;
+}
+
+namespace SideCar {
+namespace IO {
+
+/** Framing shared by ReliableMulticastSender and ReliableMulticastReceiver. Every datagram starts with a fixed
+    header in network byte order, followed by the payload. A data packet carries one encoded message under a
+    sequence number; a parity packet carries the XOR of a group of consecutive data packets (see
+    ReliableMulticastSender), from which a receiver can rebuild any one missing member of the group.
+*/
+struct ReliableMulticastPacket {
+    using Bytes = std::vector<char>;
+
+    enum Kind { kData = 1, kParity = 2 };
+
+    enum Flags {
+        kRetransmit = 1 ///< Data packet sent again in answer to a NACK
+    };
+
+    enum { kMagic = 0x5343524D, kHeaderSize = 20 };
+
+    /** Write a header in front of a payload.
+
+        \param packet storage for the new packet
+
+        \param kind packet type
+
+        \param flags packet flags
+
+        \param groupSize number of data packets covered by each parity packet, or 0 if none
+
+        \param sequence data sequence number, or first sequence number covered by a parity packet
+
+        \param data payload
+
+        \param size number of payload bytes
+    */
+    static void Build(Bytes& packet, Kind kind, int flags, size_t groupSize, uint64_t sequence, const char* data,
+                      size_t size);
+
+    /** Read the header of a packet.
+
+        \param data start of the packet
+
+        \param size number of bytes in the packet
+
+        \return true if the packet is valid
+    */
+    bool parse(const char* data, size_t size);
+
+    Kind kind;
+    int flags;
+    size_t groupSize;
+    uint64_t sequence;
+    const char* payload;
+    size_t length;
+};
+
+/** Sending side of the reliability layer. Assigns sequence numbers to outgoing messages, keeps the last few in a
+    bounded window for retransmission when receivers send NACKs, emits a parity packet after each group of data
+    packets, and paces transmission to a byte rate.
+
+    The pacing rate adapts to loss: each interval with NACKs cuts it by 20%, down to a quarter of the configured
+    rate, and each interval without NACKs raises it by 5% of the configured rate, back up to the configured rate.
+*/
+class ReliableMulticastSender {
+public:
+    using Bytes = ReliableMulticastPacket::Bytes;
+
+    struct Stats {
+        uint64_t sent;          ///< Data packets sent once
+        uint64_t parity;        ///< Parity packets sent
+        uint64_t retransmitted; ///< Data packets sent again
+        uint64_t nacked;        ///< Sequence numbers asked for
+        uint64_t tooLate;       ///< Sequence numbers asked for but no longer in the window
+        double rate;            ///< Current pacing rate in bytes per second
+    };
+
+    static Logger::Log& Log();
+
+    /** Constructor.
+
+        \param windowSize number of recent data packets held for retransmission
+
+        \param groupSize number of data packets covered by each parity packet, or 0 for no parity packets
+
+        \param rate pacing rate in bytes per second, or 0 for no pacing
+    */
+    ReliableMulticastSender(size_t windowSize = 1024, size_t groupSize = 8, double rate = 0.0);
+
+    /** Frame a message for sending. Adds the new data packet to the retransmission window.
+
+        \param data encoded message
+
+        \param size number of bytes in the message
+
+        \param packets storage for the packets to send: the data packet, and a parity packet if the message
+        completes a group
+    */
+    void wrap(const char* data, size_t size, std::vector<Bytes>& packets);
+
+    /** Handle a NACK from a receiver.
+
+        \param sequence sequence number the receiver is missing
+
+        \param packet storage for the data packet to send again
+
+        \return true if the packet is still in the window
+    */
+    bool nack(uint64_t sequence, Bytes& packet);
+
+    /** Determine how long to wait before sending some bytes to stay within the pacing rate. Also updates the
+        pacing rate once an adaptation interval has passed.
+
+        \param size number of bytes about to be sent
+
+        \param now current time in seconds
+
+        \return seconds to wait
+    */
+    double pace(size_t size, double now);
+
+    const Stats& getStats() const { return stats_; }
+
+    size_t getGroupSize() const { return groupSize_; }
+
+private:
+    size_t windowSize_;
+    size_t groupSize_;
+    double configuredRate_;
+    uint64_t sequence_;
+    std::deque<Bytes> window_; ///< Last data packets sent, oldest first
+    Bytes parity_;             ///< XOR of the lengths and payloads of the current group
+    size_t parityMembers_;
+    double tokens_;
+    double lastPace_;
+    double intervalStart_;
+    uint64_t intervalNacks_;
+    Stats stats_;
+};
+
+/** Receiving side of the reliability layer. Takes packets in the order they arrive and hands back messages in
+    sequence order. A hole in the sequence is repaired by a parity packet if possible; otherwise poll() asks the
+    sender for it with NACKs, repeating until the sender answers or the hole grows too old, at which point the
+    receiver gives up on it and moves on.
+
+    A receiver starts with the first sequence number it sees, and starts over if the sender's numbers jump
+    backwards (sender restart) or too far forwards.
+*/
+class ReliableMulticastReceiver {
+public:
+    using Bytes = ReliableMulticastPacket::Bytes;
+
+    struct Stats {
+        uint64_t received;        ///< Data packets accepted
+        uint64_t duplicates;      ///< Data packets already seen
+        uint64_t recoveredByNack; ///< Holes filled by a retransmission
+        uint64_t recoveredByFec;  ///< Holes filled from a parity packet
+        uint64_t unrecovered;     ///< Holes given up on
+        uint64_t nacksSent;       ///< NACKs returned by poll()
+        uint64_t recoveries;      ///< Number of recovery latency samples
+        double recoveryTotal;     ///< Sum of times from hole detection to repair, in seconds
+        double recoveryMax;       ///< Longest time from hole detection to repair, in seconds
+    };
+
+    static Logger::Log& Log();
+
+    /** Constructor.
+
+        \param nackDelay seconds to wait for reordered or parity packets before sending the first NACK for a hole
+
+        \param nackInterval seconds between NACKs for the same hole
+
+        \param giveUpDelay seconds after which an unfilled hole is abandoned
+
+        \param maxPending most messages held back behind a hole
+    */
+    ReliableMulticastReceiver(double nackDelay = 0.002, double nackInterval = 0.02, double giveUpDelay = 0.25,
+                              size_t maxPending = 4096);
+
+    /** Accept a packet.
+
+        \param data start of the packet
+
+        \param size number of bytes in the packet
+
+        \param now current time in seconds
+
+        \param messages storage for the messages now deliverable, in sequence order
+
+        \return false if the packet was not valid
+    */
+    bool add(const char* data, size_t size, double now, std::vector<Bytes>& messages);
+
+    /** Check the holes in the sequence. Call often, every few milliseconds.
+
+        \param now current time in seconds
+
+        \param nacks storage for the sequence numbers to ask the sender for
+
+        \param messages storage for the messages deliverable after giving up on holes, in sequence order
+    */
+    void poll(double now, std::vector<uint64_t>& nacks, std::vector<Bytes>& messages);
+
+    const Stats& getStats() const { return stats_; }
+
+    /** Obtain the mean time from hole detection to repair.
+
+        \return seconds
+    */
+    double getMeanRecovery() const { return stats_.recoveries ? stats_.recoveryTotal / stats_.recoveries : 0.0; }
+
+private:
+    struct Hole {
+        double detected;
+        double lastNack;
+    };
+
+    void reset(uint64_t sequence);
+
+    uint64_t getGroupFirst(uint64_t sequence) const;
+
+    /** Hold a message until its turn for delivery, filling its hole if there is one.
+
+        \param sequence sequence number of the message
+
+        \param payload message bytes, taken by swapping
+
+        \param now current time in seconds
+
+        \param recovered counter to bump if the message fills a hole, or NULL if it is not a repair
+    */
+    void store(uint64_t sequence, Bytes& payload, double now, uint64_t* recovered);
+
+    /** Rebuild the one missing member of a parity group, if there is a parity packet for it.
+     */
+    void recover(uint64_t groupFirst, double now);
+
+    /** Move held messages that are next in sequence to the output.
+     */
+    void deliver(std::vector<Bytes>& messages);
+
+    /** Abandon all holes up to and including a sequence number, and deliver what follows them.
+     */
+    void skipTo(uint64_t sequence, std::vector<Bytes>& messages);
+
+    double nackDelay_;
+    double nackInterval_;
+    double giveUpDelay_;
+    size_t maxPending_;
+    size_t groupSize_;
+    uint64_t expected_;                  ///< Next sequence number to deliver, or 0 before the first packet
+    uint64_t highest_;                   ///< Highest sequence number seen
+    std::map<uint64_t, Bytes> pending_;  ///< Messages held back behind a hole
+    std::map<uint64_t, Bytes> history_;  ///< Delivered messages of the group holding expected_, for parity repair
+    std::map<uint64_t, Bytes> parities_; ///< Parity payloads by first sequence number of their group
+    std::map<uint64_t, Hole> holes_;
+    Stats stats_;
+};
+
+} // end namespace IO
+} // end namespace SideCar
+
+/** \file
+ */
+
+#endif
@@ -0,0 +1,255 @@
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "UnitTest/UnitTest.h"
+
+#include "ReliableMulticast.h"
+
+using namespace SideCar::IO;
+
+using Bytes = ReliableMulticastPacket::Bytes;
+
+struct Test : public UnitTest::TestObj {
+    Test() : UnitTest::TestObj("ReliableMulticast") {}
+    void test();
+};
+
+static std::string
+Message(int index)
+{
+    return "message " + std::string(index % 7, '.') + std::to_string(index);
+}
+
+static std::string
+Text(const Bytes& bytes)
+{
+    return std::string(bytes.begin(), bytes.end());
+}
+
+/** Loopback link between a sender and a receiver that drops chosen packets on the way.
+ */
+struct Link {
+    Link(ReliableMulticastSender& sender, ReliableMulticastReceiver& receiver) :
+        sender_(sender), receiver_(receiver), now_(100.0), packets_(0), delivered_()
+    {
+    }
+
+    /** Send a message. The drop vector holds the indices, counting from 1, of the packets to lose.
+     */
+    void send(int index, const std::vector<int>& drops = std::vector<int>())
+    {
+        std::string text(Message(index));
+        std::vector<Bytes> packets;
+        sender_.wrap(text.data(), text.size(), packets);
+        for (const auto& packet : packets) {
+            ++packets_;
+            bool drop = false;
+            for (auto value : drops) drop = drop || value == packets_;
+            if (!drop) receiver_.add(&packet[0], packet.size(), now_, delivered_);
+        }
+    }
+
+    /** Advance the clock and answer any NACKs.
+     */
+    void advance(double seconds)
+    {
+        now_ += seconds;
+        std::vector<uint64_t> nacks;
+        receiver_.poll(now_, nacks, delivered_);
+        for (auto sequence : nacks) {
+            Bytes packet;
+            if (sender_.nack(sequence, packet)) receiver_.add(&packet[0], packet.size(), now_, delivered_);
+        }
+    }
+
+    bool inOrder(int first, int last) const
+    {
+        if (delivered_.size() != size_t(last - first + 1)) return false;
+        for (int index = first; index <= last; ++index) {
+            if (Text(delivered_[index - first]) != Message(index)) return false;
+        }
+
+        return true;
+    }
+
+    ReliableMulticastSender& sender_;
+    ReliableMulticastReceiver& receiver_;
+    double now_;
+    int packets_;
+    std::vector<Bytes> delivered_;
+};
+
+void
+Test::test()
+{
+    // Packet framing.
+    //
+    {
+        Bytes packet;
+        ReliableMulticastPacket::Build(packet, ReliableMulticastPacket::kData, 0, 4, 0x123456789A, "abc", 3);
+        ReliableMulticastPacket parsed;
+        assertTrue(parsed.parse(&packet[0], packet.size()));
+        assertEqual(ReliableMulticastPacket::kData, parsed.kind);
+        assertEqual(size_t(4), parsed.groupSize);
+        assertEqual(uint64_t(0x123456789A), parsed.sequence);
+        assertEqual(std::string("abc"), std::string(parsed.payload, parsed.length));
+        assertFalse(parsed.parse(&packet[0], packet.size() - 1));
+        packet[0] = 0;
+        assertFalse(parsed.parse(&packet[0], packet.size()));
+    }
+
+    // No loss, no parity: everything arrives in order, and nothing is asked for.
+    //
+    {
+        ReliableMulticastSender sender(16, 0);
+        ReliableMulticastReceiver receiver;
+        Link link(sender, receiver);
+        for (int index = 1; index <= 20; ++index) link.send(index);
+        link.advance(1.0);
+        assertTrue(link.inOrder(1, 20));
+        assertEqual(uint64_t(0), receiver.getStats().nacksSent);
+        assertEqual(uint64_t(20), sender.getStats().sent);
+        assertEqual(uint64_t(0), sender.getStats().parity);
+    }
+
+    // One loss in a parity group is rebuilt from the parity packet without a NACK. Each group of 4 messages goes
+    // out as 5 packets, so packet 2 is message 2.
+    //
+    {
+        ReliableMulticastSender sender(16, 4);
+        ReliableMulticastReceiver receiver;
+        Link link(sender, receiver);
+        for (int index = 1; index <= 8; ++index) link.send(index, {2});
+        assertTrue(link.inOrder(1, 8));
+        assertEqual(uint64_t(1), receiver.getStats().recoveredByFec);
+        assertEqual(uint64_t(0), receiver.getStats().nacksSent);
+        assertEqual(uint64_t(2), sender.getStats().parity);
+    }
+
+    // A loss at the end of a group shows up through the parity packet, which also repairs it.
+    //
+    {
+        ReliableMulticastSender sender(16, 4);
+        ReliableMulticastReceiver receiver;
+        Link link(sender, receiver);
+        for (int index = 1; index <= 4; ++index) link.send(index, {4});
+        assertTrue(link.inOrder(1, 4));
+        assertEqual(uint64_t(1), receiver.getStats().recoveredByFec);
+    }
+
+    // Two losses in a group are beyond the parity packet, so the receiver waits for reordered packets, then
+    // NACKs. The first retransmission fills one hole, after which the parity packet fills the other, and the
+    // second retransmission is a duplicate.
+    //
+    {
+        ReliableMulticastSender sender(16, 4);
+        ReliableMulticastReceiver receiver(0.002, 0.02, 0.25);
+        Link link(sender, receiver);
+        for (int index = 1; index <= 8; ++index) link.send(index, {2, 3});
+        assertEqual(size_t(1), link.delivered_.size());
+
+        link.advance(0.001);
+        assertEqual(uint64_t(0), receiver.getStats().nacksSent);
+
+        link.advance(0.002);
+        assertEqual(uint64_t(2), receiver.getStats().nacksSent);
+        assertTrue(link.inOrder(1, 8));
+        assertEqual(uint64_t(1), receiver.getStats().recoveredByNack);
+        assertEqual(uint64_t(1), receiver.getStats().recoveredByFec);
+        assertEqual(uint64_t(1), receiver.getStats().duplicates);
+        assertEqual(uint64_t(2), sender.getStats().retransmitted);
+        assertEqual(uint64_t(2), receiver.getStats().recoveries);
+        assertTrue(receiver.getMeanRecovery() > 0.0029 && receiver.getMeanRecovery() < 0.0031);
+    }
+
+    // A hole the sender can no longer fill is given up on, and what follows it is delivered.
+    //
+    {
+        ReliableMulticastSender sender(2, 0);
+        ReliableMulticastReceiver receiver(0.002, 0.02, 0.25);
+        Link link(sender, receiver);
+        for (int index = 1; index <= 6; ++index) link.send(index, {3});
+        link.advance(0.01);
+        assertEqual(uint64_t(1), sender.getStats().tooLate);
+        assertEqual(size_t(2), link.delivered_.size());
+
+        link.advance(0.3);
+        assertEqual(uint64_t(1), receiver.getStats().unrecovered);
+        assertEqual(size_t(5), link.delivered_.size());
+        assertEqual(Message(4), Text(link.delivered_[2]));
+    }
+
+    // The receiver never holds back more than its limit behind a hole.
+    //
+    {
+        ReliableMulticastSender sender(64, 0);
+        ReliableMulticastReceiver receiver(0.002, 0.02, 0.25, 8);
+        Link link(sender, receiver);
+        for (int index = 1; index <= 20; ++index) link.send(index, {2});
+        assertEqual(uint64_t(1), receiver.getStats().unrecovered);
+        assertEqual(size_t(19), link.delivered_.size());
+    }
+
+    // A sender that starts over is followed.
+    //
+    {
+        ReliableMulticastSender sender(16, 0);
+        ReliableMulticastReceiver receiver(0.002, 0.02, 0.25, 8);
+        Link link(sender, receiver);
+        for (int index = 1; index <= 20; ++index) link.send(index);
+
+        ReliableMulticastSender restarted(16, 0);
+        Link other(restarted, receiver);
+        for (int index = 1; index <= 3; ++index) other.send(index);
+        assertTrue(other.inOrder(1, 3));
+    }
+
+    // Random loss of 5% of all packets, including retransmissions, with parity and NACKs.
+    //
+    {
+        ::srand(1234);
+        ReliableMulticastSender sender(1024, 8);
+        ReliableMulticastReceiver receiver(0.002, 0.02, 1.0);
+        Link link(sender, receiver);
+        std::vector<int> drops;
+        for (int index = 1; index <= 20000; ++index) {
+            if (::rand() % 100 < 5) drops.push_back(index);
+        }
+
+        for (int index = 1; index <= 10000; ++index) {
+            link.send(index, drops);
+            link.advance(0.0005);
+        }
+
+        link.advance(0.1);
+        assertTrue(link.inOrder(1, 10000));
+        const ReliableMulticastReceiver::Stats& stats(receiver.getStats());
+        assertEqual(uint64_t(0), stats.unrecovered);
+        assertTrue(stats.recoveredByFec > 100);
+        assertTrue(stats.recoveredByNack > 0);
+        assertTrue(stats.recoveryMax < 0.1);
+    }
+
+    // Pacing allows a burst, then spaces packets out at the rate. NACKs slow the rate down, and it recovers
+    // without them.
+    //
+    {
+        ReliableMulticastSender sender(16, 0, 1.0E6);
+        assertEqual(0.0, sender.pace(64 * 1024, 10.0));
+        assertTrue(sender.pace(1000, 10.0) > 0.0009);
+
+        Bytes packet;
+        sender.nack(1, packet);
+        sender.pace(0, 10.2);
+        assertEqual(0.8E6, sender.getStats().rate);
+        for (int index = 1; index <= 10; ++index) sender.pace(0, 10.2 + index * 0.15);
+        assertEqual(1.0E6, sender.getStats().rate);
+    }
+}
+
+int
+main(int argc, const char* argv[])
+{
+    return Test().mainRun();
+}
@@ -0,0 +1,178 @@
+#ifndef SIDECAR_IO_SENDQUEUE_H // -*- C++ -*-
+#define SIDECAR_IO_SENDQUEUE_H
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace SideCar {
+namespace IO {
+
+/** Policy and counters shared by all SendQueue instantiations.
+ */
+class SendQueueBase {
+public:
+    /** What to do with a new item when the queue is full.
+     */
+    enum Policy {
+        kBlock,      ///< Refuse the item; the producer waits for room. Every item is sent.
+        kDropOldest, ///< Drop the oldest waiting item to make room
+        kLatestOnly  ///< Keep only the newest item; anything still waiting is dropped
+    };
+
+    struct Stats {
+        uint64_t queued;  ///< Items accepted
+        uint64_t sent;    ///< Items taken for sending
+        uint64_t dropped; ///< Items dropped by the policy
+        double maxLag;    ///< Longest time an item waited before being taken, in seconds
+    };
+
+    /** Convert a policy name ("block", "dropOldest", or "latestOnly") into a Policy value.
+
+        \param name policy name
+
+        \param policy storage for the result
+
+        \return true if the name is valid
+    */
+    static bool ParsePolicy(const std::string& name, Policy& policy)
+    {
+        if (name == "block") {
+            policy = kBlock;
+        } else if (name == "dropOldest") {
+            policy = kDropOldest;
+        } else if (name == "latestOnly") {
+            policy = kLatestOnly;
+        } else {
+            return false;
+        }
+
+        return true;
+    }
+};
+
+/** Bounded FIFO of outgoing items for one consumer of a fan-out writer. The policy given at construction
+    decides what happens when a producer adds to a full queue. Items pushed out by the policy are handed back to
+    the producer to dispose of. The queue also tracks how long items wait, so that a slow consumer shows up as
+    lag.
+
+    The queue does no locking of its own.
+*/
+template <typename T>
+class SendQueue : public SendQueueBase {
+public:
+    /** Constructor.
+
+        \param policy what to do when full
+
+        \param depth most items held at once; kLatestOnly always holds at most one
+    */
+    SendQueue(Policy policy = kDropOldest, size_t depth = 64) :
+        policy_(policy), depth_(policy == kLatestOnly ? 1 : (depth ? depth : 1)), entries_(), stats_()
+    {
+    }
+
+    Policy getPolicy() const { return policy_; }
+
+    size_t getDepth() const { return depth_; }
+
+    /** Add an item.
+
+        \param item the item to add
+
+        \param now current time in seconds
+
+        \param dropped storage for items dropped to make room
+
+        \return false if the queue is full and the policy is kBlock; the item was not taken
+    */
+    bool push(const T& item, double now, std::vector<T>& dropped)
+    {
+        if (entries_.size() >= depth_) {
+            if (policy_ == kBlock) return false;
+            while (entries_.size() >= depth_) {
+                dropped.push_back(entries_.front().item);
+                entries_.pop_front();
+                ++stats_.dropped;
+            }
+        }
+
+        entries_.push_back(Entry(item, now));
+        ++stats_.queued;
+        return true;
+    }
+
+    /** Take the oldest item for sending.
+
+        \param item storage for the item
+
+        \param now current time in seconds
+
+        \param queuedAt if not NULL, storage for the time the item was added
+
+        \return false if the queue is empty
+    */
+    bool pop(T& item, double now, double* queuedAt = 0)
+    {
+        if (entries_.empty()) return false;
+        const Entry& entry(entries_.front());
+        item = entry.item;
+        if (queuedAt) *queuedAt = entry.when;
+        if (now - entry.when > stats_.maxLag) stats_.maxLag = now - entry.when;
+        entries_.pop_front();
+        ++stats_.sent;
+        return true;
+    }
+
+    /** Remove every item.
+
+        \param dropped storage for the removed items
+    */
+    void clear(std::vector<T>& dropped)
+    {
+        for (const auto& entry : entries_) dropped.push_back(entry.item);
+        entries_.clear();
+    }
+
+    bool empty() const { return entries_.empty(); }
+
+    bool full() const { return entries_.size() >= depth_; }
+
+    size_t size() const { return entries_.size(); }
+
+    /** Obtain the time the oldest waiting item was added.
+
+        \param when storage for the time
+
+        \return false if the queue is empty
+    */
+    bool getOldest(double& when) const
+    {
+        if (entries_.empty()) return false;
+        when = entries_.front().when;
+        return true;
+    }
+
+    const Stats& getStats() const { return stats_; }
+
+private:
+    struct Entry {
+        Entry(const T& i, double w) : item(i), when(w) {}
+        T item;
+        double when;
+    };
+
+    Policy policy_;
+    size_t depth_;
+    std::deque<Entry> entries_;
+    Stats stats_;
+};
+
+} // end namespace IO
+} // end namespace SideCar
+
+/** \file
+ */
+
+#endif
@@ -0,0 +1,93 @@
+#include <vector>
+
+#include "UnitTest/UnitTest.h"
+
+#include "SendQueue.h"
+
+using namespace SideCar::IO;
+
+struct Test : public UnitTest::TestObj {
+    Test() : UnitTest::TestObj("SendQueue") {}
+    void test();
+};
+
+void
+Test::test()
+{
+    SendQueueBase::Policy policy;
+    assertTrue(SendQueueBase::ParsePolicy("latestOnly", policy));
+    assertEqual(SendQueueBase::kLatestOnly, policy);
+    assertTrue(SendQueueBase::ParsePolicy("block", policy));
+    assertEqual(SendQueueBase::kBlock, policy);
+    assertFalse(SendQueueBase::ParsePolicy("latest", policy));
+
+    // Blocking: a full queue refuses new items and drops nothing.
+    //
+    {
+        SendQueue<int> queue(SendQueueBase::kBlock, 2);
+        std::vector<int> dropped;
+        assertTrue(queue.push(1, 1.0, dropped));
+        assertTrue(queue.push(2, 1.0, dropped));
+        assertTrue(queue.full());
+        assertFalse(queue.push(3, 1.0, dropped));
+        assertTrue(dropped.empty());
+
+        int item;
+        assertTrue(queue.pop(item, 1.5));
+        assertEqual(1, item);
+        assertTrue(queue.push(3, 1.5, dropped));
+        assertEqual(uint64_t(3), queue.getStats().queued);
+        assertEqual(0.5, queue.getStats().maxLag);
+    }
+
+    // Dropping the oldest keeps the newest items in order.
+    //
+    {
+        SendQueue<int> queue(SendQueueBase::kDropOldest, 3);
+        std::vector<int> dropped;
+        for (int index = 1; index <= 5; ++index) assertTrue(queue.push(index, index, dropped));
+        assertEqual(size_t(2), dropped.size());
+        assertEqual(1, dropped[0]);
+        assertEqual(2, dropped[1]);
+        assertEqual(uint64_t(2), queue.getStats().dropped);
+
+        double oldest;
+        assertTrue(queue.getOldest(oldest));
+        assertEqual(3.0, oldest);
+
+        int item;
+        double queuedAt;
+        assertTrue(queue.pop(item, 10.0, &queuedAt));
+        assertEqual(3, item);
+        assertEqual(3.0, queuedAt);
+        assertEqual(7.0, queue.getStats().maxLag);
+    }
+
+    // Latest only: whatever was waiting goes, whatever the requested depth.
+    //
+    {
+        SendQueue<int> queue(SendQueueBase::kLatestOnly, 10);
+        assertEqual(size_t(1), queue.getDepth());
+        std::vector<int> dropped;
+        for (int index = 1; index <= 4; ++index) queue.push(index, 0.0, dropped);
+        assertEqual(size_t(3), dropped.size());
+        assertEqual(size_t(1), queue.size());
+
+        int item;
+        assertTrue(queue.pop(item, 0.0));
+        assertEqual(4, item);
+        assertFalse(queue.pop(item, 0.0));
+
+        queue.push(5, 0.0, dropped);
+        dropped.clear();
+        queue.clear(dropped);
+        assertEqual(size_t(1), dropped.size());
+        assertTrue(queue.empty());
+    }
+}
+
+int
+main(int argc, const char* argv[])
+{
+    return Test().mainRun();
+}
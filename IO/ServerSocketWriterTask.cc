@@ -1,11 +1,12 @@
+#include <iomanip>
 #include <sstream>
 
+#include "ace/INET_Addr.h"
 #include "ace/Message_Block.h"
 #include "ace/Reactor.h"
 
 #include "Logger/Log.h"
 
-#include "GatherWriter.h"
 #include "MessageManager.h"
 #include "Module.h"
 #include "ServerSocketWriterTask.h"
@@ -48,6 +49,13 @@ ServerSocketWriterTask::OutputHandler::open(void* arg)
             LOGERROR << "failed to set SO_SNDBUF to " << bufferSize << std::endl;
     }
 
+    ACE_INET_Addr remoteAddress;
+    if (peer().get_remote_addr(remoteAddress) == 0) {
+        std::ostringstream os;
+        os << remoteAddress.get_host_addr() << ':' << remoteAddress.get_port_number();
+        address_ = os.str();
+    }
+
     // Register for notification when the socket in closed.
     //
     if (reactor()->register_handler(this, ACE_Event_Handler::READ_MASK) == -1) {
@@ -55,24 +63,21 @@ ServerSocketWriterTask::OutputHandler::open(void* arg)
         return -1;
     }
 
-    // Change our writer to use our socket connection
-    //
-    writer_.getDevice().set_handle(get_handle());
-
     task_->addOutputHandler(this);
-
-    return activate(task_->threadFlags_, 1, 0, task_->threadPriority_);
+    return 0;
 }
 
 int
 ServerSocketWriterTask::OutputHandler::handle_input(ACE_HANDLE handle)
 {
     Logger::ProcLog log("handle_input", Log());
-    LOGINFO << "remote connection closed" << std::endl;
+    LOGINFO << "remote connection closed - " << address_ << std::endl;
 
-    // Disable the input queue so that the svc thread will exit.
+    // Stop watching the socket, and place a message on our master's message queue that will remove us from its
+    // set of clients. The socket stays open until the FanOutWriter lets go of it.
     //
-    msg_queue()->deactivate();
+    reactor()->remove_handler(this, ACE_Event_Handler::READ_MASK | ACE_Event_Handler::DONT_CALL);
+    task_->removeOutputHandler(this);
     return 0;
 }
 
@@ -80,57 +85,17 @@ int
 ServerSocketWriterTask::OutputHandler::close(u_long flags)
 {
     Logger::ProcLog log("close", Log());
-    LOGINFO << "closing - " << flags << std::endl;
+    LOGINFO << "closing - " << flags << ' ' << address_ << std::endl;
 
-    if (flags) {
-        if (!msg_queue()->deactivated()) {
-            LOGDEBUG << "shutting down service thread" << std::endl;
-            msg_queue()->deactivate();
-            if (wait() == -1) LOGERROR << "failed to join to service thread" << std::endl;
-        }
-    } else {
-        LOGDEBUG << "closing client connection" << std::endl;
-
-        // The thread has finished. Close the client connection, unregister ourselves for the connection device.
-        //
-        reactor()->remove_handler(get_handle(), ACE_Event_Handler::READ_MASK | ACE_Event_Handler::DONT_CALL);
+    if (get_handle() != ACE_INVALID_HANDLE) {
+        reactor()->remove_handler(this, ACE_Event_Handler::READ_MASK | ACE_Event_Handler::DONT_CALL);
         peer().close();
-
-        // Place a message on our master's message queue that will remove us from its set of clients.
-        //
-        task_->removeOutputHandler(this);
     }
 
     LOGINFO << "done" << std::endl;
     return 0;
 }
 
-int
-ServerSocketWriterTask::OutputHandler::svc()
-{
-    Logger::ProcLog log("svc", Log());
-    LOGINFO << "start" << std::endl;
-
-    GatherWriter gatherWriter(writer_);
-    gatherWriter.setCountLimit(1);
-
-    ACE_Message_Block* data = 0;
-    while (getq(data) != -1) {
-        MessageManager mgr(data);
-        if (!mgr.hasNativeMessageType(task_->getMetaTypeInfoKey())) {
-            LOGFATAL << "invalid message type in queue - " << mgr.getMessageType() << std::endl;
-            ::abort();
-        }
-
-        gatherWriter.add(mgr.getEncoded());
-    }
-
-    gatherWriter.flush();
-
-    LOGWARNING << "terminating" << std::endl;
-    return 0;
-}
-
 Logger::Log&
 ServerSocketWriterTask::Acceptor::Log()
 {
@@ -174,7 +139,8 @@ ServerSocketWriterTask::Make()
     return ref;
 }
 
-ServerSocketWriterTask::ServerSocketWriterTask() : IOTask(), acceptor_(0), clients_()
+ServerSocketWriterTask::ServerSocketWriterTask() :
+    IOTask(), acceptor_(0), clients_(), clientPolicy_(SendQueueBase::kBlock), clientDepth_(64), fanOut_()
 {
     Logger::ProcLog log("ServerSocketWriterTask", Log());
     LOGINFO << std::endl;
@@ -236,6 +202,11 @@ ServerSocketWriterTask::openAndInit(const std::string& key, uint16_t port, int b
     port_ = serverAddress.get_port_number();
     LOGDEBUG << "port: " << port_ << std::endl;
 
+    if (!fanOut_.start(threadFlags_, threadPriority_)) {
+        LOGERROR << "failed to start client writer thread" << std::endl;
+        return false;
+    }
+
     if (activate(threadFlags_, 1, 0, threadPriority_) == -1) {
         LOGERROR << "failed to start main processing thread" << std::endl;
         return false;
@@ -261,17 +232,24 @@ ServerSocketWriterTask::close(u_long flags)
         msg_queue()->deactivate();
         if (wait() == -1) LOGERROR << "failed to join main processing thread" << std::endl;
 
-        // Now that our main processing thread is finished, we can safely muck with our client output threads.
-        // First, handle the any unprocessed client open/close requests.
+        // Now that our main processing thread is finished, we can safely muck with our clients. First, handle the
+        // any unprocessed client open/close requests. Data messages still in the queue are not sent.
         //
         msg_queue()->activate();
         while (!msg_queue()->is_empty()) {
             ACE_Message_Block* data;
-            if (getq(data) != -1) updateClients(data);
+            if (getq(data) != -1) {
+                if (MessageManager::IsDataMessage(data)) {
+                    data->release();
+                } else {
+                    updateClients(data);
+                }
+            }
         }
 
-        // Now, close any remaining client output threads
+        // Stop the writer thread, which lets go of all client sockets, and then close the connections.
         //
+        fanOut_.stop();
         for (size_t index = 0; index < clients_.size(); ++index) {
             OutputHandler* handler = clients_[index];
             LOGDEBUG << "closing output handler: " << handler << std::endl;
@@ -353,13 +331,21 @@ ServerSocketWriterTask::updateClients(ACE_Message_Block* data)
     OutputHandler* outputHandler = reinterpret_cast<OutputHandler*>(data->rd_ptr());
 
     if (data->msg_type() == ACE_Message_Block::MB_START) {
-        LOGDEBUG << "added new output handler" << std::endl;
-        clients_.push_back(outputHandler);
+        if (fanOut_.addClient(outputHandler->get_handle(), outputHandler->getAddress(), clientPolicy_,
+                              clientDepth_)) {
+            LOGDEBUG << "added new output handler" << std::endl;
+            clients_.push_back(outputHandler);
+        } else {
+            LOGERROR << "failed to add client " << outputHandler->getAddress() << std::endl;
+            outputHandler->close(1);
+            delete outputHandler;
+        }
     } else if (data->msg_type() == ACE_Message_Block::MB_HANGUP) {
         OutputHandlerVector::iterator pos = std::find(clients_.begin(), clients_.end(), outputHandler);
         if (pos == clients_.end()) {
             LOGERROR << "did not find client to remove" << std::endl;
         } else {
+            fanOut_.removeClient((*pos)->get_handle());
             (*pos)->close(1);
             delete *pos;
             clients_.erase(pos);
@@ -383,17 +369,42 @@ ServerSocketWriterTask::distribute(ACE_Message_Block* data)
 {
     static Logger::ProcLog log("distribute", Log());
 
+    // Encode just once here, and let the writer share the encoded data among all of the clients.
+    //
     MessageManager mgr(data);
+    if (!mgr.hasNativeMessageType(getMetaTypeInfoKey())) {
+        LOGFATAL << "invalid message type in queue - " << mgr.getMessageType() << std::endl;
+        ::abort();
+    }
 
-    OutputHandlerVector::const_iterator pos = clients_.begin();
-    OutputHandlerVector::const_iterator end = clients_.end();
-    for (; pos != end; ++pos) {
-        LOGDEBUG << "adding to client output queue" << std::endl;
-        ACE_Message_Block* dup = mgr.getMessage();
-        if ((*pos)->put(dup) == -1) {
-            LOGERROR << "failed to write to client output queue - flushing" << std::endl;
-            dup->release();
-            (*pos)->close(1);
+    ACE_Message_Block* encoded = mgr.getEncoded();
+    if (!encoded) {
+        LOGERROR << "failed to encode message" << std::endl;
+        return;
+    }
+
+    fanOut_.send(encoded);
+}
+
+std::string
+ServerSocketWriterTask::getClientSummary() const
+{
+    std::vector<FanOutWriter::ClientInfo> clients;
+    fanOut_.getClients(clients);
+
+    std::ostringstream os;
+    os << std::fixed << std::setprecision(1);
+    for (const auto& client : clients) {
+        if (os.tellp() > 0) os << ' ';
+        os << client.address;
+        if (client.failed) {
+            os << " failed";
+        } else {
+            os << " Q: " << client.waiting << " Lag: " << client.lag * 1000.0 << " ms";
         }
+
+        if (client.stats.dropped) os << " Dropped: " << client.stats.dropped;
     }
+
+    return os.str();
 }
@@ -6,8 +6,8 @@
 #include "ace/Svc_Handler.h"
 #include "boost/signals2.hpp"
 
+#include "IO/FanOutWriter.h"
 #include "IO/IOTask.h"
-#include "IO/Writers.h"
 
 namespace Logger {
 class Log;
@@ -17,8 +17,11 @@ namespace SideCar {
 namespace IO {
 
 /** An ACE service / task that sets up a server-side socket for client connections, managers client connect
-    requests, and send data to clients using a SocketWriter object. Outgoing messages are given to the services'
-    put() method, where they are queued for transmission.
+    requests, and send data to clients. Outgoing messages are given to the services' put() method, where they are
+    queued for transmission. The task's thread encodes each message once and hands it to a FanOutWriter, which
+    keeps a bounded queue for each client. By default a client that falls behind holds up the task until it catches
+    up, so that no client misses a message; with a dropping policy, a slow client cannot hold up the others (see
+    setClientPolicy()).
 */
 class ServerSocketWriterTask : public IOTask {
     using Super = IOTask;
@@ -77,6 +80,25 @@ public:
 
     int getBufferSize() const { return bufferSize_; }
 
+    /** Set what to do when a client falls behind. Only affects clients that connect after the call. The default
+        is SendQueueBase::kBlock with a depth of 64.
+
+        \param policy what to do when a client's queue is full
+
+        \param depth most messages to queue for a client
+    */
+    void setClientPolicy(SendQueueBase::Policy policy, size_t depth)
+    {
+        clientPolicy_ = policy;
+        clientDepth_ = depth;
+    }
+
+    /** Obtain a one-line report of each client's backlog, suitable for connection info.
+
+        \return client report
+    */
+    std::string getClientSummary() const;
+
     /** Hand a data message to the task to process. Note that since it circumvents the normal message routing
         framework found in Task, this should be used with care.
 
@@ -108,9 +130,8 @@ private:
     */
     bool deliverDataMessage(ACE_Message_Block* data, ACE_Time_Value* timeout);
 
-    /** Helper class that acquires data from connected clients. A separate thread runs the InputHandler::svc()
-        routine, which takes complete messages from a SocketWriter. The messages are then passed to the
-        SocketWriterTask::put() routine.
+    /** Helper class that represents one connected client. The data goes out through the task's FanOutWriter;
+        the handler only watches for the client closing the connection.
     */
     class OutputHandler : public ACE_Svc_Handler<ACE_SOCK_STREAM, ACE_MT_SYNCH> {
         using Super = ACE_Svc_Handler<ACE_SOCK_STREAM, ACE_MT_SYNCH>;
@@ -122,27 +143,34 @@ private:
         */
         static Logger::Log& Log();
 
-        OutputHandler() : Super(), task_(0), writer_() {}
+        OutputHandler() : Super(), task_(0), address_() {}
 
         ~OutputHandler();
 
-        /** Override of ACE_Svc_Handler method. Sets up the SocketWriter instance to use the socket connection
-            to the client.
+        /** Override of ACE_Svc_Handler method. Configures the client socket and asks the task to start sending
+            to it.
 
             \param arg ACE_Acceptor object that did the connecting
 
             \return 0 if successful, -1 otherwise
         */
         int open(void* arg = 0);
+
+        /** Override of ACE_Svc_Handler method. Stops watching the socket and closes it.
+
+            \param flags ignored
+
+            \return 0
+        */
         int close(u_long flags);
-        int put(ACE_Message_Block* data, ACE_Time_Value* timeout = 0) { return putq(data, timeout); }
+
         int handle_input(ACE_HANDLE handle = ACE_INVALID_HANDLE);
 
-    private:
-        int svc();
+        const std::string& getAddress() const { return address_; }
 
-        ServerSocketWriterTask* task_; ///< Task to receive message objects
-        TCPSocketWriter writer_;       ///< Reader of message objects
+    private:
+        ServerSocketWriterTask* task_; ///< Task that owns us
+        std::string address_;          ///< Remote address of the client
     };
 
     friend class OutputHandler;
@@ -196,6 +224,9 @@ private:
     int bufferSize_;
     long threadFlags_;
     long threadPriority_;
+    SendQueueBase::Policy clientPolicy_;
+    size_t clientDepth_;
+    FanOutWriter fanOut_;
     ConnectionCountChanged connectionCountChangedSignal_;
 };
 
@@ -0,0 +1,239 @@
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <unistd.h>
+
+#include "ace/CDR_Stream.h"
+#include "ace/Reactor.h"
+
+#include "Logger/Log.h"
+#include "Zeroconf/Publisher.h"
+
+#include "MessageManager.h"
+#include "Preamble.h"
+#include "SharedMemoryDataPublisher.h"
+
+using namespace SideCar::IO;
+
+Logger::Log&
+SharedMemoryDataPublisher::Log()
+{
+    static Logger::Log& log_ = Logger::Log::Find("SideCar.IO.SharedMemoryDataPublisher");
+    return log_;
+}
+
+SharedMemoryDataPublisher::Ref
+SharedMemoryDataPublisher::Make()
+{
+    Ref ref(new SharedMemoryDataPublisher);
+    return ref;
+}
+
+SharedMemoryDataPublisher::SharedMemoryDataPublisher() : Super(), ring_(), readerCount_(0), dropCount_(0), timer_(-1)
+{
+    ;
+}
+
+void
+SharedMemoryDataPublisher::setServiceName(const std::string& serviceName)
+{
+    Super::setServiceName(serviceName);
+    std::ostringstream os;
+    os << serviceName << " PUB";
+    setTaskName(os.str());
+}
+
+bool
+SharedMemoryDataPublisher::openAndInit(const std::string& key, const std::string& serviceName, size_t slotCount,
+                                       size_t slotSize)
+{
+    Logger::ProcLog log("openAndInit", Log());
+    LOGINFO << "key: " << key << " serviceName: " << serviceName << " slotCount: " << slotCount
+            << " slotSize: " << slotSize << std::endl;
+
+    if (!reactor()) reactor(ACE_Reactor::instance());
+
+    setMetaTypeInfoKeyName(key);
+    setTransport("shm");
+
+    ring_ = SharedMemoryRing::Create(serviceName, slotCount, slotSize);
+    if (!ring_) {
+        LOGERROR << "failed to create ring for " << serviceName << std::endl;
+        return false;
+    }
+
+    char host[256];
+    if (::gethostname(host, sizeof(host)) == -1) {
+        LOGERROR << "failed gethostname - " << ::strerror(errno) << std::endl;
+        return false;
+    }
+
+    host[sizeof(host) - 1] = 0;
+
+    // Set our Zeroconf publisher connection info. Registering a port of zero would only reserve the name, so
+    // give a non-zero value that subscribers ignore.
+    //
+    std::string serviceType(MakeZeroconfType(key));
+    LOGDEBUG << "serviceType: " << serviceType << std::endl;
+    setType(serviceType);
+    setPort(1);
+    setHost(host);
+
+    std::ostringstream os;
+    os << ::getpid();
+    getConnectionPublisher()->setTextData("pid", os.str());
+    os.str("");
+    os << ring_->getFileDescriptor();
+    getConnectionPublisher()->setTextData("fd", os.str());
+
+    os.str("");
+    os << "Segment: " << SharedMemoryRing::GetPath(::getpid(), ring_->getFileDescriptor())
+       << " Slots: " << ring_->getSlotCount() << " Slot Size: " << ring_->getSlotSize();
+    setConnectionInfo(os.str());
+
+    if (!publish(serviceName)) {
+        LOGERROR << "failed to publish connection with name '" << serviceName << " type: " << serviceType << std::endl;
+        return false;
+    }
+
+    // Create a timer to periodically count the attached subscribers. Subscribers do not announce themselves;
+    // they just take an entry in the ring.
+    //
+    const ACE_Time_Value delay(1);
+    const ACE_Time_Value repeat(1);
+    timer_ = reactor()->schedule_timer(this, &timer_, delay, repeat);
+
+    return true;
+}
+
+int
+SharedMemoryDataPublisher::close(u_long flags)
+{
+    static Logger::ProcLog log("close", Log());
+    LOGINFO << "flags: " << flags << std::endl;
+
+    if (flags) {
+        if (timer_ != -1) {
+            reactor()->cancel_timer(timer_);
+            timer_ = -1;
+        }
+
+        if (ring_) ring_->close();
+        readerCount_ = 0;
+    }
+
+    return Super::close(flags);
+}
+
+int
+SharedMemoryDataPublisher::handle_timeout(const ACE_Time_Value& duration, const void* arg)
+{
+    static Logger::ProcLog log("handle_timeout", Log());
+
+    if (arg != &timer_) return Super::handle_timeout(duration, arg);
+
+    size_t readerCount = ring_->getReaderCount();
+    if (readerCount != readerCount_) {
+        LOGINFO << getTaskName() << " readers: " << readerCount << std::endl;
+        readerCount_ = readerCount;
+        updateUsingDataValue();
+    }
+
+    return 0;
+}
+
+bool
+SharedMemoryDataPublisher::deliverDataMessage(ACE_Message_Block* data, ACE_Time_Value* timeout)
+{
+    if (!isUsingData()) {
+        data->release();
+        return true;
+    }
+
+    MessageManager mgr(data);
+    return write(mgr);
+}
+
+bool
+SharedMemoryDataPublisher::write(const MessageManager& mgr)
+{
+    static Logger::ProcLog log("write", Log());
+
+    // A slot that we claim but never publish is simply claimed again for the next message.
+    //
+    // A subscriber still reading the next slot, or a message too large for a slot, is a drop like a full
+    // queue in MulticastDataPublisher, and not a failure of the task. The claim does not wait for the
+    // subscriber, so that it never holds up the upstream task.
+    //
+    char* slot = ring_->claim();
+    if (!slot) {
+        ++dropCount_;
+        return true;
+    }
+
+    size_t capacity = ring_->getSlotSize();
+    size_t length = 0;
+
+    if (mgr.hasEncoded()) {
+        // Another publisher already encoded the message, so just copy its bytes.
+        //
+        ACE_Message_Block* encoded = mgr.getEncoded();
+        for (ACE_Message_Block* block = encoded; block; block = block->cont()) {
+            if (length + block->length() > capacity) {
+                length = capacity + 1;
+                break;
+            }
+
+            ::memcpy(slot + length, block->rd_ptr(), block->length());
+            length += block->length();
+        }
+
+        encoded->release();
+    } else {
+        // Encode the message body after room for the preamble. If the body does not fit, ACE_OutputCDR moves on
+        // to a new block of its own.
+        //
+        char* body = slot + Preamble::kCDRStreamSize;
+        ACE_OutputCDR messageEncoder(body, capacity - Preamble::kCDRStreamSize);
+        if (!mgr.getNative()->write(messageEncoder).good_bit()) {
+            LOGERROR << getTaskName() << " failed to encode message" << std::endl;
+            ++dropCount_;
+            return false;
+        }
+
+        if (messageEncoder.begin()->rd_ptr() != body || messageEncoder.begin()->cont()) {
+            length = capacity + 1;
+        } else {
+            Preamble preamble(messageEncoder.total_length());
+            ACE_OutputCDR preambleEncoder(slot, Preamble::kCDRStreamSize);
+            preamble.write(preambleEncoder);
+            length = Preamble::kCDRStreamSize + messageEncoder.total_length();
+        }
+    }
+
+    if (length > capacity) {
+        LOGERROR << getTaskName() << " message larger than slot size " << capacity << std::endl;
+        ++dropCount_;
+        return true;
+    }
+
+    ring_->publish(length);
+    return true;
+}
+
+void
+SharedMemoryDataPublisher::fillStatus(StatusBase& status)
+{
+    Super::fillStatus(status);
+
+    // Report the messages that never made it into the ring along with those lost on the way in.
+    //
+    XmlRpc::XmlRpcValue drops(status[TaskStatus::kDropCount]);
+    status.setSlot(TaskStatus::kDropCount, int(drops) + int(dropCount_));
+}
+
+bool
+SharedMemoryDataPublisher::calculateUsingDataValue() const
+{
+    return readerCount_ != 0 || Super::calculateUsingDataValue();
+}
@@ -0,0 +1,143 @@
+#ifndef SIDECAR_IO_SHAREDMEMORYDATAPUBLISHER_H // -*- C++ -*-
+#define SIDECAR_IO_SHAREDMEMORYDATAPUBLISHER_H
+
+#include "IO/DataPublisher.h"
+#include "IO/Module.h"
+#include "IO/SharedMemoryRing.h"
+#include "IO/ZeroconfRegistry.h"
+
+namespace Logger {
+class Log;
+}
+
+namespace SideCar {
+namespace IO {
+
+class MessageManager;
+
+/** Publisher of data to subscribers running on the same host, through a SharedMemoryRing. Each message is encoded
+    straight into a ring slot by the thread delivering it, so there is no message queue, no writer thread, and no
+    kernel copy; subscribers decode the message in place.
+
+    The Zeroconf registration uses the same service type as the TCP and multicast publishers, with a transport of
+    "shm". Instead of a network address, its text record holds the host name and the process ID and file
+    descriptor of the ring segment, from which a subscriber builds the path to map it (see
+    SharedMemoryRing::GetPath()). A subscriber on another host cannot use the publisher and ignores it.
+*/
+class SharedMemoryDataPublisher : public DataPublisher, public ZeroconfTypes::Publisher {
+    using Super = DataPublisher;
+
+public:
+    using Ref = boost::shared_ptr<SharedMemoryDataPublisher>;
+
+    /** Log device for objects of this type.
+
+        \return log device
+    */
+    static Logger::Log& Log();
+
+    /** Factory method for creating new SharedMemoryDataPublisher objects
+
+        \return reference to new SharedMemoryDataPublisher object
+    */
+    static Ref Make();
+
+    /** Create the ring segment and publish its location.
+
+        \param key message type key of published data
+
+        \param serviceName Zeroconf name of service publishing the data
+
+        \param slotCount number of messages the ring holds
+
+        \param slotSize largest encoded message the ring holds, in bytes
+
+        \return true if successful, false otherwise
+    */
+    bool openAndInit(const std::string& key, const std::string& serviceName, size_t slotCount = 64,
+                     size_t slotSize = 256 * 1024);
+
+    /** Override of DataPublisher method. The service is being shutdown. Closes the ring so that subscribers stop
+        waiting on it.
+
+        \param flags if 1 module is shutting down
+
+        \return 0 if successful, -1 otherwise.
+    */
+    int close(u_long flags = 0);
+
+    /** Obtain the number of messages dropped because they did not fit in a slot or a slow subscriber held on
+        to the slot.
+
+        \return message count
+    */
+    size_t getDropCount() const { return dropCount_; }
+
+protected:
+    /** Constructor. Does nothing -- like most ACE classes, all initialization is done in the init and open
+        methods.
+    */
+    SharedMemoryDataPublisher();
+
+    /** Implementation of Task::deliverDataMessage() interface. Writes the message into the next ring slot.
+
+        \param data message to deliver
+
+        \param timeout ignored
+
+        \return true if successful
+    */
+    bool deliverDataMessage(ACE_Message_Block* data, ACE_Time_Value* timeout = 0);
+
+    /** Override of DataPublisher method. Uses the new service name as the basis for our own task name, and
+        calls setTaskName() with the new value.
+
+        \param serviceName the new name to use
+    */
+    void setServiceName(const std::string& serviceName);
+
+    /** Override of Task method. Adds the messages dropped by write() to the drop count.
+
+        \param status container to fill
+    */
+    void fillStatus(StatusBase& status);
+
+    /** Override of DataPublisher method. Invoked by ACE_Reactor when a scheduled timer times out. Updates the
+        count of attached subscribers.
+
+        \param duration ignored
+
+        \param arg value used to distinguish between timer events
+
+        \return 0
+    */
+    int handle_timeout(const ACE_Time_Value& duration, const void* arg);
+
+private:
+    /** Write a message into the next ring slot. Reuses the encoded form of the message if there is one already;
+        otherwise, encodes the native message directly into the slot. A message that does not fit in a slot, or
+        that finds its slot still held by a subscriber, is dropped and counted.
+
+        \param mgr message to write
+
+        \return false if the message could not be encoded
+    */
+    bool write(const MessageManager& mgr);
+
+    bool calculateUsingDataValue() const;
+
+    SharedMemoryRing::Ref ring_;
+    size_t readerCount_;
+    size_t dropCount_;
+    long timer_;
+};
+
+using SharedMemoryDataPublisherModule = TModule<SharedMemoryDataPublisher>;
+
+} // end namespace IO
+} // end namespace SideCar
+
+/** \file
+ */
+
+#endif
@@ -0,0 +1,201 @@
+#include <cstdlib>
+#include <sstream>
+#include <unistd.h>
+
+#include "ace/Reactor.h"
+
+#include "Logger/Log.h"
+#include "Messages/Header.h"
+
+#include "Decoder.h"
+#include "MessageManager.h"
+#include "SharedMemoryDataSubscriber.h"
+
+using namespace SideCar;
+using namespace SideCar::IO;
+
+Logger::Log&
+SharedMemoryDataSubscriber::Log()
+{
+    static Logger::Log& log_ = Logger::Log::Find("SideCar.IO.SharedMemoryDataSubscriber");
+    return log_;
+}
+
+SharedMemoryDataSubscriber::Ref
+SharedMemoryDataSubscriber::Make()
+{
+    Ref ref(new SharedMemoryDataSubscriber);
+    return ref;
+}
+
+SharedMemoryDataSubscriber::SharedMemoryDataSubscriber() :
+    Super(), ring_(), threadFlags_(kDefaultThreadFlags), threadPriority_(ACE_DEFAULT_THREAD_PRIORITY), stopping_(false)
+{
+    ;
+}
+
+bool
+SharedMemoryDataSubscriber::openAndInit(const std::string& key, const std::string& serviceName, int interface,
+                                        long threadFlags, long threadPriority)
+{
+    static Logger::ProcLog log("openAndInit", Log());
+    LOGINFO << "key: " << key << " serviceName: " << serviceName << " interface: " << interface << std::endl;
+
+    setMetaTypeInfoKeyName(key);
+
+    if (!reactor()) reactor(ACE_Reactor::instance());
+    setError("Not connected to publisher");
+
+    threadFlags_ = threadFlags;
+    threadPriority_ = threadPriority;
+
+    return Super::openAndInit(key, serviceName, MakeTwinZeroconfType(key), interface);
+}
+
+int
+SharedMemoryDataSubscriber::close(u_long flags)
+{
+    static Logger::ProcLog log("close", Log());
+    LOGINFO << getTaskName() << " flags: " << flags << std::endl;
+
+    // NOTE: ACE_Task calls close(0) when our svc() thread exits.
+    //
+    if (flags) stopReader();
+
+    return Super::close(flags);
+}
+
+void
+SharedMemoryDataSubscriber::setServiceName(const std::string& serviceName)
+{
+    Super::setServiceName(serviceName);
+    std::string taskName(serviceName);
+    taskName += " SUB (SHM)";
+    setTaskName(taskName);
+}
+
+void
+SharedMemoryDataSubscriber::resolvedService(const Zeroconf::ServiceEntry::Ref& serviceEntry)
+{
+    static Logger::ProcLog log("resolvedService", Log());
+    const Zeroconf::ResolvedEntry& resolved = serviceEntry->getResolvedEntry();
+    LOGINFO << getTaskName() << " host: " << resolved.getHost() << std::endl;
+
+    stopReader();
+
+    if (resolved.getTextEntry("transport") != "shm") {
+        LOGERROR << getTaskName() << " publisher uses transport '" << resolved.getTextEntry("transport") << "'"
+                 << std::endl;
+        setError("Publisher does not use shared memory");
+        return;
+    }
+
+    char host[256];
+    if (::gethostname(host, sizeof(host)) == -1 || resolved.getHost() != host) {
+        LOGERROR << getTaskName() << " publisher is on another host - " << resolved.getHost() << std::endl;
+        setError("Publisher is on another host");
+        return;
+    }
+
+    pid_t pid = ::atoi(resolved.getTextEntry("pid").c_str());
+    int fd = ::atoi(resolved.getTextEntry("fd").c_str());
+    std::string path(SharedMemoryRing::GetPath(pid, fd));
+
+    ring_ = SharedMemoryRing::Attach(path);
+    if (!ring_) {
+        LOGERROR << getTaskName() << " failed to attach to ring " << path << std::endl;
+        setError("Failed to attach to publisher segment");
+        return;
+    }
+
+    if (activate(threadFlags_, 1, 0, threadPriority_) == -1) {
+        LOGERROR << getTaskName() << " failed to start reader thread" << std::endl;
+        setError("Failed to start reader thread");
+        ring_.reset();
+        return;
+    }
+
+    std::ostringstream os;
+    os << "Segment: " << path << " Slots: " << ring_->getSlotCount() << " Slot Size: " << ring_->getSlotSize();
+    setConnectionInfo(os.str());
+
+    clearError();
+    establishedConnection();
+}
+
+void
+SharedMemoryDataSubscriber::lostService()
+{
+    static Logger::ProcLog log("lostService", Log());
+    LOGINFO << getTaskName() << std::endl;
+    stopReader();
+    setError("Not connected to publisher");
+    setConnectionInfo("");
+}
+
+void
+SharedMemoryDataSubscriber::stopReader()
+{
+    static Logger::ProcLog log("stopReader", Log());
+    LOGINFO << getTaskName() << " ring: " << ring_.get() << std::endl;
+
+    if (!ring_) return;
+
+    // The reader thread checks the flag at least every quarter second.
+    //
+    stopping_ = true;
+    wait();
+    stopping_ = false;
+
+    LOGINFO << getTaskName() << " lost messages: " << ring_->getLostCount() << std::endl;
+    ring_.reset();
+}
+
+int
+SharedMemoryDataSubscriber::svc()
+{
+    static Logger::ProcLog log("svc", Log());
+    LOGINFO << getTaskName() << " started" << std::endl;
+
+    SharedMemoryRing::View view;
+    while (!stopping_) {
+        if (ring_->acquire(view, 0.25)) {
+            process(view);
+        } else if (ring_->isClosed()) {
+            // The publisher is gone. Zeroconf will tell us when it, or a replacement, shows up.
+            //
+            LOGWARNING << getTaskName() << " publisher closed its ring" << std::endl;
+            break;
+        }
+    }
+
+    LOGINFO << getTaskName() << " stopped" << std::endl;
+    return 0;
+}
+
+void
+SharedMemoryDataSubscriber::process(const SharedMemoryRing::View& view)
+{
+    static Logger::ProcLog log("process", Log());
+
+    // Decode straight from the ring slot. The message block just points at the slot, and the slot stays pinned
+    // until the native message is built.
+    //
+    Messages::Header::Ref msg;
+    try {
+        ACE_Message_Block* data = new ACE_Message_Block(const_cast<char*>(view.data), view.length);
+        data->wr_ptr(view.length);
+        Decoder decoder(data);
+        msg = getMetaTypeInfoCDRLoader()(decoder);
+    } catch (const std::exception& ex) {
+        LOGERROR << getTaskName() << " failed to decode message " << view.sequence << " - " << ex.what()
+                 << std::endl;
+    }
+
+    ring_->release();
+    if (!msg) return;
+
+    MessageManager mgr(msg);
+    updateInputStats(0, msg->getSize(), msg->getMessageSequenceNumber());
+    sendManaged(mgr, 0);
+}
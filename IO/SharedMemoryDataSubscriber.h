@@ -0,0 +1,115 @@
+#ifndef SIDECAR_IO_SHAREDMEMORYDATASUBSCRIBER_H // -*- C++ -*-
+#define SIDECAR_IO_SHAREDMEMORYDATASUBSCRIBER_H
+
+#include <atomic>
+
+#include "IO/DataSubscriber.h"
+#include "IO/Module.h"
+#include "IO/SharedMemoryRing.h"
+#include "IO/ZeroconfRegistry.h"
+
+namespace Logger {
+class Log;
+}
+
+namespace SideCar {
+namespace IO {
+
+/** Subscriber to a SharedMemoryDataPublisher running on the same host. Once the publisher's service resolves, maps
+    its ring segment and starts a thread that waits for messages in the ring, decodes each one in place, and
+    sends the result down the stream. A publisher on another host, or one using a different transport, is
+    ignored.
+*/
+class SharedMemoryDataSubscriber : public DataSubscriber, public ZeroconfTypes::Subscriber {
+    using Super = DataSubscriber;
+
+public:
+    using Ref = boost::shared_ptr<SharedMemoryDataSubscriber>;
+
+    /** Log device for objects of this type.
+
+        \return log device
+    */
+    static Logger::Log& Log();
+
+    /** Factory method for creating new SharedMemoryDataSubscriber objects
+
+        \return reference to new SharedMemoryDataSubscriber object
+    */
+    static Ref Make();
+
+    /** Prepare to subscribe to a data publisher with a given service name. Starts a Zeroconf::Browser to watch
+        for DataPublisher objects bearing the service name.
+
+        \param key message type key of data coming in
+
+        \param serviceName Zeroconf name of service publishing the data
+
+        \return true if successful, false otherwise
+    */
+    bool openAndInit(const std::string& key, const std::string& serviceName, int interface = 0,
+                     long threadFlags = kDefaultThreadFlags, long threadPriority = ACE_DEFAULT_THREAD_PRIORITY);
+
+    /** Override of DataSubscriber method. The service is being shutdown.
+
+        \param flags if 1 module is shutting down
+
+        \return 0 if successful, -1 otherwise.
+    */
+    int close(u_long flags = 0);
+
+protected:
+    /** Constructor. Does nothing -- like most ACE classes, all initialization is done in the init and open
+        methods.
+    */
+    SharedMemoryDataSubscriber();
+
+    /** Override of DataSubscriber method. Updates the task name with the service name.
+
+        \param serviceName
+    */
+    void setServiceName(const std::string& serviceName);
+
+private:
+    /** Implementation of DataSubscriber API. Notification that a ServiceEntry has connection information. Maps
+        the publisher's ring and starts the reader thread.
+
+        \param service the service that was resolved
+    */
+    void resolvedService(const Zeroconf::ServiceEntry::Ref& service);
+
+    /** Implementation of DataSubscriber API. Notification that the publisher is no longer available. Stops the
+        reader thread and unmaps the ring.
+    */
+    void lostService();
+
+    /** Stop any running reader thread, and release the ring.
+     */
+    void stopReader();
+
+    /** Override of ACE_Task method. Routine that runs in a separate thread. Takes messages from the ring until
+        stopReader() or until the publisher goes away.
+    */
+    int svc();
+
+    /** Decode a message held in the ring and send it on.
+
+        \param view location of the encoded message
+    */
+    void process(const SharedMemoryRing::View& view);
+
+    SharedMemoryRing::Ref ring_;
+    long threadFlags_;
+    long threadPriority_;
+    std::atomic<bool> stopping_;
+};
+
+using SharedMemoryDataSubscriberModule = TModule<SharedMemoryDataSubscriber>;
+
+} // end namespace IO
+} // end namespace SideCar
+
+/** \file
+ */
+
+#endif
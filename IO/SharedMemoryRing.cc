@@ -0,0 +1,400 @@
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sched.h>
+#include <signal.h>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "Logger/Log.h"
+
+#include "SharedMemoryRing.h"
+
+using namespace SideCar::IO;
+
+namespace {
+
+const uint32_t kMagic = 0x5343524E; // "SCRN"
+const uint32_t kVersion = 1;
+constexpr size_t kAlignment = 64;
+
+size_t
+RoundUp(size_t value)
+{
+    return (value + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+timespec
+MakeTimeSpec(double seconds)
+{
+    timespec spec;
+    spec.tv_sec = time_t(seconds);
+    spec.tv_nsec = long((seconds - spec.tv_sec) * 1.0E9);
+    return spec;
+}
+
+bool
+IsAlive(pid_t pid)
+{
+    return ::kill(pid, 0) == 0 || errno != ESRCH;
+}
+
+} // namespace
+
+/** Entry in the table of attached readers. A reader stores the sequence number of the message it is about to
+    use in pinned before checking that the slot still holds that message; the writer marks a slot busy before
+    checking for pins on its old message. With sequentially-consistent operations on both sides, one of them
+    always sees the other.
+*/
+struct alignas(kAlignment) SharedMemoryRing::ReaderEntry {
+    std::atomic<int32_t> pid;
+    std::atomic<uint64_t> pinned;
+};
+
+/** Layout of the start of the segment. The slots follow.
+ */
+struct SharedMemoryRing::Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slotCount;
+    uint32_t slotSize; ///< Bytes from one slot to the next
+    int32_t writerPid;
+    std::atomic<uint32_t> closed;
+    std::atomic<uint32_t> futex;   ///< Bumped after each publish() and at close()
+    std::atomic<uint32_t> waiters; ///< Number of readers blocked on futex
+    std::atomic<uint64_t> head;    ///< Sequence number of the last message published
+    ReaderEntry readers[kMaxReaders];
+};
+
+/** Layout of a slot. Message bytes start at the next kAlignment boundary, so CDR data keeps its natural
+    alignment.
+*/
+struct SharedMemoryRing::Slot {
+    std::atomic<uint64_t> sequence; ///< Sequence number of the message held, or 0 while being written
+    uint64_t length;
+
+    char* getData() { return reinterpret_cast<char*>(this) + kAlignment; }
+};
+
+Logger::Log&
+SharedMemoryRing::Log()
+{
+    static Logger::Log& log_ = Logger::Log::Find("SideCar.IO.SharedMemoryRing");
+    return log_;
+}
+
+std::string
+SharedMemoryRing::GetPath(pid_t pid, int fd)
+{
+    std::ostringstream os;
+    os << "/proc/" << pid << "/fd/" << fd;
+    return os.str();
+}
+
+SharedMemoryRing::Ref
+SharedMemoryRing::Create(const std::string& name, size_t slotCount, size_t slotSize)
+{
+    Logger::ProcLog log("Create", Log());
+    LOGINFO << name << ' ' << slotCount << ' ' << slotSize << std::endl;
+
+    size_t stride = kAlignment + RoundUp(slotSize);
+    if (slotCount == 0 || slotSize == 0 || stride > UINT32_MAX) {
+        LOGERROR << "invalid ring dimensions " << slotCount << 'x' << slotSize << std::endl;
+        return Ref();
+    }
+
+    int fd = ::memfd_create(name.c_str(), MFD_CLOEXEC);
+    if (fd == -1) {
+        LOGERROR << "failed memfd_create - " << ::strerror(errno) << std::endl;
+        return Ref();
+    }
+
+    size_t size = RoundUp(sizeof(Header)) + slotCount * stride;
+    if (::ftruncate(fd, size) == -1) {
+        LOGERROR << "failed to size segment to " << size << " - " << ::strerror(errno) << std::endl;
+        ::close(fd);
+        return Ref();
+    }
+
+    void* base = ::mmap(0, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        LOGERROR << "failed mmap - " << ::strerror(errno) << std::endl;
+        ::close(fd);
+        return Ref();
+    }
+
+    // The new file is all zeros, which is a valid state for every atomic in it.
+    //
+    Header* header = static_cast<Header*>(base);
+    header->magic = kMagic;
+    header->version = kVersion;
+    header->slotCount = slotCount;
+    header->slotSize = stride;
+    header->writerPid = ::getpid();
+
+    return Ref(new SharedMemoryRing(fd, base, size, true));
+}
+
+SharedMemoryRing::Ref
+SharedMemoryRing::Attach(const std::string& path)
+{
+    Logger::ProcLog log("Attach", Log());
+    LOGINFO << path << std::endl;
+
+    int fd = ::open(path.c_str(), O_RDWR | O_CLOEXEC);
+    if (fd == -1) {
+        LOGERROR << "failed to open " << path << " - " << ::strerror(errno) << std::endl;
+        return Ref();
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) == -1 || size_t(st.st_size) < sizeof(Header)) {
+        LOGERROR << path << " is not a ring" << std::endl;
+        ::close(fd);
+        return Ref();
+    }
+
+    void* base = ::mmap(0, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        LOGERROR << "failed mmap - " << ::strerror(errno) << std::endl;
+        ::close(fd);
+        return Ref();
+    }
+
+    Ref ring(new SharedMemoryRing(fd, base, st.st_size, false));
+    Header* header = ring->header_;
+    if (header->magic != kMagic || header->version != kVersion ||
+        RoundUp(sizeof(Header)) + size_t(header->slotCount) * header->slotSize > size_t(st.st_size)) {
+        LOGERROR << path << " is not a ring" << std::endl;
+        return Ref();
+    }
+
+    // Take a free reader entry, and start with the next message published.
+    //
+    for (int index = 0; index < kMaxReaders; ++index) {
+        ReaderEntry& entry(header->readers[index]);
+        int32_t expected = 0;
+        if (entry.pid.compare_exchange_strong(expected, ::getpid())) {
+            entry.pinned.store(0);
+            ring->entry_ = &entry;
+            ring->next_ = header->head.load() + 1;
+            return ring;
+        }
+    }
+
+    LOGERROR << path << " has no free reader entries" << std::endl;
+    return Ref();
+}
+
+SharedMemoryRing::SharedMemoryRing(int fd, void* base, size_t size, bool writer) :
+    fd_(fd), base_(base), size_(size), header_(static_cast<Header*>(base)), writer_(writer), entry_(0), next_(1),
+    lost_(0)
+{
+    ;
+}
+
+SharedMemoryRing::~SharedMemoryRing()
+{
+    if (writer_) {
+        close();
+    } else if (entry_) {
+        entry_->pinned.store(0);
+        entry_->pid.store(0);
+    }
+
+    ::munmap(base_, size_);
+    ::close(fd_);
+}
+
+size_t
+SharedMemoryRing::getSlotCount() const
+{
+    return header_->slotCount;
+}
+
+size_t
+SharedMemoryRing::getSlotSize() const
+{
+    return header_->slotSize - kAlignment;
+}
+
+uint64_t
+SharedMemoryRing::getSequence() const
+{
+    return header_->head.load(std::memory_order_acquire);
+}
+
+SharedMemoryRing::Slot&
+SharedMemoryRing::getSlot(uint64_t sequence) const
+{
+    char* slots = static_cast<char*>(base_) + RoundUp(sizeof(Header));
+    return *reinterpret_cast<Slot*>(slots + ((sequence - 1) % header_->slotCount) * header_->slotSize);
+}
+
+char*
+SharedMemoryRing::claim(double wait)
+{
+    static Logger::ProcLog log("claim", Log());
+
+    uint64_t sequence = header_->head.load(std::memory_order_relaxed) + 1;
+    Slot& slot(getSlot(sequence));
+
+    // Mark the slot busy so that no reader pins its old message from here on, then wait for readers that did to
+    // let go of it.
+    //
+    uint64_t old = slot.sequence.exchange(0);
+    if (old) {
+        timespec start;
+        ::clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int index = 0; index < kMaxReaders; ++index) {
+            ReaderEntry& entry(header_->readers[index]);
+            for (int spins = 0; entry.pinned.load() == old; ++spins) {
+                int32_t pid = entry.pid.load();
+                if (pid == 0 || !IsAlive(pid)) {
+                    LOGWARNING << "clearing entry of reader " << pid << std::endl;
+                    entry.pinned.store(0);
+                    entry.pid.store(0);
+                    break;
+                }
+
+                if (spins < 100 && wait > 0.0) {
+                    ::sched_yield();
+                    continue;
+                }
+
+                timespec now;
+                ::clock_gettime(CLOCK_MONOTONIC, &now);
+                if (now.tv_sec - start.tv_sec + (now.tv_nsec - start.tv_nsec) * 1.0E-9 >= wait) {
+                    LOGDEBUG1 << "reader " << pid << " still holds message " << old << std::endl;
+                    slot.sequence.store(old);
+                    return 0;
+                }
+
+                timespec nap = MakeTimeSpec(50.0E-6);
+                ::nanosleep(&nap, 0);
+            }
+        }
+    }
+
+    return slot.getData();
+}
+
+void
+SharedMemoryRing::publish(size_t length)
+{
+    uint64_t sequence = header_->head.load(std::memory_order_relaxed) + 1;
+    Slot& slot(getSlot(sequence));
+    slot.length = length;
+    slot.sequence.store(sequence, std::memory_order_release);
+    header_->head.store(sequence, std::memory_order_release);
+    header_->futex.fetch_add(1);
+    if (header_->waiters.load()) {
+        ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&header_->futex), FUTEX_WAKE, INT_MAX, 0, 0, 0);
+    }
+}
+
+void
+SharedMemoryRing::close()
+{
+    if (header_->closed.exchange(1)) return;
+    header_->futex.fetch_add(1);
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&header_->futex), FUTEX_WAKE, INT_MAX, 0, 0, 0);
+}
+
+size_t
+SharedMemoryRing::getReaderCount()
+{
+    size_t count = 0;
+    for (int index = 0; index < kMaxReaders; ++index) {
+        ReaderEntry& entry(header_->readers[index]);
+        int32_t pid = entry.pid.load();
+        if (pid == 0) continue;
+        if (IsAlive(pid)) {
+            ++count;
+        } else {
+            entry.pinned.store(0);
+            entry.pid.compare_exchange_strong(pid, 0);
+        }
+    }
+
+    return count;
+}
+
+bool
+SharedMemoryRing::acquire(View& view, double timeout)
+{
+    static Logger::ProcLog log("acquire", Log());
+
+    timespec start;
+    ::clock_gettime(CLOCK_MONOTONIC, &start);
+    while (true) {
+        // Snapshot the futex word before looking for a message, so that a publish() after the look wakes us.
+        //
+        uint32_t value = header_->futex.load();
+        uint64_t head = header_->head.load(std::memory_order_acquire);
+        if (next_ > head) {
+            if (header_->closed.load()) return false;
+            timespec now;
+            ::clock_gettime(CLOCK_MONOTONIC, &now);
+            double remaining = timeout - (now.tv_sec - start.tv_sec + (now.tv_nsec - start.tv_nsec) * 1.0E-9);
+            if (remaining <= 0.0) return false;
+            waitForChange(value, remaining);
+            continue;
+        }
+
+        // Skip over messages the writer has already reused the slots of.
+        //
+        if (head - next_ >= header_->slotCount) {
+            uint64_t oldest = head - header_->slotCount + 1;
+            lost_ += oldest - next_;
+            next_ = oldest;
+        }
+
+        Slot& slot(getSlot(next_));
+        entry_->pinned.store(next_);
+        if (slot.sequence.load() != next_) {
+
+            // The writer is putting a newer message in the slot, so this one is gone.
+            //
+            entry_->pinned.store(0);
+            LOGDEBUG << "lost message " << next_ << std::endl;
+            ++lost_;
+            ++next_;
+            continue;
+        }
+
+        view.data = slot.getData();
+        view.length = slot.length;
+        view.sequence = next_++;
+        return true;
+    }
+}
+
+void
+SharedMemoryRing::release()
+{
+    entry_->pinned.store(0, std::memory_order_release);
+}
+
+bool
+SharedMemoryRing::isClosed() const
+{
+    return header_->closed.load() || !IsAlive(header_->writerPid);
+}
+
+void
+SharedMemoryRing::waitForChange(uint32_t value, double timeout) const
+{
+    timespec spec = MakeTimeSpec(timeout);
+    header_->waiters.fetch_add(1);
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&header_->futex), FUTEX_WAIT, value, &spec, 0, 0);
+    header_->waiters.fetch_sub(1);
+}
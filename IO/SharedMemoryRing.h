@@ -0,0 +1,194 @@
+#ifndef SIDECAR_IO_SHAREDMEMORYRING_H // -*- C++ -*-
+#define SIDECAR_IO_SHAREDMEMORYRING_H
+
+#include <cstdint>
+#include <string>
+#include <sys/types.h>
+
+#include "boost/shared_ptr.hpp"
+
+namespace Logger {
+class Log;
+}
+
+namespace SideCar {
+namespace IO {
+
+/** Ring of fixed-size message slots in a shared memory segment, written by one process and read by any number
+    of others on the same host. The segment is an anonymous memfd file; other processes map it by opening the
+    writer's descriptor through /proc (see GetPath()).
+
+    The writer places message N in slot (N - 1) % slotCount, and readers follow along at their own pace. A
+    reader sees a message in place, with no copying, from acquire() until release(). While it does, the slot is
+    pinned: the writer will not reuse it, and by default gives up on the new message at once instead of waiting
+    for the reader to let go, so that a slow reader never stalls the writer. Pins live in a table of per-reader entries instead of a counter in each slot, so
+    that a reader that dies holding one does not wedge the writer; the writer clears the entries of readers
+    whose processes are gone.
+
+    A reader that falls more than slotCount messages behind loses the oldest ones, and getLostCount() tells how
+    many. Readers block in a futex on the segment while waiting for new messages.
+*/
+class SharedMemoryRing {
+public:
+    using Ref = boost::shared_ptr<SharedMemoryRing>;
+
+    /** Most readers that may attach to a ring at once.
+     */
+    enum { kMaxReaders = 32 };
+
+    /** View of a message held by a reader between acquire() and release().
+     */
+    struct View {
+        const char* data;
+        size_t length;
+        uint64_t sequence;
+    };
+
+    static Logger::Log& Log();
+
+    /** Create a new ring for writing.
+
+        \param name name of the memfd file, seen only in /proc listings
+
+        \param slotCount number of message slots
+
+        \param slotSize largest message the ring holds, in bytes
+
+        \return new ring, or NULL if the segment could not be created
+    */
+    static Ref Create(const std::string& name, size_t slotCount, size_t slotSize);
+
+    /** Attach to a ring created by another process, as a reader.
+
+        \param path path of the segment, from GetPath()
+
+        \return new ring, or NULL if the segment could not be opened or is not a ring, or if all reader entries
+        are taken
+    */
+    static Ref Attach(const std::string& path);
+
+    /** Obtain the path another process on the host can give to Attach() to map a ring.
+
+        \param pid process ID of the writer
+
+        \param fd file descriptor of the segment in the writer
+
+        \return path in /proc
+    */
+    static std::string GetPath(pid_t pid, int fd);
+
+    /** Destructor. A writer marks the ring closed, and a reader gives up its reader entry.
+     */
+    ~SharedMemoryRing();
+
+    /** Obtain the file descriptor of the segment.
+
+        \return file descriptor
+    */
+    int getFileDescriptor() const { return fd_; }
+
+    /** Obtain the number of message slots.
+
+        \return slot count
+    */
+    size_t getSlotCount() const;
+
+    /** Obtain the largest message the ring holds.
+
+        \return size in bytes
+    */
+    size_t getSlotSize() const;
+
+    /** Obtain the number of messages written to the ring.
+
+        \return message count
+    */
+    uint64_t getSequence() const;
+
+    /** Writer method. Claim the next slot for a new message. Waits up to a given time for readers still using a
+        previous message in the slot to finish with it.
+
+        \param wait seconds to wait for readers. If zero, fails right away when a reader holds the slot.
+
+        \return address of the slot's getSlotSize() bytes, or NULL if readers kept the slot
+    */
+    char* claim(double wait = 0.0);
+
+    /** Writer method. Make the message in the slot obtained from claim() visible to readers, and wake up any
+        waiting readers.
+
+        \param length number of bytes of the message
+    */
+    void publish(size_t length);
+
+    /** Writer method. Mark the ring closed, and wake up any waiting readers. Readers get the messages already
+        written, then see isClosed().
+    */
+    void close();
+
+    /** Writer method. Obtain the number of attached readers. Clears the entries of readers that have exited.
+
+        \return reader count
+    */
+    size_t getReaderCount();
+
+    /** Reader method. Wait for the next message and pin it.
+
+        \param view storage for the message
+
+        \param timeout seconds to wait for a message
+
+        \return true if there is a message, false if the wait timed out or the ring closed
+    */
+    bool acquire(View& view, double timeout);
+
+    /** Reader method. Unpin the message obtained by the last acquire().
+     */
+    void release();
+
+    /** Reader method. Determine if the writer has closed the ring or exited.
+
+        \return true if so
+    */
+    bool isClosed() const;
+
+    /** Reader method. Obtain the number of messages lost because the writer overran this reader.
+
+        \return message count
+    */
+    uint64_t getLostCount() const { return lost_; }
+
+private:
+    struct Header;
+    struct ReaderEntry;
+    struct Slot;
+
+    SharedMemoryRing(int fd, void* base, size_t size, bool writer);
+
+    Slot& getSlot(uint64_t sequence) const;
+
+    /** Wait for the futex word of the ring to change from a given value.
+
+        \param value last value seen
+
+        \param timeout seconds to wait
+    */
+    void waitForChange(uint32_t value, double timeout) const;
+
+    int fd_;
+    void* base_;
+    size_t size_;
+    Header* header_;
+    bool writer_;
+    ReaderEntry* entry_;
+    uint64_t next_;
+    uint64_t lost_;
+};
+
+} // end namespace IO
+} // end namespace SideCar
+
+/** \file
+ */
+
+#endif
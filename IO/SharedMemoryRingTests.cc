@@ -0,0 +1,133 @@
+#include <cstring>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "Threading/Threading.h"
+#include "UnitTest/UnitTest.h"
+
+#include "SharedMemoryRing.h"
+
+using namespace SideCar::IO;
+
+struct Test : public UnitTest::TestObj {
+    Test() : UnitTest::TestObj("SharedMemoryRing") {}
+    void test();
+};
+
+static void
+Write(SharedMemoryRing& ring, const std::string& text)
+{
+    char* data = ring.claim();
+    ::memcpy(data, text.data(), text.size());
+    ring.publish(text.size());
+}
+
+static std::string
+Read(SharedMemoryRing& ring)
+{
+    SharedMemoryRing::View view;
+    if (!ring.acquire(view, 1.0)) return "";
+    std::string text(view.data, view.length);
+    ring.release();
+    return text;
+}
+
+/** Reader that waits in acquire() for a message written after it starts.
+ */
+struct Waiter : public Threading::Thread {
+    Waiter(SharedMemoryRing& ring) : Thread(), ring_(ring), text_() {}
+
+    void run() { text_ = Read(ring_); }
+
+    SharedMemoryRing& ring_;
+    std::string text_;
+};
+
+void
+Test::test()
+{
+    SharedMemoryRing::Ref writer(SharedMemoryRing::Create("test", 4, 100));
+    assertTrue(writer.get());
+    assertEqual(size_t(4), writer->getSlotCount());
+    assertTrue(writer->getSlotSize() >= 100);
+    assertEqual(size_t(0), writer->getReaderCount());
+
+    std::string path(SharedMemoryRing::GetPath(::getpid(), writer->getFileDescriptor()));
+    assertFalse(SharedMemoryRing::Attach("/dev/null").get());
+
+    // A reader starts with the first message written after it attaches.
+    //
+    Write(*writer, "before");
+    SharedMemoryRing::Ref reader(SharedMemoryRing::Attach(path));
+    assertTrue(reader.get());
+    assertEqual(size_t(1), writer->getReaderCount());
+
+    Write(*writer, "one");
+    Write(*writer, "two");
+    assertEqual(std::string("one"), Read(*reader));
+    assertEqual(std::string("two"), Read(*reader));
+
+    SharedMemoryRing::View view;
+    assertFalse(reader->acquire(view, 0.01));
+
+    // A blocked reader wakes up when a message arrives.
+    //
+    Waiter waiter(*reader);
+    waiter.start();
+    Threading::Thread::Sleep(0.05);
+    Write(*writer, "three");
+    waiter.join();
+    assertEqual(std::string("three"), waiter.text_);
+
+    // A reader that falls behind by more than the ring size loses the oldest messages.
+    //
+    for (int index = 0; index < 6; ++index) Write(*writer, std::string(1, 'a' + index));
+    assertEqual(std::string("c"), Read(*reader));
+    assertEqual(uint64_t(2), reader->getLostCount());
+    assertEqual(std::string("d"), Read(*reader));
+
+    // The writer does not reuse a slot while a reader holds its message.
+    //
+    assertTrue(reader->acquire(view, 1.0));
+    assertEqual(std::string("e"), std::string(view.data, view.length));
+    Write(*writer, "g");
+    Write(*writer, "h");
+    assertTrue(writer->claim() == 0);
+    assertTrue(writer->claim(0.01) == 0);
+    assertEqual(std::string("e"), std::string(view.data, view.length));
+    reader->release();
+    assertTrue(writer->claim(0.01) != 0);
+    writer->publish(0);
+
+    // The entry of a reader in a process that exits goes away, along with any message it held.
+    //
+    pid_t child = ::fork();
+    if (child == 0) {
+        SharedMemoryRing::Ref other(SharedMemoryRing::Attach(path));
+        Write(*writer, "from child");
+        if (!other || !other->acquire(view, 1.0)) ::_exit(1);
+        ::_exit(0);
+    }
+
+    int status = 0;
+    ::waitpid(child, &status, 0);
+    assertEqual(0, WEXITSTATUS(status));
+    assertEqual(size_t(1), writer->getReaderCount());
+
+    // Once closed, readers see what remains and then the close.
+    //
+    writer->close();
+    assertTrue(reader->isClosed());
+    while (reader->acquire(view, 1.0)) reader->release();
+    assertEqual(uint64_t(writer->getSequence()), view.sequence);
+
+    reader.reset();
+    assertEqual(size_t(0), writer->getReaderCount());
+}
+
+int
+main(int argc, const char* argv[])
+{
+    return Test().mainRun();
+}
@@ -22,7 +22,7 @@ public:
      */
     enum Index { kVersion = 0, kClassName, kName, kNumSlots };
 
-    static std::string GetCompiledVersion() { return "2.0"; }
+    static std::string GetCompiledVersion() { return "2.1"; }
 
     static void Make(XmlRpc::XmlRpcValue& status, size_t numSlots, const std::string& className,
                      const std::string& name);
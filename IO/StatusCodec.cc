@@ -0,0 +1,470 @@
+#include <cstring>
+#include <ctime>
+
+#include "StatusBase.h"
+#include "StatusCodec.h"
+
+using namespace SideCar::IO;
+
+const char StatusCodec::kSignature[4] = {'\0', 'S', 'C', 'S'};
+
+namespace {
+
+void
+writeVarint(std::string& output, uint64_t value)
+{
+    while (value >= 0x80) {
+        output.push_back(char((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    output.push_back(char(value));
+}
+
+void
+writeInt(std::string& output, int value)
+{
+    // Zig-zag encoding keeps small negative values small.
+    //
+    writeVarint(output, (uint32_t(value) << 1) ^ uint32_t(value >> 31));
+}
+
+void
+writeString(std::string& output, const std::string& value)
+{
+    writeVarint(output, value.size());
+    output.append(value);
+}
+
+void
+writeDouble(std::string& output, double value)
+{
+    uint64_t bits;
+    ::memcpy(&bits, &value, sizeof(bits));
+    for (int index = 0; index < 8; ++index) {
+        output.push_back(char(bits & 0xFF));
+        bits >>= 8;
+    }
+}
+
+/** Determine if an XML-RPC value holds a status container created by StatusBase::Make().
+ */
+bool
+isStatus(const XmlRpc::XmlRpcValue& value)
+{
+    if (value.getType() != XmlRpc::XmlRpcValue::TypeArray || value.size() < StatusBase::kNumSlots) return false;
+    const XmlRpc::XmlRpcValue& version(value[StatusBase::kVersion]);
+    return version.getType() == XmlRpc::XmlRpcValue::TypeString &&
+           value[StatusBase::kClassName].getType() == XmlRpc::XmlRpcValue::TypeString &&
+           static_cast<const std::string&>(version) == StatusBase::GetCompiledVersion();
+}
+
+} // namespace
+
+bool
+StatusCodec::IsBinary(const char* data, size_t size)
+{
+    return size > sizeof(kSignature) && ::memcmp(data, kSignature, sizeof(kSignature)) == 0;
+}
+
+StatusEncoder::StatusEncoder(int keyframeInterval) :
+    keyframeInterval_(keyframeInterval < 1 ? 1 : keyframeInterval), framesSinceKeyframe_(0), forceKeyframe_(true),
+    sequence_(0), keyframeSequence_(0), keyframe_(), schemaIds_(), schemas_(), keyframeSchemaCount_(0)
+{
+    ;
+}
+
+uint32_t
+StatusEncoder::getSchemaId(const std::string& version, const std::string& className)
+{
+    SchemaKey key(version, className);
+    auto pos = schemaIds_.find(key);
+    if (pos != schemaIds_.end()) return pos->second;
+    uint32_t id = schemas_.size();
+    schemaIds_.insert(SchemaIdMap::value_type(key, id));
+    schemas_.push_back(key);
+    return id;
+}
+
+bool
+StatusEncoder::encode(const XmlRpc::XmlRpcValue& status, std::string& output)
+{
+    bool keyframe = forceKeyframe_ || ++framesSinceKeyframe_ >= keyframeInterval_;
+    ++sequence_;
+
+    // Encode the body first, since doing so may define new schemas that must appear in the header.
+    //
+    std::string body;
+    if (keyframe) {
+        encodeValue(status, body);
+    } else {
+        if (!encodeDelta(status, keyframe_, body) && body.empty()) encodeValue(status, body);
+    }
+
+    output.clear();
+    output.append(kSignature, sizeof(kSignature));
+    output.push_back(char(keyframe ? kKeyframe : 0));
+    writeVarint(output, sequence_);
+    writeVarint(output, keyframe ? sequence_ : keyframeSequence_);
+
+    size_t firstSchema = keyframe ? 0 : keyframeSchemaCount_;
+    writeVarint(output, schemas_.size() - firstSchema);
+    for (size_t index = firstSchema; index < schemas_.size(); ++index) {
+        writeVarint(output, index);
+        writeString(output, schemas_[index].first);
+        writeString(output, schemas_[index].second);
+    }
+
+    output.append(body);
+
+    if (keyframe) {
+        keyframe_ = status;
+        keyframeSequence_ = sequence_;
+        keyframeSchemaCount_ = schemas_.size();
+        framesSinceKeyframe_ = 0;
+        forceKeyframe_ = false;
+    }
+
+    return keyframe;
+}
+
+void
+StatusEncoder::encodeValue(const XmlRpc::XmlRpcValue& value, std::string& output)
+{
+    switch (value.getType()) {
+    case XmlRpc::XmlRpcValue::TypeBoolean:
+        output.push_back(char(static_cast<const bool&>(value) ? kTrue : kFalse));
+        break;
+
+    case XmlRpc::XmlRpcValue::TypeInt:
+        output.push_back(char(kInt));
+        writeInt(output, value);
+        break;
+
+    case XmlRpc::XmlRpcValue::TypeDouble:
+        output.push_back(char(kDouble));
+        writeDouble(output, value);
+        break;
+
+    case XmlRpc::XmlRpcValue::TypeString:
+        output.push_back(char(kString));
+        writeString(output, value);
+        break;
+
+    case XmlRpc::XmlRpcValue::TypeDateTime: {
+        const struct tm& t(value);
+        output.push_back(char(kDateTime));
+        writeInt(output, t.tm_year);
+        writeInt(output, t.tm_mon);
+        writeInt(output, t.tm_mday);
+        writeInt(output, t.tm_hour);
+        writeInt(output, t.tm_min);
+        writeInt(output, t.tm_sec);
+        break;
+    }
+
+    case XmlRpc::XmlRpcValue::TypeBase64: {
+        const XmlRpc::XmlRpcValue::BinaryData& data(value);
+        output.push_back(char(kBase64));
+        writeVarint(output, data.size());
+        output.append(data.begin(), data.end());
+        break;
+    }
+
+    case XmlRpc::XmlRpcValue::TypeArray:
+        if (isStatus(value)) {
+            output.push_back(char(kStatus));
+            writeVarint(output, getSchemaId(value[StatusBase::kVersion], value[StatusBase::kClassName]));
+            writeVarint(output, value.size());
+            for (int index = StatusBase::kName; index < value.size(); ++index) encodeValue(value[index], output);
+        } else {
+            output.push_back(char(kArray));
+            writeVarint(output, value.size());
+            for (int index = 0; index < value.size(); ++index) encodeValue(value[index], output);
+        }
+        break;
+
+    case XmlRpc::XmlRpcValue::TypeStruct: {
+        const XmlRpc::XmlRpcValue::ValueStruct& members(value);
+        output.push_back(char(kStruct));
+        writeVarint(output, members.size());
+        for (auto& member : members) {
+            writeString(output, member.first);
+            encodeValue(member.second, output);
+        }
+        break;
+    }
+
+    default: output.push_back(char(kInvalid)); break;
+    }
+}
+
+bool
+StatusEncoder::encodeDelta(const XmlRpc::XmlRpcValue& value, const XmlRpc::XmlRpcValue& base, std::string& output)
+{
+    // Only arrays have slots to compare. Anything else that changed goes out in full.
+    //
+    if (value.getType() != XmlRpc::XmlRpcValue::TypeArray || base.getType() != XmlRpc::XmlRpcValue::TypeArray) {
+        if (value == base) return false;
+        encodeValue(value, output);
+        return true;
+    }
+
+    std::string changes;
+    std::string nested;
+    size_t changeCount = 0;
+    for (int index = 0; index < value.size(); ++index) {
+        const XmlRpc::XmlRpcValue& slot(value[index]);
+        if (index < base.size()) {
+            const XmlRpc::XmlRpcValue& baseSlot(base[index]);
+            if (slot.getType() == XmlRpc::XmlRpcValue::TypeArray &&
+                baseSlot.getType() == XmlRpc::XmlRpcValue::TypeArray) {
+                nested.clear();
+                if (!encodeDelta(slot, baseSlot, nested)) continue;
+                writeVarint(changes, index);
+                changes.append(nested);
+                ++changeCount;
+                continue;
+            }
+
+            if (slot == baseSlot) continue;
+        }
+
+        writeVarint(changes, index);
+        encodeValue(slot, changes);
+        ++changeCount;
+    }
+
+    if (changeCount == 0 && value.size() == base.size()) {
+        // Nothing changed, but the top-level frame must still hold a valid value.
+        //
+        output.push_back(char(kDelta));
+        writeVarint(output, value.size());
+        writeVarint(output, 0);
+        return false;
+    }
+
+    output.push_back(char(kDelta));
+    writeVarint(output, value.size());
+    writeVarint(output, changeCount);
+    output.append(changes);
+    return true;
+}
+
+/** Sequential reader of the bytes in a binary frame. All methods return false if there is not enough data.
+ */
+struct StatusDecoder::Reader {
+    enum { kMaxSize = 1 << 24 };
+
+    Reader(const char* data, size_t size) : pos_(data), end_(data + size) {}
+
+    bool readByte(uint8_t& value)
+    {
+        if (pos_ == end_) return false;
+        value = uint8_t(*pos_++);
+        return true;
+    }
+
+    bool readVarint(uint64_t& value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint8_t byte;
+            if (!readByte(byte)) return false;
+            value |= uint64_t(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+        return false;
+    }
+
+    bool readSize(size_t& value)
+    {
+        uint64_t tmp;
+        if (!readVarint(tmp) || tmp > kMaxSize) return false;
+        value = tmp;
+        return true;
+    }
+
+    bool readInt(int& value)
+    {
+        uint64_t tmp;
+        if (!readVarint(tmp)) return false;
+        value = int(uint32_t(tmp >> 1) ^ -uint32_t(tmp & 1));
+        return true;
+    }
+
+    bool readDouble(double& value)
+    {
+        if (end_ - pos_ < 8) return false;
+        uint64_t bits = 0;
+        for (int index = 7; index >= 0; --index) bits = (bits << 8) | uint8_t(pos_[index]);
+        pos_ += 8;
+        ::memcpy(&value, &bits, sizeof(value));
+        return true;
+    }
+
+    bool readString(std::string& value)
+    {
+        uint64_t size;
+        if (!readVarint(size) || size > uint64_t(end_ - pos_)) return false;
+        value.assign(pos_, size);
+        pos_ += size;
+        return true;
+    }
+
+    size_t getRemaining() const { return end_ - pos_; }
+
+    const char* pos_;
+    const char* end_;
+};
+
+StatusDecoder::StatusDecoder() : haveKeyframe_(false), keyframeSequence_(0), keyframe_(), schemas_(), orphanCount_(0)
+{
+    ;
+}
+
+bool
+StatusDecoder::decode(const char* data, size_t size, XmlRpc::XmlRpcValue& status)
+{
+    if (!IsBinary(data, size)) return false;
+
+    Reader reader(data + sizeof(kSignature), size - sizeof(kSignature));
+    uint8_t flags;
+    uint64_t sequence, keyframeSequence, schemaCount;
+    if (!reader.readByte(flags) || !reader.readVarint(sequence) || !reader.readVarint(keyframeSequence) ||
+        !reader.readVarint(schemaCount))
+        return false;
+
+    for (uint64_t count = 0; count < schemaCount; ++count) {
+        size_t id;
+        SchemaKey key;
+        if (!reader.readSize(id) || !reader.readString(key.first) || !reader.readString(key.second)) return false;
+        if (id >= schemas_.size()) schemas_.resize(id + 1);
+        schemas_[id] = key;
+    }
+
+    if (flags & kKeyframe) {
+        XmlRpc::XmlRpcValue value;
+        if (!decodeValue(reader, value)) return false;
+        keyframe_ = value;
+        keyframeSequence_ = uint32_t(keyframeSequence);
+        haveKeyframe_ = true;
+        status = value;
+        return true;
+    }
+
+    if (!haveKeyframe_ || keyframeSequence_ != uint32_t(keyframeSequence)) {
+        ++orphanCount_;
+        return false;
+    }
+
+    XmlRpc::XmlRpcValue value(keyframe_);
+    if (!decodeValue(reader, value)) return false;
+    status = value;
+    return true;
+}
+
+bool
+StatusDecoder::decodeValue(Reader& reader, XmlRpc::XmlRpcValue& value)
+{
+    uint8_t tag;
+    if (!reader.readByte(tag)) return false;
+
+    switch (tag) {
+    case kInvalid: value.clear(); return true;
+    case kFalse: value = false; return true;
+    case kTrue: value = true; return true;
+
+    case kInt: {
+        int tmp;
+        if (!reader.readInt(tmp)) return false;
+        value = tmp;
+        return true;
+    }
+
+    case kDouble: {
+        double tmp;
+        if (!reader.readDouble(tmp)) return false;
+        value = tmp;
+        return true;
+    }
+
+    case kString: {
+        std::string tmp;
+        if (!reader.readString(tmp)) return false;
+        value = tmp;
+        return true;
+    }
+
+    case kDateTime: {
+        struct tm t;
+        ::memset(&t, 0, sizeof(t));
+        if (!reader.readInt(t.tm_year) || !reader.readInt(t.tm_mon) || !reader.readInt(t.tm_mday) ||
+            !reader.readInt(t.tm_hour) || !reader.readInt(t.tm_min) || !reader.readInt(t.tm_sec))
+            return false;
+        value = XmlRpc::XmlRpcValue(&t);
+        return true;
+    }
+
+    case kBase64: {
+        std::string tmp;
+        if (!reader.readString(tmp)) return false;
+        value = XmlRpc::XmlRpcValue(const_cast<char*>(tmp.data()), int(tmp.size()));
+        return true;
+    }
+
+    case kArray:
+    case kStatus: {
+        size_t id = 0, size;
+        if (tag == kStatus && (!reader.readSize(id) || id >= schemas_.size())) return false;
+        if (!reader.readSize(size) || size > reader.getRemaining()) return false;
+        XmlRpc::XmlRpcValue tmp;
+        tmp.setSize(int(size));
+        int index = 0;
+        if (tag == kStatus) {
+            if (size < StatusBase::kNumSlots) return false;
+            tmp[StatusBase::kVersion] = schemas_[id].first;
+            tmp[StatusBase::kClassName] = schemas_[id].second;
+            index = StatusBase::kName;
+        }
+        for (; index < int(size); ++index) {
+            if (!decodeValue(reader, tmp[index])) return false;
+        }
+        value = tmp;
+        return true;
+    }
+
+    case kStruct: {
+        size_t size;
+        if (!reader.readSize(size)) return false;
+        XmlRpc::XmlRpcValue tmp;
+        XmlRpc::XmlRpcValue::ValueStruct& members(tmp);
+        while (size--) {
+            std::string key;
+            if (!reader.readString(key) || !decodeValue(reader, members[key])) return false;
+        }
+        value = tmp;
+        return true;
+    }
+
+    case kDelta: return applyDelta(reader, value);
+
+    default: return false;
+    }
+}
+
+bool
+StatusDecoder::applyDelta(Reader& reader, XmlRpc::XmlRpcValue& value)
+{
+    size_t size, changeCount;
+    if (value.getType() != XmlRpc::XmlRpcValue::TypeArray || !reader.readSize(size) || !reader.readSize(changeCount))
+        return false;
+
+    XmlRpc::XmlRpcValue::ValueArray& slots(value);
+    slots.resize(size);
+    while (changeCount--) {
+        size_t index;
+        if (!reader.readSize(index) || index >= size || !decodeValue(reader, slots[index])) return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,178 @@
+#ifndef SIDECAR_IO_STATUSCODEC_H // -*- C++ -*-
+#define SIDECAR_IO_STATUSCODEC_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "XMLRPC/XmlRpcValue.h"
+
+namespace SideCar {
+namespace IO {
+
+/** Constants and helpers shared by StatusEncoder and StatusDecoder, which together implement a compact binary
+    alternative to the XML text normally used to carry status reports from a StatusEmitterBase object to its
+    collectors.
+
+    A binary frame starts with a four-byte signature that can never begin an XML document. It is either a
+    keyframe, which holds a complete status tree, or a delta, which holds only the array slots that changed
+    since the most recent keyframe. Deltas are always relative to a keyframe and never to another delta, so a
+    lost UDP datagram only costs the update it carried. A collector that has not yet seen the keyframe a delta
+    refers to ignores the delta until the next keyframe arrives.
+
+    Every status container found in the tree (an array whose first two slots hold the StatusBase version and
+    class name) is encoded with a small schema ID in place of those two strings. Schema definitions travel in
+    keyframes, and in any delta that uses a schema first seen after its keyframe.
+
+    Integers and lengths are written as little-endian base-128 varints, and doubles as 8 little-endian bytes.
+
+    Collectors announce that they understand binary frames by setting the GetEncodingKey() entry of their
+    Zeroconf TXT record to GetBinaryEncodingName(). Emitters continue to send XML to all other collectors.
+*/
+class StatusCodec {
+public:
+    /** Value tags found in a binary frame.
+     */
+    enum Tag {
+        kInvalid = 0,
+        kFalse,
+        kTrue,
+        kInt,
+        kDouble,
+        kString,
+        kDateTime,
+        kBase64,
+        kArray,
+        kStruct,
+        kStatus,
+        kDelta
+    };
+
+    /** Flag values for the frame header.
+     */
+    enum Flags { kKeyframe = 1 };
+
+    /** Obtain the Zeroconf TXT record key used by collectors to advertise the status encodings they accept.
+
+        \return key name
+    */
+    static const char* GetEncodingKey() { return "statusEncoding"; }
+
+    /** Obtain the TXT record value that indicates that a collector accepts binary status frames.
+
+        \return encoding name
+    */
+    static const char* GetBinaryEncodingName() { return "binary1"; }
+
+    /** Determine if a buffer holds a binary status frame.
+
+        \param data pointer to the first byte of the buffer
+
+        \param size number of bytes in the buffer
+
+        \return true if so
+    */
+    static bool IsBinary(const char* data, size_t size);
+
+protected:
+    static const char kSignature[4];
+};
+
+/** Encoder of binary status frames. Keeps a copy of the last keyframe it generated in order to determine which
+    slots to put into delta frames. Not thread-safe.
+*/
+class StatusEncoder : public StatusCodec {
+public:
+    /** Constructor.
+
+        \param keyframeInterval number of frames between keyframes (1 always generates keyframes)
+    */
+    StatusEncoder(int keyframeInterval = 10);
+
+    /** Make the next encode() call generate a keyframe. Used when a new collector appears so that it does not
+        have to wait for the next scheduled keyframe.
+    */
+    void forceKeyframe() { forceKeyframe_ = true; }
+
+    /** Encode a status tree.
+
+        \param status the status to encode
+
+        \param output buffer that receives the encoded frame
+
+        \return true if the frame is a keyframe
+    */
+    bool encode(const XmlRpc::XmlRpcValue& status, std::string& output);
+
+private:
+    void encodeValue(const XmlRpc::XmlRpcValue& value, std::string& output);
+
+    bool encodeDelta(const XmlRpc::XmlRpcValue& value, const XmlRpc::XmlRpcValue& base, std::string& output);
+
+    uint32_t getSchemaId(const std::string& version, const std::string& className);
+
+    using SchemaKey = std::pair<std::string, std::string>;
+    using SchemaIdMap = std::map<SchemaKey, uint32_t>;
+
+    int keyframeInterval_;
+    int framesSinceKeyframe_;
+    bool forceKeyframe_;
+    uint32_t sequence_;
+    uint32_t keyframeSequence_;
+    XmlRpc::XmlRpcValue keyframe_;
+    SchemaIdMap schemaIds_;
+    std::vector<SchemaKey> schemas_;
+    size_t keyframeSchemaCount_;
+};
+
+/** Decoder of binary status frames generated by a StatusEncoder object. There must be one decoder per emitter,
+    since each decoder holds on to the last keyframe it received. Not thread-safe.
+*/
+class StatusDecoder : public StatusCodec {
+public:
+    /** Constructor.
+     */
+    StatusDecoder();
+
+    /** Decode a binary frame.
+
+        \param data pointer to the first byte of the frame
+
+        \param size number of bytes in the frame
+
+        \param status storage for the decoded status tree
+
+        \return true if successful, false if the frame was malformed or refers to an unknown keyframe
+    */
+    bool decode(const char* data, size_t size, XmlRpc::XmlRpcValue& status);
+
+    /** Obtain the number of delta frames that were ignored because the keyframe they referred to never arrived.
+
+        \return frame count
+    */
+    size_t getOrphanCount() const { return orphanCount_; }
+
+private:
+    struct Reader;
+
+    bool decodeValue(Reader& reader, XmlRpc::XmlRpcValue& value);
+
+    bool applyDelta(Reader& reader, XmlRpc::XmlRpcValue& value);
+
+    using SchemaKey = std::pair<std::string, std::string>;
+
+    bool haveKeyframe_;
+    uint32_t keyframeSequence_;
+    XmlRpc::XmlRpcValue keyframe_;
+    std::vector<SchemaKey> schemas_;
+    size_t orphanCount_;
+};
+
+} // end namespace IO
+} // end namespace SideCar
+
+/** \file
+ */
+
+#endif
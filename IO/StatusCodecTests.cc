@@ -0,0 +1,97 @@
+#include <string>
+
+#include "StatusBase.h"
+#include "StatusCodec.h"
+#include "UnitTest/UnitTest.h"
+
+using namespace SideCar::IO;
+
+struct Test : public UnitTest::TestObj {
+    Test() : UnitTest::TestObj("StatusCodec") {}
+    void test();
+};
+
+static XmlRpc::XmlRpcValue
+makeStatus(int taskCount, int counter)
+{
+    XmlRpc::XmlRpcValue tasks;
+    tasks.setSize(taskCount);
+    for (int index = 0; index < taskCount; ++index) {
+        XmlRpc::XmlRpcValue& task(tasks[index]);
+        StatusBase::Make(task, StatusBase::kNumSlots + 4, "TaskStatus", "task");
+        task[StatusBase::kNumSlots] = index == 0 ? counter : index;
+        task[StatusBase::kNumSlots + 1] = 1.5 * index;
+        task[StatusBase::kNumSlots + 2] = index % 2 == 0;
+        task[StatusBase::kNumSlots + 3] = -index;
+    }
+
+    XmlRpc::XmlRpcValue status;
+    StatusBase::Make(status, StatusBase::kNumSlots + 2, "StreamStatus", "stream");
+    status[StatusBase::kNumSlots] = tasks;
+    status[StatusBase::kNumSlots + 1]["key"] = std::string("value");
+    return status;
+}
+
+void
+Test::test()
+{
+    assertFalse(StatusCodec::IsBinary("<value>", 7));
+
+    StatusEncoder encoder(3);
+    StatusDecoder decoder;
+    std::string frame;
+    XmlRpc::XmlRpcValue decoded;
+
+    // First frame is always a keyframe, and much smaller than the XML.
+    //
+    XmlRpc::XmlRpcValue status(makeStatus(20, 0));
+    assertTrue(encoder.encode(status, frame));
+    assertTrue(StatusCodec::IsBinary(frame.data(), frame.size()));
+    assertTrue(frame.size() * 4 < status.toXml().size());
+    assertTrue(decoder.decode(frame.data(), frame.size(), decoded));
+    assertTrue(decoded == status);
+
+    // Delta with a single change is tiny.
+    //
+    std::string keyframe(frame);
+    status = makeStatus(20, 1);
+    assertFalse(encoder.encode(status, frame));
+    assertTrue(frame.size() < 24);
+    assertTrue(decoder.decode(frame.data(), frame.size(), decoded));
+    assertTrue(decoded == status);
+
+    // Deltas are relative to the keyframe, so losing one does not matter. Growing and shrinking arrays works.
+    //
+    status = makeStatus(22, 2);
+    assertFalse(encoder.encode(status, frame));
+    assertTrue(decoder.decode(frame.data(), frame.size(), decoded));
+    assertTrue(decoded == status);
+
+    status = makeStatus(5, 3);
+    assertTrue(encoder.encode(status, frame));
+    assertTrue(decoder.decode(frame.data(), frame.size(), decoded));
+    assertTrue(decoded == status);
+
+    // A new decoder ignores deltas until it sees a keyframe.
+    //
+    StatusDecoder late;
+    status = makeStatus(5, 4);
+    assertFalse(encoder.encode(status, frame));
+    assertFalse(late.decode(frame.data(), frame.size(), decoded));
+    assertEqual(size_t(1), late.getOrphanCount());
+
+    encoder.forceKeyframe();
+    assertTrue(encoder.encode(status, frame));
+    assertTrue(late.decode(frame.data(), frame.size(), decoded));
+    assertTrue(decoded == status);
+
+    // A truncated frame is rejected.
+    //
+    assertFalse(decoder.decode(keyframe.data(), keyframe.size() - 1, decoded));
+}
+
+int
+main(int argc, const char* argv[])
+{
+    return Test().mainRun();
+}
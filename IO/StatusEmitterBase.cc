@@ -2,10 +2,12 @@
 #include <string>
 #include <vector>
 
+#include "ace/Guard_T.h"
 #include "ace/Message_Block.h"
 #include "ace/Reactor.h"
 #include "ace/SOCK_Dgram.h"
 #include "ace/Task.h"
+#include "ace/Thread_Mutex.h"
 
 #include "Logger/Log.h"
 #include "Utils/Format.h"
@@ -17,6 +19,7 @@
 #include "Zeroconf/ResolvedEntry.h"
 #include "Zeroconf/ServiceEntry.h"
 
+#include "StatusCodec.h"
 #include "StatusEmitterBase.h"
 #include "Task.h"
 
@@ -25,7 +28,8 @@ namespace IO {
 
 /** Internal class used by StatusEmitterBase to do most of the work. Handles discovery of StatusCollector
     entities via Zeroconf::Browser, and transmission of status information to the active StatusCollector
-    entities.
+    entities. Collectors that advertise support for binary status frames (see StatusCodec) receive the output of
+    a StatusEncoder; all others receive XML text. Each encoding is only generated if a collector needs it.
 */
 struct StatusEmitterBase::Emitter : public ACE_Task<ACE_MT_SYNCH> {
     using Super = ACE_Task<ACE_MT_SYNCH>;
@@ -35,12 +39,13 @@ public:
      */
     struct Destination {
         Destination(const Zeroconf::ServiceEntry::Ref& serviceEntry) :
-            serviceEntry_(serviceEntry), address_(), failures_(0)
+            serviceEntry_(serviceEntry), address_(), failures_(0), binary_(false)
         {
         }
         Zeroconf::ServiceEntry::Ref serviceEntry_;
         ACE_INET_Addr address_;
         int failures_;
+        bool binary_;
     };
 
     using DestinationVector = std::vector<Destination*>;
@@ -63,7 +68,7 @@ public:
     void emitStatus();
     void startTimer();
     void stopTimer();
-    void sendTo(Destination* destination) const;
+    void sendTo(Destination* destination);
 
     void foundSlot(const ServiceEntryVector& services);
     void lostSlot(const ServiceEntryVector& services);
@@ -79,7 +84,14 @@ public:
     DestinationVector destinations_;
     size_t destinationCount_;
     long timerId_;
-    ACE_Message_Block* current_;
+    ACE_Thread_Mutex pendingMutex_;
+    std::unique_ptr<XmlRpc::XmlRpcValue> pending_;
+    std::unique_ptr<XmlRpc::XmlRpcValue> current_;
+    std::string xml_;
+    std::string frame_;
+    bool xmlValid_;
+    bool frameValid_;
+    StatusEncoder encoder_;
 };
 
 } // namespace IO
@@ -98,7 +110,8 @@ StatusEmitterBase::Log()
 StatusEmitterBase::Emitter::Emitter(StatusEmitterBase& owner) :
     Super(), owner_(owner), socket_(ACE_INET_Addr(uint16_t(0))),
     browser_(Zeroconf::Browser::Make(Zeroconf::ACEMonitorFactory::Make(), owner.collectorType_)), destinations_(),
-    destinationCount_(0), timerId_(-1), current_(0)
+    destinationCount_(0), timerId_(-1), pendingMutex_(), pending_(), current_(), xml_(), frame_(), xmlValid_(false),
+    frameValid_(false), encoder_()
 {
     Logger::ProcLog log("StatusEmitterBase", Log());
 
@@ -188,14 +201,17 @@ StatusEmitterBase::Emitter::emitStatus()
 {
     static Logger::ProcLog log("emitStatus", Log());
 
-    // Generate a new XML status and post it to our emitter thread.
+    // Generate a new status and hand it to our emitter thread, which performs any encoding. If the emitter
+    // thread has not yet picked up the previous status, it will just see this newer one.
     //
-    XmlRpc::XmlRpcValue status;
-    owner_.fillStatus(status);
-    std::string buffer(status.toXml());
+    std::unique_ptr<XmlRpc::XmlRpcValue> status(new XmlRpc::XmlRpcValue);
+    owner_.fillStatus(*status);
+    {
+        ACE_Guard<ACE_Thread_Mutex> lock(pendingMutex_);
+        pending_.swap(status);
+    }
 
-    ACE_Message_Block* data = new ACE_Message_Block(buffer.size(), ACE_Message_Block::MB_DATA);
-    data->copy(buffer.c_str(), buffer.size());
+    ACE_Message_Block* data = new ACE_Message_Block(0, ACE_Message_Block::MB_DATA);
     if (putq(data) == -1) {
         LOGERROR << "failed to post status update to emitter queue" << std::endl;
         data->release();
@@ -233,20 +249,28 @@ StatusEmitterBase::Emitter::svc()
     //
     while (getq(data) != -1) {
         switch (data->msg_type()) {
-        case ACE_Message_Block::MB_DATA:
-
-            // Post status update to the all Destination objects.
+        case ACE_Message_Block::MB_DATA: {
+            // Take the latest status. Encodings are generated on demand by sendTo().
             //
-            if (current_) current_->release();
-            current_ = data;
+            std::unique_ptr<XmlRpc::XmlRpcValue> status;
+            {
+                ACE_Guard<ACE_Thread_Mutex> lock(pendingMutex_);
+                status.swap(pending_);
+            }
 
-            // Emit the current status to all active destinations.
-            //
-            std::for_each(destinations_.begin(), destinations_.end(), [this](auto d) { sendTo(d); });
+            if (status) {
+                current_.swap(status);
+                xmlValid_ = false;
+                frameValid_ = false;
 
-            // NOTE: don't call data->release() since we are caching it in current_.
-            //
+                // Emit the current status to all active destinations.
+                //
+                std::for_each(destinations_.begin(), destinations_.end(), [this](auto d) { sendTo(d); });
+            }
+
+            data->release();
             break;
+        }
 
         case ACE_Message_Block::MB_START:
 
@@ -265,7 +289,20 @@ StatusEmitterBase::Emitter::svc()
 
             if (dest) {
                 destinations_.push_back(dest);
-                if (current_) sendTo(dest);
+                if (dest->binary_) {
+                    // A new binary collector needs a keyframe. Since deltas always refer to the latest keyframe,
+                    // all other binary collectors must see it too.
+                    //
+                    encoder_.forceKeyframe();
+                    if (current_) {
+                        frameValid_ = false;
+                        for (auto d : destinations_) {
+                            if (d->binary_) sendTo(d);
+                        }
+                    }
+                } else if (current_) {
+                    sendTo(dest);
+                }
             }
 
             data->release();
@@ -297,7 +334,7 @@ StatusEmitterBase::Emitter::svc()
 }
 
 void
-StatusEmitterBase::Emitter::sendTo(Destination* destination) const
+StatusEmitterBase::Emitter::sendTo(Destination* destination)
 {
     static Logger::ProcLog log("sendTo", Log());
     Zeroconf::ServiceEntry::Ref serviceEntry = destination->serviceEntry_;
@@ -309,13 +346,27 @@ StatusEmitterBase::Emitter::sendTo(Destination* destination) const
     //
     if (destination->failures_ > 10) return;
 
+    // Generate the encoding that the destination wants if we have not already done so.
+    //
+    const std::string* buffer = &xml_;
+    if (destination->binary_) {
+        if (!frameValid_) {
+            encoder_.encode(*current_, frame_);
+            frameValid_ = true;
+        }
+        buffer = &frame_;
+    } else if (!xmlValid_) {
+        xml_ = current_->toXml();
+        xmlValid_ = true;
+    }
+
     // Attempt to send to the StatusCollector found at the Destination object.
     //
-    ssize_t rc = socket_.send(current_->rd_ptr(), current_->size() - 1, destination->address_, 0);
-    if (rc != ssize_t(current_->size() - 1)) {
+    ssize_t rc = socket_.send(buffer->data(), buffer->size(), destination->address_, 0);
+    if (rc != ssize_t(buffer->size())) {
         ++destination->failures_;
         LOGERROR << serviceEntry->getName() << " failed send to " << Utils::INETAddrToString(destination->address_)
-                 << " - buffer size: " << current_->size() << " - " << Utils::showErrno() << std::endl;
+                 << " - buffer size: " << buffer->size() << " - " << Utils::showErrno() << std::endl;
     } else {
         destination->failures_ = 0;
     }
@@ -359,8 +410,14 @@ StatusEmitterBase::Emitter::resolvedSlot(const Zeroconf::ServiceEntry::Ref& serv
     // Create a new Destination object to represent the location of the remote StatusCollector. Encapsulate it
     // in an ACE_Message_Block and post it to the emitter thread.
     //
+    // See if the collector accepts binary status frames.
+    //
+    std::string encoding;
     Destination* dest = new Destination(service);
     dest->address_ = address;
+    dest->binary_ = resolvedEntry.hasTextEntry(StatusCodec::GetEncodingKey(), &encoding) &&
+                    encoding == StatusCodec::GetBinaryEncodingName();
+    LOGDEBUG << "binary: " << dest->binary_ << std::endl;
     ACE_Message_Block* data =
         new ACE_Message_Block(sizeof(*dest), ACE_Message_Block::MB_START, 0, reinterpret_cast<char*>(dest));
     if (putq(data) == -1) {
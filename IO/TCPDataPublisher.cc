@@ -70,7 +70,8 @@ TCPDataPublisher::openAndInit(const std::string& key, const std::string& service
 
     std::ostringstream os;
     os << "Port: " << port;
-    setConnectionInfo(os.str());
+    portInfo_ = os.str();
+    setConnectionInfo(portInfo_);
 
     return true;
 }
@@ -81,6 +82,7 @@ TCPDataPublisher::close(u_long flags)
     Logger::ProcLog log("close", Log());
     LOGINFO << "flags: " << flags << std::endl;
 
+    portInfo_ = "";
     setConnectionInfo("");
     writer_->close(flags);
     return Super::close(flags);
@@ -98,6 +100,23 @@ TCPDataPublisher::getConnectionCount() const
     return writer_->getConnectionCount();
 }
 
+void
+TCPDataPublisher::setClientPolicy(SendQueueBase::Policy policy, size_t depth)
+{
+    writer_->setClientPolicy(policy, depth);
+}
+
+void
+TCPDataPublisher::fillStatus(StatusBase& status)
+{
+    if (!portInfo_.empty()) {
+        std::string clients(writer_->getClientSummary());
+        setConnectionInfo(clients.empty() ? portInfo_ : portInfo_ + ' ' + clients);
+    }
+
+    Super::fillStatus(status);
+}
+
 void
 TCPDataPublisher::connectionCountChanged(size_t count)
 {
@@ -3,6 +3,7 @@
 
 #include "IO/DataPublisher.h"
 #include "IO/Module.h"
+#include "IO/SendQueue.h"
 #include "IO/ZeroconfRegistry.h"
 
 namespace Logger {
@@ -59,6 +60,20 @@ public:
 
     size_t getConnectionCount() const;
 
+    /** Set what to do when a subscriber falls behind. Must be called before openAndInit().
+
+        \param policy what to do when a subscriber's queue is full
+
+        \param depth most messages to queue for a subscriber
+    */
+    void setClientPolicy(SendQueueBase::Policy policy, size_t depth);
+
+    /** Override of Task method. Adds the backlog of each subscriber to the connection info.
+
+        \param status container to update
+    */
+    void fillStatus(StatusBase& status);
+
 protected:
     /** Constructor.
      */
@@ -75,6 +90,7 @@ private:
 
     using ServerSocketWriterTaskRef = boost::shared_ptr<ServerSocketWriterTask>;
     ServerSocketWriterTaskRef writer_;
+    std::string portInfo_;
 };
 
 using TCPDataPublisherModule = TModule<TCPDataPublisher>;
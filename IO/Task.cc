@@ -8,6 +8,7 @@
 #include "ace/Reactor.h"
 
 #include "Logger/Log.h"
+#include "XMLRPC/XmlRpcValue.h"
 
 #include "MessageManager.h"
 #include "ParametersChangeRequest.h"
@@ -36,7 +37,7 @@ Task::Log()
 }
 
 Task::Task(bool usingData) :
-    Super(), stream_(), taskName_(""), error_(""), taskIndex_(0), inputs_(), inputStats_(), outputs_(),
+    Super(), stream_(), taskName_(""), error_(""), taskIndex_(0), inputs_(), inputStats_(), traceRecorder_(), outputs_(),
     parameterMap_(), parameterVector_(),
     processingStateParameter_(ProcessingStateParameter::Make("processingState", "Processing State",
                                                              ProcessingStateParameter::None())),
@@ -415,6 +416,7 @@ Task::put(ACE_Message_Block* data, ACE_Time_Value* timeout)
         size_t channelIndex = data->msg_priority();
         Header::Ref msg = mgr.getNative();
         updateInputStats(channelIndex, msg->getSize(), msg->getMessageSequenceNumber());
+        traceRecorder_.add(*msg);
 
         // Attempt to deliver the message to the task. For threaded tasks, this will insert the message into a
         // work queue for the thread to process.
@@ -670,6 +672,13 @@ Task::fillStatus(StatusBase& status)
     status.setSlot(TaskStatus::kHasParameters, parameterVector_.size() > taskParameterCount_);
     status.setSlot(TaskStatus::kUsingData, usingData_);
 
+    // Hand off any pipeline trace spans recorded since the last update.
+    //
+    XmlRpc::XmlRpcValue traceSpans;
+    int droppedSpans = traceRecorder_.drain(traceSpans);
+    if (droppedSpans) { LOGWARNING << taskName_ << " dropped " << droppedSpans << " trace spans" << std::endl; }
+    status.setSlot(TaskStatus::kTraceSpans, traceSpans);
+
     // Calculate message counts and rates from the Stats object associated with each input.
     //
     size_t messageCount = 0;
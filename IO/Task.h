@@ -13,6 +13,7 @@
 #include "IO/ProcessingState.h"
 #include "IO/Stats.h"
 #include "IO/TaskStatus.h"
+#include "IO/TraceRecorder.h"
 #include "Messages/Header.h"
 
 #include "Parameter/Parameter.h"
@@ -642,6 +643,7 @@ private:
 
     ChannelVector inputs_; ///< Collection of channels defined for inputs
     std::vector<Stats> inputStats_;
+    TraceRecorder traceRecorder_; ///< Spans of traced messages received
     ChannelVector outputs_;     ///< Collection of channels defined for outputs
     ParameterMap parameterMap_; ///< Registered runtime parameters
     ParameterVector parameterVector_;
@@ -25,6 +25,7 @@ public:
         kPendingQueueCount,
         kHasParameters,
         kUsingData,
+        kTraceSpans,
         kNumSlots
     };
 
@@ -61,6 +62,13 @@ public:
     bool hasParameters() const { return getSlot(kHasParameters); }
 
     bool isUsingData() const { return getSlot(kUsingData); }
+
+    /** Obtain the pipeline trace spans recorded by the task since the last status update. See
+        IO::TraceRecorder for the layout of each entry.
+
+        \return XML-RPC array of spans
+    */
+    const XmlRpc::XmlRpcValue& getTraceSpans() const { return getSlot(kTraceSpans); }
 };
 
 } // end namespace IO
@@ -0,0 +1,50 @@
+#include "ace/Guard_T.h"
+
+#include "XMLRPC/XmlRpcValue.h"
+
+#include "TraceRecorder.h"
+
+using namespace SideCar;
+using namespace SideCar::IO;
+
+void
+TraceRecorder::addSpan(uint32_t traceId, const Time::TimeStamp& origin)
+{
+    Span span;
+    span.traceId = traceId;
+    span.origin = origin;
+    span.arrival = Time::TimeStamp::Now();
+
+    ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
+    if (spans_.size() < capacity_) {
+        spans_.push_back(span);
+    } else {
+        ++dropped_;
+    }
+}
+
+int
+TraceRecorder::drain(XmlRpc::XmlRpcValue& value)
+{
+    std::vector<Span> spans;
+    int dropped;
+    {
+        ACE_Guard<ACE_Thread_Mutex> guard(mutex_);
+        spans.swap(spans_);
+        dropped = dropped_;
+        dropped_ = 0;
+    }
+
+    value.setSize(spans.size());
+    for (size_t index = 0; index < spans.size(); ++index) {
+        const Span& span(spans[index]);
+        XmlRpc::XmlRpcValue entry;
+        entry.setSize(kNumSpanSlots);
+        entry[kTraceId] = int(span.traceId);
+        entry[kOriginTime] = span.origin.asDouble();
+        entry[kArrivalTime] = span.arrival.asDouble();
+        value[index] = entry;
+    }
+
+    return dropped;
+}
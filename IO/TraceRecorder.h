@@ -0,0 +1,79 @@
+#ifndef SIDECAR_IO_TRACERECORDER_H // -*- C++ -*-
+#define SIDECAR_IO_TRACERECORDER_H
+
+#include <vector>
+
+#include "ace/Thread_Mutex.h"
+
+#include "Messages/Header.h"
+#include "Time/TimeStamp.h"
+
+namespace XmlRpc {
+class XmlRpcValue;
+}
+
+namespace SideCar {
+namespace IO {
+
+/** Collection of pipeline trace spans seen by a Task. Whenever a Task receives a message that belongs to a
+    sampled trace (see Messages::Header::isTraced()), it records a span that holds the trace ID, the trace
+    origin time, and the time of arrival at the task. Since the trace ID and origin travel with the message
+    across TCP and multicast hops, spans from all of the tasks that saw a traced message may be joined by trace
+    ID to show where time went between VME arrival and display.
+
+    Spans are held in a fixed-size buffer until drained by a status update (see Task::fillStatus()). If the
+    buffer fills before a drain, the newest spans are dropped and counted. Traced messages are rare (one in N),
+    so a mutex protects the buffer between the processing thread and the status emitter thread.
+*/
+class TraceRecorder {
+public:
+    /** Indices of the values in an XML-RPC span array created by drain().
+     */
+    enum { kTraceId = 0, kOriginTime, kArrivalTime, kNumSpanSlots };
+
+    /** Constructor.
+
+        \param capacity maximum number of spans held between drains
+    */
+    TraceRecorder(size_t capacity = 128) : capacity_(capacity), spans_(), dropped_(0), mutex_() {}
+
+    /** Record the arrival of a traced message. Does nothing if the message is not traced.
+
+        \param msg the message that arrived
+    */
+    void add(const Messages::Header& msg)
+    {
+        if (msg.isTraced()) addSpan(msg.getTraceId(), msg.getTraceOriginTimeStamp());
+    }
+
+    /** Move all held spans into an XML-RPC array. Each entry is itself an array of kNumSpanSlots values with
+        times expressed as seconds since the epoch.
+
+        \param value XML-RPC container to fill
+
+        \return number of spans dropped since the last drain
+    */
+    int drain(XmlRpc::XmlRpcValue& value);
+
+private:
+    struct Span {
+        uint32_t traceId;
+        Time::TimeStamp origin;
+        Time::TimeStamp arrival;
+    };
+
+    void addSpan(uint32_t traceId, const Time::TimeStamp& origin);
+
+    size_t capacity_;
+    std::vector<Span> spans_;
+    int dropped_;
+    ACE_Thread_Mutex mutex_;
+};
+
+} // end namespace IO
+} // end namespace SideCar
+
+/** \file
+ */
+
+#endif
@@ -91,6 +91,11 @@ UDPSocketReaderTask::close(u_long flags)
 {
     Logger::ProcLog log("close", Log());
     LOGINFO << flags << std::endl;
+
+    const DatagramReassembler::Stats& stats(reader_.getFragmentStats());
+    LOGINFO << "fragments: " << stats.fragments << " reassembled: " << stats.reassembled
+            << " timeouts: " << stats.timeouts + stats.evicted << std::endl;
+
     int rc = reactor()->remove_handler(this, ACE_Event_Handler::READ_MASK);
     LOGDEBUG << "remove_handler: " << rc << std::endl;
     return 0;
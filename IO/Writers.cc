@@ -94,6 +94,16 @@ Writer::Log()
     return log_;
 }
 
+void
+Writer::setMaxDatagramSize(size_t maxDatagramSize)
+{
+    if (!fragmenter_) {
+        fragmenter_.reset(new DatagramFragmenter(maxDatagramSize));
+    } else {
+        fragmenter_->setMaxDatagramSize(maxDatagramSize);
+    }
+}
+
 bool
 Writer::write(const MessageManager& mm)
 {
@@ -108,6 +118,17 @@ Writer::writeEncoded(size_t messageCount, ACE_Message_Block* data)
     IOVVector iovs;
 
     size_t size = iovs.push_back(data);
+    if (fragmenter_ && fragmenter_->needsFragments(size)) {
+        bool ok = writeFragments(iovs, size);
+        while (data) {
+            ACE_Message_Block* next = data->next();
+            data->release();
+            data = next;
+        }
+
+        return ok;
+    }
+
     ssize_t remaining = size;
     LOGTIN << "sending " << remaining << " bytes" << std::endl;
 
@@ -148,3 +169,43 @@ Writer::writeEncoded(size_t messageCount, ACE_Message_Block* data)
     LOGTOUT << "FT"[remaining == 0] << std::endl;
     return remaining == 0;
 }
+
+bool
+Writer::writeFragments(const IOVVector& iovs, size_t size)
+{
+    static Logger::ProcLog log("writeFragments", Log());
+
+    std::vector<DatagramFragmenter::Fragment> fragments;
+    if (!fragmenter_->split(&iovs[0], iovs.size(), size, fragments)) return false;
+    LOGDEBUG << "sending " << size << " bytes in " << fragments.size() << " fragments" << std::endl;
+
+    IOVVector datagram;
+    for (const auto& fragment : fragments) {
+        datagram.clear();
+        datagram.emplace_back(fragment.header, size_t(DatagramFragmenter::kHeaderSize));
+        for (const auto& iov : fragment.iovs) datagram.emplace_back(iov.iov_base, iov.iov_len);
+
+        // Each fragment must go out in one send, so it cannot use more iovec entries than the device takes.
+        //
+        if (datagram.size() > ACE_IOV_MAX) {
+            LOGERROR << "fragment needs " << datagram.size() << " iovec entries" << std::endl;
+            return false;
+        }
+
+        ssize_t rc;
+        do {
+            errno = 0;
+            rc = writeToDevice(&datagram[0], datagram.size());
+        } while (rc == -1 && errno == EAGAIN && !isClosing());
+
+        if (rc == -1) {
+            LOGERROR << "writeToDevice failed - " << errno << " - " << ::strerror(errno) << std::endl;
+            lastError_ = errno;
+            return false;
+        }
+
+        if (isClosing()) return false;
+    }
+
+    return true;
+}
@@ -10,8 +10,11 @@
 #include "ace/SOCK_Dgram_Mcast.h"
 #include "ace/SOCK_Stream.h"
 
+#include "boost/scoped_ptr.hpp"
 #include "boost/shared_ptr.hpp"
 
+#include "IO/DatagramFragments.h"
+
 namespace Logger {
 class Log;
 }
@@ -166,6 +169,12 @@ public:
     */
     void setRemoteAddress(const ACE_INET_Addr& remoteAddress) { remoteAddress_ = remoteAddress; }
 
+    /** Obtain the address of the remote host written to.
+
+        \return IP address of remote host
+    */
+    const ACE_INET_Addr& getRemoteAddress() const { return remoteAddress_; }
+
 protected:
     /** Send data to the device.
 
@@ -237,7 +246,7 @@ public:
 
     /** Constructor.
      */
-    Writer() : closing_(0), lastError_(0) {}
+    Writer() : closing_(0), lastError_(0), fragmenter_() {}
 
     /** Destructor.
      */
@@ -277,6 +286,19 @@ public:
 
     int getLastError() const { return lastError_; }
 
+    /** Split messages too large for one datagram into fragments that a DatagramReader puts back together. Only
+        useful for datagram devices; writers of other devices never fragment.
+
+        \param maxDatagramSize largest datagram to send
+    */
+    void setMaxDatagramSize(size_t maxDatagramSize);
+
+    /** Obtain the fragmenter used for large messages.
+
+        \return fragmenter, or NULL if the writer does not fragment
+    */
+    DatagramFragmenter* getFragmenter() const { return fragmenter_.get(); }
+
 protected:
     /** Prototype of method that writes data to a device. The data to write exists as an array of pointer/length
         pairs.
@@ -290,8 +312,19 @@ protected:
     virtual ssize_t writeToDevice(const iovec* iov, int count) = 0;
 
 private:
+    /** Send a message as a series of fragment datagrams.
+
+        \param iovs the message data
+
+        \param size number of bytes in the message
+
+        \return true if successful, false otherwise
+    */
+    bool writeFragments(const IOVVector& iovs, size_t size);
+
     volatile int closing_;
     int lastError_;
+    boost::scoped_ptr<DatagramFragmenter> fragmenter_;
 };
 
 /** Abstract base class for a data writer. The template argument _D is a device writer class that provides a
@@ -364,7 +397,7 @@ public:
     TCPSocketWriter() : Super() {}
 };
 
-/** Writer that sends raw data to a UDP socket device.
+/** Writer that sends raw data to a UDP socket device. Messages too large for one datagram go out as fragments.
  */
 class UDPSocketWriter : public TWriter<WriterDevices::UDPSocket> {
 public:
@@ -374,11 +407,12 @@ public:
 
     /** Constructor for new writer.
      */
-    UDPSocketWriter() : Super() {}
+    UDPSocketWriter() : Super() { setMaxDatagramSize(DatagramFragmenter::kDefaultMaxDatagramSize); }
 };
 
-/** Writer that sends raw data to a multicast UDP socket device.
- */
+/** Writer that sends raw data to a multicast UDP socket device. Messages too large for one datagram go out as
+    fragments.
+*/
 class MulticastSocketWriter : public TWriter<WriterDevices::MulticastSocket> {
 public:
     /** Class type synonym for our parent class
@@ -387,7 +421,7 @@ public:
 
     /** Constructor for new writer.
      */
-    MulticastSocketWriter() : Super() {}
+    MulticastSocketWriter() : Super() { setMaxDatagramSize(DatagramFragmenter::kDefaultMaxDatagramSize); }
 };
 
 } // end namespace IO
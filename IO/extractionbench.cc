@@ -0,0 +1,115 @@
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "ace/CDR_Stream.h"
+
+#include "Messages/Extraction.h"
+#include "Time/TimeStamp.h"
+#include "Utils/CmdLineArgs.h"
+#include "Utils/IO.h"
+
+using namespace SideCar;
+
+const std::string about = "Compare the cost of encoding and decoding Extractions messages whose attributes are "
+                          "stored as XML (the old wire format) and as binary values.";
+
+const Utils::CmdLineArgs::OptionDef opts[] = {
+    {'e', "extractions", "number of extractions per message (default 1000)", "N"},
+    {'n', "iterations", "number of encode/decode cycles to time (default 100)", "N"},
+};
+
+/** Build a message with attributes like those added by an extractor: a few numeric values and a string.
+ */
+static Messages::Extractions::Ref
+MakeMessage(int count)
+{
+    static const Messages::Attributes::Key snr = Messages::Attributes::Intern("snr");
+    static const Messages::Attributes::Key hits = Messages::Attributes::Intern("hits");
+    static const Messages::Attributes::Key peak = Messages::Attributes::Intern("peak");
+    static const Messages::Attributes::Key source = Messages::Attributes::Intern("source");
+
+    Messages::Extractions::Ref msg(Messages::Extractions::Make("bench", Messages::Header::Ref()));
+    msg->reserve(count);
+    for (int index = 0; index < count; ++index) {
+        Messages::Extraction extraction(Time::TimeStamp(index, 0), 10.0 + index * 0.01, index * 0.001, 0.0);
+        extraction.addAttribute(snr, 12.5 + index);
+        extraction.addAttribute(hits, index % 7);
+        extraction.addAttribute(peak, true);
+        extraction.addAttribute(source, "cfar");
+        msg->push_back(extraction);
+    }
+
+    return msg;
+}
+
+/** Write a message the way software prior to the binary attribute encoding did, with each Attributes container
+    written as an XML-RPC struct in a CDR string.
+*/
+static void
+WriteLegacy(const Messages::Extractions::Ref& msg, ACE_OutputCDR& cdr)
+{
+    msg->Header::write(cdr);
+    cdr << uint32_t(msg->size());
+    for (size_t index = 0; index < msg->size(); ++index) {
+        const Messages::Extraction& extraction(msg[index]);
+        cdr << Time::TimeStamp(index, 0);
+        cdr << extraction.getRange();
+        cdr << extraction.getAzimuth();
+        cdr << extraction.getElevation();
+        cdr << extraction.getX();
+        cdr << extraction.getY();
+        cdr << extraction.getAttributes().getXmlRpcValue().toXml();
+    }
+}
+
+static void
+Report(const char* label, double elapsed, size_t bytes, int iterations)
+{
+    std::cout << std::setw(10) << label << std::fixed << std::setprecision(1) << std::setw(10)
+              << elapsed * 1.0E6 / iterations << " usecs/message " << std::setw(10) << double(bytes) / iterations
+              << " bytes/message\n";
+}
+
+int
+main(int argc, char** argv)
+{
+    Utils::CmdLineArgs cla(argc, argv, about, opts, sizeof(opts), 0, 0);
+
+    int count = 1000;
+    if (cla.hasOpt("extractions")) cla.opt("extractions")[0] >> count;
+
+    int iterations = 100;
+    if (cla.hasOpt("iterations")) cla.opt("iterations")[0] >> iterations;
+
+    Messages::Extractions::Ref msg(MakeMessage(count));
+
+    // XML path: attributes built into XML-RPC values, written as text, and parsed back when loaded.
+    //
+    size_t bytes = 0;
+    Time::TimeStamp start(Time::TimeStamp::Now());
+    for (int index = 0; index < iterations; ++index) {
+        ACE_OutputCDR output;
+        WriteLegacy(msg, output);
+        bytes += output.total_length();
+        ACE_InputCDR input(output);
+        Messages::Extractions::Ref decoded(Messages::Extractions::Make(input));
+    }
+    Report("xml", (Time::TimeStamp::Now() - start).asDouble(), bytes, iterations);
+
+    // Binary path: attributes written and read as typed values.
+    //
+    bytes = 0;
+    start = Time::TimeStamp::Now();
+    for (int index = 0; index < iterations; ++index) {
+        ACE_OutputCDR output;
+        msg->write(output);
+        bytes += output.total_length();
+        ACE_InputCDR input(output);
+        Messages::Extractions::Ref decoded(Messages::Extractions::Make(input));
+    }
+    Report("binary", (Time::TimeStamp::Now() - start).asDouble(), bytes, iterations);
+
+    return 0;
+}
@@ -0,0 +1,178 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "ace/FILE_Connector.h"
+
+#include "IO/MessageManager.h"
+#include "IO/Readers.h"
+#include "Messages/BinaryVideo.h"
+#include "Messages/SegmentLabeller.h"
+#include "Messages/Video.h"
+#include "Time/TimeStamp.h"
+#include "Utils/BitVector.h"
+#include "Utils/CmdLineArgs.h"
+#include "Utils/Utils.h"
+
+using namespace SideCar;
+
+const std::string about = "Time the binary video to segments to blobs pipeline on a synthetic clutter scene, or on "
+                          "the Video or BinaryVideo messages of a recorded file.";
+
+const Utils::CmdLineArgs::OptionDef opts[] = {
+    {'b', "blobs", "number of synthetic clutter blobs (default 2000)", "N"},
+    {'f', "file", "recorded file to use instead of a synthetic scene", "PATH"},
+    {'g', "gates", "gates per synthetic PRI (default 4096)", "N"},
+    {'n', "iterations", "number of passes over the scene (default 5)", "N"},
+    {'p', "pris", "PRIs in the synthetic scan (default 4096)", "N"},
+    {'r', "rings", "number of synthetic range rings (default 2)", "N"},
+    {'s', "speckle", "synthetic speckle probability in percent (default 1)", "N"},
+    {'t', "threshold", "threshold for recorded Video messages (default 5000)", "N"},
+};
+
+using Scene = std::vector<std::vector<char>>;
+
+/** Build one scan of thresholded video: scattered single-gate speckle, elliptical blobs of various sizes, and a
+    few rings at constant range.
+*/
+static void
+MakeScene(Scene& scene, int pris, int gates, int blobs, int rings, int speckle)
+{
+    ::srand(1234);
+    scene.assign(pris, std::vector<char>(gates, 0));
+    for (auto& pri : scene) {
+        for (auto& gate : pri) gate = (::rand() % 1000) < speckle * 10;
+    }
+
+    for (int index = 0; index < blobs; ++index) {
+        int az = ::rand() % pris;
+        int range = ::rand() % gates;
+        int azRadius = 1 + ::rand() % 12;
+        int rangeRadius = 1 + ::rand() % 20;
+        for (int dAz = -azRadius; dAz <= azRadius; ++dAz) {
+            std::vector<char>& pri(scene[(az + dAz + pris) % pris]);
+            double fraction = 1.0 - double(dAz * dAz) / (azRadius * azRadius);
+            int span = int(rangeRadius * fraction);
+            int last = std::min(gates - 1, range + span);
+            for (int gate = std::max(0, range - span); gate <= last; ++gate) pri[gate] = 1;
+        }
+    }
+
+    for (int index = 0; index < rings; ++index) {
+        int range = ::rand() % gates;
+        for (auto& pri : scene) pri[range] = 1;
+    }
+}
+
+/** Load the PRIs of a recorded file, thresholding Video messages and taking BinaryVideo messages as-is.
+ */
+static bool
+LoadScene(Scene& scene, const std::string& path, int threshold)
+{
+    IO::FileReader::Ref reader(IO::FileReader::Make());
+    ACE_FILE_Addr address(path.c_str());
+    ACE_FILE_Connector connector;
+    if (connector.connect(reader->getDevice(), address, 0, ACE_Addr::sap_any, 0, O_RDONLY, ACE_DEFAULT_FILE_PERMS) ==
+        -1) {
+        std::cerr << "failed to open file " << path << std::endl;
+        return false;
+    }
+
+    while (reader->fetchInput()) {
+        if (!reader->isMessageAvailable()) continue;
+        IO::MessageManager mgr(reader->getMessage());
+        Messages::Header::Ref msg(mgr.getNative());
+        if (!msg) continue;
+        if (msg->getMetaTypeInfo().getKey() == Messages::MetaTypeInfo::Value::kVideo) {
+            Messages::Video::Ref video(mgr.getNative<Messages::Video>());
+            scene.emplace_back(video->size());
+            for (size_t gate = 0; gate < video->size(); ++gate) scene.back()[gate] = video[gate] >= threshold;
+        } else if (msg->getMetaTypeInfo().getKey() == Messages::MetaTypeInfo::Value::kBinaryVideo) {
+            Messages::BinaryVideo::Ref video(mgr.getNative<Messages::BinaryVideo>());
+            scene.push_back(video->getData());
+        }
+    }
+
+    return !scene.empty();
+}
+
+static void
+Report(const char* label, double elapsed, size_t pris, int iterations)
+{
+    std::cout << std::setw(10) << label << std::fixed << std::setprecision(3) << std::setw(10)
+              << elapsed * 1.0E6 / (double(pris) * iterations) << " usecs/PRI\n";
+}
+
+int
+main(int argc, char** argv)
+{
+    Utils::CmdLineArgs cla(argc, argv, about, opts, sizeof(opts), 0, 0);
+
+    int iterations = 5;
+    if (cla.hasOpt("iterations")) cla.opt("iterations")[0] >> iterations;
+
+    Scene scene;
+    if (cla.hasOpt("file")) {
+        int threshold = 5000;
+        if (cla.hasOpt("threshold")) cla.opt("threshold")[0] >> threshold;
+        if (!LoadScene(scene, cla.opt("file")[0], threshold)) return 1;
+    } else {
+        int pris = 4096, gates = 4096, blobs = 2000, rings = 2, speckle = 1;
+        if (cla.hasOpt("pris")) cla.opt("pris")[0] >> pris;
+        if (cla.hasOpt("gates")) cla.opt("gates")[0] >> gates;
+        if (cla.hasOpt("blobs")) cla.opt("blobs")[0] >> blobs;
+        if (cla.hasOpt("rings")) cla.opt("rings")[0] >> rings;
+        if (cla.hasOpt("speckle")) cla.opt("speckle")[0] >> speckle;
+        MakeScene(scene, pris, gates, blobs, rings, speckle);
+    }
+
+    // Stage 1: pack the gates and run-length encode them. Keep the results for the second stage.
+    //
+    std::vector<Messages::SegmentList> segments(scene.size());
+    Utils::BitVector bits;
+    size_t segmentCount = 0;
+    Time::TimeStamp start(Time::TimeStamp::Now());
+    for (int pass = 0; pass < iterations; ++pass) {
+        segmentCount = 0;
+        for (size_t index = 0; index < scene.size(); ++index) {
+            const std::vector<char>& pri(scene[index]);
+            bits.assign(pri.data(), pri.data() + pri.size());
+            segments[index] = Messages::SegmentList();
+            segments[index].merge(index, bits);
+            segmentCount += segments[index].size();
+        }
+    }
+    Report("encode", (Time::TimeStamp::Now() - start).asDouble(), scene.size(), iterations);
+
+    // Stage 2: label the connected components, limiting blobs to half of the scan.
+    //
+    Messages::SegmentLabeller labeller(scene.size() / 2);
+    Messages::SegmentLabeller::BlobVector done;
+    size_t blobCount = 0;
+    size_t maxOpen = 0;
+    start = Time::TimeStamp::Now();
+    for (int pass = 0; pass < iterations; ++pass) {
+        blobCount = 0;
+        for (const auto& pri : segments) {
+            labeller.add(pri, done);
+            if (labeller.getOpenCount() > maxOpen) maxOpen = labeller.getOpenCount();
+            blobCount += done.size();
+            for (auto list : done) delete list;
+            done.clear();
+        }
+
+        labeller.flush(done);
+        blobCount += done.size();
+        for (auto list : done) delete list;
+        done.clear();
+    }
+    Report("label", (Time::TimeStamp::Now() - start).asDouble(), scene.size(), iterations);
+
+    std::cout << "PRIs: " << scene.size() << " segments: " << segmentCount << " blobs: " << blobCount
+              << " max open blobs: " << maxOpen << '\n';
+
+    return 0;
+}
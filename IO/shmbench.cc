@@ -0,0 +1,240 @@
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+#include "IO/SharedMemoryRing.h"
+#include "Utils/CmdLineArgs.h"
+#include "Utils/Utils.h"
+
+using namespace SideCar;
+
+const std::string about = "Compare the latency and throughput of a SharedMemoryRing against loopback TCP, with the "
+                          "writer and reader in separate processes. Each transport runs twice: once flooding the "
+                          "reader for throughput, and once paced for latency.";
+
+const Utils::CmdLineArgs::OptionDef opts[] = {
+    {'c', "count", "number of messages per run (default 100000)", "N"},
+    {'i', "interval", "microseconds between messages in the paced run (default 20)", "N"},
+    {'n', "slots", "number of ring slots (default 64)", "N"},
+    {'s', "size", "message size in bytes (default 16384)", "N"},
+};
+
+/** Results a reader process sends back to the writer over a pipe.
+ */
+struct Result {
+    uint64_t received;
+    uint64_t lost;
+    double seconds; ///< From the first message sent to the last one received
+    double mean;    ///< Latencies in microseconds
+    double p50;
+    double p99;
+};
+
+static uint64_t
+Now()
+{
+    timespec now;
+    ::clock_gettime(CLOCK_MONOTONIC, &now);
+    return uint64_t(now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+static void
+Pace(uint64_t start, size_t index, int interval)
+{
+    if (!interval) return;
+    uint64_t when = start + uint64_t(index) * interval * 1000;
+    while (Now() < when)
+        ;
+}
+
+/** Reduce the latencies seen by a reader, and send them to the writer.
+ */
+static void
+Report(int fd, std::vector<uint64_t>& latencies, uint64_t first, uint64_t last, uint64_t lost)
+{
+    Result result;
+    ::memset(&result, 0, sizeof(result));
+    result.received = latencies.size();
+    result.lost = lost;
+    if (!latencies.empty()) {
+        std::sort(latencies.begin(), latencies.end());
+        double sum = 0.0;
+        for (auto latency : latencies) sum += latency;
+        result.seconds = (last - first) * 1.0E-9;
+        result.mean = sum / latencies.size() * 1.0E-3;
+        result.p50 = latencies[latencies.size() / 2] * 1.0E-3;
+        result.p99 = latencies[latencies.size() * 99 / 100] * 1.0E-3;
+    }
+
+    if (::write(fd, &result, sizeof(result)) != sizeof(result)) ::_exit(1);
+}
+
+static void
+Print(const std::string& label, const Result& result, size_t size)
+{
+    std::cout << std::setw(10) << label << std::fixed << std::setprecision(1) << std::setw(12)
+              << (result.seconds ? result.received / result.seconds : 0.0) << " msg/s" << std::setw(10)
+              << (result.seconds ? result.received * size / result.seconds / 1.0E6 : 0.0) << " MB/s"
+              << std::setprecision(2) << "  latency mean " << result.mean << " p50 " << result.p50 << " p99 "
+              << result.p99 << " usec  lost " << result.lost << std::endl;
+}
+
+/** Run one pass through a SharedMemoryRing. The reader looks at each message in place.
+ */
+static Result
+RunRing(size_t count, size_t size, size_t slots, int interval)
+{
+    IO::SharedMemoryRing::Ref ring(IO::SharedMemoryRing::Create("shmbench", slots, size));
+    std::string path(IO::SharedMemoryRing::GetPath(::getpid(), ring->getFileDescriptor()));
+
+    int pipes[2];
+    if (::pipe(pipes) == -1) ::exit(1);
+
+    pid_t child = ::fork();
+    if (child == 0) {
+        IO::SharedMemoryRing::Ref reader(IO::SharedMemoryRing::Attach(path));
+        char ready = 1;
+        if (!reader || ::write(pipes[1], &ready, 1) != 1) ::_exit(1);
+
+        std::vector<uint64_t> latencies;
+        latencies.reserve(count);
+        uint64_t first = 0, last = 0;
+        IO::SharedMemoryRing::View view;
+        while (reader->acquire(view, 5.0)) {
+            last = Now();
+            uint64_t sent;
+            ::memcpy(&sent, view.data, sizeof(sent));
+            reader->release();
+            if (!first) first = sent;
+            latencies.push_back(last - sent);
+        }
+
+        Report(pipes[1], latencies, first, last, reader->getLostCount());
+        ::_exit(0);
+    }
+
+    char ready;
+    if (::read(pipes[0], &ready, 1) != 1) ::exit(1);
+
+    uint64_t start = Now();
+    for (size_t index = 0; index < count; ++index) {
+        Pace(start, index, interval);
+        char* slot = ring->claim();
+        if (!slot) continue;
+        uint64_t now = Now();
+        ::memcpy(slot, &now, sizeof(now));
+        ring->publish(size);
+    }
+
+    ring->close();
+
+    Result result;
+    if (::read(pipes[0], &result, sizeof(result)) != sizeof(result)) ::memset(&result, 0, sizeof(result));
+    ::waitpid(child, 0, 0);
+    ::close(pipes[0]);
+    ::close(pipes[1]);
+    return result;
+}
+
+/** Run one pass over a loopback TCP connection. The reader copies each message out of the socket.
+ */
+static Result
+RunTCP(size_t count, size_t size, int interval)
+{
+    int server = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address;
+    ::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t length = sizeof(address);
+    if (::bind(server, reinterpret_cast<sockaddr*>(&address), length) == -1 || ::listen(server, 1) == -1 ||
+        ::getsockname(server, reinterpret_cast<sockaddr*>(&address), &length) == -1) {
+        std::cerr << "failed to open loopback socket - " << ::strerror(errno) << std::endl;
+        ::exit(1);
+    }
+
+    int pipes[2];
+    if (::pipe(pipes) == -1) ::exit(1);
+
+    pid_t child = ::fork();
+    if (child == 0) {
+        ::close(server);
+        int socket = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (::connect(socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1) ::_exit(1);
+
+        std::vector<uint64_t> latencies;
+        latencies.reserve(count);
+        std::vector<char> buffer(size);
+        uint64_t first = 0, last = 0;
+        while (::recv(socket, &buffer[0], size, MSG_WAITALL) == ssize_t(size)) {
+            last = Now();
+            uint64_t sent;
+            ::memcpy(&sent, &buffer[0], sizeof(sent));
+            if (!first) first = sent;
+            latencies.push_back(last - sent);
+        }
+
+        Report(pipes[1], latencies, first, last, count - latencies.size());
+        ::_exit(0);
+    }
+
+    int socket = ::accept(server, 0, 0);
+    int flag = 1;
+    ::setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+
+    std::vector<char> buffer(size);
+    uint64_t start = Now();
+    for (size_t index = 0; index < count; ++index) {
+        Pace(start, index, interval);
+        uint64_t now = Now();
+        ::memcpy(&buffer[0], &now, sizeof(now));
+        if (::send(socket, &buffer[0], size, 0) != ssize_t(size)) break;
+    }
+
+    ::close(socket);
+    ::close(server);
+
+    Result result;
+    if (::read(pipes[0], &result, sizeof(result)) != sizeof(result)) ::memset(&result, 0, sizeof(result));
+    ::waitpid(child, 0, 0);
+    ::close(pipes[0]);
+    ::close(pipes[1]);
+    return result;
+}
+
+int
+main(int argc, char** argv)
+{
+    Utils::CmdLineArgs cla(argc, argv, about, opts, sizeof(opts), 0, 0);
+
+    size_t count = 100000;
+    if (cla.hasOpt("count")) cla.opt("count")[0] >> count;
+    int interval = 20;
+    if (cla.hasOpt("interval")) cla.opt("interval")[0] >> interval;
+    size_t slots = 64;
+    if (cla.hasOpt("slots")) cla.opt("slots")[0] >> slots;
+    size_t size = 16384;
+    if (cla.hasOpt("size")) cla.opt("size")[0] >> size;
+    size = std::max(size, sizeof(uint64_t));
+
+    std::cout << "messages: " << count << " size: " << size << " slots: " << slots << " interval: " << interval
+              << " usec" << std::endl;
+
+    Print("shm flood", RunRing(count, size, slots, 0), size);
+    Print("tcp flood", RunTCP(count, size, 0), size);
+    Print("shm paced", RunRing(count, size, slots, interval), size);
+    Print("tcp paced", RunTCP(count, size, interval), size);
+
+    return 0;
+}
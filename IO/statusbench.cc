@@ -0,0 +1,122 @@
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "IO/StatusBase.h"
+#include "IO/StatusCodec.h"
+#include "IO/TaskStatus.h"
+#include "Time/TimeStamp.h"
+#include "Utils/CmdLineArgs.h"
+#include "Utils/Utils.h"
+
+using namespace SideCar;
+
+const std::string about = "Compare the cost of encoding and decoding runner status as XML and as binary frames.";
+
+const Utils::CmdLineArgs::OptionDef opts[] = {
+    {'t', "tasks", "number of tasks in the synthetic status (default 500)", "N"},
+    {'n', "iterations", "number of encode/decode cycles to time (default 100)", "N"},
+    {'c', "changes", "percentage of tasks whose counters change between updates (default 10)", "PCT"},
+};
+
+/** Build a status tree shaped like the one created by a Runner with a single stream holding many tasks.
+ */
+static XmlRpc::XmlRpcValue
+MakeStatus(int taskCount, int changePercent, int iteration)
+{
+    XmlRpc::XmlRpcValue tasks;
+    tasks.setSize(taskCount);
+    for (int index = 0; index < taskCount; ++index) {
+        XmlRpc::XmlRpcValue& task(tasks[index]);
+        IO::StatusBase::Make(task, IO::TaskStatus::kNumSlots, "TaskStatus", "Task" + std::to_string(index));
+        bool changing = index * 100 < taskCount * changePercent;
+        int count = changing ? iteration * 1000 + index : index;
+        task[IO::TaskStatus::kProcessingState] = 2;
+        task[IO::TaskStatus::kError] = std::string("");
+        task[IO::TaskStatus::kConnectionInfo] = std::string("localhost:9000");
+        task[IO::TaskStatus::kMessageCount] = count;
+        task[IO::TaskStatus::kByteRate] = changing ? 1.0E6 + iteration : 1.0E6;
+        task[IO::TaskStatus::kMessageRate] = changing ? 800.0 + iteration : 800.0;
+        task[IO::TaskStatus::kDropCount] = 0;
+        task[IO::TaskStatus::kDupeCount] = 0;
+        task[IO::TaskStatus::kPendingQueueCount] = 0;
+        task[IO::TaskStatus::kHasParameters] = false;
+        task[IO::TaskStatus::kUsingData] = true;
+        task[IO::TaskStatus::kTraceSpans].setSize(0);
+    }
+
+    XmlRpc::XmlRpcValue status;
+    IO::StatusBase::Make(status, IO::StatusBase::kNumSlots + 1, "StreamStatus", "Stream");
+    status[IO::StatusBase::kNumSlots] = tasks;
+    return status;
+}
+
+static void
+Report(const char* label, double elapsed, size_t bytes, int iterations)
+{
+    std::cout << std::setw(16) << label << std::fixed << std::setprecision(1) << std::setw(10)
+              << elapsed * 1.0E6 / iterations << " usecs/update " << std::setw(10) << double(bytes) / iterations
+              << " bytes/update\n";
+}
+
+int
+main(int argc, char** argv)
+{
+    Utils::CmdLineArgs cla(argc, argv, about, opts, sizeof(opts), 0, 0);
+
+    int taskCount = 500;
+    if (cla.hasOpt("tasks")) cla.opt("tasks")[0] >> taskCount;
+
+    int iterations = 100;
+    if (cla.hasOpt("iterations")) cla.opt("iterations")[0] >> iterations;
+
+    int changePercent = 10;
+    if (cla.hasOpt("changes")) cla.opt("changes")[0] >> changePercent;
+
+    std::vector<XmlRpc::XmlRpcValue> updates;
+    for (int index = 0; index < iterations; ++index) updates.push_back(MakeStatus(taskCount, changePercent, index));
+
+    // XML path: what StatusEmitterBase and the Master application do today.
+    //
+    size_t bytes = 0;
+    Time::TimeStamp start(Time::TimeStamp::Now());
+    for (auto& update : updates) {
+        std::string xml(update.toXml());
+        bytes += xml.size();
+        int offset = 0;
+        XmlRpc::XmlRpcValue decoded(xml, &offset);
+    }
+    Report("xml", (Time::TimeStamp::Now() - start).asDouble(), bytes, iterations);
+
+    // Binary path with keyframes only.
+    //
+    IO::StatusEncoder keyframeEncoder(1);
+    IO::StatusDecoder keyframeDecoder;
+    std::string frame;
+    bytes = 0;
+    start = Time::TimeStamp::Now();
+    for (auto& update : updates) {
+        keyframeEncoder.encode(update, frame);
+        bytes += frame.size();
+        XmlRpc::XmlRpcValue decoded;
+        keyframeDecoder.decode(frame.data(), frame.size(), decoded);
+    }
+    Report("binary keyframe", (Time::TimeStamp::Now() - start).asDouble(), bytes, iterations);
+
+    // Binary path with the default keyframe interval.
+    //
+    IO::StatusEncoder deltaEncoder;
+    IO::StatusDecoder deltaDecoder;
+    bytes = 0;
+    start = Time::TimeStamp::Now();
+    for (auto& update : updates) {
+        deltaEncoder.encode(update, frame);
+        bytes += frame.size();
+        XmlRpc::XmlRpcValue decoded;
+        deltaDecoder.decode(frame.data(), frame.size(), decoded);
+    }
+    Report("binary delta", (Time::TimeStamp::Now() - start).asDouble(), bytes, iterations);
+
+    return 0;
+}
@@ -1,8 +1,10 @@
 #include <algorithm>
+#include <atomic>
 #include <cstring> // for tolower
 #include <functional>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <sstream>
 #include <unistd.h> // for ::getpid
 
@@ -340,6 +342,278 @@ Log::GetClockSource()
     return RuntimeData::Singleton().clock();
 }
 
+namespace Logger {
+
+/** Queue of log messages posted by one thread and awaiting delivery by the AsyncDelivery thread. There is one
+    producer, the owning thread, and one consumer at a time, so the queue needs no locks: the producer only
+    advances tail_ and the consumer only advances head_.
+
+    Messages are stored as variable-length records in a byte ring: a fixed Record header followed by the message
+    text, rounded up to a multiple of 8 bytes. A record never wraps around the end of the ring; if one does not
+    fit, the producer skips to the start, marking the unused space with a Record whose log is NULL if there is
+    room for one.
+*/
+class MsgQueue {
+public:
+    using Ref = std::shared_ptr<MsgQueue>;
+
+    static constexpr size_t kCapacity = 64 * 1024;
+
+    /** Longest message text that the queue accepts, so that one message never takes up most of the ring.
+     */
+    static constexpr size_t kMaxTextSize = kCapacity / 4;
+
+    MsgQueue() : buffer_(new char[kCapacity]), head_(0), tail_(0), orphaned_(false) {}
+
+    /** Add a message to the queue. Only called by the owning thread.
+
+        \param log device that posted the message
+
+        \param level priority level of the message
+
+        \param when time the message was posted
+
+        \param text text of the message, no longer than kMaxTextSize
+
+        \return true if added, false if there was no room
+    */
+    bool push(const Log* log, Priority::Level level, const ::timeval& when, const std::string& text)
+    {
+        size_t size = text.size();
+        size_t need = RecordSize(size);
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t used = tail - head_.load(std::memory_order_acquire);
+        size_t offset = tail % kCapacity;
+        size_t skip = kCapacity - offset < need ? kCapacity - offset : 0;
+        if (used + skip + need > kCapacity) return false;
+
+        if (skip) {
+            if (skip >= sizeof(Record)) reinterpret_cast<Record*>(buffer_.get() + offset)->log = nullptr;
+            offset = 0;
+        }
+
+        Record* record = reinterpret_cast<Record*>(buffer_.get() + offset);
+        record->log = log;
+        record->level = level;
+        record->size = size;
+        record->when = when;
+        ::memcpy(record + 1, text.data(), size);
+        tail_.store(tail + skip + need, std::memory_order_release);
+        return true;
+    }
+
+    /** Deliver all messages in the queue. Only called by one thread at a time, under the AsyncDelivery drain
+        lock.
+
+        \return number of messages delivered
+    */
+    size_t drain()
+    {
+        size_t count = 0;
+        size_t head = head_.load(std::memory_order_relaxed);
+        size_t tail = tail_.load(std::memory_order_acquire);
+        while (head != tail) {
+            size_t offset = head % kCapacity;
+            size_t left = kCapacity - offset;
+            const Record* record = reinterpret_cast<const Record*>(buffer_.get() + offset);
+            if (left < sizeof(Record) || !record->log) {
+                head += left;
+                continue;
+            }
+
+            Msg msg(record->log->fullName(), std::string(reinterpret_cast<const char*>(record + 1), record->size),
+                    record->level);
+            msg.when_ = record->when;
+            record->log->deliver(msg);
+            head += RecordSize(record->size);
+            head_.store(head, std::memory_order_release);
+            ++count;
+        }
+
+        head_.store(head, std::memory_order_release);
+        return count;
+    }
+
+    bool isEmpty() const { return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire); }
+
+    /** Note that the owning thread has exited. The queue goes away once it is empty.
+     */
+    void orphan() { orphaned_.store(true, std::memory_order_release); }
+
+    bool isOrphaned() const { return orphaned_.load(std::memory_order_acquire); }
+
+private:
+    struct Record {
+        const Log* log;
+        Priority::Level level;
+        uint32_t size;
+        ::timeval when;
+    };
+
+    static size_t RecordSize(size_t size) { return (sizeof(Record) + size + 7) & ~size_t(7); }
+
+    std::unique_ptr<char[]> buffer_;
+    std::atomic<size_t> head_;
+    std::atomic<size_t> tail_;
+    std::atomic<bool> orphaned_;
+};
+
+/** Delivery of the messages in the MsgQueue objects of all posting threads by a background thread. Threads
+    register their queue the first time they post a message, which is the only time posting takes a lock. The
+    background thread wakes up every few milliseconds to deliver what has accumulated.
+*/
+class AsyncDelivery {
+public:
+    static AsyncDelivery& Singleton()
+    {
+        static AsyncDelivery* singleton_ = new AsyncDelivery;
+        return *singleton_;
+    }
+
+    bool isEnabled() const { return enabled_.load(std::memory_order_acquire); }
+
+    size_t getDroppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+
+    void setEnabled(bool enabled);
+
+    /** Queue a message for delivery. If the queue of the calling thread is full, the message is counted and
+        discarded.
+
+        \return false if the message is too long to queue, in which case the caller must deliver it
+    */
+    bool post(const Log* log, Priority::Level level, const ::timeval& when, const std::string& text);
+
+    /** Deliver all queued messages from the calling thread.
+     */
+    void drain();
+
+private:
+    /** Thread that periodically drains the queues until told to stop.
+     */
+    class Worker : public Threading::Thread {
+    public:
+        Worker(AsyncDelivery& owner) : Thread(), owner_(owner), stop_(false), wakeup_(Threading::Condition::Make()) {}
+
+        void stop()
+        {
+            Threading::Locker lock(wakeup_);
+            stop_ = true;
+            wakeup_->signal();
+        }
+
+    private:
+        void run() override
+        {
+            Threading::Locker lock(wakeup_);
+            while (!stop_) {
+                owner_.drain();
+                wakeup_->timedWaitForSignal(0.005);
+            }
+        }
+
+        AsyncDelivery& owner_;
+        bool stop_;
+        Threading::Condition::Ref wakeup_;
+    };
+
+    /** Holder of the MsgQueue of a thread. Its destructor runs when the thread exits.
+     */
+    struct ThreadQueue {
+        ~ThreadQueue()
+        {
+            if (queue) queue->orphan();
+        }
+
+        MsgQueue::Ref queue;
+    };
+
+    AsyncDelivery() :
+        enabled_(false), dropped_(0), worker_(), queues_(), controlMutex_(Threading::Mutex::Make()),
+        queuesMutex_(Threading::Mutex::Make()), drainMutex_(Threading::Mutex::Make())
+    {
+    }
+
+    std::atomic<bool> enabled_;
+    std::atomic<size_t> dropped_;
+    std::unique_ptr<Worker> worker_;
+    std::vector<MsgQueue::Ref> queues_;
+    Threading::Mutex::Ref controlMutex_;
+    Threading::Mutex::Ref queuesMutex_;
+    Threading::Mutex::Ref drainMutex_;
+
+    static thread_local ThreadQueue threadQueue_;
+};
+
+thread_local AsyncDelivery::ThreadQueue AsyncDelivery::threadQueue_;
+
+} // end namespace Logger
+
+extern "C" {
+static void
+StopAsyncDeliveryStub()
+{
+    Log::SetAsynchronous(false);
+}
+}
+
+void
+AsyncDelivery::setEnabled(bool enabled)
+{
+    static bool registered = false;
+    Threading::Locker lock(controlMutex_);
+    if (enabled == isEnabled()) return;
+    if (enabled) {
+        if (!registered) {
+            ::atexit(&StopAsyncDeliveryStub);
+            registered = true;
+        }
+
+        worker_.reset(new Worker(*this));
+        worker_->start();
+        enabled_.store(true, std::memory_order_release);
+    } else {
+        enabled_.store(false, std::memory_order_release);
+        worker_->stop();
+        worker_->join();
+        worker_.reset();
+        drain();
+    }
+}
+
+bool
+AsyncDelivery::post(const Log* log, Priority::Level level, const ::timeval& when, const std::string& text)
+{
+    if (text.size() > MsgQueue::kMaxTextSize) return false;
+    if (!threadQueue_.queue) {
+        threadQueue_.queue.reset(new MsgQueue);
+        Threading::Locker lock(queuesMutex_);
+        queues_.push_back(threadQueue_.queue);
+    }
+
+    if (!threadQueue_.queue->push(log, level, when, text)) dropped_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void
+AsyncDelivery::drain()
+{
+    Threading::Locker drainLock(drainMutex_);
+    std::vector<MsgQueue::Ref> queues;
+    {
+        Threading::Locker lock(queuesMutex_);
+        queues = queues_;
+    }
+
+    for (auto& queue : queues) queue->drain();
+
+    // Forget the queues of threads that have exited once they are empty.
+    //
+    Threading::Locker lock(queuesMutex_);
+    queues_.erase(std::remove_if(queues_.begin(), queues_.end(),
+                                 [](auto& queue) { return queue->isOrphaned() && queue->isEmpty(); }),
+                  queues_.end());
+}
+
 Log&
 Log::Root()
 {
@@ -400,6 +674,30 @@ Log::MakeObj(const std::string& name, const std::string& fullName, Log* parent,
     return obj.release();
 }
 
+void
+Log::SetAsynchronous(bool enabled)
+{
+    AsyncDelivery::Singleton().setEnabled(enabled);
+}
+
+bool
+Log::IsAsynchronous()
+{
+    return AsyncDelivery::Singleton().isEnabled();
+}
+
+size_t
+Log::GetDroppedCount()
+{
+    return AsyncDelivery::Singleton().getDroppedCount();
+}
+
+void
+Log::Drain()
+{
+    if (IsAsynchronous()) AsyncDelivery::Singleton().drain();
+}
+
 std::string
 Log::MakeFullName(const std::string& prefix, const std::string& tail)
 {
@@ -506,6 +804,7 @@ Log::updateMaxPriorityLimit(Priority::Level maxPriority)
 void
 Log::flushWriters()
 {
+    Drain();
     Threading::Locker lock(modifyMutex_);
     std::for_each(writers_.begin(), writers_.end(), [](auto v) { v->flush(); });
 }
@@ -550,8 +849,25 @@ void
 Log::post(Priority::Level level, const std::string& msg) const
 {
     DBG("post() - level: " << level << " msg: '" << msg << "'");
+    ::timeval when;
+    GetClockSource()->now(when);
+
+    // Fatal messages, and those too long to queue, go out right away, after any that are still queued.
+    //
+    AsyncDelivery& async(AsyncDelivery::Singleton());
+    if (async.isEnabled()) {
+        if (level != Priority::kFatal && async.post(this, level, when, msg)) return;
+        async.drain();
+    }
+
     Msg m(fullName_, msg, level);
-    GetClockSource()->now(m.when_);
+    m.when_ = when;
+    deliver(m);
+}
+
+void
+Log::deliver(const Msg& m) const
+{
     const Log* p = this;
     while (p) {
         DBG("checking - p: " << p << " name: " << p->fullName_);
@@ -575,12 +891,46 @@ Log::postMsg(const Msg& msg) const
     std::for_each(writers_.begin(), writers_.end(), [msg](auto v) { v->write(msg); });
 }
 
-ProcLog::ProcLog(const char* name, Log& log) : log_(Log::Find(Log::MakeFullName(log.fullName(), name), false))
+/** Locate the child of a Log device for a ProcLog. Each thread keeps a direct-mapped cache of the devices it has
+    found, keyed by the parent device and the address of the name. Since the same address may hold a different
+    name later, a hit must also match the name of the cached device; names with periods therefore never hit, but
+    still resolve correctly through Log::Find().
+
+    \param parent device that is the parent of the one to find
+
+    \param name name of the child device
+
+    \return found device
+*/
+static Log&
+FindProcLog(Log& parent, const char* name)
+{
+    struct Entry {
+        const Log* parent;
+        const char* name;
+        Log* log;
+    };
+
+    static constexpr size_t kCacheSize = 256;
+    static thread_local Entry cache[kCacheSize];
+
+    uintptr_t key = reinterpret_cast<uintptr_t>(&parent) * 31 + reinterpret_cast<uintptr_t>(name);
+    Entry& entry(cache[(key ^ (key >> 8) ^ (key >> 16)) % kCacheSize]);
+    if (entry.parent == &parent && entry.name == name && entry.log->name() == name) return *entry.log;
+
+    Log& log(Log::Find(Log::MakeFullName(parent.fullName(), name), false));
+    entry.parent = &parent;
+    entry.name = name;
+    entry.log = &log;
+    return log;
+}
+
+ProcLog::ProcLog(const char* name, Log& log) : log_(FindProcLog(log, name))
 {
     ;
 }
 
-ProcLog::ProcLog(const std::string& name, Log& log) : log_(Log::Find(Log::MakeFullName(log.fullName(), name), false))
+ProcLog::ProcLog(const std::string& name, Log& log) : log_(FindProcLog(log, name.c_str()))
 {
     ;
 }
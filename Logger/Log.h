@@ -61,6 +61,13 @@ class Msg;
     postMsg() gives the message to registered writers that do the actual writing of the log message to a log
     device.
 
+    By default, postMsg() runs in the thread that posts the message. After a call to SetAsynchronous(true),
+    post() instead copies the message text, priority level, and timestamp into a queue belonging to the posting
+    thread, and a background thread formats the messages and hands them to the writers. Queuing a message takes
+    no locks and does no I/O, so a slow log device no longer stalls algorithm and IO threads. If a queue is full
+    the message is dropped and counted (see GetDroppedCount()). Fatal messages, messages with more than 16 KB of
+    text, and calls to flushWriters(), first deliver everything queued so far and then proceed synchronously.
+
     For the best performance, one should conditionalize log message generation with a call to one of the
     `shows*' methods (eg showsDebug() or showsError()).
 
@@ -142,6 +149,30 @@ public:
     */
     static std::vector<std::string> GetNames(NewLogNotifier observer);
 
+    /** Enable or disable asynchronous delivery of log messages. Disabling delivers any queued messages before
+        returning.
+
+        \param enabled true to queue messages for a background thread
+    */
+    static void SetAsynchronous(bool enabled);
+
+    /** Determine if log messages are delivered asynchronously.
+
+        \return true if so
+    */
+    static bool IsAsynchronous();
+
+    /** Obtain the number of log messages dropped because the queue of the posting thread was full.
+
+        \return drop count
+    */
+    static size_t GetDroppedCount();
+
+    /** Deliver all log messages queued for asynchronous delivery. Does nothing if SetAsynchronous() is not
+        enabled.
+    */
+    static void Drain();
+
     /** Create a proper log path name
 
         \param prefix the prefix of the full name
@@ -248,8 +279,9 @@ public:
      */
     int numWriters() const;
 
-    /** Ask all registered writers for the log device to write out any unwritten log messages.
-     */
+    /** Ask all registered writers for the log device to write out any unwritten log messages. Delivers any
+        messages queued for asynchronous delivery first.
+    */
     void flushWriters();
 
     /** Submit a log message to all of the assigned LogWriters. Does nothing if the given message level is
@@ -417,6 +449,12 @@ private:
 
     void initialize();
 
+    /** Send a log message to this device and to its parents, as long as they propagate messages.
+
+        \param msg Msg instance to send
+    */
+    void deliver(const Msg& msg) const;
+
     /** Private method used by the Log::post to send the log message to registered Writer instances.
 
         \param msg Msg instance to send
@@ -486,6 +524,7 @@ private:
     static Log* MakeObj(const std::string& name, const std::string& fullName, Log* parent, bool hidden);
 
     friend class LogMap;
+    friend class MsgQueue;
 };
 
 /** Utility class used to create log messages prefixed with a procedure name. To use, simply create an instance
@@ -500,6 +539,10 @@ private:
 
     The above assumes that the class Foo defined a (class) method called Log() which returned the general log
     device to use for all Foo-related log messages.
+
+    Creating a non-static ProcLog is also cheap. Each thread keeps a small cache of the devices it has found,
+    keyed by the parent device and the address of the routine name, so repeated constructions with the same
+    string literal do no string building, locking, or map lookups.
 */
 class ProcLog {
 public:
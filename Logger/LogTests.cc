@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -401,6 +402,8 @@ struct TestLog : public UnitTest::TestObj {
     void testPropagation();
     void testPriorityLimit();
     void testProcLog();
+    void testProcLogCache();
+    void testAsynchronous();
 
     static UnitTest::ProcSuite<TestLog>* Install(UnitTest::ProcSuite<TestLog>* ps)
     {
@@ -409,6 +412,8 @@ struct TestLog : public UnitTest::TestObj {
         ps->add("propagation", &TestLog::testPropagation);
         ps->add("priorityLimit", &TestLog::testPriorityLimit);
         ps->add("procLog", &TestLog::testProcLog);
+        ps->add("procLogCache", &TestLog::testProcLogCache);
+        ps->add("asynchronous", &TestLog::testAsynchronous);
         return ps;
     }
 };
@@ -570,6 +575,111 @@ TestLog::testProcLog()
                 oss.str());
 }
 
+void
+TestLog::testProcLogCache()
+{
+    testClock->reset();
+    Log& parent(Log::Find("root.cache"));
+    std::stringstream oss("");
+    Writers::Writer::Ref sw(Writers::Stream::Make(Formatters::Verbose::Make(), oss));
+    parent.addWriter(sw);
+    CleanUp cl(parent, sw);
+    parent.setPriorityLimit(Priority::kInfo);
+
+    // Repeated constructions with the same name reach the same device.
+    //
+    for (int index = 0; index < 2; ++index) {
+        ProcLog log("c", parent);
+        log.info() << index << std::endl;
+    }
+
+    // The same address holding a different name must not reuse the cached device.
+    //
+    char name[] = "one";
+    {
+        ProcLog log(name, parent);
+        log.info() << "first" << std::endl;
+    }
+
+    ::strcpy(name, "two");
+    {
+        ProcLog log(name, parent);
+        log.info() << "second" << std::endl;
+    }
+
+    assertEqual("19700101 000000.00 INFO root.cache.c: 0\n"
+                "19700101 000001.00 INFO root.cache.c: 1\n"
+                "19700101 000002.00 INFO root.cache.one: first\n"
+                "19700101 000003.00 INFO root.cache.two: second\n",
+                oss.str());
+}
+
+struct AsyncPoster : public Threading::Thread {
+    AsyncPoster(Log& log) : Thread(), log_(log) {}
+
+    void run()
+    {
+        for (int index = 0; index < 100; ++index) log_.info() << "thread " << index << std::endl;
+    }
+
+    Log& log_;
+};
+
+void
+TestLog::testAsynchronous()
+{
+    testClock->reset();
+    Log& log(Log::Find("root.async"));
+    std::stringstream oss("");
+    Writers::Writer::Ref sw(Writers::Stream::Make(Formatters::Terse::Make(), oss));
+    log.addWriter(sw);
+    CleanUp cl(log, sw);
+    log.setPriorityLimit(Priority::kInfo);
+
+    Log::SetAsynchronous(true);
+    assertTrue(Log::IsAsynchronous());
+
+    // Messages from another thread arrive intact, in the order that thread posted them.
+    //
+    AsyncPoster poster(log);
+    poster.start();
+    poster.join();
+    log.flushWriters();
+
+    std::string text(oss.str());
+    std::string::size_type pos = 0;
+    for (int index = 0; index < 100; ++index) {
+        std::ostringstream line;
+        line << " I - thread " << index << '\n';
+        pos = text.find(line.str(), pos);
+        assertTrue(pos != std::string::npos);
+    }
+
+    // Messages keep the time at which they were posted, not when they were written.
+    //
+    oss.str("");
+    testClock->reset();
+    log.info() << "queued" << std::endl;
+    testClock->reset();
+    Log::SetAsynchronous(false);
+    assertFalse(Log::IsAsynchronous());
+    assertEqual("19700101 000000.00 I - queued\n", oss.str());
+    assertEqual(size_t(0), Log::GetDroppedCount());
+
+    // Messages too long to queue arrive whole, after those queued before them.
+    //
+    oss.str("");
+    testClock->reset();
+    Log::SetAsynchronous(true);
+    std::string longText(40000, 'x');
+    log.info() << "before" << std::endl;
+    log.info() << longText << std::endl;
+    Log::SetAsynchronous(false);
+    std::string expected("19700101 000000.00 I - before\n19700101 000001.00 I - ");
+    assertEqual(expected + longText + '\n', oss.str());
+    assertEqual(size_t(0), Log::GetDroppedCount());
+}
+
 void
 TestLog::testPropagation()
 {
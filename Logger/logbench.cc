@@ -0,0 +1,89 @@
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "Time/TimeStamp.h"
+#include "Utils/CmdLineArgs.h"
+#include "Utils/Utils.h"
+
+#include "Formatters.h"
+#include "Log.h"
+#include "Writers.h"
+
+using namespace SideCar;
+using namespace Logger;
+
+const std::string about = "Time the cost to the calling thread of disabled log statements, of creating a ProcLog "
+                          "on the stack, and of posting messages with synchronous and asynchronous delivery.";
+
+const Utils::CmdLineArgs::OptionDef opts[] = {
+    {'n', "iterations", "number of operations to time (default 100000)", "N"},
+    {'o', "output", "file to write log messages to (default /dev/null)", "PATH"},
+};
+
+static void
+Report(const char* label, double elapsed, int iterations)
+{
+    std::cout << std::setw(24) << label << std::fixed << std::setprecision(1) << std::setw(12)
+              << elapsed * 1.0E9 / iterations << " nsecs/op\n";
+}
+
+/** Routine that creates its ProcLog on every call, as many message handlers do.
+ */
+static void
+Routine(Log& parent, int index)
+{
+    ProcLog log("Routine", parent);
+    LOGDEBUG << "index: " << index << std::endl;
+}
+
+int
+main(int argc, char** argv)
+{
+    Utils::CmdLineArgs cla(argc, argv, about, opts, sizeof(opts), 0, 0);
+
+    int iterations = 100000;
+    std::string path("/dev/null");
+    if (cla.hasOpt("iterations")) cla.opt("iterations")[0] >> iterations;
+    if (cla.hasOpt("output")) path = cla.opt("output")[0];
+
+    Log& parent(Log::Find("logbench"));
+    parent.setPriorityLimit(Priority::kInfo);
+    parent.addWriter(Writers::File::Make(Formatters::Verbose::Make(), path, true, 00644, true));
+
+    {
+        Log& log(parent);
+        Time::TimeStamp start(Time::TimeStamp::Now());
+        for (int index = 0; index < iterations; ++index) LOGDEBUG << "index: " << index << std::endl;
+        Report("disabled LOGDEBUG", (Time::TimeStamp::Now() - start).asDouble(), iterations);
+    }
+
+    {
+        Time::TimeStamp start(Time::TimeStamp::Now());
+        for (int index = 0; index < iterations; ++index) {
+            Log& log(Log::Find(Log::MakeFullName(parent.fullName(), "Routine"), false));
+            LOGDEBUG << "index: " << index << std::endl;
+        }
+        Report("Find + MakeFullName", (Time::TimeStamp::Now() - start).asDouble(), iterations);
+
+        start = Time::TimeStamp::Now();
+        for (int index = 0; index < iterations; ++index) Routine(parent, index);
+        Report("cached ProcLog", (Time::TimeStamp::Now() - start).asDouble(), iterations);
+    }
+
+    {
+        Log& log(parent);
+        Time::TimeStamp start(Time::TimeStamp::Now());
+        for (int index = 0; index < iterations; ++index) LOGINFO << "index: " << index << std::endl;
+        Report("synchronous LOGINFO", (Time::TimeStamp::Now() - start).asDouble(), iterations);
+
+        Log::SetAsynchronous(true);
+        start = Time::TimeStamp::Now();
+        for (int index = 0; index < iterations; ++index) LOGINFO << "index: " << index << std::endl;
+        Report("asynchronous LOGINFO", (Time::TimeStamp::Now() - start).asDouble(), iterations);
+        Log::SetAsynchronous(false);
+        std::cout << std::setw(24) << "dropped" << std::setw(12) << Log::GetDroppedCount() << '\n';
+    }
+
+    return 0;
+}
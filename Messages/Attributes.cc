@@ -1,3 +1,10 @@
+#include <limits>
+#include <unordered_map>
+
+#include "ace/CDR_Stream.h"
+#include "ace/Guard_T.h"
+#include "ace/Mutex.h"
+
 #include "Utils/IO.h" // Contains operators << and >> for
 // std::strings
 #include "Logger/Log.h"
@@ -6,41 +13,321 @@
 
 using namespace SideCar::Messages;
 
+/** Marker written in place of the legacy XML string length. The high bit can never be set in the length of an
+    XML string, and the remaining bits hold the encoding version.
+*/
+static const ACE_CDR::ULong kBinaryMarker = 0x80000000;
+static const ACE_CDR::ULong kCurrentVersion = 1;
+
+namespace {
+
+/** Process-wide table of attribute names.
+ */
+struct KeyTable {
+    ACE_Mutex mutex_;
+    std::unordered_map<std::string, Attributes::Key> keys_;
+    std::vector<const std::string*> names_;
+};
+
+KeyTable&
+GetKeyTable()
+{
+    static KeyTable* table_ = new KeyTable;
+    return *table_;
+}
+
+} // namespace
+
 Attributes::DuplicateAttribute::DuplicateAttribute(const std::string& name) : Utils::Exception("Attributes::add")
 {
     *this << ": attempt to add attribute that already exists - " << name;
 }
 
-Attributes::Attributes() : attributes_(new XmlRpc::XmlRpcValue::ValueStruct)
+Attributes::Key
+Attributes::Intern(const std::string& name)
+{
+    KeyTable& table(GetKeyTable());
+    ACE_Guard<ACE_Mutex> locker(table.mutex_);
+    auto pos = table.keys_.find(name);
+    if (pos != table.keys_.end()) return pos->second;
+
+    if (table.names_.size() > std::numeric_limits<Key>::max()) {
+        Utils::Exception ex("Attributes::Intern: too many attribute names - ");
+        ex << name;
+        throw ex;
+    }
+
+    Key key = Key(table.names_.size());
+    pos = table.keys_.emplace(name, key).first;
+    table.names_.push_back(&pos->first);
+    return key;
+}
+
+const std::string&
+Attributes::GetName(Key key)
+{
+    KeyTable& table(GetKeyTable());
+    ACE_Guard<ACE_Mutex> locker(table.mutex_);
+    return *table.names_.at(key);
+}
+
+Attributes::Attributes() : entries_(), text_()
 {
     ;
 }
 
+const Attributes::Entry*
+Attributes::locate(Key key) const
+{
+    for (const auto& entry : entries_) {
+        if (entry.key == key) return &entry;
+    }
+    return 0;
+}
+
+Attributes::Entry&
+Attributes::append(Key key, Type type)
+{
+    if (locate(key)) {
+        DuplicateAttribute ex(GetName(key));
+        throw ex;
+    }
+
+    entries_.emplace_back();
+    Entry& entry(entries_.back());
+    entry.key = key;
+    entry.type = type;
+    entry.length = 0;
+    entry.asDouble = 0.0;
+    return entry;
+}
+
+void
+Attributes::appendText(Key key, Type type, const std::string& text)
+{
+    Entry& entry(append(key, type));
+    entry.offset = text_.size();
+    entry.length = text.size();
+    text_ += text;
+}
+
+void
+Attributes::add(Key key, bool value)
+{
+    append(key, kBool).asBool = value;
+}
+
+void
+Attributes::add(Key key, int value)
+{
+    append(key, kInt).asInt = value;
+}
+
+void
+Attributes::add(Key key, double value)
+{
+    append(key, kDouble).asDouble = value;
+}
+
+void
+Attributes::add(Key key, const std::string& value)
+{
+    appendText(key, kString, value);
+}
+
+void
+Attributes::add(Key key, const char* value)
+{
+    appendText(key, kString, value);
+}
+
 void
 Attributes::add(const std::string& name, const XmlRpc::XmlRpcValue& value)
 {
-    if (attributes_.hasMember(name)) {
-        DuplicateAttribute ex(name);
-        throw ex;
+    Key key = Intern(name);
+    switch (value.getType()) {
+    case XmlRpc::XmlRpcValue::TypeBoolean: add(key, static_cast<const bool&>(value)); break;
+    case XmlRpc::XmlRpcValue::TypeInt: add(key, static_cast<const int&>(value)); break;
+    case XmlRpc::XmlRpcValue::TypeDouble: add(key, static_cast<const double&>(value)); break;
+    case XmlRpc::XmlRpcValue::TypeString: add(key, static_cast<const std::string&>(value)); break;
+    default: appendText(key, kXml, value.toXml()); break;
     }
+}
+
+bool
+Attributes::contains(const std::string& name) const
+{
+    for (const auto& entry : entries_) {
+        if (GetName(entry.key) == name) return true;
+    }
+    return false;
+}
+
+bool
+Attributes::get(Key key, double& value) const
+{
+    const Entry* entry = locate(key);
+    if (!entry) return false;
+    switch (entry->type) {
+    case kBool: value = entry->asBool ? 1.0 : 0.0; return true;
+    case kInt: value = entry->asInt; return true;
+    case kDouble: value = entry->asDouble; return true;
+    default: return false;
+    }
+}
+
+bool
+Attributes::get(Key key, std::string& value) const
+{
+    const Entry* entry = locate(key);
+    if (!entry || entry->type != kString) return false;
+    value.assign(text_, entry->offset, entry->length);
+    return true;
+}
+
+XmlRpc::XmlRpcValue
+Attributes::makeValue(const Entry& entry) const
+{
+    switch (entry.type) {
+    case kBool: return XmlRpc::XmlRpcValue(entry.asBool);
+    case kInt: return XmlRpc::XmlRpcValue(int(entry.asInt));
+    case kDouble: return XmlRpc::XmlRpcValue(entry.asDouble);
+    case kString: return XmlRpc::XmlRpcValue(text_.substr(entry.offset, entry.length));
+    default: break;
+    }
+
+    XmlRpc::XmlRpcValue value;
+    const char* cp = text_.data() + entry.offset;
+    value.fromXml(cp, cp + entry.length);
+    return value;
+}
+
+XmlRpc::XmlRpcValue
+Attributes::find(const std::string& name) const
+{
+    for (const auto& entry : entries_) {
+        if (GetName(entry.key) == name) return makeValue(entry);
+    }
+    return XmlRpc::XmlRpcValue();
+}
 
-    attributes_[name] = value;
+XmlRpc::XmlRpcValue
+Attributes::getXmlRpcValue() const
+{
+    XmlRpc::XmlRpcValue value(new XmlRpc::XmlRpcValue::ValueStruct);
+    for (const auto& entry : entries_) value[GetName(entry.key)] = makeValue(entry);
+    return value;
 }
 
 ACE_InputCDR&
 Attributes::load(ACE_InputCDR& cdr)
 {
-    std::string xml;
-    cdr >> xml;
+    static Logger::ProcLog log("load", Logger::Log::Find("SideCar.Messages.Attributes"));
+
+    entries_.clear();
+    text_.clear();
+
+    ACE_CDR::ULong marker;
+    cdr >> marker;
+    if (!(marker & kBinaryMarker)) return loadLegacy(cdr, marker);
+
+    ACE_CDR::ULong version = marker & ~kBinaryMarker;
+    if (version != kCurrentVersion) {
+        Utils::Exception ex("unknown attributes encoding version ");
+        ex << version;
+        log.thrower(ex);
+    }
+
+    return loadV1(cdr);
+}
+
+ACE_InputCDR&
+Attributes::loadLegacy(ACE_InputCDR& cdr, uint32_t length)
+{
+    // Legacy format: an ACE CDR string (length includes the trailing NUL) holding an XML-RPC struct.
+    //
+    if (length == 0) return cdr;
+
+    std::string xml(length, '\0');
+    if (!cdr.read_char_array(&xml[0], length)) return cdr;
+    xml.resize(length - 1);
+
+    XmlRpc::XmlRpcValue value;
     int offset = 0;
-    attributes_.fromXml(xml, &offset);
+    if (!value.fromXml(xml, &offset) || value.getType() != XmlRpc::XmlRpcValue::TypeStruct) return cdr;
+
+    XmlRpc::XmlRpcValue::ValueStruct& members(value);
+    for (auto& member : members) add(member.first, member.second);
+
+    return cdr;
+}
+
+ACE_InputCDR&
+Attributes::loadV1(ACE_InputCDR& cdr)
+{
+    static Logger::ProcLog log("loadV1", Logger::Log::Find("SideCar.Messages.Attributes"));
+
+    ACE_CDR::ULong count;
+    if (!(cdr >> count)) return cdr;
+
+    entries_.reserve(count);
+    std::string name;
+    std::string text;
+    while (count-- && cdr.good_bit()) {
+        ACE_CDR::Octet type;
+        cdr >> name;
+        cdr >> ACE_InputCDR::to_octet(type);
+        Key key = Intern(name);
+        switch (type) {
+        case kBool: {
+            ACE_CDR::Boolean value;
+            cdr >> ACE_InputCDR::to_boolean(value);
+            add(key, bool(value));
+            break;
+        }
+        case kInt: {
+            ACE_CDR::Long value;
+            cdr >> value;
+            add(key, int(value));
+            break;
+        }
+        case kDouble: {
+            ACE_CDR::Double value;
+            cdr >> value;
+            add(key, double(value));
+            break;
+        }
+        case kString:
+        case kXml:
+            cdr >> text;
+            appendText(key, Type(type), text);
+            break;
+        default: {
+            Utils::Exception ex("invalid attribute type ");
+            ex << int(type) << " for attribute " << name;
+            log.thrower(ex);
+        }
+        }
+    }
+
     return cdr;
 }
 
 ACE_OutputCDR&
 Attributes::write(ACE_OutputCDR& cdr) const
 {
-    std::string xml(attributes_.toXml());
-    cdr << xml;
+    cdr << ACE_CDR::ULong(kBinaryMarker | kCurrentVersion);
+    cdr << ACE_CDR::ULong(entries_.size());
+    for (const auto& entry : entries_) {
+        cdr << GetName(entry.key);
+        cdr << ACE_OutputCDR::from_octet(entry.type);
+        switch (entry.type) {
+        case kBool: cdr << ACE_OutputCDR::from_boolean(entry.asBool); break;
+        case kInt: cdr << ACE_CDR::Long(entry.asInt); break;
+        case kDouble: cdr << ACE_CDR::Double(entry.asDouble); break;
+        default: cdr << text_.substr(entry.offset, entry.length); break;
+        }
+    }
+
     return cdr;
 }
@@ -2,6 +2,7 @@
 #define SIDECAR_MESSAGES_ATTRIBUTES_H
 
 #include <string>
+#include <vector>
 
 #include "IO/CDRStreamable.h"
 #include "IO/Printable.h"
@@ -11,9 +12,17 @@
 namespace SideCar {
 namespace Messages {
 
-/** Collection of name/value pairs for SideCar messages. Relies on the XMLRPC library for marshalling the values
-    to/from network or disk. Currently, the Extraction and BugPlot messages support attributes. If enough
-    messsage classes do, it may make sense to have Header acquire an Attributes slot.
+/** Collection of name/value pairs for SideCar messages. Currently, the Extraction, TSPI, and BugPlot messages
+    support attributes. If enough messsage classes do, it may make sense to have Header acquire an Attributes
+    slot.
+
+    Attribute names are interned in a process-wide table, and each attribute occupies one fixed-size Entry in a
+    flat array. Boolean, integer, and floating-point values live in the Entry itself; string values share a
+    single character buffer. Any other XML-RPC value is kept as its XML text. An empty container performs no
+    heap allocations, and a container with only numeric attributes performs one.
+
+    The CDR representation is binary and versioned. Containers written by older software as a single XML string
+    are still accepted by load(). XML-RPC values are only built when asked for by find() or print().
 */
 class Attributes : public IO::CDRStreamable<Attributes>, public IO::Printable<Attributes> {
 public:
@@ -28,6 +37,30 @@ public:
         DuplicateAttribute(const std::string& name);
     };
 
+    /** Interned attribute name. Obtain with Intern() and reuse to avoid name lookups in tight loops.
+     */
+    using Key = uint16_t;
+
+    /** Storage types for attribute values.
+     */
+    enum Type { kBool, kInt, kDouble, kString, kXml };
+
+    /** Obtain the key for an attribute name, adding the name to the process-wide table if necessary. Thread-safe.
+
+        \param name the attribute name
+
+        \return key for the name
+    */
+    static Key Intern(const std::string& name);
+
+    /** Obtain the name for an interned key.
+
+        \param key value returned by Intern()
+
+        \return attribute name
+    */
+    static const std::string& GetName(Key key);
+
     /** Constructor. Initialize empty container of attributes.
      */
     Attributes();
@@ -41,13 +74,94 @@ public:
     */
     void add(const std::string& name, const XmlRpc::XmlRpcValue& value);
 
+    /** Add a new boolean attribute. Throws DuplicateAttribute if the key is already present.
+
+        \param key the attribute key
+
+        \param value the attribute value
+    */
+    void add(Key key, bool value);
+
+    /** Add a new integer attribute. Throws DuplicateAttribute if the key is already present.
+
+        \param key the attribute key
+
+        \param value the attribute value
+    */
+    void add(Key key, int value);
+
+    /** Add a new floating-point attribute. Throws DuplicateAttribute if the key is already present.
+
+        \param key the attribute key
+
+        \param value the attribute value
+    */
+    void add(Key key, double value);
+
+    /** Add a new string attribute. Throws DuplicateAttribute if the key is already present.
+
+        \param key the attribute key
+
+        \param value the attribute value
+    */
+    void add(Key key, const std::string& value);
+
+    /** Add a new string attribute. Without this, a string literal would convert to bool and pick that overload.
+        Throws DuplicateAttribute if the key is already present.
+
+        \param key the attribute key
+
+        \param value the attribute value
+    */
+    void add(Key key, const char* value);
+
     /** Determines if there is an attribute with the given name.
 
         \param name the attribute name
 
         \return true if exists
     */
-    bool contains(const std::string& name) const { return attributes_.hasMember(name); }
+    bool contains(const std::string& name) const;
+
+    /** Determines if there is an attribute with the given key.
+
+        \param key the attribute key
+
+        \return true if exists
+    */
+    bool contains(Key key) const { return locate(key) != 0; }
+
+    /** Obtain the number of attributes in the container.
+
+        \return attribute count
+    */
+    size_t size() const { return entries_.size(); }
+
+    /** Determine if the container is empty.
+
+        \return true if so
+    */
+    bool empty() const { return entries_.empty(); }
+
+    /** Obtain the numeric value of an attribute. Boolean and integer values are converted.
+
+        \param key the attribute key
+
+        \param value storage for the value
+
+        \return true if the attribute exists and is numeric
+    */
+    bool get(Key key, double& value) const;
+
+    /** Obtain the value of a string attribute.
+
+        \param key the attribute key
+
+        \param value storage for the value
+
+        \return true if the attribute exists and holds a string
+    */
+    bool get(Key key, std::string& value) const;
 
     /** Find an attribute with the given name.
 
@@ -55,7 +169,7 @@ public:
 
         \return attribute value if found; 'invalid' XMLRPC value if not.
     */
-    const XmlRpc::XmlRpcValue& find(const std::string& name) const { return attributes_[name]; }
+    XmlRpc::XmlRpcValue find(const std::string& name) const;
 
     /** Obtain an attribute with the given name.
 
@@ -63,7 +177,13 @@ public:
 
         \return attribute value if found; 'invalid' XMLRPC value if not.
     */
-    const XmlRpc::XmlRpcValue& operator[](const std::string& name) const { return find(name); }
+    XmlRpc::XmlRpcValue operator[](const std::string& name) const { return find(name); }
+
+    /** Obtain all attributes as an XML-RPC struct. Intended for XML export.
+
+        \return new XML-RPC struct value
+    */
+    XmlRpc::XmlRpcValue getXmlRpcValue() const;
 
     /** Build an Attributes container from an ACE CDR stream.
 
@@ -87,13 +207,43 @@ public:
 
         \return stream written to
     */
-    std::ostream& print(std::ostream& os) const { return os << attributes_.toXml(); }
+    std::ostream& print(std::ostream& os) const { return os << getXmlRpcValue().toXml(); }
 
 private:
-    XmlRpc::XmlRpcValue attributes_;
+    /** A single attribute. Strings and XML text are stored in text_ at [offset, offset + length).
+     */
+    struct Entry {
+        Key key;
+        uint8_t type;
+        uint32_t length;
+        union {
+            bool asBool;
+            int32_t asInt;
+            double asDouble;
+            uint32_t offset;
+        };
+    };
+
+    const Entry* locate(Key key) const;
+
+    Entry& append(Key key, Type type);
+
+    void appendText(Key key, Type type, const std::string& text);
+
+    XmlRpc::XmlRpcValue makeValue(const Entry& entry) const;
+
+    ACE_InputCDR& loadLegacy(ACE_InputCDR& cdr, uint32_t length);
+
+    ACE_InputCDR& loadV1(ACE_InputCDR& cdr);
+
+    std::vector<Entry> entries_;
+    std::string text_;
 };
 
 } // end namespace Messages
 } // end namespace SideCar
 
+/** \file
+ */
+
 #endif
@@ -0,0 +1,130 @@
+#include "ace/CDR_Stream.h"
+
+#include "Logger/Log.h"
+#include "UnitTest/UnitTest.h"
+#include "Utils/IO.h"
+
+#include "Attributes.h"
+
+using namespace SideCar::Messages;
+
+struct Test : public UnitTest::TestObj {
+    Test() : TestObj("Attributes") {}
+
+    void test();
+};
+
+void
+Test::test()
+{
+    Attributes::Key snr = Attributes::Intern("snr");
+    assertEqual(snr, Attributes::Intern("snr"));
+    assertEqual(std::string("snr"), Attributes::GetName(snr));
+
+    Attributes attributes;
+    assertTrue(attributes.empty());
+    attributes.add(snr, 12.5);
+    attributes.add(Attributes::Intern("hits"), 3);
+    attributes.add(Attributes::Intern("confirmed"), true);
+    attributes.add(Attributes::Intern("source"), "cfar");
+
+    XmlRpc::XmlRpcValue list;
+    list.setSize(2);
+    list[0] = 1;
+    list[1] = 2;
+    attributes.add("list", list);
+    assertEqual(size_t(5), attributes.size());
+
+    // Duplicate names must be rejected whether given by key or by name.
+    //
+    try {
+        attributes.add(snr, 1.0);
+        assertTrue(false);
+    } catch (const Attributes::DuplicateAttribute&) {
+        ;
+    }
+
+    try {
+        attributes.add("hits", XmlRpc::XmlRpcValue(4));
+        assertTrue(false);
+    } catch (const Attributes::DuplicateAttribute&) {
+        ;
+    }
+
+    // Round-trip through the binary CDR encoding.
+    //
+    {
+        ACE_OutputCDR out;
+        out << attributes;
+        ACE_InputCDR in(out);
+        Attributes copy;
+        in >> copy;
+        assertTrue(in.good_bit());
+        assertEqual(size_t(5), copy.size());
+
+        double value = 0.0;
+        assertTrue(copy.get(snr, value));
+        assertEqual(12.5, value);
+        assertTrue(copy.get(Attributes::Intern("hits"), value));
+        assertEqual(3.0, value);
+        assertTrue(copy.get(Attributes::Intern("confirmed"), value));
+        assertEqual(1.0, value);
+
+        std::string source;
+        assertTrue(copy.get(Attributes::Intern("source"), source));
+        assertEqual(std::string("cfar"), source);
+        assertFalse(copy.get(snr, source));
+
+        assertTrue(copy.find("list") == list);
+        assertTrue(copy.getXmlRpcValue() == attributes.getXmlRpcValue());
+        assertFalse(copy.find("missing").valid());
+    }
+
+    // Load the XML string written by older software.
+    //
+    {
+        XmlRpc::XmlRpcValue legacy;
+        legacy["foo"] = std::string("one");
+        legacy["range"] = 4.5;
+
+        ACE_OutputCDR out;
+        out << legacy.toXml();
+        out << ACE_CDR::Long(1234);
+        ACE_InputCDR in(out);
+        Attributes copy;
+        in >> copy;
+        assertEqual(size_t(2), copy.size());
+        assertTrue(copy["foo"] == legacy["foo"]);
+
+        double value = 0.0;
+        assertTrue(copy.get(Attributes::Intern("range"), value));
+        assertEqual(4.5, value);
+
+        // The stream must be left positioned just after the attributes.
+        //
+        ACE_CDR::Long trailer;
+        in >> trailer;
+        assertEqual(1234, trailer);
+    }
+
+    // An empty legacy string and an empty binary container both load as empty.
+    //
+    {
+        ACE_OutputCDR out;
+        out << std::string("");
+        out << Attributes();
+        ACE_InputCDR in(out);
+        Attributes copy;
+        in >> copy;
+        assertTrue(copy.empty());
+        in >> copy;
+        assertTrue(copy.empty());
+        assertTrue(in.good_bit());
+    }
+}
+
+int
+main(int, const char**)
+{
+    return Test().mainRun();
+}
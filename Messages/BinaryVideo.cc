@@ -4,6 +4,11 @@
 
 using namespace SideCar::Messages;
 
+/** Flag set in the sample count of a serialized BinaryVideo message when the gate values are packed eight to a
+    byte. Older software wrote one byte per gate and never sets this bit, since counts are far smaller.
+*/
+static const uint32_t kPackedFlag = 0x80000000;
+
 MetaTypeInfo BinaryVideo::metaTypeInfo_(MetaTypeInfo::Value::kBinaryVideo, "BinaryVideo", &BinaryVideo::CDRLoader,
                                         &BinaryVideo::XMLLoader);
 
@@ -115,3 +120,53 @@ BinaryVideo::getVideoBasis() const
 
     return video;
 }
+
+void
+BinaryVideo::getBits(Utils::BitVector& bits) const
+{
+    const Container& data(getData());
+    bits.assign(data.data(), data.data() + data.size());
+}
+
+void
+BinaryVideo::setBits(const Utils::BitVector& bits)
+{
+    bits.unpack(getData());
+}
+
+ACE_InputCDR&
+BinaryVideo::load(ACE_InputCDR& cdr)
+{
+    uint32_t count;
+    loadArray(cdr, count);
+    if (!(count & kPackedFlag)) {
+        TraitsType::Reader(cdr, count, data_);
+        return cdr;
+    }
+
+    // Gate N is bit (N % 8) of byte (N / 8).
+    //
+    count &= ~kPackedFlag;
+    std::vector<ACE_CDR::Octet> packed((count + 7) / 8);
+    if (!packed.empty()) cdr.read_octet_array(&packed[0], packed.size());
+
+    data_.resize(count);
+    for (uint32_t index = 0; index < count; ++index) data_[index] = (packed[index / 8] >> (index % 8)) & 1;
+
+    return cdr;
+}
+
+ACE_OutputCDR&
+BinaryVideo::write(ACE_OutputCDR& cdr) const
+{
+    uint32_t count = size();
+    writeArray(cdr, count | kPackedFlag);
+
+    std::vector<ACE_CDR::Octet> packed((count + 7) / 8, 0);
+    for (uint32_t index = 0; index < count; ++index) {
+        if (data_[index]) packed[index / 8] |= 1 << (index % 8);
+    }
+
+    if (!packed.empty()) cdr.write_octet_array(&packed[0], packed.size());
+    return cdr;
+}
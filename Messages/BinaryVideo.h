@@ -2,6 +2,7 @@
 #define SIDECAR_MESSAGES_BINARYVIDEO_H
 
 #include "Messages/Video.h"
+#include "Utils/BitVector.h"
 
 namespace SideCar {
 namespace Messages {
@@ -90,6 +91,36 @@ public:
     */
     Ref getBinaryBasis() const { return getBasis<BinaryVideo>(); }
 
+    /** Obtain the gate values packed one bit per gate. The byte-per-gate container returned by getData() remains
+        the primary representation; use this for word-level processing.
+
+        \param bits container to fill
+    */
+    void getBits(Utils::BitVector& bits) const;
+
+    /** Replace the gate values with those from a packed bit container.
+
+        \param bits the new gate values
+    */
+    void setBits(const Utils::BitVector& bits);
+
+    /** Read in a message from a CDR stream. Accepts both the packed encoding written by write() and the older
+        byte-per-gate encoding.
+
+        \param cdr stream to read from
+
+        \return stream read from
+    */
+    ACE_InputCDR& load(ACE_InputCDR& cdr);
+
+    /** Write out the message to a CDR stream, with gate values packed eight to a byte.
+
+        \param cdr stream to write to
+
+        \return stream written to
+    */
+    ACE_OutputCDR& write(ACE_OutputCDR& cdr) const;
+
 private:
     BinaryVideo();
 
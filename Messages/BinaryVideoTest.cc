@@ -0,0 +1,75 @@
+#include "Logger/Log.h"
+#include "UnitTest/UnitTest.h"
+#include "Utils/BitVector.h"
+
+#include "BinaryVideo.h"
+
+using namespace SideCar;
+using namespace SideCar::Messages;
+
+struct Test : public UnitTest::TestObj {
+    Test() : TestObj("BinaryVideo") {}
+
+    void test();
+};
+
+void
+Test::test()
+{
+    const size_t kNumSamples = 77;
+
+    Logger::Log::Root().setPriorityLimit(Logger::Priority::kDebug);
+
+    VMEDataMessage vme;
+    vme.header.msgDesc = (VMEHeader::kPackedReal << 16) | VMEHeader::kIRIGValidMask | VMEHeader::kTimeStampValidMask |
+                         VMEHeader::kAzimuthValidMask | VMEHeader::kPRIValidMask;
+    vme.header.timeStamp = 0;
+    vme.header.azimuth = 12345;
+    vme.header.pri = 1;
+    vme.header.irigTime = 1.2345;
+
+    BinaryVideo::Ref msg(BinaryVideo::Make("Test::test()", vme, kNumSamples));
+    for (size_t index = 0; index < kNumSamples; ++index) msg->push_back(index % 3 == 0 || index == 70);
+
+    // Packed accessors
+    //
+    Utils::BitVector bits;
+    msg->getBits(bits);
+    assertEqual(kNumSamples, bits.size());
+    assertEqual(size_t(27), bits.count());
+    bits.set(1);
+    msg->setBits(bits);
+    assertEqual(kNumSamples, msg->size());
+    assertTrue(msg[1]);
+    msg[1] = false;
+
+    // Packed CDR encoding takes one bit per gate
+    //
+    ACE_OutputCDR packed(size_t(0), ACE_CDR_BYTE_ORDER);
+    assertTrue(msg->write(packed).good_bit());
+    ACE_OutputCDR legacy(size_t(0), ACE_CDR_BYTE_ORDER);
+    assertTrue(msg->Super::write(legacy).good_bit());
+    assertEqual(legacy.total_length() - kNumSamples + (kNumSamples + 7) / 8, packed.total_length());
+
+    // Both encodings load
+    //
+    {
+        ACE_InputCDR input(packed);
+        BinaryVideo::Ref copy(BinaryVideo::Make(input));
+        assertEqual(kNumSamples, copy->size());
+        assertEqual(12345U, copy->getRIUInfo().shaftEncoding);
+        for (size_t index = 0; index < kNumSamples; ++index) assertEqual(msg[index], copy[index]);
+    }
+    {
+        ACE_InputCDR input(legacy);
+        BinaryVideo::Ref copy(BinaryVideo::Make(input));
+        assertEqual(kNumSamples, copy->size());
+        for (size_t index = 0; index < kNumSamples; ++index) assertEqual(msg[index], copy[index]);
+    }
+}
+
+int
+main(int, const char**)
+{
+    return Test().mainRun();
+}
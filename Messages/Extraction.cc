@@ -12,20 +12,30 @@ MetaTypeInfo Extractions::metaTypeInfo_(MetaTypeInfo::Value::kExtractions, "Extr
 
 Extraction::Extraction(const Time::TimeStamp& when, double range, double azimuth, double elevation) :
     when_(when), range_(range), azimuth_(azimuth), elevation_(elevation), x_(range * ::sin(azimuth)),
-    y_(range * ::cos(azimuth))
+    y_(range * ::cos(azimuth)), attributes_(), correlated_(false), numCorrelations_(0)
 {
     ;
 }
 
-Extraction::Extraction(XmlStreamReader& xsr)
+Extraction::Extraction(const Time::TimeStamp& when, double range, double azimuth, double elevation, double x,
+                       double y) :
+    when_(when), range_(range), azimuth_(azimuth), elevation_(elevation), x_(x), y_(y), attributes_(),
+    correlated_(false), numCorrelations_(0)
+{
+    ;
+}
+
+Extraction::Extraction(XmlStreamReader& xsr) : attributes_(), correlated_(false), numCorrelations_(0)
 {
     when_ = Time::TimeStamp::ParseSpecification(xsr.getAttribute("when").toStdString(), Time::TimeStamp::Min());
     range_ = xsr.getAttribute("range").toDouble();
     azimuth_ = Utils::degreesToRadians(xsr.getAttribute("azimuth").toDouble());
     elevation_ = xsr.getAttribute("elevation").toDouble();
+    x_ = range_ * ::sin(azimuth_);
+    y_ = range_ * ::cos(azimuth_);
 }
 
-Extraction::Extraction(ACE_InputCDR& cdr)
+Extraction::Extraction(ACE_InputCDR& cdr) : attributes_(), correlated_(false), numCorrelations_(0)
 {
     cdr >> when_;
     cdr >> range_;
@@ -32,6 +32,20 @@ public:
   Extraction(const Time::TimeStamp &when, double range, double azimuth,
              double elevation);
 
+  /** Constructor for entries whose rectangular coordinates are already known,
+      such as those rebuilt from an ExtractionColumns object.
+
+      \param range range of the artifact
+
+      \param azimuth azimuth of the artifact (radians)
+
+      \param x X coordinate of the artifact
+
+      \param y Y coordinate of the artifact
+  */
+  Extraction(const Time::TimeStamp &when, double range, double azimuth,
+             double elevation, double x, double y);
+
   /** Constructor for objects loaded from an ACE input stream.
 
       \param cdr stream to read from
@@ -104,8 +118,25 @@ public:
     attributes_.add(name, value);
   }
 
+  /** Add a typed attribute using an interned key. Avoids building an
+      XmlRpcValue for each extraction.
+
+      \param key value from Attributes::Intern()
+
+      \param value attribute value (bool, int, double, std::string, or C string)
+  */
+  template <typename T> void addAttribute(Attributes::Key key, const T &value) {
+    attributes_.add(key, value);
+  }
+
   const Attributes &getAttributes() const { return attributes_; }
 
+  /** Replace the attributes of the extraction.
+
+      \param attributes new attribute container
+  */
+  void setAttributes(const Attributes &attributes) { attributes_ = attributes; }
+
   /** Write out binary representation to a CDR stream
 
       \param cdr stream to write to
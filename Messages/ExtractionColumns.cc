@@ -0,0 +1,177 @@
+#include <cmath>
+
+#include "ExtractionColumns.h"
+
+using namespace SideCar::Messages;
+
+namespace {
+
+/** Append to indices the rows in [0, count) for which test returns true. Every row is written to the output
+    slot and the slot is only advanced on a match, so the loop body has no data-dependent branches.
+*/
+template <typename Test>
+size_t
+Select(size_t count, Test test, ExtractionColumns::IndexVector& indices)
+{
+    size_t base = indices.size();
+    indices.resize(base + count);
+    uint32_t* out = indices.data() + base;
+    size_t found = 0;
+    for (size_t index = 0; index < count; ++index) {
+        out[found] = uint32_t(index);
+        found += test(index) ? 1 : 0;
+    }
+
+    indices.resize(base + found);
+    return found;
+}
+
+} // namespace
+
+ExtractionColumns::ExtractionColumns() :
+    when_(), time_(), range_(), azimuth_(), elevation_(), x_(), y_(), correlated_(), numCorrelations_(),
+    attributes_()
+{
+    ;
+}
+
+ExtractionColumns::ExtractionColumns(const Extractions& msg) : ExtractionColumns()
+{
+    assign(msg);
+}
+
+void
+ExtractionColumns::assign(const Extractions& msg)
+{
+    clear();
+    reserve(msg.size());
+    for (const auto& extraction : msg) append(extraction);
+}
+
+void
+ExtractionColumns::clear()
+{
+    when_.clear();
+    time_.clear();
+    range_.clear();
+    azimuth_.clear();
+    elevation_.clear();
+    x_.clear();
+    y_.clear();
+    correlated_.clear();
+    numCorrelations_.clear();
+    attributes_.clear();
+}
+
+void
+ExtractionColumns::reserve(size_t size)
+{
+    when_.reserve(size);
+    time_.reserve(size);
+    range_.reserve(size);
+    azimuth_.reserve(size);
+    elevation_.reserve(size);
+    x_.reserve(size);
+    y_.reserve(size);
+    correlated_.reserve(size);
+    numCorrelations_.reserve(size);
+    attributes_.reserve(size);
+}
+
+void
+ExtractionColumns::append(const Extraction& extraction)
+{
+    when_.push_back(extraction.getWhen());
+    time_.push_back(extraction.getWhen().asDouble());
+    range_.push_back(extraction.getRange());
+    azimuth_.push_back(extraction.getAzimuth());
+    elevation_.push_back(extraction.getElevation());
+    x_.push_back(extraction.getX());
+    y_.push_back(extraction.getY());
+    correlated_.push_back(extraction.getCorrelated());
+    numCorrelations_.push_back(extraction.getNumCorrelations());
+    attributes_.push_back(extraction.getAttributes());
+}
+
+void
+ExtractionColumns::append(const Time::TimeStamp& when, double range, double azimuth, double elevation)
+{
+    when_.push_back(when);
+    time_.push_back(when.asDouble());
+    range_.push_back(range);
+    azimuth_.push_back(azimuth);
+    elevation_.push_back(elevation);
+    x_.push_back(0.0);
+    y_.push_back(0.0);
+    correlated_.push_back(false);
+    numCorrelations_.push_back(0);
+    attributes_.emplace_back();
+}
+
+void
+ExtractionColumns::computeXY(size_t first)
+{
+    const double* range = range_.data();
+    const double* azimuth = azimuth_.data();
+    double* x = x_.data();
+    double* y = y_.data();
+    for (size_t index = first; index < size(); ++index) {
+        x[index] = range[index] * ::sin(azimuth[index]);
+        y[index] = range[index] * ::cos(azimuth[index]);
+    }
+}
+
+Extraction
+ExtractionColumns::makeExtraction(size_t index) const
+{
+    Extraction extraction(when_[index], range_[index], azimuth_[index], elevation_[index], x_[index], y_[index]);
+    extraction.setCorrelated(correlated_[index]);
+    extraction.setNumCorrelations(numCorrelations_[index]);
+    extraction.setAttributes(attributes_[index]);
+    return extraction;
+}
+
+void
+ExtractionColumns::fill(Extractions& msg) const
+{
+    msg.reserve(msg.size() + size());
+    for (size_t index = 0; index < size(); ++index) msg.push_back(makeExtraction(index));
+}
+
+void
+ExtractionColumns::fill(Extractions& msg, const IndexVector& indices) const
+{
+    msg.reserve(msg.size() + indices.size());
+    for (auto index : indices) msg.push_back(makeExtraction(index));
+}
+
+size_t
+ExtractionColumns::selectRange(double minRange, double maxRange, IndexVector& indices) const
+{
+    const double* range = range_.data();
+    return Select(
+        size(), [=](size_t index) { return (range[index] >= minRange) & (range[index] <= maxRange); }, indices);
+}
+
+size_t
+ExtractionColumns::selectTime(double begin, double end, IndexVector& indices) const
+{
+    const double* time = time_.data();
+    return Select(
+        size(), [=](size_t index) { return (time[index] >= begin) & (time[index] <= end); }, indices);
+}
+
+size_t
+ExtractionColumns::selectWithin(double x, double y, double radius2, IndexVector& indices) const
+{
+    const double* xs = x_.data();
+    const double* ys = y_.data();
+    return Select(
+        size(),
+        [=](size_t index) {
+            double dx = xs[index] - x;
+            double dy = ys[index] - y;
+            return dx * dx + dy * dy < radius2;
+        },
+        indices);
+}
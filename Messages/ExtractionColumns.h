@@ -0,0 +1,206 @@
+#ifndef SIDECAR_MESSAGES_EXTRACTIONCOLUMNS_H // -*- C++ -*-
+#define SIDECAR_MESSAGES_EXTRACTIONCOLUMNS_H
+
+#include <vector>
+
+#include "Messages/Extraction.h"
+#include "Time/TimeStamp.h"
+
+namespace SideCar {
+namespace Messages {
+
+/** Structure-of-arrays view of the contents of an Extractions message. Each field of an Extraction lives in its own
+    contiguous column, so that gating and filtering code walks flat arrays of doubles instead of a vector of large
+    Extraction objects. Conversion to and from Extractions is lossless: the derived X and Y values are copied as-is,
+    and the attributes of each extraction are kept in their own column.
+
+    The select methods append the indices of matching rows to an IndexVector. They evaluate the test for every row
+    without branching, which lets the compiler vectorize the comparisons.
+*/
+class ExtractionColumns {
+public:
+    using IndexVector = std::vector<uint32_t>;
+
+    /** Constructor. Creates an empty container.
+     */
+    ExtractionColumns();
+
+    /** Constructor. Copies the contents of an Extractions message.
+
+        \param msg the message to copy
+    */
+    explicit ExtractionColumns(const Extractions& msg);
+
+    /** Replace the contents of the container with those of an Extractions message.
+
+        \param msg the message to copy
+    */
+    void assign(const Extractions& msg);
+
+    /** Remove all rows. Column capacity is retained.
+     */
+    void clear();
+
+    /** Allocate space in each column for a given number of rows.
+
+        \param size number of rows to reserve
+    */
+    void reserve(size_t size);
+
+    /** Append a copy of an Extraction.
+
+        \param extraction the value to append
+    */
+    void append(const Extraction& extraction);
+
+    /** Append a new row without its X and Y values. Call computeXY() when done appending.
+
+        \param when time of the extraction
+
+        \param range range of the extraction
+
+        \param azimuth azimuth of the extraction (radians)
+
+        \param elevation elevation of the extraction
+    */
+    void append(const Time::TimeStamp& when, double range, double azimuth, double elevation);
+
+    /** Calculate the X and Y values of rows from range and azimuth, using the same nautical convention as
+        Extraction.
+
+        \param first index of the first row to update
+    */
+    void computeXY(size_t first = 0);
+
+    /** Obtain the number of rows.
+
+        \return row count
+    */
+    size_t size() const { return range_.size(); }
+
+    /** Determine if there are any rows.
+
+        \return true if empty
+    */
+    bool empty() const { return range_.empty(); }
+
+    /** Rebuild the Extraction held in a given row.
+
+        \param index the row to fetch
+
+        \return new Extraction object
+    */
+    Extraction makeExtraction(size_t index) const;
+
+    /** Append all rows to an Extractions message.
+
+        \param msg the message to update
+    */
+    void fill(Extractions& msg) const;
+
+    /** Append selected rows to an Extractions message.
+
+        \param msg the message to update
+
+        \param indices the rows to append
+    */
+    void fill(Extractions& msg, const IndexVector& indices) const;
+
+    const Time::TimeStamp& getWhen(size_t index) const { return when_[index]; }
+
+    double getTime(size_t index) const { return time_[index]; }
+
+    double getRange(size_t index) const { return range_[index]; }
+
+    double getAzimuth(size_t index) const { return azimuth_[index]; }
+
+    double getElevation(size_t index) const { return elevation_[index]; }
+
+    double getX(size_t index) const { return x_[index]; }
+
+    double getY(size_t index) const { return y_[index]; }
+
+    bool getCorrelated(size_t index) const { return correlated_[index]; }
+
+    void setCorrelated(size_t index, bool value) { correlated_[index] = value; }
+
+    int getNumCorrelations(size_t index) const { return numCorrelations_[index]; }
+
+    void setNumCorrelations(size_t index, int value) { numCorrelations_[index] = value; }
+
+    const Attributes& getAttributes(size_t index) const { return attributes_[index]; }
+
+    /** Obtain the column of extraction times, in seconds.
+
+        \return read-only column
+    */
+    const std::vector<double>& getTimes() const { return time_; }
+
+    const std::vector<double>& getRanges() const { return range_; }
+
+    const std::vector<double>& getAzimuths() const { return azimuth_; }
+
+    const std::vector<double>& getElevations() const { return elevation_; }
+
+    const std::vector<double>& getXs() const { return x_; }
+
+    const std::vector<double>& getYs() const { return y_; }
+
+    /** Select the rows whose range lies within [minRange, maxRange].
+
+        \param minRange smallest accepted range
+
+        \param maxRange largest accepted range
+
+        \param indices container to receive the indices of matching rows
+
+        \return number of rows selected
+    */
+    size_t selectRange(double minRange, double maxRange, IndexVector& indices) const;
+
+    /** Select the rows whose time lies within [begin, end].
+
+        \param begin earliest accepted time in seconds
+
+        \param end latest accepted time in seconds
+
+        \param indices container to receive the indices of matching rows
+
+        \return number of rows selected
+    */
+    size_t selectTime(double begin, double end, IndexVector& indices) const;
+
+    /** Select the rows whose X,Y position is strictly less than a given distance from a point.
+
+        \param x X coordinate of the point
+
+        \param y Y coordinate of the point
+
+        \param radius2 square of the gate radius
+
+        \param indices container to receive the indices of matching rows
+
+        \return number of rows selected
+    */
+    size_t selectWithin(double x, double y, double radius2, IndexVector& indices) const;
+
+private:
+    std::vector<Time::TimeStamp> when_;
+    std::vector<double> time_;
+    std::vector<double> range_;
+    std::vector<double> azimuth_;
+    std::vector<double> elevation_;
+    std::vector<double> x_;
+    std::vector<double> y_;
+    std::vector<uint8_t> correlated_;
+    std::vector<int32_t> numCorrelations_;
+    std::vector<Attributes> attributes_;
+};
+
+} // end namespace Messages
+} // end namespace SideCar
+
+/** \file
+ */
+
+#endif
@@ -0,0 +1,92 @@
+#include <cmath>
+
+#include "Logger/Log.h"
+#include "UnitTest/UnitTest.h"
+
+#include "ExtractionColumns.h"
+
+using namespace SideCar;
+using namespace SideCar::Messages;
+
+struct Test : public UnitTest::TestObj {
+    Test() : TestObj("ExtractionColumns") {}
+
+    void test();
+};
+
+void
+Test::test()
+{
+    Extractions::Ref msg(Extractions::Make("test", Header::Ref()));
+    for (int index = 0; index < 10; ++index) {
+        Extraction extraction(Time::TimeStamp(100 + index, 250000), 1.0 + index, index * 0.5, 0.25 * index);
+        extraction.setCorrelated(index % 2);
+        extraction.setNumCorrelations(index);
+        extraction.addAttribute("index", index);
+        msg->push_back(extraction);
+    }
+
+    ExtractionColumns columns(*msg);
+    assertEqual(size_t(10), columns.size());
+    assertEqual(101.25, columns.getTime(1));
+    assertEqual(msg[3].getX(), columns.getX(3));
+    assertEqual(msg[3].getY(), columns.getY(3));
+
+    // Conversion back to Extractions must reproduce every field.
+    //
+    Extractions::Ref copy(Extractions::Make("copy", msg));
+    columns.fill(*copy);
+    assertEqual(msg->size(), copy->size());
+    for (size_t index = 0; index < msg->size(); ++index) {
+        const Extraction& lhs(msg[index]);
+        const Extraction& rhs(copy[index]);
+        assertTrue(lhs.getWhen() == rhs.getWhen());
+        assertEqual(lhs.getRange(), rhs.getRange());
+        assertEqual(lhs.getAzimuth(), rhs.getAzimuth());
+        assertEqual(lhs.getElevation(), rhs.getElevation());
+        assertEqual(lhs.getX(), rhs.getX());
+        assertEqual(lhs.getY(), rhs.getY());
+        assertEqual(lhs.getCorrelated(), rhs.getCorrelated());
+        assertEqual(lhs.getNumCorrelations(), rhs.getNumCorrelations());
+        assertTrue(lhs.getAttributes().getXmlRpcValue() == rhs.getAttributes().getXmlRpcValue());
+    }
+
+    // Bulk X/Y calculation must match the Extraction constructor.
+    //
+    ExtractionColumns built;
+    for (size_t index = 0; index < msg->size(); ++index)
+        built.append(msg[index].getWhen(), msg[index].getRange(), msg[index].getAzimuth(), msg[index].getElevation());
+    built.computeXY();
+    for (size_t index = 0; index < msg->size(); ++index) {
+        assertEqual(msg[index].getX(), built.getX(index));
+        assertEqual(msg[index].getY(), built.getY(index));
+    }
+
+    // Gating
+    //
+    ExtractionColumns::IndexVector indices;
+    assertEqual(size_t(3), columns.selectRange(3.0, 5.0, indices));
+    assertEqual(size_t(3), indices.size());
+    assertEqual(uint32_t(2), indices[0]);
+    assertEqual(uint32_t(4), indices[2]);
+
+    indices.clear();
+    assertEqual(size_t(2), columns.selectTime(104.0, 106.0, indices));
+    assertEqual(uint32_t(4), indices[0]);
+    assertEqual(uint32_t(5), indices[1]);
+
+    indices.clear();
+    assertEqual(size_t(1), columns.selectWithin(columns.getX(7), columns.getY(7), 0.01, indices));
+    assertEqual(uint32_t(7), indices[0]);
+
+    Extractions::Ref selected(Extractions::Make("selected", msg));
+    columns.fill(*selected, indices);
+    assertEqual(size_t(1), selected->size());
+    assertEqual(msg[7].getRange(), selected[0].getRange());
+}
+
+int
+main(int, const char**)
+{
+    return Test().mainRun();
+}
@@ -1,3 +1,6 @@
+#include <atomic>
+#include <unistd.h>
+
 #include "Logger/Log.h"
 
 #include "Header.h"
@@ -13,11 +16,37 @@ Header::DefineLoaders()
     TLoaderRegistry<Header>::VersionedLoaderVector loaders;
     loaders.push_back(TLoaderRegistry<Header>::VersionedLoader(1, &Header::LoadV1));
     loaders.push_back(TLoaderRegistry<Header>::VersionedLoader(2, &Header::LoadV2));
+    loaders.push_back(TLoaderRegistry<Header>::VersionedLoader(3, &Header::LoadV3));
     return loaders;
 }
 
 TLoaderRegistry<Header> Header::loaderRegistry_(Header::DefineLoaders());
 
+/** Number of root messages between sampled traces. Zero disables tracing.
+ */
+static std::atomic<uint32_t> traceSamplingPeriod_(0);
+
+/** Number of root messages seen while tracing is enabled.
+ */
+static std::atomic<uint32_t> traceSampleCounter_(0);
+
+/** Source of trace IDs. Seeded with the process ID so that traces started by different runners are unlikely to
+    share an ID.
+*/
+static std::atomic<uint32_t> nextTraceId_(uint32_t(::getpid()) << 16);
+
+void
+Header::SetTraceSamplingPeriod(uint32_t period)
+{
+    traceSamplingPeriod_ = period;
+}
+
+uint32_t
+Header::GetTraceSamplingPeriod()
+{
+    return traceSamplingPeriod_;
+}
+
 Logger::Log&
 Header::Log()
 {
@@ -37,39 +66,43 @@ Header::GetMessageMetaTypeInfo(ACE_InputCDR& cdr)
 
 Header::Header(ACE_InputCDR& cdr) :
     metaTypeInfo_(*MetaTypeInfo::Find(MetaTypeInfo::Value::kVideo)), guid_(), createdTimeStamp_(), emittedTimeStamp_(),
-    basis_()
+    basis_(), traceId_(0), traceOriginTimeStamp_()
 {
     load(cdr);
 }
 
 Header::Header(const std::string& producer, const MetaTypeInfo& metaTypeInfo) :
     metaTypeInfo_(metaTypeInfo), guid_(producer, metaTypeInfo), createdTimeStamp_(Time::TimeStamp::Now()),
-    emittedTimeStamp_(), basis_()
+    emittedTimeStamp_(), basis_(), traceId_(0), traceOriginTimeStamp_()
 {
     static Logger::ProcLog log("Header(0)", Log());
     LOGTIN << std::endl;
+    initializeTrace();
 }
 
 Header::Header(const std::string& producer, const MetaTypeInfo& metaTypeInfo, const Ref& basis) :
     metaTypeInfo_(metaTypeInfo), guid_(producer, metaTypeInfo), createdTimeStamp_(Time::TimeStamp::Now()),
-    emittedTimeStamp_(), basis_(basis)
+    emittedTimeStamp_(), basis_(basis), traceId_(0), traceOriginTimeStamp_()
 {
     static Logger::ProcLog log("Header(1)", Log());
     LOGTIN << std::endl;
+    initializeTrace();
 }
 
 Header::Header(const std::string& producer, const MetaTypeInfo& metaTypeInfo, const Ref& basis,
                MetaTypeInfo::SequenceType sequenceNumber) :
     metaTypeInfo_(metaTypeInfo),
     guid_(producer, metaTypeInfo, sequenceNumber), createdTimeStamp_(Time::TimeStamp::Now()), emittedTimeStamp_(),
-    basis_(basis)
+    basis_(basis), traceId_(0), traceOriginTimeStamp_()
 {
     static Logger::ProcLog log("Header(2)", Log());
     LOGTIN << std::endl;
+    initializeTrace();
 }
 
 Header::Header(const MetaTypeInfo& metaTypeInfo) :
-    metaTypeInfo_(metaTypeInfo), guid_(), createdTimeStamp_(), emittedTimeStamp_(), basis_()
+    metaTypeInfo_(metaTypeInfo), guid_(), createdTimeStamp_(), emittedTimeStamp_(), basis_(), traceId_(0),
+    traceOriginTimeStamp_()
 {
     static Logger::ProcLog log("Header(3)", Log());
     LOGTIN << std::endl;
@@ -80,6 +113,23 @@ Header::~Header()
     ;
 }
 
+void
+Header::initializeTrace()
+{
+    if (basis_) {
+        traceId_ = basis_->traceId_;
+        traceOriginTimeStamp_ = basis_->traceOriginTimeStamp_;
+        return;
+    }
+
+    uint32_t period = traceSamplingPeriod_.load(std::memory_order_relaxed);
+    if (period && traceSampleCounter_.fetch_add(1, std::memory_order_relaxed) % period == 0) {
+        traceId_ = nextTraceId_.fetch_add(1, std::memory_order_relaxed);
+        if (!traceId_) traceId_ = nextTraceId_.fetch_add(1, std::memory_order_relaxed);
+        traceOriginTimeStamp_ = createdTimeStamp_;
+    }
+}
+
 Time::TimeStamp
 Header::setCreatedTimeStamp(const Time::TimeStamp& value)
 {
@@ -128,6 +178,21 @@ Header::LoadV2(Header* obj, ACE_InputCDR& cdr)
     return cdr;
 }
 
+ACE_InputCDR&
+Header::LoadV3(Header* obj, ACE_InputCDR& cdr)
+{
+    static Logger::ProcLog log("LoadV3", Log());
+    LoadV2(obj, cdr);
+    ACE_CDR::ULong traceId;
+    cdr >> traceId;
+    obj->traceId_ = traceId;
+    if (traceId) {
+        cdr >> obj->traceOriginTimeStamp_;
+        LOGDEBUG << "traceId: " << traceId << " traceOrigin: " << obj->traceOriginTimeStamp_ << std::endl;
+    }
+    return cdr;
+}
+
 ACE_OutputCDR&
 Header::write(ACE_OutputCDR& cdr) const
 {
@@ -138,14 +203,17 @@ Header::write(ACE_OutputCDR& cdr) const
     cdr << createdTimeStamp_;
     if (emittedTimeStamp_ == Time::TimeStamp::Min()) emittedTimeStamp_ = Time::TimeStamp::Now();
     cdr << emittedTimeStamp_;
+    cdr << ACE_CDR::ULong(traceId_);
+    if (traceId_) cdr << traceOriginTimeStamp_;
     return cdr;
 }
 
 std::ostream&
 Header::printHeader(std::ostream& os) const
 {
-    return os << "GUID: " << guid_.getRepresentation() << " CTime: " << createdTimeStamp_
-              << " ETime: " << emittedTimeStamp_;
+    os << "GUID: " << guid_.getRepresentation() << " CTime: " << createdTimeStamp_ << " ETime: " << emittedTimeStamp_;
+    if (traceId_) os << " Trace: " << traceId_ << " TTime: " << traceOriginTimeStamp_;
+    return os;
 }
 
 std::ostream&
@@ -133,6 +133,39 @@ public:
     */
     Time::TimeStamp setEmittedTimeStamp(const Time::TimeStamp& timeStamp);
 
+    /** Set how often new messages without a basis start a pipeline trace. A value of N traces every Nth such
+        message; zero (the default) disables tracing. Messages created from a basis message inherit the trace of
+        their basis, so a trace follows a PRI through every algorithm and network hop that carries it.
+
+        \param period sampling period
+    */
+    static void SetTraceSamplingPeriod(uint32_t period);
+
+    /** Obtain the current trace sampling period.
+
+        \return sampling period (zero if disabled)
+    */
+    static uint32_t GetTraceSamplingPeriod();
+
+    /** Determine if the message belongs to a sampled pipeline trace.
+
+        \return true if so
+    */
+    bool isTraced() const { return traceId_ != 0; }
+
+    /** Obtain the ID of the trace this message belongs to.
+
+        \return trace ID, or zero if not traced
+    */
+    uint32_t getTraceId() const { return traceId_; }
+
+    /** Obtain the time when the trace this message belongs to was started. This is the creation time of the
+        root message of the trace, usually when the PRI arrived from the VME.
+
+        \return time stamp reference
+    */
+    const Time::TimeStamp& getTraceOriginTimeStamp() const { return traceOriginTimeStamp_; }
+
     /** Obtain the C++ structure size for this object. Derived classes must override if they extend Header with
         additional members.
 
@@ -292,11 +325,18 @@ private:
     */
     Header(const Header& rhs);
 
+    /** Set the trace attributes for a new message, either by inheriting them from the basis message or by
+        sampling a new trace.
+    */
+    void initializeTrace();
+
     const MetaTypeInfo& metaTypeInfo_;         ///< Meta type info for this object
     GUID guid_;                                ///< Globally-unique ID for this object
     Time::TimeStamp createdTimeStamp_;         ///< When created
     mutable Time::TimeStamp emittedTimeStamp_; ///< When emitted
     Ref basis_;                                ///< Msg that is the basis for this one
+    uint32_t traceId_;                         ///< Pipeline trace ID (zero if none)
+    Time::TimeStamp traceOriginTimeStamp_;     ///< When the trace started
 
     /** Header v1 loader. Reads in GUID and created timestamp.
 
@@ -319,6 +359,16 @@ private:
     */
     static ACE_InputCDR& LoadV2(Header* object, ACE_InputCDR& cdr);
 
+    /** Header v3 loader. V3 adds the pipeline trace ID and, for traced messages, the trace origin timestamp.
+
+        \param object the Header object to load into
+
+        \param cdr the input stream to read from
+
+        \return input stream read from
+    */
+    static ACE_InputCDR& LoadV3(Header* object, ACE_InputCDR& cdr);
+
     /** Factory method that creates and returns an array of supported versioned loaders.
 
         \return
@@ -351,7 +401,7 @@ struct SideCarMessage
     uint16_t magic_;            // 0xAAAA
     uint16_t alignment_;        // Zero is litle-endian
     uint32_t payloadSize_;      // Number of bytes in messsage
-    uint16_t headerVersion_;    // Currently at 2
+    uint16_t headerVersion_;    // Currently at 3
     uint16_t guidVersion_;      // Currently at 3
     uint32_t producerLength_;   // Number of characters in producer name
     char     producer_[producerLength_];
@@ -367,6 +417,9 @@ struct SideCarMessage
     int32_t  createdTimeStampMicroSeconds_;
     int32_t  emittedTimeStampSeconds_;
     int32_t  emittedTimeStampMicroSeconds_;
+    uint32_t traceId_;          // Zero if not traced
+    int32_t  traceOriginSeconds_;       // Only present if traceId_ != 0
+    int32_t  traceOriginMicroSeconds_;  // Only present if traceId_ != 0
 
     uint16_t messageVersion_;   // Currently at 4
 
@@ -0,0 +1,141 @@
+#include <algorithm>
+
+#include "SegmentLabeller.h"
+
+using namespace SideCar::Messages;
+
+SegmentLabeller::SegmentLabeller(size_t maxSpan) :
+    forest_(), lists_(), previous_(), current_(), previousLabels_(), currentLabels_(), maxSpan_(maxSpan)
+{
+    ;
+}
+
+SegmentLabeller::~SegmentLabeller()
+{
+    reset();
+}
+
+void
+SegmentLabeller::reset()
+{
+    for (auto list : lists_) delete list;
+    forest_.reset();
+    lists_.clear();
+    previous_.clear();
+    previousLabels_.clear();
+}
+
+SegmentLabeller::Label
+SegmentLabeller::unite(Label a, Label b)
+{
+    if (a == b) return a;
+
+    // Keep the blob with more segments so that fewer segments are copied.
+    //
+    if (lists_[a]->size() < lists_[b]->size()) std::swap(a, b);
+
+    lists_[a]->merge(*lists_[b]);
+    delete lists_[b];
+    lists_[b] = 0;
+    forest_.unite(a, b);
+    return a;
+}
+
+SegmentLabeller::Label
+SegmentLabeller::allocate()
+{
+    Label label = forest_.allocate();
+    if (lists_.size() < forest_.getLabelCount()) lists_.resize(forest_.getLabelCount(), 0);
+    lists_[label] = new SegmentList;
+    return label;
+}
+
+void
+SegmentLabeller::attach(Label label, const Segment& segment)
+{
+    SegmentList* list = lists_[label];
+    if (forest_.touch(label)) list->setPRISpan(list->PRISpan() + 1);
+    list->merge(segment);
+}
+
+void
+SegmentLabeller::add(const SegmentList& pri, BlobVector& done)
+{
+    forest_.beginPRI();
+
+    current_.assign(pri.data().begin(), pri.data().end());
+    auto byStart = [](const Segment& lhs, const Segment& rhs) { return lhs.start < rhs.start; };
+    if (!std::is_sorted(current_.begin(), current_.end(), byStart)) {
+        std::sort(current_.begin(), current_.end(), byStart);
+    }
+
+    // Sweep both PRIs in range order. Segments of the previous PRI that end more than one gate before the current
+    // segment cannot touch it or any that follow. Those that begin no more than one gate after it ends do touch it.
+    //
+    currentLabels_.resize(current_.size());
+    size_t first = 0;
+    for (size_t index = 0; index < current_.size(); ++index) {
+        const Segment& segment = current_[index];
+        while (first < previous_.size() && previous_[first].stop + 1 < segment.start) ++first;
+
+        Label label = 0;
+        bool found = false;
+        for (size_t other = first; other < previous_.size() && previous_[other].start <= segment.stop + 1; ++other) {
+            Label root = forest_.find(previousLabels_[other]);
+            label = found ? unite(label, root) : root;
+            found = true;
+        }
+
+        if (!found) label = allocate();
+        attach(label, segment);
+        currentLabels_[index] = label;
+    }
+
+    // Blobs open before this PRI that did not receive a segment are complete. The blobs extended by this PRI are
+    // the ones that remain open, except for any that span too many PRIs: those are returned now, and their
+    // segments are removed so that they do not connect to the next PRI.
+    //
+    bool rings = false;
+    forest_.close(
+        [&](Label label) {
+            done.push_back(lists_[label]);
+            lists_[label] = 0;
+        },
+        [&](Label label) {
+            if (!maxSpan_ || lists_[label]->PRISpan() <= maxSpan_) return true;
+            done.push_back(lists_[label]);
+            lists_[label] = 0;
+            rings = true;
+            return false;
+        });
+
+    size_t kept = 0;
+    for (size_t index = 0; index < current_.size(); ++index) {
+        Label label = forest_.find(currentLabels_[index]);
+        if (rings && !lists_[label]) continue;
+        current_[kept] = current_[index];
+        currentLabels_[kept] = label;
+        ++kept;
+    }
+
+    current_.resize(kept);
+    currentLabels_.resize(kept);
+
+    // All surviving segments now refer to roots, so labels merged away during this PRI are no longer used.
+    //
+    forest_.recycleMerged();
+
+    previous_.swap(current_);
+    previousLabels_.swap(currentLabels_);
+}
+
+void
+SegmentLabeller::flush(BlobVector& done)
+{
+    for (auto label : forest_.getOpen()) {
+        done.push_back(lists_[label]);
+        lists_[label] = 0;
+    }
+
+    reset();
+}
@@ -0,0 +1,100 @@
+#ifndef SIDECAR_MESSAGES_SEGMENTLABELLER_H // -*- C++ -*-
+#define SIDECAR_MESSAGES_SEGMENTLABELLER_H
+
+#include <vector>
+
+#include "Messages/Segments.h"
+#include "Utils/LabelForest.h"
+
+namespace SideCar {
+namespace Messages {
+
+/** Streaming connected-components labeller for run-length encoded PRIs. Feed it the segments of each PRI in
+    order; it joins each segment to the segments of the previous PRI that it touches (8-point connectivity) and
+    hands back each blob once no segment of the latest PRI extends it.
+
+    Blob membership is tracked with a Utils::LabelForest. Only the segments of the
+    previous PRI and the blobs still open are held, so memory stays bounded by the width of the clutter rather
+    than by the length of the scan. Labels of finished or merged blobs are recycled.
+*/
+class SegmentLabeller {
+public:
+    /** Container of finished blobs. The caller takes ownership of each SegmentList.
+     */
+    using BlobVector = std::vector<SegmentList*>;
+
+    /** Constructor.
+
+        \param maxSpan largest number of PRIs a blob may cover. A blob that grows past this (such as a ring of
+        clutter at constant range) is returned at once, and its segments no longer connect to later PRIs.
+    */
+    explicit SegmentLabeller(size_t maxSpan = 0);
+
+    /** Destructor. Deletes any open blobs.
+     */
+    ~SegmentLabeller();
+
+    /** Forget all open blobs and the previous PRI.
+     */
+    void reset();
+
+    /** Change the largest number of PRIs a blob may cover. Zero disables the limit.
+
+        \param maxSpan new limit
+    */
+    void setMaxSpan(size_t maxSpan) { maxSpan_ = maxSpan; }
+
+    /** Process the segments of the next PRI. Segments need not be sorted.
+
+        \param pri segments of one PRI
+
+        \param done container to receive blobs that were completed by this PRI
+    */
+    void add(const SegmentList& pri, BlobVector& done);
+
+    /** Finish all open blobs, as at the end of the data.
+
+        \param done container to receive the blobs
+    */
+    void flush(BlobVector& done);
+
+    /** Obtain the number of blobs that are still open.
+
+        \return blob count
+    */
+    size_t getOpenCount() const { return forest_.getOpenCount(); }
+
+    /** Obtain the number of labels allocated, both in use and free. This is the high-water mark of blobs
+        that were open at the same time.
+
+        \return label count
+    */
+    size_t getLabelCount() const { return forest_.getLabelCount(); }
+
+private:
+    using Label = Utils::LabelForest::Label;
+
+    Label unite(Label a, Label b);
+
+    Label allocate();
+
+    void attach(Label label, const Segment& segment);
+
+    Utils::LabelForest forest_;
+    std::vector<SegmentList*> lists_;
+
+    SegmentList::Container previous_;
+    SegmentList::Container current_;
+    std::vector<Label> previousLabels_;
+    std::vector<Label> currentLabels_;
+
+    size_t maxSpan_;
+};
+
+} // end namespace Messages
+} // end namespace SideCar
+
+/** \file
+ */
+
+#endif
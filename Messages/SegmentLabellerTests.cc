@@ -0,0 +1,126 @@
+#include <memory>
+
+#include "Logger/Log.h"
+#include "UnitTest/UnitTest.h"
+
+#include "SegmentLabeller.h"
+
+using namespace SideCar;
+using namespace SideCar::Messages;
+
+struct Test : public UnitTest::TestObj {
+    Test() : TestObj("SegmentLabeller") {}
+
+    void test();
+};
+
+/** Build the run-length encoding of one row of a picture, where '#' marks a set gate.
+ */
+static SegmentList
+Row(size_t azimuth, const char* row)
+{
+    std::vector<char> gates;
+    for (; *row; ++row) gates.push_back(*row == '#');
+    Utils::BitVector bits;
+    bits.assign(gates.data(), gates.data() + gates.size());
+    SegmentList list;
+    list.merge(azimuth, bits);
+    return list;
+}
+
+void
+Test::test()
+{
+    // Run-length encoding finds runs that cross word boundaries and end at the last gate.
+    //
+    {
+        std::vector<char> gates(130, 0);
+        for (size_t index = 60; index < 70; ++index) gates[index] = 1;
+        gates[0] = 1;
+        gates[128] = gates[129] = 1;
+        Utils::BitVector bits;
+        bits.assign(gates.data(), gates.data() + gates.size());
+        SegmentList list;
+        list.merge(7, bits);
+        assertEqual(size_t(3), list.size());
+        assertTrue(list.data()[0] == Segment(7, 0, 0));
+        assertTrue(list.data()[1] == Segment(7, 60, 69));
+        assertTrue(list.data()[2] == Segment(7, 128, 129));
+        assertEqual(size_t(13), list.getCellCount());
+    }
+
+    // A "U" shape starts as two blobs that join on the last row. The diagonal blob on the right is a separate
+    // object that touches only at corners.
+    //
+    const char* picture[] = {
+        "##...##.....#...",
+        "##...##......#..",
+        ".#...#........#.",
+        ".#####..........",
+        "................",
+    };
+
+    SegmentLabeller labeller;
+    SegmentLabeller::BlobVector done;
+    for (size_t row = 0; row < 3; ++row) {
+        labeller.add(Row(row, picture[row]), done);
+        assertTrue(done.empty());
+    }
+
+    assertEqual(size_t(3), labeller.getOpenCount());
+
+    // The diagonal blob ends on row 3, when the two arms of the "U" join.
+    //
+    labeller.add(Row(3, picture[3]), done);
+    assertEqual(size_t(1), done.size());
+    std::unique_ptr<SegmentList> diagonal(done[0]);
+    assertEqual(size_t(3), diagonal->getCellCount());
+    assertEqual(size_t(3), diagonal->PRISpan());
+    assertEqual(size_t(1), labeller.getOpenCount());
+
+    // The "U" ends on row 4.
+    //
+    done.clear();
+    labeller.add(Row(4, picture[4]), done);
+    assertEqual(size_t(1), done.size());
+    std::unique_ptr<SegmentList> shape(done[0]);
+    assertEqual(size_t(7), shape->size());
+    assertEqual(size_t(15), shape->getCellCount());
+    assertEqual(size_t(4), shape->PRISpan());
+    assertEqual(size_t(0), labeller.getOpenCount());
+
+    // Labels are recycled, so a long run of separate blobs does not grow the label table.
+    //
+    done.clear();
+    for (size_t row = 0; row < 1000; ++row) {
+        labeller.add(Row(row, (row % 2) ? "#.#.#.#." : "........"), done);
+        for (auto list : done) delete list;
+        done.clear();
+    }
+
+    assertTrue(labeller.getLabelCount() <= 8);
+
+    // A blob that covers more than the span limit is returned as soon as it passes the limit, and does not
+    // capture the gates that follow it.
+    //
+    labeller.reset();
+    labeller.setMaxSpan(3);
+    for (size_t row = 0; row < 4; ++row) labeller.add(Row(row, "..##.."), done);
+    assertEqual(size_t(1), done.size());
+    assertEqual(size_t(4), done[0]->PRISpan());
+    delete done[0];
+    done.clear();
+
+    labeller.add(Row(4, "..##.."), done);
+    assertTrue(done.empty());
+    labeller.flush(done);
+    assertEqual(size_t(1), done.size());
+    assertEqual(size_t(1), done[0]->PRISpan());
+    delete done[0];
+}
+
+int
+main(int, const char**)
+{
+    return Test().mainRun();
+}
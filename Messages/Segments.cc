@@ -5,6 +5,27 @@ using namespace SideCar::Messages;
 
 // SegmentList
 //
+void
+SegmentList::merge(size_t azimuth, const Utils::BitVector& bits)
+{
+    bits.forEachRun([&](size_t start, size_t stop) { merge(Segment(azimuth, start, stop)); });
+}
+
+void
+SegmentList::pop(const SegmentList& other)
+{
+    if (other.empty()) return;
+
+    Container sorted(other.segments);
+    std::sort(sorted.begin(), sorted.end());
+    Container::iterator end = std::remove_if(segments.begin(), segments.end(), [&](const Segment& s) {
+        return std::binary_search(sorted.begin(), sorted.end(), s);
+    });
+
+    for (Container::const_iterator pos = end; pos != segments.end(); ++pos) cellCount -= pos->stop - pos->start + 1;
+    segments.erase(end, segments.end());
+}
+
 ACE_InputCDR&
 SegmentList::load(ACE_InputCDR& cdr)
 {
@@ -12,22 +33,21 @@ SegmentList::load(ACE_InputCDR& cdr)
     uint32_t tmp1;
     cdr >> tmp1;
     span = tmp1;
-    cdr >> tmp1;
-    numSegments = tmp1;
+    uint32_t count;
+    cdr >> count;
 
     // read in the segments
     cellCount = 0;
-    size_t tmp = numSegments;
+    segments.reserve(segments.size() + count);
     Segment s;
-    while (tmp--) {
+    while (count--) {
         cdr >> tmp1;
         s.azimuth = tmp1;
         cdr >> tmp1;
         s.start = tmp1;
         cdr >> tmp1;
         s.stop = tmp1;
-        segments.push_back(s);
-        cellCount += s.stop - s.start + 1;
+        merge(s);
     }
 
     return cdr;
@@ -38,15 +58,13 @@ SegmentList::write(ACE_OutputCDR& cdr) const
 {
     // write out the header info
     cdr << uint32_t(span);
-    cdr << uint32_t(numSegments);
+    cdr << uint32_t(segments.size());
 
     // write out the segments
-    std::list<Segment>::const_iterator s;
-    std::list<Segment>::const_iterator stop = segments.end();
-    for (s = segments.begin(); s != stop; s++) {
-        cdr << uint32_t(s->azimuth);
-        cdr << uint32_t(s->start);
-        cdr << uint32_t(s->stop);
+    for (const auto& s : segments) {
+        cdr << uint32_t(s.azimuth);
+        cdr << uint32_t(s.start);
+        cdr << uint32_t(s.stop);
     }
 
     return cdr;
@@ -55,12 +73,9 @@ SegmentList::write(ACE_OutputCDR& cdr) const
 std::ostream&
 SegmentList::print(std::ostream& os) const
 {
-    os << "Span: " << span << endl << "Segment count: " << numSegments << endl;
-
-    std::list<Segment>::const_iterator s;
-    std::list<Segment>::const_iterator stop = segments.end();
-    for (s = segments.begin(); s != stop; s++) {
-        os << "segment(az=" << s->azimuth << ", start=" << s->start << ", stop=" << s->stop << ")" << endl;
+    os << "Span: " << span << endl << "Segment count: " << segments.size() << endl;
+    for (const auto& s : segments) {
+        os << "segment(az=" << s.azimuth << ", start=" << s.start << ", stop=" << s.stop << ")" << endl;
     }
 
     return os;
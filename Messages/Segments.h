@@ -5,10 +5,13 @@
 #include "IO/Printable.h"
 #include "Messages/Header.h"
 #include "MetaTypeInfo.h"
+#include "Utils/BitVector.h"
 
 #include "boost/shared_ptr.hpp"
 
-#include <list>
+#include <algorithm>
+#include <limits>
+#include <vector>
 
 namespace SideCar {
 namespace Messages {
@@ -29,6 +32,13 @@ public:
         return azimuth == rhs.azimuth && start == rhs.start && stop == rhs.stop;
     }
 
+    bool operator<(const Segment& rhs) const
+    {
+        if (azimuth != rhs.azimuth) return azimuth < rhs.azimuth;
+        if (start != rhs.start) return start < rhs.start;
+        return stop < rhs.stop;
+    }
+
     /// azimuth index
     size_t azimuth;
     /// minimum range index
@@ -38,21 +48,24 @@ public:
 };
 
 /**
-   Store a bunch of segments and maintain info about their distribution.
+   Store a bunch of segments and maintain info about their distribution. Segments are held in one contiguous
+   array, so walking them touches sequential memory and appending rarely allocates.
 */
 class SegmentList {
 private:
     using VideoT = int16_t;
 
 public:
-    SegmentList() : numSegments(0), span(0), cellCount(0), peakPower(std::numeric_limits<VideoT>::min()) {}
+    using Container = std::vector<Segment>;
+    using const_iterator = Container::const_iterator;
+
+    SegmentList() : segments(), span(0), cellCount(0), peakPower(std::numeric_limits<VideoT>::min()) {}
 
     // takes all segments from the other object -- assumes they share a common depth
     void merge(SegmentList& other)
     {
-        segments.splice(segments.end(), other.segments);
-        numSegments += other.numSegments;
-        other.numSegments = 0;
+        segments.insert(segments.end(), other.segments.begin(), other.segments.end());
+        other.segments.clear();
 
         if (other.span > span) span = other.span;
 
@@ -64,37 +77,46 @@ public:
     void merge(const Segment& s)
     {
         segments.push_back(s);
-        numSegments++;
         cellCount += s.stop - s.start + 1;
         // boundingBox.addX(s.azimuth()); // problems with 2pi wrap
         // boundingBox.widenY(s);
     }
 
-    void pop(const SegmentList& other)
-    {
-        std::list<Segment>::const_iterator index;
-        std::list<Segment>::const_iterator stop = other.segments.end();
-        for (index = other.segments.begin(); index != stop; index++) { pop(*index); }
-    }
+    /** Append one segment for each run of set bits. Runs are found a word at a time, so long stretches of empty
+        or full gates cost one operation per 64 gates.
+
+        \param azimuth azimuth index for the new segments
+
+        \param bits gate values to encode
+    */
+    void merge(size_t azimuth, const Utils::BitVector& bits);
+
+    /** Remove all segments that appear in another list.
+
+        \param other segments to remove
+    */
+    void pop(const SegmentList& other);
 
     void pop(const Segment& s)
     {
-        std::list<Segment>::iterator index;
-        std::list<Segment>::const_iterator stop = segments.end();
-        for (index = segments.begin(); index != stop; /* inc in loop */) {
-            if (s == *index) {
-                index = segments.erase(index);
-            } else {
-                index++;
-            }
+        Container::iterator end = std::remove(segments.begin(), segments.end(), s);
+        for (Container::const_iterator pos = end; pos != segments.end(); ++pos) {
+            cellCount -= pos->stop - pos->start + 1;
         }
+
+        segments.erase(end, segments.end());
     }
 
+    void reserve(size_t size) { segments.reserve(size); }
+
     inline size_t PRISpan() const { return span; }
     inline void setPRISpan(size_t x) { span = x; }
 
-    // what's the best way to expose the list?
-    const std::list<Segment>& data() { return segments; }
+    const Container& data() const { return segments; }
+
+    size_t size() const { return segments.size(); }
+
+    bool empty() const { return segments.empty(); }
 
     /// Return the number of cells in this list
     size_t getCellCount() const { return cellCount; }
@@ -106,8 +128,7 @@ public:
 private:
     // Primary data (stored to disk)
     //
-    size_t numSegments; // so we don't have to traverse the list to find out
-    std::list<Segment> segments;
+    Container segments;
     size_t span; // number of azimuth angles spanned by this list
     // Derived data (not stored to disk?)
     //
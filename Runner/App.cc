@@ -1,7 +1,6 @@
 #ifdef linux
 
 #include <fstream>
-#include <sstream>
 
 #else
 
@@ -13,7 +12,9 @@
 
 #endif
 
+#include <chrono>
 #include <signal.h>
+#include <sstream>
 #include <sys/types.h>
 #include <unistd.h>
 
@@ -29,12 +30,15 @@
 #include "IO/Stream.h"
 #include "IO/StreamStatus.h"
 #include "Logger/ConfiguratorFile.h"
+#include "Messages/Header.h"
 #include "Utils/Format.h"
+#include "Utils/StartupTrace.h"
 #include "Utils/Utils.h"
 #include "XMLRPC/XmlRpcValue.h"
 
 #include "App.h"
 #include "LogCollector.h"
+#include "ReconfigurePlan.h"
 #include "RemoteController.h"
 #include "RunnerStatus.h"
 #include "StatusEmitter.h"
@@ -49,9 +53,14 @@ using namespace SideCar::Runner;
 
 const std::string about = "SideCar application that creates and manages one or more processing streams.";
 
-const Utils::CmdLineArgs::OptionDef options[] = {{'d', "debug", "turn on verbose debugging", 0},
-                                                 {'L', "logger", "use LOG for logging configuration", "LOG"},
-                                                 {'Q', "daq", "setup for data acquisition mode", 0}};
+const Utils::CmdLineArgs::OptionDef options[] = {
+    {'C', "snapshot", "restore configuration from PATH if still current, and save it there after startup", "PATH"},
+    {'d', "debug", "turn on verbose debugging", 0},
+    {'j', "jobs", "build up to N streams at once (default 1)", "N"},
+    {'L', "logger", "use LOG for logging configuration", "LOG"},
+    {'Q', "daq", "setup for data acquisition mode", 0},
+    {'S', "synclog", "write log messages in the posting thread", 0},
+    {'T', "trace", "trace every Nth message through the pipeline", "N"}};
 
 const Utils::CmdLineArgs::ArgumentDef args[] = {{"NAME", "Runner to startup"}, {"CONFIG", "Configuration file"}};
 
@@ -80,7 +89,9 @@ quit(int sig)
 
 App::App(int argc, char* const* argv) :
     cla_(argc, argv, about, options, sizeof(options), args, sizeof(args)), logCollector_(LogCollector::Make()),
-    loggerConfig_(), streams_(), remoteController_(), statusEmitter_(), loader_(), runnerConfig_()
+    loggerConfig_(), streams_(), streamConfigs_(), streamsMutex_(Threading::Mutex::Make()),
+    reconfigureMutex_(Threading::Mutex::Make()), processingState_(IO::ProcessingState::kInvalid), recordingPath_(),
+    reconfigureStats_(), jobs_(1), remoteController_(), statusEmitter_(), loader_(), runnerConfig_()
 {
     Logger::Log::Root().addWriter(logCollector_);
     Logger::ProcLog log("App", Log());
@@ -98,6 +109,21 @@ stackPrefault()
     memset(&dummy, 0, sizeof(dummy));
 }
 
+/** Give each stream definition without a name attribute the name its stream gets from its position.
+
+    \param configs stream definitions to update
+*/
+static void
+NameStreams(QList<QDomElement>& configs)
+{
+    for (int index = 0; index < configs.size(); ++index) {
+        if (!configs[index].hasAttribute("name")) {
+            std::string name(StreamBuilder::GetStreamName(configs[index], index));
+            configs[index].setAttribute("name", QString::fromStdString(name));
+        }
+    }
+}
+
 void
 App::initializeRealTime(const QString& scheduler)
 {
@@ -156,6 +182,8 @@ App::initialize()
     Logger::ProcLog log("initialize", Log());
     LOGINFO << std::endl;
 
+    Utils::StartupTrace::Instance().reset();
+
     // Process command line parameters
     //
     std::string name(cla_.arg(0));
@@ -178,13 +206,58 @@ App::initialize()
         loggerConfig_->startMonitor(10);
     }
 
-    // Load XML configuration file
+    // Unless told otherwise, hand log messages to a background thread so that writing them never stalls the
+    // algorithm and IO threads.
     //
-    if (!loader_.load(QString::fromStdString(cla_.arg(1)))) {
-        Utils::Exception ex("failed to load file ");
-        ex << cla_.arg(1);
-        ex << " - " << loader_.getLastLoadResult();
-        log.thrower(ex);
+    if (!cla_.hasOpt("synclog")) Logger::Log::SetAsynchronous(true);
+
+    // Enable sampled pipeline tracing. Traced messages carry a trace ID to downstream runners, and every task
+    // that sees one reports its arrival time in its status.
+    //
+    if (cla_.hasOpt("trace", value)) {
+        int period = 0;
+        if (!(std::istringstream(value) >> period) || period < 0) {
+            Utils::Exception ex("invalid trace period - ");
+            ex << value;
+            log.thrower(ex);
+        }
+        Messages::Header::SetTraceSamplingPeriod(period);
+        LOGWARNING << "tracing every " << period << " messages" << std::endl;
+    }
+
+    // Number of streams to build at once. Streams share nothing, but algorithms may not expect their startup()
+    // to run alongside that of others, so building in parallel is opt-in.
+    //
+    if (cla_.hasOpt("jobs", value)) {
+        int count = 0;
+        if (!(std::istringstream(value) >> count) || count < 1) {
+            Utils::Exception ex("invalid jobs count - ");
+            ex << value;
+            log.thrower(ex);
+        }
+        jobs_ = count;
+    }
+
+    // Load XML configuration file. If given a snapshot path, first try to restore the configuration from a
+    // snapshot saved by an earlier startup, which skips parsing the configuration file and its include files.
+    //
+    QString configurationPath(QString::fromStdString(cla_.arg(1)));
+    QString snapshotPath;
+    if (cla_.hasOpt("snapshot", value)) snapshotPath = QString::fromStdString(value);
+
+    bool fromSnapshot = false;
+    {
+        Utils::StartupTrace::Scope trace("config", cla_.arg(1));
+        if (!snapshotPath.isEmpty()) {
+            fromSnapshot = loader_.loadSnapshot(configurationPath, QString::fromStdString(name), snapshotPath);
+        }
+
+        if (!fromSnapshot && !loader_.load(configurationPath)) {
+            Utils::Exception ex("failed to load file ");
+            ex << cla_.arg(1);
+            ex << " - " << loader_.getLastLoadResult();
+            log.thrower(ex);
+        }
     }
 
     // Get XML configuration info for Runner thread
@@ -196,10 +269,17 @@ App::initialize()
         log.thrower(ex);
     }
 
+    // Start loading algorithm DLLs while we finish setting up the process.
+    //
+    StreamBuilder::PreloadAlgorithms(runnerConfig_->getStreamNodes());
+
     // If Scheduler is specified as an RT scheduler (FIFO or RR) attempt to configure the scheduler
     //
     QString scheduler = runnerConfig_->getScheduler();
-    if (scheduler != "SCHED_INHERIT") { initializeRealTime(scheduler); }
+    if (scheduler != "SCHED_INHERIT") {
+        Utils::StartupTrace::Scope trace("runner", "realtime");
+        initializeRealTime(scheduler);
+    }
 
     struct sigaction action;
 
@@ -227,18 +307,41 @@ App::initialize()
     statusEmitter_->open(THR_INHERIT_SCHED, 0);
 
     std::string multicastAddress = runnerConfig_->getMulticastAddress().toStdString();
-    foreach (QDomElement stream, runnerConfig_->getStreamNodes()) {
-        streams_.push_back(StreamBuilder::Make(stream, statusEmitter_, multicastAddress));
+    std::vector<IO::Stream::Ref> streams(
+        StreamBuilder::MakeAll(runnerConfig_->getStreamNodes(), statusEmitter_, multicastAddress, jobs_));
+
+    // The configuration just built every stream, so it is safe to reuse on the next startup.
+    //
+    if (!snapshotPath.isEmpty() && !fromSnapshot) {
+        if (!loader_.saveSnapshot(QString::fromStdString(name), snapshotPath)) {
+            LOGERROR << "failed to save configuration snapshot " << snapshotPath.toStdString() << std::endl;
+        }
+    }
+
+    // Keep the stream definitions for reconfigure(), named as the streams are so that they pair up with the
+    // definitions of the next configuration no matter where those appear.
+    //
+    QList<QDomElement> configs(runnerConfig_->getStreamNodes());
+    NameStreams(configs);
+    {
+        Threading::Locker lock(streamsMutex_);
+        streams_.insert(streams_.end(), streams.begin(), streams.end());
+        streamConfigs_ = configs;
     }
 
+    // Report where the startup time went.
+    //
+    std::ostringstream report;
+    Utils::StartupTrace::Instance().report(report);
+    LOGWARNING << (fromSnapshot ? "configuration from snapshot - " : "") << report.str() << std::endl;
+
 #ifdef linux
     std::ostringstream os;
     os << "/proc/" << ::getpid() << "/statm";
     statmPath_ = os.str();
 #endif
-    postControlMessage(IO::ProcessingStateChangeRequest(
-                           IO::ProcessingState::GetValue(runnerConfig_->getInitialProcessingState().toStdString()))
-                           .getWrapped());
+    processingStateChange(
+        IO::ProcessingState::GetValue(runnerConfig_->getInitialProcessingState().toStdString()));
 }
 
 App::~App()
@@ -261,8 +364,19 @@ App::run()
 
     remoteController_->stop();
 
-    for (auto v : streams_) v->close();
-    streams_.clear();
+    // Wait for any reconfigure() in progress, and keep another from starting.
+    //
+    Threading::Locker reconfigureLock(reconfigureMutex_);
+    std::vector<IO::Stream::Ref> streams;
+    {
+        Threading::Locker lock(streamsMutex_);
+        streams.swap(streams_);
+        streamConfigs_.clear();
+    }
+
+    for (auto v : streams) v->close();
+
+    Logger::Log::SetAsynchronous(false);
 }
 
 void
@@ -285,7 +399,12 @@ App::recordingStateChange(const std::string& dirPath)
 {
     Logger::ProcLog log("recordingStateChange", Log());
     LOGINFO << dirPath << std::endl;
-    postControlMessage(IO::RecordingStateChangeRequest(dirPath).getWrapped());
+    {
+        Threading::Locker lock(streamsMutex_);
+        recordingPath_ = dirPath;
+        post(streams_, IO::RecordingStateChangeRequest(dirPath).getWrapped());
+    }
+
     statusEmitter_->emitStatus();
 }
 
@@ -297,16 +416,33 @@ App::clearStats()
     postControlMessage(IO::ClearStatsRequest().getWrapped());
 }
 
+void
+App::processingStateChange(IO::ProcessingState::Value state)
+{
+    Logger::ProcLog log("processingStateChange", Log());
+    LOGINFO << IO::ProcessingState::GetName(state) << std::endl;
+    Threading::Locker lock(streamsMutex_);
+    processingState_ = state;
+    post(streams_, IO::ProcessingStateChangeRequest(state).getWrapped());
+}
+
 void
 App::postControlMessage(ACE_Message_Block* data)
+{
+    Threading::Locker lock(streamsMutex_);
+    post(streams_, data);
+}
+
+void
+App::post(const std::vector<IO::Stream::Ref>& streams, ACE_Message_Block* data) const
 {
     Logger::ProcLog log("put", Log());
     LOGINFO << data->msg_type() << ' ' << data->size() << std::endl;
 
-    for (size_t index = 0; index < streams_.size(); ++index) {
+    for (size_t index = 0; index < streams.size(); ++index) {
         std::unique_ptr<ACE_Message_Block> tmp(data->duplicate());
-        if (streams_[index]->put(tmp.get()) == -1) {
-            LOGERROR << "failed to post message to stream " << streams_[index]->getName() << std::endl;
+        if (streams[index]->put(tmp.get()) == -1) {
+            LOGERROR << "failed to post message to stream " << streams[index]->getName() << std::endl;
         } else {
             tmp.release();
         }
@@ -315,17 +451,247 @@ App::postControlMessage(ACE_Message_Block* data)
     data->release();
 }
 
+bool
+App::reconfigure(const std::string& path, std::string& error)
+{
+    Logger::ProcLog log("reconfigure", Log());
+    LOGWARNING << "path: " << path << std::endl;
+
+    // Only one reconfiguration at a time.
+    //
+    Threading::Locker reconfigureLock(reconfigureMutex_);
+    std::chrono::steady_clock::time_point start(std::chrono::steady_clock::now());
+
+    // Leave the process-wide RadarConfig alone, since running tasks read it without any locking. A change to the
+    // <radar> definition requires a restart.
+    //
+    std::string configurationPath(path.empty() ? cla_.arg(1) : path);
+    Configuration::Loader loader;
+    if (!loader.load(QString::fromStdString(configurationPath), false)) {
+        std::ostringstream os;
+        os << "failed to load file " << configurationPath << " - " << loader.getLastLoadResult();
+        error = os.str();
+        LOGERROR << error << std::endl;
+        return false;
+    }
+
+    if (loader.getRadarDefinition() != loader_.getRadarDefinition()) {
+        error = "the <radar> definition changed - restart the runner to apply it";
+        LOGERROR << error << std::endl;
+        return false;
+    }
+
+    std::unique_ptr<Configuration::RunnerConfig> runnerConfig(
+        loader.getRunnerConfig(QString::fromStdString(cla_.arg(0))));
+    if (!runnerConfig) {
+        error = "failed to locate runner " + cla_.arg(0) + " in configuration file";
+        LOGERROR << error << std::endl;
+        return false;
+    }
+
+    QList<QDomElement> next(runnerConfig->getStreamNodes());
+    NameStreams(next);
+
+    std::vector<IO::Stream::Ref> live;
+    QList<QDomElement> liveConfigs;
+    {
+        Threading::Locker lock(streamsMutex_);
+        live = streams_;
+        liveConfigs = streamConfigs_;
+    }
+
+    ReconfigurePlan plan(liveConfigs, next);
+    StreamBuilder::PreloadAlgorithms(next);
+
+    std::vector<IO::Stream::Ref> closing;
+    QList<QDomElement> building;
+    std::vector<IO::Stream::Ref> streams;
+    QList<QDomElement> configs;
+    std::vector<bool> kept(live.size(), false);
+    for (const auto& entry : plan.getEntries()) {
+        switch (entry.action) {
+        case ReconfigurePlan::kKeep:
+        case ReconfigurePlan::kUpdate:
+            kept[entry.liveIndex] = true;
+            streams.push_back(live[entry.liveIndex]);
+            configs.append(entry.config);
+            break;
+
+        case ReconfigurePlan::kReplace:
+            closing.push_back(live[entry.liveIndex]);
+            building.append(entry.config);
+            break;
+
+        case ReconfigurePlan::kAdd: building.append(entry.config); break;
+
+        case ReconfigurePlan::kRemove: closing.push_back(live[entry.liveIndex]); break;
+        }
+    }
+
+    // Take the streams going away out of service so that control messages and status requests no longer reach
+    // them, then close them outside of the lock. They close before their replacements exist, since those use the
+    // same publisher names and ports. Closing lets each task finish the message in hand, so the switch to a
+    // replacement stream happens between messages.
+    //
+    if (!closing.empty()) {
+        Threading::Locker lock(streamsMutex_);
+        streams_ = streams;
+        streamConfigs_ = configs;
+    }
+
+    std::chrono::steady_clock::time_point down(std::chrono::steady_clock::now());
+    for (auto stream : closing) stream->close();
+
+    std::string multicastAddress(runnerConfig->getMulticastAddress().toStdString());
+    std::vector<IO::Stream::Ref> built;
+    if (!building.empty()) {
+        try {
+            built = StreamBuilder::MakeAll(building, statusEmitter_, multicastAddress, jobs_);
+        } catch (const std::exception& ex) {
+            error = ex.what();
+            LOGERROR << "failed to build streams - " << error << std::endl;
+        }
+    }
+
+    if (!error.empty()) {
+        restore(live, liveConfigs, kept, error);
+        statusEmitter_->emitStatus();
+        return false;
+    }
+
+    // Hand new parameter values to the tasks of streams that otherwise stay as they are. Streams whose
+    // definitions are the same keep running untouched.
+    //
+    for (const auto& entry : plan.getEntries()) {
+        if (entry.action != ReconfigurePlan::kUpdate) continue;
+        for (const auto& change : entry.changes) {
+            IO::Task::Ref task(live[entry.liveIndex]->getTask(change.first));
+            if (!task || !EnqueueParameters(task, change.second, true)) {
+                LOGERROR << "failed to change parameters of task " << change.first << " of stream " << entry.name
+                         << std::endl;
+            }
+        }
+    }
+
+    // Install the new streams in the order of the new configuration, and bring them to the state of the others.
+    //
+    if (!built.empty()) {
+        streams.clear();
+        configs.clear();
+        size_t builtIndex = 0;
+        for (const auto& entry : plan.getEntries()) {
+            if (entry.action == ReconfigurePlan::kRemove) continue;
+            if (entry.action == ReconfigurePlan::kKeep || entry.action == ReconfigurePlan::kUpdate) {
+                streams.push_back(live[entry.liveIndex]);
+            } else {
+                streams.push_back(built[builtIndex++]);
+            }
+            configs.append(entry.config);
+        }
+    }
+
+    std::chrono::steady_clock::time_point end(std::chrono::steady_clock::now());
+    {
+        Threading::Locker lock(streamsMutex_);
+        streams_ = streams;
+        streamConfigs_ = configs;
+
+        // Keep the service name the runner advertises, which may differ from the configured one after a name
+        // conflict.
+        //
+        runnerConfig->setServiceName(runnerConfig_->getServiceName());
+        runnerConfig_.swap(runnerConfig);
+        post(built, IO::ProcessingStateChangeRequest(processingState_).getWrapped());
+        if (!recordingPath_.empty()) post(built, IO::RecordingStateChangeRequest(recordingPath_).getWrapped());
+
+        ++reconfigureStats_.count;
+        reconfigureStats_.latency = std::chrono::duration<double>(end - start).count();
+        reconfigureStats_.outage =
+            closing.empty() && building.empty() ? 0.0 : std::chrono::duration<double>(end - down).count();
+        reconfigureStats_.added = plan.getCount(ReconfigurePlan::kAdd);
+        reconfigureStats_.removed = plan.getCount(ReconfigurePlan::kRemove);
+        reconfigureStats_.replaced = plan.getCount(ReconfigurePlan::kReplace);
+        reconfigureStats_.updated = plan.getCount(ReconfigurePlan::kUpdate);
+        LOGWARNING << "added: " << reconfigureStats_.added << " removed: " << reconfigureStats_.removed
+                   << " replaced: " << reconfigureStats_.replaced << " updated: " << reconfigureStats_.updated
+                   << " latency: " << reconfigureStats_.latency << " outage: " << reconfigureStats_.outage
+                   << std::endl;
+    }
+
+    statusEmitter_->emitStatus();
+    return true;
+}
+
+void
+App::restore(const std::vector<IO::Stream::Ref>& live, const QList<QDomElement>& liveConfigs,
+             const std::vector<bool>& kept, std::string& error)
+{
+    Logger::ProcLog log("restore", Log());
+
+    QList<QDomElement> building;
+    for (size_t index = 0; index < live.size(); ++index) {
+        if (!kept[index]) building.append(liveConfigs[index]);
+    }
+
+    std::vector<IO::Stream::Ref> built;
+    if (!building.empty()) {
+        try {
+            built = StreamBuilder::MakeAll(building, statusEmitter_,
+                                           runnerConfig_->getMulticastAddress().toStdString(), jobs_);
+        } catch (const std::exception& ex) {
+            LOGERROR << "failed to rebuild previous streams - " << ex.what() << std::endl;
+            error += std::string(" - failed to rebuild previous streams - ") + ex.what();
+        }
+    }
+
+    // Put everything back in its original order. If the old streams could not be rebuilt, only those that were
+    // never closed remain.
+    //
+    std::vector<IO::Stream::Ref> streams;
+    QList<QDomElement> configs;
+    size_t builtIndex = 0;
+    for (size_t index = 0; index < live.size(); ++index) {
+        if (kept[index]) {
+            streams.push_back(live[index]);
+        } else if (!built.empty()) {
+            streams.push_back(built[builtIndex++]);
+        } else {
+            continue;
+        }
+
+        configs.append(liveConfigs[index]);
+    }
+
+    Threading::Locker lock(streamsMutex_);
+    streams_ = streams;
+    streamConfigs_ = configs;
+    post(built, IO::ProcessingStateChangeRequest(processingState_).getWrapped());
+    if (!recordingPath_.empty()) post(built, IO::RecordingStateChangeRequest(recordingPath_).getWrapped());
+    LOGWARNING << "restored " << built.size() << " of " << building.size() << " streams" << std::endl;
+}
+
 void
 App::fillStatus(XmlRpc::XmlRpcValue& status)
 {
     static Logger::ProcLog log("fillStatus", Log());
-    LOGINFO << streams_.size() << std::endl;
 
     std::unique_ptr<XmlRpc::XmlRpcValue::ValueArray> streamStatusArray(new XmlRpc::XmlRpcValue::ValueArray);
-    for (auto s : streams_) {
-        IO::StreamStatus streamStatus(s->getName());
-        s->fillStatus(streamStatus);
-        streamStatusArray->push_back(streamStatus.getXMLData());
+    XmlRpc::XmlRpcValue reconfiguration;
+    std::unique_ptr<Configuration::RunnerConfig> runnerConfig;
+    {
+        Threading::Locker lock(streamsMutex_);
+        LOGINFO << streams_.size() << std::endl;
+        for (auto s : streams_) {
+            IO::StreamStatus streamStatus(s->getName());
+            s->fillStatus(streamStatus);
+            streamStatusArray->push_back(streamStatus.getXMLData());
+        }
+
+        RunnerStatus::MakeReconfiguration(reconfiguration, reconfigureStats_.count, reconfigureStats_.latency,
+                                          reconfigureStats_.outage, reconfigureStats_.added,
+                                          reconfigureStats_.removed, reconfigureStats_.replaced,
+                                          reconfigureStats_.updated);
+        runnerConfig.reset(new Configuration::RunnerConfig(*runnerConfig_));
     }
 
     double memoryUsed = 0;
@@ -352,14 +718,15 @@ App::fillStatus(XmlRpc::XmlRpcValue& status)
     memoryUsed = t.size_allocated;
 #endif
 
-    RunnerStatus::Make(status, *runnerConfig_, std::move(streamStatusArray), std::move(logCollector_->dump()),
-                       memoryUsed);
+    RunnerStatus::Make(status, *runnerConfig, std::move(streamStatusArray), std::move(logCollector_->dump()),
+                       memoryUsed, reconfiguration);
 }
 
 void
 App::getChangedParameters(XmlRpc::XmlRpcValue& value) const
 {
     static Logger::ProcLog log("getChangedParameters", Log());
+    Threading::Locker lock(streamsMutex_);
     LOGINFO << "size: " << streams_.size() << std::endl;
     value.setSize(streams_.size());
     for (size_t index = 0; index < streams_.size(); ++index) {
@@ -377,8 +744,13 @@ App::getParameters(int streamIndex, int taskIndex, XmlRpc::XmlRpcValue& result)
 {
     static Logger::ProcLog log("getParameters", Log());
     LOGINFO << streamIndex << ' ' << taskIndex << std::endl;
-    if (streamIndex < 0 || streamIndex >= int(streams_.size())) return false;
-    IO::Stream::Ref stream(streams_[streamIndex]);
+    IO::Stream::Ref stream;
+    {
+        Threading::Locker lock(streamsMutex_);
+        if (streamIndex < 0 || streamIndex >= int(streams_.size())) return false;
+        stream = streams_[streamIndex];
+    }
+
     IO::Task::Ref task(stream->getTask(taskIndex));
     if (!task) return false;
     LOGDEBUG << "task: " << task->getTaskName() << std::endl;
@@ -392,10 +764,23 @@ App::setParameters(int streamIndex, int taskIndex, const XmlRpc::XmlRpcValue& pa
     static Logger::ProcLog log("setParameters", Log());
     LOGINFO << streamIndex << ' ' << taskIndex << std::endl;
 
-    IO::Stream::Ref stream(streams_[streamIndex]);
+    IO::Stream::Ref stream;
+    {
+        Threading::Locker lock(streamsMutex_);
+        if (streamIndex < 0 || streamIndex >= int(streams_.size())) return false;
+        stream = streams_[streamIndex];
+    }
+
     IO::Task::Ref task(stream->getTask(taskIndex));
+    if (!task) return false;
     LOGINFO << "task: " << task->getTaskName() << std::endl;
-    IO::ParametersChangeRequest request(params, false);
+    return EnqueueParameters(task, params, false);
+}
+
+bool
+App::EnqueueParameters(const IO::Task::Ref& task, const XmlRpc::XmlRpcValue& params, bool originalValues)
+{
+    IO::ParametersChangeRequest request(params, originalValues);
     ACE_Message_Block* data = request.getWrapped();
 
     // !!! Place the parameter change message at the front of the queue, so that it will take place before other
@@ -414,7 +799,11 @@ App::setServiceName(const std::string& serviceName)
 {
     Logger::ProcLog log("setServiceName", Log());
     LOGWARNING << "new service name: " << serviceName << std::endl;
-    runnerConfig_->setServiceName(QString::fromStdString(serviceName));
+    {
+        Threading::Locker lock(streamsMutex_);
+        runnerConfig_->setServiceName(QString::fromStdString(serviceName));
+    }
+
     if (remoteController_) {
         remoteController_->stop();
         remoteController_->start(runnerConfig_->getServiceName());
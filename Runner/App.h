@@ -6,8 +6,13 @@
 
 #include "boost/shared_ptr.hpp"
 
+#include "QtCore/QList"
+#include "QtXml/QDomElement"
+
 #include "Configuration/Loader.h"
+#include "IO/ProcessingState.h"
 #include "IO/Stream.h"
+#include "Threading/Threading.h"
 
 #include "Utils/CmdLineArgs.h"
 
@@ -75,6 +80,11 @@ class StatusEmitter;
     stream index, and task index. Returns an XML-RPC array with status for
     each stream.
 
+    - reconfigure -- load the configuration file again, or the one given
+    as an optional string parameter, and apply its stream definitions to the
+    running streams without restarting the runner. See reconfigure().
+    Returns true if successful, or a string describing the failure.
+
     - recordingChange -- start/stop data recording for all
     Algorithm::Controller objects enabled to record. Takes one parameter, a
     string that is the path of the directory into which Algorithm::Controller
@@ -189,6 +199,39 @@ public:
     */
     void postControlMessage(ACE_Message_Block* data);
 
+    /** Command all of the tasks to enter a new processing state. Streams created later by reconfigure() start
+        in the same state.
+
+        \param state new processing state
+    */
+    void processingStateChange(IO::ProcessingState::Value state);
+
+    /** Apply a new configuration to the running streams. Pairs the streams of the runner in the new
+        configuration with the running streams by name (see ReconfigurePlan), and then:
+
+        - leaves streams with the same definition running untouched
+        - sends new parameter values to the tasks of streams whose definitions only differ in algorithm <param>
+          values. The changes go to the front of the task queues, so they take effect at the next message.
+        - closes streams no longer in the configuration
+        - closes and rebuilds streams with any other difference. The old stream closes first, since the new
+          one uses the same publisher names and ports; each task finishes the message it is working on, so the
+          switch happens between messages.
+        - builds new streams, in parallel
+
+        Rebuilt and new streams start in the current processing and recording states. If a stream fails to
+        build, nothing changes: the closed streams are rebuilt from their previous definitions, and parameter
+        changes are not sent. The service name and scheduler settings do not change, and a change to the <radar>
+        definition is refused, since running tasks use the RadarConfig values without locking; both require a
+        restart. The time taken shows up in the RunnerStatus reports.
+
+        \param path configuration file to load. If empty, reloads the file given at startup.
+
+        \param error storage for a description of the failure
+
+        \return true if successful
+    */
+    bool reconfigure(const std::string& path, std::string& error);
+
     /** Command all of the tasks to change their recording state if they are enabled for recording. If the given
         path is not empty, then it is a valid directory into which tasks shall write their recordings. If it is
         empty, then any previous recording activity stops.
@@ -201,7 +244,11 @@ public:
 
         \return stream count
     */
-    size_t getStreamCount() const { return streams_.size(); }
+    size_t getStreamCount() const
+    {
+        Threading::Locker lock(streamsMutex_);
+        return streams_.size();
+    }
 
     /** Change the runner's service name. Called when there is a naming conflict with another runner.
 
@@ -212,10 +259,63 @@ public:
 private:
     void initializeRealTime(const QString& scheduler);
 
+    /** Post a control message to some streams. Invoked while holding streamsMutex_.
+
+        \param streams streams to post to
+
+        \param data raw representation of an IO::ControlMessage object
+    */
+    void post(const std::vector<IO::Stream::Ref>& streams, ACE_Message_Block* data) const;
+
+    /** Put back the streams closed by a reconfigure() that failed to build their replacements. Invoked while
+        holding reconfigureMutex_.
+
+        \param live streams that were running before the reconfigure() call
+
+        \param liveConfigs definitions of those streams
+
+        \param kept flags for the streams that were never closed
+
+        \param error description of the failure, extended if the streams cannot be rebuilt either
+    */
+    void restore(const std::vector<IO::Stream::Ref>& live, const QList<QDomElement>& liveConfigs,
+                 const std::vector<bool>& kept, std::string& error);
+
+    /** Place a parameter change message at the front of a task's queue.
+
+        \param task task to change
+
+        \param params XML-RPC array containing parameter names and new values
+
+        \param originalValues true if the values become the ones the parameters revert to
+
+        \return true if successful
+    */
+    static bool EnqueueParameters(const IO::Task::Ref& task, const XmlRpc::XmlRpcValue& params, bool originalValues);
+
+    /** Statistics of the runner's reconfigure() calls.
+     */
+    struct ReconfigureStats {
+        int count;
+        double latency; ///< Seconds from request to completion of the last reconfigure
+        double outage;  ///< Seconds the rebuilt streams of the last reconfigure were out of service
+        int added;
+        int removed;
+        int replaced;
+        int updated;
+    };
+
     Utils::CmdLineArgs cla_;
     boost::shared_ptr<LogCollector> logCollector_;
     std::unique_ptr<Logger::ConfiguratorFile> loggerConfig_;
     std::vector<IO::Stream::Ref> streams_;
+    QList<QDomElement> streamConfigs_;
+    Threading::Mutex::Ref streamsMutex_;
+    Threading::Mutex::Ref reconfigureMutex_;
+    IO::ProcessingState::Value processingState_;
+    std::string recordingPath_;
+    ReconfigureStats reconfigureStats_;
+    size_t jobs_;
     std::unique_ptr<RemoteController> remoteController_;
     boost::shared_ptr<StatusEmitter> statusEmitter_;
     Configuration::Loader loader_;
@@ -0,0 +1,179 @@
+#include "QtXml/QDomAttr"
+#include "QtXml/QDomNamedNodeMap"
+
+#include "Logger/Log.h"
+
+#include "ReconfigurePlan.h"
+#include "StreamBuilder.h"
+
+using namespace SideCar::Runner;
+
+/** Append a canonical text form of an element to a string: its tag, its attributes sorted by name, and its child
+    elements, skipping <param> elements below the top. Attribute order and formatting in the file do not matter.
+
+    \param element element to describe
+
+    \param depth nesting level of the element
+
+    \param text storage for the description
+*/
+static void
+AppendLayout(const QDomElement& element, int depth, QString& text)
+{
+    if (depth > 1 && element.tagName() == "param") return;
+
+    QStringList attributes;
+    QDomNamedNodeMap map(element.attributes());
+    for (int index = 0; index < map.count(); ++index) {
+        QDomAttr attribute(map.item(index).toAttr());
+        attributes.append(attribute.name() + "=\"" + attribute.value() + '"');
+    }
+
+    attributes.sort();
+    text += '<' + element.tagName() + ' ' + attributes.join(" ") + '>';
+
+    QDomElement child = element.firstChildElement();
+    while (!child.isNull()) {
+        AppendLayout(child, depth + 1, text);
+        child = child.nextSiblingElement();
+    }
+
+    text += "</" + element.tagName() + '>';
+}
+
+Logger::Log&
+ReconfigurePlan::Log()
+{
+    static Logger::Log& log_ = Logger::Log::Find("runner.ReconfigurePlan");
+    return log_;
+}
+
+ReconfigurePlan::ReconfigurePlan(const QList<QDomElement>& live, const QList<QDomElement>& next) : entries_()
+{
+    Logger::ProcLog log("ReconfigurePlan", Log());
+
+    std::vector<std::string> liveNames;
+    for (int index = 0; index < live.size(); ++index) {
+        liveNames.push_back(StreamBuilder::GetStreamName(live[index], index));
+    }
+
+    std::vector<bool> matched(live.size(), false);
+    for (int index = 0; index < next.size(); ++index) {
+        Entry entry;
+        entry.action = kAdd;
+        entry.name = StreamBuilder::GetStreamName(next[index], index);
+        entry.liveIndex = -1;
+        entry.config = next[index];
+
+        // Pair with the first unmatched live stream of the same name.
+        //
+        for (size_t liveIndex = 0; liveIndex < liveNames.size(); ++liveIndex) {
+            if (!matched[liveIndex] && liveNames[liveIndex] == entry.name) {
+                matched[liveIndex] = true;
+                entry.liveIndex = liveIndex;
+                break;
+            }
+        }
+
+        if (entry.liveIndex != -1) {
+            const QDomElement& current(live[entry.liveIndex]);
+            if (GetLayout(current) != GetLayout(entry.config) || !CompareParameters(current, entry.config, entry)) {
+                entry.action = kReplace;
+                entry.changes.clear();
+            } else {
+                entry.action = entry.changes.empty() ? kKeep : kUpdate;
+            }
+        }
+
+        LOGINFO << entry.name << " action: " << entry.action << " changes: " << entry.changes.size() << std::endl;
+        entries_.push_back(entry);
+    }
+
+    for (size_t liveIndex = 0; liveIndex < liveNames.size(); ++liveIndex) {
+        if (matched[liveIndex]) continue;
+        Entry entry;
+        entry.action = kRemove;
+        entry.name = liveNames[liveIndex];
+        entry.liveIndex = liveIndex;
+        LOGINFO << entry.name << " action: " << entry.action << std::endl;
+        entries_.push_back(entry);
+    }
+}
+
+size_t
+ReconfigurePlan::getCount(Action action) const
+{
+    size_t count = 0;
+    for (const auto& entry : entries_) {
+        if (entry.action == action) ++count;
+    }
+
+    return count;
+}
+
+QString
+ReconfigurePlan::GetLayout(const QDomElement& config)
+{
+    QString text;
+    AppendLayout(config, 0, text);
+    return text;
+}
+
+QStringList
+ReconfigurePlan::GetParameterKeys(const QDomElement& task)
+{
+    QStringList keys;
+    QDomElement param = task.firstChildElement("param");
+    while (!param.isNull()) {
+        keys.append(param.attribute("name") + ':' + param.attribute("type"));
+        param = param.nextSiblingElement("param");
+    }
+
+    return keys;
+}
+
+QStringList
+ReconfigurePlan::GetParameterSettings(const QDomElement& task)
+{
+    QStringList settings;
+    QDomElement param = task.firstChildElement("param");
+    while (!param.isNull()) {
+        settings.append(param.attribute("name") + ':' + param.attribute("type") + '=' + param.attribute("value"));
+        param = param.nextSiblingElement("param");
+    }
+
+    return settings;
+}
+
+bool
+ReconfigurePlan::CompareParameters(const QDomElement& live, const QDomElement& next, Entry& entry)
+{
+    Logger::ProcLog log("CompareParameters", Log());
+
+    // The layouts match, so the two definitions have the same tasks in the same order, and a task's index in the
+    // definition is its index in the stream.
+    //
+    QDomElement liveTask = live.firstChildElement();
+    QDomElement nextTask = next.firstChildElement();
+    for (int taskIndex = 0; !nextTask.isNull(); ++taskIndex) {
+        if (GetParameterSettings(liveTask) != GetParameterSettings(nextTask)) {
+
+            // Only algorithms take runtime parameters. A parameter that went away would keep its current value
+            // instead of reverting to its default, so a different set of parameters requires a new task.
+            //
+            if (nextTask.tagName() != "algorithm" || GetParameterKeys(liveTask) != GetParameterKeys(nextTask)) {
+                LOGWARNING << entry.name << " task " << taskIndex << " has different parameters" << std::endl;
+                return false;
+            }
+
+            XmlRpc::XmlRpcValue values;
+            StreamBuilder::GetParameterValues(nextTask, values);
+            entry.changes.push_back(TaskChange(taskIndex, values));
+        }
+
+        liveTask = liveTask.nextSiblingElement();
+        nextTask = nextTask.nextSiblingElement();
+    }
+
+    return true;
+}
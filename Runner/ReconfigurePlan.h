@@ -0,0 +1,115 @@
+#ifndef SIDECAR_RUNNER_RECONFIGUREPLAN_H // -*- C++ -*-
+#define SIDECAR_RUNNER_RECONFIGUREPLAN_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "QtCore/QList"
+#include "QtCore/QStringList"
+#include "QtXml/QDomElement"
+
+#include "XMLRPC/XmlRpcValue.h"
+
+namespace Logger {
+class Log;
+}
+
+namespace SideCar {
+namespace Runner {
+
+/** Difference between the stream definitions a runner is running and those of a new configuration. Streams pair
+    up by name. A stream whose tasks, channels, and attributes are the same in both, and whose algorithms have the
+    same <param> names in the same order, keeps running; if only <param> values differ, the changes are applied to
+    its tasks in place. Any other difference replaces the stream with a new one.
+*/
+class ReconfigurePlan {
+public:
+    enum Action {
+        kKeep,    ///< Stream definitions are the same
+        kUpdate,  ///< Only algorithm <param> values differ
+        kReplace, ///< Stream must be rebuilt
+        kAdd,     ///< Stream is new
+        kRemove   ///< Stream is gone
+    };
+
+    /** Parameter changes for the task at a given index in its stream.
+     */
+    using TaskChange = std::pair<int, XmlRpc::XmlRpcValue>;
+
+    struct Entry {
+        Action action;
+        std::string name;
+        int liveIndex;                   ///< Index in the live streams, or -1 if kAdd
+        QDomElement config;              ///< New definition, null if kRemove
+        std::vector<TaskChange> changes; ///< Parameter changes if kUpdate
+    };
+
+    static Logger::Log& Log();
+
+    /** Constructor. Compares two sets of stream definitions. Entries for streams in the new configuration appear
+        in its order, followed by kRemove entries for the streams no longer present.
+
+        \param live definitions of the running streams, each with a name attribute
+
+        \param next definitions from the new configuration
+    */
+    ReconfigurePlan(const QList<QDomElement>& live, const QList<QDomElement>& next);
+
+    const std::vector<Entry>& getEntries() const { return entries_; }
+
+    /** Obtain the number of entries with a given action.
+
+        \param action value to look for
+
+        \return entry count
+    */
+    size_t getCount(Action action) const;
+
+private:
+    /** Obtain the text of a stream definition without the <param> elements of its tasks.
+
+        \param config stream definition
+
+        \return XML text
+    */
+    static QString GetLayout(const QDomElement& config);
+
+    /** Obtain the name and type of each <param> element of a task, in order.
+
+        \param task task definition
+
+        \return list of name and type pairs
+    */
+    static QStringList GetParameterKeys(const QDomElement& task);
+
+    /** Obtain the name, type, and value of each <param> element of a task, in order.
+
+        \param task task definition
+
+        \return list of name, type, and value triples
+    */
+    static QStringList GetParameterSettings(const QDomElement& task);
+
+    /** Compare two definitions of a stream with the same layout, and record the parameter changes of its tasks.
+
+        \param live definition of the running stream
+
+        \param next definition from the new configuration
+
+        \param entry entry to update
+
+        \return false if a task has a different set of <param> elements, which requires a rebuild
+    */
+    static bool CompareParameters(const QDomElement& live, const QDomElement& next, Entry& entry);
+
+    std::vector<Entry> entries_;
+};
+
+} // end namespace Runner
+} // end namespace SideCar
+
+/** \file
+ */
+
+#endif
@@ -0,0 +1,162 @@
+#include "QtXml/QDomDocument"
+
+#include "UnitTest/UnitTest.h"
+
+#include "ReconfigurePlan.h"
+
+using namespace SideCar::Runner;
+
+struct Test : public UnitTest::TestObj {
+    Test() : UnitTest::TestObj("ReconfigurePlan") {}
+    void test();
+};
+
+/** Parse the <stream> elements of a <runner> definition.
+
+    \param doc document to hold the elements
+
+    \param text XML text of the runner definition
+
+    \return stream definitions
+*/
+static QList<QDomElement>
+Streams(QDomDocument& doc, const char* text)
+{
+    QList<QDomElement> streams;
+    if (!doc.setContent(QString(text))) return streams;
+    QDomElement stream = doc.documentElement().firstChildElement("stream");
+    while (!stream.isNull()) {
+        streams.append(stream);
+        stream = stream.nextSiblingElement("stream");
+    }
+
+    return streams;
+}
+
+static const char* const kLive =
+    "<runner>"
+    "<stream name=\"A\"><subscriber name=\"in\" channel=\"x\"/>"
+    "<algorithm name=\"f\" dll=\"F\"><param name=\"gain\" type=\"double\" value=\"1.0\"/></algorithm></stream>"
+    "<stream name=\"B\"><subscriber name=\"in\" channel=\"y\"/>"
+    "<algorithm name=\"g\" dll=\"G\"><param name=\"n\" type=\"int\" value=\"3\"/></algorithm></stream>"
+    "<stream name=\"C\"><subscriber name=\"in\" channel=\"z\"/></stream>"
+    "<stream name=\"D\"><subscriber name=\"in\" channel=\"w\"/></stream>"
+    "</runner>";
+
+void
+Test::test()
+{
+    QDomDocument liveDoc;
+    QList<QDomElement> live(Streams(liveDoc, kLive));
+    assertEqual(4, live.size());
+
+    // Nothing changes when the definitions are the same, even with attributes in another order.
+    //
+    {
+        QDomDocument doc;
+        QList<QDomElement> next(Streams(
+            doc, "<runner>"
+                 "<stream name=\"A\"><subscriber channel=\"x\" name=\"in\"/>"
+                 "<algorithm dll=\"F\" name=\"f\"><param name=\"gain\" type=\"double\" value=\"1.0\"/></algorithm>"
+                 "</stream>"
+                 "<stream name=\"B\"><subscriber name=\"in\" channel=\"y\"/>"
+                 "<algorithm name=\"g\" dll=\"G\"><param name=\"n\" type=\"int\" value=\"3\"/></algorithm></stream>"
+                 "<stream name=\"C\"><subscriber name=\"in\" channel=\"z\"/></stream>"
+                 "<stream name=\"D\"><subscriber name=\"in\" channel=\"w\"/></stream>"
+                 "</runner>"));
+        ReconfigurePlan plan(live, next);
+        assertEqual(size_t(4), plan.getEntries().size());
+        assertEqual(size_t(4), plan.getCount(ReconfigurePlan::kKeep));
+        for (int index = 0; index < 4; ++index) assertEqual(index, plan.getEntries()[index].liveIndex);
+    }
+
+    // A new parameter value is an update, a new channel a replacement, and streams pair up by name wherever they
+    // appear. D is gone and E is new.
+    //
+    {
+        QDomDocument doc;
+        QList<QDomElement> next(Streams(
+            doc, "<runner>"
+                 "<stream name=\"E\"><subscriber name=\"in\" channel=\"v\"/></stream>"
+                 "<stream name=\"C\"><subscriber name=\"in\" channel=\"q\"/></stream>"
+                 "<stream name=\"B\"><subscriber name=\"in\" channel=\"y\"/>"
+                 "<algorithm name=\"g\" dll=\"G\"><param name=\"n\" type=\"int\" value=\"3\"/></algorithm></stream>"
+                 "<stream name=\"A\"><subscriber name=\"in\" channel=\"x\"/>"
+                 "<algorithm name=\"f\" dll=\"F\"><param name=\"gain\" type=\"double\" value=\"2.5\"/></algorithm>"
+                 "</stream>"
+                 "</runner>"));
+        ReconfigurePlan plan(live, next);
+        const std::vector<ReconfigurePlan::Entry>& entries(plan.getEntries());
+        assertEqual(size_t(5), entries.size());
+
+        assertEqual(ReconfigurePlan::kAdd, entries[0].action);
+        assertEqual(std::string("E"), entries[0].name);
+        assertEqual(-1, entries[0].liveIndex);
+
+        assertEqual(ReconfigurePlan::kReplace, entries[1].action);
+        assertEqual(2, entries[1].liveIndex);
+        assertTrue(entries[1].changes.empty());
+
+        assertEqual(ReconfigurePlan::kKeep, entries[2].action);
+        assertEqual(1, entries[2].liveIndex);
+
+        assertEqual(ReconfigurePlan::kUpdate, entries[3].action);
+        assertEqual(0, entries[3].liveIndex);
+        assertEqual(size_t(1), entries[3].changes.size());
+        assertEqual(1, entries[3].changes[0].first);
+        XmlRpc::XmlRpcValue values(entries[3].changes[0].second);
+        assertEqual(2, values.size());
+        assertEqual(std::string("gain"), std::string(values[0]));
+        assertEqual(2.5, double(values[1]));
+
+        assertEqual(ReconfigurePlan::kRemove, entries[4].action);
+        assertEqual(std::string("D"), entries[4].name);
+        assertEqual(3, entries[4].liveIndex);
+        assertTrue(entries[4].config.isNull());
+    }
+
+    // A different set of parameters, or a parameter change in a task that is not an algorithm, requires a new
+    // stream.
+    //
+    {
+        QDomDocument doc;
+        QList<QDomElement> next(Streams(
+            doc, "<runner>"
+                 "<stream name=\"A\"><subscriber name=\"in\" channel=\"x\"/>"
+                 "<algorithm name=\"f\" dll=\"F\"><param name=\"gain\" type=\"double\" value=\"1.0\"/>"
+                 "<param name=\"bias\" type=\"double\" value=\"0.0\"/></algorithm></stream>"
+                 "<stream name=\"B\"><subscriber name=\"in\" channel=\"y\"/>"
+                 "<algorithm name=\"g\" dll=\"G\"><param name=\"n\" type=\"double\" value=\"3\"/></algorithm>"
+                 "</stream>"
+                 "<stream name=\"C\"><subscriber name=\"in\" channel=\"z\">"
+                 "<param name=\"bufferSize\" type=\"int\" value=\"10\"/></subscriber></stream>"
+                 "<stream name=\"D\"><subscriber name=\"in\" channel=\"w\"/></stream>"
+                 "</runner>"));
+        ReconfigurePlan plan(live, next);
+        assertEqual(size_t(3), plan.getCount(ReconfigurePlan::kReplace));
+        assertEqual(size_t(1), plan.getCount(ReconfigurePlan::kKeep));
+        assertEqual(ReconfigurePlan::kKeep, plan.getEntries()[3].action);
+    }
+
+    // Unnamed streams pair up by their position, like the names the runner gives them.
+    //
+    {
+        QDomDocument before;
+        QList<QDomElement> unnamed(
+            Streams(before, "<runner><stream><subscriber name=\"in\" channel=\"x\"/></stream></runner>"));
+        QDomDocument after;
+        QList<QDomElement> next(Streams(after, "<runner><stream><subscriber name=\"in\" channel=\"x\"/></stream>"
+                                               "<stream><subscriber name=\"in\" channel=\"y\"/></stream></runner>"));
+        ReconfigurePlan plan(unnamed, next);
+        assertEqual(size_t(2), plan.getEntries().size());
+        assertEqual(ReconfigurePlan::kKeep, plan.getEntries()[0].action);
+        assertEqual(ReconfigurePlan::kAdd, plan.getEntries()[1].action);
+        assertEqual(std::string("Stream 2"), plan.getEntries()[1].name);
+    }
+}
+
+int
+main(int argc, const char* argv[])
+{
+    return Test().mainRun();
+}
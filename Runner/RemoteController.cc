@@ -1,7 +1,6 @@
 #include "ace/Reactor.h"
 
 #include "IO/ProcessingState.h"
-#include "IO/ProcessingStateChangeRequest.h"
 #include "IO/ShutdownRequest.h"
 
 #include "Logger/Log.h"
@@ -100,6 +99,40 @@ struct GetParameters : public AppMethodBase {
     }
 };
 
+/** App method to apply a new configuration to the running streams.
+ */
+struct Reconfigure : public AppMethodBase {
+    /** Constructor
+
+        \param app the App object to work with
+
+        \param server the server that will execute the method
+    */
+    Reconfigure(App& app, XmlRpc::XmlRpcServer* server) : AppMethodBase(app, server, "reconfigure") {}
+
+    /** Perform the XML-RPC request. Implementation of XmlRpcServerMethod interface.
+
+        \param params arguments to the request. May contain one string
+        value, the path of the configuration file to load. Without it, the
+        runner reloads the file it started with.
+
+        \param result true if successful, or a string describing the failure
+    */
+    void execute(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result)
+    {
+        static Logger::ProcLog log("Reconfigure::execute", RemoteController::Log());
+        std::string path;
+        if (params.getType() == XmlRpc::XmlRpcValue::TypeArray && params.size() > 0) path = std::string(params[0]);
+        LOGWARNING << "path: " << path << std::endl;
+        std::string error;
+        if (app_.reconfigure(path, error)) {
+            result = true;
+        } else {
+            result = error;
+        }
+    }
+};
+
 /** App method to change the recording state for all IO::Task objects.
  */
 struct RecordingChange : public AppMethodBase {
@@ -202,7 +235,7 @@ struct StateChange : public AppMethodBase {
     void execute(XmlRpc::XmlRpcValue& params, XmlRpc::XmlRpcValue& result)
     {
         IO::ProcessingState::Value state = IO::ProcessingState::Value(int(params[0]));
-        app_.postControlMessage(IO::ProcessingStateChangeRequest(state).getWrapped());
+        app_.processingStateChange(state);
         result = true;
     }
 };
@@ -229,6 +262,7 @@ RemoteController::installServices(XmlRpc::XmlRpcServer* server)
     new ClearStats(app_, server);
     new GetChangedParameters(app_, server);
     new GetParameters(app_, server);
+    new Reconfigure(app_, server);
     new RecordingChange(app_, server);
     new SetParameters(app_, server);
     new Shutdown(app_, server);
@@ -10,7 +10,8 @@ using namespace SideCar::Runner;
 void
 RunnerStatus::Make(XmlRpc::XmlRpcValue& status, const RunnerConfig& runnerConfig,
                    std::unique_ptr<XmlRpc::XmlRpcValue::ValueArray> streamStatus,
-                   std::unique_ptr<XmlRpc::XmlRpcValue::ValueArray> logMessages, double memoryUsed)
+                   std::unique_ptr<XmlRpc::XmlRpcValue::ValueArray> logMessages, double memoryUsed,
+                   const XmlRpc::XmlRpcValue& reconfiguration)
 {
     StatusBase::Make(status, kNumSlots, GetClassName(), runnerConfig.getRunnerName().toStdString());
     status[kConfigName] = runnerConfig.getConfigurationName().toStdString();
@@ -20,4 +21,19 @@ RunnerStatus::Make(XmlRpc::XmlRpcValue& status, const RunnerConfig& runnerConfig
     status[kStreamStatus] = streamStatus.release();
     status[kLogMessages] = logMessages.release();
     status[kMemoryUsed] = memoryUsed;
+    status[kReconfiguration] = reconfiguration;
+}
+
+void
+RunnerStatus::MakeReconfiguration(XmlRpc::XmlRpcValue& value, int count, double latency, double outage, int added,
+                                  int removed, int replaced, int updated)
+{
+    value.setSize(7);
+    value[0] = count;
+    value[1] = latency;
+    value[2] = outage;
+    value[3] = added;
+    value[4] = removed;
+    value[5] = replaced;
+    value[6] = updated;
 }
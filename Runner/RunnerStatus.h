@@ -26,6 +26,7 @@ public:
         kStreamStatus,
         kLogMessages,
         kMemoryUsed,
+        kReconfiguration,
         kNumSlots
     };
 
@@ -33,7 +34,29 @@ public:
 
     static void Make(XmlRpc::XmlRpcValue& status, const Configuration::RunnerConfig& runnerConfig,
                      std::unique_ptr<XmlRpc::XmlRpcValue::ValueArray> streamStatus,
-                     std::unique_ptr<XmlRpc::XmlRpcValue::ValueArray> logMessages, double memoryUsed);
+                     std::unique_ptr<XmlRpc::XmlRpcValue::ValueArray> logMessages, double memoryUsed,
+                     const XmlRpc::XmlRpcValue& reconfiguration);
+
+    /** Create the value of the kReconfiguration slot from the statistics of the runner's reconfigurations.
+
+        \param value storage for the result
+
+        \param count number of reconfigurations done
+
+        \param latency seconds taken by the last reconfiguration
+
+        \param outage seconds the streams rebuilt by the last reconfiguration were out of service
+
+        \param added number of streams the last reconfiguration added
+
+        \param removed number of streams the last reconfiguration removed
+
+        \param replaced number of streams the last reconfiguration rebuilt
+
+        \param updated number of streams the last reconfiguration changed parameters of in place
+    */
+    static void MakeReconfiguration(XmlRpc::XmlRpcValue& value, int count, double latency, double outage, int added,
+                                    int removed, int replaced, int updated);
 
     RunnerStatus(const XmlRpc::XmlRpcValue& status) : IO::StatusBase(status) {}
 
@@ -52,6 +75,20 @@ public:
     const XmlRpc::XmlRpcValue& getLogMessages() const { return getSlot(kLogMessages); }
 
     double getMemoryUsed() const { return getSlot(kMemoryUsed); }
+
+    int getReconfigurationCount() const { return getSlot(kReconfiguration)[0]; }
+
+    double getReconfigurationLatency() const { return getSlot(kReconfiguration)[1]; }
+
+    double getReconfigurationOutage() const { return getSlot(kReconfiguration)[2]; }
+
+    int getStreamsAdded() const { return getSlot(kReconfiguration)[3]; }
+
+    int getStreamsRemoved() const { return getSlot(kReconfiguration)[4]; }
+
+    int getStreamsReplaced() const { return getSlot(kReconfiguration)[5]; }
+
+    int getStreamsUpdated() const { return getSlot(kReconfiguration)[6]; }
 };
 
 } // end namespace Runner
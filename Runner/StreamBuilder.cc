@@ -1,6 +1,9 @@
 #include "boost/bind.hpp"
+#include <algorithm>
+#include <atomic>
 #include <unistd.h>
 
+#include "Algorithms/AlgorithmLoader.h"
 #include "Algorithms/Controller.h"
 #include "Algorithms/ShutdownMonitor.h"
 #include "GUI/LogUtils.h"
@@ -11,6 +14,8 @@
 #include "IO/MulticastVMEReaderTask.h"
 #include "IO/ParametersChangeRequest.h"
 #include "IO/ProcessingStateChangeRequest.h"
+#include "IO/SharedMemoryDataPublisher.h"
+#include "IO/SharedMemoryDataSubscriber.h"
 #include "IO/TCPDataPublisher.h"
 #include "IO/TCPDataSubscriber.h"
 #include "IO/TSPIReaderTask.h"
@@ -25,6 +30,8 @@
 
 #include "IO/UDPSocketReaderTask.h"
 #include "IO/UDPSocketWriterTask.h"
+#include "Threading/Threading.h"
+#include "Utils/StartupTrace.h"
 #include "XMLRPC/XmlRpcValue.h"
 
 #include "App.h"
@@ -32,6 +39,7 @@
 #include "StreamBuilder.h"
 
 #include "QtCore/QTextStream" // Needs to be after anything with boost::signal
+#include "QtXml/QDomDocument"
 
 using namespace SideCar;
 using namespace SideCar::Algorithms;
@@ -49,17 +57,150 @@ StreamBuilder::Log()
     return log_;
 }
 
+/** Thread that builds streams for StreamBuilder::MakeAll(). Workers take the next unbuilt stream until there are
+    none left.
+*/
+class StreamBuilder::Worker : public Threading::Thread {
+public:
+    struct Job {
+        QDomElement config;
+        std::string name;
+        IO::Stream::Ref stream;
+        std::string error;
+    };
+
+    Worker(std::vector<Job>& jobs, std::atomic<size_t>& next, const StatusEmitter::Ref& emitter,
+           const std::string& mcastAddress) :
+        Thread(), jobs_(jobs), next_(next), emitter_(emitter), mcastAddress_(mcastAddress)
+    {
+    }
+
+    void run() override
+    {
+        for (size_t index = next_++; index < jobs_.size(); index = next_++) {
+            Job& job(jobs_[index]);
+            try {
+                job.stream = StreamBuilder::Build(job.config, job.name, emitter_, mcastAddress_);
+            } catch (const std::exception& ex) {
+                job.error = ex.what();
+            } catch (...) {
+                job.error = "unknown error";
+            }
+        }
+    }
+
+private:
+    std::vector<Job>& jobs_;
+    std::atomic<size_t>& next_;
+    StatusEmitter::Ref emitter_;
+    std::string mcastAddress_;
+};
+
 IO::Stream::Ref
 StreamBuilder::Make(const QDomElement& stream, const StatusEmitter::Ref& statusEmitter, const std::string& mcastAddress)
 {
-    Logger::ProcLog log("Make", Log());
+    return Build(stream, GetStreamName(stream, App::GetApp()->getStreamCount()), statusEmitter, mcastAddress);
+}
+
+std::vector<IO::Stream::Ref>
+StreamBuilder::MakeAll(const QList<QDomElement>& configs, const StatusEmitter::Ref& statusEmitter,
+                       const std::string& mcastAddress, size_t maxThreads)
+{
+    Logger::ProcLog log("MakeAll", Log());
+    LOGINFO << configs.size() << ' ' << maxThreads << std::endl;
+
+    std::vector<IO::Stream::Ref> streams;
+    size_t first = App::GetApp()->getStreamCount();
+    if (maxThreads < 2 || configs.size() < 2) {
+        try {
+            foreach (QDomElement config, configs) {
+                std::string name(GetStreamName(config, first + streams.size()));
+                streams.push_back(Build(config, name, statusEmitter, mcastAddress));
+            }
+        } catch (...) {
+            // Do not leave the streams built so far running, just as with the parallel build below.
+            //
+            for (auto stream : streams) stream->close();
+            throw;
+        }
+        return streams;
+    }
+
+    // QDom classes are reentrant but not thread-safe, so give each job its own deep copy of its stream definition.
+    //
+    std::vector<Worker::Job> jobs(configs.size());
+    for (size_t index = 0; index < jobs.size(); ++index) {
+        QDomDocument doc;
+        jobs[index].config = doc.importNode(configs[index], true).toElement();
+        doc.appendChild(jobs[index].config);
+        jobs[index].name = GetStreamName(configs[index], first + index);
+    }
+
+    std::atomic<size_t> next(0);
+    std::vector<Worker*> workers;
+    for (size_t index = 0; index < std::min(maxThreads, jobs.size()); ++index) {
+        workers.push_back(new Worker(jobs, next, statusEmitter, mcastAddress));
+        workers.back()->start();
+    }
+
+    for (auto worker : workers) {
+        worker->join();
+        delete worker;
+    }
+
+    std::string error;
+    for (const auto& job : jobs) {
+        if (!job.error.empty() && error.empty()) error = job.name + ": " + job.error;
+    }
+
+    if (!error.empty()) {
+        for (const auto& job : jobs) {
+            if (job.stream) job.stream->close();
+        }
+        Utils::Exception ex(error);
+        log.thrower(ex);
+    }
+
+    for (const auto& job : jobs) streams.push_back(job.stream);
+    return streams;
+}
+
+void
+StreamBuilder::PreloadAlgorithms(const QList<QDomElement>& configs)
+{
+    std::vector<std::string> names;
+    foreach (QDomElement config, configs) {
+        QDomElement def = config.firstChildElement("algorithm");
+        while (!def.isNull()) {
+            QString dll(def.attribute("dll"));
+            if (!dll.isEmpty()) names.push_back(dll.toStdString());
+            def = def.nextSiblingElement("algorithm");
+        }
+    }
+
+    AlgorithmLoader::Instance().preload(names);
+}
 
-    std::string name(stream.attribute("name").toStdString());
+std::string
+StreamBuilder::GetStreamName(const QDomElement& config, size_t index)
+{
+    std::string name(config.attribute("name").toStdString());
     if (!name.size()) {
-        QString tmp = QString("Stream %1").arg(App::GetApp()->getStreamCount() + 1);
+        QString tmp = QString("Stream %1").arg(index + 1);
         name = tmp.toStdString();
     }
 
+    return name;
+}
+
+IO::Stream::Ref
+StreamBuilder::Build(const QDomElement& stream, const std::string& name, const StatusEmitter::Ref& statusEmitter,
+                     const std::string& mcastAddress)
+{
+    Logger::ProcLog log("Build", Log());
+    LOGINFO << name << std::endl;
+
+    Utils::StartupTrace::Scope trace("stream", name);
     StreamBuilder builder(name, statusEmitter, mcastAddress);
 
     QDomElement def = stream.firstChildElement();
@@ -404,29 +545,39 @@ StreamBuilder::makeAlgorithm(const QDomElement& xml)
         log.thrower(ex);
     }
 
+    XmlRpc::XmlRpcValue init;
+    if (GetParameterValues(xml, init)) { controller->injectControlMessage(IO::ParametersChangeRequest(init, true)); }
+}
+
+bool
+StreamBuilder::GetParameterValues(const QDomElement& xml, XmlRpc::XmlRpcValue& values)
+{
+    Logger::ProcLog log("GetParameterValues", Log());
+
     QDomElement param = xml.firstChildElement("param");
-    if (!param.isNull()) {
-        // Build up an XML-RPC <value> request that contains settings for all of the <param> elements.
-        //
-        QString buffer;
-        QTextStream os(&buffer, QIODevice::WriteOnly);
-        os << "<value><array><data>";
-        do {
-            os << "<value><string>" << param.attribute("name") << "</string></value><value><" << param.attribute("type")
-               << ">" << param.attribute("value") << "</" << param.attribute("type") << "></value>";
-            param = param.nextSiblingElement("param");
-        } while (!param.isNull());
-
-        // Terminate the request, then post the change request to the controller.
-        //
-        os << "</data></array></value>";
-        LOGDEBUG << buffer.toStdString() << std::endl;
+    if (param.isNull()) return false;
 
-        int offset = 0;
-        XmlRpc::XmlRpcValue init(buffer.toStdString(), &offset);
-        LOGDEBUG << init.toXml() << std::endl;
-        controller->injectControlMessage(IO::ParametersChangeRequest(init, true));
-    }
+    // Build up an XML-RPC <value> request that contains settings for all of the <param> elements.
+    //
+    QString buffer;
+    QTextStream os(&buffer, QIODevice::WriteOnly);
+    os << "<value><array><data>";
+    do {
+        os << "<value><string>" << param.attribute("name") << "</string></value><value><" << param.attribute("type")
+           << ">" << param.attribute("value") << "</" << param.attribute("type") << "></value>";
+        param = param.nextSiblingElement("param");
+    } while (!param.isNull());
+
+    // Terminate the request.
+    //
+    os << "</data></array></value>";
+    os.flush();
+    LOGDEBUG << buffer.toStdString() << std::endl;
+
+    int offset = 0;
+    values = XmlRpc::XmlRpcValue(buffer.toStdString(), &offset);
+    LOGDEBUG << values.toXml() << std::endl;
+    return true;
 }
 
 std::string
@@ -541,6 +692,8 @@ StreamBuilder::makeDataPublisher(const QDomElement& xml)
         makeMulticastDataPublisher(xml, name, type, interface);
     } else if (transport == "tcp") {
         makeTCPDataPublisher(xml, name, type, interface);
+    } else if (transport == "shm") {
+        makeSharedMemoryDataPublisher(xml, name, type, interface);
     } else if (transport == "udp") {
         makeUDPWriter(xml, name, type, interface);
     } else {
@@ -566,6 +719,24 @@ StreamBuilder::makeMulticastDataPublisher(const QDomElement& xml, const std::str
 
     if (interface) { publisher->setInterface(interface); }
 
+    // Optional reliability layer: retransmission window and parity group size in messages, pacing rate in bytes
+    // per second, and a fraction of packets to drop for testing.
+    //
+    if (xml.attribute("reliable") == "true") {
+        bool ok[4];
+        size_t window = xml.attribute("window", "1024").toUInt(&ok[0]);
+        size_t fecGroup = xml.attribute("fecGroup", "8").toUInt(&ok[1]);
+        double rate = xml.attribute("rate", "0").toDouble(&ok[2]);
+        double simulatedLoss = xml.attribute("simulatedLoss", "0").toDouble(&ok[3]);
+        if (!ok[0] || !ok[1] || !ok[2] || !ok[3]) {
+            Utils::Exception ex("invalid reliability settings for multicast publisher ");
+            ex << name;
+            log.thrower(ex);
+        }
+
+        publisher->setReliability(window, fecGroup, rate, simulatedLoss);
+    }
+
     // If the publisher does not define an input channel, create one for it, and link to the previous task.
     //
     std::string realType(type);
@@ -613,6 +784,22 @@ StreamBuilder::makeTCPDataPublisher(const QDomElement& xml, const std::string& n
         }
     }
 
+    // What to do when a subscriber falls behind: "block", "dropOldest", or "latestOnly", and how many messages
+    // to hold for each subscriber. By default no subscriber misses a message, at the cost of holding up the
+    // stream while one falls behind. Publishers that feed displays should ask for "dropOldest" or "latestOnly".
+    //
+    IO::SendQueueBase::Policy clientPolicy;
+    bool ok;
+    size_t clientQueue = xml.attribute("clientQueue", "64").toUInt(&ok);
+    if (!IO::SendQueueBase::ParsePolicy(xml.attribute("clientPolicy", "block").toStdString(), clientPolicy) ||
+        !ok || !clientQueue) {
+        Utils::Exception ex("invalid client queue settings for TCP publisher ");
+        ex << name;
+        log.thrower(ex);
+    }
+
+    publisher->setClientPolicy(clientPolicy, clientQueue);
+
     // If the publisher does not define an input channel, create one for it, and link to the previous task.
     //
     std::string realType(type);
@@ -627,6 +814,55 @@ StreamBuilder::makeTCPDataPublisher(const QDomElement& xml, const std::string& n
     }
 }
 
+void
+StreamBuilder::makeSharedMemoryDataPublisher(const QDomElement& xml, const std::string& name, const std::string& type,
+                                             uint32_t interface)
+{
+    Logger::ProcLog log("makeSharedMemoryDataPublisher", Log());
+    LOGINFO << name << ' ' << type << ' ' << interface << std::endl;
+
+    IO::SharedMemoryDataPublisherModule* module = new IO::SharedMemoryDataPublisherModule(stream_);
+    addModule(xml, module);
+    IO::SharedMemoryDataPublisher::Ref publisher = module->getTask();
+
+    if (interface) { publisher->setInterface(interface); }
+
+    size_t slotCount = 64;
+    if (xml.hasAttribute("slots")) {
+        bool ok;
+        slotCount = xml.attribute("slots").toUInt(&ok);
+        if (!ok || !slotCount) {
+            Utils::Exception ex("invalid slots for 'shm publisher' - ");
+            ex << xml.attribute("slots").toStdString();
+            log.thrower(ex);
+        }
+    }
+
+    size_t slotSize = 256 * 1024;
+    if (xml.hasAttribute("slotSize")) {
+        bool ok;
+        slotSize = xml.attribute("slotSize").toUInt(&ok);
+        if (!ok || !slotSize) {
+            Utils::Exception ex("invalid slotSize for 'shm publisher' - ");
+            ex << xml.attribute("slotSize").toStdString();
+            log.thrower(ex);
+        }
+    }
+
+    // If the publisher does not define an input channel, create one for it, and link to the previous task.
+    //
+    std::string realType(type);
+    if (publisher->getNumInputChannels() == 0) {
+        connectInput(publisher, realType, "", xml.attribute("channel").toStdString());
+    }
+
+    if (!publisher->openAndInit(realType, name, slotCount, slotSize)) {
+        Utils::Exception ex("unable to open shared memory data publisher named ");
+        ex << name;
+        log.thrower(ex);
+    }
+}
+
 void
 StreamBuilder::makeDataSubscriber(const QDomElement& xml)
 {
@@ -654,6 +890,8 @@ StreamBuilder::makeDataSubscriber(const QDomElement& xml)
         makeMulticastDataSubscriber(xml, name, type, interface);
     } else if (transport == "tcp") {
         makeTCPDataSubscriber(xml, name, type, interface);
+    } else if (transport == "shm") {
+        makeSharedMemoryDataSubscriber(xml, name, type, interface);
     } else if (transport == "udp") {
         makeUDPReader(xml, name, type, interface);
     } else {
@@ -717,6 +955,33 @@ StreamBuilder::makeTCPDataSubscriber(const QDomElement& xml, const std::string&
     }
 }
 
+void
+StreamBuilder::makeSharedMemoryDataSubscriber(const QDomElement& xml, const std::string& name, const std::string& type,
+                                              uint32_t interface)
+{
+    Logger::ProcLog log("makeSharedMemoryDataSubscriber", Log());
+    LOGINFO << name << ' ' << type << ' ' << interface << std::endl;
+
+    long threadFlags = getThreadFlags(xml.attribute(kScheduler));
+    long threadPriority = getThreadPriority(xml.attribute(kThreadPriority));
+
+    IO::SharedMemoryDataSubscriberModule* module = new IO::SharedMemoryDataSubscriberModule(stream_);
+    addModule(xml, module);
+    IO::SharedMemoryDataSubscriber::Ref subscriber = module->getTask();
+
+    // If the subscriber does not define an output channel, create one for it,
+    //
+    if (subscriber->getNumOutputChannels() == 0) {
+        registerOutput(subscriber, type, "", xml.attribute("channel").toStdString());
+    }
+
+    if (!subscriber->openAndInit(type, name, interface, threadFlags, threadPriority)) {
+        Utils::Exception ex("unable to subscribe to ");
+        ex << name;
+        log.thrower(ex);
+    }
+}
+
 void
 StreamBuilder::makeUDPReader(const QDomElement& xml, const std::string& name, const std::string& type,
                              uint32_t interface)
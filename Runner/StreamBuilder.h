@@ -3,7 +3,9 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
+#include "QtCore/QList"
 #include "QtXml/QDomElement"
 
 #include "IO/Stream.h"
@@ -12,6 +14,9 @@
 namespace Logger {
 class Log;
 }
+namespace XmlRpc {
+class XmlRpcValue;
+}
 
 namespace SideCar {
 namespace IO {
@@ -34,9 +39,71 @@ public:
     static IO::Stream::Ref Make(const QDomElement& config, const StatusEmitter::Ref& emitter,
                                 const std::string& mcastAddress);
 
+    /** Factory method that creates IO::Stream objects for several stream definitions. Streams do not share
+        tasks or channels, so up to maxThreads of them are built at once, each from its own copy of its XML
+        definition. If any stream fails to build, closes the others and throws the error of the first one that
+        failed.
+
+        \param configs XML configurations for the streams
+
+        \param emitter status emitter given to each stream
+
+        \param mcastAddress multicast address for data publishers
+
+        \param maxThreads most streams to build at once. If 1, builds them in order in the calling thread.
+
+        \return new stream objects, in the order of their definitions
+    */
+    static std::vector<IO::Stream::Ref> MakeAll(const QList<QDomElement>& configs, const StatusEmitter::Ref& emitter,
+                                                const std::string& mcastAddress, size_t maxThreads);
+
+    /** Begin loading the DLLs of the algorithms named in stream definitions in a background thread, so that the
+        work overlaps with the rest of runner startup. See Algorithms::AlgorithmLoader.
+
+        \param configs XML configurations for the streams
+    */
+    static void PreloadAlgorithms(const QList<QDomElement>& configs);
+
+    /** Obtain the name of a stream from its XML configuration, or make one up from its position.
+
+        \param config XML configuration for the stream
+
+        \param index position of the stream in the runner
+
+        \return stream name
+    */
+    static std::string GetStreamName(const QDomElement& config, size_t index);
+
+    /** Build an XML-RPC request for a ParametersChangeRequest from the <param> elements of a task definition.
+
+        \param xml configuration for the task
+
+        \param values storage for the name-value pairs of the request
+
+        \return true if the task has any <param> elements
+    */
+    static bool GetParameterValues(const QDomElement& xml, XmlRpc::XmlRpcValue& values);
+
 private:
     using ChannelMap = std::map<std::string, IO::Channel>;
 
+    class Worker;
+
+    /** Create and populate a new IO::Stream object.
+
+        \param config XML configuration for the stream
+
+        \param name the name of the stream
+
+        \param emitter status emitter given to the stream
+
+        \param mcastAddress multicast address for data publishers
+
+        \return new stream object
+    */
+    static IO::Stream::Ref Build(const QDomElement& config, const std::string& name, const StatusEmitter::Ref& emitter,
+                                 const std::string& mcastAddress);
+
     /** Constructor.
 
         \param name the name of the stream
@@ -84,6 +151,9 @@ private:
     void makeTCPDataPublisher(const QDomElement& xml, const std::string& name, const std::string& type,
                               uint32_t interface);
 
+    void makeSharedMemoryDataPublisher(const QDomElement& xml, const std::string& name, const std::string& type,
+                                       uint32_t interface);
+
     /** Create a new DataSubscriber task and add to the active stream.
 
         \param xml configuration information for the task
@@ -96,6 +166,9 @@ private:
     void makeTCPDataSubscriber(const QDomElement& xml, const std::string& name, const std::string& type,
                                uint32_t interface);
 
+    void makeSharedMemoryDataSubscriber(const QDomElement& xml, const std::string& name, const std::string& type,
+                                        uint32_t interface);
+
     /** Create a new VMEReader task and add to the active stream.
 
         \param xml configuration information for the task
@@ -0,0 +1,231 @@
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ace/Reactor.h"
+#include "ace/SOCK_Dgram.h"
+
+#include "Algorithms/ControllerStatus.h"
+#include "IO/StreamStatus.h"
+#include "IO/TraceRecorder.h"
+#include "Logger/Log.h"
+#include "Utils/CmdLineArgs.h"
+#include "Utils/Utils.h"
+#include "XMLRPC/XmlRpcValue.h"
+#include "Zeroconf/ACEMonitor.h"
+#include "Zeroconf/Publisher.h"
+
+#include "RunnerStatus.h"
+#include "StatusEmitter.h"
+
+using namespace SideCar;
+
+const std::string about = "Collect runner status reports and print per-task latency summaries and message traces.";
+
+const Utils::CmdLineArgs::OptionDef opts[] = {
+    {'D', "debug", "enable root debug level", 0},
+    {'d', "duration", "number of seconds to collect status reports (default 10)", "SECS"},
+    {'t', "traces", "maximum number of message traces to print (default 10)", "N"},
+};
+
+/** A hop in the path of a traced message: the task that saw it and the time it arrived there.
+ */
+struct Hop {
+    std::string task;
+    double arrival;
+    bool operator<(const Hop& rhs) const { return arrival < rhs.arrival; }
+};
+
+/** All of the hops seen for one trace ID.
+ */
+struct Trace {
+    double origin;
+    std::vector<Hop> hops;
+};
+
+using TraceMap = std::map<int, Trace>;
+using SummaryMap = std::map<std::string, XmlRpc::XmlRpcValue>;
+
+/** Status collector that registers with Zeroconf just like the Master application does, so that runners send
+    it their status reports.
+*/
+class LatencyCollector : public ACE_Event_Handler {
+public:
+    LatencyCollector() :
+        ACE_Event_Handler(ACE_Reactor::instance()), publisher_(Zeroconf::Publisher::Make(new Zeroconf::ACEMonitor)),
+        socket_(ACE_INET_Addr(uint16_t(0)))
+    {
+        publisher_->setType(Runner::StatusEmitter::GetCollectorType());
+    }
+
+    bool openAndInit();
+
+    void close();
+
+    ACE_HANDLE get_handle() const { return socket_.get_handle(); }
+
+    int handle_input(ACE_HANDLE handle);
+
+    const SummaryMap& getSummaries() const { return summaries_; }
+
+    const TraceMap& getTraces() const { return traces_; }
+
+private:
+    void process(const Runner::RunnerStatus& status);
+
+    Zeroconf::Publisher::Ref publisher_;
+    ACE_SOCK_Dgram socket_;
+    SummaryMap summaries_;
+    TraceMap traces_;
+};
+
+bool
+LatencyCollector::openAndInit()
+{
+    ACE_INET_Addr address;
+    if (socket_.get_local_addr(address) == -1) {
+        std::cerr << "*** failed to obtain local address\n";
+        return false;
+    }
+
+    if (reactor()->register_handler(this, READ_MASK) == -1) {
+        std::cerr << "*** failed to register socket handler\n";
+        return false;
+    }
+
+    publisher_->setPort(address.get_port_number());
+    std::ostringstream os;
+    os << "LatencyCollector-" << address.get_port_number();
+    if (!publisher_->publish(os.str(), false)) {
+        std::cerr << "*** failed to publish collector service\n";
+        return false;
+    }
+
+    return true;
+}
+
+void
+LatencyCollector::close()
+{
+    publisher_->stop();
+    reactor()->remove_handler(this, READ_MASK | DONT_CALL);
+    socket_.close();
+}
+
+int
+LatencyCollector::handle_input(ACE_HANDLE handle)
+{
+    char buffer[64 * 1024];
+    ACE_INET_Addr from;
+    ssize_t size = socket_.recv(buffer, sizeof(buffer) - 1, from);
+    if (size <= 0) return 0;
+    buffer[size] = 0;
+
+    int offset = 0;
+    XmlRpc::XmlRpcValue xmlValue(buffer, &offset);
+    if (!xmlValue.valid() || xmlValue.getType() != XmlRpc::XmlRpcValue::TypeArray) return 0;
+
+    Runner::RunnerStatus status(xmlValue);
+    if (!status.isLatestVersion()) return 0;
+
+    process(status);
+    return 0;
+}
+
+void
+LatencyCollector::process(const Runner::RunnerStatus& status)
+{
+    for (int streamIndex = 0; streamIndex < status.getStreamCount(); ++streamIndex) {
+        IO::StreamStatus streamStatus(status.getStreamStatus(streamIndex));
+        for (int taskIndex = 0; taskIndex < streamStatus.getTaskCount(); ++taskIndex) {
+            IO::TaskStatus taskStatus(streamStatus.getTaskStatus(taskIndex));
+            std::string name(status.getName() + '/' + streamStatus.getName() + '/' + taskStatus.getName());
+
+            // Only the most recent summaries are kept since they cover all activity since the last stats reset.
+            //
+            if (taskStatus.getClassName() == Algorithms::ControllerStatus::GetClassName()) {
+                Algorithms::ControllerStatus controllerStatus(taskStatus.getXMLData());
+                XmlRpc::XmlRpcValue& summary(summaries_[name]);
+                summary.setSize(3);
+                summary[0] = controllerStatus.getQueueWaitLatency();
+                summary[1] = controllerStatus.getProcessingLatency();
+                summary[2] = controllerStatus.getSendLatency();
+            }
+
+            // Trace spans are only reported once, so accumulate them.
+            //
+            const XmlRpc::XmlRpcValue& spans(taskStatus.getTraceSpans());
+            for (int index = 0; index < spans.size(); ++index) {
+                const XmlRpc::XmlRpcValue& span(spans[index]);
+                Trace& trace(traces_[int(span[IO::TraceRecorder::kTraceId])]);
+                trace.origin = double(span[IO::TraceRecorder::kOriginTime]);
+                trace.hops.push_back(Hop{name, double(span[IO::TraceRecorder::kArrivalTime])});
+            }
+        }
+    }
+}
+
+static void
+PrintSummary(const char* label, const XmlRpc::XmlRpcValue& summary)
+{
+    using Status = Algorithms::ControllerStatus;
+    if (summary.getType() != XmlRpc::XmlRpcValue::TypeArray || summary.size() != Status::kLatencyNumSlots) return;
+    std::cout << "  " << std::setw(10) << label << " count: " << int(summary[Status::kLatencyCount]) << std::fixed
+              << std::setprecision(1) << " mean: " << double(summary[Status::kLatencyMean]) * 1.0E6
+              << " p50: " << double(summary[Status::kLatencyP50]) * 1.0E6
+              << " p90: " << double(summary[Status::kLatencyP90]) * 1.0E6
+              << " p99: " << double(summary[Status::kLatencyP99]) * 1.0E6
+              << " p99.9: " << double(summary[Status::kLatencyP999]) * 1.0E6
+              << " max: " << double(summary[Status::kLatencyMax]) * 1.0E6 << " usecs\n";
+}
+
+int
+main(int argc, char** argv)
+{
+    Utils::CmdLineArgs cla(argc, argv, about, opts, sizeof(opts), 0, 0);
+    if (cla.hasOpt("debug")) Logger::Log::Root().setPriorityLimit(Logger::Priority::kDebug);
+
+    int duration = 10;
+    if (cla.hasOpt("duration")) cla.opt("duration")[0] >> duration;
+
+    int maxTraces = 10;
+    if (cla.hasOpt("traces")) cla.opt("traces")[0] >> maxTraces;
+
+    LatencyCollector collector;
+    if (!collector.openAndInit()) return 1;
+
+    std::clog << cla.progName() << ": collecting status for " << duration << " seconds\n";
+    ACE_Time_Value timeout(duration);
+    while (timeout != ACE_Time_Value::zero) ACE_Reactor::instance()->handle_events(timeout);
+    collector.close();
+
+    std::cout << "Latency summaries\n";
+    for (auto& entry : collector.getSummaries()) {
+        std::cout << entry.first << '\n';
+        PrintSummary("queue", entry.second[0]);
+        PrintSummary("process", entry.second[1]);
+        PrintSummary("send", entry.second[2]);
+    }
+
+    std::cout << "\nMessage traces (" << collector.getTraces().size() << " seen)\n";
+    int count = 0;
+    for (auto& entry : collector.getTraces()) {
+        if (count++ == maxTraces) break;
+        std::vector<Hop> hops(entry.second.hops);
+        std::sort(hops.begin(), hops.end());
+        std::cout << "trace " << entry.first << '\n';
+        double last = entry.second.origin;
+        for (auto& hop : hops) {
+            std::cout << std::fixed << std::setprecision(1) << "  +" << std::setw(10)
+                      << (hop.arrival - entry.second.origin) * 1.0E6 << " (" << std::setw(10)
+                      << (hop.arrival - last) * 1.0E6 << ") usecs " << hop.task << '\n';
+            last = hop.arrival;
+        }
+    }
+
+    return 0;
+}
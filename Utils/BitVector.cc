@@ -0,0 +1,280 @@
+#include <algorithm>
+#include <cstring>
+
+#include "BitVector.h"
+
+using namespace Utils;
+
+static inline size_t
+PopCount(BitVector::Word word)
+{
+    return __builtin_popcountll(word);
+}
+
+/** Pack eight bytes into eight bits, byte N becoming bit N. Any non-zero byte counts as set.
+ */
+static inline uint8_t
+PackBytes(const char* bytes)
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    // Fold each byte onto its lowest bit, then gather the eight low bits with one multiply. Bits that cross into
+    // a neighbouring byte land in its upper half, which the folding never brings down to bit zero.
+    //
+    uint64_t word;
+    ::memcpy(&word, bytes, sizeof(word));
+    word |= word >> 4;
+    word |= word >> 2;
+    word |= word >> 1;
+    word &= 0x0101010101010101ULL;
+    return (word * 0x0102040810204080ULL) >> 56;
+#else
+    uint8_t value = 0;
+    for (int bit = 0; bit < 8; ++bit) value |= uint8_t(bytes[bit] != 0) << bit;
+    return value;
+#endif
+}
+
+BitVector::BitVector(size_t size, bool value) : words_(GetNumWords(size), value ? ~Word(0) : Word(0)), size_(size)
+{
+    trim();
+}
+
+void
+BitVector::trim()
+{
+    size_t used = size_ % kBitsPerWord;
+    if (used) words_.back() &= (Word(1) << used) - 1;
+}
+
+void
+BitVector::resize(size_t size, bool value)
+{
+    size_t oldSize = size_;
+    words_.resize(GetNumWords(size), value ? ~Word(0) : Word(0));
+    size_ = size;
+    if (value && size > oldSize && oldSize % kBitsPerWord) {
+        words_[oldSize / kBitsPerWord] |= ~Word(0) << (oldSize % kBitsPerWord);
+    }
+
+    trim();
+}
+
+void
+BitVector::reset()
+{
+    std::fill(words_.begin(), words_.end(), Word(0));
+}
+
+size_t
+BitVector::count() const
+{
+    size_t total = 0;
+    for (auto word : words_) total += PopCount(word);
+    return total;
+}
+
+void
+BitVector::assign(const char* begin, const char* end)
+{
+    size_ = end - begin;
+    words_.assign(GetNumWords(size_), Word(0));
+    Word* out = words_.data();
+    while (end - begin >= kBitsPerWord) {
+        Word word = 0;
+        for (int byte = 0; byte < kBitsPerWord / 8; ++byte) word |= Word(PackBytes(begin + byte * 8)) << (byte * 8);
+        *out++ = word;
+        begin += kBitsPerWord;
+    }
+
+    for (int bit = 0; begin != end; ++bit) *out |= Word(*begin++ != 0) << bit;
+}
+
+void
+BitVector::unpack(std::vector<char>& bytes) const
+{
+    bytes.resize(size_);
+    char* out = bytes.data();
+    size_t remaining = size_;
+    for (auto word : words_) {
+        size_t span = std::min(remaining, size_t(kBitsPerWord));
+        for (size_t bit = 0; bit < span; ++bit) out[bit] = (word >> bit) & 1;
+        out += span;
+        remaining -= span;
+    }
+}
+
+BitVector&
+BitVector::operator&=(const BitVector& rhs)
+{
+    size_t count = std::min(words_.size(), rhs.words_.size());
+    for (size_t index = 0; index < count; ++index) words_[index] &= rhs.words_[index];
+    std::fill(words_.begin() + count, words_.end(), Word(0));
+    return *this;
+}
+
+BitVector&
+BitVector::operator|=(const BitVector& rhs)
+{
+    size_t count = std::min(words_.size(), rhs.words_.size());
+    for (size_t index = 0; index < count; ++index) words_[index] |= rhs.words_[index];
+    trim();
+    return *this;
+}
+
+BitVector&
+BitVector::shiftUp(size_t count)
+{
+    size_t wordShift = count / kBitsPerWord;
+    size_t bitShift = count % kBitsPerWord;
+    for (size_t index = words_.size(); index-- > 0;) {
+        Word word = 0;
+        if (index >= wordShift) {
+            size_t source = index - wordShift;
+            word = words_[source] << bitShift;
+            if (bitShift && source > 0) word |= words_[source - 1] >> (kBitsPerWord - bitShift);
+        }
+        words_[index] = word;
+    }
+
+    trim();
+    return *this;
+}
+
+BitVector&
+BitVector::shiftDown(size_t count)
+{
+    size_t wordShift = count / kBitsPerWord;
+    size_t bitShift = count % kBitsPerWord;
+    size_t numWords = words_.size();
+    for (size_t index = 0; index < numWords; ++index) {
+        Word word = 0;
+        size_t source = index + wordShift;
+        if (source < numWords) {
+            word = words_[source] >> bitShift;
+            if (bitShift && source + 1 < numWords) word |= words_[source + 1] << (kBitsPerWord - bitShift);
+        }
+        words_[index] = word;
+    }
+
+    return *this;
+}
+
+BitCounter::BitCounter(size_t size, uint32_t maxValue) : planes_(), carry_(), size_(0)
+{
+    resize(size, maxValue);
+}
+
+void
+BitCounter::resize(size_t size, uint32_t maxValue)
+{
+    size_t numPlanes = 1;
+    while (numPlanes < 32 && (maxValue >> numPlanes) != 0) ++numPlanes;
+    planes_.resize(numPlanes, BitVector(size));
+    for (auto& plane : planes_) plane.resize(size);
+    carry_.resize(BitVector::GetNumWords(size));
+    size_ = size;
+}
+
+void
+BitCounter::reset()
+{
+    for (auto& plane : planes_) plane.reset();
+}
+
+uint32_t
+BitCounter::get(size_t index) const
+{
+    uint32_t value = 0;
+    for (size_t plane = 0; plane < planes_.size(); ++plane) value |= uint32_t(planes_[plane].test(index)) << plane;
+    return value;
+}
+
+void
+BitCounter::add(const BitVector& bits)
+{
+    // Half-adder ripple: the incoming bit is the carry into plane 0. Stop early once no carries remain.
+    //
+    size_t numWords = std::min(carry_.size(), bits.getNumWords());
+    std::copy(bits.getWords(), bits.getWords() + numWords, carry_.begin());
+    for (auto& plane : planes_) {
+        BitVector::Word* words = plane.getWords();
+        BitVector::Word any = 0;
+        for (size_t index = 0; index < numWords; ++index) {
+            BitVector::Word carry = carry_[index];
+            BitVector::Word value = words[index];
+            words[index] = value ^ carry;
+            carry_[index] = value & carry;
+            any |= carry_[index];
+        }
+
+        if (!any) break;
+    }
+}
+
+void
+BitCounter::add(const BitCounter& rhs)
+{
+    size_t numWords = std::min(carry_.size(), rhs.carry_.size());
+    std::fill(carry_.begin(), carry_.begin() + numWords, BitVector::Word(0));
+    for (size_t plane = 0; plane < planes_.size(); ++plane) {
+        BitVector::Word* words = planes_[plane].getWords();
+        const BitVector::Word* other = plane < rhs.planes_.size() ? rhs.planes_[plane].getWords() : 0;
+        for (size_t index = 0; index < numWords; ++index) {
+            BitVector::Word a = words[index];
+            BitVector::Word b = other ? other[index] : 0;
+            BitVector::Word carry = carry_[index];
+            words[index] = a ^ b ^ carry;
+            carry_[index] = (a & b) | (carry & (a ^ b));
+        }
+    }
+}
+
+void
+BitCounter::subtract(const BitCounter& rhs)
+{
+    size_t numWords = std::min(carry_.size(), rhs.carry_.size());
+    std::fill(carry_.begin(), carry_.begin() + numWords, BitVector::Word(0));
+    for (size_t plane = 0; plane < planes_.size(); ++plane) {
+        BitVector::Word* words = planes_[plane].getWords();
+        const BitVector::Word* other = plane < rhs.planes_.size() ? rhs.planes_[plane].getWords() : 0;
+        for (size_t index = 0; index < numWords; ++index) {
+            BitVector::Word a = words[index];
+            BitVector::Word b = other ? other[index] : 0;
+            BitVector::Word borrow = carry_[index];
+            words[index] = a ^ b ^ borrow;
+            carry_[index] = (~a & b) | (~(a ^ b) & borrow);
+        }
+    }
+}
+
+void
+BitCounter::atLeast(uint32_t threshold, BitVector& out) const
+{
+    out.resize(size_);
+    size_t numPlanes = planes_.size();
+    if (numPlanes < 32 && (threshold >> numPlanes) != 0) {
+        out.reset();
+        return;
+    }
+
+    // Compare from the most-significant plane down. 'greater' marks counters already known to exceed the
+    // threshold, and 'equal' those that match it in all planes visited so far.
+    //
+    BitVector::Word* result = out.getWords();
+    for (size_t index = 0; index < out.getNumWords(); ++index) {
+        BitVector::Word greater = 0;
+        BitVector::Word equal = ~BitVector::Word(0);
+        for (size_t plane = numPlanes; plane-- > 0;) {
+            BitVector::Word value = planes_[plane].getWords()[index];
+            if ((threshold >> plane) & 1) {
+                equal &= value;
+            } else {
+                greater |= equal & value;
+                equal &= ~value;
+            }
+        }
+        result[index] = greater | equal;
+    }
+
+    out.trim();
+}
@@ -0,0 +1,260 @@
+#ifndef UTILS_BITVECTOR_H // -*- C++ -*-
+#define UTILS_BITVECTOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Utils {
+
+/** Fixed-size sequence of bits packed into 64-bit words. Bit N lives in word N / 64 at position N % 64. Bits
+    beyond size() in the last word are always zero, so word-level operations never see stale data.
+
+    Used to hold BinaryVideo gate values in packed form: logical and shift operations work on 64 gates at a time,
+    and count() uses the hardware population count instruction where available.
+*/
+class BitVector {
+public:
+    using Word = uint64_t;
+
+    enum { kBitsPerWord = 64 };
+
+    /** Obtain the number of words needed to hold a given number of bits.
+
+        \param size number of bits
+
+        \return number of words
+    */
+    static size_t GetNumWords(size_t size) { return (size + kBitsPerWord - 1) / kBitsPerWord; }
+
+    /** Constructor.
+
+        \param size number of bits
+
+        \param value initial value for all bits
+    */
+    explicit BitVector(size_t size = 0, bool value = false);
+
+    /** Obtain the number of bits held.
+
+        \return bit count
+    */
+    size_t size() const { return size_; }
+
+    /** Obtain the number of words in use.
+
+        \return word count
+    */
+    size_t getNumWords() const { return words_.size(); }
+
+    /** Change the number of bits held. Existing bits are kept.
+
+        \param size new number of bits
+
+        \param value value for any added bits
+    */
+    void resize(size_t size, bool value = false);
+
+    /** Set all bits to zero.
+     */
+    void reset();
+
+    /** Obtain the value of a bit.
+
+        \param index bit to fetch
+
+        \return bit value
+    */
+    bool test(size_t index) const { return (words_[index / kBitsPerWord] >> (index % kBitsPerWord)) & 1; }
+
+    /** Change the value of a bit.
+
+        \param index bit to change
+
+        \param value new value
+    */
+    void set(size_t index, bool value = true)
+    {
+        Word mask = Word(1) << (index % kBitsPerWord);
+        if (value)
+            words_[index / kBitsPerWord] |= mask;
+        else
+            words_[index / kBitsPerWord] &= ~mask;
+    }
+
+    Word* getWords() { return words_.data(); }
+
+    const Word* getWords() const { return words_.data(); }
+
+    /** Obtain the number of bits that are set.
+
+        \return population count
+    */
+    size_t count() const;
+
+    /** Visit each run of consecutive set bits in order. Alternates between searching for the next set bit (the
+        start of a run) and the next clear bit (one past its end); inverting the word turns the second search into
+        the first, so the cost grows with the number of runs rather than the number of bits.
+
+        \param visitor functor called as visitor(start, stop) with the indices of the first and last bits of a run
+    */
+    template <typename Visitor>
+    void forEachRun(Visitor visitor) const
+    {
+        size_t start = 0;
+        bool inRun = false;
+        for (size_t index = 0; index < words_.size(); ++index) {
+            Word word = words_[index];
+            size_t base = index * kBitsPerWord;
+            size_t bit = 0;
+            while (bit < kBitsPerWord) {
+                Word pending = (inRun ? ~word : word) >> bit;
+                if (!pending) break;
+                bit += __builtin_ctzll(pending);
+                if (inRun) {
+                    visitor(start, base + bit - 1);
+                } else {
+                    start = base + bit;
+                }
+                inRun = !inRun;
+            }
+        }
+
+        if (inRun) visitor(start, size_ - 1);
+    }
+
+    /** Replace contents with one bit per byte value in [begin, end). Non-zero bytes become set bits.
+
+        \param begin first byte
+
+        \param end last + 1 byte
+    */
+    void assign(const char* begin, const char* end);
+
+    /** Write one byte per bit (0 or 1) into a container, replacing its contents.
+
+        \param bytes container to fill
+    */
+    void unpack(std::vector<char>& bytes) const;
+
+    /** Set the bits that are set in both this object and another. The other object must not be larger.
+
+        \param rhs bits to combine
+
+        \return reference to self
+    */
+    BitVector& operator&=(const BitVector& rhs);
+
+    /** Set the bits that are set in either this object or another. The other object must not be larger.
+
+        \param rhs bits to combine
+
+        \return reference to self
+    */
+    BitVector& operator|=(const BitVector& rhs);
+
+    /** Move every bit to a higher index. Bit N moves to N + count; bits shifted past size() are lost.
+
+        \param count number of positions to shift
+
+        \return reference to self
+    */
+    BitVector& shiftUp(size_t count);
+
+    /** Move every bit to a lower index. Bit N moves to N - count; bits shifted below zero are lost.
+
+        \param count number of positions to shift
+
+        \return reference to self
+    */
+    BitVector& shiftDown(size_t count);
+
+    bool operator==(const BitVector& rhs) const { return size_ == rhs.size_ && words_ == rhs.words_; }
+
+    bool operator!=(const BitVector& rhs) const { return !operator==(rhs); }
+
+private:
+    friend class BitCounter;
+
+    void trim();
+
+    std::vector<Word> words_;
+    size_t size_;
+};
+
+/** Array of small unsigned counters stored bit-sliced: plane P holds bit P of every counter as a BitVector. Adding
+    a BitVector increments every counter whose bit is set using word-wide ripple-carry logic, so 64 counters are
+    updated per word operation. Used by M-of-N style detectors to count hits per gate without unpacking.
+*/
+class BitCounter {
+public:
+    /** Constructor.
+
+        \param size number of counters
+
+        \param maxValue largest value any counter must hold
+    */
+    BitCounter(size_t size = 0, uint32_t maxValue = 1);
+
+    /** Change the number of counters and their capacity. Existing counter values are kept where they fit.
+
+        \param size number of counters
+
+        \param maxValue largest value any counter must hold
+    */
+    void resize(size_t size, uint32_t maxValue);
+
+    /** Set all counters to zero.
+     */
+    void reset();
+
+    size_t size() const { return size_; }
+
+    size_t getNumPlanes() const { return planes_.size(); }
+
+    /** Obtain the value of one counter.
+
+        \param index counter to fetch
+
+        \return counter value
+    */
+    uint32_t get(size_t index) const;
+
+    /** Increment the counters whose bits are set in a BitVector.
+
+        \param bits which counters to increment
+    */
+    void add(const BitVector& bits);
+
+    /** Add the values of another counter array.
+
+        \param rhs values to add
+    */
+    void add(const BitCounter& rhs);
+
+    /** Subtract the values of another counter array. Counters must not go negative.
+
+        \param rhs values to subtract
+    */
+    void subtract(const BitCounter& rhs);
+
+    /** Determine which counters are at least a given value.
+
+        \param threshold value to compare against
+
+        \param out set to one bit per counter, set if the counter is >= threshold
+    */
+    void atLeast(uint32_t threshold, BitVector& out) const;
+
+private:
+    std::vector<BitVector> planes_;
+    std::vector<BitVector::Word> carry_;
+    size_t size_;
+};
+
+} // end namespace Utils
+
+/** \file
+ */
+
+#endif
@@ -0,0 +1,126 @@
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+#include "BitVector.h"
+#include "UnitTest/UnitTest.h"
+
+using namespace Utils;
+
+struct Test : public UnitTest::TestObj {
+    Test() : UnitTest::TestObj("BitVector") {}
+    void test();
+};
+
+void
+Test::test()
+{
+    // Pack and unpack byte-per-bit data, including a partial last word.
+    //
+    std::vector<char> bytes(150);
+    for (size_t index = 0; index < bytes.size(); ++index) bytes[index] = (index % 3 == 0) ? 7 : 0;
+
+    BitVector bits;
+    bits.assign(&bytes[0], &bytes[0] + bytes.size());
+    assertEqual(size_t(150), bits.size());
+    assertEqual(size_t(3), bits.getNumWords());
+    assertEqual(size_t(50), bits.count());
+    assertTrue(bits.test(0));
+    assertFalse(bits.test(1));
+    assertTrue(bits.test(147));
+
+    std::vector<char> unpacked;
+    bits.unpack(unpacked);
+    assertEqual(bytes.size(), unpacked.size());
+    for (size_t index = 0; index < bytes.size(); ++index) assertEqual(bytes[index] ? 1 : 0, int(unpacked[index]));
+
+    // Shifts across word boundaries must drop bits that fall off either end.
+    //
+    BitVector up(bits);
+    up.shiftUp(70);
+    BitVector down(bits);
+    down.shiftDown(70);
+    for (size_t index = 0; index < bits.size(); ++index) {
+        assertEqual(index >= 70 && bits.test(index - 70), up.test(index));
+        assertEqual(index + 70 < bits.size() && bits.test(index + 70), down.test(index));
+    }
+
+    BitVector ones(150, true);
+    assertEqual(size_t(150), ones.count());
+    ones.shiftUp(1);
+    assertEqual(size_t(149), ones.count());
+    ones.resize(200, true);
+    assertEqual(size_t(199), ones.count());
+
+    BitVector both(bits);
+    both &= up;
+    BitVector either(bits);
+    either |= up;
+    for (size_t index = 0; index < bits.size(); ++index) {
+        assertEqual(bits.test(index) && up.test(index), both.test(index));
+        assertEqual(bits.test(index) || up.test(index), either.test(index));
+    }
+
+    // Bit-sliced counters must agree with plain integer counting.
+    //
+    const size_t kSize = 333;
+    std::vector<uint32_t> expected(kSize, 0);
+    BitCounter counter(kSize, 40);
+    BitCounter other(kSize, 40);
+    std::srand(1234);
+    for (int round = 0; round < 40; ++round) {
+        BitVector input(kSize);
+        for (size_t index = 0; index < kSize; ++index) {
+            if (std::rand() & 1) {
+                input.set(index);
+                ++expected[index];
+            }
+        }
+        counter.add(input);
+        if (round < 10) other.add(input);
+    }
+
+    for (size_t index = 0; index < kSize; ++index) assertEqual(expected[index], counter.get(index));
+
+    counter.subtract(other);
+    for (size_t index = 0; index < kSize; ++index) expected[index] -= other.get(index);
+    for (size_t index = 0; index < kSize; ++index) assertEqual(expected[index], counter.get(index));
+
+    counter.add(other);
+    for (size_t index = 0; index < kSize; ++index) expected[index] += other.get(index);
+    for (size_t index = 0; index < kSize; ++index) assertEqual(expected[index], counter.get(index));
+
+    // Runs of set bits, including ones that cross words and one that reaches the last bit.
+    //
+    BitVector runs(kSize);
+    for (size_t index = 3; index < 5; ++index) runs.set(index);
+    for (size_t index = 60; index < 130; ++index) runs.set(index);
+    runs.set(kSize - 1);
+    std::vector<std::pair<size_t, size_t>> found;
+    runs.forEachRun([&](size_t start, size_t stop) { found.emplace_back(start, stop); });
+    assertEqual(size_t(3), found.size());
+    assertEqual(size_t(3), found[0].first);
+    assertEqual(size_t(4), found[0].second);
+    assertEqual(size_t(60), found[1].first);
+    assertEqual(size_t(129), found[1].second);
+    assertEqual(kSize - 1, found[2].first);
+    assertEqual(kSize - 1, found[2].second);
+
+    for (uint32_t threshold = 0; threshold < 70; threshold += 7) {
+        BitVector passed;
+        counter.atLeast(threshold, passed);
+        assertEqual(kSize, passed.size());
+        size_t total = 0;
+        for (size_t index = 0; index < kSize; ++index) {
+            assertEqual(expected[index] >= threshold, passed.test(index));
+            total += expected[index] >= threshold;
+        }
+        assertEqual(total, passed.count());
+    }
+}
+
+int
+main(int argc, const char* argv[])
+{
+    return Test().mainRun();
+}
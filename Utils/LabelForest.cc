@@ -0,0 +1,93 @@
+#include "LabelForest.h"
+
+using namespace Utils;
+
+LabelForest::LabelForest() :
+    parent_(), lastPRI_(), free_(), merged_(), open_(), touched_(), priCounter_(0)
+{
+    ;
+}
+
+void
+LabelForest::reset()
+{
+    parent_.clear();
+    lastPRI_.clear();
+    free_.clear();
+    merged_.clear();
+    open_.clear();
+    touched_.clear();
+    priCounter_ = 0;
+}
+
+void
+LabelForest::beginPRI()
+{
+    ++priCounter_;
+    touched_.clear();
+}
+
+LabelForest::Label
+LabelForest::allocate()
+{
+    Label label;
+    if (free_.empty()) {
+        label = parent_.size();
+        parent_.push_back(label);
+        lastPRI_.push_back(0);
+    } else {
+        label = free_.back();
+        free_.pop_back();
+        parent_[label] = label;
+        lastPRI_[label] = 0;
+    }
+
+    return label;
+}
+
+LabelForest::Label
+LabelForest::find(Label label)
+{
+    Label root = label;
+    while (parent_[root] != root) root = parent_[root];
+
+    // Path compression
+    //
+    while (parent_[label] != root) {
+        Label next = parent_[label];
+        parent_[label] = root;
+        label = next;
+    }
+
+    return root;
+}
+
+void
+LabelForest::unite(Label into, Label from)
+{
+    parent_[from] = into;
+    merged_.push_back(from);
+
+    // The merged component stays open if either part was extended by this PRI.
+    //
+    if (isTouched(from) && !isTouched(into)) {
+        lastPRI_[into] = priCounter_;
+        touched_.push_back(into);
+    }
+}
+
+bool
+LabelForest::touch(Label label)
+{
+    if (isTouched(label)) return false;
+    lastPRI_[label] = priCounter_;
+    touched_.push_back(label);
+    return true;
+}
+
+void
+LabelForest::recycleMerged()
+{
+    free_.insert(free_.end(), merged_.begin(), merged_.end());
+    merged_.clear();
+}
@@ -0,0 +1,132 @@
+#ifndef UTILS_LABELFOREST_H // -*- C++ -*-
+#define UTILS_LABELFOREST_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Utils {
+
+/** Union-find forest over small integer labels for streaming connected-component labellers, which see a scan one
+    PRI at a time and join the runs of each PRI to those of the one before. Besides the forest, it tracks which
+    components the current PRI extended, which components are still open, and which labels are free, so that a
+    labeller only has to keep the data of each component in its own containers indexed by label.
+
+    Per PRI, a labeller calls beginPRI(), then for each run find() the labels of the runs it touches in the previous
+    PRI, unite() them, or allocate() a new label, and touch() the result. close() then hands over the components
+    that the PRI did not extend, and once the runs of the PRI refer to roots, recycleMerged() frees the labels that
+    were merged away.
+*/
+class LabelForest {
+public:
+    using Label = uint32_t;
+
+    LabelForest();
+
+    /** Forget all labels.
+     */
+    void reset();
+
+    /** Start labelling the next PRI.
+     */
+    void beginPRI();
+
+    /** Obtain a label for a new component, reusing a free one if there is one.
+
+        \return new root label, less than getLabelCount()
+    */
+    Label allocate();
+
+    /** Obtain the root label of the component that holds a label, compressing the path to it.
+
+        \param label label to look up
+
+        \return root label
+    */
+    Label find(Label label);
+
+    /** Merge one component into another. The caller must have folded the data of \p from into that of \p into.
+
+        \param into root label of the component that remains
+
+        \param from root label of the component merged away
+    */
+    void unite(Label into, Label from);
+
+    /** Note that the current PRI extends a component.
+
+        \param label root label of the component
+
+        \return true if this is the first time during the current PRI
+    */
+    bool touch(Label label);
+
+    /** Finish the current PRI. Components that were open before it and that it did not extend are complete: each
+        is passed to \p complete and its label is freed. Those it did extend stay open unless \p keep returns false,
+        in which case the caller is done with them and their labels are freed too.
+
+        \param complete functor called as complete(label) for each completed component
+
+        \param keep functor called as keep(label) for each extended component
+    */
+    template <typename Complete, typename Keep>
+    void close(Complete complete, Keep keep)
+    {
+        for (auto label : open_) {
+            if (isRoot(label) && !isTouched(label)) {
+                complete(label);
+                free_.push_back(label);
+            }
+        }
+
+        open_.clear();
+        for (auto label : touched_) {
+            if (!isRoot(label)) continue;
+            if (keep(label)) {
+                open_.push_back(label);
+            } else {
+                free_.push_back(label);
+            }
+        }
+    }
+
+    /** Free the labels merged away during the current PRI. Call once nothing refers to them, that is, once the runs
+        of the PRI refer to root labels.
+    */
+    void recycleMerged();
+
+    bool isRoot(Label label) const { return parent_[label] == label; }
+
+    bool isTouched(Label label) const { return lastPRI_[label] == priCounter_; }
+
+    /** Obtain the root labels of the components extended by the last PRI.
+
+        \return open labels
+    */
+    const std::vector<Label>& getOpen() const { return open_; }
+
+    size_t getOpenCount() const { return open_.size(); }
+
+    /** Obtain the number of labels allocated, both in use and free. This is the high-water mark of components
+        that were open at the same time.
+
+        \return label count
+    */
+    size_t getLabelCount() const { return parent_.size(); }
+
+private:
+    std::vector<Label> parent_;
+    std::vector<uint32_t> lastPRI_;
+    std::vector<Label> free_;
+    std::vector<Label> merged_;
+    std::vector<Label> open_;
+    std::vector<Label> touched_;
+    uint32_t priCounter_;
+};
+
+} // end namespace Utils
+
+/** \file
+ */
+
+#endif
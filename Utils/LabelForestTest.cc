@@ -0,0 +1,78 @@
+#include <vector>
+
+#include "LabelForest.h"
+#include "UnitTest/UnitTest.h"
+
+using namespace Utils;
+
+struct Test : public UnitTest::TestObj {
+    Test() : UnitTest::TestObj("LabelForest") {}
+    void test();
+};
+
+void
+Test::test()
+{
+    using Label = LabelForest::Label;
+    LabelForest forest;
+    std::vector<Label> completed;
+    auto complete = [&](Label label) { completed.push_back(label); };
+    auto keep = [](Label) { return true; };
+
+    // Two components start in the first PRI.
+    //
+    forest.beginPRI();
+    Label a = forest.allocate();
+    Label b = forest.allocate();
+    assertTrue(forest.touch(a));
+    assertFalse(forest.touch(a));
+    assertTrue(forest.touch(b));
+    forest.close(complete, keep);
+    forest.recycleMerged();
+    assertEqual(size_t(2), forest.getOpenCount());
+    assertEqual(size_t(2), forest.getLabelCount());
+
+    // A run in the next PRI joins them. The merged component stays open.
+    //
+    forest.beginPRI();
+    forest.unite(a, b);
+    assertTrue(forest.touch(a));
+    assertEqual(a, forest.find(b));
+    forest.close(complete, keep);
+    forest.recycleMerged();
+    assertEqual(size_t(1), forest.getOpenCount());
+    assertTrue(completed.empty());
+
+    // A PRI that does not extend it completes it, and its labels are reused.
+    //
+    forest.beginPRI();
+    Label c = forest.allocate();
+    assertEqual(b, c);
+    forest.touch(c);
+    forest.close(complete, keep);
+    forest.recycleMerged();
+    assertEqual(size_t(1), completed.size());
+    assertEqual(a, completed[0]);
+
+    // A component the caller gives up on is not kept open, and its label is free at once.
+    //
+    forest.beginPRI();
+    forest.touch(c);
+    forest.close(complete, [](Label) { return false; });
+    assertEqual(size_t(0), forest.getOpenCount());
+    assertEqual(size_t(1), completed.size());
+    forest.beginPRI();
+    assertEqual(size_t(2), forest.getLabelCount());
+    forest.allocate();
+    forest.allocate();
+    assertEqual(size_t(2), forest.getLabelCount());
+
+    forest.reset();
+    assertEqual(size_t(0), forest.getLabelCount());
+}
+
+int
+main(int argc, const char* argv[])
+{
+    return Test().mainRun();
+}
@@ -0,0 +1,87 @@
+#include <algorithm>
+#include <cmath>
+
+#include "LatencyHistogram.h"
+
+using namespace Utils;
+
+size_t
+LatencyHistogram::GetBucketIndex(uint64_t value)
+{
+    if (value > GetMaximumTrackableValue()) value = GetMaximumTrackableValue();
+
+    // Values below 2 * kSubBucketCount map directly to their bucket. Above that, each power of two has
+    // kSubBucketCount buckets, each one 2^shift values wide.
+    //
+    int msb = value ? 63 - __builtin_clzll(value) : 0;
+    int shift = msb > kSubBucketBits ? msb - kSubBucketBits : 0;
+    return size_t(kSubBucketCount) * shift + size_t(value >> shift);
+}
+
+uint64_t
+LatencyHistogram::GetLowestValueAt(size_t index)
+{
+    int shift = index < 2 * kSubBucketCount ? 0 : int(index / kSubBucketCount) - 1;
+    return uint64_t(index - size_t(kSubBucketCount) * shift) << shift;
+}
+
+uint64_t
+LatencyHistogram::GetHighestValueAt(size_t index)
+{
+    int shift = index < 2 * kSubBucketCount ? 0 : int(index / kSubBucketCount) - 1;
+    return GetLowestValueAt(index) + (uint64_t(1) << shift) - 1;
+}
+
+LatencyHistogram::LatencyHistogram() : counts_(kBucketCount, 0)
+{
+    reset();
+}
+
+void
+LatencyHistogram::reset()
+{
+    std::fill(counts_.begin(), counts_.end(), 0);
+    count_ = 0;
+    minimum_ = GetMaximumTrackableValue();
+    maximum_ = 0;
+    sum_ = 0.0;
+}
+
+void
+LatencyHistogram::addValue(uint64_t value)
+{
+    ++counts_[GetBucketIndex(value)];
+    ++count_;
+    sum_ += value;
+    if (value < minimum_) minimum_ = value;
+    if (value > maximum_) maximum_ = value;
+}
+
+void
+LatencyHistogram::merge(const LatencyHistogram& other)
+{
+    if (!other.count_) return;
+    for (size_t index = 0; index < counts_.size(); ++index) counts_[index] += other.counts_[index];
+    count_ += other.count_;
+    sum_ += other.sum_;
+    minimum_ = std::min(minimum_, other.minimum_);
+    maximum_ = std::max(maximum_, other.maximum_);
+}
+
+uint64_t
+LatencyHistogram::getValueAtPercentile(double percentile) const
+{
+    if (!count_) return 0;
+
+    percentile = std::min(std::max(percentile, 0.0), 100.0);
+    uint64_t target = uint64_t(::ceil(percentile / 100.0 * count_));
+    if (target == 0) target = 1;
+
+    uint64_t running = 0;
+    for (size_t index = 0; index < counts_.size(); ++index) {
+        running += counts_[index];
+        if (running >= target) return std::min(GetHighestValueAt(index), maximum_);
+    }
+
+    return maximum_;
+}
@@ -0,0 +1,139 @@
+#ifndef UTILS_LATENCYHISTOGRAM_H // -*- C++ -*-
+#define UTILS_LATENCYHISTOGRAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Utils {
+
+/** Histogram of latency values with a fixed relative precision, in the spirit of Gil Tene's HdrHistogram. Values
+    are recorded as integral microseconds. Each power-of-two range of values is split into kSubBucketCount
+    linear sub-buckets, so the error of any reported value is less than 1% regardless of magnitude. Values
+    larger than GetMaximumTrackableValue() are recorded in the last bucket.
+
+    Recording a value is O(1) and never allocates, which makes the class suitable for use in message processing
+    paths. Like RunningMedian, the class is not thread-safe: there should be only one thread adding values.
+    Other threads may read the counters for reporting, at the risk of seeing a value added mid-way through a
+    scan.
+*/
+class LatencyHistogram {
+public:
+    enum {
+        kSubBucketBits = 7,
+        kSubBucketCount = 1 << kSubBucketBits,
+        kMaxValueBits = 40,
+        kBucketCount = kSubBucketCount * (kMaxValueBits - kSubBucketBits + 1)
+    };
+
+    /** Obtain the largest value that the histogram can record without clamping (about 12.7 days).
+
+        \return maximum value in microseconds
+    */
+    static uint64_t GetMaximumTrackableValue() { return (uint64_t(1) << kMaxValueBits) - 1; }
+
+    /** Obtain the bucket index that holds a given value.
+
+        \param value the value to locate
+
+        \return bucket index
+    */
+    static size_t GetBucketIndex(uint64_t value);
+
+    /** Obtain the smallest value that maps to a given bucket index.
+
+        \param index the bucket to query
+
+        \return lowest value in microseconds
+    */
+    static uint64_t GetLowestValueAt(size_t index);
+
+    /** Obtain the largest value that maps to a given bucket index.
+
+        \param index the bucket to query
+
+        \return highest value in microseconds
+    */
+    static uint64_t GetHighestValueAt(size_t index);
+
+    /** Constructor. Creates an empty histogram.
+     */
+    LatencyHistogram();
+
+    /** Forget all recorded values.
+     */
+    void reset();
+
+    /** Record a new value.
+
+        \param micros latency value in microseconds
+    */
+    void addValue(uint64_t micros);
+
+    /** Record a new value given in seconds. Negative values (due to clock adjustments) are recorded as zero.
+
+        \param seconds latency value in seconds
+    */
+    void addSeconds(double seconds) { addValue(seconds > 0.0 ? uint64_t(seconds * 1.0E6 + 0.5) : 0); }
+
+    /** Add the counts from another histogram to ours.
+
+        \param other the histogram to merge
+    */
+    void merge(const LatencyHistogram& other);
+
+    /** Obtain the number of values recorded.
+
+        \return value count
+    */
+    uint64_t getCount() const { return count_; }
+
+    /** Obtain the smallest value recorded. Returns zero if the histogram is empty.
+
+        \return minimum value in microseconds
+    */
+    uint64_t getMinimumValue() const { return count_ ? minimum_ : 0; }
+
+    /** Obtain the largest value recorded. Returns zero if the histogram is empty.
+
+        \return maximum value in microseconds
+    */
+    uint64_t getMaximumValue() const { return maximum_; }
+
+    /** Obtain the exact mean of the values recorded.
+
+        \return mean value in microseconds
+    */
+    double getMeanValue() const { return count_ ? sum_ / count_ : 0.0; }
+
+    /** Obtain the value at or below which a given percentage of the recorded values fall. The result is the
+        highest value equivalent to the bucket holding the percentile, capped by getMaximumValue().
+
+        \param percentile value between 0.0 and 100.0
+
+        \return value in microseconds
+    */
+    uint64_t getValueAtPercentile(double percentile) const;
+
+    /** Obtain the number of values recorded in a given bucket. Used when dumping the full distribution.
+
+        \param index the bucket to query
+
+        \return value count
+    */
+    uint64_t getCountAt(size_t index) const { return counts_[index]; }
+
+private:
+    std::vector<uint64_t> counts_;
+    uint64_t count_;
+    uint64_t minimum_;
+    uint64_t maximum_;
+    double sum_;
+};
+
+} // end namespace Utils
+
+/** \file
+ */
+
+#endif
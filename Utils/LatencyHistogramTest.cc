@@ -0,0 +1,71 @@
+#include "LatencyHistogram.h"
+#include "UnitTest/UnitTest.h"
+
+using namespace Utils;
+
+struct Test : public UnitTest::TestObj {
+    Test() : UnitTest::TestObj("LatencyHistogram") {}
+    void test();
+};
+
+void
+Test::test()
+{
+    // Bucket boundaries must be contiguous and must bracket the values that map to them.
+    //
+    for (size_t index = 0; index < LatencyHistogram::kBucketCount - 1; ++index) {
+        assertEqual(LatencyHistogram::GetHighestValueAt(index) + 1, LatencyHistogram::GetLowestValueAt(index + 1));
+    }
+
+    uint64_t values[] = {0, 1, 127, 255, 256, 1000, 123456, 987654321};
+    for (auto value : values) {
+        size_t index = LatencyHistogram::GetBucketIndex(value);
+        assertTrue(LatencyHistogram::GetLowestValueAt(index) <= value);
+        assertTrue(LatencyHistogram::GetHighestValueAt(index) >= value);
+        assertTrue(LatencyHistogram::GetHighestValueAt(index) - LatencyHistogram::GetLowestValueAt(index) <=
+                   value / LatencyHistogram::kSubBucketCount);
+    }
+
+    assertEqual(size_t(LatencyHistogram::kBucketCount - 1),
+                LatencyHistogram::GetBucketIndex(LatencyHistogram::GetMaximumTrackableValue() * 2));
+
+    LatencyHistogram h;
+    assertEqual(uint64_t(0), h.getCount());
+    assertEqual(uint64_t(0), h.getValueAtPercentile(50.0));
+
+    // Record 1..10000 microseconds. Percentiles must be within the histogram's relative precision.
+    //
+    for (uint64_t value = 1; value <= 10000; ++value) h.addValue(value);
+    assertEqual(uint64_t(10000), h.getCount());
+    assertEqual(uint64_t(1), h.getMinimumValue());
+    assertEqual(uint64_t(10000), h.getMaximumValue());
+    assertEqualEpsilon(5000.5, h.getMeanValue(), 0.001);
+    assertEqualEpsilon(5000.0, double(h.getValueAtPercentile(50.0)), 5000.0 / LatencyHistogram::kSubBucketCount);
+    assertEqualEpsilon(9900.0, double(h.getValueAtPercentile(99.0)), 9900.0 / LatencyHistogram::kSubBucketCount);
+    assertEqual(uint64_t(10000), h.getValueAtPercentile(100.0));
+    assertEqual(uint64_t(1), h.getValueAtPercentile(0.0));
+
+    // Seconds are converted to microseconds, and negative values clamp to zero.
+    //
+    LatencyHistogram s;
+    s.addSeconds(0.25);
+    s.addSeconds(-1.0);
+    assertEqual(uint64_t(2), s.getCount());
+    assertEqual(uint64_t(0), s.getMinimumValue());
+    assertEqual(uint64_t(250000), s.getMaximumValue());
+
+    h.merge(s);
+    assertEqual(uint64_t(10002), h.getCount());
+    assertEqual(uint64_t(0), h.getMinimumValue());
+    assertEqual(uint64_t(250000), h.getMaximumValue());
+
+    h.reset();
+    assertEqual(uint64_t(0), h.getCount());
+    assertEqual(uint64_t(0), h.getMaximumValue());
+}
+
+int
+main(int argc, const char* argv[])
+{
+    return Test().mainRun();
+}
@@ -0,0 +1,311 @@
+#include <algorithm>
+#include <cmath>
+
+#include "ScanRaster.h"
+
+using namespace Utils;
+
+const ScanRaster::Value ScanRaster::kEmpty;
+
+/** Spacing of the samples taken along and across the beam, as a fraction of a pixel. A lattice of points no
+    more than 1/sqrt(2) pixels apart touches every pixel it covers, whatever its orientation.
+*/
+static const double kOversample = 0.7;
+
+/** Upper limit to the number of rays cast for one PRI, which only matters for silly azimuth spans.
+ */
+static const int kMaxRays = 4096;
+
+ScanRaster::ScanRaster(int size, double rangeMax) :
+    tiles_(), mips_(), dirtyTiles_(), marks_(), rangeMax_(0.0), pixelSpan_(0.0), size_(kTileSize), tilesPerSide_(),
+    levelCount_(1), tileCount_(0), stamp_(0), hasData_(false), stats_()
+{
+    while (size_ < size) size_ *= 2;
+    while ((1 << (levelCount_ - 1)) < size_) ++levelCount_;
+
+    tilesPerSide_ = size_ / kTileSize;
+    tiles_.resize(tilesPerSide_ * tilesPerSide_, 0);
+    marks_.resize(tiles_.size(), 0);
+
+    for (int level = 1; level < levelCount_; ++level) {
+        int side = getSize(level);
+        mips_.push_back(std::vector<Value>(side * side, kEmpty));
+    }
+
+    reset(rangeMax);
+}
+
+ScanRaster::~ScanRaster()
+{
+    for (auto tile : tiles_) delete tile;
+}
+
+void
+ScanRaster::reset(double rangeMax)
+{
+    rangeMax_ = rangeMax;
+    pixelSpan_ = 2.0 * rangeMax / size_;
+    clear();
+}
+
+void
+ScanRaster::clear()
+{
+    for (auto tile : tiles_) {
+        if (tile) clearTile(tile);
+    }
+
+    for (auto& mip : mips_) std::fill(mip.begin(), mip.end(), kEmpty);
+
+    dirtyTiles_.clear();
+    stamp_ = 0;
+    hasData_ = false;
+}
+
+void
+ScanRaster::clearTile(Tile* tile)
+{
+    Cell empty = {kEmpty, 0};
+    std::fill(tile->cells, tile->cells + kTileSize * kTileSize, empty);
+    tile->dirty = false;
+}
+
+inline void
+ScanRaster::write(int column, int row, Value value)
+{
+    if (column < 0 || column >= size_ || row < 0 || row >= size_) return;
+
+    size_t index = (row >> kTileBits) * tilesPerSide_ + (column >> kTileBits);
+    Tile* tile = tiles_[index];
+    if (!tile) {
+        tile = new Tile;
+        clearTile(tile);
+        tiles_[index] = tile;
+        ++tileCount_;
+    }
+
+    if (!tile->dirty) {
+        tile->dirty = true;
+        dirtyTiles_.push_back(index);
+    }
+
+    ++stats_.writes;
+    size_t offset = ((row & (kTileSize - 1)) << kTileBits) + (column & (kTileSize - 1));
+    Cell& cell(tile->cells[offset]);
+    if (cell.stamp != stamp_) {
+        cell.stamp = stamp_;
+        cell.value = value;
+    } else if (value > cell.value) {
+        cell.value = value;
+    }
+}
+
+void
+ScanRaster::add(double azimuth, double azimuthSpan, double rangeMin, double rangeFactor, const Value* samples,
+                size_t count)
+{
+    ++stats_.pris;
+    if (!count || rangeMax_ <= 0.0 || rangeFactor <= 0.0) return;
+
+    double rangeEnd = std::min(rangeMin + (count - 1) * rangeFactor, rangeMax_);
+    if (rangeEnd < std::max(rangeMin, 0.0)) return;
+
+    // Number the PRI so that write() can tell values from this PRI from those of earlier ones. When the counter
+    // wraps, forget the old numbers so that none of them can match a new one.
+    //
+    if (++stamp_ == 0) {
+        for (auto tile : tiles_) {
+            if (!tile) continue;
+            for (auto& cell : tile->cells) cell.stamp = 0;
+        }
+        stamp_ = 1;
+    }
+
+    hasData_ = true;
+    long firstGate = rangeMin < 0.0 ? long(::ceil(-rangeMin / rangeFactor)) : 0;
+    long lastGate = long(::floor((rangeEnd - rangeMin) / rangeFactor));
+    stats_.gates += lastGate - firstGate + 1;
+
+    // Walk outward along rays that are no more than kOversample pixels apart across the beam, taking steps of
+    // kOversample pixels. When gates are finer than a step, each step takes the largest of the gates it spans;
+    // otherwise it takes the nearest gate. The beam gets wider with range, so more rays are needed further out.
+    // The ray count doubles each time the spacing of the current set gets too wide, and the new rays begin at
+    // the range where that happens. Ray j belongs to the set of size rays / (j & -j), so every set is evenly
+    // spread over the wedge.
+    //
+    double step = pixelSpan_ * kOversample;
+    double gatesPerStep = step / rangeFactor;
+    bool spansGates = gatesPerStep > 1.0;
+    double span = std::max(azimuthSpan, 0.0);
+
+    int rays = 1;
+    while (rays * step < rangeEnd * span && rays < kMaxRays) rays *= 2;
+
+    double center = size_ * 0.5;
+    double scale = 1.0 / pixelSpan_;
+    long lastStep = long(::floor((rangeEnd - rangeMin) / step));
+
+    for (int ray = 0; ray < rays; ++ray) {
+        int setSize = ray ? rays / (ray & -ray) : 1;
+        double rayStart = setSize == 1 ? 0.0 : (setSize / 2) * step / span;
+
+        long index = rayStart > rangeMin ? long(::ceil((rayStart - rangeMin) / step)) : 0;
+        if (index > lastStep) continue;
+
+        double angle = azimuth + span * (ray + 0.5) / rays;
+        double dx = ::sin(angle) * step * scale;
+        double dy = -::cos(angle) * step * scale;
+        double range = rangeMin + index * step;
+        double x = center + range * scale * ::sin(angle);
+        double y = center - range * scale * ::cos(angle);
+
+        // Position of the nearest gate, or of the first gate spanned by the step.
+        //
+        double gate = index * gatesPerStep + 0.5;
+        if (spansGates) gate -= gatesPerStep * 0.5;
+        size_t first = size_t(std::max(gate, 0.0));
+
+        // Steps that fall in the same pixel are combined before they are written.
+        //
+        int column = int(x);
+        int row = int(y);
+        Value value = kEmpty;
+        for (; index <= lastStep; ++index) {
+            gate += gatesPerStep;
+            Value sample = kEmpty;
+            if (spansGates) {
+                size_t end = std::min(size_t(gate), count);
+                for (; first < end; ++first) sample = std::max(sample, samples[first]);
+            } else if (first < count) {
+                sample = samples[first];
+                first = size_t(gate);
+            }
+
+            int nextColumn = int(x);
+            int nextRow = int(y);
+            if (nextColumn != column || nextRow != row) {
+                if (value != kEmpty) write(column, row, value);
+                column = nextColumn;
+                row = nextRow;
+                value = sample;
+            } else {
+                value = std::max(value, sample);
+            }
+
+            x += dx;
+            y += dy;
+        }
+
+        if (value != kEmpty) write(column, row, value);
+    }
+}
+
+void
+ScanRaster::updatePyramid()
+{
+    if (dirtyTiles_.empty()) return;
+
+    stats_.tilesUpdated += dirtyTiles_.size();
+    for (auto index : dirtyTiles_) tiles_[index]->dirty = false;
+
+    // Each pass maps the changed blocks of one level to the blocks of the next coarser one, and recomputes those.
+    // A block is kTileSize pixels on a side, or the whole level when the level is smaller than that.
+    //
+    std::vector<size_t> current;
+    std::vector<size_t> next;
+    current.swap(dirtyTiles_);
+
+    int side = tilesPerSide_;
+    for (int level = 1; level < levelCount_; ++level) {
+        int parentSide = std::max(side / 2, 1);
+        next.clear();
+        for (auto index : current) {
+            size_t parent = (index / side / 2) * parentSide + (index % side) / 2;
+            if (!marks_[parent]) {
+                marks_[parent] = 1;
+                next.push_back(parent);
+            }
+        }
+
+        for (auto index : next) {
+            marks_[index] = 0;
+            updateBlock(level, index % parentSide, index / parentSide);
+        }
+
+        current.swap(next);
+        side = parentSide;
+    }
+
+    // Keep the storage for the next round.
+    //
+    current.clear();
+    dirtyTiles_.swap(current);
+}
+
+void
+ScanRaster::updateBlock(int level, int blockX, int blockY)
+{
+    int levelSize = getSize(level);
+    int x0 = blockX * kTileSize;
+    int x1 = std::min(x0 + kTileSize, levelSize);
+    int y0 = blockY * kTileSize;
+    int y1 = std::min(y0 + kTileSize, levelSize);
+
+    std::vector<Value>& mip(mips_[level - 1]);
+
+    if (level == 1) {
+        // The 2x2 source pixels always lie in one tile since both the pixel coordinates and the tile size are
+        // even.
+        //
+        for (int y = y0; y < y1; ++y) {
+            int sourceY = y * 2;
+            for (int x = x0; x < x1; ++x) {
+                int sourceX = x * 2;
+                const Tile* tile = tiles_[(sourceY >> kTileBits) * tilesPerSide_ + (sourceX >> kTileBits)];
+                Value value = kEmpty;
+                if (tile) {
+                    const Cell* ptr =
+                        tile->cells + ((sourceY & (kTileSize - 1)) << kTileBits) + (sourceX & (kTileSize - 1));
+                    value = std::max(std::max(ptr[0].value, ptr[1].value),
+                                     std::max(ptr[kTileSize].value, ptr[kTileSize + 1].value));
+                }
+                mip[y * levelSize + x] = value;
+            }
+        }
+    } else {
+        const std::vector<Value>& source(mips_[level - 2]);
+        int sourceSize = levelSize * 2;
+        for (int y = y0; y < y1; ++y) {
+            const Value* row0 = &source[y * 2 * sourceSize];
+            const Value* row1 = row0 + sourceSize;
+            for (int x = x0; x < x1; ++x) {
+                int sourceX = x * 2;
+                mip[y * levelSize + x] = std::max(std::max(row0[sourceX], row0[sourceX + 1]),
+                                                  std::max(row1[sourceX], row1[sourceX + 1]));
+            }
+        }
+    }
+}
+
+int
+ScanRaster::chooseLevel(double span) const
+{
+    int level = 0;
+    while (level + 1 < levelCount_ && getPixelSpan(level + 1) <= span) ++level;
+    return level;
+}
+
+ScanRaster::Value
+ScanRaster::getValue(int level, int column, int row) const
+{
+    if (level < 0 || level >= levelCount_) return kEmpty;
+
+    int levelSize = getSize(level);
+    if (column < 0 || column >= levelSize || row < 0 || row >= levelSize) return kEmpty;
+
+    if (level) return mips_[level - 1][row * levelSize + column];
+
+    const Tile* tile = tiles_[(row >> kTileBits) * tilesPerSide_ + (column >> kTileBits)];
+    if (!tile) return kEmpty;
+    return tile->cells[((row & (kTileSize - 1)) << kTileBits) + (column & (kTileSize - 1))].value;
+}
@@ -0,0 +1,215 @@
+#ifndef UTILS_SCANRASTER_H // -*- C++ -*-
+#define UTILS_SCANRASTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "Utils/Utils.h"
+
+namespace Utils {
+
+/** Cartesian image of one revolution of polar radar samples. PRIs added with add() are scan-converted into a
+    square raster that covers -rangeMax to +rangeMax in X and Y, with North (azimuth zero) up and azimuth
+    increasing clockwise. A redraw of a revolution then only needs to visit the pixels of the raster, no matter
+    how many PRIs or gates went into it.
+
+    The full-resolution level is held in square tiles of kTileSize pixels which are only allocated when a sample
+    lands in them, so the corners outside of the scan circle cost nothing. Coarser levels form a mip pyramid in
+    which each pixel holds the largest value of the 2x2 pixels below it, so that a small target does not vanish
+    when the raster is shown zoomed out. The pyramid is brought up to date by updatePyramid(), which only
+    recomputes the parts under tiles that changed since the last update.
+
+    A PRI replaces whatever an earlier PRI left in the pixels it covers, so that the raster always shows the
+    latest pass of the antenna. Gates of the same PRI that fall in the same pixel keep the largest value.
+
+    Like RunningMedian, the class is not thread-safe.
+*/
+class ScanRaster : public Uncopyable {
+public:
+    using Value = int16_t;
+
+    enum { kTileBits = 6, kTileSize = 1 << kTileBits };
+
+    /** Value of a pixel that no sample has touched.
+     */
+    static const Value kEmpty = std::numeric_limits<Value>::min();
+
+    struct Stats {
+        uint64_t pris;         ///< PRIs added
+        uint64_t gates;        ///< Gates of those PRIs that fell inside the raster
+        uint64_t writes;       ///< Pixel writes performed
+        uint64_t tilesUpdated; ///< Tiles folded into the pyramid by updatePyramid()
+    };
+
+    /** Constructor.
+
+        \param size number of pixels on a side of the full-resolution level; rounded up to a power of two no
+        smaller than kTileSize
+
+        \param rangeMax range in kilometers of the edge of the raster from its center
+    */
+    ScanRaster(int size, double rangeMax);
+
+    /** Destructor. Releases the tiles.
+     */
+    ~ScanRaster();
+
+    /** Forget all samples and use a new range extent.
+
+        \param rangeMax range in kilometers of the edge of the raster from its center
+    */
+    void reset(double rangeMax);
+
+    /** Forget all samples. The tiles are kept for reuse.
+     */
+    void clear();
+
+    /** Scan-convert the samples of one PRI. The PRI covers the wedge that starts at azimuth and extends
+        clockwise for azimuthSpan radians. Gate N is centered at rangeMin + N * rangeFactor. Gates beyond the
+        edge of the raster are ignored.
+
+        \param azimuth start of the wedge in radians
+
+        \param azimuthSpan width of the wedge in radians
+
+        \param rangeMin range of the first gate in kilometers
+
+        \param rangeFactor distance between gates in kilometers
+
+        \param samples gate values
+
+        \param count number of gates
+    */
+    void add(double azimuth, double azimuthSpan, double rangeMin, double rangeFactor, const Value* samples,
+             size_t count);
+
+    /** Recompute the parts of the coarser levels that lie under tiles changed by add() since the last call.
+     */
+    void updatePyramid();
+
+    /** Determine if there are changes not yet folded into the coarser levels.
+
+        \return true if so
+    */
+    bool isDirty() const { return !dirtyTiles_.empty(); }
+
+    /** Determine if any sample has been added since the last clear().
+
+        \return true if so
+    */
+    bool hasData() const { return hasData_; }
+
+    double getRangeMax() const { return rangeMax_; }
+
+    /** Obtain the number of levels, including the full-resolution one. The coarsest level is one pixel.
+
+        \return level count
+    */
+    int getLevelCount() const { return levelCount_; }
+
+    /** Obtain the number of pixels on a side of a level.
+
+        \param level 0 for full resolution, higher for coarser levels
+
+        \return pixel count
+    */
+    int getSize(int level = 0) const { return size_ >> level; }
+
+    /** Obtain the width of a pixel of a level.
+
+        \param level 0 for full resolution, higher for coarser levels
+
+        \return pixel width in kilometers
+    */
+    double getPixelSpan(int level = 0) const { return pixelSpan_ * (1 << level); }
+
+    /** Obtain the coarsest level whose pixels are no wider than a given span. Drawing that level onto a display
+        with pixels of the given span shows all the detail that the display can hold and no more.
+
+        \param span display pixel width in kilometers
+
+        \return level index
+    */
+    int chooseLevel(double span) const;
+
+    /** Obtain the value of a pixel. Row 0 is at the top (+rangeMax in Y), and column 0 is at the left (-rangeMax
+        in X). The coarser levels are only valid after updatePyramid().
+
+        \param level 0 for full resolution, higher for coarser levels
+
+        \param column pixel column
+
+        \param row pixel row
+
+        \return pixel value or kEmpty
+    */
+    Value getValue(int level, int column, int row) const;
+
+    /** Obtain the X coordinate of the center of a pixel column.
+
+        \param level level of the column
+
+        \param column pixel column
+
+        \return X value in kilometers
+    */
+    double getX(int level, int column) const { return (column + 0.5) * getPixelSpan(level) - rangeMax_; }
+
+    /** Obtain the Y coordinate of the center of a pixel row.
+
+        \param level level of the row
+
+        \param row pixel row
+
+        \return Y value in kilometers
+    */
+    double getY(int level, int row) const { return rangeMax_ - (row + 0.5) * getPixelSpan(level); }
+
+    /** Obtain the number of full-resolution tiles in use.
+
+        \return tile count
+    */
+    size_t getTileCount() const { return tileCount_; }
+
+    const Stats& getStats() const { return stats_; }
+
+private:
+    struct Cell {
+        Value value;
+        uint16_t stamp; ///< Number of the PRI that last wrote the value
+    };
+
+    struct Tile {
+        Cell cells[kTileSize * kTileSize];
+        bool dirty;
+    };
+
+    void write(int column, int row, Value value);
+
+    void clearTile(Tile* tile);
+
+    void updateBlock(int level, int blockX, int blockY);
+
+    std::vector<Tile*> tiles_;
+    std::vector<std::vector<Value>> mips_; ///< Levels 1 and up
+    std::vector<size_t> dirtyTiles_;
+    std::vector<char> marks_;
+    double rangeMax_;
+    double pixelSpan_;
+    int size_;
+    int tilesPerSide_;
+    int levelCount_;
+    size_t tileCount_;
+    uint16_t stamp_;
+    bool hasData_;
+    Stats stats_;
+};
+
+} // end namespace Utils
+
+/** \file
+ */
+
+#endif
@@ -0,0 +1,149 @@
+#include <cmath>
+#include <vector>
+
+#include "ScanRaster.h"
+#include "UnitTest/UnitTest.h"
+#include "Utils.h"
+
+using namespace Utils;
+
+struct Test : public UnitTest::TestObj {
+    Test() : UnitTest::TestObj("ScanRaster") {}
+    void test();
+};
+
+/** Add one revolution of PRIs whose gates hold their gate index.
+ */
+static void
+AddRevolution(ScanRaster& raster, int radials, size_t gates, double rangeFactor)
+{
+    std::vector<ScanRaster::Value> samples(gates);
+    for (size_t gate = 0; gate < gates; ++gate) samples[gate] = gate;
+
+    double span = kCircleRadians / radials;
+    for (int radial = 0; radial < radials; ++radial) {
+        raster.add(radial * span, span, 0.0, rangeFactor, &samples[0], gates);
+    }
+}
+
+void
+Test::test()
+{
+    ScanRaster raster(200, 10.0);
+    assertEqual(256, raster.getSize());
+    assertEqual(9, raster.getLevelCount());
+    assertEqual(1, raster.getSize(8));
+    assertEqualEpsilon(20.0 / 256, raster.getPixelSpan(), 1.0E-9);
+    assertEqual(size_t(0), raster.getTileCount());
+    assertFalse(raster.hasData());
+    assertEqual(ScanRaster::kEmpty, raster.getValue(0, 128, 128));
+
+    // Level choice follows the display pixel size.
+    //
+    assertEqual(0, raster.chooseLevel(raster.getPixelSpan() * 0.5));
+    assertEqual(0, raster.chooseLevel(raster.getPixelSpan() * 1.5));
+    assertEqual(2, raster.chooseLevel(raster.getPixelSpan() * 4.0));
+    assertEqual(8, raster.chooseLevel(1000.0));
+
+    // A full revolution must leave no holes inside the scan circle, with gates both finer and coarser than a
+    // pixel. Every pixel must also hold a gate whose range is close to the pixel's range.
+    //
+    double rangeFactors[] = {0.01, 0.5};
+    for (auto rangeFactor : rangeFactors) {
+        raster.clear();
+        size_t gates = size_t(10.0 / rangeFactor) + 1;
+        AddRevolution(raster, 4096, gates, rangeFactor);
+        assertTrue(raster.hasData());
+
+        int holes = 0;
+        int misplaced = 0;
+        for (int row = 0; row < raster.getSize(); ++row) {
+            for (int column = 0; column < raster.getSize(); ++column) {
+                double range = ::hypot(raster.getX(0, column), raster.getY(0, row));
+                if (range > 9.8) continue;
+                ScanRaster::Value value = raster.getValue(0, column, row);
+                if (value == ScanRaster::kEmpty) {
+                    ++holes;
+                } else if (std::abs(value * rangeFactor - range) > raster.getPixelSpan() + rangeFactor) {
+                    ++misplaced;
+                }
+            }
+        }
+
+        assertEqual(0, holes);
+        assertEqual(0, misplaced);
+
+        // Corners lie beyond the last gate.
+        //
+        assertEqual(ScanRaster::kEmpty, raster.getValue(0, 0, 0));
+    }
+
+    assertEqual(uint64_t(2 * 4096), raster.getStats().pris);
+
+    // Each coarser pixel holds the largest of the four below it.
+    //
+    raster.updatePyramid();
+    assertFalse(raster.isDirty());
+    for (int level = 1; level < raster.getLevelCount(); ++level) {
+        int size = raster.getSize(level);
+        for (int row = 0; row < size; ++row) {
+            for (int column = 0; column < size; ++column) {
+                ScanRaster::Value value =
+                    std::max(std::max(raster.getValue(level - 1, column * 2, row * 2),
+                                      raster.getValue(level - 1, column * 2 + 1, row * 2)),
+                             std::max(raster.getValue(level - 1, column * 2, row * 2 + 1),
+                                      raster.getValue(level - 1, column * 2 + 1, row * 2 + 1)));
+                assertEqual(value, raster.getValue(level, column, row));
+            }
+        }
+    }
+
+    // A later PRI replaces the values of an earlier one, even smaller ones, and the pyramid follows.
+    //
+    std::vector<ScanRaster::Value> samples(21, 7);
+    raster.add(0.0, 0.1, 0.0, 0.5, &samples[0], samples.size());
+    int column = raster.getSize() / 2;
+    int row = int((10.0 - 5.0) / raster.getPixelSpan());
+    assertEqual(ScanRaster::Value(7), raster.getValue(0, column, row));
+    assertTrue(raster.isDirty());
+    raster.updatePyramid();
+    assertEqual(ScanRaster::Value(7), raster.getValue(1, column / 2, row / 2));
+    assertEqual(ScanRaster::Value(20), raster.getValue(raster.getLevelCount() - 1, 0, 0));
+
+    // Within one PRI the largest gate wins.
+    //
+    samples.assign(1001, 0);
+    samples[504] = 99;
+    raster.add(M_PI, 0.01, 0.0, 0.01, &samples[0], samples.size());
+    assertEqual(ScanRaster::Value(99), raster.getValue(0, raster.getSize() / 2 - 1, raster.getSize() / 2 + 64));
+
+    // Clearing empties every level but keeps the tiles.
+    //
+    size_t tiles = raster.getTileCount();
+    raster.clear();
+    assertFalse(raster.hasData());
+    assertEqual(tiles, raster.getTileCount());
+    assertEqual(ScanRaster::kEmpty, raster.getValue(0, column, row));
+    assertEqual(ScanRaster::kEmpty, raster.getValue(raster.getLevelCount() - 1, 0, 0));
+
+    // Gates outside of the raster are ignored.
+    //
+    raster.reset(1.0);
+    raster.add(0.0, 0.1, 2.0, 0.5, &samples[0], samples.size());
+    assertFalse(raster.hasData());
+    assertFalse(raster.isDirty());
+
+    // Tiles are only allocated where samples land. A single PRI to the North covers one column of tiles above
+    // the center.
+    //
+    ScanRaster sparse(1024, 10.0);
+    samples.assign(21, 1);
+    sparse.add(0.0, 0.001, 0.5, 0.45, &samples[0], samples.size());
+    assertEqual(size_t(8), sparse.getTileCount());
+}
+
+int
+main(int argc, const char* argv[])
+{
+    return Test().mainRun();
+}
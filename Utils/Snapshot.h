@@ -0,0 +1,128 @@
+#ifndef UTILS_SNAPSHOT_H // -*- C++ -*-
+#define UTILS_SNAPSHOT_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+#include "boost/shared_ptr.hpp"
+
+namespace Utils {
+
+/** Versioned, immutable value handed from the threads that build it to the single thread that uses it. The user
+    calls update() at a point where a change is safe, such as the start of a message, and then works with get()
+    until the next update(). Between updates the value does not change, no matter how many versions are published
+    in the meantime.
+
+    When nothing new has been published, update() costs one atomic load. Otherwise it takes the newest version
+    with one atomic exchange; versions published and replaced before the user got to them are discarded unseen.
+    The previous value is not destroyed in the using thread but parked for the next publish() to release, so an
+    expensive teardown normally happens elsewhere.
+
+    Any number of threads may call publish(); a mutex keeps their calls from overlapping, and the using thread
+    never takes it. Calls to update() and get() must all come from one thread.
+*/
+template <typename T>
+class Snapshot {
+public:
+    using Ref = boost::shared_ptr<const T>;
+
+    /** Constructor. There is no value until the first update() after a publish().
+     */
+    Snapshot() : current_(), version_(0), pending_(nullptr), retired_(nullptr), published_(0), publishMutex_() {}
+
+    /** Constructor.
+
+        \param value the initial value, available immediately as version 1
+    */
+    explicit Snapshot(const Ref& value) :
+        current_(value), version_(1), pending_(nullptr), retired_(nullptr), published_(1), publishMutex_()
+    {
+    }
+
+    /** Destructor.
+     */
+    ~Snapshot()
+    {
+        delete pending_.load(std::memory_order_acquire);
+        delete retired_.load(std::memory_order_acquire);
+    }
+
+    /** Make a new value available to the next update(). Releases the value given up by the last update().
+
+        \param value new value
+    */
+    void publish(const Ref& value)
+    {
+        std::lock_guard<std::mutex> lock(publishMutex_);
+        delete retired_.exchange(nullptr, std::memory_order_acq_rel);
+        Entry* entry = new Entry(value, published_.load(std::memory_order_relaxed) + 1);
+        published_.store(entry->version, std::memory_order_relaxed);
+        delete pending_.exchange(entry, std::memory_order_acq_rel);
+    }
+
+    /** Adopt the newest published value, if there is one. Only call from the thread that uses the value.
+
+        \return true if the value changed
+    */
+    bool update()
+    {
+        if (!pending_.load(std::memory_order_acquire)) return false;
+        Entry* entry = pending_.exchange(nullptr, std::memory_order_acq_rel);
+        if (!entry) return false;
+        current_.swap(entry->value);
+        version_ = entry->version;
+        delete retired_.exchange(entry, std::memory_order_acq_rel);
+        return true;
+    }
+
+    /** Obtain the value adopted by the last update(). Only call from the thread that uses the value.
+
+        \return value, or NULL if nothing has been published
+    */
+    const T* get() const { return current_.get(); }
+
+    /** Obtain a reference to the value adopted by the last update(), for sharing with helper threads. Only call
+        from the thread that uses the value.
+
+        \return value reference
+    */
+    const Ref& getRef() const { return current_; }
+
+    /** Obtain the version of the value adopted by the last update(). Only call from the thread that uses the
+        value.
+
+        \return version, starting with 1 for the first value; 0 if none
+    */
+    uint64_t getVersion() const { return version_; }
+
+    /** Obtain the version given to the last value published.
+
+        \return version
+    */
+    uint64_t getPublishedVersion() const { return published_.load(std::memory_order_relaxed); }
+
+private:
+    struct Entry {
+        Entry(const Ref& v, uint64_t n) : value(v), version(n) {}
+        Ref value;
+        uint64_t version;
+    };
+
+    Snapshot(const Snapshot&);
+    Snapshot& operator=(const Snapshot&);
+
+    Ref current_;
+    uint64_t version_;
+    std::atomic<Entry*> pending_;
+    std::atomic<Entry*> retired_;
+    std::atomic<uint64_t> published_;
+    std::mutex publishMutex_;
+};
+
+} // end namespace Utils
+
+/** \file
+ */
+
+#endif
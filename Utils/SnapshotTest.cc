@@ -0,0 +1,110 @@
+#include "Threading/Threading.h"
+#include "UnitTest/UnitTest.h"
+
+#include "Snapshot.h"
+
+using namespace Utils;
+
+struct Test : public UnitTest::TestObj {
+    Test() : UnitTest::TestObj("Snapshot") {}
+    void test();
+};
+
+/** Value whose fields must always agree. A torn or recycled value would break the relationship.
+ */
+struct Pair {
+    Pair(int v) : a(v), b(2 * v) {}
+    ~Pair() { a = b = -1; }
+    int a;
+    int b;
+};
+
+using PairSnapshot = Snapshot<Pair>;
+
+struct Publisher : public Threading::Thread {
+    Publisher(PairSnapshot& snapshot, int count) : Thread(), snapshot_(snapshot), count_(count) {}
+
+    void run()
+    {
+        for (int index = 1; index <= count_; ++index) snapshot_.publish(PairSnapshot::Ref(new Pair(index)));
+    }
+
+    PairSnapshot& snapshot_;
+    int count_;
+};
+
+void
+Test::test()
+{
+    PairSnapshot snapshot;
+    assertFalse(snapshot.update());
+    assertTrue(snapshot.get() == 0);
+    assertEqual(uint64_t(0), snapshot.getVersion());
+
+    // Only the newest of several publications is seen, and only at update().
+    //
+    snapshot.publish(PairSnapshot::Ref(new Pair(1)));
+    snapshot.publish(PairSnapshot::Ref(new Pair(2)));
+    assertTrue(snapshot.get() == 0);
+    assertEqual(uint64_t(2), snapshot.getPublishedVersion());
+    assertTrue(snapshot.update());
+    assertEqual(2, snapshot.get()->a);
+    assertEqual(uint64_t(2), snapshot.getVersion());
+    assertFalse(snapshot.update());
+
+    // The value held by the user stays alive until the user moves on, even if the publisher releases its copy.
+    //
+    PairSnapshot::Ref held(snapshot.getRef());
+    snapshot.publish(PairSnapshot::Ref(new Pair(3)));
+    snapshot.publish(PairSnapshot::Ref(new Pair(4)));
+    assertEqual(2, snapshot.get()->a);
+    assertTrue(snapshot.update());
+    assertEqual(4, snapshot.get()->a);
+    assertEqual(2, held->a);
+
+    // Under concurrent publication every value seen is whole, and versions only move forward.
+    //
+    const int kCount = 200000;
+    PairSnapshot shared(PairSnapshot::Ref(new Pair(0)));
+    Publisher publisher(shared, kCount);
+    publisher.start();
+    uint64_t last = shared.getVersion();
+    int updates = 0;
+    while (shared.get()->a != kCount) {
+        if (shared.update()) {
+            ++updates;
+            const Pair* value = shared.get();
+            assertEqual(value->a * 2, value->b);
+            assertTrue(shared.getVersion() > last);
+            assertEqual(uint64_t(value->a + 1), shared.getVersion());
+            last = shared.getVersion();
+        }
+    }
+
+    publisher.join();
+    assertTrue(updates > 0);
+    assertEqual(uint64_t(kCount + 1), shared.getPublishedVersion());
+
+    // Several publishers at once neither lose versions nor leak or double-release values.
+    //
+    PairSnapshot many(PairSnapshot::Ref(new Pair(0)));
+    Publisher first(many, kCount / 4);
+    Publisher second(many, kCount / 4);
+    Publisher third(many, kCount / 4);
+    first.start();
+    second.start();
+    third.start();
+    first.join();
+    second.join();
+    third.join();
+    assertEqual(uint64_t(3 * (kCount / 4) + 1), many.getPublishedVersion());
+    assertTrue(many.update());
+    assertEqual(kCount / 4, many.get()->a);
+    assertEqual(many.getPublishedVersion(), many.getVersion());
+}
+
+int
+main(int argc, const char* argv[])
+{
+    return Test().mainRun();
+}
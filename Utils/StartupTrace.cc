@@ -0,0 +1,98 @@
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <map>
+
+#include "StartupTrace.h"
+
+using namespace Utils;
+
+StartupTrace&
+StartupTrace::Instance()
+{
+    // Never destroyed, since threads of the application may still record steps when static objects go away.
+    //
+    static StartupTrace* trace_ = new StartupTrace;
+    return *trace_;
+}
+
+StartupTrace::StartupTrace() : mutex_(Threading::Mutex::Make()), origin_(std::chrono::steady_clock::now()), steps_()
+{
+    ;
+}
+
+void
+StartupTrace::reset()
+{
+    Threading::Locker lock(mutex_);
+    origin_ = std::chrono::steady_clock::now();
+    steps_.clear();
+}
+
+double
+StartupTrace::now() const
+{
+    Threading::Locker lock(mutex_);
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - origin_).count();
+}
+
+void
+StartupTrace::add(const std::string& category, const std::string& name, double start, double elapsed)
+{
+    Step step = {category, name, start, elapsed};
+    Threading::Locker lock(mutex_);
+    steps_.push_back(step);
+}
+
+std::vector<StartupTrace::Step>
+StartupTrace::getSteps() const
+{
+    Threading::Locker lock(mutex_);
+    return steps_;
+}
+
+std::ostream&
+StartupTrace::report(std::ostream& os, size_t slowest) const
+{
+    double wall = now();
+    std::vector<Step> steps(getSteps());
+
+    struct Summary {
+        Summary() : total(0.0), count(0), longest(0) {}
+        double total;
+        size_t count;
+        const Step* longest;
+    };
+
+    std::map<std::string, Summary> byCategory;
+    for (const auto& step : steps) {
+        Summary& summary(byCategory[step.category]);
+        summary.total += step.elapsed;
+        ++summary.count;
+        if (!summary.longest || step.elapsed > summary.longest->elapsed) summary.longest = &step;
+    }
+
+    std::vector<std::pair<std::string, Summary>> categories(byCategory.begin(), byCategory.end());
+    std::sort(categories.begin(), categories.end(),
+              [](const std::pair<std::string, Summary>& a, const std::pair<std::string, Summary>& b) {
+                  return a.second.total > b.second.total;
+              });
+
+    os << std::fixed << std::setprecision(3) << "startup " << wall << " sec wall-clock, " << steps.size()
+       << " steps\n";
+    for (const auto& entry : categories) {
+        os << "  " << std::left << std::setw(12) << entry.first << std::right << std::setw(10) << entry.second.total
+           << " sec in " << std::setw(4) << entry.second.count << " - longest " << entry.second.longest->elapsed
+           << " sec " << entry.second.longest->name << '\n';
+    }
+
+    std::sort(steps.begin(), steps.end(), [](const Step& a, const Step& b) { return a.elapsed > b.elapsed; });
+    if (steps.size() > slowest) steps.resize(slowest);
+    if (!steps.empty()) os << "  slowest steps:\n";
+    for (const auto& step : steps) {
+        os << "    " << std::setw(10) << step.elapsed << " sec at " << std::setw(8) << step.start << ' '
+           << step.category << ' ' << step.name << '\n';
+    }
+
+    return os;
+}
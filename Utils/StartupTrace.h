@@ -0,0 +1,117 @@
+#ifndef UTILS_STARTUPTRACE_H // -*- C++ -*-
+#define UTILS_STARTUPTRACE_H
+
+#include <chrono>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "Threading/Threading.h"
+
+namespace Utils {
+
+/** Process-wide record of how long the steps of application startup take. Each step has a category, such as
+    "dll" or "stream", and a name that identifies the instance, such as the algorithm or stream name. Steps may
+    overlap when several threads build parts of the application at once, so the report shows both the sum of the
+    time spent in each category and the wall-clock time since the trace began.
+
+    Adding a step takes a mutex, so the class is meant for one-time work and not for message processing paths.
+*/
+class StartupTrace {
+public:
+    /** Record of one startup step.
+     */
+    struct Step {
+        std::string category; ///< Kind of work done
+        std::string name;     ///< What the work was done for
+        double start;         ///< Seconds between the beginning of the trace and the start of the step
+        double elapsed;       ///< Duration of the step in seconds
+    };
+
+    /** Timer that records a step covering its own lifetime.
+     */
+    class Scope {
+    public:
+        /** Constructor. Starts the step.
+
+            \param category kind of work done
+
+            \param name what the work is done for
+        */
+        Scope(const std::string& category, const std::string& name) :
+            category_(category), name_(name), start_(StartupTrace::Instance().now())
+        {
+        }
+
+        /** Destructor. Records the step.
+         */
+        ~Scope() { StartupTrace::Instance().add(category_, name_, start_, StartupTrace::Instance().now() - start_); }
+
+    private:
+        std::string category_;
+        std::string name_;
+        double start_;
+    };
+
+    /** Obtain the trace for the process.
+
+        \return trace reference
+    */
+    static StartupTrace& Instance();
+
+    /** Forget all recorded steps, and begin timing anew.
+     */
+    void reset();
+
+    /** Obtain the number of seconds since the trace began.
+
+        \return elapsed seconds
+    */
+    double now() const;
+
+    /** Record a step.
+
+        \param category kind of work done
+
+        \param name what the work was done for
+
+        \param start value of now() when the step began
+
+        \param elapsed duration of the step in seconds
+    */
+    void add(const std::string& category, const std::string& name, double start, double elapsed);
+
+    /** Obtain the steps recorded so far, in the order they finished.
+
+        \return step list
+    */
+    std::vector<Step> getSteps() const;
+
+    /** Write a breakdown of the startup time: the wall-clock time so far, the total, count, and longest step of
+        each category in order of decreasing total, and the slowest steps overall.
+
+        \param os stream to write to
+
+        \param slowest number of slowest steps to list
+
+        \return stream written to
+    */
+    std::ostream& report(std::ostream& os, size_t slowest = 10) const;
+
+private:
+    StartupTrace();
+
+    StartupTrace(const StartupTrace&);
+    StartupTrace& operator=(const StartupTrace&);
+
+    Threading::Mutex::Ref mutex_;
+    std::chrono::steady_clock::time_point origin_;
+    std::vector<Step> steps_;
+};
+
+} // end namespace Utils
+
+/** \file
+ */
+
+#endif
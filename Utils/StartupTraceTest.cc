@@ -0,0 +1,73 @@
+#include <sstream>
+
+#include "Threading/Threading.h"
+#include "UnitTest/UnitTest.h"
+
+#include "StartupTrace.h"
+
+using namespace Utils;
+
+struct Test : public UnitTest::TestObj {
+    Test() : UnitTest::TestObj("StartupTrace") {}
+    void test();
+};
+
+struct Builder : public Threading::Thread {
+    Builder(const std::string& name) : Thread(), name_(name) {}
+
+    void run()
+    {
+        StartupTrace::Scope scope("stream", name_);
+        Threading::Thread::Sleep(0.02);
+    }
+
+    std::string name_;
+};
+
+void
+Test::test()
+{
+    StartupTrace& trace(StartupTrace::Instance());
+    trace.reset();
+    assertEqual(size_t(0), trace.getSteps().size());
+
+    trace.add("config", "test.xml", 0.0, 0.005);
+    {
+        StartupTrace::Scope scope("dll", "libslow");
+        Threading::Thread::Sleep(0.01);
+    }
+
+    // Steps recorded by overlapping threads all show up, and count in full toward their category.
+    //
+    Builder one("one"), two("two");
+    one.start();
+    two.start();
+    one.join();
+    two.join();
+
+    std::vector<StartupTrace::Step> steps(trace.getSteps());
+    assertEqual(size_t(4), steps.size());
+    assertEqual(std::string("config"), steps[0].category);
+    assertEqual(std::string("libslow"), steps[1].name);
+    assertTrue(steps[1].elapsed >= 0.01);
+    assertTrue(steps[2].start >= steps[1].start + steps[1].elapsed);
+    assertEqual(std::string("stream"), steps[3].category);
+    assertTrue(trace.now() >= steps[3].start + steps[3].elapsed);
+
+    std::ostringstream os;
+    trace.report(os, 2);
+    std::string text(os.str());
+    assertTrue(text.find("4 steps") != std::string::npos);
+    assertTrue(text.find("stream") < text.find("dll"));
+    assertTrue(text.find("dll") < text.find("config"));
+    assertTrue(text.find("libslow") != std::string::npos);
+
+    trace.reset();
+    assertEqual(size_t(0), trace.getSteps().size());
+}
+
+int
+main(int argc, const char* argv[])
+{
+    return Test().mainRun();
+}
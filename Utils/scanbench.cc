@@ -0,0 +1,139 @@
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Time/TimeStamp.h"
+#include "Utils/CmdLineArgs.h"
+#include "Utils/ScanRaster.h"
+#include "Utils/Utils.h"
+
+using namespace SideCar;
+using namespace Utils;
+
+const std::string about = "Time the scan conversion of PRIs into a ScanRaster and the upkeep of its pyramid, and "
+                          "compare redrawing a revolution from the raster against redrawing it from its PRIs.";
+
+const Utils::CmdLineArgs::OptionDef opts[] = {
+    {'d', "display", "display size in pixels (default 1000)", "N"},
+    {'g', "gates", "gates per PRI (default 4096)", "N"},
+    {'n', "revolutions", "number of revolutions to process (default 10)", "N"},
+    {'p', "pris", "PRIs per revolution (default 4096)", "N"},
+    {'r', "range", "range of the last gate in kilometers (default 100)", "N"},
+    {'s', "size", "raster size in pixels (default 1024)", "N"},
+};
+
+/** Point emitted by a redraw, like the vertex and color pairs that a VertexGenerator produces.
+ */
+struct Point {
+    float x;
+    float y;
+    int16_t value;
+};
+
+static void
+Report(const char* label, double elapsed, double count, const char* units)
+{
+    std::cout << std::setw(24) << label << std::fixed << std::setprecision(3) << std::setw(12) << elapsed * 1.0E3
+              << " msecs " << std::setw(10) << std::setprecision(2) << elapsed * 1.0E9 / count << " nsecs/"
+              << units << '\n';
+}
+
+int
+main(int argc, char** argv)
+{
+    Utils::CmdLineArgs cla(argc, argv, about, opts, sizeof(opts), 0, 0);
+
+    int display = 1000, gates = 4096, revolutions = 10, pris = 4096, size = 1024;
+    double rangeMax = 100.0;
+    if (cla.hasOpt("display")) cla.opt("display")[0] >> display;
+    if (cla.hasOpt("gates")) cla.opt("gates")[0] >> gates;
+    if (cla.hasOpt("revolutions")) cla.opt("revolutions")[0] >> revolutions;
+    if (cla.hasOpt("pris")) cla.opt("pris")[0] >> pris;
+    if (cla.hasOpt("range")) cla.opt("range")[0] >> rangeMax;
+    if (cla.hasOpt("size")) cla.opt("size")[0] >> size;
+
+    double rangeFactor = rangeMax / gates;
+    double span = kCircleRadians / pris;
+
+    ::srand(1234);
+    std::vector<std::vector<ScanRaster::Value>> samples(16, std::vector<ScanRaster::Value>(gates));
+    for (auto& pri : samples) {
+        for (auto& value : pri) value = ::rand() % 10 ? ::rand() % 200 : ::rand() % 3000;
+    }
+
+    ScanRaster raster(size, rangeMax);
+
+    double addTime = 0.0;
+    double pyramidTime = 0.0;
+    for (int revolution = 0; revolution < revolutions; ++revolution) {
+        Time::TimeStamp start(Time::TimeStamp::Now());
+        for (int pri = 0; pri < pris; ++pri) {
+            const auto& data(samples[pri % samples.size()]);
+            raster.add(pri * span, span, 0.0, rangeFactor, &data[0], data.size());
+        }
+        addTime += (Time::TimeStamp::Now() - start).asDouble();
+
+        start = Time::TimeStamp::Now();
+        raster.updatePyramid();
+        pyramidTime += (Time::TimeStamp::Now() - start).asDouble();
+    }
+
+    const ScanRaster::Stats& stats(raster.getStats());
+    Report("add", addTime / revolutions, double(pris), "PRI");
+    Report("add", addTime / revolutions, double(stats.gates) / revolutions, "gate");
+    Report("updatePyramid", pyramidTime / revolutions, double(stats.tilesUpdated) / revolutions, "tile");
+
+    // Redraw one revolution on a display of the given size, first from every PRI, and then from the raster level
+    // that matches the display pixels.
+    //
+    std::vector<Point> points;
+    points.reserve(size_t(pris) * gates);
+
+    Time::TimeStamp start(Time::TimeStamp::Now());
+    for (int pass = 0; pass < revolutions; ++pass) {
+        points.clear();
+        for (int pri = 0; pri < pris; ++pri) {
+            const auto& data(samples[pri % samples.size()]);
+            double sine = ::sin(pri * span);
+            double cosine = ::cos(pri * span);
+            for (int gate = 0; gate < gates; ++gate) {
+                double range = gate * rangeFactor;
+                Point point = {float(range * sine), float(range * cosine), data[gate]};
+                points.push_back(point);
+            }
+        }
+    }
+    double fromPRIs = (Time::TimeStamp::Now() - start).asDouble() / revolutions;
+    size_t priPoints = points.size();
+
+    int level = raster.chooseLevel(2.0 * rangeMax / display);
+    int levelSize = raster.getSize(level);
+    start = Time::TimeStamp::Now();
+    for (int pass = 0; pass < revolutions; ++pass) {
+        points.clear();
+        for (int row = 0; row < levelSize; ++row) {
+            float y = raster.getY(level, row);
+            for (int column = 0; column < levelSize; ++column) {
+                ScanRaster::Value value = raster.getValue(level, column, row);
+                if (value == ScanRaster::kEmpty) continue;
+                Point point = {float(raster.getX(level, column)), y, value};
+                points.push_back(point);
+            }
+        }
+    }
+    double fromRaster = (Time::TimeStamp::Now() - start).asDouble() / revolutions;
+
+    Report("redraw from PRIs", fromPRIs, double(priPoints), "point");
+    Report("redraw from raster", fromRaster, double(points.size()), "point");
+
+    std::cout << "raster: " << raster.getSize() << " pixels, " << raster.getTileCount() << " tiles, level " << level
+              << " for a " << display << " pixel display\n"
+              << "points: " << priPoints << " from PRIs, " << points.size() << " from raster, speedup "
+              << std::setprecision(1) << fromPRIs / fromRaster << "x\n"
+              << "writes/gate: " << std::setprecision(2) << double(stats.writes) / stats.gates << '\n';
+
+    return 0;
+}
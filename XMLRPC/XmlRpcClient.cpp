@@ -36,6 +36,9 @@ XmlRpcClient::XmlRpcClient( const std::string& host, int port,
     _connectionState = NO_CONNECTION;
     _executing = false;
     _eof = false;
+    _isFault = false;
+    _serverClosing = false;
+    _expectedResponses = 0;
 
     // Default to keeping the connection open until an explicit close is done
     setKeepOpen();
@@ -50,6 +53,9 @@ XmlRpcClient::XmlRpcClient( const std::string& host, int port )
     _connectionState = NO_CONNECTION;
     _executing = false;
     _eof = false;
+    _isFault = false;
+    _serverClosing = false;
+    _expectedResponses = 0;
 
     // Default to keeping the connection open until an explicit close is done
     setKeepOpen();
@@ -106,10 +112,11 @@ XmlRpcClient::execute(const char* method, XmlRpcValue const& params, XmlRpcValue
     return false;
 
   result.clear();
-  double msTime = -1.0;   // Process until exit is called
-  _disp.work(msTime);
+  if ( ! exchange(1))
+    return false;
 
-  if (_connectionState != IDLE || ! parseResponse(result))
+  _response.swap(_responses[0]);
+  if ( ! parseResponse(result))
     return false;
 
   XmlRpcUtil::log(1, "XmlRpcClient::execute: method %s completed.", method);
@@ -117,6 +124,72 @@ XmlRpcClient::execute(const char* method, XmlRpcValue const& params, XmlRpcValue
   return true;
 }
 
+// Execute a sequence of procedures on the remote server, writing all of the
+// requests before reading the responses.
+bool 
+XmlRpcClient::executePipelined(std::vector<Call> const& calls, std::vector<XmlRpcValue>& results,
+                               std::vector<bool>* faults)
+{
+  XmlRpcUtil::log(1, "XmlRpcClient::executePipelined: %d calls (_connectionState %d).", int(calls.size()),
+                  _connectionState);
+
+  results.clear();
+  if (faults) faults->clear();
+  if (calls.empty())
+    return true;
+
+  if (_executing)
+    return false;
+
+  _executing = true;
+  ClearFlagOnExit cf(_executing);
+
+  _sendAttempts = 0;
+  _isFault = false;
+
+  if ( ! setupConnection())
+    return false;
+
+  std::string batch;
+  for (size_t index = 0; index < calls.size(); ++index) {
+    if ( ! generateRequest(calls[index].method.c_str(), calls[index].params))
+      return false;
+    batch += _request;
+  }
+  _request.swap(batch);
+
+  if ( ! exchange(calls.size()))
+    return false;
+
+  results.resize(calls.size());
+  bool anyFault = false;
+  for (size_t index = 0; index < calls.size(); ++index) {
+    _isFault = false;
+    _response.swap(_responses[index]);
+    if ( ! parseResponse(results[index]))
+      return false;
+    if (faults) faults->push_back(_isFault);
+    anyFault = anyFault || _isFault;
+  }
+
+  _isFault = anyFault;
+  XmlRpcUtil::log(1, "XmlRpcClient::executePipelined: %d calls completed.", int(calls.size()));
+  return true;
+}
+
+// Send the contents of _request and collect the given number of responses.
+bool
+XmlRpcClient::exchange(size_t expectedResponses)
+{
+  _responses.clear();
+  _expectedResponses = expectedResponses;
+
+  double msTime = -1.0;   // Process until exit is called
+  _disp.work(msTime);
+
+  return _connectionState == IDLE && _responses.size() == expectedResponses;
+}
+
 // XmlRpcSource interface implementation
 // Handle server responses. Called by the event dispatcher during execute.
 unsigned
@@ -133,18 +206,36 @@ XmlRpcClient::handleEvent(unsigned eventType)
     return 0;
   }
 
-  if (_connectionState == WRITE_REQUEST)
-    if ( ! writeRequest()) return 0;
+  // While a long pipelined batch is still being written, the server may
+  // already be answering. Buffer what it sends so that neither side blocks.
+  if (_connectionState == WRITE_REQUEST && eventType == XmlRpcDispatch::ReadableEvent) {
+    if ( ! XmlRpcSocket::nbRead(this->getfd(), _header, &_eof)) {
+      XmlRpcUtil::error("Error in XmlRpcClient::handleEvent: read error (%s).",XmlRpcSocket::getErrorMsg().c_str());
+      return 0;
+    }
+  }
+
+  for (;;) {
+    if (_connectionState == WRITE_REQUEST)
+      if ( ! writeRequest()) return 0;
+
+    if (_connectionState == READ_HEADER)
+      if ( ! readHeader()) return 0;
 
-  if (_connectionState == READ_HEADER)
-    if ( ! readHeader()) return 0;
+    if (_connectionState != READ_RESPONSE)
+      break;
 
-  if (_connectionState == READ_RESPONSE)
+    size_t received = _responses.size();
     if ( ! readResponse()) return 0;
 
+    // Process any pipelined responses that are already buffered
+    if (_responses.size() == received || _connectionState != READ_HEADER || _header.empty())
+      break;
+  }
+
   // This should probably always ask for Exception events too
   return (_connectionState == WRITE_REQUEST) 
-        ? XmlRpcDispatch::WritableEvent : XmlRpcDispatch::ReadableEvent;
+        ? XmlRpcDispatch::WritableEvent | XmlRpcDispatch::ReadableEvent : XmlRpcDispatch::ReadableEvent;
 }
 
 
@@ -153,10 +244,11 @@ bool
 XmlRpcClient::setupConnection()
 {
   // If an error occurred last time through, or if the server closed the connection, close our end
-  if ((_connectionState != NO_CONNECTION && _connectionState != IDLE) || _eof)
+  if ((_connectionState != NO_CONNECTION && _connectionState != IDLE) || _eof || _serverClosing)
     close();
 
   _eof = false;
+  _serverClosing = false;
   if (_connectionState == NO_CONNECTION)
     if (! doConnect()) 
       return false;
@@ -195,6 +287,8 @@ XmlRpcClient::doConnect()
     return false;
   }
 
+  (void) XmlRpcSocket::setNoDelay(fd);
+
   if ( ! XmlRpcSocket::connect(fd, _host, _port))
   {
     this->close();
@@ -220,14 +314,14 @@ XmlRpcClient::generateRequest(const char* methodName, XmlRpcValue const& params)
     {
       for (int i=0; i<params.size(); ++i) {
         body += PARAM_TAG;
-        body += params[i].toXml();
+        params[i].toXml(body);
         body += PARAM_ETAG;
       }
     }
     else
     {
       body += PARAM_TAG;
-      body += params.toXml();
+      params.toXml(body);
       body += PARAM_ETAG;
     }
       
@@ -279,9 +373,9 @@ XmlRpcClient::writeRequest()
     
   XmlRpcUtil::log(3, "XmlRpcClient::writeRequest: wrote %d of %d bytes.", _bytesWritten, _request.length());
 
-  // Wait for the result
+  // Wait for the result. Any response data that arrived during the write is
+  // already in _header.
   if (_bytesWritten == int(_request.length())) {
-    _header = "";
     _response = "";
     _connectionState = READ_HEADER;
   }
@@ -299,7 +393,7 @@ XmlRpcClient::readHeader()
 
     // If we haven't read any data yet and this is a keep-alive connection, the server may
     // have timed out, so we try one more time.
-    if (getKeepOpen() && _header.length() == 0 && _sendAttempts++ == 0) {
+    if (getKeepOpen() && _header.length() == 0 && _responses.empty() && _sendAttempts++ == 0) {
       XmlRpcUtil::log(4, "XmlRpcClient::readHeader: re-trying connection");
       XmlRpcSource::close();
       _connectionState = NO_CONNECTION;
@@ -318,10 +412,13 @@ XmlRpcClient::readHeader()
   char *ep = hp + _header.length();   // End of string
   char *bp = 0;                       // Start of body
   char *lp = 0;                       // Start of content-length value
+  char *kp = 0;                       // Start of connection value
 
   for (char *cp = hp; (bp == 0) && (cp < ep); ++cp) {
     if ((ep - cp > 16) && (strncasecmp(cp, "Content-length: ", 16) == 0))
       lp = cp + 16;
+    else if ((ep - cp > 12) && (strncasecmp(cp, "Connection: ", 12) == 0))
+      kp = cp + 12;
     else if ((ep - cp > 4) && (strncmp(cp, "\r\n\r\n", 4) == 0))
       bp = cp + 4;
     else if ((ep - cp > 2) && (strncmp(cp, "\n\n", 2) == 0))
@@ -353,9 +450,14 @@ XmlRpcClient::readHeader()
   	
   XmlRpcUtil::log(4, "client read content length: %d", _contentLength);
 
+  // A server that will close the connection after this response forces a
+  // reconnect on the next request.
+  if (kp != 0 && strncasecmp(kp, "close", 5) == 0)
+    _serverClosing = true;
+
   // Otherwise copy non-header data to response buffer and set state to read response.
-  _response = bp;
-  _header = "";   // should parse out any interesting bits from the header (connection, etc)...
+  _response.assign(bp, ep - bp);
+  _header = "";
   _connectionState = READ_RESPONSE;
   return true;    // Continue monitoring this source
 }
@@ -381,10 +483,24 @@ XmlRpcClient::readResponse()
     }
   }
 
-  // Otherwise, parse and return the result
+  // Anything past the end of the body belongs to the next pipelined response
+  if (int(_response.length()) > _contentLength) {
+    _header.assign(_response, _contentLength, std::string::npos);
+    _response.resize(_contentLength);
+  }
+
+  // Otherwise, save the response for parsing
   XmlRpcUtil::log(3, "XmlRpcClient::readResponse (read %d bytes)", _response.length());
   XmlRpcUtil::log(5, "response:\n%s", _response.c_str());
 
+  _responses.push_back(std::string());
+  _responses.back().swap(_response);
+  if (_responses.size() < _expectedResponses) {
+    _connectionState = READ_HEADER;
+    return true;
+  }
+
+  _header = "";
   _connectionState = IDLE;
 
   return false;    // Stop monitoring this source (causes return from work)
@@ -405,9 +521,8 @@ XmlRpcClient::parseResponse(XmlRpcValue& result)
   // Expect either <params><param>... or <fault>...
   if ((XmlRpcUtil::nextTagIs(PARAMS_TAG,_response,&offset) &&
        XmlRpcUtil::nextTagIs(PARAM_TAG,_response,&offset)) ||
-      XmlRpcUtil::nextTagIs(FAULT_TAG,_response,&offset))
+      (_isFault = XmlRpcUtil::nextTagIs(FAULT_TAG,_response,&offset)))
   {
-      _isFault = true;
     if ( ! result.fromXml(_response, &offset)) {
       XmlRpcUtil::error("Error in XmlRpcClient::parseResponse: Invalid response value. Response:\n%s", _response.c_str());
       _response = "";
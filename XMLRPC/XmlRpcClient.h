@@ -6,16 +6,15 @@
 
 #ifndef MAKEDEPEND
 #include <string>
+#include <vector>
 #endif
 
 #include "XmlRpcDispatch.h"
 #include "XmlRpcSource.h"
+#include "XmlRpcValue.h"
 
 namespace XmlRpc {
 
-// Arguments and results are represented by XmlRpcValues
-class XmlRpcValue;
-
 //! A class to send XML RPC requests to a server and return the results.
 class XmlRpcClient : public XmlRpcSource {
 public:
@@ -63,7 +62,36 @@ public:
     //! to determine whether the result is a fault response.
     bool execute(const char* method, XmlRpcValue const& params, XmlRpcValue& result);
 
-    //! Returns true if the result of the last execute() was a fault response.
+    //! A remote procedure name and its arguments. \see executePipelined
+    struct Call {
+        std::string method;
+        XmlRpcValue params;
+    };
+
+    //! Execute a sequence of procedures on the remote server over the
+    //! connection, writing all of the requests before waiting for any of the
+    //! responses. This saves a round trip per call when talking to a server
+    //! that keeps connections alive.
+
+    //!  \param calls The procedures to execute, in order
+
+    //!  \param results The result values, one per call, in the same order
+
+    //!  \param faults If not NULL, receives one flag per call that is true if
+    //!   the corresponding result is a fault response
+
+    //!  \return true if all requests were sent and all results received
+    bool executePipelined(std::vector<Call> const& calls, std::vector<XmlRpcValue>& results,
+                          std::vector<bool>* faults = 0);
+
+    //! Returns the name of the remote host.
+    std::string const& getHost() const { return _host; }
+
+    //! Returns the port of the remote server.
+    int getPort() const { return _port; }
+
+    //! Returns true if the result of the last execute() was a fault response,
+    //! or if any result of the last executePipelined() was.
     bool isFault() const { return _isFault; }
 
     // XmlRpcSource interface implementation
@@ -88,6 +116,9 @@ protected:
     virtual bool readResponse();
     virtual bool parseResponse(XmlRpcValue& result);
 
+    // Write _request and run the dispatcher until the responses arrive
+    bool exchange(size_t expectedResponses);
+
     // Possible IO states for the connection
     enum ClientConnectionState { NO_CONNECTION, CONNECTING, WRITE_REQUEST, READ_HEADER, READ_RESPONSE, IDLE };
     ClientConnectionState _connectionState;
@@ -97,11 +128,16 @@ protected:
     std::string _uri;
     int _port;
 
-    // The xml-encoded request, http header of response, and response xml
+    // The xml-encoded request, http header of response (followed by any
+    // data read past the current response), and response xml
     std::string _request;
     std::string _header;
     std::string _response;
 
+    // Completed response bodies, and the number expected for the current exchange
+    std::vector<std::string> _responses;
+    size_t _expectedResponses;
+
     // Number of times the client has attempted to send the request
     int _sendAttempts;
 
@@ -115,6 +151,9 @@ protected:
     // True if the server closed the connection
     bool _eof;
 
+    // True if the server said it would close the connection after its response
+    bool _serverClosing;
+
     // True if a fault response was returned by the server
     bool _isFault;
 
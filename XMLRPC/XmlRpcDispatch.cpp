@@ -1,5 +1,5 @@
 #include <errno.h>
-#include <iostream>
+#include <string.h>
 
 #include "XmlRpcDispatch.h"
 #include "XmlRpcSource.h"
@@ -18,22 +18,42 @@
 # endif
 #else
 # include <sys/time.h>
+# include <unistd.h>
 #endif  // _WINDOWS
 
+#if defined(XMLRPC_USE_EPOLL)
+# include <sys/epoll.h>
+#endif
+
 
 using namespace XmlRpc;
 
+//! Maximum number of readiness reports to fetch from the kernel in one call
+static const int kMaxEvents = 64;
+
 
 XmlRpcDispatch::XmlRpcDispatch()
 {
+    _nextId = 0;
+    _epollFd = -1;
     _endTime = -1.0;
     _doClear = false;
     _inWork = false;
+
+#if defined(XMLRPC_USE_EPOLL)
+    _epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    if (_epollFd < 0)
+	XmlRpcUtil::error("XmlRpcDispatch: epoll_create1 failed (%d), using select.", errno);
+#endif
 }
 
 
 XmlRpcDispatch::~XmlRpcDispatch()
 {
+#if defined(XMLRPC_USE_EPOLL)
+    if (_epollFd >= 0)
+	::close(_epollFd);
+#endif
 }
 
 // Monitor this source for the specified events and call its event handler
@@ -41,7 +61,10 @@ XmlRpcDispatch::~XmlRpcDispatch()
 void
 XmlRpcDispatch::addSource(XmlRpcSource* source, unsigned mask)
 {
-    _sources.push_back(MonitoredSource(source, mask));
+    unsigned long id = ++_nextId;
+    SourceList::iterator pos = _sources.insert(_sources.end(), MonitoredSource(source, mask, id));
+    _index[id] = pos;
+    sync(*pos);
 }
 
 // Stop monitoring this source. Does not close the source.
@@ -51,7 +74,7 @@ XmlRpcDispatch::removeSource(XmlRpcSource* source)
     for (SourceList::iterator it=_sources.begin(); it!=_sources.end(); ++it)
 	if (it->getSource() == source)
 	{
-	    _sources.erase(it);
+	    unregister(it);
 	    break;
 	}
 }
@@ -65,11 +88,159 @@ XmlRpcDispatch::setSourceEvents(XmlRpcSource* source, unsigned eventMask)
 	if (it->getSource() == source)
 	{
 	    it->getMask() = eventMask;
+	    sync(*it);
 	    break;
 	}
 }
 
 
+// Make the kernel event set agree with the source's mask and descriptor.
+// Sources with an empty mask or without a descriptor are not registered.
+void
+XmlRpcDispatch::sync(MonitoredSource& source)
+{
+#if defined(XMLRPC_USE_EPOLL)
+    if (_epollFd < 0)
+	return;
+
+    int fd = source.getSource()->getfd();
+    unsigned mask = fd < 0 ? 0 : source.getMask();
+
+    // The source closed (and perhaps reopened) its descriptor. Closing removes
+    // it from the epoll set, and the number may now belong to someone else,
+    // so it must not be touched.
+    if (source._registered && source._fd != fd)
+	source._registered = 0;
+
+    if (mask == source._registered)
+	return;
+
+    int op = EPOLL_CTL_MOD;
+    if (! mask)
+	op = EPOLL_CTL_DEL;
+    else if (! source._registered)
+	op = EPOLL_CTL_ADD;
+
+    struct epoll_event event;
+    ::memset(&event, 0, sizeof(event));
+    if (mask & ReadableEvent) event.events |= EPOLLIN;
+    if (mask & WritableEvent) event.events |= EPOLLOUT;
+    if (mask & Exception)     event.events |= EPOLLPRI;
+    event.data.u64 = source._id;
+
+    if (::epoll_ctl(_epollFd, op, fd, &event) < 0) {
+	// The descriptor may already be gone or may be unknown to the kernel
+	// after a close; both leave nothing registered.
+	if (op == EPOLL_CTL_MOD && errno == ENOENT &&
+	    ::epoll_ctl(_epollFd, EPOLL_CTL_ADD, fd, &event) == 0) {
+	    source._fd = fd;
+	    source._registered = mask;
+	    return;
+	}
+	if (op != EPOLL_CTL_DEL)
+	    XmlRpcUtil::error("Error in XmlRpcDispatch::sync: epoll_ctl(%d) on %d failed (%d).",
+			      op, fd, errno);
+	source._registered = 0;
+	return;
+    }
+
+    source._fd = fd;
+    source._registered = mask;
+#endif
+}
+
+
+// Forget a source without closing it
+void
+XmlRpcDispatch::unregister(SourceList::iterator pos)
+{
+    pos->getMask() = 0;
+    sync(*pos);
+    _index.erase(pos->_id);
+    _sources.erase(pos);
+}
+
+
+// Block until at least one source is ready or the timeout expires
+bool
+XmlRpcDispatch::waitForEvents(double timeout, std::vector<ReadyEvent>& ready)
+{
+    ready.clear();
+
+#if defined(XMLRPC_USE_EPOLL)
+    if (_epollFd >= 0) {
+	struct epoll_event events[kMaxEvents];
+	int msecs = timeout < 0.0 ? -1 : (int)ceil(timeout * 1000.0);
+	int nEvents = ::epoll_wait(_epollFd, events, kMaxEvents, msecs);
+	if (nEvents < 0)
+	    return errno == EINTR;
+
+	for (int index = 0; index < nEvents; ++index) {
+	    unsigned flags = events[index].events;
+	    ReadyEvent event;
+	    event._id = events[index].data.u64;
+	    event._events = 0;
+	    // Hang-ups and errors are reported the way select() reports them: the
+	    // descriptor is readable and writable, and the next I/O call fails.
+	    if (flags & (EPOLLIN | EPOLLHUP | EPOLLERR)) event._events |= ReadableEvent;
+	    if (flags & (EPOLLOUT | EPOLLHUP | EPOLLERR)) event._events |= WritableEvent;
+	    if (flags & EPOLLPRI)			  event._events |= Exception;
+	    ready.push_back(event);
+	}
+
+	return true;
+    }
+#endif
+
+    // Construct the sets of descriptors we are interested in
+    fd_set inFd, outFd, excFd;
+    FD_ZERO(&inFd);
+    FD_ZERO(&outFd);
+    FD_ZERO(&excFd);
+
+    int maxFd = -1;     // Not used on windows
+    SourceList::iterator it;
+    for (it=_sources.begin(); it!=_sources.end(); ++it) {
+	int fd = it->getSource()->getfd();
+	if (fd < 0) continue;
+	if (it->getMask() & ReadableEvent) FD_SET(fd, &inFd);
+	if (it->getMask() & WritableEvent) FD_SET(fd, &outFd);
+	if (it->getMask() & Exception)     FD_SET(fd, &excFd);
+	if (it->getMask() && fd > maxFd)   maxFd = fd;
+    }
+
+    // Check for events
+    int nEvents;
+    if (timeout < 0.0)
+	nEvents = ::select( maxFd+1, &inFd, &outFd, &excFd, NULL);
+    else 
+    {
+	struct timeval tv;
+	tv.tv_sec = (int)floor(timeout);
+	tv.tv_usec = ((int)floor(1000000.0 * (timeout-floor(timeout)))) %
+	    1000000;
+	nEvents = ::select( maxFd+1, &inFd, &outFd, &excFd, &tv);
+    }
+
+    if (nEvents < 0)
+	return errno == EINTR;
+
+    for (it=_sources.begin(); it!=_sources.end(); ++it) {
+	int fd = it->getSource()->getfd();
+	if (fd < 0 || fd > maxFd) continue;
+	ReadyEvent event;
+	event._id = it->_id;
+	event._events = 0;
+	if (FD_ISSET(fd, &inFd))  event._events |= ReadableEvent;
+	if (FD_ISSET(fd, &outFd)) event._events |= WritableEvent;
+	if (FD_ISSET(fd, &excFd)) event._events |= Exception;
+	if (event._events)
+	    ready.push_back(event);
+    }
+
+    return true;
+}
+
 
 // Watch current set of sources and process events
 void
@@ -80,87 +251,71 @@ XmlRpcDispatch::work(double timeout)
     _doClear = false;
     _inWork = true;
 
+    std::vector<ReadyEvent> ready;
+    ready.reserve(kMaxEvents);
+
     // Only work while there is something to monitor
     while (_sources.size() > 0) {
 
-again:
-	// Construct the sets of descriptors we are interested in
-	fd_set inFd, outFd, excFd;
-	FD_ZERO(&inFd);
-	FD_ZERO(&outFd);
-	FD_ZERO(&excFd);
-
-	int maxFd = -1;     // Not used on windows
-	SourceList::iterator it;
-	for (it=_sources.begin(); it!=_sources.end(); ++it) {
-	    int fd = it->getSource()->getfd();
-	    if (it->getMask() & ReadableEvent) FD_SET(fd, &inFd);
-	    if (it->getMask() & WritableEvent) FD_SET(fd, &outFd);
-	    if (it->getMask() & Exception)     FD_SET(fd, &excFd);
-	    if (it->getMask() && fd > maxFd)   maxFd = fd;
+	// Wait no longer than the time remaining
+	double remaining = -1.0;
+	if (_endTime >= 0.0) {
+	    remaining = _endTime - getTime();
+	    if (remaining < 0.0) remaining = 0.0;
 	}
 
-	// Check for events
-	int nEvents;
-	if (timeout < 0.0)
-	    nEvents = ::select( maxFd+1, &inFd, &outFd, &excFd, NULL);
-	else 
+	if (! waitForEvents(remaining, ready))
 	{
-	    struct timeval tv;
-	    tv.tv_sec = (int)floor(timeout);
-	    tv.tv_usec = ((int)floor(1000000.0 * (timeout-floor(timeout)))) %
-		1000000;
-	    std::clog << tv.tv_sec << ' ' << tv.tv_usec << std::endl;
-	    nEvents = ::select( maxFd+1, &inFd, &outFd, &excFd, &tv);
-	}
-
-	if (nEvents < 0)
-	{
-	    if ( errno == EINTR )
-		goto again;
-
-	    XmlRpcUtil::error("Error in XmlRpcDispatch::work: error in select (%d).",
+	    XmlRpcUtil::error("Error in XmlRpcDispatch::work: error waiting for events (%d).",
 			      errno );
 	    _inWork = false;
 	    return;
 	}
 
-	// Process events
-	for (it=_sources.begin(); it != _sources.end(); )
+	// Process events. A handler may add or remove sources (including
+	// itself), so look up the source again after every callback.
+	for (size_t index = 0; index < ready.size(); ++index)
 	{
-	    SourceList::iterator thisIt = it++;
-	    XmlRpcSource* src = thisIt->getSource();
-	    int fd = src->getfd();
+	    unsigned long id = ready[index]._id;
+	    std::unordered_map<unsigned long, SourceList::iterator>::iterator found = _index.find(id);
+	    if (found == _index.end())
+		continue;
+
+	    XmlRpcSource* src = found->second->getSource();
+	    unsigned mask = found->second->getMask();
+	    unsigned events = ready[index]._events & mask;
 	    unsigned newMask = (unsigned) -1;
-	    if (fd <= maxFd) {
-		// If you select on multiple event types this could be ambiguous
-		if (FD_ISSET(fd, &inFd))
-		    newMask &= src->handleEvent(ReadableEvent);
-		if (FD_ISSET(fd, &outFd))
-		    newMask &= src->handleEvent(WritableEvent);
-		if (FD_ISSET(fd, &excFd))
-		    newMask &= src->handleEvent(Exception);
-
-		if ( ! newMask) {
-		    _sources.erase(thisIt);  // Stop monitoring this one
-		    if ( ! src->getKeepOpen())
-			src->close();
-		} else if (newMask != (unsigned) -1) {
-		    thisIt->getMask() = newMask;
+	    static const unsigned kOrder[] = { ReadableEvent, WritableEvent, Exception };
+
+	    // If you select on multiple event types this could be ambiguous
+	    bool gone = false;
+	    for (int type = 0; type < 3 && ! gone; ++type) {
+		if (events & kOrder[type]) {
+		    newMask &= src->handleEvent(kOrder[type]);
+		    gone = _index.find(id) == _index.end();
 		}
 	    }
+
+	    if (gone)
+		continue;
+
+	    SourceList::iterator thisIt = _index[id];
+	    if ( ! newMask) {
+		unregister(thisIt);  // Stop monitoring this one
+		if ( ! src->getKeepOpen())
+		    src->close();
+	    } else if (newMask != (unsigned) -1) {
+		thisIt->getMask() = newMask;
+		sync(*thisIt);
+	    } else {
+		sync(*thisIt);	// Descriptor may have changed
+	    }
 	}
 
 	// Check whether to clear all sources
 	if (_doClear)
 	{
-	    SourceList closeList = _sources;
-	    _sources.clear();
-	    for (SourceList::iterator it=closeList.begin(); it!=closeList.end(); ++it) {
-		XmlRpcSource *src = it->getSource();
-		src->close();
-	    }
-
+	    clearSources();
 	    _doClear = false;
 	}
 
@@ -188,12 +343,22 @@ XmlRpcDispatch::clear()
     if (_inWork)
 	_doClear = true;  // Finish reporting current events before clearing
     else
-    {
-	SourceList closeList = _sources;
-	_sources.clear();
-	for (SourceList::iterator it=closeList.begin(); it!=closeList.end(); ++it)
-	    it->getSource()->close();
+	clearSources();
+}
+
+
+// Stop monitoring and close every source
+void
+XmlRpcDispatch::clearSources()
+{
+    std::vector<XmlRpcSource*> closeList;
+    while (! _sources.empty()) {
+	closeList.push_back(_sources.front().getSource());
+	unregister(_sources.begin());
     }
+
+    for (size_t index = 0; index < closeList.size(); ++index)
+	closeList[index]->close();
 }
 
 
@@ -214,5 +379,3 @@ XmlRpcDispatch::getTime()
     return (tv.tv_sec + tv.tv_usec / 1000000.0);
 #endif /* USE_FTIME */
 }
-
-
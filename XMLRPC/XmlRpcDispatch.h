@@ -6,6 +6,12 @@
 
 #ifndef MAKEDEPEND
 #include <list>
+#include <unordered_map>
+#include <vector>
+#endif
+
+#if defined(__linux__)
+#define XMLRPC_USE_EPOLL
 #endif
 
 namespace XmlRpc {
@@ -15,6 +21,10 @@ class XmlRpcSource;
 
 //! An object which monitors file descriptors for events and performs
 //! callbacks when interesting events happen.
+
+//! On Linux the descriptors are watched with epoll(7), so the cost of each
+//! pass through work() depends on the number of active sources rather than
+//! on the total number of sources. Other platforms use select().
 class XmlRpcDispatch {
 public:
     //! Constructor
@@ -45,8 +55,8 @@ public:
     void setSourceEvents(XmlRpcSource* source, unsigned eventMask);
 
     //! Watch current set of sources and process events for the specified
-    //! duration (in ms, -1 implies wait forever, or until exit is called)
-    void work(double msTime);
+    //! duration (in seconds, -1 implies wait forever, or until exit is called)
+    void work(double timeout);
 
     //! Exit from work routine
     void exit();
@@ -60,19 +70,52 @@ protected:
 
     // A source to monitor and what to monitor it for
     struct MonitoredSource {
-        MonitoredSource(XmlRpcSource* src, unsigned mask) : _src(src), _mask(mask) {}
+        MonitoredSource(XmlRpcSource* src, unsigned mask, unsigned long id) :
+            _src(src), _mask(mask), _id(id), _fd(-1), _registered(0)
+        {
+        }
         XmlRpcSource* getSource() const { return _src; }
         unsigned& getMask() { return _mask; }
         XmlRpcSource* _src;
         unsigned _mask;
+        unsigned long _id; // Unique tag that identifies this entry in readiness reports
+        int _fd;           // Descriptor known to the kernel event set
+        unsigned _registered; // Event mask known to the kernel event set
     };
 
     // A list of sources to monitor
     using SourceList = std::list<MonitoredSource>;
 
+    // A readiness report for a source
+    struct ReadyEvent {
+        unsigned long _id;
+        unsigned _events;
+    };
+
+    // Wait for sources to become ready. Returns false on a fatal error.
+    bool waitForEvents(double timeout, std::vector<ReadyEvent>& ready);
+
+    // Bring the kernel's view of a source in line with its current mask and descriptor
+    void sync(MonitoredSource& source);
+
+    // Forget a source
+    void unregister(SourceList::iterator pos);
+
+    // Stop monitoring and close all sources
+    void clearSources();
+
     // Sources being monitored
     SourceList _sources;
 
+    // Lookup of sources by their unique tags
+    std::unordered_map<unsigned long, SourceList::iterator> _index;
+
+    // Next unique tag to hand out
+    unsigned long _nextId;
+
+    // The epoll instance (-1 if select is in use)
+    int _epollFd;
+
     // When work should stop (-1 implies wait forever, or until exit is called)
     double _endTime;
 
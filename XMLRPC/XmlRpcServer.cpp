@@ -158,6 +158,8 @@ XmlRpcServer::acceptConnection()
   }
   else  // Notify the dispatcher to listen for input on this source when we are in work()
   {
+    (void) XmlRpcSocket::setNoDelay(s);
+
     XmlRpcUtil::log(2, "XmlRpcServer::acceptConnection: creating a connection");
     _disp.addSource(this->createConnection(s), XmlRpcDispatch::ReadableEvent);
   }
@@ -50,15 +50,25 @@ XmlRpcServerConnection::~XmlRpcServerConnection()
 unsigned
 XmlRpcServerConnection::handleEvent(unsigned /*eventType*/)
 {
-  if (_connectionState == READ_HEADER)
-    if ( ! readHeader()) return 0;
+  // A client may pipeline requests, sending several before reading any
+  // responses. Keep answering requests that are already buffered until we
+  // need to wait on the socket.
+  for (;;) {
+    if (_connectionState == READ_HEADER)
+      if ( ! readHeader()) return 0;
 
-  if (_connectionState == READ_REQUEST)
-    if ( ! readRequest()) return 0;
+    if (_connectionState == READ_REQUEST)
+      if ( ! readRequest()) return 0;
+
+    if (_connectionState != WRITE_RESPONSE)
+      break;
 
-  if (_connectionState == WRITE_RESPONSE)
     if ( ! writeResponse()) return 0;
 
+    if (_connectionState == WRITE_RESPONSE || _header.empty())
+      break;
+  }
+
   return (_connectionState == WRITE_RESPONSE) 
         ? XmlRpcDispatch::WritableEvent : XmlRpcDispatch::ReadableEvent;
 }
@@ -162,6 +172,12 @@ XmlRpcServerConnection::readRequest()
     }
   }
 
+  // Anything past the end of the body belongs to the next (pipelined) request
+  if (int(_request.length()) > _contentLength) {
+    _header.assign(_request, _contentLength, std::string::npos);
+    _request.resize(_contentLength);
+  }
+
   // Otherwise, parse and dispatch the request
   XmlRpcUtil::log(3, "XmlRpcServerConnection::readRequest read %d bytes.", _request.length());
   //XmlRpcUtil::log(5, "XmlRpcServerConnection::readRequest:\n%s\n", _request.c_str());
@@ -191,13 +207,14 @@ XmlRpcServerConnection::writeResponse()
   }
   XmlRpcUtil::log(3, "XmlRpcServerConnection::writeResponse: wrote %d of %d bytes.", _bytesWritten, _response.length());
 
-  // Prepare to read the next request
-  if (_bytesWritten == int(_response.length())) {
-    _header = "";
-    _request = "";
-    _response = "";
-    _connectionState = READ_HEADER;
-  }
+  // Keep writing until the whole response is out
+  if (_bytesWritten < int(_response.length()))
+    return true;
+
+  // Prepare to read the next request. Any pipelined data is already in _header.
+  _request = "";
+  _response = "";
+  _connectionState = READ_HEADER;
 
   return _keepAlive;    // Continue monitoring this source if true
 }
@@ -238,7 +255,7 @@ XmlRpcServerConnection::parseRequest(XmlRpcValue& params)
   {
     int nArgs = 0;
     while (XmlRpcUtil::nextTagIs(PARAM_TAG, _request, &offset)) {
-      params[nArgs++] = XmlRpcValue(_request, &offset);
+      params[nArgs++].fromXml(_request, &offset);   // parse in place
       (void) XmlRpcUtil::nextTagIs(PARAM_ETAG, _request, &offset);
     }
 
@@ -74,7 +74,7 @@ protected:
     enum ServerConnectionState { READ_HEADER, READ_REQUEST, WRITE_RESPONSE };
     ServerConnectionState _connectionState;
 
-    // Request headers
+    // Request headers, and any pipelined data received after the current request
     std::string _header;
 
     // Number of bytes expected in the request body (parsed from header)
@@ -20,6 +20,7 @@ extern "C" {
 # include <sys/types.h>
 # include <sys/socket.h>
 # include <netinet/in.h>
+# include <netinet/tcp.h>
 # include <netdb.h>
 # include <errno.h>
 # include <fcntl.h>
@@ -107,6 +108,16 @@ XmlRpcSocket::setReuseAddr(int fd)
 }
 
 
+bool
+XmlRpcSocket::setNoDelay(int fd)
+{
+  // Send small writes immediately. Otherwise a pipelined response that follows
+  // another one waits for the peer's delayed acknowledgement.
+  int sflag = 1;
+  return (setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, (const char *)&sflag, sizeof(sflag)) == 0);
+}
+
+
 // Bind to a specified port
 bool 
 XmlRpcSocket::bind(int fd, int port)
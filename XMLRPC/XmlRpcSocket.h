@@ -28,6 +28,9 @@ public:
     //! Write text to the specified socket. Returns false on error.
     static bool nbWrite(int socket, std::string& s, int* bytesSoFar);
 
+    //! Disable Nagle's algorithm so that small messages are sent without delay.
+    static bool setNoDelay(int socket);
+
     // The next four methods are appropriate for servers.
 
     //! Allow the port the specified socket is bound to to be re-bound immediately so
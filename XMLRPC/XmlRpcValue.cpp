@@ -5,10 +5,12 @@
 #include "base64.h"
 
 #ifndef MAKEDEPEND
+# include <ctype.h>
 # include <iostream>
 # include <ostream>
 # include <stdlib.h>
 # include <stdio.h>
+# include <string.h>
 #endif
 
 namespace XmlRpc {
@@ -149,6 +151,19 @@ namespace XmlRpc {
     return *this;
   }
 
+  XmlRpcValue& XmlRpcValue::operator=(XmlRpcValue&& rhs) noexcept
+  {
+    if (this != &rhs)
+    {
+      invalidate();
+      _type = rhs._type;
+      _value = rhs._value;
+      rhs._type = TypeInvalid;
+      rhs._value.asBinary = 0;
+    }
+    return *this;
+  }
+
 XmlRpcValue&
 XmlRpcValue::operator=( ValueArray* valueArray )
 {
@@ -244,194 +259,304 @@ XmlRpcValue::operator=( ValueStruct* valueStruct )
     return _type == TypeStruct && _value.asStruct->find(name) != _value.asStruct->end();
   }
 
+  // Helpers for the cursor-based parser. The parser walks the document in
+  // place with a pair of pointers, so no tag or value text is copied unless
+  // it ends up in the parsed value.
+
+  static inline const char* skipSpace(const char* cp, const char* end)
+  {
+    while (cp < end && isspace((unsigned char)*cp))
+      ++cp;
+    return cp;
+  }
+
+  // Returns true if tag is found at cp and advances cp past it.
+  template <size_t N>
+  static inline bool tagAt(const char (&tag)[N], const char*& cp, const char* end)
+  {
+    if (size_t(end - cp) < N - 1 || memcmp(cp, tag, N - 1) != 0)
+      return false;
+    cp += N - 1;
+    return true;
+  }
+
+  // Returns true if tag is next (modulo any whitespace) and advances cp past it.
+  template <size_t N>
+  static inline bool nextTagIs(const char (&tag)[N], const char*& cp, const char* end)
+  {
+    const char* tp = skipSpace(cp, end);
+    if ( ! tagAt(tag, tp, end))
+      return false;
+    cp = tp;
+    return true;
+  }
+
+  // Returns the start of the next occurrence of tag at or after cp, or end.
+  template <size_t N>
+  static inline const char* searchTag(const char (&tag)[N], const char* cp, const char* end)
+  {
+    while (cp < end) {
+      const char* lt = (const char*) memchr(cp, '<', end - cp);
+      if ( ! lt || size_t(end - lt) < N - 1)
+        break;
+      if (memcmp(lt, tag, N - 1) == 0)
+        return lt;
+      cp = lt + 1;
+    }
+    return end;
+  }
+
+  // Returns the character data starting at cp, up to the next tag.
+  static inline const char* textEnd(const char* cp, const char* end)
+  {
+    const char* lt = (const char*) memchr(cp, '<', end - cp);
+    return lt ? lt : 0;
+  }
+
+  // Copies the character data at cp, up to the next tag or end, into buf so
+  // that strtol and strtod cannot read past end. Returns false if the text
+  // does not fit.
+  template <size_t N>
+  static inline bool numberText(const char* cp, const char* end, char (&buf)[N])
+  {
+    const char* lt = textEnd(cp, end);
+    size_t length = (lt ? lt : end) - cp;
+    if (length >= N)
+      return false;
+    memcpy(buf, cp, length);
+    buf[length] = 0;
+    return true;
+  }
+
+  // Converts character data to a string, decoding entities only when present.
+  static inline void decodeText(const char* cp, const char* end, std::string& text)
+  {
+    if (memchr(cp, '&', end - cp))
+      text = XmlRpcUtil::xmlDecode(std::string(cp, end));
+    else
+      text.assign(cp, end);
+  }
+
+
   // Set the value from xml. The chars at *offset into valueXml 
   // should be the start of a <value> tag. Destroys any existing value.
   bool XmlRpcValue::fromXml(std::string const& valueXml, int* offset)
   {
-    int savedOffset = *offset;
+    invalidate();
+    if (*offset < 0 || *offset >= int(valueXml.length()))
+      return false;
+
+    const char* begin = valueXml.c_str();
+    const char* cp = begin + *offset;
+    if ( ! fromXml(cp, begin + valueXml.length()))
+      return false;
+
+    *offset = int(cp - begin);
+    return true;
+  }
 
+  // Set the value from the xml at cp. On success cp is left just after the
+  // closing </value> tag; on failure it is not moved.
+  bool XmlRpcValue::fromXml(const char*& cp, const char* end)
+  {
     invalidate();
-    if ( ! XmlRpcUtil::nextTagIs(VALUE_TAG, valueXml, offset))
-      return false;       // Not a value, offset not updated
 
-	int afterValueOffset = *offset;
-    std::string typeTag = XmlRpcUtil::getNextTag(valueXml, offset);
+    const char* vp = cp;
+    if ( ! nextTagIs(VALUE_TAG, vp, end))
+      return false;       // Not a value, cursor not updated
+
+    const char* afterValue = vp;
+    const char* tp = skipSpace(vp, end);
     bool result = false;
-    if (typeTag == BOOLEAN_TAG)
-      result = boolFromXml(valueXml, offset);
-    else if (typeTag == I4_TAG || typeTag == INT_TAG)
-      result = intFromXml(valueXml, offset);
-    else if (typeTag == DOUBLE_TAG)
-      result = doubleFromXml(valueXml, offset);
-    else if (typeTag.empty() || typeTag == STRING_TAG)
-      result = stringFromXml(valueXml, offset);
-    else if (typeTag == DATETIME_TAG)
-      result = timeFromXml(valueXml, offset);
-    else if (typeTag == BASE64_TAG)
-      result = binaryFromXml(valueXml, offset);
-    else if (typeTag == ARRAY_TAG)
-      result = arrayFromXml(valueXml, offset);
-    else if (typeTag == STRUCT_TAG)
-      result = structFromXml(valueXml, offset);
+
+    // Values without a type tag are strings, including any leading whitespace
+    if (tp == end || *tp != '<')
+      result = stringFromXml(vp, end);
+    else if (tagAt(I4_TAG, tp, end) || tagAt(INT_TAG, tp, end))
+      result = intFromXml(vp = tp, end);
+    else if (tagAt(STRING_TAG, tp, end))
+      result = stringFromXml(vp = tp, end);
+    else if (tagAt(DOUBLE_TAG, tp, end))
+      result = doubleFromXml(vp = tp, end);
+    else if (tagAt(BOOLEAN_TAG, tp, end))
+      result = boolFromXml(vp = tp, end);
+    else if (tagAt(STRUCT_TAG, tp, end))
+      result = structFromXml(vp = tp, end);
+    else if (tagAt(ARRAY_TAG, tp, end))
+      result = arrayFromXml(vp = tp, end);
+    else if (tagAt(DATETIME_TAG, tp, end))
+      result = timeFromXml(vp = tp, end);
+    else if (tagAt(BASE64_TAG, tp, end))
+      result = binaryFromXml(vp = tp, end);
     // Watch for empty/blank strings with no <string>tag
-    else if (typeTag == VALUE_ETAG)
-    {
-      *offset = afterValueOffset;   // back up & try again
-      result = stringFromXml(valueXml, offset);
-    }
+    else if (tagAt(VALUE_ETAG, tp, end))
+      result = stringFromXml(vp = afterValue, end);
 
-    if (result)  // Skip over the </value> tag
-      XmlRpcUtil::findTag(VALUE_ETAG, valueXml, offset);
-    else        // Unrecognized tag after <value>
-      *offset = savedOffset;
+    if ( ! result)      // Unrecognized tag after <value>
+      return false;
 
-    return result;
+    // Skip over the </value> tag
+    const char* etag = searchTag(VALUE_ETAG, vp, end);
+    cp = etag == end ? vp : etag + sizeof(VALUE_ETAG) - 1;
+    return true;
   }
 
   // Encode the Value in xml
   std::string XmlRpcValue::toXml() const
+  {
+    std::string xml;
+    toXml(xml);
+    return xml;
+  }
+
+  // Append the xml encoding of the Value
+  void XmlRpcValue::toXml(std::string& xml) const
   {
     switch (_type) {
-      case TypeBoolean:  return boolToXml();
-      case TypeInt:      return intToXml();
-      case TypeDouble:   return doubleToXml();
-      case TypeString:   return stringToXml();
-      case TypeDateTime: return timeToXml();
-      case TypeBase64:   return binaryToXml();
-      case TypeArray:    return arrayToXml();
-      case TypeStruct:   return structToXml();
-      default: break;
+      case TypeBoolean:  boolToXml(xml); break;
+      case TypeInt:      intToXml(xml); break;
+      case TypeDouble:   doubleToXml(xml); break;
+      case TypeString:   stringToXml(xml); break;
+      case TypeDateTime: timeToXml(xml); break;
+      case TypeBase64:   binaryToXml(xml); break;
+      case TypeArray:    arrayToXml(xml); break;
+      case TypeStruct:   structToXml(xml); break;
+      default: break;   // Invalid value
     }
-    return std::string();   // Invalid value
   }
 
 
   // Boolean
-  bool XmlRpcValue::boolFromXml(std::string const& valueXml, int* offset)
+  bool XmlRpcValue::boolFromXml(const char*& cp, const char* end)
   {
-    const char* valueStart = valueXml.c_str() + *offset;
+    char buf[64];
+    if ( ! numberText(cp, end, buf))
+      return false;
+
     char* valueEnd;
-    long ivalue = strtol(valueStart, &valueEnd, 10);
-    if (valueEnd == valueStart || (ivalue != 0 && ivalue != 1))
+    long ivalue = strtol(buf, &valueEnd, 10);
+    if (valueEnd == buf || (ivalue != 0 && ivalue != 1))
       return false;
 
     _type = TypeBoolean;
     _value.asBool = (ivalue == 1);
-    *offset += int(valueEnd - valueStart);
+    cp += valueEnd - buf;
     return true;
   }
 
-  std::string XmlRpcValue::boolToXml() const
+  void XmlRpcValue::boolToXml(std::string& xml) const
   {
-    std::string xml = VALUE_TAG;
+    xml += VALUE_TAG;
     xml += BOOLEAN_TAG;
     xml += (_value.asBool ? "1" : "0");
     xml += BOOLEAN_ETAG;
     xml += VALUE_ETAG;
-    return xml;
   }
 
   // Int
-  bool XmlRpcValue::intFromXml(std::string const& valueXml, int* offset)
+  bool XmlRpcValue::intFromXml(const char*& cp, const char* end)
   {
-    const char* valueStart = valueXml.c_str() + *offset;
+    char buf[64];
+    if ( ! numberText(cp, end, buf))
+      return false;
+
     char* valueEnd;
-    long ivalue = strtol(valueStart, &valueEnd, 10);
-    if (valueEnd == valueStart)
+    long ivalue = strtol(buf, &valueEnd, 10);
+    if (valueEnd == buf)
       return false;
 
     _type = TypeInt;
     _value.asInt = int(ivalue);
-    *offset += int(valueEnd - valueStart);
+    cp += valueEnd - buf;
     return true;
   }
 
-  std::string XmlRpcValue::intToXml() const
+  void XmlRpcValue::intToXml(std::string& xml) const
   {
     char buf[256];
     snprintf(buf, sizeof(buf)-1, "%d", _value.asInt);
     buf[sizeof(buf)-1] = 0;
-    std::string xml = VALUE_TAG;
+    xml += VALUE_TAG;
     xml += I4_TAG;
     xml += buf;
     xml += I4_ETAG;
     xml += VALUE_ETAG;
-    return xml;
   }
 
   // Double
-  bool XmlRpcValue::doubleFromXml(std::string const& valueXml, int* offset)
+  bool XmlRpcValue::doubleFromXml(const char*& cp, const char* end)
   {
-    const char* valueStart = valueXml.c_str() + *offset;
+    // Large enough for any double written with the default "%f" format.
+    char buf[512];
+    if ( ! numberText(cp, end, buf))
+      return false;
+
     char* valueEnd;
-    double dvalue = strtod(valueStart, &valueEnd);
-    if (valueEnd == valueStart)
+    double dvalue = strtod(buf, &valueEnd);
+    if (valueEnd == buf)
       return false;
 
     _type = TypeDouble;
     _value.asDouble = dvalue;
-    *offset += int(valueEnd - valueStart);
+    cp += valueEnd - buf;
     return true;
   }
 
-  std::string XmlRpcValue::doubleToXml() const
+  void XmlRpcValue::doubleToXml(std::string& xml) const
   {
     char buf[256];
     snprintf(buf, sizeof(buf)-1, getDoubleFormat().c_str(), _value.asDouble);
     buf[sizeof(buf)-1] = 0;
 
-    std::string xml = VALUE_TAG;
+    xml += VALUE_TAG;
     xml += DOUBLE_TAG;
     xml += buf;
     xml += DOUBLE_ETAG;
     xml += VALUE_ETAG;
-    return xml;
   }
 
   // String
-  bool XmlRpcValue::stringFromXml(std::string const& valueXml, int* offset)
+  bool XmlRpcValue::stringFromXml(const char*& cp, const char* end)
   {
-    size_t valueEnd = valueXml.find('<', *offset);
-    if (valueEnd == std::string::npos)
+    const char* valueEnd = textEnd(cp, end);
+    if ( ! valueEnd)
       return false;     // No end tag;
 
     _type = TypeString;
-    _value.asString = new std::string(XmlRpcUtil::xmlDecode(valueXml.substr(*offset, valueEnd-*offset)));
-    *offset += int(_value.asString->length());
+    _value.asString = new std::string();
+    decodeText(cp, valueEnd, *_value.asString);
+    cp = valueEnd;
     return true;
   }
 
-  std::string XmlRpcValue::stringToXml() const
+  void XmlRpcValue::stringToXml(std::string& xml) const
   {
-    std::string xml = VALUE_TAG;
+    xml += VALUE_TAG;
     //xml += STRING_TAG; optional
     xml += XmlRpcUtil::xmlEncode(*_value.asString);
     //xml += STRING_ETAG;
     xml += VALUE_ETAG;
-    return xml;
   }
 
   // DateTime (stored as a struct tm)
-  bool XmlRpcValue::timeFromXml(std::string const& valueXml, int* offset)
+  bool XmlRpcValue::timeFromXml(const char*& cp, const char* end)
   {
-    size_t valueEnd = valueXml.find('<', *offset);
-    if (valueEnd == std::string::npos)
+    const char* valueEnd = textEnd(cp, end);
+    if ( ! valueEnd)
       return false;     // No end tag;
 
-    std::string stime = valueXml.substr(*offset, valueEnd-*offset);
-
     struct tm t;
-    if (sscanf(stime.c_str(),"%4d%2d%2dT%2d:%2d:%2d",&t.tm_year,&t.tm_mon,&t.tm_mday,&t.tm_hour,&t.tm_min,&t.tm_sec) != 6)
+    if (sscanf(cp,"%4d%2d%2dT%2d:%2d:%2d",&t.tm_year,&t.tm_mon,&t.tm_mday,&t.tm_hour,&t.tm_min,&t.tm_sec) != 6)
       return false;
 
     t.tm_isdst = -1;
     _type = TypeDateTime;
     _value.asTime = new struct tm(t);
-    *offset += int(stime.length());
+    cp = valueEnd;
     return true;
   }
 
-  std::string XmlRpcValue::timeToXml() const
+  void XmlRpcValue::timeToXml(std::string& xml) const
   {
     struct tm* t = _value.asTime;
     char buf[20];
@@ -439,24 +564,22 @@ XmlRpcValue::operator=( ValueStruct* valueStruct )
       t->tm_year,t->tm_mon,t->tm_mday,t->tm_hour,t->tm_min,t->tm_sec);
     buf[sizeof(buf)-1] = 0;
 
-    std::string xml = VALUE_TAG;
+    xml += VALUE_TAG;
     xml += DATETIME_TAG;
     xml += buf;
     xml += DATETIME_ETAG;
     xml += VALUE_ETAG;
-    return xml;
   }
 
 
   // Base64
-  bool XmlRpcValue::binaryFromXml(std::string const& valueXml, int* offset)
+  bool XmlRpcValue::binaryFromXml(const char*& cp, const char* end)
   {
-    size_t valueEnd = valueXml.find('<', *offset);
-    if (valueEnd == std::string::npos)
+    const char* valueEnd = textEnd(cp, end);
+    if ( ! valueEnd)
       return false;     // No end tag;
 
     _type = TypeBase64;
-    std::string asString = valueXml.substr(*offset, valueEnd-*offset);
     _value.asBinary = new BinaryData();
     // check whether base64 encodings can contain chars xml encodes...
 
@@ -464,14 +587,14 @@ XmlRpcValue::operator=( ValueStruct* valueStruct )
     int iostatus = 0;
 	  base64<char> decoder;
     std::back_insert_iterator<BinaryData> ins = std::back_inserter(*(_value.asBinary));
-		decoder.get(asString.begin(), asString.end(), ins, iostatus);
+		decoder.get(cp, valueEnd, ins, iostatus);
 
-    *offset += int(asString.length());
+    cp = valueEnd;
     return true;
   }
 
 
-  std::string XmlRpcValue::binaryToXml() const
+  void XmlRpcValue::binaryToXml(std::string& xml) const
   {
     // convert to base64
     std::vector<char> base64data;
@@ -481,81 +604,89 @@ XmlRpcValue::operator=( ValueStruct* valueStruct )
 		encoder.put(_value.asBinary->begin(), _value.asBinary->end(), ins, iostatus, base64<>::crlf());
 
     // Wrap with xml
-    std::string xml = VALUE_TAG;
+    xml += VALUE_TAG;
     xml += BASE64_TAG;
     xml.append(base64data.begin(), base64data.end());
     xml += BASE64_ETAG;
     xml += VALUE_ETAG;
-    return xml;
   }
 
 
-  // Array
-  bool XmlRpcValue::arrayFromXml(std::string const& valueXml, int* offset)
+  // Array. Elements are parsed in place at the end of the array.
+  bool XmlRpcValue::arrayFromXml(const char*& cp, const char* end)
   {
-    if ( ! XmlRpcUtil::nextTagIs(DATA_TAG, valueXml, offset))
+    if ( ! nextTagIs(DATA_TAG, cp, end))
       return false;
 
     _type = TypeArray;
     _value.asArray = new ValueArray;
-    XmlRpcValue v;
-    while (v.fromXml(valueXml, offset))
-      _value.asArray->push_back(v);       // copy...
+    for (;;) {
+      _value.asArray->emplace_back();
+      if ( ! _value.asArray->back().fromXml(cp, end)) {
+        _value.asArray->pop_back();
+        break;
+      }
+    }
 
     // Skip the trailing </data>
-    (void) XmlRpcUtil::nextTagIs(DATA_ETAG, valueXml, offset);
+    (void) nextTagIs(DATA_ETAG, cp, end);
     return true;
   }
 
 
-  // In general, its preferable to generate the xml of each element of the
-  // array as it is needed rather than glomming up one big string.
-  std::string XmlRpcValue::arrayToXml() const
+  // Elements append their xml to the same buffer as the array.
+  void XmlRpcValue::arrayToXml(std::string& xml) const
   {
-    std::string xml = VALUE_TAG;
+    xml += VALUE_TAG;
     xml += ARRAY_TAG;
     xml += DATA_TAG;
 
     int s = int(_value.asArray->size());
     for (int i=0; i<s; ++i)
-       xml += _value.asArray->at(i).toXml();
+       _value.asArray->at(i).toXml(xml);
 
     xml += DATA_ETAG;
     xml += ARRAY_ETAG;
     xml += VALUE_ETAG;
-    return xml;
   }
 
 
-  // Struct
-  bool XmlRpcValue::structFromXml(std::string const& valueXml, int* offset)
+  // Struct. Member values are parsed in place in the map.
+  bool XmlRpcValue::structFromXml(const char*& cp, const char* end)
   {
     _type = TypeStruct;
     _value.asStruct = new ValueStruct;
 
-    while (XmlRpcUtil::nextTagIs(MEMBER_TAG, valueXml, offset)) {
+    std::string name;
+    while (nextTagIs(MEMBER_TAG, cp, end)) {
       // name
-      const std::string name = XmlRpcUtil::parseTag(NAME_TAG, valueXml, offset);
+      name.clear();
+      const char* np = searchTag(NAME_TAG, cp, end);
+      if (np != end) {
+        np += sizeof(NAME_TAG) - 1;
+        const char* ne = searchTag(NAME_ETAG, np, end);
+        if (ne != end) {
+          decodeText(np, ne, name);
+          cp = ne + sizeof(NAME_ETAG) - 1;
+        }
+      }
+
       // value
-      XmlRpcValue val(valueXml, offset);
-      if ( ! val.valid()) {
+      if ( ! (*_value.asStruct)[name].fromXml(cp, end)) {
         invalidate();
         return false;
       }
-      const std::pair<const std::string, XmlRpcValue> p(name, val);
-      _value.asStruct->insert(p);
 
-      (void) XmlRpcUtil::nextTagIs(MEMBER_ETAG, valueXml, offset);
+      (void) nextTagIs(MEMBER_ETAG, cp, end);
     }
     return true;
   }
 
 
-  // In general, its preferable to generate the xml of each element
-  // as it is needed rather than glomming up one big string.
-  std::string XmlRpcValue::structToXml() const
+  // Members append their xml to the same buffer as the struct.
+  void XmlRpcValue::structToXml(std::string& xml) const
   {
-    std::string xml = VALUE_TAG;
+    xml += VALUE_TAG;
     xml += STRUCT_TAG;
 
     ValueStruct::const_iterator it;
@@ -564,13 +695,12 @@ XmlRpcValue::operator=( ValueStruct* valueStruct )
       xml += NAME_TAG;
       xml += XmlRpcUtil::xmlEncode(it->first);
       xml += NAME_ETAG;
-      xml += it->second.toXml();
+      it->second.toXml(xml);
       xml += MEMBER_ETAG;
     }
 
     xml += STRUCT_ETAG;
     xml += VALUE_ETAG;
-    return xml;
   }
 
 
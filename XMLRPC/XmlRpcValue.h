@@ -65,6 +65,13 @@ public:
     //! Copy
     XmlRpcValue(XmlRpcValue const& rhs) : _type(TypeInvalid) { *this = rhs; }
 
+    //! Move. Takes ownership of the value held by rhs, leaving rhs invalid.
+    XmlRpcValue(XmlRpcValue&& rhs) noexcept : _type(rhs._type), _value(rhs._value)
+    {
+        rhs._type = TypeInvalid;
+        rhs._value.asBinary = 0;
+    }
+
     //! Destructor (make virtual if you want to subclass)
     /*virtual*/ ~XmlRpcValue() { invalidate(); }
 
@@ -73,6 +80,7 @@ public:
 
     // Operators
     XmlRpcValue& operator=(XmlRpcValue const& rhs);
+    XmlRpcValue& operator=(XmlRpcValue&& rhs) noexcept;
     XmlRpcValue& operator=(bool const& rhs) { return operator=(XmlRpcValue(rhs)); }
     XmlRpcValue& operator=(int const& rhs) { return operator=(XmlRpcValue(rhs)); }
     XmlRpcValue& operator=(double const& rhs) { return operator=(XmlRpcValue(rhs)); }
@@ -228,9 +236,16 @@ public:
     //! Decode xml. Destroys any existing value.
     bool fromXml(std::string const& valueXml, int* offset);
 
+    //! Decode xml found between cp and end, which must be followed by a NUL or other non-XML character.
+    //! Destroys any existing value. On success, cp is advanced past the closing value tag.
+    bool fromXml(const char*& cp, const char* end);
+
     //! Encode the Value in xml
     std::string toXml() const;
 
+    //! Append the xml encoding of the Value to the given buffer
+    void toXml(std::string& xml) const;
+
     //! Write the value (no xml encoding)
     std::ostream& write(std::ostream& os) const;
 
@@ -253,25 +268,25 @@ protected:
     void assertStruct() const;
     void assertStruct();
 
-    // XML decoding
-    bool boolFromXml(std::string const& valueXml, int* offset);
-    bool intFromXml(std::string const& valueXml, int* offset);
-    bool doubleFromXml(std::string const& valueXml, int* offset);
-    bool stringFromXml(std::string const& valueXml, int* offset);
-    bool timeFromXml(std::string const& valueXml, int* offset);
-    bool binaryFromXml(std::string const& valueXml, int* offset);
-    bool arrayFromXml(std::string const& valueXml, int* offset);
-    bool structFromXml(std::string const& valueXml, int* offset);
-
-    // XML encoding
-    std::string boolToXml() const;
-    std::string intToXml() const;
-    std::string doubleToXml() const;
-    std::string stringToXml() const;
-    std::string timeToXml() const;
-    std::string binaryToXml() const;
-    std::string arrayToXml() const;
-    std::string structToXml() const;
+    // XML decoding. Each advances the cursor past the text it consumed.
+    bool boolFromXml(const char*& cp, const char* end);
+    bool intFromXml(const char*& cp, const char* end);
+    bool doubleFromXml(const char*& cp, const char* end);
+    bool stringFromXml(const char*& cp, const char* end);
+    bool timeFromXml(const char*& cp, const char* end);
+    bool binaryFromXml(const char*& cp, const char* end);
+    bool arrayFromXml(const char*& cp, const char* end);
+    bool structFromXml(const char*& cp, const char* end);
+
+    // XML encoding. Each appends to the given buffer.
+    void boolToXml(std::string& xml) const;
+    void intToXml(std::string& xml) const;
+    void doubleToXml(std::string& xml) const;
+    void stringToXml(std::string& xml) const;
+    void timeToXml(std::string& xml) const;
+    void binaryToXml(std::string& xml) const;
+    void arrayToXml(std::string& xml) const;
+    void structToXml(std::string& xml) const;
 
     // Format strings
     static std::string _doubleFormat;
@@ -0,0 +1,210 @@
+// xmlrpcload: measure XML-RPC request throughput.
+//
+// Starts an XmlRpcServer in a background thread and drives it from one or
+// more client threads, reporting requests per second for each of the ways a
+// client can talk to the server:
+//
+//   oneshot    - a new connection for every request
+//   keepalive  - one connection per client, one request at a time
+//   pipelined  - one connection per client, batches of requests written
+//                before any response is read
+//
+// A final pass times XmlRpcValue encoding and decoding of a status-sized
+// value without any networking.
+//
+// Usage: xmlrpcload [-p port] [-c clients] [-n requests] [-d depth] [-s size]
+
+#include "XmlRpc.h"
+
+#ifndef MAKEDEPEND
+# include <algorithm>
+# include <atomic>
+# include <chrono>
+# include <iostream>
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <thread>
+# include <vector>
+#endif
+
+using namespace XmlRpc;
+
+namespace {
+
+  typedef std::chrono::steady_clock Clock;
+
+  double elapsedSince(Clock::time_point start)
+  {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+  }
+
+  //! Returns its arguments unchanged.
+  class Echo : public XmlRpcServerMethod
+  {
+  public:
+    Echo(XmlRpcServer* s) : XmlRpcServerMethod("echo", s) {}
+    void execute(XmlRpcValue& params, XmlRpcValue& result) { result = params; }
+  };
+
+  //! Build an argument shaped like a small status report.
+  XmlRpcValue makeArgument(int size)
+  {
+    XmlRpcValue arg;
+    arg.setSize(size);
+    for (int i=0; i<size; ++i) {
+      arg[i]["name"] = std::string("task");
+      arg[i]["count"] = i;
+      arg[i]["rate"] = 1.5 * i;
+      arg[i]["active"] = (i % 2) == 0;
+    }
+    return arg;
+  }
+
+  enum Mode { ONESHOT, KEEPALIVE, PIPELINED };
+
+  const char* modeName(Mode mode)
+  {
+    switch (mode) {
+      case ONESHOT:   return "oneshot";
+      case KEEPALIVE: return "keepalive";
+      default:        return "pipelined";
+    }
+  }
+
+  //! Issue requests from a single client. Returns the number that failed.
+  int runClient(Mode mode, int port, int requests, int depth, XmlRpcValue const& arg)
+  {
+    int failures = 0;
+    XmlRpcValue result;
+
+    if (mode == ONESHOT) {
+      for (int i=0; i<requests; ++i) {
+        XmlRpcClient client("localhost", port);
+        if ( ! client.execute("echo", arg, result) || client.isFault()) ++failures;
+        client.close();
+      }
+      return failures;
+    }
+
+    XmlRpcClient client("localhost", port);
+    if (mode == KEEPALIVE) {
+      for (int i=0; i<requests; ++i)
+        if ( ! client.execute("echo", arg, result) || client.isFault()) ++failures;
+    } else {
+      std::vector<XmlRpcClient::Call> calls(depth);
+      for (int i=0; i<depth; ++i) {
+        calls[i].method = "echo";
+        calls[i].params = arg;
+      }
+      std::vector<XmlRpcValue> results;
+      for (int done=0; done<requests; done += int(calls.size())) {
+        calls.resize(std::min(depth, requests - done));
+        if ( ! client.executePipelined(calls, results) || client.isFault())
+          failures += int(calls.size());
+      }
+    }
+
+    client.close();
+    return failures;
+  }
+
+  void runMode(Mode mode, int port, int clients, int requests, int depth, XmlRpcValue const& arg)
+  {
+    std::atomic<int> failures(0);
+    std::vector<std::thread> threads;
+
+    Clock::time_point start = Clock::now();
+    for (int i=0; i<clients; ++i)
+      threads.push_back(std::thread([&]() {
+        failures += runClient(mode, port, requests, depth, arg);
+      }));
+    for (size_t i=0; i<threads.size(); ++i)
+      threads[i].join();
+    double elapsed = elapsedSince(start);
+
+    int total = clients * requests;
+    printf("%-10s %8d requests %8.3f s %10.0f req/s %6d failed\n", modeName(mode), total, elapsed,
+           total / elapsed, failures.load());
+  }
+
+  void runCodec(XmlRpcValue const& arg, int iterations)
+  {
+    size_t bytes = 0;
+    Clock::time_point start = Clock::now();
+    for (int i=0; i<iterations; ++i) {
+      std::string xml = arg.toXml();
+      bytes += xml.size();
+      int offset = 0;
+      XmlRpcValue decoded(xml, &offset);
+      if (i == 0 && decoded != arg)
+        std::cerr << "xmlrpcload: value did not survive an encode/decode cycle\n";
+    }
+    double elapsed = elapsedSince(start);
+    printf("%-10s %8d values   %8.3f s %10.1f MB/s\n", "codec", iterations, elapsed,
+           bytes / elapsed / 1.0E6);
+  }
+
+  void usage()
+  {
+    std::cerr << "usage: xmlrpcload [-p port] [-c clients] [-n requests] [-d depth] [-s size]\n"
+              << "  -p port      server port (default 9191)\n"
+              << "  -c clients   concurrent client threads (default 4)\n"
+              << "  -n requests  requests per client per mode (default 2000)\n"
+              << "  -d depth     requests per pipelined batch (default 16)\n"
+              << "  -s size      elements in the echoed argument (default 10)\n";
+    exit(1);
+  }
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  int port = 9191;
+  int clients = 4;
+  int requests = 2000;
+  int depth = 16;
+  int size = 10;
+
+  for (int i=1; i<argc; ++i) {
+    if (argv[i][0] != '-' || argv[i][1] == 0 || argv[i][2] != 0 || i + 1 == argc)
+      usage();
+    int value = atoi(argv[++i]);
+    if (value <= 0)
+      usage();
+    switch (argv[i-1][1]) {
+      case 'p': port = value; break;
+      case 'c': clients = value; break;
+      case 'n': requests = value; break;
+      case 'd': depth = value; break;
+      case 's': size = value; break;
+      default: usage();
+    }
+  }
+
+  XmlRpcServer server;
+  Echo echo(&server);
+  if ( ! server.bindAndListen(port, 128)) {
+    std::cerr << "xmlrpcload: failed to listen on port " << port << "\n";
+    return 1;
+  }
+
+  std::atomic<bool> running(true);
+  std::thread serverThread([&]() {
+    while (running)
+      server.work(0.1);
+  });
+
+  XmlRpcValue arg = makeArgument(size);
+  runMode(ONESHOT, port, clients, requests, depth, arg);
+  runMode(KEEPALIVE, port, clients, requests, depth, arg);
+  runMode(PIPELINED, port, clients, requests, depth, arg);
+
+  running = false;
+  serverThread.join();
+  server.shutdown();
+
+  runCodec(makeArgument(size * 100), 100);
+  return 0;
+}